@@ -1,8 +1,8 @@
 #!/usr/bin/python3
 
 import sys
-from collections import Counter
 import babeltrace
+import math
 import statistics
 
 def analyze_trace(path):
@@ -10,54 +10,56 @@ def analyze_trace(path):
     if col.add_trace(path, 'ctf') is None:
         raise RuntimeError('Cannot add trace')
 
-    buffers = {}
+    frames = {}
 
     for event in col.events:
-        if event.name.startswith("aethercast_"):
-            buffer_timestamp = event["timestamp"]
-
-            current_buffer = {}
-
-            if buffer_timestamp in buffers.keys():
-                current_buffer = buffers[buffer_timestamp]
-            else:
-                current_buffer['timestamp'] = buffer_timestamp
-
-            current_buffer[event.name] = event.timestamp
-
-            buffers[buffer_timestamp] = current_buffer
-
-    rendering_times = []
-    encoding_times = []
-    packetizing_times = []
-    sending_times = []
-
-    for buffer_timestamp in buffers:
-        buffer = buffers[buffer_timestamp]
-
-        start = buffer["aethercast_encoder:received_input_buffer"]
-        usec_per_sec = 1000000
-
-        renderer_end = buffer["aethercast_renderer:finished_frame"]
-        rendering_times.append(((renderer_end - start) / usec_per_sec))
-
-        encoder_end = buffer["aethercast_encoder:finished_frame"]
-        encoding_times.append(((encoder_end - start) / usec_per_sec))
-
-        packetizer_end = buffer["aethercast_packetizer:packetized_frame"]
-        packetizing_times.append(((packetizer_end - start) / usec_per_sec))
-
-        sender_end = buffer["aethercast_sender:sent_packet"]
-        sending_times.append(((sender_end - start) / usec_per_sec))
-
-    def dump_statistics(name, data):
-        print("%s time max: %f ms min: %f ms mean: %f ms stdev: %f ms" %
-              (name, max(data), min(data), statistics.mean(data), statistics.stdev(data)))
-
-    dump_statistics("Rendering", rendering_times)
-    dump_statistics("Encoding", encoding_times)
-    dump_statistics("Packetizing", packetizing_times)
-    dump_statistics("Sending", sending_times)
+        if not event.name.startswith("aethercast_"):
+            continue
+
+        # Events not belonging to a frame (e.g. codec config) carry
+        # a frame number of zero.
+        frame_number = event.get("frame", 0)
+        if frame_number == 0:
+            continue
+
+        frame = frames.setdefault(frame_number, {})
+
+        # For every datagram of a frame we get a separate event but
+        # we want to know when the first and last one went out.
+        if event.name == "aethercast_sender:sent_packet":
+            frame.setdefault("first_sent_packet", event.timestamp)
+            frame["last_sent_packet"] = event.timestamp
+        else:
+            frame.setdefault(event.name, event.timestamp)
+
+    stages = [
+        ("Rendering", "aethercast_renderer:finished_frame", "aethercast_encoder:received_input_buffer"),
+        ("Encoding", "aethercast_encoder:received_input_buffer", "aethercast_encoder:finished_frame"),
+        ("Packetizing", "aethercast_encoder:finished_frame", "aethercast_packetizer:packetized_frame"),
+        ("Queueing", "aethercast_packetizer:packetized_frame", "first_sent_packet"),
+        ("Sending", "first_sent_packet", "last_sent_packet"),
+        ("Total", "aethercast_renderer:finished_frame", "last_sent_packet"),
+    ]
+
+    # Event timestamps are in nanoseconds
+    nsec_per_msec = 1000000
+
+    def percentile(data, p):
+        data = sorted(data)
+        rank = max(0, int(math.ceil(p / 100.0 * len(data))) - 1)
+        return data[rank]
+
+    for name, begin, end in stages:
+        times = [(frame[end] - frame[begin]) / nsec_per_msec
+                 for frame in frames.values() if begin in frame and end in frame]
+
+        if len(times) < 2:
+            print("%s: not enough samples" % name)
+            continue
+
+        print("%s time max: %f ms min: %f ms mean: %f ms stdev: %f ms p50: %f ms p90: %f ms p99: %f ms" %
+              (name, max(times), min(times), statistics.mean(times), statistics.stdev(times),
+               percentile(times, 50), percentile(times, 90), percentile(times, 99)))
 
 if __name__ == '__main__':
     if len(sys.argv) != 2:
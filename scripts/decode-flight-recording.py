@@ -0,0 +1,126 @@
+#!/usr/bin/python3
+
+import struct
+import sys
+
+MAGIC = 0x52464341
+VERSION = 2
+
+HEADER = struct.Struct("<IIIIQ")
+# A slot is the sequence followed by the event
+SLOT = struct.Struct("<QQQIHH")
+
+# Has to match FlightRecorder::EventType
+EVENT_NAMES = [
+    None,
+    "renderer:began_frame",
+    "renderer:finished_frame",
+    "renderer:skipped_frames",
+    "encoder:started",
+    "encoder:stopped",
+    "encoder:received_input_buffer",
+    "encoder:began_frame",
+    "encoder:finished_frame",
+    "encoder:requested_idr_frame",
+    "packetizer:packetized_frame",
+    "sender:sent_packet",
+    "sender:failed_to_send_packet",
+    "connection:phase",
+    "encoder:emitted_idr_frame",
+    "renderer:unchanged_frame",
+]
+
+# Has to match ConnectionTimeline::Phase
+CONNECTION_PHASES = [
+    "connect-requested",
+    "group-negotiated",
+    "group-started",
+    "address-assigned",
+    "sink-connected",
+    "play-requested",
+    "pipeline-started",
+    "first-frame-rendered",
+    "first-frame-encoded",
+    "first-packet-sent",
+]
+
+# Gaps between two events larger than this are marked in the timeline
+STALL_THRESHOLD_US = 100000
+
+def read_events(path):
+    with open(path, "rb") as f:
+        data = f.read()
+
+    magic, version, event_size, capacity, next_event = HEADER.unpack_from(data, 0)
+    if magic != MAGIC:
+        raise RuntimeError("Not a flight recording")
+    if version != VERSION or event_size != SLOT.size:
+        raise RuntimeError("Unsupported flight recording version %d" % version)
+
+    first = max(0, next_event - capacity)
+
+    events = []
+    for n in range(first, next_event):
+        offset = HEADER.size + (n % capacity) * event_size
+        sequence, time, frame, value, event_type, _ = SLOT.unpack_from(data, offset)
+        # Slots written while the recording was dumped or when the
+        # service crashed might be incomplete.
+        if sequence != n + 1:
+            continue
+        if event_type == 0 or event_type >= len(EVENT_NAMES):
+            continue
+        events.append((time, frame, value, EVENT_NAMES[event_type]))
+
+    # Every thread reserves its slot before it writes the time so
+    # neighbours can be slightly out of order.
+    events.sort(key=lambda e: e[0])
+    return events
+
+def describe(name, frame, value, last_packetized):
+    if name == "connection:phase":
+        return CONNECTION_PHASES[value] if value < len(CONNECTION_PHASES) else "unknown"
+    if name.startswith("encoder:") and not name.endswith("_idr_frame"):
+        return "frame %d encoder queue %d" % (frame, value)
+    if name == "renderer:skipped_frames":
+        return "%d frames" % value
+    if name == "sender:sent_packet":
+        queue = max(0, last_packetized - frame) if frame > 0 else 0
+        return "frame %d size %d sender queue %d" % (frame, value, queue)
+    if frame > 0:
+        return "frame %d" % frame
+    return ""
+
+def print_timeline(events):
+    if not events:
+        print("No events recorded")
+        return
+
+    start = events[0][0]
+    previous = start
+    last_packetized = 0
+
+    for time, frame, value, name in events:
+        if time - previous > STALL_THRESHOLD_US:
+            print("%12s  --- nothing happened for %.1f ms ---" % ("", (time - previous) / 1000.0))
+        previous = time
+
+        if name == "packetizer:packetized_frame" and frame > 0:
+            last_packetized = frame
+
+        print("%12.3f  %-32s %s" % ((time - start) / 1000.0, name,
+                                    describe(name, frame, value, last_packetized)))
+
+    print("")
+    print("%d events over %.1f seconds" % (len(events), (events[-1][0] - start) / 1000000.0))
+    for name in ("renderer:skipped_frames", "encoder:requested_idr_frame",
+                 "encoder:emitted_idr_frame", "sender:failed_to_send_packet"):
+        count = sum(1 for e in events if e[3] == name)
+        if count > 0:
+            print("%s: %d" % (name, count))
+
+if __name__ == '__main__':
+    if len(sys.argv) != 2:
+        print("Usage: %s <flight recording>" % sys.argv[0])
+        sys.exit(1)
+
+    print_timeline(read_events(sys.argv[1]))
@@ -23,6 +23,9 @@
 #include <system/window.h>
 #pragma GCC diagnostic pop
 
+#include <algorithm>
+#include <ratio>
+
 #include <boost/concept_check.hpp>
 
 #include "ac/logger.h"
@@ -49,6 +52,12 @@ static constexpr int32_t kDefaultBitrate = 5000000;
 // By default send an I frame every 15 seconds which is the
 // same Android currently configures in its WiFi Display code path.
 static constexpr std::chrono::seconds kDefaultIFrameInterval{15};
+// Percentage of all macroblocks refreshed with each frame by the
+// cyclic intra refresh
+static constexpr int32_t kIntraRefreshPercentage = 10;
+// Frame rate we assume for the intra refresh sweep if the configuration
+// doesn't tell us
+static constexpr int32_t kAssumedFramerate = 30;
 // From frameworks/av/include/media/stagefright/MediaErrors.h
 enum AndroidMediaError {
     kAndroidMediaErrorBase = -1000,
@@ -208,7 +217,8 @@ bool H264Encoder::Configure(const Config &config) {
     // completely update a whole video frame. If the frame rate is 30,
     // it takes about 333 ms in the best case (if next frame is not an IDR)
     // to recover from a lost/corrupted packet.
-    const int32_t mbs = (((config.width + 15) / 16) * ((config.height + 15) / 16) * 10) / 100;
+    const int32_t total_mbs = ((config.width + 15) / 16) * ((config.height + 15) / 16);
+    const int32_t mbs = (total_mbs * kIntraRefreshPercentage) / 100;
     media_message_set_int32(format, kFormatKeyIntraRefreshCIRMbs, mbs);
 
     if (config.i_frame_interval > 0)
@@ -293,6 +303,14 @@ bool H264Encoder::Configure(const Config &config) {
     format_ = format;
     source_format_ = source_format;
 
+    // Requests for IDR frames coming in shortly after the last one was
+    // sent can be left to the intra refresh sweep if it is fast enough.
+    if (mbs > 0) {
+        const auto framerate = config.framerate > 0 ? config.framerate : kAssumedFramerate;
+        const auto frames = (total_mbs + mbs - 1) / mbs;
+        idr_scheduler_.SetRefreshPeriod((frames * std::micro::den) / framerate);
+    }
+
     AC_DEBUG("Configured encoder succesfully");
 
     return true;
@@ -405,7 +423,12 @@ int H264Encoder::OnSourceRead(MediaBufferWrapper **buffer, void *user_data) {
 
     *buffer = next_buffer;
 
-    thiz->report_->BeganFrame(input_buffer->Timestamp());
+    {
+        std::lock_guard<std::mutex> l(thiz->frames_mutex_);
+        thiz->frames_in_flight_.push_back(FrameItem{input_buffer->Timestamp(), input_buffer->FrameNumber()});
+    }
+
+    thiz->report_->BeganFrame(input_buffer->FrameNumber(), input_buffer->Timestamp());
 
     return 0;
 }
@@ -460,6 +483,9 @@ bool H264Encoder::Execute() {
         return false;
     }
 
+    if (idr_scheduler_.Poll())
+        EmitIDRFrame();
+
     MediaBufferWrapper *buffer = nullptr;
     if (!media_codec_source_read(encoder_, &buffer)) {
         AC_ERROR("Failed to read a new buffer from encoder");
@@ -468,9 +494,22 @@ bool H264Encoder::Execute() {
 
     auto mbuf = MediaSourceBuffer::Create(buffer);
 
-    report_->FinishedFrame(mbuf->Timestamp());
+    const auto is_codec_config = DoesBufferContainCodecConfig(buffer);
+
+    // The encoder only gives us the timestamp from its own meta data
+    // back which isn't guaranteed to be the one we fed in. Restore
+    // what we know about the frame it just finished.
+    if (!is_codec_config) {
+        const auto item = TakeFrameInFlight(mbuf->Timestamp());
+        if (item.frame > 0) {
+            mbuf->SetTimestamp(item.timestamp);
+            mbuf->SetFrameNumber(item.frame);
+        }
+    }
+
+    report_->FinishedFrame(mbuf->FrameNumber(), mbuf->Timestamp());
 
-    if (DoesBufferContainCodecConfig(buffer)) {
+    if (is_codec_config) {
         if (auto sp = delegate_.lock())
             sp->OnBufferWithCodecConfig(mbuf);
     }
@@ -481,6 +520,29 @@ bool H264Encoder::Execute() {
     return true;
 }
 
+bool H264Encoder::Reset() {
+    if (!encoder_ || running_)
+        return false;
+
+    // The media source passed to the codec source when configuring
+    // is owned by it and goes away together with it.
+    media_codec_source_release(encoder_);
+    encoder_ = nullptr;
+
+    media_message_release(format_);
+    format_ = nullptr;
+
+    media_meta_data_release(source_format_);
+    source_format_ = nullptr;
+
+    config_ = Config();
+
+    idr_scheduler_.Reset();
+    idr_scheduler_.SetRefreshPeriod(0);
+
+    return true;
+}
+
 bool H264Encoder::Stop() {
     if (!encoder_ || !running_)
         return false;
@@ -501,7 +563,30 @@ void H264Encoder::QueueBuffer(const video::Buffer::Ptr &buffer) {
 
     input_queue_->Push(buffer);
 
-    report_->ReceivedInputBuffer(buffer->Timestamp());
+    report_->ReceivedInputBuffer(buffer->FrameNumber(), buffer->Timestamp());
+}
+
+H264Encoder::FrameItem H264Encoder::TakeFrameInFlight(const ac::TimestampUs &timestamp) {
+    std::lock_guard<std::mutex> l(frames_mutex_);
+
+    if (frames_in_flight_.empty())
+        return FrameItem{timestamp, 0};
+
+    auto iter = std::find_if(frames_in_flight_.begin(), frames_in_flight_.end(),
+                             [&](const FrameItem &item) { return item.timestamp == timestamp; });
+
+    // We don't configure any B-frames so the encoder gives us the
+    // frames back in the order we fed them. If it rewrote the timestamp
+    // the oldest frame is the one we got.
+    if (iter == frames_in_flight_.end())
+        iter = frames_in_flight_.begin();
+
+    const auto item = *iter;
+
+    // Everything queued before was dropped by the encoder
+    frames_in_flight_.erase(frames_in_flight_.begin(), iter + 1);
+
+    return item;
 }
 
 video::BaseEncoder::Config H264Encoder::Configuration() const {
@@ -514,7 +599,20 @@ void H264Encoder::SendIDRFrame() {
 
     AC_DEBUG("");
 
+    report_->RequestedIDRFrame();
+
+    if (idr_scheduler_.Request())
+        EmitIDRFrame();
+}
+
+void H264Encoder::EmitIDRFrame() {
     media_codec_source_request_idr_frame(encoder_);
+
+    report_->EmittedIDRFrame();
+}
+
+video::IdrScheduler::Statistics H264Encoder::IDRStatistics() const {
+    return idr_scheduler_.Stats();
 }
 
 std::string H264Encoder::Name() const {
@@ -18,7 +18,9 @@
 #ifndef AC_ANDORID_ENCODER_H_
 #define AC_ANDORID_ENCODER_H_
 
+#include <deque>
 #include <memory>
+#include <mutex>
 #include <thread>
 
 #include <hybris/media/media_codec_source_layer.h>
@@ -31,6 +33,7 @@
 #include "ac/video/baseencoder.h"
 #include "ac/video/encoderreport.h"
 #include "ac/video/bufferqueue.h"
+#include "ac/video/idrscheduler.h"
 
 namespace ac {
 namespace android {
@@ -46,6 +49,7 @@ public:
     BaseEncoder::Config DefaultConfiguration() override;
 
     bool Configure(const BaseEncoder::Config &config) override;
+    bool Reset() override;
 
     void QueueBuffer(const ac::video::Buffer::Ptr &buffer) override;
 
@@ -54,6 +58,8 @@ public:
 
     void SendIDRFrame() override;
 
+    video::IdrScheduler::Statistics IDRStatistics() const;
+
     // From ac::common::Executable
     bool Start() override;
     bool Stop() override;
@@ -81,6 +87,15 @@ private:
         MediaBufferWrapper *media_buffer;
     };
 
+    struct FrameItem {
+        ac::TimestampUs timestamp;
+        video::FrameNumber frame;
+    };
+
+    FrameItem TakeFrameInFlight(const ac::TimestampUs &timestamp);
+
+    void EmitIDRFrame();
+
 private:
     video::EncoderReport::Ptr report_;
     BaseEncoder::Config config_;
@@ -90,8 +105,12 @@ private:
     bool running_;
     ac::video::BufferQueue::Ptr input_queue_;
     std::vector<BufferItem> pending_buffers_;
+    std::mutex frames_mutex_;
+    // Frames handed to the encoder in the order we did so
+    std::deque<FrameItem> frames_in_flight_;
     ac::TimestampUs start_time_;
     uint32_t frame_count_;
+    video::IdrScheduler idr_scheduler_;
 };
 
 } // namespace android
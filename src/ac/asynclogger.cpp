@@ -0,0 +1,191 @@
+/*
+ * Copyright (C) 2016 Canonical, Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 3, as published
+ * by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranties of
+ * MERCHANTABILITY, SATISFACTORY QUALITY, or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <time.h>
+
+#include <algorithm>
+
+#include "ac/asynclogger.h"
+
+namespace {
+std::atomic<std::uint64_t> next_logger_id{1};
+}
+
+namespace ac {
+
+constexpr std::size_t AsyncLogger::kRecordsPerThread;
+constexpr std::chrono::milliseconds AsyncLogger::kDrainInterval;
+
+AsyncLogger::ThreadQueue::ThreadQueue(std::size_t capacity) :
+    records(capacity),
+    dropped(0),
+    orphaned(false) {
+}
+
+AsyncLogger::AsyncLogger(std::ostream &out, const Severity &severity) :
+    id_(next_logger_id.fetch_add(1)),
+    out_(out),
+    severity_(severity),
+    dropped_(0),
+    running_(true),
+    thread_(&AsyncLogger::Run, this) {
+}
+
+AsyncLogger::~AsyncLogger() {
+    {
+        std::lock_guard<std::mutex> lock(wait_mutex_);
+        running_ = false;
+    }
+    wait_cv_.notify_all();
+    thread_.join();
+
+    DrainQueues();
+}
+
+void AsyncLogger::Init(const Severity &severity) {
+    severity_.store(severity);
+}
+
+bool AsyncLogger::IsEnabled(Severity severity) const {
+    return severity >= severity_.load(std::memory_order_relaxed);
+}
+
+void AsyncLogger::Log(Severity severity, const std::string &message, const boost::optional<Location> &location) {
+    if (!IsEnabled(severity))
+        return;
+
+    auto queue = QueueForCurrentThread();
+
+    Record record{severity, std::chrono::system_clock::now(), message, location};
+    if (!queue->records.Push(std::move(record)))
+        queue->dropped.fetch_add(1, std::memory_order_relaxed);
+}
+
+void AsyncLogger::Flush() {
+    DrainQueues();
+}
+
+std::uint64_t AsyncLogger::DroppedMessages() const {
+    return dropped_.load();
+}
+
+AsyncLogger::ThreadQueue* AsyncLogger::QueueForCurrentThread() {
+    struct Cache {
+        ~Cache() {
+            if (queue)
+                queue->orphaned.store(true);
+        }
+
+        std::uint64_t logger_id{0};
+        std::shared_ptr<ThreadQueue> queue;
+    };
+
+    static thread_local Cache cache;
+
+    if (cache.logger_id == id_)
+        return cache.queue.get();
+
+    // Either the first message from this thread or it logged to another
+    // logger instance before. The old queue will be cleaned up by its
+    // logger.
+    if (cache.queue)
+        cache.queue->orphaned.store(true);
+
+    auto queue = std::make_shared<ThreadQueue>(kRecordsPerThread);
+    {
+        std::lock_guard<std::mutex> lock(queues_mutex_);
+        queues_.push_back(queue);
+    }
+
+    cache.logger_id = id_;
+    cache.queue = queue;
+
+    return queue.get();
+}
+
+void AsyncLogger::Run() {
+    Utils::SetThreadName("AsyncLogger");
+
+    std::unique_lock<std::mutex> lock(wait_mutex_);
+    while (running_) {
+        wait_cv_.wait_for(lock, kDrainInterval);
+
+        lock.unlock();
+        DrainQueues();
+        lock.lock();
+    }
+}
+
+void AsyncLogger::DrainQueues() {
+    std::lock_guard<std::mutex> drain_lock(drain_mutex_);
+
+    std::vector<std::shared_ptr<ThreadQueue>> queues;
+    {
+        std::lock_guard<std::mutex> lock(queues_mutex_);
+        queues = queues_;
+    }
+
+    std::vector<Record> records;
+    std::uint64_t dropped = 0;
+
+    for (const auto &queue : queues) {
+        queue->records.Drain([&](Record &&record) {
+            records.push_back(std::move(record));
+        });
+        dropped += queue->dropped.exchange(0);
+    }
+
+    {
+        // Nothing gets added to orphaned queues anymore so once they are
+        // empty they can go.
+        std::lock_guard<std::mutex> lock(queues_mutex_);
+        queues_.erase(std::remove_if(queues_.begin(), queues_.end(), [](const std::shared_ptr<ThreadQueue> &queue) {
+            return queue->orphaned.load() && queue->records.Empty();
+        }), queues_.end());
+    }
+
+    if (records.size() == 0 && dropped == 0)
+        return;
+
+    // Every thread has its own queue so we have to restore the order
+    // in which things happened.
+    std::stable_sort(records.begin(), records.end(), [](const Record &a, const Record &b) {
+        return a.timestamp < b.timestamp;
+    });
+
+    for (const auto &record : records) {
+        const auto time = std::chrono::system_clock::to_time_t(record.timestamp);
+        struct tm tm;
+        gmtime_r(&time, &tm);
+        char formatted_time[20];
+        strftime(formatted_time, sizeof(formatted_time), "%Y-%m-%d %H:%M:%S", &tm);
+
+        out_ << "[" << record.severity << " " << formatted_time << "] ";
+        if (record.location)
+            out_ << "[" << *record.location << "] ";
+        out_ << record.message << "\n";
+    }
+
+    if (dropped > 0) {
+        dropped_.fetch_add(dropped);
+        out_ << "[" << Severity::kWarning << "] Dropped " << dropped << " log messages\n";
+    }
+
+    out_.flush();
+}
+
+} // namespace ac
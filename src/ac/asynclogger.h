@@ -0,0 +1,98 @@
+/*
+ * Copyright (C) 2016 Canonical, Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 3, as published
+ * by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranties of
+ * MERCHANTABILITY, SATISFACTORY QUALITY, or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef AC_ASYNCLOGGER_H_
+#define AC_ASYNCLOGGER_H_
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "ac/logger.h"
+
+#include "ac/common/ringbuffer.h"
+
+namespace ac {
+// AsyncLogger keeps the cost of logging on the calling thread as low
+// as possible. Messages below the configured severity are dropped
+// before they are even formatted. All others go into a lock-free queue
+// owned by the calling thread and a background thread writes them out
+// in batches. If a thread logs faster than that its messages are
+// dropped instead of blocking it.
+class AsyncLogger : public Logger {
+public:
+    static constexpr std::size_t kRecordsPerThread{512};
+    static constexpr std::chrono::milliseconds kDrainInterval{20};
+
+    explicit AsyncLogger(std::ostream &out = std::cout, const Severity &severity = Severity::kInfo);
+    ~AsyncLogger();
+
+    // Sets the minimum severity of messages which are written out
+    void Init(const Severity &severity = Severity::kWarning) override;
+
+    bool IsEnabled(Severity severity) const override;
+
+    void Log(Severity severity, const std::string &message, const boost::optional<Location> &location) override;
+
+    // Writes out everything logged until now
+    void Flush();
+
+    // Number of messages dropped because a queue was full
+    std::uint64_t DroppedMessages() const;
+
+private:
+    struct Record {
+        Severity severity;
+        std::chrono::system_clock::time_point timestamp;
+        std::string message;
+        boost::optional<Location> location;
+    };
+
+    struct ThreadQueue {
+        explicit ThreadQueue(std::size_t capacity);
+
+        common::RingBuffer<Record> records;
+        std::atomic<std::uint64_t> dropped;
+        // Set when the thread is gone and nothing will be added anymore
+        std::atomic<bool> orphaned;
+    };
+
+    ThreadQueue* QueueForCurrentThread();
+    void Run();
+    void DrainQueues();
+
+private:
+    const std::uint64_t id_;
+    std::ostream &out_;
+    std::atomic<Severity> severity_;
+    std::atomic<std::uint64_t> dropped_;
+    std::mutex queues_mutex_;
+    std::vector<std::shared_ptr<ThreadQueue>> queues_;
+    std::mutex drain_mutex_;
+    std::mutex wait_mutex_;
+    std::condition_variable wait_cv_;
+    bool running_;
+    std::thread thread_;
+};
+} // namespace ac
+
+#endif
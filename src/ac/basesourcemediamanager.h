@@ -35,6 +35,11 @@ public:
 
     explicit BaseSourceMediaManager();
 
+    // Called once the RTSP session with the sink begins. Gives us the
+    // chance to start setting up everything expensive before the
+    // video format gets negotiated.
+    virtual void Prepare() { }
+
     void SetDelegate(const std::weak_ptr<Delegate> &delegate);
     void ResetDelegate();
 
@@ -0,0 +1,97 @@
+/*
+ * Copyright (C) 2016 Canonical, Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 3, as published
+ * by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranties of
+ * MERCHANTABILITY, SATISFACTORY QUALITY, or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef AC_COMMON_RINGBUFFER_H_
+#define AC_COMMON_RINGBUFFER_H_
+
+#include <atomic>
+#include <cstddef>
+#include <vector>
+
+#include "ac/non_copyable.h"
+
+namespace ac {
+namespace common {
+
+// Bounded queue for exactly one producer and one consumer thread which
+// never blocks or takes a lock. The capacity is rounded up to the next
+// power of two.
+template<typename T>
+class RingBuffer : public ac::NonCopyable {
+public:
+    explicit RingBuffer(std::size_t capacity) :
+        slots_(RoundUpToPowerOfTwo(capacity)),
+        mask_(slots_.size() - 1),
+        head_(0),
+        tail_(0) {
+    }
+
+    // Only to be called from the producer. Returns false if the buffer
+    // is full and leaves the item untouched in that case.
+    bool Push(T &&item) {
+        const auto head = head_.load(std::memory_order_relaxed);
+        if (head - tail_.load(std::memory_order_acquire) == slots_.size())
+            return false;
+
+        slots_[head & mask_] = std::move(item);
+        head_.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Only to be called from the consumer. Hands all currently queued
+    // items to the callback and returns how many there were.
+    template<typename F>
+    std::size_t Drain(F callback) {
+        auto tail = tail_.load(std::memory_order_relaxed);
+        const auto head = head_.load(std::memory_order_acquire);
+
+        const auto count = head - tail;
+        for (; tail != head; tail++)
+            callback(std::move(slots_[tail & mask_]));
+
+        tail_.store(tail, std::memory_order_release);
+        return count;
+    }
+
+    bool Empty() const {
+        return head_.load(std::memory_order_acquire) == tail_.load(std::memory_order_acquire);
+    }
+
+    std::size_t Capacity() const {
+        return slots_.size();
+    }
+
+private:
+    static std::size_t RoundUpToPowerOfTwo(std::size_t value) {
+        std::size_t result = 1;
+        while (result < value)
+            result <<= 1;
+        return result;
+    }
+
+private:
+    std::vector<T> slots_;
+    const std::size_t mask_;
+    // Both only ever grow, the slot is taken modulo the capacity
+    std::atomic<std::size_t> head_;
+    std::atomic<std::size_t> tail_;
+};
+
+} // namespace common
+} // namespace ac
+
+#endif
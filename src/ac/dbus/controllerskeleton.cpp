@@ -21,6 +21,7 @@
 
 #include "ac/glib_wrapper.h"
 
+#include "ac/config.h"
 #include "ac/keep_alive.h"
 #include "ac/utils.h"
 #include "ac/logger.h"
@@ -29,8 +30,17 @@
 #include "ac/dbus/errors.h"
 #include "ac/dbus/helpers.h"
 
+#include "ac/report/metrics/registry.h"
+#include "ac/report/recorder/flightrecorder.h"
+#include "ac/report/timeline/connectiontimeline.h"
+
 namespace {
 constexpr const char *kManagerSkeletonInstanceKey{"controller-skeleton"};
+constexpr const char *kMetricsPropertyName{"Metrics"};
+constexpr const char *kConnectionTimelinePropertyName{"ConnectionTimeline"};
+// Getter of the generated skeleton we fall back to for all properties
+// we don't handle ourself.
+GDBusInterfaceGetPropertyFunc skeleton_get_property = nullptr;
 }
 
 namespace ac {
@@ -127,6 +137,27 @@ static std::string HyphenNameFromPropertyName(const std::string &property_name)
     return hyphen_name;
 }
 
+GVariant* ControllerSkeleton::OnGetProperty(GDBusConnection *connection, const gchar *sender,
+                                            const gchar *object_path, const gchar *interface_name,
+                                            const gchar *property_name, GError **error,
+                                            gpointer user_data) {
+
+    // Metrics change far too often to keep the property in sync and
+    // send out change notifications so we only gather them when asked.
+    if (g_strcmp0(property_name, kMetricsPropertyName) == 0)
+        return Helpers::GenerateMetrics(report::metrics::Registry::Instance()->TakeSnapshot());
+
+    // Same for the timeline which is stamped from the streaming threads.
+    if (g_strcmp0(property_name, kConnectionTimelinePropertyName) == 0) {
+        const auto timeline = report::timeline::ConnectionTimeline::Instance();
+        return Helpers::GenerateConnectionTimeline(
+                    timeline ? timeline->Breakdown() : std::vector<report::timeline::ConnectionTimeline::Entry>{});
+    }
+
+    return skeleton_get_property(connection, sender, object_path, interface_name,
+                                 property_name, error, user_data);
+}
+
 gboolean ControllerSkeleton::OnSetProperty(GDBusConnection *connection, const gchar *sender,
                                                    const gchar *object_path, const gchar *interface_name,
                                                    const gchar *property_name, GVariant *variant,
@@ -181,9 +212,14 @@ void ControllerSkeleton::OnNameAcquired(GDBusConnection *connection, const gchar
 
     // We override the property setter method of the skeleton's vtable
     // here to apply some more policy decisions when the user sets
-    // specific properties which are state dependent.
+    // specific properties which are state dependent. The getter is
+    // overridden to produce the metrics on demand.
     auto vtable = g_dbus_interface_skeleton_get_vtable(G_DBUS_INTERFACE_SKELETON(inst->manager_obj_.get()));
     vtable->set_property = &ControllerSkeleton::OnSetProperty;
+    if (vtable->get_property != &ControllerSkeleton::OnGetProperty) {
+        skeleton_get_property = vtable->get_property;
+        vtable->get_property = &ControllerSkeleton::OnGetProperty;
+    }
 
     g_signal_connect_data(inst->manager_obj_.get(), "handle-scan",
                      G_CALLBACK(&ControllerSkeleton::OnHandleScan),
@@ -197,6 +233,12 @@ void ControllerSkeleton::OnNameAcquired(GDBusConnection *connection, const gchar
                      [](gpointer data, GClosure *) { delete static_cast<WeakKeepAlive<ControllerSkeleton>*>(data); },
                      GConnectFlags(0));
 
+    g_signal_connect_data(inst->manager_obj_.get(), "handle-dump-flight-recording",
+                     G_CALLBACK(&ControllerSkeleton::OnHandleDumpFlightRecording),
+                     new WeakKeepAlive<ControllerSkeleton>(inst),
+                     [](gpointer data, GClosure *) { delete static_cast<WeakKeepAlive<ControllerSkeleton>*>(data); },
+                     GConnectFlags(0));
+
     inst->SyncProperties();
 
     g_dbus_interface_skeleton_export(G_DBUS_INTERFACE_SKELETON(inst->manager_obj_.get()),
@@ -260,6 +302,29 @@ gboolean ControllerSkeleton::OnHandleDisconnectAll(AethercastInterfaceManager *s
     return TRUE;
 }
 
+gboolean ControllerSkeleton::OnHandleDumpFlightRecording(AethercastInterfaceManager *skeleton,
+                                                         GDBusMethodInvocation *invocation, gpointer user_data) {
+    boost::ignore_unused_variable_warning(user_data);
+
+    const auto recorder = ac::report::recorder::FlightRecorder::Instance();
+    if (!recorder) {
+        g_dbus_method_invocation_return_error(invocation, AETHERCAST_ERROR,
+            AETHERCAST_ERROR_NOT_READY, "Flight recorder is disabled");
+        return TRUE;
+    }
+
+    const auto path = recorder->DumpToDirectory(ac::kStateDir);
+    if (path.length() == 0) {
+        g_dbus_method_invocation_return_error(invocation, AETHERCAST_ERROR,
+            AETHERCAST_ERROR_FAILED, "Failed to write flight recording");
+        return TRUE;
+    }
+
+    aethercast_interface_manager_complete_dump_flight_recording(skeleton, invocation, path.c_str());
+
+    return TRUE;
+}
+
 std::shared_ptr<ControllerSkeleton> ControllerSkeleton::FinalizeConstruction() {
     auto sp = shared_from_this();
 
@@ -65,6 +65,13 @@ private:
                                  gpointer user_data);
     static gboolean OnHandleDisconnectAll(AethercastInterfaceManager *skeleton, GDBusMethodInvocation *invocation,
                                           gpointer user_data);
+    static gboolean OnHandleDumpFlightRecording(AethercastInterfaceManager *skeleton, GDBusMethodInvocation *invocation,
+                                                gpointer user_data);
+
+    static GVariant* OnGetProperty(GDBusConnection *connection, const gchar *sender,
+                                   const gchar *object_path, const gchar *interface_name,
+                                   const gchar *property_name, GError **error,
+                                   gpointer user_data);
 
     static gboolean OnSetProperty(GDBusConnection *connection, const gchar *sender,
                                   const gchar *object_path,const gchar *interface_name,
@@ -40,6 +40,25 @@ gchar** Helpers::GenerateCapabilities(const std::vector<NetworkManager::Capabili
     return out_capabilities;
 }
 
+GVariant* Helpers::GenerateMetrics(const std::map<std::string, double> &metrics) {
+    GVariantBuilder builder;
+    g_variant_builder_init(&builder, G_VARIANT_TYPE("a{sd}"));
+    for (const auto &metric : metrics)
+        g_variant_builder_add(&builder, "{sd}", metric.first.c_str(), metric.second);
+    return g_variant_builder_end(&builder);
+}
+
+GVariant* Helpers::GenerateConnectionTimeline(const std::vector<report::timeline::ConnectionTimeline::Entry> &entries) {
+    GVariantBuilder builder;
+    g_variant_builder_init(&builder, G_VARIANT_TYPE("a(stt)"));
+    for (const auto &entry : entries)
+        g_variant_builder_add(&builder, "(stt)",
+                              report::timeline::ConnectionTimeline::PhaseToString(entry.phase).c_str(),
+                              static_cast<guint64>(entry.since_start),
+                              static_cast<guint64>(entry.since_previous));
+    return g_variant_builder_end(&builder);
+}
+
 void Helpers::ParseDictionary(GVariant *properties, std::function<void(std::string, GVariant*)> callback, const std::string &key_filter) {
     if (!callback || !properties)
         return;
@@ -19,17 +19,23 @@
 #define DBUSHELPERS_H_
 
 #include <functional>
+#include <map>
+#include <string>
 
 #include "ac/glib_wrapper.h"
 
 #include "ac/networkmanager.h"
 #include "ac/scoped_gobject.h"
 
+#include "ac/report/timeline/connectiontimeline.h"
+
 namespace ac {
 namespace dbus {
 struct Helpers {
     static gchar** GenerateCapabilities(const std::vector<NetworkManager::Capability> &capabilities);
     static gchar** GenerateDeviceCapabilities(const std::vector<NetworkDeviceRole> &roles);
+    static GVariant* GenerateMetrics(const std::map<std::string, double> &metrics);
+    static GVariant* GenerateConnectionTimeline(const std::vector<report::timeline::ConnectionTimeline::Entry> &entries);
     static void ParseDictionary(GVariant *properties, std::function<void(std::string, GVariant*)> callback, const std::string &key_filter = "");
     static void ParseArray(GVariant *array, std::function<void(GVariant*)> callback);
 };
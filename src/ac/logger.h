@@ -52,6 +52,10 @@ public:
 
     virtual void Log(Severity severity, const std::string &message, const boost::optional<Location>& location) = 0;
 
+    // IsEnabled allows callers to skip preparing messages which would
+    // not be logged anyway.
+    virtual bool IsEnabled(Severity severity) const;
+
     virtual void Trace(const std::string& message, const boost::optional<Location>& location = boost::optional<Location>{});
     virtual void Debug(const std::string& message, const boost::optional<Location>& location = boost::optional<Location>{});
     virtual void Info(const std::string& message, const boost::optional<Location>& location = boost::optional<Location>{});
@@ -62,31 +66,43 @@ public:
 
     template<typename... T>
     void Tracef(const boost::optional<Location>& location, const std::string& pattern, T&&...args) {
+        if (!IsEnabled(Severity::kTrace))
+            return;
         Trace(Utils::Sprintf(pattern, std::forward<T>(args)...), location);
     }
 
     template<typename... T>
     void Debugf(const boost::optional<Location>& location, const std::string& pattern, T&&...args) {
+        if (!IsEnabled(Severity::kDebug))
+            return;
         Debug(Utils::Sprintf(pattern, std::forward<T>(args)...), location);
     }
 
     template<typename... T>
     void Infof(const boost::optional<Location>& location, const std::string& pattern, T&&...args) {
+        if (!IsEnabled(Severity::kInfo))
+            return;
         Info(Utils::Sprintf(pattern, std::forward<T>(args)...), location);
     }
 
     template<typename... T>
     void Warningf(const boost::optional<Location>& location, const std::string& pattern, T&&...args) {
+        if (!IsEnabled(Severity::kWarning))
+            return;
         Warning(Utils::Sprintf(pattern, std::forward<T>(args)...), location);
     }
 
     template<typename... T>
     void Errorf(const boost::optional<Location>& location, const std::string& pattern, T&&...args) {
+        if (!IsEnabled(Severity::kError))
+            return;
         Error(Utils::Sprintf(pattern, std::forward<T>(args)...), location);
     }
 
     template<typename... T>
     void Fatalf(const boost::optional<Location>& location, const std::string& pattern, T&&...args) {
+        if (!IsEnabled(Severity::kFatal))
+            return;
         Fatal(Utils::Sprintf(pattern, std::forward<T>(args)...), location);
     }
 
@@ -107,11 +123,17 @@ Logger& Log();
 void SetLogger(const std::shared_ptr<Logger>& logger);
 }
 
-#define AC_TRACE(...) ac::Log().Tracef(ac::Logger::Location{__FILE__, __FUNCTION__, __LINE__}, __VA_ARGS__)
-#define AC_DEBUG(...) ac::Log().Debugf(ac::Logger::Location{__FILE__, __FUNCTION__, __LINE__}, __VA_ARGS__)
-#define AC_INFO(...) ac::Log().Infof(ac::Logger::Location{__FILE__, __FUNCTION__, __LINE__}, __VA_ARGS__)
-#define AC_WARNING(...) ac::Log().Warningf(ac::Logger::Location{__FILE__, __FUNCTION__, __LINE__}, __VA_ARGS__)
-#define AC_ERROR(...) ac::Log().Errorf(ac::Logger::Location{__FILE__, __FUNCTION__, __LINE__}, __VA_ARGS__)
-#define AC_FATAL(...) ac::Log().Fatalf(ac::Logger::Location{__FILE__, __FUNCTION__, __LINE__}, __VA_ARGS__)
+// The severity is checked before anything else so disabled messages
+// don't cost more than a virtual call.
+#define AC_LOG_IF_ENABLED(severity, method, ...) \
+    (ac::Log().IsEnabled(severity) ? \
+        ac::Log().method(ac::Logger::Location{__FILE__, __FUNCTION__, __LINE__}, __VA_ARGS__) : void())
+
+#define AC_TRACE(...) AC_LOG_IF_ENABLED(ac::Logger::Severity::kTrace, Tracef, __VA_ARGS__)
+#define AC_DEBUG(...) AC_LOG_IF_ENABLED(ac::Logger::Severity::kDebug, Debugf, __VA_ARGS__)
+#define AC_INFO(...) AC_LOG_IF_ENABLED(ac::Logger::Severity::kInfo, Infof, __VA_ARGS__)
+#define AC_WARNING(...) AC_LOG_IF_ENABLED(ac::Logger::Severity::kWarning, Warningf, __VA_ARGS__)
+#define AC_ERROR(...) AC_LOG_IF_ENABLED(ac::Logger::Severity::kError, Errorf, __VA_ARGS__)
+#define AC_FATAL(...) AC_LOG_IF_ENABLED(ac::Logger::Severity::kFatal, Fatalf, __VA_ARGS__)
 
 #endif
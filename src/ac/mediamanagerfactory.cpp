@@ -32,6 +32,36 @@
 
 #include "ac/android/h264encoder.h"
 
+#include "ac/video/nullbufferproducer.h"
+#include "ac/video/replayencoder.h"
+
+namespace {
+unsigned int ScreencastBuffers() {
+    const auto value = ac::Utils::GetEnvValue("AETHERCAST_SCREENCAST_BUFFERS");
+    if (value.length() == 0)
+        return ac::mir::Screencast::kDefaultNumBuffers;
+
+    try {
+        return std::stoul(value);
+    } catch (...) {
+        AC_WARNING("Ignoring invalid number of screencast buffers '%s'", value);
+    }
+
+    return ac::mir::Screencast::kDefaultNumBuffers;
+}
+
+ac::video::ReplayEncoder::Pace ReplayPace() {
+    const auto value = ac::Utils::GetEnvValue("AETHERCAST_REPLAY_PACE");
+    if (value == "fast")
+        return ac::video::ReplayEncoder::Pace::kAsFastAsPossible;
+
+    if (value.length() > 0 && value != "realtime")
+        AC_WARNING("Ignoring invalid replay pace '%s'", value);
+
+    return ac::video::ReplayEncoder::Pace::kRealtime;
+}
+}
+
 namespace ac {
 
 void NullSourceMediaManager::Play() {
@@ -57,6 +87,7 @@ bool NullSourceMediaManager::Configure() {
 }
 
 std::shared_ptr<BaseSourceMediaManager> MediaManagerFactory::CreateSource(const std::string &remote_address,
+                                                                          const ac::MacAddress &sink_address,
                                                                           const ac::network::Stream::Ptr &output_stream) {
     std::string type = Utils::GetEnvValue("MIRACAST_SOURCE_TYPE");
     if (type.length() == 0)
@@ -67,17 +98,39 @@ std::shared_ptr<BaseSourceMediaManager> MediaManagerFactory::CreateSource(const
     if (type == "mir") {
         const auto executor_factory = std::make_shared<common::ThreadedExecutorFactory>();
         const auto report_factory = report::ReportFactory::Create();
-        const auto screencast = std::make_shared<ac::mir::Screencast>();
+        const auto screencast = std::make_shared<ac::mir::Screencast>(ScreencastBuffers());
         const auto encoder = ac::android::H264Encoder::Create(report_factory->CreateEncoderReport());
 
         return std::make_shared<ac::mir::SourceMediaManager>(
                     remote_address,
+                    sink_address,
                     executor_factory,
                     screencast,
                     encoder,
                     output_stream,
                     report_factory);
     }
+    else if (type == "replay") {
+        const auto path = Utils::GetEnvValue("AETHERCAST_REPLAY_FILE");
+        const auto report_factory = report::ReportFactory::Create();
+        const auto encoder = ac::video::ReplayEncoder::Create(
+                    path, report_factory->CreateEncoderReport(), ReplayPace(),
+                    !Utils::IsEnvSet("AETHERCAST_REPLAY_NO_LOOP"));
+
+        if (!encoder) {
+            AC_ERROR("Failed to setup replay of '%s'", path);
+            return std::make_shared<NullSourceMediaManager>();
+        }
+
+        return std::make_shared<ac::mir::SourceMediaManager>(
+                    remote_address,
+                    sink_address,
+                    std::make_shared<common::ThreadedExecutorFactory>(),
+                    std::make_shared<ac::video::NullBufferProducer>(),
+                    encoder,
+                    output_stream,
+                    report_factory);
+    }
 
     return std::make_shared<NullSourceMediaManager>();
 }
@@ -21,6 +21,7 @@
 #include <memory>
 
 #include "ac/basesourcemediamanager.h"
+#include "ac/mac_address.h"
 
 #include "ac/network/types.h"
 #include "ac/network/stream.h"
@@ -42,6 +43,7 @@ protected:
 class MediaManagerFactory {
 public:
     static std::shared_ptr<BaseSourceMediaManager> CreateSource(const std::string &remote_address,
+                                                                const ac::MacAddress &sink_address,
                                                                 const ac::network::Stream::Ptr &output_stream);
 };
 } // namespace ac
@@ -15,6 +15,9 @@
  *
  */
 
+#include <algorithm>
+#include <utility>
+
 #include <boost/concept_check.hpp>
 
 #include "ac/logger.h"
@@ -23,20 +26,153 @@
 namespace {
 static constexpr const char *kMirSocket{"/run/mir_socket"};
 static constexpr const char *kMirConnectionName{"aethercast screencast client"};
+// Sampling grid for detecting content changes. With 1280x720 this
+// reads 14400 pixels, about 1.5% of the frame. Each sampled row starts
+// at a different column so thin vertical lines don't slip through.
+static constexpr int kFingerprintRowStep{4};
+static constexpr int kFingerprintColumnStep{16};
+// All formats we get for a screencast use 32 bits per pixel
+static constexpr int kFingerprintBytesPerPixel{4};
+static constexpr std::uint64_t kFnvOffsetBasis{14695981039346656037ull};
+static constexpr std::uint64_t kFnvPrime{1099511628211ull};
+
+bool IsRotated(MirOrientation orientation) {
+    return orientation == mir_orientation_left ||
+           orientation == mir_orientation_right;
+}
+
+// The region of the active output in the display layout. The display
+// mode is always in the native orientation of the panel. When the
+// output is rotated, e.g. a phone with a portrait panel held in
+// landscape, the logical size is swapped and the compositor renders
+// the content upright for us.
+MirRectangle OutputRegion(const MirDisplayOutput *output) {
+    const MirDisplayMode *mode = &output->modes[output->current_mode];
+
+    unsigned int width = mode->horizontal_resolution;
+    unsigned int height = mode->vertical_resolution;
+    if (IsRotated(output->orientation))
+        std::swap(width, height);
+
+    MirRectangle region;
+    region.left = output->position_x;
+    region.top = output->position_y;
+    region.width = width;
+    region.height = height;
+    return region;
+}
+
+bool Overlaps(const MirRectangle &a, const MirRectangle &b) {
+    return a.left < b.left + static_cast<int>(b.width) &&
+           b.left < a.left + static_cast<int>(a.width) &&
+           a.top < b.top + static_cast<int>(b.height) &&
+           b.top < a.top + static_cast<int>(a.height);
+}
+
+// Calculates the region we have to capture to get the output scaled
+// into a buffer of the size the sink requested without distorting it.
+// If the aspect ratios differ the region is extended on both sides of
+// the output, which leaves nothing for the compositor to draw there
+// but black bars (letterboxing or pillarboxing) around the centred
+// output. Returns false if that would pull in another output instead.
+bool MirrorCaptureRegion(const MirDisplayConfiguration *config, const MirDisplayOutput *output,
+                         const ac::video::DisplayOutput &sink, MirRectangle &region) {
+    region = OutputRegion(output);
+
+    if (sink.width == 0 || sink.height == 0)
+        return false;
+
+    // Compare width / height against sink.width / sink.height without
+    // going through floating point.
+    const auto scaled_width = static_cast<uint64_t>(region.height) * sink.width;
+    const auto scaled_height = static_cast<uint64_t>(region.width) * sink.height;
+
+    if (scaled_height > scaled_width) {
+        // Wider than the sink, bars above and below
+        const unsigned int height = (scaled_height + sink.width / 2) / sink.width;
+        region.top -= (height - region.height) / 2;
+        region.height = height;
+    } else if (scaled_width > scaled_height) {
+        // Taller than the sink, bars left and right
+        const unsigned int width = (scaled_width + sink.height / 2) / sink.height;
+        region.left -= (width - region.width) / 2;
+        region.width = width;
+    }
+
+    for (unsigned int i = 0; i < config->num_outputs; ++i) {
+        const auto other = &config->outputs[i];
+        if (other == output || !other->used || other->current_mode >= other->num_modes)
+            continue;
+
+        if (Overlaps(region, OutputRegion(other)))
+            return false;
+    }
+
+    return true;
+}
+
+std::uint64_t Fingerprint(const MirGraphicsRegion &region) {
+    const int width = std::min(region.width, region.stride / kFingerprintBytesPerPixel);
+
+    std::uint64_t hash = kFnvOffsetBasis;
+    for (int y = 0; y < region.height; y += kFingerprintRowStep) {
+        const auto row = reinterpret_cast<const std::uint32_t*>(region.vaddr + y * region.stride);
+        const int offset = (y / kFingerprintRowStep) % kFingerprintColumnStep;
+        for (int x = offset; x < width; x += kFingerprintColumnStep) {
+            hash ^= row[x];
+            hash *= kFnvPrime;
+        }
+    }
+    return hash;
+}
+
+MirRectangle ExtendCaptureRegion(const MirDisplayOutput *output) {
+    const MirDisplayMode *mode = &output->modes[output->current_mode];
+
+    MirRectangle region;
+    // If we request a screen region outside the available screen area
+    // mir will create a mir output which is then available for everyone
+    // as just another display.
+    region.left = mode->horizontal_resolution;
+    region.top = 0;
+    region.width = mode->vertical_resolution;
+    region.height = mode->horizontal_resolution;
+    return region;
+}
 }
 
 namespace ac {
 namespace mir {
 
-Screencast::Screencast() :
+constexpr unsigned int Screencast::kDefaultNumBuffers;
+constexpr unsigned int Screencast::kMinNumBuffers;
+constexpr unsigned int Screencast::kMaxNumBuffers;
+
+Screencast::Screencast(unsigned int num_buffers) :
     connection_(nullptr),
     screencast_(nullptr),
-    buffer_stream_(nullptr) {
+    buffer_stream_(nullptr),
+    num_buffers_(std::max(kMinNumBuffers, std::min(num_buffers, kMaxNumBuffers))),
+    swap_pending_(false),
+    has_fingerprint_(false),
+    last_fingerprint_(0) {
+
+    if (num_buffers_ != num_buffers)
+        AC_WARNING("Invalid number of buffers %d, using %d instead",
+                   num_buffers, num_buffers_);
 }
 
 Screencast::~Screencast() {
     AC_DEBUG("");
 
+    // Don't let a swap still in progress call back into us after
+    // we're gone. A swap is pending from before it is handed to Mir
+    // so this also covers one which was just being started.
+    {
+        std::unique_lock<std::mutex> l(swap_mutex_);
+        swap_done_.wait(l, [&]() { return !swap_pending_; });
+    }
+
     if (screencast_)
         mir_screencast_release_sync(screencast_);
 
@@ -44,11 +180,37 @@ Screencast::~Screencast() {
         mir_connection_release(connection_);
 }
 
+bool Screencast::Connect() {
+    connection_ = mir_connect_sync(kMirSocket, kMirConnectionName);
+    if (!mir_connection_is_valid(connection_)) {
+        AC_ERROR("Failed to connect to Mir server: %s",
+                  mir_connection_get_error_message(connection_));
+
+        // Leave the way free for another attempt from Setup()
+        if (connection_)
+            mir_connection_release(connection_);
+        connection_ = nullptr;
+        return false;
+    }
+
+    return true;
+}
+
+bool Screencast::Prepare() {
+    if (connection_)
+        return true;
+
+    AC_DEBUG("Connecting to Mir ahead of screencast setup");
+
+    return Connect();
+}
+
 bool Screencast::Setup(const video::DisplayOutput &output) {
-    if (screencast_ || connection_ || buffer_stream_)
+    if (screencast_ || buffer_stream_)
         return false;
 
-    if (output.mode != video::DisplayOutput::Mode::kExtend) {
+    if (output.mode != video::DisplayOutput::Mode::kMirror &&
+        output.mode != video::DisplayOutput::Mode::kExtend) {
         AC_ERROR("Unsupported display output mode specified '%s'", output.mode);
         return false;
     }
@@ -56,12 +218,9 @@ bool Screencast::Setup(const video::DisplayOutput &output) {
     AC_DEBUG("Setting up screencast [%s %dx%d]", output.mode,
               output.width, output.height);
 
-    connection_ = mir_connect_sync(kMirSocket, kMirConnectionName);
-    if (!mir_connection_is_valid(connection_)) {
-        AC_ERROR("Failed to connect to Mir server: %s",
-                  mir_connection_get_error_message(connection_));
+    // Unless Prepare() did it already
+    if (!connection_ && !Connect())
         return false;
-    }
 
     const auto config = mir_connection_create_display_config(connection_);
     if (!config) {
@@ -102,24 +261,31 @@ bool Screencast::Setup(const video::DisplayOutput &output) {
     mir_screencast_spec_set_height(spec, output.height);
 
     MirRectangle region;
-    // If we request a screen region outside the available screen area
-    // mir will create a mir output which is then available for everyone
-    // as just another display.
-    region.left = display_mode->horizontal_resolution;
-    region.top = 0;
-    region.width = display_mode->vertical_resolution;
-    region.height = display_mode->horizontal_resolution;
+    if (output.mode == video::DisplayOutput::Mode::kMirror) {
+        // Streaming distorted or someone else's content is worse than
+        // not streaming at all.
+        if (!MirrorCaptureRegion(config, active_output, output, region)) {
+            AC_ERROR("Can't fit output into sink (%ix%i) without capturing another output",
+                     output.width, output.height);
+            mir_screencast_spec_release(spec);
+            return false;
+        }
+    } else {
+        region = ExtendCaptureRegion(active_output);
+    }
 
     mir_screencast_spec_set_capture_region(spec, &region);
 
     output_.refresh_rate = display_mode->refresh_rate;
 
-    AC_INFO("Selected output ID %i [(%ix%i)+(%ix%i)] orientation %d",
+    AC_INFO("Selected output ID %i [(%ix%i)+(%ix%i)] orientation %d capturing (%ix%i)+(%ix%i)",
              output_index,
              display_mode->vertical_resolution,
              display_mode->horizontal_resolution,
-             region.left, region.top,
-             active_output->orientation);
+             active_output->position_x, active_output->position_y,
+             active_output->orientation,
+             region.width, region.height,
+             region.left, region.top);
 
     unsigned int num_pixel_formats = 0;
     MirPixelFormat pixel_format;
@@ -133,7 +299,7 @@ bool Screencast::Setup(const video::DisplayOutput &output) {
 
     mir_screencast_spec_set_pixel_format(spec, pixel_format);
     mir_screencast_spec_set_mirror_mode(spec, mir_mirror_mode_vertical);
-    mir_screencast_spec_set_number_of_buffers(spec, 2);
+    mir_screencast_spec_set_number_of_buffers(spec, num_buffers_);
 
     screencast_ = mir_screencast_create_sync(spec);
     mir_screencast_spec_release(spec);
@@ -161,6 +327,60 @@ void Screencast::SwapBuffers() {
     mir_buffer_stream_swap_buffers_sync(buffer_stream_);
 }
 
+void Screencast::SwapBuffersAsync(const SwapCallback &callback) {
+    if (!buffer_stream_) {
+        callback(false);
+        return;
+    }
+
+    {
+        std::unique_lock<std::mutex> l(swap_mutex_);
+        if (swap_pending_) {
+            l.unlock();
+            // The pending swap still completes its own callback
+            AC_WARNING("Swap of buffers already in progress");
+            callback(false);
+            return;
+        }
+
+        swap_callback_ = callback;
+        swap_pending_ = true;
+    }
+
+    // Mir may already call us back from within this call when a
+    // buffer is available right away so we must not hold the lock.
+    mir_buffer_stream_swap_buffers(buffer_stream_, &Screencast::OnSwapBuffersDone, this);
+}
+
+void Screencast::OnSwapBuffersDone(MirBufferStream *buffer_stream, void *context) {
+    auto thiz = static_cast<Screencast*>(context);
+
+    // Mir also completes the swap when it failed, e.g. when the
+    // server went away, and leaves us with an invalid stream then.
+    const bool success = mir_buffer_stream_is_valid(buffer_stream);
+    if (!success)
+        AC_ERROR("Failed to swap buffers: %s",
+                 mir_buffer_stream_get_error_message(buffer_stream));
+
+    SwapCallback callback;
+    {
+        std::lock_guard<std::mutex> l(thiz->swap_mutex_);
+        callback = std::move(thiz->swap_callback_);
+        thiz->swap_callback_ = nullptr;
+        thiz->swap_pending_ = false;
+        // Still under the lock as the destructor may go ahead and
+        // free us as soon as it sees the swap completed.
+        thiz->swap_done_.notify_all();
+    }
+
+    if (callback)
+        callback(success);
+}
+
+unsigned int Screencast::NumBuffers() const {
+    return num_buffers_;
+}
+
 video::DisplayOutput Screencast::OutputMode() const {
     return output_;
 }
@@ -173,5 +393,27 @@ void* Screencast::CurrentBuffer() const {
     mir_buffer_stream_get_current_buffer(buffer_stream_, &buffer);
     return reinterpret_cast<void*>(buffer);
 }
+
+bool Screencast::CurrentBufferChanged() const {
+    if (!buffer_stream_)
+        return true;
+
+    // Without access to the pixels we can't tell and have to assume
+    // something changed.
+    MirGraphicsRegion region;
+    if (!mir_buffer_stream_get_graphics_region(buffer_stream_, &region) ||
+        !region.vaddr || region.width <= 0 || region.height <= 0) {
+        has_fingerprint_ = false;
+        return true;
+    }
+
+    const auto fingerprint = Fingerprint(region);
+    const bool changed = !has_fingerprint_ || fingerprint != last_fingerprint_;
+
+    last_fingerprint_ = fingerprint;
+    has_fingerprint_ = true;
+
+    return changed;
+}
 } // namespace mir
 } // namespace ac
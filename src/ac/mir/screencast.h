@@ -18,7 +18,10 @@
 #ifndef AC_MIR_CONNECTOR_H_
 #define AC_MIR_CONNECTOR_H_
 
+#include <condition_variable>
+#include <cstdint>
 #include <memory>
+#include <mutex>
 
 #include <mir_toolkit/mir_client_library.h>
 #include <mir_toolkit/mir_screencast.h>
@@ -33,21 +36,50 @@ namespace mir {
 
 class Screencast : public ac::video::BufferProducer {
 public:
-    explicit Screencast();
+    static constexpr unsigned int kDefaultNumBuffers{2};
+    static constexpr unsigned int kMinNumBuffers{2};
+    static constexpr unsigned int kMaxNumBuffers{4};
+
+    // With more than two buffers the compositor can already render the
+    // next frame while the previous ones are still with the encoder.
+    explicit Screencast(unsigned int num_buffers = kDefaultNumBuffers);
     ~Screencast();
 
+    // Connects to Mir ahead of Setup() as that takes a good part of
+    // the time needed to get the screencast up.
+    bool Prepare() override;
     bool Setup(const video::DisplayOutput &output) override;
 
+    unsigned int NumBuffers() const;
+
     // From ac::video::BufferProducer
     void SwapBuffers() override;
+    void SwapBuffersAsync(const SwapCallback &callback) override;
     void* CurrentBuffer() const override;
+    // Compares a sparse sample of the pixels against the ones of the
+    // buffer we looked at before. Changes falling between the sampled
+    // pixels are missed until the next one hits a sample or the
+    // renderer refreshes the sink anyway.
+    bool CurrentBufferChanged() const override;
     video::DisplayOutput OutputMode() const override;
 
+private:
+    static void OnSwapBuffersDone(MirBufferStream *buffer_stream, void *context);
+
+    bool Connect();
+
 private:
     MirConnection *connection_;
     MirScreencast *screencast_;
     MirBufferStream *buffer_stream_;
     video::DisplayOutput output_;
+    unsigned int num_buffers_;
+    std::mutex swap_mutex_;
+    std::condition_variable swap_done_;
+    SwapCallback swap_callback_;
+    bool swap_pending_;
+    mutable bool has_fingerprint_;
+    mutable std::uint64_t last_fingerprint_;
 };
 
 } // namespace mir
@@ -15,6 +15,8 @@
  *
  */
 
+#include <map>
+
 #include "ac/logger.h"
 #include "ac/keep_alive.h"
 
@@ -24,11 +26,13 @@
 #include "ac/network/udpstream.h"
 
 #include "ac/report/reportfactory.h"
+#include "ac/report/timeline/connectiontimeline.h"
 
 #include "ac/video/videoformat.h"
 #include "ac/video/displayoutput.h"
 
 #include "ac/streaming/mpegtspacketizer.h"
+#include "ac/streaming/rtcpreceiver.h"
 #include "ac/streaming/rtpsender.h"
 
 #include "ac/mir/sourcemediamanager.h"
@@ -36,14 +40,96 @@
 #include "ac/android/h264encoder.h"
 
 namespace {
-// Number of milliseconds was choosen by measurement
-static constexpr std::chrono::milliseconds kStreamDelayOnPlay{300};
+// We probe the sink with growing intervals until it stops refusing
+// our packets but give up waiting for it at some point.
+static constexpr std::chrono::milliseconds kMinProbeInterval{10};
+static constexpr std::chrono::milliseconds kMaxProbeInterval{160};
+static constexpr std::chrono::milliseconds kMaxStartDelay{1500};
+
+// Parity packets go to the port SMPTE 2022-1 uses for column FEC
+static constexpr ac::network::Port kFECPortOffset{2};
+// The sink sends RTCP feedback to the port above our RTP port
+static constexpr ac::network::Port kRTCPPortOffset{1};
+
+// How long sinks refused our packets after we wanted to start the
+// stream the last time, by their P2P device address. The IP address
+// is no use here as our DHCP server hands out the same one to every
+// sink.
+std::map<ac::MacAddress, std::chrono::milliseconds>& SinkStartDelays() {
+    static std::map<ac::MacAddress, std::chrono::milliseconds> delays;
+    return delays;
+}
+
+// The format we bet on while the sink didn't tell us yet what it
+// supports. See ac::BaseSourceMediaManager::GetH264VideoCodecs for
+// what we offer.
+wds::H264VideoFormat SpeculativeVideoFormat() {
+    return wds::H264VideoFormat(wds::CBP, wds::k3_1, wds::CEA1280x720p30);
+}
+
+std::uint32_t RendererBufferSlots() {
+    const auto value = ac::Utils::GetEnvValue("AETHERCAST_RENDERER_BUFFER_SLOTS");
+    if (value.length() == 0)
+        return ac::mir::StreamRenderer::kDefaultBufferSlots;
+
+    try {
+        return std::stoul(value);
+    } catch (...) {
+        AC_WARNING("Ignoring invalid number of renderer buffer slots '%s'", value);
+    }
+
+    return ac::mir::StreamRenderer::kDefaultBufferSlots;
+}
+
+ac::mir::StreamRenderer::Config RendererConfiguration() {
+    ac::mir::StreamRenderer::Config config;
+    config.buffer_slots = RendererBufferSlots();
+
+    if (ac::Utils::IsEnvSet("AETHERCAST_RENDERER_SKIP_UNCHANGED"))
+        config.mode = ac::mir::StreamRenderer::Mode::kSkipUnchanged;
+    else if (ac::Utils::IsEnvSet("AETHERCAST_RENDERER_REPEAT_UNCHANGED"))
+        config.mode = ac::mir::StreamRenderer::Mode::kRepeatUnchanged;
+
+    if (ac::Utils::IsEnvSet("AETHERCAST_RENDERER_ASYNC_SWAP"))
+        config.async_swap = true;
+
+    return config;
+}
+
+// FEC stays off unless a matrix is given as <columns>x<rows>
+ac::streaming::FECConfig FECConfiguration() {
+    ac::streaming::FECConfig config;
+
+    const auto value = ac::Utils::GetEnvValue("AETHERCAST_FEC");
+    if (value.length() == 0)
+        return config;
+
+    const auto dimensions = ac::Utils::StringSplit(value, 'x');
+    if (dimensions.size() == 2) {
+        try {
+            config.columns = std::stoul(dimensions[0]);
+            config.rows = std::stoul(dimensions[1]);
+        } catch (...) {
+            config.columns = 0;
+        }
+    }
+
+    config.row_parity = ac::Utils::IsEnvSet("AETHERCAST_FEC_ROW_PARITY");
+
+    if (!config.IsValid()) {
+        AC_WARNING("Ignoring invalid FEC matrix '%s'", value);
+        return ac::streaming::FECConfig();
+    }
+
+    return config;
+}
 }
 
 namespace ac {
 namespace mir {
 
 SourceMediaManager::SourceMediaManager(const std::string &remote_address,
+                                       const ac::MacAddress &sink_address,
                                        const ac::common::ExecutorFactory::Ptr &executor_factory,
                                        const ac::video::BufferProducer::Ptr &producer,
                                        const ac::video::BaseEncoder::Ptr &encoder,
@@ -51,12 +137,16 @@ SourceMediaManager::SourceMediaManager(const std::string &remote_address,
                                        const ac::report::ReportFactory::Ptr &report_factory) :
     state_(State::Stopped),
     remote_address_(remote_address),
+    sink_address_(sink_address),
     producer_(producer),
     encoder_(encoder),
     output_stream_(output_stream),
     report_factory_(report_factory),
-    pipeline_(executor_factory, 4),
-    delay_timeout_(0) {
+    pipeline_(executor_factory, 5),
+    delay_timeout_(0),
+    probe_interval_(kMinProbeInterval),
+    refused_for_(0),
+    probe_sent_(false) {
 }
 
 SourceMediaManager::~SourceMediaManager() {
@@ -64,23 +154,47 @@ SourceMediaManager::~SourceMediaManager() {
         pipeline_.Stop();
 }
 
-bool SourceMediaManager::Configure() {
-    auto rr = ac::video::ExtractRateAndResolution(format_);
+void SourceMediaManager::ForgetSinkStartDelays() {
+    SinkStartDelays().clear();
+}
 
-    if (!output_stream_->Connect(remote_address_, sink_port1_))
-        return false;
+void SourceMediaManager::Prepare() {
+    if (stream_prepared_.valid() || sender_)
+        return;
 
-    AC_DEBUG("dimensions: %dx%d@%d", rr.width, rr.height, rr.framerate);
+    if (ac::Utils::IsEnvSet("AETHERCAST_DISABLE_PREPARE"))
+        return;
 
-    video::DisplayOutput output{video::DisplayOutput::Mode::kExtend, rr.width, rr.height, rr.framerate};
+    // Creating the socket, connecting to Mir and bringing up the
+    // encoder are independent from each other and each takes its
+    // time so we let them run in parallel while the sink is still
+    // negotiating with us. Configure() picks up the results.
+    const auto output_stream = output_stream_;
+    stream_prepared_ = std::async(std::launch::async, [output_stream]() {
+        return output_stream->Prepare();
+    });
+
+    const auto producer = producer_;
+    producer_prepared_ = std::async(std::launch::async, [producer]() {
+        return producer->Prepare();
+    });
+
+    prepared_config_ = EncoderConfiguration(SpeculativeVideoFormat());
+
+    const auto encoder = encoder_;
+    const auto config = prepared_config_;
+    encoder_prepared_ = std::async(std::launch::async, [encoder, config]() {
+        return encoder->Configure(config);
+    });
+
+    AC_DEBUG("Preparing pipeline for %dx%d@%d", config.width, config.height, config.framerate);
+}
 
-    if (!producer_->Setup(output)) {
-        AC_ERROR("Failed to setup buffer producer");
-        return false;
-    }
+ac::video::BaseEncoder::Config SourceMediaManager::EncoderConfiguration(const wds::H264VideoFormat &format) {
+    const auto rr = ac::video::ExtractRateAndResolution(format);
 
     int profile = 0, level = 0, constraint = 0;
-    ac::video::ExtractProfileLevel(format_, &profile, &level, &constraint);
+    ac::video::ExtractProfileLevel(format, &profile, &level, &constraint);
 
     auto config = encoder_->DefaultConfiguration();
     config.width = rr.width;
@@ -90,18 +204,93 @@ bool SourceMediaManager::Configure() {
     config.level_idc = level;
     config.constraint_set = constraint;
 
-    if (!encoder_->Configure(config)) {
+    return config;
+}
+
+bool SourceMediaManager::ConfigureEncoder(const ac::video::BaseEncoder::Config &config) {
+    if (encoder_prepared_.valid() && encoder_prepared_.get()) {
+        if (prepared_config_ == config) {
+            AC_DEBUG("Using encoder prepared ahead of time");
+            return true;
+        }
+
+        AC_DEBUG("Negotiated format differs from the prepared one, reconfiguring encoder");
+
+        if (!encoder_->Reset()) {
+            AC_ERROR("Failed to reset encoder");
+            return false;
+        }
+    }
+
+    return encoder_->Configure(config);
+}
+
+bool SourceMediaManager::Configure() {
+    auto rr = ac::video::ExtractRateAndResolution(format_);
+
+    // A failed preparation isn't fatal as Connect and Setup below
+    // will just do the missing work themselves.
+    if (stream_prepared_.valid() && !stream_prepared_.get())
+        AC_WARNING("Failed to prepare output stream");
+
+    if (!output_stream_->Connect(remote_address_, sink_port1_))
+        return false;
+
+    AC_DEBUG("dimensions: %dx%d@%d", rr.width, rr.height, rr.framerate);
+
+    // Extending the desktop stays our default but mirroring the
+    // screen of the device can be requested.
+    auto mode = video::DisplayOutput::Mode::kExtend;
+    if (ac::Utils::GetEnvValue("AETHERCAST_DISPLAY_MODE") == "mirror")
+        mode = video::DisplayOutput::Mode::kMirror;
+
+    video::DisplayOutput output{mode, rr.width, rr.height, rr.framerate};
+
+    if (producer_prepared_.valid() && !producer_prepared_.get())
+        AC_WARNING("Failed to prepare buffer producer");
+
+    if (!producer_->Setup(output)) {
+        AC_ERROR("Failed to setup buffer producer");
+        return false;
+    }
+
+    const auto config = EncoderConfiguration(format_);
+
+    if (!ConfigureEncoder(config)) {
         AC_ERROR("Failed to configure encoder");
         return false;
     }
 
     renderer_ = std::make_shared<ac::mir::StreamRenderer>(
-                producer_, encoder_, report_factory_->CreateRendererReport());
+                producer_, encoder_, report_factory_->CreateRendererReport(),
+                RendererConfiguration());
 
     auto rtp_sender = std::make_shared<ac::streaming::RTPSender>(
                 output_stream_, report_factory_->CreateSenderReport());
     rtp_sender->SetDelegate(shared_from_this());
 
+    const auto fec_config = FECConfiguration();
+    if (fec_config.IsValid()) {
+        const auto fec_stream = std::make_shared<ac::network::UdpStream>();
+        if (fec_stream->Connect(remote_address_, sink_port1_ + kFECPortOffset) &&
+                rtp_sender->EnableFEC(fec_stream, fec_config))
+            AC_DEBUG("Sending %dx%d FEC with %.0f%% overhead", fec_config.columns,
+                     fec_config.rows, fec_config.Overhead() * 100);
+        else
+            AC_WARNING("Failed to set up FEC, streaming without it");
+    }
+
+    ac::streaming::RTCPReceiver::Ptr rtcp_receiver;
+    if (ac::Utils::IsEnvSet("AETHERCAST_RTCP_NACK")) {
+        rtcp_receiver = std::make_shared<ac::streaming::RTCPReceiver>();
+        if (rtcp_receiver->Bind(output_stream_->LocalPort() + kRTCPPortOffset, remote_address_)) {
+            rtcp_receiver->SetDelegate(rtp_sender);
+        } else {
+            AC_WARNING("Failed to set up RTCP receiver, lost packets won't be resent");
+            rtcp_receiver.reset();
+        }
+    }
+
     const auto mpegts_packetizer = ac::streaming::MPEGTSPacketizer::Create(
                 report_factory_->CreatePacketizerReport());
 
@@ -117,6 +306,9 @@ bool SourceMediaManager::Configure() {
     pipeline_.Add(rtp_sender);
     pipeline_.Add(sender_);
 
+    if (rtcp_receiver)
+        pipeline_.Add(rtcp_receiver);
+
     return true;
 }
 
@@ -133,14 +325,69 @@ void SourceMediaManager::CancelDelayTimeout() {
     delay_timeout_ = 0;
 }
 
-gboolean SourceMediaManager::OnStartPipeline(gpointer user_data) {
+void SourceMediaManager::StartPipeline() {
+    pipeline_.Start();
+
+    if (const auto timeline = report::timeline::ConnectionTimeline::Instance())
+        timeline->Mark(report::timeline::ConnectionTimeline::Phase::kPipelineStarted);
+}
+
+void SourceMediaManager::RememberStartDelay() {
+    // Sinks we don't know the device address of would all end up
+    // sharing the same delay.
+    if (sink_address_.length() == 0)
+        return;
+
+    SinkStartDelays()[sink_address_] = refused_for_;
+}
+
+void SourceMediaManager::ScheduleProbe(const std::chrono::milliseconds &delay) {
+    delay_timeout_ = g_timeout_add_full(G_PRIORITY_DEFAULT,
+           delay.count(),
+           &OnProbeSink,
+           new WeakKeepAlive<SourceMediaManager>(shared_from_this()),
+           [](gpointer data) { delete static_cast<WeakKeepAlive<SourceMediaManager>*>(data); });
+}
+
+gboolean SourceMediaManager::OnProbeSink(gpointer user_data) {
     auto thiz = static_cast<ac::WeakKeepAlive<SourceMediaManager>*>(user_data)->GetInstance().lock();
     if (!thiz)
         return FALSE;
 
-    thiz->pipeline_.Start();
     thiz->delay_timeout_ = 0;
 
+    const auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
+                std::chrono::steady_clock::now() - thiz->play_requested_);
+
+    if (thiz->probe_sent_) {
+        if (!thiz->output_stream_->RemoteRefused()) {
+            AC_DEBUG("Sink accepts packets after %d ms", elapsed.count());
+            thiz->RememberStartDelay();
+            thiz->StartPipeline();
+            return FALSE;
+        }
+
+        thiz->refused_for_ = elapsed;
+    }
+
+    if (elapsed >= kMaxStartDelay) {
+        AC_WARNING("Sink still refuses packets after %d ms, starting anyway", elapsed.count());
+        thiz->RememberStartDelay();
+        thiz->StartPipeline();
+        return FALSE;
+    }
+
+    if (!thiz->output_stream_->SendProbe()) {
+        AC_WARNING("Failed to probe sink, starting right away");
+        thiz->RememberStartDelay();
+        thiz->StartPipeline();
+        return FALSE;
+    }
+
+    thiz->probe_sent_ = true;
+    thiz->ScheduleProbe(thiz->probe_interval_);
+    thiz->probe_interval_ = std::min(thiz->probe_interval_ * 2, kMaxProbeInterval);
+
     return FALSE;
 }
 
@@ -152,18 +399,27 @@ void SourceMediaManager::Play() {
 
     CancelDelayTimeout();
 
-    // Deferring the actual pipeline start a bit helps to solve
-    // problems with receiver devices not being ready in the same
-    // timeframe as we are. If we send RTP packages to early we
-    // will receive ICMP failures which are not causing much
-    // issues but its better to avoid them.
-    delay_timeout_ = g_timeout_add_full(G_PRIORITY_DEFAULT,
-           kStreamDelayOnPlay.count(),
-           &OnStartPipeline,
-           new WeakKeepAlive<SourceMediaManager>(shared_from_this()),
-           [](gpointer data) { delete static_cast<WeakKeepAlive<SourceMediaManager>*>(data); });
+    if (const auto timeline = report::timeline::ConnectionTimeline::Instance())
+        timeline->Mark(report::timeline::ConnectionTimeline::Phase::kPlayRequested);
+
+    // Receiver devices are not always ready in the same timeframe as
+    // we are. RTP packets sent too early cause ICMP failures which let
+    // our writes fail so we probe the sink until it stops refusing
+    // packets before starting the pipeline. A sink we streamed to
+    // before isn't probed before the time it needed back then.
+    play_requested_ = std::chrono::steady_clock::now();
+    probe_interval_ = kMinProbeInterval;
+    refused_for_ = std::chrono::milliseconds{0};
+    probe_sent_ = false;
+
+    std::chrono::milliseconds delay{0};
+    const auto known = SinkStartDelays().find(sink_address_);
+    if (known != SinkStartDelays().end())
+        delay = known->second;
+
+    ScheduleProbe(delay);
 
-    // We defer the actual start of the pipeline a bit here but
+    // We defer the actual start of the pipeline here but
     // stay in state 'Playing' as even if the pipeline start
     // fails we don't have any direct way yet to switch the
     // state from our position.
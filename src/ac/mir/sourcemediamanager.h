@@ -18,11 +18,14 @@
 #ifndef AC_MIR_SOURCEMEDIAMANAGERNEXT_H_
 #define AC_MIR_SOURCEMEDIAMANAGERNEXT_H_
 
+#include <chrono>
+#include <future>
 #include <memory>
 
 #include "ac/glib_wrapper.h"
 
 #include "ac/basesourcemediamanager.h"
+#include "ac/mac_address.h"
 
 #include "ac/common/executor.h"
 #include "ac/common/threadedexecutor.h"
@@ -55,6 +58,7 @@ public:
     };
 
     SourceMediaManager(const std::string &remote_address,
+                       const ac::MacAddress &sink_address,
                        const ac::common::ExecutorFactory::Ptr &executor_factory,
                        const ac::video::BufferProducer::Ptr &producer,
                        const ac::video::BaseEncoder::Ptr &encoder,
@@ -63,6 +67,11 @@ public:
 
     ~SourceMediaManager();
 
+    // Drops what we learned about how long sinks need until they
+    // accept our stream.
+    static void ForgetSinkStartDelays();
+
+    void Prepare() override;
     void Play() override;
     void Pause() override;
     void Teardown() override;
@@ -75,16 +84,23 @@ public:
     void OnTransportNetworkError() override;
 
 private:
-    static gboolean OnStartPipeline(gpointer user_data);
+    static gboolean OnProbeSink(gpointer user_data);
 
+    void ScheduleProbe(const std::chrono::milliseconds &delay);
+    void RememberStartDelay();
+    void StartPipeline();
     void CancelDelayTimeout();
 
+    ac::video::BaseEncoder::Config EncoderConfiguration(const wds::H264VideoFormat &format);
+    bool ConfigureEncoder(const ac::video::BaseEncoder::Config &config);
+
 protected:
     bool Configure() override;
 
 private:
     State state_;
     std::string remote_address_;
+    ac::MacAddress sink_address_;
     ac::video::BufferProducer::Ptr producer_;
     ac::video::BaseEncoder::Ptr encoder_;
     ac::network::Stream::Ptr output_stream_;
@@ -93,6 +109,14 @@ private:
     ac::streaming::MediaSender::Ptr sender_;
     ac::common::ExecutorPool pipeline_;
     guint delay_timeout_;
+    std::chrono::steady_clock::time_point play_requested_;
+    std::chrono::milliseconds probe_interval_;
+    std::chrono::milliseconds refused_for_;
+    bool probe_sent_;
+    std::future<bool> stream_prepared_;
+    std::future<bool> producer_prepared_;
+    std::future<bool> encoder_prepared_;
+    ac::video::BaseEncoder::Config prepared_config_;
 };
 
 } // namespace mir
@@ -15,11 +15,10 @@
  *
  */
 
+#include <algorithm>
 #include <chrono>
 #include <thread>
 
-#include <boost/concept_check.hpp>
-
 #include "ac/logger.h"
 
 #include "ac/mir/screencast.h"
@@ -27,22 +26,53 @@
 
 namespace {
 static constexpr const char *kStreamRendererThreadName{"StreamRenderer"};
-static constexpr unsigned int kNumBufferSlots{2};
+// Time we wait for a slot to become free before we return from
+// an iteration to let the executor check if we should stop.
+static constexpr std::chrono::milliseconds kSlotWaitTimeout{1};
+// Same for waiting on an asynchronous swap of buffers to finish
+static constexpr std::chrono::milliseconds kSwapWaitTimeout{1};
+
+ac::TimestampUs FrameInterval(int framerate) {
+    // Without a valid framerate we don't pace at all
+    if (framerate <= 0)
+        return 0;
+
+    return std::micro::den / framerate;
+}
 }
 
 namespace ac {
 namespace mir {
 
+constexpr std::uint32_t StreamRenderer::kDefaultBufferSlots;
+constexpr std::uint32_t StreamRenderer::kMaxBufferSlots;
+constexpr std::chrono::milliseconds StreamRenderer::kDefaultMinRefreshInterval;
+
 StreamRenderer::StreamRenderer(const video::BufferProducer::Ptr &buffer_producer,
                                const video::BaseEncoder::Ptr &encoder,
-                               const video::RendererReport::Ptr &report) :
+                               const video::RendererReport::Ptr &report,
+                               const Config &config) :
     report_(report),
     buffer_producer_(buffer_producer),
     encoder_(encoder),
     width_(buffer_producer->OutputMode().width),
     height_(buffer_producer->OutputMode().height),
-    input_buffers_(ac::video::BufferQueue::Create(BufferSlots())),
-    target_iteration_time_((1. / encoder_->Configuration().framerate) * std::micro::den) {
+    slots_(std::max(1u, std::min(config.buffer_slots, kMaxBufferSlots))),
+    pacer_(FrameInterval(encoder_->Configuration().framerate)),
+    mode_(config.mode),
+    min_refresh_interval_(std::chrono::duration_cast<std::chrono::microseconds>(
+                              config.min_refresh_interval).count()),
+    last_encoded_time_(0),
+    last_composed_time_(0),
+    content_static_(false),
+    unchanged_frames_(0),
+    last_frame_number_(0),
+    async_swap_(config.async_swap),
+    swap_state_(SwapState::kIdle) {
+
+    if (slots_.size() != config.buffer_slots)
+        AC_WARNING("Invalid number of buffer slots %d, using %d instead",
+                   config.buffer_slots, slots_.size());
 }
 
 StreamRenderer::~StreamRenderer() {
@@ -50,63 +80,234 @@ StreamRenderer::~StreamRenderer() {
 }
 
 bool StreamRenderer::Execute() {
-    ac::TimestampUs iteration_start_time = ac::Utils::GetNowUs();
-
     // Wait until we have free slots again and all buffers we produced
     // went through the pipeline.
-    if (!input_buffers_->WaitForSlots())
+    if (!WaitForFreeSlot())
         return true;
 
-    report_->BeganFrame();
+    // While the content is static we don't let the producer compose
+    // the same frame again and send the last one once more instead.
+    const bool repeat = ShouldRepeat(ac::Utils::GetNowUs());
+
+    if (!repeat && async_swap_) {
+        // Composition of this frame was most likely already started
+        // at the end of the last iteration.
+        RequestSwap();
+        switch (WaitForSwap()) {
+        case SwapState::kCompleted:
+            break;
+        case SwapState::kFailed:
+            // No buffer for this frame. Try again with the next one
+            // instead of spinning on a producer which can't deliver.
+            pacer_.WaitForNextFrame();
+            return true;
+        default:
+            return true;
+        }
+    } else if (!repeat) {
+        report_->BeganFrame();
 
-    // This will trigger the rendering/compositing process inside mir
-    // and will block until that is done and we received a new buffer
-    buffer_producer_->SwapBuffers();
+        // This will trigger the rendering/compositing process inside mir
+        // and will block until that is done and we received a new buffer
+        buffer_producer_->SwapBuffers();
+    }
+
+    // The pacer keeps its schedule on the monotonic clock so it only
+    // ever gets to see the time we got the buffer at.
+    const auto now = ac::Utils::GetNowUs();
+    report_->FrameLateness(pacer_.FrameProduced(now));
+
+    // For the frame itself we prefer the presentation timestamp of our
+    // producer and only if that isn't available fallback to the time
+    // we got the buffer. A repeated frame is stamped with the time we
+    // repeat it at.
+    ac::TimestampUs timestamp = repeat ? 0 : buffer_producer_->CurrentBufferTimestamp();
+    if (timestamp <= 0)
+        timestamp = now;
+
+    if (repeat) {
+        unchanged_frames_++;
+        report_->UnchangedFrame(timestamp);
+        EncodeCurrentBuffer(timestamp);
+        last_encoded_time_ = now;
+    } else if (ShouldEncode(now)) {
+        EncodeCurrentBuffer(timestamp);
+        last_encoded_time_ = now;
+    } else {
+        report_->UnchangedFrame(timestamp);
+    }
+
+    // Let the producer compose the next frame while the encoder works
+    // on this one and we wait for the next deadline. Without a free
+    // slot the producer could reuse a buffer the encoder still reads
+    // from so we defer that to the next iteration then.
+    if (async_swap_ && HasFreeSlot() && !ShouldRepeat(ac::Utils::GetNowUs()))
+        RequestSwap();
+
+    // Wait for the absolute deadline of the next frame to keep our
+    // framerate constant. If we're behind we skip frames rather than
+    // trying to catch up with a burst of them.
+    const auto skipped = pacer_.WaitForNextFrame();
+    if (skipped > 0)
+        report_->SkippedFrames(skipped);
+
+    return true;
+}
 
+void StreamRenderer::EncodeCurrentBuffer(const ac::TimestampUs &timestamp) {
     const auto native_buffer = buffer_producer_->CurrentBuffer();
 
+    const auto frame = ++last_frame_number_;
+
     auto buffer = ac::video::Buffer::Create(native_buffer);
     buffer->SetDelegate(shared_from_this());
+    buffer->SetTimestamp(timestamp);
+    buffer->SetFrameNumber(frame);
 
-    // FIXME: at optimum we would get the timestamp directly supplied
-    // from our producer but as long as that isn't available we don't
-    // have any other chance and need to do it here.
-    buffer->SetTimestamp(ac::Utils::GetNowUs());
-
-    input_buffers_->Push(buffer);
+    OccupySlot(buffer);
 
     encoder_->QueueBuffer(buffer);
 
-    report_->FinishedFrame(buffer->Timestamp());
+    report_->FinishedFrame(frame, timestamp);
+}
 
-    // Calculate how long we have to wait until we can render the next
-    // frame to keep our framerate constant.
-    ac::TimestampUs iteration_time = ac::Utils::GetNowUs() - iteration_start_time;
-    ac::TimestampUs sleep_time = target_iteration_time_ - iteration_time;
-    if (sleep_time > 0)
-        std::this_thread::sleep_for(std::chrono::microseconds(sleep_time));
+bool StreamRenderer::ShouldRepeat(const ac::TimestampUs &now) const {
+    if (mode_ != Mode::kRepeatUnchanged || !content_static_)
+        return false;
 
-    return true;
+    // Look for changes again at least every refresh interval
+    return now - last_composed_time_ < min_refresh_interval_;
+}
+
+bool StreamRenderer::ShouldEncode(const ac::TimestampUs &now) {
+    if (mode_ == Mode::kEncodeAll)
+        return true;
+
+    if (mode_ == Mode::kRepeatUnchanged) {
+        // The freshly composed frame always goes out, only the ones
+        // after it are repeated if it didn't change.
+        content_static_ = !buffer_producer_->CurrentBufferChanged();
+        last_composed_time_ = now;
+        return true;
+    }
+
+    if (buffer_producer_->CurrentBufferChanged())
+        return true;
+
+    // Even if nothing changed we have to send a frame from time to
+    // time to not let the sink think we're gone.
+    if (last_encoded_time_ == 0 || now - last_encoded_time_ >= min_refresh_interval_)
+        return true;
+
+    unchanged_frames_++;
+
+    return false;
+}
+
+bool StreamRenderer::WaitForFreeSlot() {
+    std::unique_lock<std::mutex> l(slots_mutex_);
+    return slots_available_.wait_for(l, kSlotWaitTimeout, [&]() {
+        return HasFreeSlotUnlocked();
+    });
+}
+
+bool StreamRenderer::HasFreeSlotUnlocked() const {
+    return std::find(slots_.begin(), slots_.end(), nullptr) != slots_.end();
+}
+
+bool StreamRenderer::HasFreeSlot() const {
+    std::unique_lock<std::mutex> l(slots_mutex_);
+    return HasFreeSlotUnlocked();
+}
+
+void StreamRenderer::RequestSwap() {
+    {
+        std::unique_lock<std::mutex> l(swap_mutex_);
+        if (swap_state_ != SwapState::kIdle)
+            return;
+
+        swap_state_ = SwapState::kPending;
+    }
+
+    report_->BeganFrame();
+
+    std::weak_ptr<StreamRenderer> weak_self = shared_from_this();
+    buffer_producer_->SwapBuffersAsync([weak_self](bool success) {
+        if (auto self = weak_self.lock())
+            self->OnSwapBuffersDone(success);
+    });
+}
+
+StreamRenderer::SwapState StreamRenderer::WaitForSwap() {
+    std::unique_lock<std::mutex> l(swap_mutex_);
+    if (!swap_done_.wait_for(l, kSwapWaitTimeout, [&]() {
+            return swap_state_ != SwapState::kPending;
+        }))
+        return SwapState::kPending;
+
+    const auto state = swap_state_;
+    swap_state_ = SwapState::kIdle;
+    return state;
+}
+
+void StreamRenderer::OnSwapBuffersDone(bool success) {
+    std::unique_lock<std::mutex> l(swap_mutex_);
+    swap_state_ = success ? SwapState::kCompleted : SwapState::kFailed;
+    l.unlock();
+    swap_done_.notify_one();
+}
+
+void StreamRenderer::OccupySlot(const video::Buffer::Ptr &buffer) {
+    std::unique_lock<std::mutex> l(slots_mutex_);
+    auto slot = std::find(slots_.begin(), slots_.end(), nullptr);
+    // Only the renderer thread occupies slots and it always waits
+    // for a free one before it starts a new frame.
+    if (slot == slots_.end())
+        return;
+
+    *slot = buffer;
 }
 
 void StreamRenderer::OnBufferFinished(const video::Buffer::Ptr &buffer) {
-    boost::ignore_unused_variable_warning(buffer);
+    std::unique_lock<std::mutex> l(slots_mutex_);
+
+    // Buffers can come back in any order so we have to find the
+    // slot the buffer was assigned to and free it up for the
+    // next frame.
+    auto slot = std::find(slots_.begin(), slots_.end(), buffer);
+    if (slot == slots_.end()) {
+        AC_WARNING("Got unknown buffer %p back", buffer.get());
+        return;
+    }
 
-    // We're currently relying on the buffers to come back in order so
-    // we can safely remove the head from the queue here which then
-    // gives us a free slot at the beginning which will be filled by
-    // the renderer again.
-    input_buffers_->Pop();
+    slot->reset();
+
+    l.unlock();
+    slots_available_.notify_one();
 }
 
 bool StreamRenderer::Start() {
     AC_DEBUG("Everything successfully setup; Starting recording now %dx%d@%d",
               width_, height_, encoder_->Configuration().framerate);
 
+    pacer_.Reset();
+    last_encoded_time_ = 0;
+    last_composed_time_ = 0;
+    content_static_ = false;
+
     return true;
 }
 
 bool StreamRenderer::Stop() {
+    const auto lateness = pacer_.Lateness();
+    for (std::size_t n = 0; n < lateness.size(); n++) {
+        if (lateness[n] == 0)
+            continue;
+
+        AC_DEBUG("%d frames late by up to %lld us", lateness[n],
+                 video::FramePacer::LatenessBucketLimit(n));
+    }
+
     return true;
 }
 
@@ -115,7 +316,25 @@ std::string StreamRenderer::Name() const {
 }
 
 std::uint32_t StreamRenderer::BufferSlots() const {
-    return kNumBufferSlots;
+    return slots_.size();
+}
+
+video::FramePacer::LatenessHistogram StreamRenderer::FrameLateness() const {
+    return pacer_.Lateness();
+}
+
+std::uint64_t StreamRenderer::SkippedFrames() const {
+    return pacer_.SkippedFrames();
+}
+
+std::uint64_t StreamRenderer::UnchangedFrames() const {
+    return unchanged_frames_;
+}
+
+std::uint32_t StreamRenderer::OccupiedBufferSlots() const {
+    std::unique_lock<std::mutex> l(slots_mutex_);
+    return std::count_if(slots_.begin(), slots_.end(),
+                         [](const video::Buffer::Ptr &buffer) { return buffer != nullptr; });
 }
 
 } // namespace mir
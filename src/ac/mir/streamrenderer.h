@@ -18,10 +18,13 @@
 #ifndef AC_MIR_STREAMRENDERER_H_
 #define AC_MIR_STREAMRENDERER_H_
 
+#include <atomic>
+#include <chrono>
 #include <memory>
 #include <thread>
 #include <mutex>
-#include <queue>
+#include <condition_variable>
+#include <vector>
 
 #include "ac/common/executable.h"
 
@@ -31,6 +34,7 @@
 #include "ac/video/baseencoder.h"
 #include "ac/video/bufferqueue.h"
 #include "ac/video/bufferproducer.h"
+#include "ac/video/framepacer.h"
 #include "ac/video/rendererreport.h"
 
 namespace ac {
@@ -40,15 +44,70 @@ class StreamRenderer : public std::enable_shared_from_this<StreamRenderer>,
                        public ac::video::Buffer::Delegate {
 public:
     static constexpr unsigned int kNumTextures{2};
+    static constexpr std::uint32_t kDefaultBufferSlots{2};
+    static constexpr std::uint32_t kMaxBufferSlots{8};
+    // Sinks expect to get regular updates even if nothing changes on
+    // the screen so we never stay silent for longer than this. PAT, PMT
+    // and PCR only go out together with a frame and have to be repeated
+    // every 100ms so this has to stay well below that.
+    static constexpr std::chrono::milliseconds kDefaultMinRefreshInterval{40};
 
     typedef std::shared_ptr<StreamRenderer> Ptr;
 
+    enum class Mode {
+        // Every frame is send to the encoder
+        kEncodeAll,
+        // Frames without any content change are dropped but we still
+        // repeat the last one at the minimum refresh interval.
+        kSkipUnchanged,
+        // Once the content stopped changing the producer only composes
+        // a new frame every minimum refresh interval to look for
+        // changes. In between the last frame is send to the encoder
+        // again so the sink keeps getting the full framerate. Trades
+        // up to one refresh interval of latency for composition.
+        kRepeatUnchanged
+    };
+
+    class Config {
+    public:
+        Config() :
+            buffer_slots(kDefaultBufferSlots),
+            mode(Mode::kEncodeAll),
+            min_refresh_interval(kDefaultMinRefreshInterval),
+            async_swap(false) {
+        }
+
+        std::uint32_t buffer_slots;
+        Mode mode;
+        std::chrono::milliseconds min_refresh_interval;
+        // Request the next buffer from the producer right after the
+        // current one went to the encoder so composition overlaps with
+        // encoding. The producer needs at least one buffer more than
+        // we have slots for this to pay off.
+        bool async_swap;
+    };
+
     StreamRenderer(const video::BufferProducer::Ptr &buffer_producer,
                    const video::BaseEncoder::Ptr &encoder,
-                   const video::RendererReport::Ptr  &report);
+                   const video::RendererReport::Ptr  &report,
+                   const Config &config = Config{});
     ~StreamRenderer();
 
+    // Number of buffers we allow to be in flight through the pipeline
+    // at the same time. More slots give a slow encoder more room to
+    // pipeline frames at the cost of a higher latency.
     std::uint32_t BufferSlots() const;
+    // Number of slots currently occupied by a buffer which wasn't
+    // returned to us yet.
+    std::uint32_t OccupiedBufferSlots() const;
+
+    // Histogram of how late frames were produced compared to the
+    // deadline they were scheduled for.
+    video::FramePacer::LatenessHistogram FrameLateness() const;
+    std::uint64_t SkippedFrames() const;
+    // Number of frames not send to the encoder or repeated as their
+    // content didn't change.
+    std::uint64_t UnchangedFrames() const;
 
     // From ac::video::Buffer::Delegate
     void OnBufferFinished(const ac::video::Buffer::Ptr &buffer);
@@ -59,14 +118,48 @@ public:
     bool Execute() override;
     std::string Name() const override;
 
+private:
+    enum class SwapState {
+        kIdle,
+        kPending,
+        kCompleted,
+        kFailed
+    };
+
+    bool WaitForFreeSlot();
+    bool HasFreeSlotUnlocked() const;
+    bool HasFreeSlot() const;
+    void OccupySlot(const video::Buffer::Ptr &buffer);
+    bool ShouldEncode(const ac::TimestampUs &now);
+    bool ShouldRepeat(const ac::TimestampUs &now) const;
+    void EncodeCurrentBuffer(const ac::TimestampUs &timestamp);
+    void RequestSwap();
+    SwapState WaitForSwap();
+    void OnSwapBuffersDone(bool success);
+
 private:
     video::RendererReport::Ptr report_;
     video::BufferProducer::Ptr buffer_producer_;
     video::BaseEncoder::Ptr encoder_;
     unsigned int width_;
     unsigned int height_;
-    ac::video::BufferQueue::Ptr input_buffers_;
-    ac::TimestampUs target_iteration_time_;
+    // Buffers are tracked by identity as the encoder is free to
+    // return them in any order it likes.
+    std::vector<ac::video::Buffer::Ptr> slots_;
+    mutable std::mutex slots_mutex_;
+    std::condition_variable slots_available_;
+    video::FramePacer pacer_;
+    Mode mode_;
+    ac::TimestampUs min_refresh_interval_;
+    ac::TimestampUs last_encoded_time_;
+    ac::TimestampUs last_composed_time_;
+    bool content_static_;
+    std::atomic<std::uint64_t> unchanged_frames_;
+    video::FrameNumber last_frame_number_;
+    bool async_swap_;
+    std::mutex swap_mutex_;
+    std::condition_variable swap_done_;
+    SwapState swap_state_;
 };
 } // namespace mir
 } // namespace ac
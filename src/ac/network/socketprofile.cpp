@@ -0,0 +1,153 @@
+/*
+ * Copyright (C) 2016 Canonical, Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 3, as published
+ * by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranties of
+ * MERCHANTABILITY, SATISFACTORY QUALITY, or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <map>
+
+#include "ac/logger.h"
+#include "ac/utils.h"
+
+#include "ac/network/socketprofile.h"
+
+namespace {
+static constexpr int kLegacySendBufferSize{256 * 1024};
+
+const std::map<std::string, ac::network::SocketProfile::MtuDiscovery>& MtuDiscoveryModes() {
+    static const std::map<std::string, ac::network::SocketProfile::MtuDiscovery> modes{
+        {"system", ac::network::SocketProfile::MtuDiscovery::kSystem},
+        {"dont", ac::network::SocketProfile::MtuDiscovery::kDont},
+        {"want", ac::network::SocketProfile::MtuDiscovery::kWant},
+        {"do", ac::network::SocketProfile::MtuDiscovery::kDo},
+        {"probe", ac::network::SocketProfile::MtuDiscovery::kProbe},
+    };
+    return modes;
+}
+
+bool ParseInt(const std::string &value, int &result) {
+    try {
+        std::size_t end = 0;
+        // Base 0 allows to give TOS values in hex
+        result = std::stoi(value, &end, 0);
+        return end == value.length();
+    } catch (...) {
+    }
+    return false;
+}
+}
+
+namespace ac {
+namespace network {
+
+constexpr int SocketProfile::kVideoTypeOfService;
+constexpr int SocketProfile::kVideoPriority;
+
+SocketProfile SocketProfile::Legacy() {
+    SocketProfile profile;
+    profile.send_buffer_size = kLegacySendBufferSize;
+    return profile;
+}
+
+SocketProfile SocketProfile::Video() {
+    auto profile = Legacy();
+    profile.type_of_service = kVideoTypeOfService;
+    profile.priority = kVideoPriority;
+    return profile;
+}
+
+bool SocketProfile::Parse(const std::string &spec, SocketProfile &profile) {
+    const auto items = ac::Utils::StringSplit(spec, ',');
+    if (items.size() == 0)
+        return false;
+
+    SocketProfile result;
+    if (items[0] == "legacy")
+        result = Legacy();
+    else if (items[0] == "video")
+        result = Video();
+    else
+        return false;
+
+    for (std::size_t n = 1; n < items.size(); n++) {
+        const auto pair = ac::Utils::StringSplit(items[n], '=');
+        if (pair.size() != 2)
+            return false;
+
+        const auto &key = pair[0];
+        const auto &value = pair[1];
+
+        if (key == "pmtudisc") {
+            const auto mode = MtuDiscoveryModes().find(value);
+            if (mode == MtuDiscoveryModes().end())
+                return false;
+            result.mtu_discovery = mode->second;
+            continue;
+        }
+
+        int number = 0;
+        if (!ParseInt(value, number))
+            return false;
+
+        if (key == "sndbuf")
+            result.send_buffer_size = number;
+        else if (key == "tos")
+            result.type_of_service = number;
+        else if (key == "priority")
+            result.priority = number;
+        else
+            return false;
+    }
+
+    profile = result;
+
+    return true;
+}
+
+SocketProfile SocketProfile::FromEnvironment() {
+    const auto value = ac::Utils::GetEnvValue("AETHERCAST_SOCKET_PROFILE");
+    if (value.length() == 0)
+        return Video();
+
+    SocketProfile profile;
+    if (!Parse(value, profile)) {
+        AC_WARNING("Ignoring invalid socket profile '%s'", value);
+        return Video();
+    }
+
+    return profile;
+}
+
+bool SocketProfile::operator==(const SocketProfile &other) const {
+    return send_buffer_size == other.send_buffer_size &&
+            type_of_service == other.type_of_service &&
+            priority == other.priority &&
+            mtu_discovery == other.mtu_discovery;
+}
+
+std::ostream& operator<<(std::ostream &out, const SocketProfile &profile) {
+    std::string mtu_discovery;
+    for (const auto &mode : MtuDiscoveryModes()) {
+        if (mode.second == profile.mtu_discovery)
+            mtu_discovery = mode.first;
+    }
+
+    return out << "sndbuf " << profile.send_buffer_size
+               << " tos " << profile.type_of_service
+               << " priority " << profile.priority
+               << " pmtudisc " << mtu_discovery;
+}
+
+} // namespace network
+} // namespace ac
@@ -0,0 +1,71 @@
+/*
+ * Copyright (C) 2016 Canonical, Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 3, as published
+ * by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranties of
+ * MERCHANTABILITY, SATISFACTORY QUALITY, or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef AC_NETWORK_SOCKETPROFILE_H_
+#define AC_NETWORK_SOCKETPROFILE_H_
+
+#include <ostream>
+#include <string>
+
+namespace ac {
+namespace network {
+
+// Socket options for the sockets carrying the stream. Lets us compare
+// how different settings behave in the air without rebuilding.
+struct SocketProfile {
+    enum class MtuDiscovery {
+        kSystem,
+        kDont,
+        kWant,
+        kDo,
+        kProbe,
+    };
+
+    // Marked with DSCP CS5 which WiFi drivers map to user priority 5
+    // and with that the WMM video access category.
+    static constexpr int kVideoTypeOfService{0xa0};
+    static constexpr int kVideoPriority{5};
+
+    // What we always used before profiles existed
+    static SocketProfile Legacy();
+    // Our default with packets marked for the WMM video access category
+    static SocketProfile Video();
+
+    // Parses "<legacy|video>[,<key>=<value>...]" where the keys sndbuf,
+    // tos, priority and pmtudisc override single values of the named
+    // profile. Returns false for anything it doesn't understand.
+    static bool Parse(const std::string &spec, SocketProfile &profile);
+
+    // Reads AETHERCAST_SOCKET_PROFILE and falls back to Video()
+    static SocketProfile FromEnvironment();
+
+    bool operator==(const SocketProfile &other) const;
+
+    // Zero keeps the default of the system
+    int send_buffer_size{0};
+    // Negative values keep the default of the system
+    int type_of_service{-1};
+    int priority{-1};
+    MtuDiscovery mtu_discovery{MtuDiscovery::kSystem};
+};
+
+std::ostream& operator<<(std::ostream &out, const SocketProfile &profile);
+
+} // namespace network
+} // namespace ac
+
+#endif
@@ -38,6 +38,12 @@ public:
         kRemoteClosedConnection,
     };
 
+    /**
+     * @brief Sets up everything not depending on the remote side ahead of Connect
+     * @return true on success, false otherwise
+     */
+    virtual bool Prepare() { return true; }
+
     virtual bool Connect(const std::string &address, const Port &port) = 0;
 
     virtual Error Write(const uint8_t *data, unsigned int size,
@@ -45,6 +51,21 @@ public:
 
     virtual Port LocalPort() const = 0;
 
+    /**
+     * @brief Sends a packet without any payload to the remote side so that
+     * RemoteRefused tells afterwards whether anyone is listening there yet
+     * @return true on success, false otherwise
+     */
+    virtual bool SendProbe() { return true; }
+
+    /**
+     * @brief Checks if the remote side refused any packet since the last check
+     *
+     * Streams without a way to find out always report the remote side
+     * to accept packets.
+     */
+    virtual bool RemoteRefused() { return false; }
+
     /**
      * @brief Returns the maximum size of a unit the stream will send out
      * @return Maximum send unit size in bytes
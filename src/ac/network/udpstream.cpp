@@ -20,6 +20,8 @@
 #include <net/if.h>
 #include <netdb.h>
 #include <netinet/in.h>
+#include <netinet/ip_icmp.h>
+#include <linux/errqueue.h>
 #include <sys/ioctl.h>
 #include <sys/socket.h>
 #include <memory.h>
@@ -28,26 +30,62 @@
 #include <stdlib.h>
 
 #include <random>
+#include <sstream>
 
 #include <boost/concept_check.hpp>
 
 #include "ac/logger.h"
 #include "ac/networkutils.h"
 
+#include "ac/report/metrics/registry.h"
+
 #include "ac/network/udpstream.h"
 
 namespace {
-static constexpr unsigned int kUdpTxBufferSize = 256 * 1024;
 /* Value below configured MTU so that we don't require any further splits */
 static constexpr unsigned int kMaxUDPPacketSize = 1472;
+
+int MtuDiscoveryOption(const ac::network::SocketProfile::MtuDiscovery &mode) {
+    switch (mode) {
+    case ac::network::SocketProfile::MtuDiscovery::kDont:
+        return IP_PMTUDISC_DONT;
+    case ac::network::SocketProfile::MtuDiscovery::kWant:
+        return IP_PMTUDISC_WANT;
+    case ac::network::SocketProfile::MtuDiscovery::kDo:
+        return IP_PMTUDISC_DO;
+    case ac::network::SocketProfile::MtuDiscovery::kProbe:
+        return IP_PMTUDISC_PROBE;
+    default:
+        break;
+    }
+    return -1;
+}
+
+ac::network::SocketProfile::MtuDiscovery MtuDiscoveryMode(int option) {
+    switch (option) {
+    case IP_PMTUDISC_DONT:
+        return ac::network::SocketProfile::MtuDiscovery::kDont;
+    case IP_PMTUDISC_WANT:
+        return ac::network::SocketProfile::MtuDiscovery::kWant;
+    case IP_PMTUDISC_DO:
+        return ac::network::SocketProfile::MtuDiscovery::kDo;
+    case IP_PMTUDISC_PROBE:
+        return ac::network::SocketProfile::MtuDiscovery::kProbe;
+    default:
+        break;
+    }
+    return ac::network::SocketProfile::MtuDiscovery::kSystem;
+}
 }
 
 namespace ac {
 namespace network {
 
-UdpStream::UdpStream() :
+UdpStream::UdpStream(const SocketProfile &profile) :
     socket_(0),
-    local_port_(NetworkUtils::PickRandomPort()) {
+    local_port_(NetworkUtils::PickRandomPort()),
+    profile_(profile),
+    effective_profile_(profile) {
 }
 
 UdpStream::~UdpStream() {
@@ -55,32 +93,119 @@ UdpStream::~UdpStream() {
         ::close(socket_);
 }
 
-bool UdpStream::Connect(const std::string &address, const Port &port) {
-    AC_DEBUG("Connected with remote on %s:%d", address, port);
+bool UdpStream::Prepare() {
+    if (socket_ > 0)
+        return true;
 
-    socket_ = ::socket(AF_INET, SOCK_DGRAM, 0);
-    if (socket_ < 0) {
+    const auto fd = ::socket(AF_INET, SOCK_DGRAM, 0);
+    if (fd < 0) {
         AC_ERROR("Failed to create socket: %s (%d)", ::strerror(errno), errno);
         return false;
     }
 
-    int value = kUdpTxBufferSize;
-    if (::setsockopt(socket_, SOL_SOCKET, SO_SNDBUF, &value, sizeof(value)) < 0) {
+    int value = profile_.send_buffer_size;
+    if (value > 0 && ::setsockopt(fd, SOL_SOCKET, SO_SNDBUF, &value, sizeof(value)) < 0) {
         AC_ERROR("Failed to set socket transmit buffer size: %s (%d)", ::strerror(errno), errno);
+        ::close(fd);
         return false;
     }
 
+    ApplyProfile(fd);
+
+    // Lets ICMP errors for our packets end up in the error queue of
+    // the socket so that we can tell when the remote refuses them.
+    value = 1;
+    if (::setsockopt(fd, IPPROTO_IP, IP_RECVERR, &value, sizeof(value)) < 0)
+        AC_WARNING("Failed to enable extended error reporting: %s (%d)", ::strerror(errno), errno);
+
     struct sockaddr_in addr;
     memset(addr.sin_zero, 0, sizeof(addr.sin_zero));
     addr.sin_family = AF_INET;
     addr.sin_addr.s_addr = htonl(INADDR_ANY);
     addr.sin_port = htons(local_port_);
 
-    if (::bind(socket_, reinterpret_cast<const struct sockaddr*>(&addr), sizeof(addr)) < 0) {
+    if (::bind(fd, reinterpret_cast<const struct sockaddr*>(&addr), sizeof(addr)) < 0) {
         AC_ERROR("Failed to bind socket to address: %s (%d)", ::strerror(errno), errno);
+        ::close(fd);
         return false;
     }
 
+    socket_ = fd;
+
+    ReadEffectiveProfile(fd);
+    PublishEffectiveProfile();
+
+    return true;
+}
+
+void UdpStream::ApplyProfile(int fd) {
+    // Everything beyond the buffer size only tunes how our packets go
+    // out so failing to apply any of it isn't fatal.
+    int value = profile_.type_of_service;
+    if (value >= 0 && ::setsockopt(fd, IPPROTO_IP, IP_TOS, &value, sizeof(value)) < 0)
+        AC_WARNING("Failed to set type of service: %s (%d)", ::strerror(errno), errno);
+
+    // Setting the type of service may have changed the priority as well
+    // so this has to come afterwards.
+    value = profile_.priority;
+    if (value >= 0 && ::setsockopt(fd, SOL_SOCKET, SO_PRIORITY, &value, sizeof(value)) < 0)
+        AC_WARNING("Failed to set socket priority: %s (%d)", ::strerror(errno), errno);
+
+    value = MtuDiscoveryOption(profile_.mtu_discovery);
+    if (value >= 0 && ::setsockopt(fd, IPPROTO_IP, IP_MTU_DISCOVER, &value, sizeof(value)) < 0)
+        AC_WARNING("Failed to set path MTU discovery mode: %s (%d)", ::strerror(errno), errno);
+}
+
+void UdpStream::ReadEffectiveProfile(int fd) {
+    int value = 0;
+    socklen_t length = sizeof(value);
+
+    // Linux doubles the size we asked for to account for its own
+    // bookkeeping, this is what the socket really gets.
+    if (::getsockopt(fd, SOL_SOCKET, SO_SNDBUF, &value, &length) == 0)
+        effective_profile_.send_buffer_size = value;
+
+    length = sizeof(value);
+    if (::getsockopt(fd, IPPROTO_IP, IP_TOS, &value, &length) == 0)
+        effective_profile_.type_of_service = value;
+
+    length = sizeof(value);
+    if (::getsockopt(fd, SOL_SOCKET, SO_PRIORITY, &value, &length) == 0)
+        effective_profile_.priority = value;
+
+    length = sizeof(value);
+    if (::getsockopt(fd, IPPROTO_IP, IP_MTU_DISCOVER, &value, &length) == 0)
+        effective_profile_.mtu_discovery = MtuDiscoveryMode(value);
+}
+
+void UdpStream::PublishEffectiveProfile() {
+    std::stringstream requested, effective;
+    requested << profile_;
+    effective << effective_profile_;
+
+    AC_INFO("Socket profile requested: %s effective: %s", requested.str(), effective.str());
+
+    // Makes the values show up next to the stream statistics so that
+    // runs with different profiles can be compared.
+    const auto registry = ac::report::metrics::Registry::Instance();
+    registry->RegisterGauge("network.socket.send_buffer_size")->Set(effective_profile_.send_buffer_size);
+    registry->RegisterGauge("network.socket.tos")->Set(effective_profile_.type_of_service);
+    registry->RegisterGauge("network.socket.priority")->Set(effective_profile_.priority);
+    registry->RegisterGauge("network.socket.pmtudisc")->Set(
+                MtuDiscoveryOption(effective_profile_.mtu_discovery));
+}
+
+SocketProfile UdpStream::EffectiveProfile() const {
+    return effective_profile_;
+}
+
+bool UdpStream::Connect(const std::string &address, const Port &port) {
+    AC_DEBUG("Connected with remote on %s:%d", address, port);
+
+    // Unless Prepare() did it already
+    if (!Prepare())
+        return false;
+
     struct sockaddr_in remote_addr;
     memset(remote_addr.sin_zero, 0, sizeof(remote_addr.sin_zero));
     remote_addr.sin_family = AF_INET;
@@ -143,6 +268,62 @@ Stream::Error UdpStream::Write(const uint8_t *data, unsigned int size,
     return Error::kNone;
 }
 
+bool UdpStream::SendProbe() {
+    if (socket_ <= 0)
+        return false;
+
+    // Receivers drop packets which are too short to carry a RTP header
+    // so an empty datagram doesn't hurt anyone who is already listening.
+    if (::send(socket_, nullptr, 0, 0) < 0 && errno != ECONNREFUSED) {
+        AC_ERROR("Failed to send probe to remote: %s (%d)", ::strerror(errno), errno);
+        return false;
+    }
+
+    return true;
+}
+
+bool UdpStream::RemoteRefused() {
+    if (socket_ <= 0)
+        return false;
+
+    bool refused = false;
+
+    // Reading the error queue also clears the pending error of the
+    // socket so that a later write doesn't fail because of an old
+    // refused packet.
+    while (true) {
+        std::uint8_t control[512];
+        struct msghdr msg;
+        memset(&msg, 0, sizeof(msg));
+        msg.msg_control = control;
+        msg.msg_controllen = sizeof(control);
+
+        if (::recvmsg(socket_, &msg, MSG_ERRQUEUE | MSG_DONTWAIT) < 0)
+            break;
+
+        for (auto cmsg = CMSG_FIRSTHDR(&msg); cmsg; cmsg = CMSG_NXTHDR(&msg, cmsg)) {
+            if (cmsg->cmsg_level != IPPROTO_IP || cmsg->cmsg_type != IP_RECVERR)
+                continue;
+
+            const auto err = reinterpret_cast<const struct sock_extended_err*>(CMSG_DATA(cmsg));
+            if (err->ee_origin == SO_EE_ORIGIN_ICMP &&
+                    err->ee_type == ICMP_DEST_UNREACH &&
+                    err->ee_code == ICMP_PORT_UNREACH)
+                refused = true;
+        }
+    }
+
+    // Without extended error reporting the refusal only shows up as
+    // pending error of the socket.
+    int error = 0;
+    socklen_t length = sizeof(error);
+    if (::getsockopt(socket_, SOL_SOCKET, SO_ERROR, &error, &length) == 0 &&
+            error == ECONNREFUSED)
+        refused = true;
+
+    return refused;
+}
+
 Port UdpStream::LocalPort() const {
     return local_port_;
 }
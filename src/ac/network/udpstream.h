@@ -22,6 +22,7 @@
 
 #include "ac/non_copyable.h"
 
+#include "ac/network/socketprofile.h"
 #include "ac/network/stream.h"
 
 namespace ac {
@@ -29,9 +30,10 @@ namespace network {
 
 class UdpStream : public Stream {
 public:
-    UdpStream();
+    explicit UdpStream(const SocketProfile &profile = SocketProfile::FromEnvironment());
     ~UdpStream();
 
+    bool Prepare() override;
     bool Connect(const std::string &address, const Port &port) override;
 
     Error Write(const uint8_t *data, unsigned int size,
@@ -39,11 +41,24 @@ public:
 
     Port LocalPort() const override;
 
+    bool SendProbe() override;
+    bool RemoteRefused() override;
+
     std::uint32_t MaxUnitSize() const override;
 
+    // Returns what the system actually applied of our socket profile
+    // once the socket exists.
+    SocketProfile EffectiveProfile() const;
+
 private:
+    void ApplyProfile(int fd);
+    void ReadEffectiveProfile(int fd);
+    void PublishEffectiveProfile();
+
     int socket_;
     Port local_port_;
+    const SocketProfile profile_;
+    SocketProfile effective_profile_;
 };
 
 } // namespace network
@@ -0,0 +1,64 @@
+/*
+ * Copyright (C) 2016 Canonical, Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 3, as published
+ * by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranties of
+ * MERCHANTABILITY, SATISFACTORY QUALITY, or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "ac/report/composite/compositereportfactory.h"
+#include "ac/report/composite/encoderreport.h"
+#include "ac/report/composite/rendererreport.h"
+#include "ac/report/composite/packetizerreport.h"
+#include "ac/report/composite/senderreport.h"
+
+namespace ac {
+namespace report {
+
+CompositeReportFactory::CompositeReportFactory(const std::vector<ReportFactory::Ptr> &factories) :
+    factories_(factories) {
+}
+
+std::shared_ptr<video::EncoderReport> CompositeReportFactory::CreateEncoderReport() {
+    std::vector<video::EncoderReport::Ptr> reports;
+    for (const auto &factory : factories_)
+        reports.push_back(factory->CreateEncoderReport());
+    return std::make_shared<composite::EncoderReport>(reports);
+}
+
+std::shared_ptr<video::RendererReport> CompositeReportFactory::CreateRendererReport() {
+    std::vector<video::RendererReport::Ptr> reports;
+    for (const auto &factory : factories_)
+        reports.push_back(factory->CreateRendererReport());
+    return std::make_shared<composite::RendererReport>(reports);
+}
+
+std::shared_ptr<video::PacketizerReport> CompositeReportFactory::CreatePacketizerReport() {
+    std::vector<video::PacketizerReport::Ptr> reports;
+    for (const auto &factory : factories_)
+        reports.push_back(factory->CreatePacketizerReport());
+    return std::make_shared<composite::PacketizerReport>(reports);
+}
+
+std::shared_ptr<video::SenderReport> CompositeReportFactory::CreateSenderReport() {
+    std::vector<video::SenderReport::Ptr> reports;
+    for (const auto &factory : factories_)
+        reports.push_back(factory->CreateSenderReport());
+    return std::make_shared<composite::SenderReport>(reports);
+}
+
+std::vector<ReportFactory::Ptr> CompositeReportFactory::Factories() const {
+    return factories_;
+}
+
+} // namespace report
+} // namespace ac
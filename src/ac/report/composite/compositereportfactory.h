@@ -0,0 +1,49 @@
+/*
+ * Copyright (C) 2016 Canonical, Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 3, as published
+ * by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranties of
+ * MERCHANTABILITY, SATISFACTORY QUALITY, or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef AC_REPORT_COMPOSITEREPORTFACTORY_H_
+#define AC_REPORT_COMPOSITEREPORTFACTORY_H_
+
+#include <memory>
+#include <vector>
+
+#include "ac/report/reportfactory.h"
+
+namespace ac {
+namespace report {
+
+// Fans every event out to the reports of several other factories so
+// that for example metrics can be kept while recording a trace.
+class CompositeReportFactory : public ReportFactory {
+public:
+    explicit CompositeReportFactory(const std::vector<ReportFactory::Ptr> &factories);
+
+    std::shared_ptr<video::EncoderReport> CreateEncoderReport();
+    std::shared_ptr<video::RendererReport> CreateRendererReport();
+    std::shared_ptr<video::PacketizerReport> CreatePacketizerReport();
+    std::shared_ptr<video::SenderReport> CreateSenderReport();
+
+    std::vector<ReportFactory::Ptr> Factories() const;
+
+private:
+    std::vector<ReportFactory::Ptr> factories_;
+};
+
+} // namespace report
+} // namespace ac
+
+#endif
@@ -0,0 +1,65 @@
+/*
+ * Copyright (C) 2016 Canonical, Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 3, as published
+ * by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranties of
+ * MERCHANTABILITY, SATISFACTORY QUALITY, or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "ac/report/composite/encoderreport.h"
+
+namespace ac {
+namespace report {
+namespace composite {
+
+EncoderReport::EncoderReport(const std::vector<video::EncoderReport::Ptr> &reports) :
+    reports_(reports) {
+}
+
+void EncoderReport::Started() {
+    for (const auto &report : reports_)
+        report->Started();
+}
+
+void EncoderReport::Stopped() {
+    for (const auto &report : reports_)
+        report->Stopped();
+}
+
+void EncoderReport::BeganFrame(const video::FrameNumber &frame, const ac::TimestampUs &timestamp) {
+    for (const auto &report : reports_)
+        report->BeganFrame(frame, timestamp);
+}
+
+void EncoderReport::FinishedFrame(const video::FrameNumber &frame, const ac::TimestampUs &timestamp) {
+    for (const auto &report : reports_)
+        report->FinishedFrame(frame, timestamp);
+}
+
+void EncoderReport::ReceivedInputBuffer(const video::FrameNumber &frame, const ac::TimestampUs &timestamp) {
+    for (const auto &report : reports_)
+        report->ReceivedInputBuffer(frame, timestamp);
+}
+
+void EncoderReport::RequestedIDRFrame() {
+    for (const auto &report : reports_)
+        report->RequestedIDRFrame();
+}
+
+void EncoderReport::EmittedIDRFrame() {
+    for (const auto &report : reports_)
+        report->EmittedIDRFrame();
+}
+
+} // namespace composite
+} // namespace report
+} // namespace ac
@@ -0,0 +1,55 @@
+/*
+ * Copyright (C) 2016 Canonical, Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 3, as published
+ * by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranties of
+ * MERCHANTABILITY, SATISFACTORY QUALITY, or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "ac/report/composite/rendererreport.h"
+
+namespace ac {
+namespace report {
+namespace composite {
+
+RendererReport::RendererReport(const std::vector<video::RendererReport::Ptr> &reports) :
+    reports_(reports) {
+}
+
+void RendererReport::BeganFrame() {
+    for (const auto &report : reports_)
+        report->BeganFrame();
+}
+
+void RendererReport::FinishedFrame(const video::FrameNumber &frame, const ac::TimestampUs &timestamp) {
+    for (const auto &report : reports_)
+        report->FinishedFrame(frame, timestamp);
+}
+
+void RendererReport::UnchangedFrame(const ac::TimestampUs &timestamp) {
+    for (const auto &report : reports_)
+        report->UnchangedFrame(timestamp);
+}
+
+void RendererReport::SkippedFrames(const unsigned int &count) {
+    for (const auto &report : reports_)
+        report->SkippedFrames(count);
+}
+
+void RendererReport::FrameLateness(const ac::TimestampUs &lateness) {
+    for (const auto &report : reports_)
+        report->FrameLateness(lateness);
+}
+
+} // namespace composite
+} // namespace report
+} // namespace ac
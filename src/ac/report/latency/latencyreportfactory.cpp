@@ -0,0 +1,52 @@
+/*
+ * Copyright (C) 2016 Canonical, Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 3, as published
+ * by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranties of
+ * MERCHANTABILITY, SATISFACTORY QUALITY, or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "ac/report/latency/latencyreportfactory.h"
+#include "ac/report/latency/encoderreport.h"
+#include "ac/report/latency/rendererreport.h"
+#include "ac/report/latency/packetizerreport.h"
+#include "ac/report/latency/senderreport.h"
+
+namespace ac {
+namespace report {
+
+LatencyReportFactory::LatencyReportFactory() :
+    tracker_(latency::Tracker::Create()) {
+}
+
+std::shared_ptr<video::EncoderReport> LatencyReportFactory::CreateEncoderReport() {
+    return std::make_shared<latency::EncoderReport>(tracker_);
+}
+
+std::shared_ptr<video::RendererReport> LatencyReportFactory::CreateRendererReport() {
+    return std::make_shared<latency::RendererReport>(tracker_);
+}
+
+std::shared_ptr<video::PacketizerReport> LatencyReportFactory::CreatePacketizerReport() {
+    return std::make_shared<latency::PacketizerReport>(tracker_);
+}
+
+std::shared_ptr<video::SenderReport> LatencyReportFactory::CreateSenderReport() {
+    return std::make_shared<latency::SenderReport>(tracker_);
+}
+
+latency::Tracker::Ptr LatencyReportFactory::Tracker() const {
+    return tracker_;
+}
+
+} // namespace report
+} // namespace ac
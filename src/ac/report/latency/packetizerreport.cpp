@@ -0,0 +1,37 @@
+/*
+ * Copyright (C) 2016 Canonical, Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 3, as published
+ * by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranties of
+ * MERCHANTABILITY, SATISFACTORY QUALITY, or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <boost/concept_check.hpp>
+
+#include "ac/report/latency/packetizerreport.h"
+
+namespace ac {
+namespace report {
+namespace latency {
+
+PacketizerReport::PacketizerReport(const Tracker::Ptr &tracker) :
+    tracker_(tracker) {
+}
+
+void PacketizerReport::PacketizedFrame(const video::FrameNumber &frame, const ac::TimestampUs &timestamp) {
+    boost::ignore_unused_variable_warning(timestamp);
+    tracker_->FramePacketized(frame, ac::Utils::GetNowUs());
+}
+
+} // namespace latency
+} // namespace report
+} // namespace ac
@@ -0,0 +1,43 @@
+/*
+ * Copyright (C) 2016 Canonical, Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 3, as published
+ * by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranties of
+ * MERCHANTABILITY, SATISFACTORY QUALITY, or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef AC_REPORT_LATENCY_PACKETIZERREPORT_H_
+#define AC_REPORT_LATENCY_PACKETIZERREPORT_H_
+
+#include "ac/video/packetizerreport.h"
+
+#include "ac/report/latency/tracker.h"
+
+namespace ac {
+namespace report {
+namespace latency {
+
+class PacketizerReport : public video::PacketizerReport {
+public:
+    explicit PacketizerReport(const Tracker::Ptr &tracker);
+
+    void PacketizedFrame(const video::FrameNumber &frame, const ac::TimestampUs &timestamp);
+
+private:
+    Tracker::Ptr tracker_;
+};
+
+} // namespace latency
+} // namespace report
+} // namespace ac
+
+#endif
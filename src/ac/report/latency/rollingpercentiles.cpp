@@ -0,0 +1,80 @@
+/*
+ * Copyright (C) 2016 Canonical, Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 3, as published
+ * by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranties of
+ * MERCHANTABILITY, SATISFACTORY QUALITY, or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <algorithm>
+#include <cmath>
+
+#include "ac/report/latency/rollingpercentiles.h"
+
+namespace ac {
+namespace report {
+namespace latency {
+
+RollingPercentiles::RollingPercentiles(std::size_t window_size) :
+    window_size_(std::max<std::size_t>(1, window_size)),
+    next_(0) {
+    samples_.reserve(window_size_);
+}
+
+void RollingPercentiles::Add(std::int64_t value) {
+    if (samples_.size() < window_size_) {
+        samples_.push_back(value);
+        return;
+    }
+
+    samples_[next_] = value;
+    next_ = (next_ + 1) % window_size_;
+}
+
+void RollingPercentiles::Clear() {
+    samples_.clear();
+    next_ = 0;
+}
+
+std::int64_t RollingPercentiles::Percentile(double percentile) const {
+    if (samples_.empty())
+        return 0;
+
+    percentile = std::min(100.0, std::max(0.0, percentile));
+
+    auto rank = static_cast<std::size_t>(std::ceil(percentile / 100.0 * samples_.size()));
+    if (rank > 0)
+        rank--;
+
+    auto sorted = samples_;
+    std::nth_element(sorted.begin(), sorted.begin() + rank, sorted.end());
+    return sorted[rank];
+}
+
+std::int64_t RollingPercentiles::Max() const {
+    if (samples_.empty())
+        return 0;
+
+    return *std::max_element(samples_.begin(), samples_.end());
+}
+
+std::size_t RollingPercentiles::Size() const {
+    return samples_.size();
+}
+
+std::size_t RollingPercentiles::WindowSize() const {
+    return window_size_;
+}
+
+} // namespace latency
+} // namespace report
+} // namespace ac
@@ -0,0 +1,56 @@
+/*
+ * Copyright (C) 2016 Canonical, Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 3, as published
+ * by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranties of
+ * MERCHANTABILITY, SATISFACTORY QUALITY, or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef AC_REPORT_LATENCY_ROLLINGPERCENTILES_H_
+#define AC_REPORT_LATENCY_ROLLINGPERCENTILES_H_
+
+#include <cstdint>
+#include <vector>
+
+namespace ac {
+namespace report {
+namespace latency {
+
+// Keeps the last samples up to the size of its window and calculates
+// percentiles over them. Older samples are overwritten so the result
+// always reflects the recent behavior only.
+class RollingPercentiles {
+public:
+    explicit RollingPercentiles(std::size_t window_size);
+
+    void Add(std::int64_t value);
+    void Clear();
+
+    // Nearest-rank percentile for 0 < percentile <= 100. Returns zero
+    // when no samples were added yet.
+    std::int64_t Percentile(double percentile) const;
+    std::int64_t Max() const;
+
+    std::size_t Size() const;
+    std::size_t WindowSize() const;
+
+private:
+    std::vector<std::int64_t> samples_;
+    std::size_t window_size_;
+    std::size_t next_;
+};
+
+} // namespace latency
+} // namespace report
+} // namespace ac
+
+#endif
@@ -0,0 +1,43 @@
+/*
+ * Copyright (C) 2016 Canonical, Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 3, as published
+ * by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranties of
+ * MERCHANTABILITY, SATISFACTORY QUALITY, or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <boost/concept_check.hpp>
+
+#include "ac/report/latency/senderreport.h"
+
+namespace ac {
+namespace report {
+namespace latency {
+
+SenderReport::SenderReport(const Tracker::Ptr &tracker) :
+    tracker_(tracker) {
+}
+
+void SenderReport::SentPacket(const video::FrameNumber &frame, const ac::TimestampUs &timestamp, const size_t &size) {
+    boost::ignore_unused_variable_warning(timestamp);
+    boost::ignore_unused_variable_warning(size);
+    tracker_->PacketSent(frame, ac::Utils::GetNowUs());
+}
+
+void SenderReport::FailedToSendPacket(const video::FrameNumber &frame, const ac::TimestampUs &timestamp) {
+    boost::ignore_unused_variable_warning(frame);
+    boost::ignore_unused_variable_warning(timestamp);
+}
+
+} // namespace latency
+} // namespace report
+} // namespace ac
@@ -0,0 +1,196 @@
+/*
+ * Copyright (C) 2016 Canonical, Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 3, as published
+ * by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranties of
+ * MERCHANTABILITY, SATISFACTORY QUALITY, or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <algorithm>
+
+#include "ac/logger.h"
+
+#include "ac/report/latency/tracker.h"
+
+namespace ac {
+namespace report {
+namespace latency {
+
+constexpr std::size_t Tracker::kNumStages;
+constexpr std::size_t Tracker::kDefaultWindowSize;
+constexpr std::size_t Tracker::kMaxFramesInFlight;
+constexpr std::chrono::seconds Tracker::kDumpInterval;
+
+Tracker::Ptr Tracker::Create(std::size_t window_size) {
+    return std::shared_ptr<Tracker>(new Tracker(window_size));
+}
+
+Tracker::Tracker(std::size_t window_size) :
+    stages_(kNumStages, RollingPercentiles(window_size)),
+    sending_frame_(0),
+    last_dump_(0) {
+}
+
+Tracker::~Tracker() {
+    DumpUnlocked();
+}
+
+std::string Tracker::StageName(Stage stage) {
+    switch (stage) {
+    case Stage::kCapture:
+        return "capture";
+    case Stage::kEncode:
+        return "encode";
+    case Stage::kPacketize:
+        return "packetize";
+    case Stage::kQueue:
+        return "queue";
+    case Stage::kSend:
+        return "send";
+    case Stage::kTotal:
+        return "total";
+    default:
+        break;
+    }
+    return "unknown";
+}
+
+Tracker::Record& Tracker::RecordFor(const video::FrameNumber &frame) {
+    auto iter = frames_.find(frame);
+    if (iter != frames_.end())
+        return iter->second;
+
+    // Frames which never made it through the whole pipeline would
+    // otherwise pile up here.
+    if (frames_.size() >= kMaxFramesInFlight)
+        frames_.erase(frames_.begin());
+
+    return frames_[frame] = Record{0, 0, 0, 0, 0, 0, 0};
+}
+
+void Tracker::FrameRendered(const video::FrameNumber &frame, const ac::TimestampUs &capture_timestamp,
+                            const ac::TimestampUs &now) {
+    if (frame == 0)
+        return;
+
+    std::lock_guard<std::mutex> l(mutex_);
+    auto &record = RecordFor(frame);
+    record.captured = capture_timestamp;
+    record.rendered = now;
+}
+
+void Tracker::FrameReceivedByEncoder(const video::FrameNumber &frame, const ac::TimestampUs &now) {
+    if (frame == 0)
+        return;
+
+    std::lock_guard<std::mutex> l(mutex_);
+    RecordFor(frame).encoder_received = now;
+}
+
+void Tracker::FrameEncoded(const video::FrameNumber &frame, const ac::TimestampUs &now) {
+    if (frame == 0)
+        return;
+
+    std::lock_guard<std::mutex> l(mutex_);
+    RecordFor(frame).encoded = now;
+}
+
+void Tracker::FramePacketized(const video::FrameNumber &frame, const ac::TimestampUs &now) {
+    if (frame == 0)
+        return;
+
+    std::lock_guard<std::mutex> l(mutex_);
+    RecordFor(frame).packetized = now;
+}
+
+void Tracker::PacketSent(const video::FrameNumber &frame, const ac::TimestampUs &now) {
+    if (frame == 0)
+        return;
+
+    std::lock_guard<std::mutex> l(mutex_);
+
+    // Datagrams go out in order so once we see the first one of the
+    // next frame the previous one is completely sent.
+    if (frame != sending_frame_) {
+        FinishFrame(sending_frame_);
+        sending_frame_ = frame;
+    }
+
+    auto &record = RecordFor(frame);
+    if (record.first_sent == 0)
+        record.first_sent = now;
+    record.last_sent = now;
+
+    if (now - last_dump_ >= std::chrono::duration_cast<std::chrono::microseconds>(kDumpInterval).count()) {
+        if (last_dump_ > 0)
+            DumpUnlocked();
+        last_dump_ = now;
+    }
+}
+
+void Tracker::FinishFrame(const video::FrameNumber &frame) {
+    auto iter = frames_.find(frame);
+    if (iter == frames_.end())
+        return;
+
+    const auto record = iter->second;
+    frames_.erase(iter);
+
+    // Only frames we've seen in all stages give a complete picture
+    if (record.captured == 0 || record.rendered == 0 || record.encoder_received == 0 ||
+            record.encoded == 0 || record.packetized == 0 || record.first_sent == 0)
+        return;
+
+    AddSample(Stage::kCapture, record.captured, record.rendered);
+    AddSample(Stage::kEncode, record.encoder_received, record.encoded);
+    AddSample(Stage::kPacketize, record.encoded, record.packetized);
+    AddSample(Stage::kQueue, record.packetized, record.first_sent);
+    AddSample(Stage::kSend, record.first_sent, record.last_sent);
+    AddSample(Stage::kTotal, record.captured, record.last_sent);
+}
+
+void Tracker::AddSample(Stage stage, const ac::TimestampUs &begin, const ac::TimestampUs &end) {
+    stages_[static_cast<std::size_t>(stage)].Add(std::max<ac::TimestampUs>(0, end - begin));
+}
+
+Tracker::Summary Tracker::StageSummary(Stage stage) const {
+    std::lock_guard<std::mutex> l(mutex_);
+    const auto &percentiles = stages_[static_cast<std::size_t>(stage)];
+    return Summary{percentiles.Size(),
+                   percentiles.Percentile(50),
+                   percentiles.Percentile(90),
+                   percentiles.Percentile(99),
+                   percentiles.Max()};
+}
+
+void Tracker::Dump() const {
+    std::lock_guard<std::mutex> l(mutex_);
+    DumpUnlocked();
+}
+
+void Tracker::DumpUnlocked() const {
+    for (std::size_t n = 0; n < kNumStages; n++) {
+        const auto &percentiles = stages_[n];
+        if (percentiles.Size() == 0)
+            continue;
+
+        AC_INFO("%s latency p50 %lld us p90 %lld us p99 %lld us max %lld us (%d frames)",
+                StageName(static_cast<Stage>(n)),
+                percentiles.Percentile(50), percentiles.Percentile(90),
+                percentiles.Percentile(99), percentiles.Max(),
+                percentiles.Size());
+    }
+}
+
+} // namespace latency
+} // namespace report
+} // namespace ac
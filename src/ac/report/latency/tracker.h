@@ -0,0 +1,124 @@
+/*
+ * Copyright (C) 2016 Canonical, Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 3, as published
+ * by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranties of
+ * MERCHANTABILITY, SATISFACTORY QUALITY, or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef AC_REPORT_LATENCY_TRACKER_H_
+#define AC_REPORT_LATENCY_TRACKER_H_
+
+#include <chrono>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "ac/non_copyable.h"
+#include "ac/utils.h"
+
+#include "ac/video/buffer.h"
+
+#include "ac/report/latency/rollingpercentiles.h"
+
+namespace ac {
+namespace report {
+namespace latency {
+
+// Tracker follows every frame by its number through all stages of the
+// pipeline and keeps rolling percentiles of the time spent in each of
+// them. Frames not seen in every stage are left out.
+class Tracker : public ac::NonCopyable {
+public:
+    typedef std::shared_ptr<Tracker> Ptr;
+
+    enum class Stage {
+        // From the capture timestamp until the renderer is done
+        kCapture,
+        // From the encoder receiving the frame until it finished it
+        kEncode,
+        // From the encoder output until the packetizer is done
+        kPacketize,
+        // From the packetizer until the first datagram is out
+        kQueue,
+        // From the first until the last datagram of the frame is out
+        kSend,
+        // From the capture timestamp until the last datagram is out
+        kTotal
+    };
+
+    static constexpr std::size_t kNumStages{6};
+    // Enough to cover the last ten seconds at 30 frames per second
+    static constexpr std::size_t kDefaultWindowSize{300};
+    static constexpr std::size_t kMaxFramesInFlight{64};
+    static constexpr std::chrono::seconds kDumpInterval{10};
+
+    struct Summary {
+        std::size_t samples;
+        ac::TimestampUs p50;
+        ac::TimestampUs p90;
+        ac::TimestampUs p99;
+        ac::TimestampUs max;
+    };
+
+    static Ptr Create(std::size_t window_size = kDefaultWindowSize);
+
+    static std::string StageName(Stage stage);
+
+    ~Tracker();
+
+    void FrameRendered(const video::FrameNumber &frame, const ac::TimestampUs &capture_timestamp,
+                       const ac::TimestampUs &now);
+    void FrameReceivedByEncoder(const video::FrameNumber &frame, const ac::TimestampUs &now);
+    void FrameEncoded(const video::FrameNumber &frame, const ac::TimestampUs &now);
+    void FramePacketized(const video::FrameNumber &frame, const ac::TimestampUs &now);
+    void PacketSent(const video::FrameNumber &frame, const ac::TimestampUs &now);
+
+    Summary StageSummary(Stage stage) const;
+
+    // Writes the percentiles of all stages to the log
+    void Dump() const;
+
+private:
+    struct Record {
+        ac::TimestampUs captured;
+        ac::TimestampUs rendered;
+        ac::TimestampUs encoder_received;
+        ac::TimestampUs encoded;
+        ac::TimestampUs packetized;
+        ac::TimestampUs first_sent;
+        ac::TimestampUs last_sent;
+    };
+
+    explicit Tracker(std::size_t window_size);
+
+    Record& RecordFor(const video::FrameNumber &frame);
+    void FinishFrame(const video::FrameNumber &frame);
+    void AddSample(Stage stage, const ac::TimestampUs &begin, const ac::TimestampUs &end);
+    void DumpUnlocked() const;
+
+private:
+    mutable std::mutex mutex_;
+    std::map<video::FrameNumber, Record> frames_;
+    std::vector<RollingPercentiles> stages_;
+    // The frame we're currently sending datagrams for
+    video::FrameNumber sending_frame_;
+    ac::TimestampUs last_dump_;
+};
+
+} // namespace latency
+} // namespace report
+} // namespace ac
+
+#endif
@@ -23,6 +23,10 @@ namespace ac {
 namespace report {
 namespace logging {
 
+EncoderReport::EncoderReport(unsigned int messages_per_second) :
+    limiter_(messages_per_second) {
+}
+
 void EncoderReport::Started() {
     AC_TRACE("");
 }
@@ -31,16 +35,33 @@ void EncoderReport::Stopped() {
     AC_TRACE("");
 }
 
-void EncoderReport::BeganFrame(const ac::TimestampUs &timestamp) {
-    AC_TRACE("timestamp %lld", timestamp);
+void EncoderReport::BeganFrame(const video::FrameNumber &frame, const ac::TimestampUs &timestamp) {
+    if (!limiter_.Allow())
+        return;
+
+    AC_TRACE("frame %llu timestamp %lld", frame, timestamp);
 }
 
-void EncoderReport::FinishedFrame(const ac::TimestampUs &timestamp) {
-    AC_TRACE("timestamp %lld", timestamp);
+void EncoderReport::FinishedFrame(const video::FrameNumber &frame, const ac::TimestampUs &timestamp) {
+    if (!limiter_.Allow())
+        return;
+
+    AC_TRACE("frame %llu timestamp %lld", frame, timestamp);
 }
 
-void EncoderReport::ReceivedInputBuffer(const ac::TimestampUs &timestamp) {
-    AC_TRACE("timestamp %lld", timestamp);
+void EncoderReport::ReceivedInputBuffer(const video::FrameNumber &frame, const ac::TimestampUs &timestamp) {
+    if (!limiter_.Allow())
+        return;
+
+    AC_TRACE("frame %llu timestamp %lld", frame, timestamp);
+}
+
+void EncoderReport::RequestedIDRFrame() {
+    AC_TRACE("");
+}
+
+void EncoderReport::EmittedIDRFrame() {
+    AC_TRACE("");
 }
 
 } // namespace logging
@@ -25,17 +25,26 @@
 
 #include "ac/video/encoderreport.h"
 
+#include "ac/report/logging/ratelimiter.h"
+
 namespace ac {
 namespace report {
 namespace logging {
 
 class EncoderReport : public video::EncoderReport {
 public:
+    explicit EncoderReport(unsigned int messages_per_second = RateLimiter::kDefaultMessagesPerSecond);
+
     void Started();
     void Stopped();
-    void BeganFrame(const ac::TimestampUs &timestamp);
-    void FinishedFrame(const ac::TimestampUs &timestamp);
-    void ReceivedInputBuffer(const ac::TimestampUs &timestamp);
+    void BeganFrame(const video::FrameNumber &frame, const ac::TimestampUs &timestamp);
+    void FinishedFrame(const video::FrameNumber &frame, const ac::TimestampUs &timestamp);
+    void ReceivedInputBuffer(const video::FrameNumber &frame, const ac::TimestampUs &timestamp);
+    void RequestedIDRFrame();
+    void EmittedIDRFrame();
+
+private:
+    RateLimiter limiter_;
 };
 
 } // namespace logging
@@ -15,29 +15,59 @@
  *
  */
 
+#include <string>
+
+#include "ac/logger.h"
+#include "ac/utils.h"
+
 #include "ac/report/logging/loggingreportfactory.h"
+#include "ac/report/logging/ratelimiter.h"
 #include "ac/report/logging/encoderreport.h"
 #include "ac/report/logging/rendererreport.h"
 #include "ac/report/logging/packetizerreport.h"
 #include "ac/report/logging/senderreport.h"
 
+namespace {
+unsigned int MessagesPerSecondFromEnv() {
+    const auto value = ac::Utils::GetEnvValue("AETHERCAST_REPORT_LOG_RATE");
+    if (value.length() == 0)
+        return ac::report::logging::RateLimiter::kDefaultMessagesPerSecond;
+
+    try {
+        return std::stoul(value);
+    } catch (...) {
+        AC_WARNING("Ignoring invalid report log rate '%s'", value);
+    }
+
+    return ac::report::logging::RateLimiter::kDefaultMessagesPerSecond;
+}
+}
+
 namespace ac {
 namespace report {
 
+LoggingReportFactory::LoggingReportFactory() :
+    messages_per_second_(MessagesPerSecondFromEnv()) {
+}
+
 std::shared_ptr<video::EncoderReport> LoggingReportFactory::CreateEncoderReport() {
-    return std::make_shared<logging::EncoderReport>();
+    return std::make_shared<logging::EncoderReport>(messages_per_second_);
 }
 
 std::shared_ptr<video::RendererReport> LoggingReportFactory::CreateRendererReport() {
-    return std::make_shared<logging::RendererReport>();
+    return std::make_shared<logging::RendererReport>(messages_per_second_);
 }
 
 std::shared_ptr<video::PacketizerReport> LoggingReportFactory::CreatePacketizerReport() {
-    return std::make_shared<logging::PacketizerReport>();
+    return std::make_shared<logging::PacketizerReport>(messages_per_second_);
 }
 
 std::shared_ptr<video::SenderReport> LoggingReportFactory::CreateSenderReport() {
-    return std::make_shared<logging::SenderReport>();
+    return std::make_shared<logging::SenderReport>(messages_per_second_);
+}
+
+unsigned int LoggingReportFactory::MessagesPerSecond() const {
+    return messages_per_second_;
 }
 
 } // namespace report
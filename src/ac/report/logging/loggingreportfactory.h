@@ -29,10 +29,19 @@ namespace report {
 
 class LoggingReportFactory : public ReportFactory {
 public:
+    // Reads the number of messages each report may log per second
+    // from AETHERCAST_REPORT_LOG_RATE where zero means unlimited.
+    LoggingReportFactory();
+
     std::shared_ptr<video::EncoderReport> CreateEncoderReport();
     std::shared_ptr<video::RendererReport> CreateRendererReport();
     std::shared_ptr<video::PacketizerReport> CreatePacketizerReport();
     std::shared_ptr<video::SenderReport> CreateSenderReport();
+
+    unsigned int MessagesPerSecond() const;
+
+private:
+    unsigned int messages_per_second_;
 };
 
 } // namespace report
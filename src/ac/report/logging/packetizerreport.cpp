@@ -23,8 +23,15 @@ namespace ac {
 namespace report {
 namespace logging {
 
-void PacketizerReport::PacketizedFrame(const TimestampUs &timestamp) {
-    AC_TRACE("timestamp %lld", timestamp);
+PacketizerReport::PacketizerReport(unsigned int messages_per_second) :
+    limiter_(messages_per_second) {
+}
+
+void PacketizerReport::PacketizedFrame(const video::FrameNumber &frame, const TimestampUs &timestamp) {
+    if (!limiter_.Allow())
+        return;
+
+    AC_TRACE("frame %llu timestamp %lld", frame, timestamp);
 }
 
 } // namespace logging
@@ -25,13 +25,20 @@
 
 #include "ac/video/packetizerreport.h"
 
+#include "ac/report/logging/ratelimiter.h"
+
 namespace ac {
 namespace report {
 namespace logging {
 
 class PacketizerReport : public video::PacketizerReport {
 public:
-     void PacketizedFrame(const ac::TimestampUs &timestamp);
+    explicit PacketizerReport(unsigned int messages_per_second = RateLimiter::kDefaultMessagesPerSecond);
+
+     void PacketizedFrame(const video::FrameNumber &frame, const ac::TimestampUs &timestamp);
+
+private:
+    RateLimiter limiter_;
 };
 
 } // namespace logging
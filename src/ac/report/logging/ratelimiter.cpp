@@ -0,0 +1,69 @@
+/*
+ * Copyright (C) 2016 Canonical, Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 3, as published
+ * by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranties of
+ * MERCHANTABILITY, SATISFACTORY QUALITY, or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "ac/logger.h"
+
+#include "ac/report/logging/ratelimiter.h"
+
+namespace {
+static constexpr ac::TimestampUs kPeriod{1000000};
+}
+
+namespace ac {
+namespace report {
+namespace logging {
+
+constexpr unsigned int RateLimiter::kDefaultMessagesPerSecond;
+
+RateLimiter::RateLimiter(unsigned int messages_per_second) :
+    messages_per_second_(messages_per_second),
+    period_start_(0),
+    allowed_(0),
+    suppressed_(0) {
+}
+
+bool RateLimiter::Allow(const ac::TimestampUs &now) {
+    if (messages_per_second_ == 0)
+        return true;
+
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    if (now - period_start_ >= kPeriod) {
+        if (suppressed_ > 0)
+            AC_DEBUG("Suppressed %d report messages", suppressed_);
+
+        period_start_ = now;
+        allowed_ = 0;
+        suppressed_ = 0;
+    }
+
+    if (allowed_ >= messages_per_second_) {
+        suppressed_++;
+        return false;
+    }
+
+    allowed_++;
+    return true;
+}
+
+unsigned int RateLimiter::MessagesPerSecond() const {
+    return messages_per_second_;
+}
+
+} // namespace logging
+} // namespace report
+} // namespace ac
@@ -0,0 +1,56 @@
+/*
+ * Copyright (C) 2016 Canonical, Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 3, as published
+ * by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranties of
+ * MERCHANTABILITY, SATISFACTORY QUALITY, or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef AC_REPORT_LOGGING_RATELIMITER_H_
+#define AC_REPORT_LOGGING_RATELIMITER_H_
+
+#include <mutex>
+
+#include "ac/utils.h"
+
+namespace ac {
+namespace report {
+namespace logging {
+
+// Lets only a limited number of messages per second through so that
+// logging per frame or even per packet doesn't flood the log and slow
+// down the pipeline. How many messages were dropped is logged once
+// the next second starts.
+class RateLimiter {
+public:
+    static constexpr unsigned int kDefaultMessagesPerSecond{10};
+
+    // Zero lets all messages through
+    explicit RateLimiter(unsigned int messages_per_second = kDefaultMessagesPerSecond);
+
+    bool Allow(const ac::TimestampUs &now = ac::Utils::GetNowUs());
+
+    unsigned int MessagesPerSecond() const;
+
+private:
+    std::mutex mutex_;
+    unsigned int messages_per_second_;
+    ac::TimestampUs period_start_;
+    unsigned int allowed_;
+    unsigned int suppressed_;
+};
+
+} // namespace logging
+} // namespace report
+} // namespace ac
+
+#endif
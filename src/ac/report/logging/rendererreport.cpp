@@ -23,13 +23,42 @@ namespace ac {
 namespace report {
 namespace logging {
 
+RendererReport::RendererReport(unsigned int messages_per_second) :
+    limiter_(messages_per_second) {
+}
+
 void RendererReport::BeganFrame() {
 }
 
-void RendererReport::FinishedFrame(const TimestampUs &timestamp) {
+void RendererReport::FinishedFrame(const video::FrameNumber &frame, const TimestampUs &timestamp) {
+    if (!limiter_.Allow())
+        return;
+
+    AC_TRACE("frame %llu timestamp %lld", frame, timestamp);
+}
+
+void RendererReport::UnchangedFrame(const TimestampUs &timestamp) {
+    if (!limiter_.Allow())
+        return;
+
     AC_TRACE("timestamp %lld", timestamp);
 }
 
+void RendererReport::SkippedFrames(const unsigned int &count) {
+    if (!limiter_.Allow())
+        return;
+
+    AC_TRACE("count %d", count);
+}
+
+void RendererReport::FrameLateness(const TimestampUs &lateness) {
+    // Frames on time would only push the interesting messages out
+    if (lateness == 0 || !limiter_.Allow())
+        return;
+
+    AC_TRACE("lateness %lld", lateness);
+}
+
 } // namespace logging
 } // namespace report
 } // namespace ac
@@ -25,14 +25,24 @@
 
 #include "ac/video/rendererreport.h"
 
+#include "ac/report/logging/ratelimiter.h"
+
 namespace ac {
 namespace report {
 namespace logging {
 
 class RendererReport : public video::RendererReport {
 public:
+    explicit RendererReport(unsigned int messages_per_second = RateLimiter::kDefaultMessagesPerSecond);
+
      void BeganFrame();
-     void FinishedFrame(const ac::TimestampUs &timestamp);
+     void FinishedFrame(const video::FrameNumber &frame, const ac::TimestampUs &timestamp);
+     void UnchangedFrame(const ac::TimestampUs &timestamp);
+     void SkippedFrames(const unsigned int &count);
+     void FrameLateness(const ac::TimestampUs &lateness);
+
+private:
+    RateLimiter limiter_;
 };
 
 } // namespace logging
@@ -23,8 +23,22 @@ namespace ac {
 namespace report {
 namespace logging {
 
-void SenderReport::SentPacket(const TimestampUs &timestamp, const size_t &size) {
-    AC_TRACE("timestamp %lld size %d", timestamp, size);
+SenderReport::SenderReport(unsigned int messages_per_second) :
+    limiter_(messages_per_second) {
+}
+
+void SenderReport::SentPacket(const video::FrameNumber &frame, const TimestampUs &timestamp, const size_t &size) {
+    if (!limiter_.Allow())
+        return;
+
+    AC_TRACE("frame %llu timestamp %lld size %d", frame, timestamp, size);
+}
+
+void SenderReport::FailedToSendPacket(const video::FrameNumber &frame, const ac::TimestampUs &timestamp) {
+    if (!limiter_.Allow())
+        return;
+
+    AC_TRACE("frame %llu timestamp %lld", frame, timestamp);
 }
 
 } // namespace logging
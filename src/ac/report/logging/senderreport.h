@@ -25,13 +25,21 @@
 
 #include "ac/video/senderreport.h"
 
+#include "ac/report/logging/ratelimiter.h"
+
 namespace ac {
 namespace report {
 namespace logging {
 
 class SenderReport : public video::SenderReport {
 public:
-    void SentPacket(const ac::TimestampUs &timestamp, const size_t &size);
+    explicit SenderReport(unsigned int messages_per_second = RateLimiter::kDefaultMessagesPerSecond);
+
+    void SentPacket(const video::FrameNumber &frame, const ac::TimestampUs &timestamp, const size_t &size);
+    void FailedToSendPacket(const video::FrameNumber &frame, const ac::TimestampUs &timestamp);
+
+private:
+    RateLimiter limiter_;
 };
 
 } // namespace logging
@@ -33,16 +33,24 @@ void EncoderReport::Stopped() {
     ac_tracepoint(aethercast_encoder, stopped, 0);
 }
 
-void EncoderReport::BeganFrame(const ac::TimestampUs &timestamp) {
-    ac_tracepoint(aethercast_encoder, began_frame, timestamp);
+void EncoderReport::BeganFrame(const video::FrameNumber &frame, const ac::TimestampUs &timestamp) {
+    ac_tracepoint(aethercast_encoder, began_frame, frame, timestamp);
 }
 
-void EncoderReport::FinishedFrame(const ac::TimestampUs &timestamp) {
-    ac_tracepoint(aethercast_encoder, finished_frame, timestamp);
+void EncoderReport::FinishedFrame(const video::FrameNumber &frame, const ac::TimestampUs &timestamp) {
+    ac_tracepoint(aethercast_encoder, finished_frame, frame, timestamp);
 }
 
-void EncoderReport::ReceivedInputBuffer(const ac::TimestampUs &timestamp) {
-    ac_tracepoint(aethercast_encoder, received_input_buffer, timestamp);
+void EncoderReport::ReceivedInputBuffer(const video::FrameNumber &frame, const ac::TimestampUs &timestamp) {
+    ac_tracepoint(aethercast_encoder, received_input_buffer, frame, timestamp);
+}
+
+void EncoderReport::RequestedIDRFrame() {
+    ac_tracepoint(aethercast_encoder, requested_idr_frame, 0);
+}
+
+void EncoderReport::EmittedIDRFrame() {
+    ac_tracepoint(aethercast_encoder, emitted_idr_frame, 0);
 }
 
 } // namespace logging
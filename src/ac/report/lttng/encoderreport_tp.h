@@ -32,31 +32,36 @@ AC_LTTNG_VOID_TRACE_CLASS(TRACEPOINT_PROVIDER)
 
 ENCODER_TRACE_POINT(started)
 ENCODER_TRACE_POINT(stopped)
+ENCODER_TRACE_POINT(requested_idr_frame)
+ENCODER_TRACE_POINT(emitted_idr_frame)
 
 TRACEPOINT_EVENT(
     TRACEPOINT_PROVIDER,
     began_frame,
-    TP_ARGS(int, timestamp),
+    TP_ARGS(uint64_t, frame, int64_t, timestamp),
     TP_FIELDS(
-        ctf_integer(int, timestamp, timestamp)
+        ctf_integer(uint64_t, frame, frame)
+        ctf_integer(int64_t, timestamp, timestamp)
     )
 )
 
 TRACEPOINT_EVENT(
     TRACEPOINT_PROVIDER,
     finished_frame,
-    TP_ARGS(int, timestamp),
+    TP_ARGS(uint64_t, frame, int64_t, timestamp),
     TP_FIELDS(
-        ctf_integer(int, timestamp, timestamp)
+        ctf_integer(uint64_t, frame, frame)
+        ctf_integer(int64_t, timestamp, timestamp)
     )
 )
 
 TRACEPOINT_EVENT(
     TRACEPOINT_PROVIDER,
     received_input_buffer,
-    TP_ARGS(int, timestamp),
+    TP_ARGS(uint64_t, frame, int64_t, timestamp),
     TP_FIELDS(
-        ctf_integer(int, timestamp, timestamp)
+        ctf_integer(uint64_t, frame, frame)
+        ctf_integer(int64_t, timestamp, timestamp)
     )
 )
 
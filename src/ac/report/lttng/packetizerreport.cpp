@@ -25,8 +25,8 @@ namespace ac {
 namespace report {
 namespace lttng {
 
-void PacketizerReport::PacketizedFrame(const TimestampUs &timestamp) {
-    ac_tracepoint(aethercast_packetizer, packetized_frame, timestamp);
+void PacketizerReport::PacketizedFrame(const video::FrameNumber &frame, const TimestampUs &timestamp) {
+    ac_tracepoint(aethercast_packetizer, packetized_frame, frame, timestamp);
 }
 
 } // namespace lttng
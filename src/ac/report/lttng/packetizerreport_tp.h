@@ -33,9 +33,10 @@ AC_LTTNG_VOID_TRACE_CLASS(TRACEPOINT_PROVIDER)
 TRACEPOINT_EVENT(
     TRACEPOINT_PROVIDER,
     packetized_frame,
-    TP_ARGS(int, timestamp),
+    TP_ARGS(uint64_t, frame, int64_t, timestamp),
     TP_FIELDS(
-        ctf_integer(int, timestamp, timestamp)
+        ctf_integer(uint64_t, frame, frame)
+        ctf_integer(int64_t, timestamp, timestamp)
     )
 )
 
@@ -29,8 +29,20 @@ void RendererReport::BeganFrame() {
     ac_tracepoint(aethercast_renderer, began_frame, 0);
 }
 
-void RendererReport::FinishedFrame(const TimestampUs &timestamp) {
-    ac_tracepoint(aethercast_renderer, finished_frame, timestamp);
+void RendererReport::FinishedFrame(const video::FrameNumber &frame, const TimestampUs &timestamp) {
+    ac_tracepoint(aethercast_renderer, finished_frame, frame, timestamp);
+}
+
+void RendererReport::UnchangedFrame(const TimestampUs &timestamp) {
+    ac_tracepoint(aethercast_renderer, unchanged_frame, timestamp);
+}
+
+void RendererReport::SkippedFrames(const unsigned int &count) {
+    ac_tracepoint(aethercast_renderer, skipped_frames, count);
+}
+
+void RendererReport::FrameLateness(const TimestampUs &lateness) {
+    ac_tracepoint(aethercast_renderer, frame_lateness, lateness);
 }
 
 } // namespace lttng
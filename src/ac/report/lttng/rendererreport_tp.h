@@ -35,9 +35,37 @@ ENCODER_TRACE_POINT(began_frame)
 TRACEPOINT_EVENT(
     TRACEPOINT_PROVIDER,
     finished_frame,
-    TP_ARGS(int, timestamp),
+    TP_ARGS(uint64_t, frame, int64_t, timestamp),
     TP_FIELDS(
-        ctf_integer(int, timestamp, timestamp)
+        ctf_integer(uint64_t, frame, frame)
+        ctf_integer(int64_t, timestamp, timestamp)
+    )
+)
+
+TRACEPOINT_EVENT(
+    TRACEPOINT_PROVIDER,
+    unchanged_frame,
+    TP_ARGS(int64_t, timestamp),
+    TP_FIELDS(
+        ctf_integer(int64_t, timestamp, timestamp)
+    )
+)
+
+TRACEPOINT_EVENT(
+    TRACEPOINT_PROVIDER,
+    skipped_frames,
+    TP_ARGS(unsigned int, count),
+    TP_FIELDS(
+        ctf_integer(unsigned int, count, count)
+    )
+)
+
+TRACEPOINT_EVENT(
+    TRACEPOINT_PROVIDER,
+    frame_lateness,
+    TP_ARGS(int64_t, lateness),
+    TP_FIELDS(
+        ctf_integer(int64_t, lateness, lateness)
     )
 )
 
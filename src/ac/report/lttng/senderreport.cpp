@@ -25,8 +25,12 @@ namespace ac {
 namespace report {
 namespace lttng {
 
-void SenderReport::SentPacket(const TimestampUs &timestamp, const size_t &size) {
-    ac_tracepoint(aethercast_sender, sent_packet, timestamp, size);
+void SenderReport::SentPacket(const video::FrameNumber &frame, const TimestampUs &timestamp, const size_t &size) {
+    ac_tracepoint(aethercast_sender, sent_packet, frame, timestamp, size);
+}
+
+void SenderReport::FailedToSendPacket(const video::FrameNumber &frame, const TimestampUs &timestamp) {
+    ac_tracepoint(aethercast_sender, failed_to_send_packet, frame, timestamp);
 }
 
 } // namespace lttng
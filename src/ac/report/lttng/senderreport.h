@@ -31,7 +31,8 @@ namespace lttng {
 
 class SenderReport : public video::SenderReport {
 public:
-    void SentPacket(const ac::TimestampUs &timestamp, const size_t &size);
+    void SentPacket(const video::FrameNumber &frame, const ac::TimestampUs &timestamp, const size_t &size);
+    void FailedToSendPacket(const video::FrameNumber &frame, const ac::TimestampUs &timestamp);
 };
 
 } // namespace lttng
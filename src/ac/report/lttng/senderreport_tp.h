@@ -33,13 +33,24 @@ AC_LTTNG_VOID_TRACE_CLASS(TRACEPOINT_PROVIDER)
 TRACEPOINT_EVENT(
     TRACEPOINT_PROVIDER,
     sent_packet,
-    TP_ARGS(int, timestamp, int, size),
+    TP_ARGS(uint64_t, frame, int64_t, timestamp, int, size),
     TP_FIELDS(
-        ctf_integer(int, timestamp, timestamp)
+        ctf_integer(uint64_t, frame, frame)
+        ctf_integer(int64_t, timestamp, timestamp)
         ctf_integer(int, size, size)
     )
 )
 
+TRACEPOINT_EVENT(
+    TRACEPOINT_PROVIDER,
+    failed_to_send_packet,
+    TP_ARGS(uint64_t, frame, int64_t, timestamp),
+    TP_FIELDS(
+        ctf_integer(uint64_t, frame, frame)
+        ctf_integer(int64_t, timestamp, timestamp)
+    )
+)
+
 #undef ENCODER_TRACE_POINT
 
 #endif
@@ -0,0 +1,92 @@
+/*
+ * Copyright (C) 2016 Canonical, Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 3, as published
+ * by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranties of
+ * MERCHANTABILITY, SATISFACTORY QUALITY, or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <boost/concept_check.hpp>
+
+#include "ac/report/metrics/encoderreport.h"
+
+namespace ac {
+namespace report {
+namespace metrics {
+
+EncoderReport::EncoderReport(const Registry::Ptr &registry) :
+    last_received_(0),
+    last_finished_(0),
+    frames_(registry->RegisterCounter("encoder.frames")),
+    fps_(registry->RegisterMeter("encoder.fps")),
+    queue_depth_(registry->RegisterGauge("encoder.queue_depth")),
+    idr_requests_(registry->RegisterCounter("encoder.idr_requests")),
+    idr_emitted_(registry->RegisterCounter("encoder.idr_emitted")),
+    latency_(registry->RegisterHistogram("latency.encode")) {
+}
+
+void EncoderReport::Started() {
+}
+
+void EncoderReport::Stopped() {
+    queue_depth_->Set(0);
+}
+
+void EncoderReport::BeganFrame(const video::FrameNumber &frame, const ac::TimestampUs &timestamp) {
+    boost::ignore_unused_variable_warning(frame);
+    boost::ignore_unused_variable_warning(timestamp);
+}
+
+void EncoderReport::FinishedFrame(const video::FrameNumber &frame, const ac::TimestampUs &timestamp) {
+    boost::ignore_unused_variable_warning(timestamp);
+
+    frames_->Increment();
+    fps_->Mark();
+
+    ac::TimestampUs received = 0;
+    if (received_.Get(frame, &received))
+        latency_->Record(ac::Utils::GetNowUs() - received);
+
+    if (frame > 0)
+        last_finished_.store(frame);
+
+    UpdateQueueDepth();
+}
+
+void EncoderReport::ReceivedInputBuffer(const video::FrameNumber &frame, const ac::TimestampUs &timestamp) {
+    boost::ignore_unused_variable_warning(timestamp);
+
+    received_.Set(frame, ac::Utils::GetNowUs());
+
+    if (frame > 0)
+        last_received_.store(frame);
+
+    UpdateQueueDepth();
+}
+
+void EncoderReport::RequestedIDRFrame() {
+    idr_requests_->Increment();
+}
+
+void EncoderReport::EmittedIDRFrame() {
+    idr_emitted_->Increment();
+}
+
+void EncoderReport::UpdateQueueDepth() {
+    const auto received = last_received_.load();
+    const auto finished = last_finished_.load();
+    queue_depth_->Set(received > finished ? received - finished : 0);
+}
+
+} // namespace metrics
+} // namespace report
+} // namespace ac
@@ -0,0 +1,63 @@
+/*
+ * Copyright (C) 2016 Canonical, Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 3, as published
+ * by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranties of
+ * MERCHANTABILITY, SATISFACTORY QUALITY, or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef AC_REPORT_METRICS_ENCODERREPORT_H_
+#define AC_REPORT_METRICS_ENCODERREPORT_H_
+
+#include <atomic>
+
+#include "ac/video/encoderreport.h"
+
+#include "ac/report/metrics/registry.h"
+#include "ac/report/metrics/frametimestamps.h"
+
+namespace ac {
+namespace report {
+namespace metrics {
+
+class EncoderReport : public video::EncoderReport {
+public:
+    explicit EncoderReport(const Registry::Ptr &registry);
+
+    void Started();
+    void Stopped();
+    void BeganFrame(const video::FrameNumber &frame, const ac::TimestampUs &timestamp);
+    void FinishedFrame(const video::FrameNumber &frame, const ac::TimestampUs &timestamp);
+    void ReceivedInputBuffer(const video::FrameNumber &frame, const ac::TimestampUs &timestamp);
+    void RequestedIDRFrame();
+    void EmittedIDRFrame();
+
+private:
+    void UpdateQueueDepth();
+
+private:
+    FrameTimestamps received_;
+    std::atomic<video::FrameNumber> last_received_;
+    std::atomic<video::FrameNumber> last_finished_;
+    Counter::Ptr frames_;
+    Meter::Ptr fps_;
+    Gauge::Ptr queue_depth_;
+    Counter::Ptr idr_requests_;
+    Counter::Ptr idr_emitted_;
+    Histogram::Ptr latency_;
+};
+
+} // namespace metrics
+} // namespace report
+} // namespace ac
+
+#endif
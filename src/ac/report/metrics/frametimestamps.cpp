@@ -0,0 +1,63 @@
+/*
+ * Copyright (C) 2016 Canonical, Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 3, as published
+ * by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranties of
+ * MERCHANTABILITY, SATISFACTORY QUALITY, or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "ac/report/metrics/frametimestamps.h"
+
+namespace ac {
+namespace report {
+namespace metrics {
+
+constexpr std::size_t FrameTimestamps::kNumFrames;
+
+FrameTimestamps::FrameTimestamps() {
+    for (auto &entry : entries_) {
+        entry.frame.store(0);
+        entry.timestamp.store(0);
+    }
+}
+
+void FrameTimestamps::Set(const video::FrameNumber &frame, const ac::TimestampUs &timestamp) {
+    if (frame == 0)
+        return;
+
+    auto &entry = entries_[frame % entries_.size()];
+    // Invalidate the entry first so a concurrent reader never pairs
+    // the new timestamp with an old frame number.
+    entry.frame.store(0);
+    entry.timestamp.store(timestamp);
+    entry.frame.store(frame);
+}
+
+bool FrameTimestamps::Get(const video::FrameNumber &frame, ac::TimestampUs *timestamp) const {
+    if (frame == 0 || !timestamp)
+        return false;
+
+    const auto &entry = entries_[frame % entries_.size()];
+    if (entry.frame.load() != frame)
+        return false;
+
+    const auto value = entry.timestamp.load();
+    if (entry.frame.load() != frame)
+        return false;
+
+    *timestamp = value;
+    return true;
+}
+
+} // namespace metrics
+} // namespace report
+} // namespace ac
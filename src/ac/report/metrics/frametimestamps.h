@@ -0,0 +1,62 @@
+/*
+ * Copyright (C) 2016 Canonical, Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 3, as published
+ * by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranties of
+ * MERCHANTABILITY, SATISFACTORY QUALITY, or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef AC_REPORT_METRICS_FRAMETIMESTAMPS_H_
+#define AC_REPORT_METRICS_FRAMETIMESTAMPS_H_
+
+#include <array>
+#include <atomic>
+#include <memory>
+
+#include "ac/non_copyable.h"
+#include "ac/utils.h"
+
+#include "ac/video/buffer.h"
+
+namespace ac {
+namespace report {
+namespace metrics {
+
+// Remembers a timestamp for each of the most recent frames so that one
+// stage of the pipeline can measure against another one. Old frames
+// are overwritten without taking any lock.
+class FrameTimestamps : public ac::NonCopyable {
+public:
+    typedef std::shared_ptr<FrameTimestamps> Ptr;
+
+    static constexpr std::size_t kNumFrames{64};
+
+    FrameTimestamps();
+
+    void Set(const video::FrameNumber &frame, const ac::TimestampUs &timestamp);
+    // Returns false if the frame is unknown or was overwritten already
+    bool Get(const video::FrameNumber &frame, ac::TimestampUs *timestamp) const;
+
+private:
+    struct Entry {
+        std::atomic<video::FrameNumber> frame;
+        std::atomic<ac::TimestampUs> timestamp;
+    };
+
+    std::array<Entry, kNumFrames> entries_;
+};
+
+} // namespace metrics
+} // namespace report
+} // namespace ac
+
+#endif
@@ -0,0 +1,197 @@
+/*
+ * Copyright (C) 2016 Canonical, Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 3, as published
+ * by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranties of
+ * MERCHANTABILITY, SATISFACTORY QUALITY, or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <algorithm>
+#include <cmath>
+
+#include "ac/report/metrics/metrics.h"
+
+namespace {
+static constexpr std::int64_t kNoSecond{-1};
+static constexpr std::uint64_t kDirectBuckets{2 << ac::report::metrics::Histogram::kSubBucketBits};
+static constexpr std::uint64_t kSubBuckets{1 << ac::report::metrics::Histogram::kSubBucketBits};
+}
+
+namespace ac {
+namespace report {
+namespace metrics {
+
+constexpr std::int64_t Meter::kWindowSeconds;
+constexpr unsigned int Histogram::kSubBucketBits;
+constexpr std::size_t Histogram::kNumBuckets;
+
+Counter::Counter() :
+    value_(0) {
+}
+
+void Counter::Increment(std::uint64_t amount) {
+    value_.fetch_add(amount, std::memory_order_relaxed);
+}
+
+std::uint64_t Counter::Value() const {
+    return value_.load(std::memory_order_relaxed);
+}
+
+void Counter::Reset() {
+    value_.store(0, std::memory_order_relaxed);
+}
+
+Gauge::Gauge() :
+    value_(0) {
+}
+
+void Gauge::Set(std::int64_t value) {
+    value_.store(value, std::memory_order_relaxed);
+}
+
+std::int64_t Gauge::Value() const {
+    return value_.load(std::memory_order_relaxed);
+}
+
+void Gauge::Reset() {
+    value_.store(0, std::memory_order_relaxed);
+}
+
+Meter::Meter() {
+    Reset();
+}
+
+void Meter::Mark(std::uint64_t amount, const ac::TimestampUs &now) {
+    const std::int64_t second = now / 1000000ll;
+
+    auto first = kNoSecond;
+    first_second_.compare_exchange_strong(first, second);
+
+    auto &slot = slots_[second % slots_.size()];
+    auto slot_second = slot.second.load();
+    // The first one entering a new second recycles the slot. Another
+    // thread marking at the very same moment might lose its events
+    // which is acceptable for what this is used for.
+    if (slot_second != second && slot.second.compare_exchange_strong(slot_second, second))
+        slot.count.store(0);
+
+    slot.count.fetch_add(amount);
+}
+
+double Meter::Rate(const ac::TimestampUs &now) const {
+    const std::int64_t second = now / 1000000ll;
+    const auto first = first_second_.load();
+    if (first == kNoSecond)
+        return 0.0;
+
+    // Only complete seconds are considered and we don't want to
+    // underestimate the rate before the window filled up once.
+    const auto seconds = std::min(kWindowSeconds, second - first);
+    if (seconds <= 0)
+        return 0.0;
+
+    std::uint64_t count = 0;
+    for (const auto &slot : slots_) {
+        const auto slot_second = slot.second.load();
+        if (slot_second >= second - seconds && slot_second < second)
+            count += slot.count.load();
+    }
+
+    return static_cast<double>(count) / seconds;
+}
+
+void Meter::Reset() {
+    for (auto &slot : slots_) {
+        slot.second.store(kNoSecond);
+        slot.count.store(0);
+    }
+    first_second_.store(kNoSecond);
+}
+
+Histogram::Histogram() {
+    Reset();
+}
+
+std::size_t Histogram::BucketIndex(std::uint64_t value) {
+    if (value < kDirectBuckets)
+        return value;
+
+    unsigned int msb = 0;
+    for (auto v = value; v > 1; v >>= 1)
+        msb++;
+
+    const auto shift = msb - kSubBucketBits;
+    const auto top = value >> shift;
+
+    return kDirectBuckets + (shift - 1) * kSubBuckets + (top - kSubBuckets);
+}
+
+std::uint64_t Histogram::BucketValue(std::size_t index) {
+    if (index < kDirectBuckets)
+        return index;
+
+    const auto shift = (index - kDirectBuckets) / kSubBuckets + 1;
+    const auto top = (index - kDirectBuckets) % kSubBuckets + kSubBuckets;
+    const auto lower = static_cast<std::uint64_t>(top) << shift;
+
+    return lower + ((std::uint64_t{1} << shift) >> 1);
+}
+
+void Histogram::Record(std::int64_t value) {
+    if (value < 0)
+        value = 0;
+
+    buckets_[BucketIndex(value)].fetch_add(1, std::memory_order_relaxed);
+    count_.fetch_add(1, std::memory_order_relaxed);
+
+    auto max = max_.load(std::memory_order_relaxed);
+    while (value > max && !max_.compare_exchange_weak(max, value, std::memory_order_relaxed));
+}
+
+std::uint64_t Histogram::Count() const {
+    return count_.load(std::memory_order_relaxed);
+}
+
+std::int64_t Histogram::Percentile(double percentile) const {
+    const auto count = Count();
+    if (count == 0)
+        return 0;
+
+    auto rank = static_cast<std::uint64_t>(std::ceil(percentile / 100.0 * count));
+    if (rank < 1)
+        rank = 1;
+
+    std::uint64_t seen = 0;
+    for (std::size_t n = 0; n < buckets_.size(); n++) {
+        seen += buckets_[n].load(std::memory_order_relaxed);
+        if (seen >= rank)
+            // Never report more than we actually have seen
+            return std::min<std::int64_t>(BucketValue(n), Max());
+    }
+
+    return Max();
+}
+
+std::int64_t Histogram::Max() const {
+    return max_.load(std::memory_order_relaxed);
+}
+
+void Histogram::Reset() {
+    for (auto &bucket : buckets_)
+        bucket.store(0, std::memory_order_relaxed);
+    count_.store(0, std::memory_order_relaxed);
+    max_.store(0, std::memory_order_relaxed);
+}
+
+} // namespace metrics
+} // namespace report
+} // namespace ac
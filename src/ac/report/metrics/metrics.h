@@ -0,0 +1,128 @@
+/*
+ * Copyright (C) 2016 Canonical, Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 3, as published
+ * by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranties of
+ * MERCHANTABILITY, SATISFACTORY QUALITY, or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef AC_REPORT_METRICS_METRICS_H_
+#define AC_REPORT_METRICS_METRICS_H_
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+
+#include "ac/non_copyable.h"
+#include "ac/utils.h"
+
+namespace ac {
+namespace report {
+namespace metrics {
+
+// All metrics below are updated with atomic operations only so they can
+// be fed from the streaming threads without any locking. Readers might
+// see values from slightly different points in time which is fine for
+// what they are meant for.
+
+class Counter : public ac::NonCopyable {
+public:
+    typedef std::shared_ptr<Counter> Ptr;
+
+    Counter();
+
+    void Increment(std::uint64_t amount = 1);
+    std::uint64_t Value() const;
+    void Reset();
+
+private:
+    std::atomic<std::uint64_t> value_;
+};
+
+class Gauge : public ac::NonCopyable {
+public:
+    typedef std::shared_ptr<Gauge> Ptr;
+
+    Gauge();
+
+    void Set(std::int64_t value);
+    std::int64_t Value() const;
+    void Reset();
+
+private:
+    std::atomic<std::int64_t> value_;
+};
+
+// Meter counts events in one second slots and gives their rate per
+// second over the last completed seconds.
+class Meter : public ac::NonCopyable {
+public:
+    typedef std::shared_ptr<Meter> Ptr;
+
+    static constexpr std::int64_t kWindowSeconds{5};
+
+    Meter();
+
+    void Mark(std::uint64_t amount = 1, const ac::TimestampUs &now = ac::Utils::GetNowUs());
+    double Rate(const ac::TimestampUs &now = ac::Utils::GetNowUs()) const;
+    void Reset();
+
+private:
+    struct Slot {
+        std::atomic<std::int64_t> second;
+        std::atomic<std::uint64_t> count;
+    };
+
+    // One additional slot for the second we're currently in
+    std::array<Slot, kWindowSeconds + 1> slots_;
+    std::atomic<std::int64_t> first_second_;
+};
+
+// Histogram with logarithmic buckets in the spirit of HdrHistogram.
+// Every power of two is split into 16 linear buckets which keeps the
+// error of any reported value below 1/16 for the whole range of
+// 64 bit values at a fixed memory footprint.
+class Histogram : public ac::NonCopyable {
+public:
+    typedef std::shared_ptr<Histogram> Ptr;
+
+    static constexpr unsigned int kSubBucketBits{4};
+    static constexpr std::size_t kNumBuckets{(2 << kSubBucketBits) + (64 - kSubBucketBits - 1) * (1 << kSubBucketBits)};
+
+    Histogram();
+
+    // Negative values are recorded as zero
+    void Record(std::int64_t value);
+
+    std::uint64_t Count() const;
+    // Percentile for 0 < percentile <= 100. Returns zero when nothing
+    // was recorded yet.
+    std::int64_t Percentile(double percentile) const;
+    std::int64_t Max() const;
+    void Reset();
+
+    static std::size_t BucketIndex(std::uint64_t value);
+    // Middle of the value range covered by the bucket
+    static std::uint64_t BucketValue(std::size_t index);
+
+private:
+    std::array<std::atomic<std::uint64_t>, kNumBuckets> buckets_;
+    std::atomic<std::uint64_t> count_;
+    std::atomic<std::int64_t> max_;
+};
+
+} // namespace metrics
+} // namespace report
+} // namespace ac
+
+#endif
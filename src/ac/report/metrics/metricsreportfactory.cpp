@@ -0,0 +1,51 @@
+/*
+ * Copyright (C) 2016 Canonical, Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 3, as published
+ * by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranties of
+ * MERCHANTABILITY, SATISFACTORY QUALITY, or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "ac/report/metrics/metricsreportfactory.h"
+#include "ac/report/metrics/encoderreport.h"
+#include "ac/report/metrics/rendererreport.h"
+#include "ac/report/metrics/packetizerreport.h"
+#include "ac/report/metrics/senderreport.h"
+
+namespace ac {
+namespace report {
+
+MetricsReportFactory::MetricsReportFactory(const metrics::Registry::Ptr &registry) :
+    registry_(registry),
+    captured_(std::make_shared<metrics::FrameTimestamps>()),
+    last_packetized_frame_(std::make_shared<metrics::Gauge>()) {
+    registry_->Reset();
+}
+
+std::shared_ptr<video::EncoderReport> MetricsReportFactory::CreateEncoderReport() {
+    return std::make_shared<metrics::EncoderReport>(registry_);
+}
+
+std::shared_ptr<video::RendererReport> MetricsReportFactory::CreateRendererReport() {
+    return std::make_shared<metrics::RendererReport>(registry_, captured_);
+}
+
+std::shared_ptr<video::PacketizerReport> MetricsReportFactory::CreatePacketizerReport() {
+    return std::make_shared<metrics::PacketizerReport>(registry_, last_packetized_frame_);
+}
+
+std::shared_ptr<video::SenderReport> MetricsReportFactory::CreateSenderReport() {
+    return std::make_shared<metrics::SenderReport>(registry_, captured_, last_packetized_frame_);
+}
+
+} // namespace report
+} // namespace ac
@@ -0,0 +1,51 @@
+/*
+ * Copyright (C) 2016 Canonical, Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 3, as published
+ * by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranties of
+ * MERCHANTABILITY, SATISFACTORY QUALITY, or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef AC_REPORT_METRICSREPORTFACTORY_H_
+#define AC_REPORT_METRICSREPORTFACTORY_H_
+
+#include <memory>
+
+#include "ac/report/reportfactory.h"
+#include "ac/report/metrics/registry.h"
+#include "ac/report/metrics/frametimestamps.h"
+
+namespace ac {
+namespace report {
+
+// Creates reports which keep counters, rates and latency histograms
+// in a metrics registry. By default that is the one exported on the
+// bus. All values are reset as a new factory means a new session.
+class MetricsReportFactory : public ReportFactory {
+public:
+    explicit MetricsReportFactory(const metrics::Registry::Ptr &registry = metrics::Registry::Instance());
+
+    std::shared_ptr<video::EncoderReport> CreateEncoderReport();
+    std::shared_ptr<video::RendererReport> CreateRendererReport();
+    std::shared_ptr<video::PacketizerReport> CreatePacketizerReport();
+    std::shared_ptr<video::SenderReport> CreateSenderReport();
+
+private:
+    metrics::Registry::Ptr registry_;
+    metrics::FrameTimestamps::Ptr captured_;
+    metrics::Gauge::Ptr last_packetized_frame_;
+};
+
+} // namespace report
+} // namespace ac
+
+#endif
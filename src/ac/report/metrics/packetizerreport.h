@@ -0,0 +1,46 @@
+/*
+ * Copyright (C) 2016 Canonical, Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 3, as published
+ * by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranties of
+ * MERCHANTABILITY, SATISFACTORY QUALITY, or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef AC_REPORT_METRICS_PACKETIZERREPORT_H_
+#define AC_REPORT_METRICS_PACKETIZERREPORT_H_
+
+#include "ac/video/packetizerreport.h"
+
+#include "ac/report/metrics/registry.h"
+
+namespace ac {
+namespace report {
+namespace metrics {
+
+class PacketizerReport : public video::PacketizerReport {
+public:
+    // The last packetized frame is shared with the sender report to
+    // calculate how many frames are waiting to be sent.
+    PacketizerReport(const Registry::Ptr &registry, const Gauge::Ptr &last_frame);
+
+    void PacketizedFrame(const video::FrameNumber &frame, const ac::TimestampUs &timestamp);
+
+private:
+    Gauge::Ptr last_frame_;
+    Counter::Ptr frames_;
+};
+
+} // namespace metrics
+} // namespace report
+} // namespace ac
+
+#endif
@@ -0,0 +1,115 @@
+/*
+ * Copyright (C) 2016 Canonical, Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 3, as published
+ * by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranties of
+ * MERCHANTABILITY, SATISFACTORY QUALITY, or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "ac/report/metrics/registry.h"
+
+namespace {
+template<typename T>
+std::shared_ptr<T> FindOrCreate(std::map<std::string, std::shared_ptr<T>> &metrics, const std::string &name) {
+    auto iter = metrics.find(name);
+    if (iter != metrics.end())
+        return iter->second;
+
+    auto metric = std::make_shared<T>();
+    metrics.insert({name, metric});
+    return metric;
+}
+}
+
+namespace ac {
+namespace report {
+namespace metrics {
+
+Registry::Ptr Registry::Create() {
+    return Ptr(new Registry);
+}
+
+Registry::Ptr Registry::Instance() {
+    static const auto instance = Create();
+    return instance;
+}
+
+Registry::Registry() {
+}
+
+Counter::Ptr Registry::RegisterCounter(const std::string &name) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return FindOrCreate(counters_, name);
+}
+
+Gauge::Ptr Registry::RegisterGauge(const std::string &name) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return FindOrCreate(gauges_, name);
+}
+
+Meter::Ptr Registry::RegisterMeter(const std::string &name) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return FindOrCreate(meters_, name);
+}
+
+Histogram::Ptr Registry::RegisterHistogram(const std::string &name) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return FindOrCreate(histograms_, name);
+}
+
+Registry::Snapshot Registry::TakeSnapshot() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    Snapshot snapshot;
+
+    for (const auto &counter : counters_)
+        snapshot[counter.first] = counter.second->Value();
+
+    for (const auto &gauge : gauges_)
+        snapshot[gauge.first] = gauge.second->Value();
+
+    const auto now = ac::Utils::GetNowUs();
+    for (const auto &meter : meters_)
+        snapshot[meter.first] = meter.second->Rate(now);
+
+    for (const auto &histogram : histograms_) {
+        const auto &name = histogram.first;
+        const auto &h = histogram.second;
+        snapshot[name + ".count"] = h->Count();
+        snapshot[name + ".p50"] = h->Percentile(50);
+        snapshot[name + ".p90"] = h->Percentile(90);
+        snapshot[name + ".p99"] = h->Percentile(99);
+        snapshot[name + ".max"] = h->Max();
+    }
+
+    return snapshot;
+}
+
+void Registry::Reset() {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    for (const auto &counter : counters_)
+        counter.second->Reset();
+
+    for (const auto &gauge : gauges_)
+        gauge.second->Reset();
+
+    for (const auto &meter : meters_)
+        meter.second->Reset();
+
+    for (const auto &histogram : histograms_)
+        histogram.second->Reset();
+}
+
+} // namespace metrics
+} // namespace report
+} // namespace ac
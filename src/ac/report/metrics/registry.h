@@ -0,0 +1,78 @@
+/*
+ * Copyright (C) 2016 Canonical, Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 3, as published
+ * by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranties of
+ * MERCHANTABILITY, SATISFACTORY QUALITY, or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef AC_REPORT_METRICS_REGISTRY_H_
+#define AC_REPORT_METRICS_REGISTRY_H_
+
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+
+#include "ac/non_copyable.h"
+
+#include "ac/report/metrics/metrics.h"
+
+namespace ac {
+namespace report {
+namespace metrics {
+
+// Registry keeps all metrics of the process by name. Registering a
+// metric takes a lock but updating it afterwards doesn't so the
+// streaming code paths only deal with the returned metric objects.
+class Registry : public ac::NonCopyable {
+public:
+    typedef std::shared_ptr<Registry> Ptr;
+    // Flat map of all values, see TakeSnapshot
+    typedef std::map<std::string, double> Snapshot;
+
+    static Ptr Create();
+    // The registry shared by all parts of the service which is exported
+    // on the bus.
+    static Ptr Instance();
+
+    // All of these return the already registered metric if there
+    // is one with the same name.
+    Counter::Ptr RegisterCounter(const std::string &name);
+    Gauge::Ptr RegisterGauge(const std::string &name);
+    Meter::Ptr RegisterMeter(const std::string &name);
+    Histogram::Ptr RegisterHistogram(const std::string &name);
+
+    // Counters and gauges are reported with their value, meters with
+    // their rate per second and histograms with <name>.count, .p50,
+    // .p90, .p99 and .max.
+    Snapshot TakeSnapshot() const;
+
+    // Sets all registered metrics back to zero
+    void Reset();
+
+private:
+    Registry();
+
+private:
+    mutable std::mutex mutex_;
+    std::map<std::string, Counter::Ptr> counters_;
+    std::map<std::string, Gauge::Ptr> gauges_;
+    std::map<std::string, Meter::Ptr> meters_;
+    std::map<std::string, Histogram::Ptr> histograms_;
+};
+
+} // namespace metrics
+} // namespace report
+} // namespace ac
+
+#endif
@@ -0,0 +1,59 @@
+/*
+ * Copyright (C) 2016 Canonical, Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 3, as published
+ * by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranties of
+ * MERCHANTABILITY, SATISFACTORY QUALITY, or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <boost/concept_check.hpp>
+
+#include "ac/report/metrics/rendererreport.h"
+
+namespace ac {
+namespace report {
+namespace metrics {
+
+RendererReport::RendererReport(const Registry::Ptr &registry, const FrameTimestamps::Ptr &captured) :
+    captured_(captured),
+    frames_(registry->RegisterCounter("renderer.frames")),
+    skipped_frames_(registry->RegisterCounter("renderer.skipped_frames")),
+    unchanged_frames_(registry->RegisterCounter("renderer.unchanged_frames")),
+    fps_(registry->RegisterMeter("renderer.fps")),
+    lateness_(registry->RegisterHistogram("renderer.lateness")) {
+}
+
+void RendererReport::BeganFrame() {
+}
+
+void RendererReport::FinishedFrame(const video::FrameNumber &frame, const ac::TimestampUs &timestamp) {
+    frames_->Increment();
+    fps_->Mark();
+    captured_->Set(frame, timestamp);
+}
+
+void RendererReport::UnchangedFrame(const ac::TimestampUs &timestamp) {
+    boost::ignore_unused_variable_warning(timestamp);
+    unchanged_frames_->Increment();
+}
+
+void RendererReport::SkippedFrames(const unsigned int &count) {
+    skipped_frames_->Increment(count);
+}
+
+void RendererReport::FrameLateness(const ac::TimestampUs &lateness) {
+    lateness_->Record(lateness);
+}
+
+} // namespace metrics
+} // namespace report
+} // namespace ac
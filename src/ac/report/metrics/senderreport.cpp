@@ -0,0 +1,69 @@
+/*
+ * Copyright (C) 2016 Canonical, Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 3, as published
+ * by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranties of
+ * MERCHANTABILITY, SATISFACTORY QUALITY, or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <boost/concept_check.hpp>
+
+#include "ac/report/metrics/senderreport.h"
+
+namespace ac {
+namespace report {
+namespace metrics {
+
+SenderReport::SenderReport(const Registry::Ptr &registry, const FrameTimestamps::Ptr &captured,
+                           const Gauge::Ptr &last_packetized_frame) :
+    captured_(captured),
+    last_packetized_frame_(last_packetized_frame),
+    last_frame_(0),
+    packets_(registry->RegisterCounter("sender.packets")),
+    bytes_(registry->RegisterCounter("sender.bytes")),
+    errors_(registry->RegisterCounter("sender.errors")),
+    bitrate_(registry->RegisterMeter("sender.bitrate")),
+    queue_depth_(registry->RegisterGauge("sender.queue_depth")),
+    latency_(registry->RegisterHistogram("latency.total")) {
+}
+
+void SenderReport::SentPacket(const video::FrameNumber &frame, const ac::TimestampUs &timestamp, const size_t &size) {
+    boost::ignore_unused_variable_warning(timestamp);
+
+    packets_->Increment();
+    bytes_->Increment(size);
+    bitrate_->Mark(size * 8);
+
+    if (frame == 0 || frame == last_frame_)
+        return;
+
+    // First datagram of a new frame is out
+    last_frame_ = frame;
+
+    ac::TimestampUs captured = 0;
+    if (captured_->Get(frame, &captured))
+        latency_->Record(ac::Utils::GetNowUs() - captured);
+
+    const auto packetized = last_packetized_frame_->Value();
+    queue_depth_->Set(packetized > static_cast<std::int64_t>(frame) ? packetized - frame : 0);
+}
+
+void SenderReport::FailedToSendPacket(const video::FrameNumber &frame, const ac::TimestampUs &timestamp) {
+    boost::ignore_unused_variable_warning(frame);
+    boost::ignore_unused_variable_warning(timestamp);
+
+    errors_->Increment();
+}
+
+} // namespace metrics
+} // namespace report
+} // namespace ac
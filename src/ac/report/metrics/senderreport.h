@@ -0,0 +1,54 @@
+/*
+ * Copyright (C) 2016 Canonical, Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 3, as published
+ * by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranties of
+ * MERCHANTABILITY, SATISFACTORY QUALITY, or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef AC_REPORT_METRICS_SENDERREPORT_H_
+#define AC_REPORT_METRICS_SENDERREPORT_H_
+
+#include "ac/video/senderreport.h"
+
+#include "ac/report/metrics/registry.h"
+#include "ac/report/metrics/frametimestamps.h"
+
+namespace ac {
+namespace report {
+namespace metrics {
+
+class SenderReport : public video::SenderReport {
+public:
+    SenderReport(const Registry::Ptr &registry, const FrameTimestamps::Ptr &captured,
+                 const Gauge::Ptr &last_packetized_frame);
+
+    void SentPacket(const video::FrameNumber &frame, const ac::TimestampUs &timestamp, const size_t &size);
+    void FailedToSendPacket(const video::FrameNumber &frame, const ac::TimestampUs &timestamp);
+
+private:
+    FrameTimestamps::Ptr captured_;
+    Gauge::Ptr last_packetized_frame_;
+    video::FrameNumber last_frame_;
+    Counter::Ptr packets_;
+    Counter::Ptr bytes_;
+    Counter::Ptr errors_;
+    Meter::Ptr bitrate_;
+    Gauge::Ptr queue_depth_;
+    Histogram::Ptr latency_;
+};
+
+} // namespace metrics
+} // namespace report
+} // namespace ac
+
+#endif
@@ -29,18 +29,27 @@ void EncoderReport::Started() {
 void EncoderReport::Stopped() {
 }
 
-void EncoderReport::BeganFrame(const ac::TimestampUs &timestamp) {
+void EncoderReport::BeganFrame(const video::FrameNumber &frame, const ac::TimestampUs &timestamp) {
+    boost::ignore_unused_variable_warning(frame);
     boost::ignore_unused_variable_warning(timestamp);
 }
 
-void EncoderReport::FinishedFrame(const ac::TimestampUs &timestamp) {
+void EncoderReport::FinishedFrame(const video::FrameNumber &frame, const ac::TimestampUs &timestamp) {
+    boost::ignore_unused_variable_warning(frame);
     boost::ignore_unused_variable_warning(timestamp);
 }
 
-void EncoderReport::ReceivedInputBuffer(const ac::TimestampUs &timestamp) {
+void EncoderReport::ReceivedInputBuffer(const video::FrameNumber &frame, const ac::TimestampUs &timestamp) {
+    boost::ignore_unused_variable_warning(frame);
     boost::ignore_unused_variable_warning(timestamp);
 }
 
+void EncoderReport::RequestedIDRFrame() {
+}
+
+void EncoderReport::EmittedIDRFrame() {
+}
+
 } // namespace null
 } // namespace report
 } // namespace ac
@@ -32,9 +32,11 @@ class EncoderReport : public video::EncoderReport {
 public:
     void Started();
     void Stopped();
-    void BeganFrame(const ac::TimestampUs &timestamp);
-    void FinishedFrame(const ac::TimestampUs &timestamp);
-    void ReceivedInputBuffer(const ac::TimestampUs &timestamp);
+    void BeganFrame(const video::FrameNumber &frame, const ac::TimestampUs &timestamp);
+    void FinishedFrame(const video::FrameNumber &frame, const ac::TimestampUs &timestamp);
+    void ReceivedInputBuffer(const video::FrameNumber &frame, const ac::TimestampUs &timestamp);
+    void RequestedIDRFrame();
+    void EmittedIDRFrame();
 };
 
 } // namespace null
@@ -23,7 +23,8 @@ namespace ac {
 namespace report {
 namespace null {
 
-void PacketizerReport::PacketizedFrame(const TimestampUs &timestamp) {
+void PacketizerReport::PacketizedFrame(const video::FrameNumber &frame, const TimestampUs &timestamp) {
+    boost::ignore_unused_variable_warning(frame);
     boost::ignore_unused_variable_warning(timestamp);
 }
 
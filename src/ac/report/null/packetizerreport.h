@@ -31,7 +31,7 @@ namespace null {
 
 class PacketizerReport : public video::PacketizerReport {
 public:
-     void PacketizedFrame(const ac::TimestampUs &timestamp);
+     void PacketizedFrame(const video::FrameNumber &frame, const ac::TimestampUs &timestamp);
 };
 
 } // namespace null
@@ -26,10 +26,23 @@ namespace null {
 void RendererReport::BeganFrame() {
 }
 
-void RendererReport::FinishedFrame(const TimestampUs &timestamp) {
+void RendererReport::FinishedFrame(const video::FrameNumber &frame, const TimestampUs &timestamp) {
+    boost::ignore_unused_variable_warning(frame);
     boost::ignore_unused_variable_warning(timestamp);
 }
 
+void RendererReport::UnchangedFrame(const TimestampUs &timestamp) {
+    boost::ignore_unused_variable_warning(timestamp);
+}
+
+void RendererReport::SkippedFrames(const unsigned int &count) {
+    boost::ignore_unused_variable_warning(count);
+}
+
+void RendererReport::FrameLateness(const TimestampUs &lateness) {
+    boost::ignore_unused_variable_warning(lateness);
+}
+
 } // namespace null
 } // namespace report
 } // namespace ac
@@ -32,7 +32,10 @@ namespace null {
 class RendererReport : public video::RendererReport {
 public:
      void BeganFrame();
-     void FinishedFrame(const ac::TimestampUs &timestamp);
+     void FinishedFrame(const video::FrameNumber &frame, const ac::TimestampUs &timestamp);
+     void UnchangedFrame(const ac::TimestampUs &timestamp);
+     void SkippedFrames(const unsigned int &count);
+     void FrameLateness(const ac::TimestampUs &lateness);
 };
 
 } // namespace null
@@ -25,11 +25,17 @@ namespace ac {
 namespace report {
 namespace null {
 
-void SenderReport::SentPacket(const TimestampUs &timestamp, const size_t &size) {
+void SenderReport::SentPacket(const video::FrameNumber &frame, const TimestampUs &timestamp, const size_t &size) {
+    boost::ignore_unused_variable_warning(frame);
     boost::ignore_unused_variable_warning(timestamp);
     boost::ignore_unused_variable_warning(size);
 }
 
+void SenderReport::FailedToSendPacket(const video::FrameNumber &frame, const ac::TimestampUs &timestamp) {
+    boost::ignore_unused_variable_warning(frame);
+    boost::ignore_unused_variable_warning(timestamp);
+}
+
 } // namespace null
 } // namespace report
 } // namespace ac
@@ -0,0 +1,79 @@
+/*
+ * Copyright (C) 2016 Canonical, Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 3, as published
+ * by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranties of
+ * MERCHANTABILITY, SATISFACTORY QUALITY, or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <boost/concept_check.hpp>
+
+#include "ac/report/recorder/encoderreport.h"
+
+namespace ac {
+namespace report {
+namespace recorder {
+
+EncoderReport::EncoderReport(const FlightRecorder::Ptr &recorder) :
+    recorder_(recorder),
+    last_received_(0),
+    last_finished_(0) {
+}
+
+void EncoderReport::Started() {
+    recorder_->Record(FlightRecorder::EventType::kEncoderStarted);
+}
+
+void EncoderReport::Stopped() {
+    recorder_->Record(FlightRecorder::EventType::kEncoderStopped);
+}
+
+void EncoderReport::BeganFrame(const video::FrameNumber &frame, const ac::TimestampUs &timestamp) {
+    boost::ignore_unused_variable_warning(timestamp);
+    recorder_->Record(FlightRecorder::EventType::kEncoderBeganFrame, frame, QueueDepth());
+}
+
+void EncoderReport::FinishedFrame(const video::FrameNumber &frame, const ac::TimestampUs &timestamp) {
+    boost::ignore_unused_variable_warning(timestamp);
+
+    if (frame > 0)
+        last_finished_.store(frame);
+
+    recorder_->Record(FlightRecorder::EventType::kEncoderFinishedFrame, frame, QueueDepth());
+}
+
+void EncoderReport::ReceivedInputBuffer(const video::FrameNumber &frame, const ac::TimestampUs &timestamp) {
+    boost::ignore_unused_variable_warning(timestamp);
+
+    if (frame > 0)
+        last_received_.store(frame);
+
+    recorder_->Record(FlightRecorder::EventType::kEncoderReceivedInputBuffer, frame, QueueDepth());
+}
+
+void EncoderReport::RequestedIDRFrame() {
+    recorder_->Record(FlightRecorder::EventType::kEncoderRequestedIDRFrame, last_received_.load());
+}
+
+void EncoderReport::EmittedIDRFrame() {
+    recorder_->Record(FlightRecorder::EventType::kEncoderEmittedIDRFrame, last_received_.load());
+}
+
+std::uint32_t EncoderReport::QueueDepth() const {
+    const auto received = last_received_.load();
+    const auto finished = last_finished_.load();
+    return received > finished ? received - finished : 0;
+}
+
+} // namespace recorder
+} // namespace report
+} // namespace ac
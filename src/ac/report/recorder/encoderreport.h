@@ -0,0 +1,56 @@
+/*
+ * Copyright (C) 2016 Canonical, Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 3, as published
+ * by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranties of
+ * MERCHANTABILITY, SATISFACTORY QUALITY, or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef AC_REPORT_RECORDER_ENCODERREPORT_H_
+#define AC_REPORT_RECORDER_ENCODERREPORT_H_
+
+#include <atomic>
+
+#include "ac/video/encoderreport.h"
+
+#include "ac/report/recorder/flightrecorder.h"
+
+namespace ac {
+namespace report {
+namespace recorder {
+
+class EncoderReport : public video::EncoderReport {
+public:
+    explicit EncoderReport(const FlightRecorder::Ptr &recorder);
+
+    void Started();
+    void Stopped();
+    void BeganFrame(const video::FrameNumber &frame, const ac::TimestampUs &timestamp);
+    void FinishedFrame(const video::FrameNumber &frame, const ac::TimestampUs &timestamp);
+    void ReceivedInputBuffer(const video::FrameNumber &frame, const ac::TimestampUs &timestamp);
+    void RequestedIDRFrame();
+    void EmittedIDRFrame();
+
+private:
+    std::uint32_t QueueDepth() const;
+
+private:
+    FlightRecorder::Ptr recorder_;
+    std::atomic<video::FrameNumber> last_received_;
+    std::atomic<video::FrameNumber> last_finished_;
+};
+
+} // namespace recorder
+} // namespace report
+} // namespace ac
+
+#endif
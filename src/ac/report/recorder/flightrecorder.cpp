@@ -0,0 +1,251 @@
+/*
+ * Copyright (C) 2016 Canonical, Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 3, as published
+ * by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranties of
+ * MERCHANTABILITY, SATISFACTORY QUALITY, or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <fcntl.h>
+#include <stdio.h>
+#include <sys/mman.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstring>
+#include <new>
+
+#include <boost/filesystem.hpp>
+
+#include "ac/config.h"
+#include "ac/logger.h"
+#include "ac/utils.h"
+
+#include "ac/report/recorder/flightrecorder.h"
+
+namespace {
+constexpr const char *kRecordingFileName{"flightrecorder"};
+
+// A recording left behind is most likely the one of a crashed service
+// so we keep it around for one more start.
+void KeepPreviousRecording(const std::string &path) {
+    const auto previous_path = path + ac::report::recorder::FlightRecorder::kPreviousRecordingSuffix;
+
+    if (::rename(path.c_str(), previous_path.c_str()) < 0 && errno != ENOENT)
+        AC_WARNING("Failed to keep previous flight recording %s: %s", path, ::strerror(errno));
+}
+}
+
+namespace ac {
+namespace report {
+namespace recorder {
+
+static_assert(sizeof(FlightRecorder::Header) == 24, "Header layout is part of the file format");
+static_assert(sizeof(FlightRecorder::Event) == 24, "Event layout is part of the file format");
+static_assert(sizeof(FlightRecorder::Slot) == 32, "Slot layout is part of the file format");
+
+constexpr std::uint32_t FlightRecorder::kMagic;
+constexpr std::uint32_t FlightRecorder::kVersion;
+constexpr std::uint32_t FlightRecorder::kDefaultCapacity;
+constexpr const char *FlightRecorder::kPreviousRecordingSuffix;
+
+FlightRecorder::Ptr FlightRecorder::Create(std::uint32_t capacity, const std::string &path) {
+    if (capacity == 0)
+        return nullptr;
+
+    const auto size = sizeof(Header) + capacity * sizeof(Slot);
+
+    void *mapping = MAP_FAILED;
+
+    if (path.length() > 0) {
+        KeepPreviousRecording(path);
+
+        const auto fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0600);
+        if (fd < 0) {
+            AC_ERROR("Failed to open flight recorder file %s: %s", path, ::strerror(errno));
+            return nullptr;
+        }
+
+        if (::ftruncate(fd, size) == 0)
+            mapping = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+
+        // The mapping keeps its own reference to the file
+        ::close(fd);
+    } else {
+        mapping = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    }
+
+    if (mapping == MAP_FAILED) {
+        AC_ERROR("Failed to map flight recorder: %s", ::strerror(errno));
+        return nullptr;
+    }
+
+    ::memset(mapping, 0, size);
+
+    auto header = new (mapping) Header;
+    header->magic = kMagic;
+    header->version = kVersion;
+    header->event_size = sizeof(Slot);
+    header->capacity = capacity;
+    header->next.store(0);
+
+    return Ptr(new FlightRecorder(mapping, size));
+}
+
+FlightRecorder::Ptr FlightRecorder::Instance() {
+    static const auto instance = []() {
+        std::uint32_t capacity = kDefaultCapacity;
+        const auto value = ac::Utils::GetEnvValue("AETHERCAST_FLIGHT_RECORDER_EVENTS");
+        if (value.length() > 0) {
+            try {
+                capacity = std::stoul(value);
+            } catch (...) {
+                AC_WARNING("Invalid number of flight recorder events '%s'", value);
+            }
+        }
+
+        auto path = ac::Utils::GetEnvValue("AETHERCAST_FLIGHT_RECORDER_FILE");
+        if (path.length() == 0 && boost::filesystem::is_directory(ac::kRuntimePath))
+            path = (boost::filesystem::path(ac::kRuntimePath) / kRecordingFileName).string();
+
+        auto recorder = Create(capacity, path);
+        // Better record into memory only than not at all
+        if (!recorder && path.length() > 0)
+            recorder = Create(capacity);
+
+        return recorder;
+    }();
+
+    return instance;
+}
+
+FlightRecorder::FlightRecorder(void *mapping, std::size_t size) :
+    mapping_(mapping),
+    size_(size) {
+}
+
+FlightRecorder::~FlightRecorder() {
+    MutableHeader()->~Header();
+    ::munmap(mapping_, size_);
+}
+
+FlightRecorder::Header* FlightRecorder::MutableHeader() const {
+    return static_cast<Header*>(mapping_);
+}
+
+FlightRecorder::Slot* FlightRecorder::MutableSlots() const {
+    return reinterpret_cast<Slot*>(static_cast<std::uint8_t*>(mapping_) + sizeof(Header));
+}
+
+void FlightRecorder::Record(EventType type, const video::FrameNumber &frame, std::uint32_t value) {
+    const auto header = MutableHeader();
+    const auto n = header->next.fetch_add(1, std::memory_order_relaxed);
+
+    auto &slot = MutableSlots()[n % header->capacity];
+
+    // Readers must see the slot as incomplete before any of the
+    // fields of the event it held before change.
+    slot.sequence.store(0, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    slot.event.time = ac::Utils::GetNowUs();
+    slot.event.frame = frame;
+    slot.event.value = value;
+    slot.event.type = type;
+
+    slot.sequence.store(n + 1, std::memory_order_release);
+}
+
+bool FlightRecorder::Dump(const std::string &path) const {
+    const auto fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0600);
+    if (fd < 0) {
+        AC_ERROR("Failed to open %s for the flight recording: %s", path, ::strerror(errno));
+        return false;
+    }
+
+    // Events recorded while we write are not consistent with the
+    // header but as we care about what led up to a problem that
+    // doesn't matter much.
+    auto data = static_cast<const std::uint8_t*>(mapping_);
+    std::size_t written = 0;
+    while (written < size_) {
+        const auto ret = ::write(fd, data + written, size_ - written);
+        if (ret < 0) {
+            if (errno == EINTR)
+                continue;
+
+            AC_ERROR("Failed to write flight recording to %s: %s", path, ::strerror(errno));
+            ::close(fd);
+            return false;
+        }
+        written += ret;
+    }
+
+    ::close(fd);
+
+    AC_INFO("Wrote flight recording to %s", path);
+
+    return true;
+}
+
+std::string FlightRecorder::DumpToDirectory(const std::string &directory) const {
+    const auto now = ::time(nullptr);
+    struct tm tm;
+    localtime_r(&now, &tm);
+    char formatted_time[20];
+    strftime(formatted_time, sizeof(formatted_time), "%Y%m%d-%H%M%S", &tm);
+
+    const auto path = (boost::filesystem::path(directory) /
+                       ac::Utils::Sprintf("flight-recording-%s.bin", formatted_time)).string();
+
+    if (!Dump(path))
+        return "";
+
+    return path;
+}
+
+std::vector<FlightRecorder::Event> FlightRecorder::Events() const {
+    const auto header = MutableHeader();
+    const auto slots = MutableSlots();
+    const auto next = header->next.load();
+
+    std::vector<Event> result;
+
+    std::uint64_t n = next > header->capacity ? next - header->capacity : 0;
+    for (; n < next; n++) {
+        const auto &slot = slots[n % header->capacity];
+
+        // Still being written or already overwritten by a newer event
+        if (slot.sequence.load(std::memory_order_acquire) != n + 1)
+            continue;
+
+        const Event event = slot.event;
+
+        // A writer could have started on the slot while we copied it
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (slot.sequence.load(std::memory_order_relaxed) != n + 1)
+            continue;
+
+        result.push_back(event);
+    }
+
+    return result;
+}
+
+std::uint32_t FlightRecorder::Capacity() const {
+    return MutableHeader()->capacity;
+}
+
+} // namespace recorder
+} // namespace report
+} // namespace ac
@@ -0,0 +1,153 @@
+/*
+ * Copyright (C) 2016 Canonical, Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 3, as published
+ * by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranties of
+ * MERCHANTABILITY, SATISFACTORY QUALITY, or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef AC_REPORT_RECORDER_FLIGHTRECORDER_H_
+#define AC_REPORT_RECORDER_FLIGHTRECORDER_H_
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "ac/non_copyable.h"
+
+#include "ac/video/buffer.h"
+
+namespace ac {
+namespace report {
+namespace recorder {
+
+// FlightRecorder keeps the last events of the streaming pipeline in a
+// fixed size ring of compact binary records. It is cheap enough to be
+// always on so when something went wrong the events leading up to it
+// can be dumped and turned into a timeline with
+// scripts/decode-flight-recording.py.
+//
+// The ring lives in a memory mapping. If that is backed by a file the
+// events even survive a crash of the service. Dumps and the mapped file
+// share the same layout: a Header followed by Header::capacity slots.
+// Slots are written without any locking so every reader has to check
+// their sequence to drop the ones which were torn.
+class FlightRecorder : public ac::NonCopyable {
+public:
+    typedef std::shared_ptr<FlightRecorder> Ptr;
+
+    // "ACFR" in little endian
+    static constexpr std::uint32_t kMagic{0x52464341};
+    static constexpr std::uint32_t kVersion{2};
+    // At 60 fps the pipeline produces roughly 800 events per second
+    // which makes this last about 40 seconds.
+    static constexpr std::uint32_t kDefaultCapacity{32768};
+    // Appended to the path of the file the previous recording is kept in
+    static constexpr const char *kPreviousRecordingSuffix{".prev"};
+
+    enum class EventType : std::uint16_t {
+        kNone = 0,
+        kRendererBeganFrame,
+        kRendererFinishedFrame,
+        kRendererSkippedFrames,
+        kEncoderStarted,
+        kEncoderStopped,
+        kEncoderReceivedInputBuffer,
+        kEncoderBeganFrame,
+        kEncoderFinishedFrame,
+        kEncoderRequestedIDRFrame,
+        kPacketizerPacketizedFrame,
+        kSenderSentPacket,
+        kSenderFailedToSendPacket,
+        // Value is a timeline::ConnectionTimeline::Phase
+        kConnectionPhase,
+        kEncoderEmittedIDRFrame,
+        kRendererUnchangedFrame,
+    };
+
+    struct Header {
+        std::uint32_t magic;
+        std::uint32_t version;
+        // Size of a Slot
+        std::uint32_t event_size;
+        std::uint32_t capacity;
+        // Number of events ever recorded, the next one goes into the
+        // slot next % capacity.
+        std::atomic<std::uint64_t> next;
+    };
+
+    struct Event {
+        // Monotonic time in micro-seconds
+        std::uint64_t time;
+        std::uint64_t frame;
+        // Depends on the type: the queue depth for encoder events, the
+        // size for sent packets, the count of skipped frames and the
+        // phase for connection events.
+        std::uint32_t value;
+        EventType type;
+        std::uint16_t reserved;
+    };
+
+    struct Slot {
+        // Number of the event in the slot plus one. It is written last
+        // and is zero while the event is being written. A slot with any
+        // other sequence than the one of the event a reader expects
+        // there is incomplete or was overwritten already.
+        std::atomic<std::uint64_t> sequence;
+        Event event;
+    };
+
+    // Maps the ring into memory backed by the file at path or by
+    // anonymous memory if path is empty. An existing file is moved to
+    // <path>.prev first. Returns nullptr on failure.
+    static Ptr Create(std::uint32_t capacity = kDefaultCapacity, const std::string &path = "");
+    // The recorder of the service. Its size is configured through
+    // AETHERCAST_FLIGHT_RECORDER_EVENTS where zero disables it and the
+    // instance is nullptr. It is backed by the file in
+    // AETHERCAST_FLIGHT_RECORDER_FILE or in the runtime directory if
+    // that exists.
+    static Ptr Instance();
+
+    ~FlightRecorder();
+
+    // Safe to be called from any thread, never blocks.
+    void Record(EventType type, const video::FrameNumber &frame = 0, std::uint32_t value = 0);
+
+    // Writes the current state of the ring to path
+    bool Dump(const std::string &path) const;
+    // Dumps into a new timestamped file in directory and returns its
+    // path or an empty string on failure.
+    std::string DumpToDirectory(const std::string &directory) const;
+
+    // All completely recorded events still in the ring, oldest first
+    std::vector<Event> Events() const;
+
+    std::uint32_t Capacity() const;
+
+private:
+    FlightRecorder(void *mapping, std::size_t size);
+
+    Header* MutableHeader() const;
+    Slot* MutableSlots() const;
+
+private:
+    void *mapping_;
+    std::size_t size_;
+};
+
+} // namespace recorder
+} // namespace report
+} // namespace ac
+
+#endif
@@ -0,0 +1,48 @@
+/*
+ * Copyright (C) 2016 Canonical, Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 3, as published
+ * by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranties of
+ * MERCHANTABILITY, SATISFACTORY QUALITY, or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "ac/report/recorder/recorderreportfactory.h"
+#include "ac/report/recorder/encoderreport.h"
+#include "ac/report/recorder/rendererreport.h"
+#include "ac/report/recorder/packetizerreport.h"
+#include "ac/report/recorder/senderreport.h"
+
+namespace ac {
+namespace report {
+
+RecorderReportFactory::RecorderReportFactory(const recorder::FlightRecorder::Ptr &recorder) :
+    recorder_(recorder) {
+}
+
+std::shared_ptr<video::EncoderReport> RecorderReportFactory::CreateEncoderReport() {
+    return std::make_shared<recorder::EncoderReport>(recorder_);
+}
+
+std::shared_ptr<video::RendererReport> RecorderReportFactory::CreateRendererReport() {
+    return std::make_shared<recorder::RendererReport>(recorder_);
+}
+
+std::shared_ptr<video::PacketizerReport> RecorderReportFactory::CreatePacketizerReport() {
+    return std::make_shared<recorder::PacketizerReport>(recorder_);
+}
+
+std::shared_ptr<video::SenderReport> RecorderReportFactory::CreateSenderReport() {
+    return std::make_shared<recorder::SenderReport>(recorder_);
+}
+
+} // namespace report
+} // namespace ac
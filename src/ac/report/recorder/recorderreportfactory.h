@@ -0,0 +1,48 @@
+/*
+ * Copyright (C) 2016 Canonical, Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 3, as published
+ * by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranties of
+ * MERCHANTABILITY, SATISFACTORY QUALITY, or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef AC_REPORT_RECORDERREPORTFACTORY_H_
+#define AC_REPORT_RECORDERREPORTFACTORY_H_
+
+#include <memory>
+
+#include "ac/report/reportfactory.h"
+#include "ac/report/recorder/flightrecorder.h"
+
+namespace ac {
+namespace report {
+
+// Creates reports which put all events into a flight recorder. The
+// report factory adds this to whatever else is configured as long as
+// the recorder of the service is enabled.
+class RecorderReportFactory : public ReportFactory {
+public:
+    explicit RecorderReportFactory(const recorder::FlightRecorder::Ptr &recorder = recorder::FlightRecorder::Instance());
+
+    std::shared_ptr<video::EncoderReport> CreateEncoderReport();
+    std::shared_ptr<video::RendererReport> CreateRendererReport();
+    std::shared_ptr<video::PacketizerReport> CreatePacketizerReport();
+    std::shared_ptr<video::SenderReport> CreateSenderReport();
+
+private:
+    recorder::FlightRecorder::Ptr recorder_;
+};
+
+} // namespace report
+} // namespace ac
+
+#endif
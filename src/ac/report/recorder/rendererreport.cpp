@@ -0,0 +1,54 @@
+/*
+ * Copyright (C) 2016 Canonical, Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 3, as published
+ * by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranties of
+ * MERCHANTABILITY, SATISFACTORY QUALITY, or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <boost/concept_check.hpp>
+
+#include "ac/report/recorder/rendererreport.h"
+
+namespace ac {
+namespace report {
+namespace recorder {
+
+RendererReport::RendererReport(const FlightRecorder::Ptr &recorder) :
+    recorder_(recorder) {
+}
+
+void RendererReport::BeganFrame() {
+    recorder_->Record(FlightRecorder::EventType::kRendererBeganFrame);
+}
+
+void RendererReport::FinishedFrame(const video::FrameNumber &frame, const ac::TimestampUs &timestamp) {
+    boost::ignore_unused_variable_warning(timestamp);
+    recorder_->Record(FlightRecorder::EventType::kRendererFinishedFrame, frame);
+}
+
+void RendererReport::UnchangedFrame(const ac::TimestampUs &timestamp) {
+    boost::ignore_unused_variable_warning(timestamp);
+    recorder_->Record(FlightRecorder::EventType::kRendererUnchangedFrame);
+}
+
+void RendererReport::SkippedFrames(const unsigned int &count) {
+    recorder_->Record(FlightRecorder::EventType::kRendererSkippedFrames, 0, count);
+}
+
+void RendererReport::FrameLateness(const ac::TimestampUs &lateness) {
+    boost::ignore_unused_variable_warning(lateness);
+}
+
+} // namespace recorder
+} // namespace report
+} // namespace ac
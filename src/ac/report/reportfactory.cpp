@@ -15,25 +15,79 @@
  *
  */
 
+#include <algorithm>
+#include <vector>
+
+#include "ac/logger.h"
 #include "ac/utils.h"
 
 #include "ac/report/reportfactory.h"
 #include "ac/report/null/nullreportfactory.h"
 #include "ac/report/logging/loggingreportfactory.h"
 #include "ac/report/lttng/lttngreportfactory.h"
+#include "ac/report/latency/latencyreportfactory.h"
+#include "ac/report/metrics/metricsreportfactory.h"
+#include "ac/report/composite/compositereportfactory.h"
+#include "ac/report/recorder/recorderreportfactory.h"
+#include "ac/report/timeline/timelinereportfactory.h"
 
 namespace ac {
 namespace report {
 
-ReportFactory::Ptr ReportFactory::Create() {
-    std::string type = ac::Utils::GetEnvValue("AETHERCAST_REPORT_TYPE");
-
+ReportFactory::Ptr ReportFactory::CreateForType(const std::string &type) {
     if (type == "log")
         return std::make_shared<LoggingReportFactory>();
     else if (type == "lttng")
         return std::make_shared<LttngReportFactory>();
+    else if (type == "latency")
+        return std::make_shared<LatencyReportFactory>();
+    else if (type == "metrics")
+        return std::make_shared<MetricsReportFactory>();
+
+    return nullptr;
+}
+
+ReportFactory::Ptr ReportFactory::Create() {
+    // Several types can be combined like "metrics,lttng"
+    const auto types = ac::Utils::StringSplit(ac::Utils::GetEnvValue("AETHERCAST_REPORT_TYPE"), ',');
+
+    std::vector<std::string> created_types;
+    std::vector<ReportFactory::Ptr> factories;
+
+    for (const auto &type : types) {
+        if (type.length() == 0 ||
+            std::find(created_types.begin(), created_types.end(), type) != created_types.end())
+            continue;
+
+        const auto factory = CreateForType(type);
+        if (!factory) {
+            AC_WARNING("Ignoring unknown report type '%s'", type.c_str());
+            continue;
+        }
+
+        created_types.push_back(type);
+        factories.push_back(factory);
+    }
+
+    // The flight recorder is always on so that there is something to
+    // look at when a problem was reported.
+    if (const auto recorder = recorder::FlightRecorder::Instance())
+        factories.push_back(std::make_shared<RecorderReportFactory>(recorder));
+
+    // Same for the connection timeline which only needs the first
+    // frames of a connection.
+    if (const auto timeline = timeline::ConnectionTimeline::Instance())
+        factories.push_back(std::make_shared<TimelineReportFactory>(timeline));
+
+    if (factories.size() == 0)
+        return std::make_shared<NullReportFactory>();
+
+    // Hand out a single backend directly so its reports are called
+    // without going through the fan out.
+    if (factories.size() == 1)
+        return factories.front();
 
-    return std::make_shared<NullReportFactory>();
+    return std::make_shared<CompositeReportFactory>(factories);
 }
 
 } // namespace report
@@ -19,6 +19,7 @@
 #define AC_REPORT_REPORTFACTORY_H_
 
 #include <memory>
+#include <string>
 
 #include "ac/non_copyable.h"
 
@@ -34,7 +35,12 @@ class ReportFactory : public ac::NonCopyable {
 public:
     typedef std::shared_ptr<ReportFactory> Ptr;
 
+    // Creates the report backends selected through the comma separated
+    // list in AETHERCAST_REPORT_TYPE. The flight recorder and the
+    // connection timeline are always added unless they are disabled.
     static Ptr Create();
+    // Returns nullptr for unknown types
+    static Ptr CreateForType(const std::string &type);
 
     virtual video::EncoderReport::Ptr CreateEncoderReport() = 0;
     virtual video::RendererReport::Ptr CreateRendererReport() = 0;
@@ -0,0 +1,189 @@
+/*
+ * Copyright (C) 2016 Canonical, Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 3, as published
+ * by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranties of
+ * MERCHANTABILITY, SATISFACTORY QUALITY, or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <algorithm>
+#include <sstream>
+
+#include "ac/logger.h"
+#include "ac/utils.h"
+
+#include "ac/report/timeline/connectiontimeline.h"
+
+namespace ac {
+namespace report {
+namespace timeline {
+
+constexpr std::size_t ConnectionTimeline::kNumPhases;
+
+std::string ConnectionTimeline::PhaseToString(Phase phase) {
+    switch (phase) {
+    case Phase::kConnectRequested:
+        return "connect-requested";
+    case Phase::kGroupNegotiated:
+        return "group-negotiated";
+    case Phase::kGroupStarted:
+        return "group-started";
+    case Phase::kAddressAssigned:
+        return "address-assigned";
+    case Phase::kSinkConnected:
+        return "sink-connected";
+    case Phase::kPlayRequested:
+        return "play-requested";
+    case Phase::kPipelineStarted:
+        return "pipeline-started";
+    case Phase::kFirstFrameRendered:
+        return "first-frame-rendered";
+    case Phase::kFirstFrameEncoded:
+        return "first-frame-encoded";
+    case Phase::kFirstPacketSent:
+        return "first-packet-sent";
+    default:
+        break;
+    }
+    return "unknown";
+}
+
+ConnectionTimeline::Ptr ConnectionTimeline::Create(const Clock &clock, const recorder::FlightRecorder::Ptr &recorder) {
+    if (!clock)
+        return nullptr;
+
+    return Ptr(new ConnectionTimeline(clock, recorder));
+}
+
+ConnectionTimeline::Ptr ConnectionTimeline::Instance() {
+    static const auto instance = []() -> Ptr {
+        if (ac::Utils::GetEnvValue("AETHERCAST_CONNECTION_TIMELINE") == "0")
+            return nullptr;
+
+        return Create(&ac::Utils::GetNowUs, recorder::FlightRecorder::Instance());
+    }();
+
+    return instance;
+}
+
+ConnectionTimeline::ConnectionTimeline(const Clock &clock, const recorder::FlightRecorder::Ptr &recorder) :
+    clock_(clock),
+    recorder_(recorder) {
+    for (auto &stamp : stamps_)
+        stamp.store(0);
+}
+
+void ConnectionTimeline::Start() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+
+        for (auto &stamp : stamps_)
+            stamp.store(0);
+
+        stamps_[static_cast<std::size_t>(Phase::kConnectRequested)].store(clock_());
+    }
+
+    if (recorder_)
+        recorder_->Record(recorder::FlightRecorder::EventType::kConnectionPhase, 0,
+                          static_cast<std::uint32_t>(Phase::kConnectRequested));
+}
+
+void ConnectionTimeline::Mark(Phase phase) {
+    const auto index = static_cast<std::size_t>(phase);
+    if (index >= kNumPhases)
+        return;
+
+    // The pipeline calls this for every frame so avoid the lock once
+    // the phase was stamped.
+    if (stamps_[index].load() != 0)
+        return;
+
+    std::vector<Entry> breakdown;
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+
+        if (stamps_[index].load() != 0 ||
+            stamps_[static_cast<std::size_t>(Phase::kConnectRequested)].load() == 0)
+            return;
+
+        stamps_[index].store(clock_());
+
+        if (phase == Phase::kFirstPacketSent)
+            breakdown = BreakdownLocked();
+    }
+
+    if (recorder_)
+        recorder_->Record(recorder::FlightRecorder::EventType::kConnectionPhase, 0,
+                          static_cast<std::uint32_t>(phase));
+
+    if (breakdown.size() == 0)
+        return;
+
+    std::stringstream phases;
+    for (const auto &entry : breakdown) {
+        if (entry.phase == Phase::kConnectRequested)
+            continue;
+        phases << " " << PhaseToString(entry.phase) << " +" << entry.since_previous / 1000 << "ms";
+    }
+
+    AC_INFO("First packet sent %d ms after connect:%s",
+            breakdown.back().since_start / 1000, phases.str());
+}
+
+bool ConnectionTimeline::Reached(Phase phase) const {
+    const auto index = static_cast<std::size_t>(phase);
+    if (index >= kNumPhases)
+        return false;
+
+    return stamps_[index].load() != 0;
+}
+
+std::vector<ConnectionTimeline::Entry> ConnectionTimeline::Breakdown() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return BreakdownLocked();
+}
+
+std::vector<ConnectionTimeline::Entry> ConnectionTimeline::BreakdownLocked() const {
+    std::vector<Entry> entries;
+
+    const auto start = stamps_[static_cast<std::size_t>(Phase::kConnectRequested)].load();
+    if (start == 0)
+        return entries;
+
+    std::vector<std::pair<std::uint64_t, Phase>> reached;
+    for (std::size_t n = 0; n < kNumPhases; n++) {
+        const auto stamp = stamps_[n].load();
+        if (stamp != 0)
+            reached.push_back(std::make_pair(stamp, static_cast<Phase>(n)));
+    }
+
+    // Phases normally follow their declaration order but the sink can
+    // for example ask to play before the pipeline reported anything.
+    std::stable_sort(reached.begin(), reached.end(),
+                     [](const std::pair<std::uint64_t, Phase> &lhs, const std::pair<std::uint64_t, Phase> &rhs) {
+        return lhs.first < rhs.first;
+    });
+
+    auto previous = start;
+    for (const auto &r : reached) {
+        const auto stamp = std::max(r.first, start);
+        entries.push_back(Entry{r.second, stamp - start, stamp - previous});
+        previous = stamp;
+    }
+
+    return entries;
+}
+
+} // namespace timeline
+} // namespace report
+} // namespace ac
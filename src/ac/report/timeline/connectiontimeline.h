@@ -0,0 +1,114 @@
+/*
+ * Copyright (C) 2016 Canonical, Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 3, as published
+ * by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranties of
+ * MERCHANTABILITY, SATISFACTORY QUALITY, or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef AC_REPORT_TIMELINE_CONNECTIONTIMELINE_H_
+#define AC_REPORT_TIMELINE_CONNECTIONTIMELINE_H_
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "ac/non_copyable.h"
+
+#include "ac/report/recorder/flightrecorder.h"
+
+namespace ac {
+namespace report {
+namespace timeline {
+
+// ConnectionTimeline stamps the phases a connection goes through from
+// the user asking to connect until the first packet of the stream left
+// the device. Each phase is only stamped once per connection attempt so
+// the pipeline can report its first frames without keeping track of
+// that itself.
+//
+// The phases are reached by different parts of the service: the network
+// manager for the P2P group and the address, the source for the RTSP
+// session and the pipeline through the reports of the timeline backend.
+class ConnectionTimeline : public ac::NonCopyable {
+public:
+    typedef std::shared_ptr<ConnectionTimeline> Ptr;
+    // Returns a monotonic time in micro-seconds
+    typedef std::function<std::uint64_t()> Clock;
+
+    enum class Phase : std::uint8_t {
+        kConnectRequested = 0,
+        kGroupNegotiated,
+        kGroupStarted,
+        kAddressAssigned,
+        kSinkConnected,
+        kPlayRequested,
+        kPipelineStarted,
+        kFirstFrameRendered,
+        kFirstFrameEncoded,
+        kFirstPacketSent,
+    };
+
+    static constexpr std::size_t kNumPhases{10};
+
+    struct Entry {
+        Phase phase;
+        // Micro-seconds since the connect was requested
+        std::uint64_t since_start;
+        // Micro-seconds since the phase reached before this one
+        std::uint64_t since_previous;
+    };
+
+    static std::string PhaseToString(Phase phase);
+
+    // Phase transitions are also put into recorder if one is given so
+    // they show up in the dumps next to the pipeline events.
+    static Ptr Create(const Clock &clock, const recorder::FlightRecorder::Ptr &recorder = nullptr);
+    // The timeline of the service. Setting AETHERCAST_CONNECTION_TIMELINE
+    // to 0 disables it and the instance is nullptr.
+    static Ptr Instance();
+
+    // Begins a new connection attempt and forgets about the last one.
+    void Start();
+    // Stamps phase if it wasn't reached yet during the current attempt.
+    // Nothing is stamped before Start was called. Safe to be called from
+    // any thread and cheap once the phase was reached.
+    void Mark(Phase phase);
+
+    bool Reached(Phase phase) const;
+    // All phases reached during the current attempt in the order they
+    // were reached.
+    std::vector<Entry> Breakdown() const;
+
+private:
+    ConnectionTimeline(const Clock &clock, const recorder::FlightRecorder::Ptr &recorder);
+
+    std::vector<Entry> BreakdownLocked() const;
+
+private:
+    Clock clock_;
+    recorder::FlightRecorder::Ptr recorder_;
+    mutable std::mutex mutex_;
+    // Zero marks a phase which wasn't reached yet
+    std::array<std::atomic<std::uint64_t>, kNumPhases> stamps_;
+};
+
+} // namespace timeline
+} // namespace report
+} // namespace ac
+
+#endif
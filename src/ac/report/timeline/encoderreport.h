@@ -0,0 +1,49 @@
+/*
+ * Copyright (C) 2016 Canonical, Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 3, as published
+ * by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranties of
+ * MERCHANTABILITY, SATISFACTORY QUALITY, or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef AC_REPORT_TIMELINE_ENCODERREPORT_H_
+#define AC_REPORT_TIMELINE_ENCODERREPORT_H_
+
+#include "ac/video/encoderreport.h"
+
+#include "ac/report/timeline/connectiontimeline.h"
+
+namespace ac {
+namespace report {
+namespace timeline {
+
+class EncoderReport : public video::EncoderReport {
+public:
+    explicit EncoderReport(const ConnectionTimeline::Ptr &timeline);
+
+    void Started();
+    void Stopped();
+    void BeganFrame(const video::FrameNumber &frame, const ac::TimestampUs &timestamp);
+    void FinishedFrame(const video::FrameNumber &frame, const ac::TimestampUs &timestamp);
+    void ReceivedInputBuffer(const video::FrameNumber &frame, const ac::TimestampUs &timestamp);
+    void RequestedIDRFrame();
+    void EmittedIDRFrame();
+
+private:
+    ConnectionTimeline::Ptr timeline_;
+};
+
+} // namespace timeline
+} // namespace report
+} // namespace ac
+
+#endif
@@ -0,0 +1,49 @@
+/*
+ * Copyright (C) 2016 Canonical, Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 3, as published
+ * by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranties of
+ * MERCHANTABILITY, SATISFACTORY QUALITY, or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "ac/report/null/packetizerreport.h"
+
+#include "ac/report/timeline/timelinereportfactory.h"
+#include "ac/report/timeline/encoderreport.h"
+#include "ac/report/timeline/rendererreport.h"
+#include "ac/report/timeline/senderreport.h"
+
+namespace ac {
+namespace report {
+
+TimelineReportFactory::TimelineReportFactory(const timeline::ConnectionTimeline::Ptr &timeline) :
+    timeline_(timeline) {
+}
+
+std::shared_ptr<video::EncoderReport> TimelineReportFactory::CreateEncoderReport() {
+    return std::make_shared<timeline::EncoderReport>(timeline_);
+}
+
+std::shared_ptr<video::RendererReport> TimelineReportFactory::CreateRendererReport() {
+    return std::make_shared<timeline::RendererReport>(timeline_);
+}
+
+std::shared_ptr<video::PacketizerReport> TimelineReportFactory::CreatePacketizerReport() {
+    return std::make_shared<null::PacketizerReport>();
+}
+
+std::shared_ptr<video::SenderReport> TimelineReportFactory::CreateSenderReport() {
+    return std::make_shared<timeline::SenderReport>(timeline_);
+}
+
+} // namespace report
+} // namespace ac
@@ -0,0 +1,49 @@
+/*
+ * Copyright (C) 2016 Canonical, Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 3, as published
+ * by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranties of
+ * MERCHANTABILITY, SATISFACTORY QUALITY, or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef AC_REPORT_TIMELINEREPORTFACTORY_H_
+#define AC_REPORT_TIMELINEREPORTFACTORY_H_
+
+#include <memory>
+
+#include "ac/report/reportfactory.h"
+#include "ac/report/timeline/connectiontimeline.h"
+
+namespace ac {
+namespace report {
+
+// Creates reports which stamp the first rendered, encoded and sent
+// frame of a connection into a timeline. The report factory always adds
+// this to whatever else is configured. The packetizer has nothing to
+// add to the timeline and gets a null report.
+class TimelineReportFactory : public ReportFactory {
+public:
+    explicit TimelineReportFactory(const timeline::ConnectionTimeline::Ptr &timeline = timeline::ConnectionTimeline::Instance());
+
+    std::shared_ptr<video::EncoderReport> CreateEncoderReport();
+    std::shared_ptr<video::RendererReport> CreateRendererReport();
+    std::shared_ptr<video::PacketizerReport> CreatePacketizerReport();
+    std::shared_ptr<video::SenderReport> CreateSenderReport();
+
+private:
+    timeline::ConnectionTimeline::Ptr timeline_;
+};
+
+} // namespace report
+} // namespace ac
+
+#endif
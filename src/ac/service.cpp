@@ -26,10 +26,12 @@
 
 #include <chrono>
 
+#include <boost/concept_check.hpp>
 #include <boost/filesystem.hpp>
 
 #include <wds/logging.h>
 
+#include "ac/asynclogger.h"
 #include "ac/config.h"
 #include "ac/keep_alive.h"
 #include "ac/logger.h"
@@ -40,6 +42,9 @@
 
 #include "ac/dbus/controllerskeleton.h"
 
+#include "ac/report/recorder/flightrecorder.h"
+#include "ac/report/timeline/connectiontimeline.h"
+
 namespace {
 // TODO(morphis, tvoss): Expose the port as a construction-time parameter.
 const std::uint16_t kMiracastDefaultRtspCtrlPort{7236};
@@ -95,6 +100,12 @@ int Service::Main(const Service::MainOptions &options) {
         return 0;
     }
 
+    // The asynchronous logger keeps logging off the streaming threads
+    // and honors the severity so debug messages are only prepared
+    // with --debug.
+    if (ac::Utils::GetEnvValue("AETHERCAST_LOGGER") == "async")
+        ac::SetLogger(std::make_shared<ac::AsyncLogger>());
+
     if (options.debug)
         ac::Log().Init(ac::Logger::Severity::kDebug);
 
@@ -119,12 +130,22 @@ int Service::Main(const Service::MainOptions &options) {
             return FALSE;
         }
 
+        static gboolean OnDumpRequested(gpointer user_data) {
+            boost::ignore_unused_variable_warning(user_data);
+
+            if (const auto recorder = ac::report::recorder::FlightRecorder::Instance())
+                recorder->DumpToDirectory(ac::kStateDir);
+
+            return TRUE;
+        }
+
         Runtime() {
             // We do not have to use a KeepAlive<Scope> here as
             // a Runtime instance controls the lifetime of signal
             // emissions.
             g_unix_signal_add(SIGINT, OnSignalRaised, this);
             g_unix_signal_add(SIGTERM, OnSignalRaised, this);
+            g_unix_signal_add(SIGUSR1, OnDumpRequested, this);
 
             // Redirect all wds logging to our own.
             wds::LogSystem::set_vlog_func(SafeLog<ac::Logger::Severity::kTrace>);
@@ -346,7 +367,8 @@ void Service::AdvanceState(NetworkDeviceState new_state) {
         break;
 
     case kConnected:
-        source_ = SourceManager::Create(network_manager_->LocalAddress(), kMiracastDefaultRtspCtrlPort);
+        source_ = SourceManager::Create(network_manager_->LocalAddress(), kMiracastDefaultRtspCtrlPort,
+                                        current_device_->Address());
         source_->SetDelegate(shared_from_this());
         FinishConnectAttempt();
         break;
@@ -473,6 +495,11 @@ void Service::Connect(const NetworkDevice::Ptr &device, ResultCallback callback)
     // no current device is set.
      current_device_ = device;
 
+    // Everything the user waits for until the picture shows up on the
+    // remote side is measured from here on.
+    if (const auto timeline = report::timeline::ConnectionTimeline::Instance())
+        timeline->Start();
+
     if (!network_manager_->Connect(device)) {
         AC_DEBUG("Failed to connect remote device");
         current_device_.reset();
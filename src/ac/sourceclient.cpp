@@ -39,15 +39,18 @@ static int send_cseq = 0;
 }
 
 namespace ac {
-std::shared_ptr<SourceClient> SourceClient::Create(ScopedGObject<GSocket>&& socket, const ac::IpV4Address &local_address) {
-    std::shared_ptr<SourceClient> sp{new SourceClient{std::move(socket), local_address}};
+std::shared_ptr<SourceClient> SourceClient::Create(ScopedGObject<GSocket>&& socket, const ac::IpV4Address &local_address,
+                                                   const ac::MacAddress &sink_address) {
+    std::shared_ptr<SourceClient> sp{new SourceClient{std::move(socket), local_address, sink_address}};
     return sp->FinalizeConstruction();
 }
 
-SourceClient::SourceClient(ScopedGObject<GSocket>&& socket, const ac::IpV4Address &local_address) :
+SourceClient::SourceClient(ScopedGObject<GSocket>&& socket, const ac::IpV4Address &local_address,
+                           const ac::MacAddress &sink_address) :
     socket_(std::move(socket)),
     socket_source_(0),
-    local_address_(local_address) {
+    local_address_(local_address),
+    sink_address_(sink_address) {
 }
 
 SourceClient::~SourceClient() {
@@ -216,8 +219,9 @@ std::shared_ptr<SourceClient> SourceClient::FinalizeConstruction() {
 
     auto udp_stream = std::make_shared<ac::network::UdpStream>();
 
-    media_manager_ = MediaManagerFactory::CreateSource(peer_address, udp_stream);
+    media_manager_ = MediaManagerFactory::CreateSource(peer_address, sink_address_, udp_stream);
     media_manager_->SetDelegate(shared_from_this());
+    media_manager_->Prepare();
     source_.reset(wds::Source::Create(this, media_manager_.get(), this));
 
     source_->Start();
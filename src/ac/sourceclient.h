@@ -30,6 +30,7 @@
 
 #include "ac/glib_wrapper.h"
 #include "ac/ip_v4_address.h"
+#include "ac/mac_address.h"
 #include "ac/non_copyable.h"
 #include "ac/scoped_gobject.h"
 #include "ac/basesourcemediamanager.h"
@@ -47,7 +48,8 @@ public:
         virtual void OnConnectionClosed() = 0;
     };
 
-    static std::shared_ptr<SourceClient> Create(ScopedGObject<GSocket>&& socket, const ac::IpV4Address &local_address);
+    static std::shared_ptr<SourceClient> Create(ScopedGObject<GSocket>&& socket, const ac::IpV4Address &local_address,
+                                                const ac::MacAddress &sink_address);
 
     ~SourceClient();
 
@@ -74,7 +76,8 @@ public:
                                      gpointer user_data);
 
 private:
-    SourceClient(ScopedGObject<GSocket>&& socket, const ac::IpV4Address &local_address);
+    SourceClient(ScopedGObject<GSocket>&& socket, const ac::IpV4Address &local_address,
+                 const ac::MacAddress &sink_address);
     std::shared_ptr<SourceClient> FinalizeConstruction();
 
     void DumpRtsp(const std::string &prefix, const std::string &data);
@@ -86,6 +89,7 @@ private:
     ScopedGObject<GSocket> socket_;
     guint socket_source_;
     ac::IpV4Address local_address_;
+    ac::MacAddress sink_address_;
     std::vector<guint> timers_;
     std::unique_ptr<wds::Source> source_;
     std::shared_ptr<BaseSourceMediaManager> media_manager_;
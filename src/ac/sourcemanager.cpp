@@ -19,19 +19,22 @@
 #include "ac/logger.h"
 #include "ac/sourcemanager.h"
 #include "ac/sourceclient.h"
+#include "ac/report/timeline/connectiontimeline.h"
 #include "ac/logger.h"
 
 namespace ac {
-std::shared_ptr<SourceManager> SourceManager::Create(const ac::IpV4Address &address, unsigned short port) {
-    auto sp = std::shared_ptr<SourceManager>{new SourceManager{}};
+std::shared_ptr<SourceManager> SourceManager::Create(const ac::IpV4Address &address, unsigned short port,
+                                                     const ac::MacAddress &sink_address) {
+    auto sp = std::shared_ptr<SourceManager>{new SourceManager{sink_address}};
     sp->Setup(address, port);
     return sp;
 }
 
-SourceManager::SourceManager() :
+SourceManager::SourceManager(const ac::MacAddress &sink_address) :
     active_sink_(nullptr),
     socket_(nullptr),
-    socket_source_(0) {
+    socket_source_(0),
+    sink_address_(sink_address) {
 }
 
 SourceManager::~SourceManager() {
@@ -133,7 +136,11 @@ gboolean SourceManager::OnNewConnection(GSocket *socket, GIOCondition  cond, gpo
         return TRUE;
     }
 
-    inst->active_sink_ = SourceClient::Create(ScopedGObject<GSocket>{client_socket}, inst->local_address_);
+    if (const auto timeline = report::timeline::ConnectionTimeline::Instance())
+        timeline->Mark(report::timeline::ConnectionTimeline::Phase::kSinkConnected);
+
+    inst->active_sink_ = SourceClient::Create(ScopedGObject<GSocket>{client_socket}, inst->local_address_,
+                                             inst->sink_address_);
     inst->active_sink_->SetDelegate(inst->shared_from_this());
 
     return TRUE;
@@ -26,6 +26,7 @@
 #include "ac/sourceclient.h"
 #include "ac/scoped_gobject.h"
 #include "ac/ip_v4_address.h"
+#include "ac/mac_address.h"
 
 namespace ac {
 class SourceManager : public std::enable_shared_from_this<SourceManager>,
@@ -39,7 +40,8 @@ public:
         Delegate() = default;
     };
 
-    static std::shared_ptr<SourceManager> Create(const ac::IpV4Address &address, unsigned short port);
+    static std::shared_ptr<SourceManager> Create(const ac::IpV4Address &address, unsigned short port,
+                                                 const ac::MacAddress &sink_address);
 
     ~SourceManager();
 
@@ -52,7 +54,7 @@ public:
 private:
     static gboolean OnNewConnection(GSocket *socket, GIOCondition  cond, gpointer user_data);
 
-    SourceManager();
+    SourceManager(const ac::MacAddress &sink_address);
 
     bool Setup(const ac::IpV4Address &address, unsigned short port);
 
@@ -62,6 +64,7 @@ private:
     guint socket_source_;
     std::shared_ptr<SourceClient> active_sink_;
     ac::IpV4Address local_address_;
+    ac::MacAddress sink_address_;
 };
 } // namespace ac
 #endif
@@ -0,0 +1,46 @@
+/*
+ * Copyright (C) 2016 Canonical, Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 3, as published
+ * by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranties of
+ * MERCHANTABILITY, SATISFACTORY QUALITY, or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "ac/streaming/crc32.h"
+
+namespace {
+static constexpr std::uint32_t kPolynomial{0x04C11DB7};
+}
+
+namespace ac {
+namespace streaming {
+
+Crc32::Crc32() {
+    for (int i = 0; i < 256; i++) {
+        std::uint32_t crc = i << 24;
+        for (int j = 0; j < 8; j++)
+            crc = (crc << 1) ^ ((crc & 0x80000000) ? kPolynomial : 0);
+        table_[i] = crc;
+    }
+}
+
+std::uint32_t Crc32::Calculate(const std::uint8_t *data, std::size_t size) const {
+    std::uint32_t crc = 0xFFFFFFFF;
+
+    for (const std::uint8_t *p = data; p < data + size; ++p)
+        crc = (crc << 8) ^ table_[((crc >> 24) ^ *p) & 0xFF];
+
+    return crc;
+}
+
+} // namespace streaming
+} // namespace ac
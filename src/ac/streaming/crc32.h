@@ -0,0 +1,42 @@
+/*
+ * Copyright (C) 2016 Canonical, Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 3, as published
+ * by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranties of
+ * MERCHANTABILITY, SATISFACTORY QUALITY, or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef AC_STREAMING_CRC32_H_
+#define AC_STREAMING_CRC32_H_
+
+#include <cstddef>
+#include <cstdint>
+
+namespace ac {
+namespace streaming {
+
+// CRC-32 as used by the MPEG-TS program specific information sections
+// (polynomial 0x04C11DB7, no reflection, no final XOR).
+class Crc32 {
+public:
+    Crc32();
+
+    std::uint32_t Calculate(const std::uint8_t *data, std::size_t size) const;
+
+private:
+    std::uint32_t table_[256];
+};
+
+} // namespace streaming
+} // namespace ac
+
+#endif
@@ -0,0 +1,138 @@
+/*
+ * Copyright (C) 2016 Canonical, Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 3, as published
+ * by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranties of
+ * MERCHANTABILITY, SATISFACTORY QUALITY, or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <cstring>
+
+#include "ac/streaming/fec.h"
+
+namespace {
+// Lets the compiler emit SSE2 or NEON instructions without tying the
+// code to any of them.
+typedef std::uint8_t Vector __attribute__((vector_size(16)));
+
+static constexpr std::uint8_t kRowFlag{0x40};
+static constexpr std::uint8_t kRecoveryFlag{0x80};
+}
+
+namespace ac {
+namespace streaming {
+
+constexpr unsigned int FECConfig::kMaxColumns;
+constexpr unsigned int FECConfig::kMinRows;
+constexpr unsigned int FECConfig::kMaxRows;
+constexpr unsigned int FECConfig::kMaxMatrixSize;
+
+constexpr unsigned int FECHeader::kSize;
+constexpr unsigned int FECHeader::kRTPHeaderSize;
+constexpr unsigned int FECHeader::kPayloadType;
+
+bool FECConfig::IsValid() const {
+    if (columns < 1 || columns > kMaxColumns)
+        return false;
+
+    if (rows < kMinRows || rows > kMaxRows)
+        return false;
+
+    // Rows of less than four packets would cost more than they protect
+    if (row_parity && columns < kMinRows)
+        return false;
+
+    return columns * rows <= kMaxMatrixSize;
+}
+
+double FECConfig::Overhead() const {
+    if (!IsValid())
+        return 0.0;
+
+    double overhead = 1.0 / rows;
+    if (row_parity)
+        overhead += 1.0 / columns;
+
+    return overhead;
+}
+
+void FECHeader::Write(std::uint8_t *data) const {
+    data[0] = sn_base >> 8;
+    data[1] = sn_base & 0xff;
+    data[2] = length_recovery >> 8;
+    data[3] = length_recovery & 0xff;
+    data[4] = kRecoveryFlag | (pt_recovery & 0x7f);
+    // Mask isn't used by SMPTE 2022-1
+    data[5] = 0;
+    data[6] = 0;
+    data[7] = 0;
+    data[8] = ts_recovery >> 24;
+    data[9] = (ts_recovery >> 16) & 0xff;
+    data[10] = (ts_recovery >> 8) & 0xff;
+    data[11] = ts_recovery & 0xff;
+    // Type and index are zero for XOR parity
+    data[12] = row ? kRowFlag : 0;
+    data[13] = offset;
+    data[14] = count;
+    data[15] = 0;
+}
+
+bool FECHeader::Read(const std::uint8_t *data, std::size_t size) {
+    if (size < kSize)
+        return false;
+
+    // Only XOR parity without any extension is supported
+    if ((data[12] & ~kRowFlag) != 0)
+        return false;
+
+    sn_base = (data[0] << 8) | data[1];
+    length_recovery = (data[2] << 8) | data[3];
+    pt_recovery = data[4] & 0x7f;
+    ts_recovery = (data[8] << 24) | (data[9] << 16) | (data[10] << 8) | data[11];
+    row = (data[12] & kRowFlag) != 0;
+    offset = data[13];
+    count = data[14];
+
+    return offset > 0 && count > 0;
+}
+
+void FECXor(std::uint8_t *dst, const std::uint8_t *src, std::size_t size) {
+    std::size_t n = 0;
+
+    // Going through memcpy keeps the loads and stores free from any
+    // alignment requirements and still compiles down to single
+    // vector moves.
+    for (; n + 4 * sizeof(Vector) <= size; n += 4 * sizeof(Vector)) {
+        Vector a[4], b[4];
+        ::memcpy(a, dst + n, sizeof(a));
+        ::memcpy(b, src + n, sizeof(b));
+        a[0] ^= b[0];
+        a[1] ^= b[1];
+        a[2] ^= b[2];
+        a[3] ^= b[3];
+        ::memcpy(dst + n, a, sizeof(a));
+    }
+
+    for (; n + sizeof(Vector) <= size; n += sizeof(Vector)) {
+        Vector a, b;
+        ::memcpy(&a, dst + n, sizeof(a));
+        ::memcpy(&b, src + n, sizeof(b));
+        a ^= b;
+        ::memcpy(dst + n, &a, sizeof(a));
+    }
+
+    for (; n < size; n++)
+        dst[n] ^= src[n];
+}
+
+} // namespace streaming
+} // namespace ac
@@ -0,0 +1,77 @@
+/*
+ * Copyright (C) 2016 Canonical, Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 3, as published
+ * by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranties of
+ * MERCHANTABILITY, SATISFACTORY QUALITY, or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef AC_STREAMING_FEC_H_
+#define AC_STREAMING_FEC_H_
+
+#include <cstddef>
+#include <cstdint>
+
+namespace ac {
+namespace streaming {
+
+// Layout of the parity matrix for forward error correction in the style
+// of SMPTE 2022-1. Media packets are laid out row by row in a matrix of
+// the given number of columns (L) and rows (D). Column parity packets
+// protect the D packets of each column and recover bursts of up to L
+// consecutive lost packets. Row parity packets additionally protect the
+// L consecutive packets of each row.
+struct FECConfig {
+    static constexpr unsigned int kMaxColumns{20};
+    static constexpr unsigned int kMinRows{4};
+    static constexpr unsigned int kMaxRows{20};
+    static constexpr unsigned int kMaxMatrixSize{100};
+
+    bool IsValid() const;
+
+    // Returns the number of parity packets sent per media packet
+    double Overhead() const;
+
+    unsigned int columns{0};
+    unsigned int rows{0};
+    bool row_parity{false};
+};
+
+// The FEC header following the RTP header of every parity packet as
+// defined by SMPTE 2022-1 (derived from RFC 2733).
+struct FECHeader {
+    static constexpr unsigned int kSize{16};
+    // We never send RTP headers with CSRCs or extensions
+    static constexpr unsigned int kRTPHeaderSize{12};
+    // Dynamic payload type we send the parity packets with
+    static constexpr unsigned int kPayloadType{96};
+
+    void Write(std::uint8_t *data) const;
+    bool Read(const std::uint8_t *data, std::size_t size);
+
+    std::uint16_t sn_base{0};
+    std::uint16_t length_recovery{0};
+    std::uint8_t pt_recovery{0};
+    std::uint32_t ts_recovery{0};
+    bool row{false};
+    std::uint8_t offset{0};
+    std::uint8_t count{0};
+};
+
+// XORs size bytes from src into dst using the widest vector operations
+// the target offers.
+void FECXor(std::uint8_t *dst, const std::uint8_t *src, std::size_t size);
+
+} // namespace streaming
+} // namespace ac
+
+#endif
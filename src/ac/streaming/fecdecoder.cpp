@@ -0,0 +1,217 @@
+/*
+ * Copyright (C) 2016 Canonical, Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 3, as published
+ * by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranties of
+ * MERCHANTABILITY, SATISFACTORY QUALITY, or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <algorithm>
+
+#include "ac/streaming/fecdecoder.h"
+
+namespace ac {
+namespace streaming {
+
+constexpr unsigned int FECDecoder::kDefaultWindow;
+
+FECDecoder::FECDecoder(const PacketCallback &callback, unsigned int window) :
+    callback_(callback),
+    window_(window),
+    started_(false),
+    highest_(0),
+    next_(0) {
+}
+
+FECDecoder::~FECDecoder() {
+}
+
+void FECDecoder::ProcessMediaPacket(const std::uint8_t *data, std::size_t size) {
+    if (size < FECHeader::kRTPHeaderSize)
+        return;
+
+    stats_.media_packets++;
+
+    const std::uint16_t sequence_number = (data[2] << 8) | data[3];
+
+    if (!started_) {
+        highest_ = sequence_number;
+        next_ = sequence_number;
+        started_ = true;
+    }
+
+    const auto extended = Extend(sequence_number);
+
+    // Either a duplicate or we already gave up on it
+    if (extended < next_ || packets_.find(extended) != packets_.end())
+        return;
+
+    packets_[extended].assign(data, data + size);
+    highest_ = std::max(highest_, extended);
+
+    RecoverAll();
+    Deliver(false);
+}
+
+void FECDecoder::ProcessFECPacket(const std::uint8_t *data, std::size_t size) {
+    if (size < FECHeader::kRTPHeaderSize + FECHeader::kSize)
+        return;
+
+    stats_.fec_packets++;
+
+    // Without any media packet we can't tell where the parity belongs
+    if (!started_)
+        return;
+
+    Parity parity;
+    if (!parity.header.Read(data + FECHeader::kRTPHeaderSize, size - FECHeader::kRTPHeaderSize))
+        return;
+
+    parity.sn_base = Extend(parity.header.sn_base);
+    parity.payload.assign(data + FECHeader::kRTPHeaderSize + FECHeader::kSize, data + size);
+
+    parity_.push_back(std::move(parity));
+
+    RecoverAll();
+    Deliver(false);
+}
+
+void FECDecoder::Flush() {
+    RecoverAll();
+    Deliver(true);
+}
+
+FECDecoder::Statistics FECDecoder::Stats() const {
+    return stats_;
+}
+
+std::int64_t FECDecoder::Extend(std::uint16_t sequence_number) const {
+    const std::int16_t delta = sequence_number - static_cast<std::uint16_t>(highest_);
+    return highest_ + delta;
+}
+
+bool FECDecoder::Recover(const Parity &parity, std::int64_t missing) {
+    auto payload = parity.payload;
+    std::uint16_t length = parity.header.length_recovery;
+    std::uint8_t payload_type = parity.header.pt_recovery;
+    std::uint32_t timestamp = parity.header.ts_recovery;
+    const std::vector<std::uint8_t> *sibling = nullptr;
+
+    for (unsigned int n = 0; n < parity.header.count; n++) {
+        const auto sequence_number = parity.sn_base + n * parity.header.offset;
+        if (sequence_number == missing)
+            continue;
+
+        const auto &packet = packets_.at(sequence_number);
+        const auto packet_length = packet.size() - FECHeader::kRTPHeaderSize;
+        if (packet_length > payload.size())
+            return false;
+
+        length ^= packet_length;
+        payload_type ^= packet[1] & 0x7f;
+        timestamp ^= (packet[4] << 24) | (packet[5] << 16) | (packet[6] << 8) | packet[7];
+        FECXor(payload.data(), packet.data() + FECHeader::kRTPHeaderSize, packet_length);
+
+        sibling = &packet;
+    }
+
+    if (length > payload.size())
+        return false;
+
+    std::vector<std::uint8_t> packet(FECHeader::kRTPHeaderSize + length, 0);
+
+    // Version and source are the same for all packets of the stream
+    if (sibling) {
+        packet[0] = (*sibling)[0];
+        std::copy(sibling->begin() + 8, sibling->begin() + 12, packet.begin() + 8);
+    } else {
+        packet[0] = 0x80;
+    }
+
+    packet[1] = payload_type;
+    packet[2] = (missing >> 8) & 0xff;
+    packet[3] = missing & 0xff;
+    packet[4] = timestamp >> 24;
+    packet[5] = (timestamp >> 16) & 0xff;
+    packet[6] = (timestamp >> 8) & 0xff;
+    packet[7] = timestamp & 0xff;
+
+    std::copy(payload.begin(), payload.begin() + length, packet.begin() + FECHeader::kRTPHeaderSize);
+
+    packets_[missing] = std::move(packet);
+    highest_ = std::max(highest_, missing);
+    stats_.recovered_packets++;
+
+    return true;
+}
+
+void FECDecoder::RecoverAll() {
+    // Recovering a packet through one parity packet can make another
+    // one usable so we go on until nothing changes anymore.
+    bool progress = true;
+    while (progress) {
+        progress = false;
+
+        for (auto it = parity_.begin(); it != parity_.end();) {
+            unsigned int missing = 0;
+            std::int64_t missing_sequence_number = 0;
+
+            for (unsigned int n = 0; n < it->header.count; n++) {
+                const auto sequence_number = it->sn_base + n * it->header.offset;
+                if (packets_.find(sequence_number) != packets_.end())
+                    continue;
+
+                missing++;
+                missing_sequence_number = sequence_number;
+            }
+
+            if (missing > 1) {
+                ++it;
+                continue;
+            }
+
+            if (missing == 1 && missing_sequence_number >= next_ &&
+                    Recover(*it, missing_sequence_number))
+                progress = true;
+
+            it = parity_.erase(it);
+        }
+    }
+}
+
+void FECDecoder::Deliver(bool flush) {
+    while (next_ <= highest_) {
+        const auto it = packets_.find(next_);
+        if (it != packets_.end()) {
+            callback_(it->second.data(), it->second.size());
+            next_++;
+            continue;
+        }
+
+        if (!flush && highest_ - next_ < window_)
+            break;
+
+        stats_.lost_packets++;
+        next_++;
+    }
+
+    const auto oldest = next_ - window_;
+
+    packets_.erase(packets_.begin(), packets_.lower_bound(oldest));
+
+    parity_.remove_if([&](const Parity &parity) {
+        return parity.sn_base < oldest;
+    });
+}
+
+} // namespace streaming
+} // namespace ac
@@ -0,0 +1,92 @@
+/*
+ * Copyright (C) 2016 Canonical, Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 3, as published
+ * by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranties of
+ * MERCHANTABILITY, SATISFACTORY QUALITY, or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef AC_STREAMING_FECDECODER_H_
+#define AC_STREAMING_FECDECODER_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <list>
+#include <map>
+#include <vector>
+
+#include "ac/non_copyable.h"
+
+#include "ac/streaming/fec.h"
+
+namespace ac {
+namespace streaming {
+
+// Receiving side of FECEncoder. Takes the media and the parity packets
+// as they arrive, recovers lost media packets where the parity allows
+// it and hands all media packets on in order of their sequence numbers.
+class FECDecoder : public ac::NonCopyable {
+public:
+    // Media packets following a gap are held back for at most this many
+    // packets to give parity packets the chance to fill the gap. Covers
+    // the largest matrix FECConfig allows.
+    static constexpr unsigned int kDefaultWindow{FECConfig::kMaxMatrixSize + FECConfig::kMaxColumns};
+
+    typedef std::function<void(const std::uint8_t *data, std::size_t size)> PacketCallback;
+
+    struct Statistics {
+        std::uint64_t media_packets{0};
+        std::uint64_t fec_packets{0};
+        std::uint64_t recovered_packets{0};
+        std::uint64_t lost_packets{0};
+    };
+
+    explicit FECDecoder(const PacketCallback &callback, unsigned int window = kDefaultWindow);
+    ~FECDecoder();
+
+    void ProcessMediaPacket(const std::uint8_t *data, std::size_t size);
+    void ProcessFECPacket(const std::uint8_t *data, std::size_t size);
+
+    // Hands on everything still held back and gives up on all gaps
+    void Flush();
+
+    Statistics Stats() const;
+
+private:
+    struct Parity {
+        FECHeader header;
+        std::int64_t sn_base;
+        std::vector<std::uint8_t> payload;
+    };
+
+    std::int64_t Extend(std::uint16_t sequence_number) const;
+    bool Recover(const Parity &parity, std::int64_t missing);
+    void RecoverAll();
+    void Deliver(bool flush);
+
+    const PacketCallback callback_;
+    const unsigned int window_;
+    bool started_;
+    std::int64_t highest_;
+    std::int64_t next_;
+    // Delivered packets are kept around for as long as parity packets
+    // protecting them together with a missing one may still arrive.
+    std::map<std::int64_t, std::vector<std::uint8_t>> packets_;
+    std::list<Parity> parity_;
+    Statistics stats_;
+};
+
+} // namespace streaming
+} // namespace ac
+
+#endif
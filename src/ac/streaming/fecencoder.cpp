@@ -0,0 +1,155 @@
+/*
+ * Copyright (C) 2016 Canonical, Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 3, as published
+ * by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranties of
+ * MERCHANTABILITY, SATISFACTORY QUALITY, or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <algorithm>
+#include <cstring>
+
+#include "ac/streaming/fecencoder.h"
+
+namespace {
+// Parity packets are not tied to any media source
+static constexpr std::uint32_t kSourceID{0};
+}
+
+namespace ac {
+namespace streaming {
+
+FECEncoder::Parity::Parity(std::size_t max_payload_size) :
+    timestamp(0),
+    count(0),
+    payload_size(0),
+    payload(max_payload_size, 0) {
+}
+
+void FECEncoder::Parity::Add(const std::uint8_t *packet, std::size_t size) {
+    const auto length = size - FECHeader::kRTPHeaderSize;
+    const std::uint16_t sequence_number = (packet[2] << 8) | packet[3];
+
+    timestamp = (packet[4] << 24) | (packet[5] << 16) | (packet[6] << 8) | packet[7];
+
+    if (count == 0)
+        header.sn_base = sequence_number;
+
+    header.length_recovery ^= length;
+    header.pt_recovery ^= packet[1] & 0x7f;
+    header.ts_recovery ^= timestamp;
+
+    FECXor(payload.data(), packet + FECHeader::kRTPHeaderSize, length);
+
+    payload_size = std::max(payload_size, length);
+    count++;
+}
+
+void FECEncoder::Parity::Clear() {
+    ::memset(payload.data(), 0, payload_size);
+    header = FECHeader();
+    timestamp = 0;
+    count = 0;
+    payload_size = 0;
+}
+
+FECEncoder::FECEncoder(const FECConfig &config, std::size_t max_payload_size) :
+    config_(config),
+    max_payload_size_(max_payload_size),
+    columns_(config.columns, Parity(max_payload_size)),
+    row_(max_payload_size),
+    position_(0),
+    next_sequence_number_(0),
+    fec_sequence_number_(0) {
+}
+
+FECEncoder::~FECEncoder() {
+}
+
+void FECEncoder::Protect(const std::uint8_t *packet, std::size_t size,
+                         std::vector<video::Buffer::Ptr> &parity) {
+    if (size < FECHeader::kRTPHeaderSize ||
+            size - FECHeader::kRTPHeaderSize > max_payload_size_)
+        return;
+
+    const std::uint16_t sequence_number = (packet[2] << 8) | packet[3];
+
+    // Parity over a matrix with holes would be useless for the receiver
+    if (position_ > 0 && sequence_number != next_sequence_number_)
+        Reset();
+
+    next_sequence_number_ = sequence_number + 1;
+
+    const auto column = position_ % config_.columns;
+    const auto row = position_ / config_.columns;
+
+    auto &column_parity = columns_[column];
+    column_parity.Add(packet, size);
+    if (row == config_.rows - 1)
+        parity.push_back(Finish(column_parity, false, config_.columns));
+
+    if (config_.row_parity) {
+        row_.Add(packet, size);
+        if (column == config_.columns - 1)
+            parity.push_back(Finish(row_, true, 1));
+    }
+
+    position_ = (position_ + 1) % (config_.columns * config_.rows);
+}
+
+void FECEncoder::Reset() {
+    for (auto &column : columns_)
+        column.Clear();
+
+    row_.Clear();
+    position_ = 0;
+}
+
+FECConfig FECEncoder::Config() const {
+    return config_;
+}
+
+video::Buffer::Ptr FECEncoder::Finish(Parity &parity, bool row, unsigned int offset) {
+    const auto packet = video::Buffer::Create(FECHeader::kRTPHeaderSize + FECHeader::kSize +
+                                              parity.payload_size);
+    std::uint8_t *ptr = packet->Data();
+
+    ptr[0] = 0x80;
+    ptr[1] = FECHeader::kPayloadType;
+    ptr[2] = fec_sequence_number_ >> 8;
+    ptr[3] = fec_sequence_number_ & 0xff;
+    ptr[4] = parity.timestamp >> 24;
+    ptr[5] = (parity.timestamp >> 16) & 0xff;
+    ptr[6] = (parity.timestamp >> 8) & 0xff;
+    ptr[7] = parity.timestamp & 0xff;
+    ptr[8] = kSourceID >> 24;
+    ptr[9] = (kSourceID >> 16) & 0xff;
+    ptr[10] = (kSourceID >> 8) & 0xff;
+    ptr[11] = kSourceID & 0xff;
+
+    fec_sequence_number_++;
+
+    parity.header.row = row;
+    parity.header.offset = offset;
+    parity.header.count = parity.count;
+    parity.header.Write(ptr + FECHeader::kRTPHeaderSize);
+
+    ::memcpy(ptr + FECHeader::kRTPHeaderSize + FECHeader::kSize,
+             parity.payload.data(), parity.payload_size);
+
+    parity.Clear();
+
+    return packet;
+}
+
+} // namespace streaming
+} // namespace ac
@@ -0,0 +1,81 @@
+/*
+ * Copyright (C) 2016 Canonical, Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 3, as published
+ * by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranties of
+ * MERCHANTABILITY, SATISFACTORY QUALITY, or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef AC_STREAMING_FECENCODER_H_
+#define AC_STREAMING_FECENCODER_H_
+
+#include <memory>
+#include <vector>
+
+#include "ac/non_copyable.h"
+
+#include "ac/video/buffer.h"
+
+#include "ac/streaming/fec.h"
+
+namespace ac {
+namespace streaming {
+
+// Generates XOR parity packets over the RTP packets we send out
+// according to the configured FEC matrix.
+class FECEncoder : public ac::NonCopyable {
+public:
+    typedef std::shared_ptr<FECEncoder> Ptr;
+
+    FECEncoder(const FECConfig &config, std::size_t max_payload_size);
+    ~FECEncoder();
+
+    // Adds the RTP packet to the matrix and appends all parity packets
+    // it completes to the given list. Packets are expected in the order
+    // of their sequence numbers, a gap starts a new matrix.
+    void Protect(const std::uint8_t *packet, std::size_t size,
+                 std::vector<video::Buffer::Ptr> &parity);
+
+    void Reset();
+
+    FECConfig Config() const;
+
+private:
+    class Parity {
+    public:
+        explicit Parity(std::size_t max_payload_size);
+
+        void Add(const std::uint8_t *packet, std::size_t size);
+        void Clear();
+
+        FECHeader header;
+        std::uint32_t timestamp;
+        unsigned int count;
+        std::size_t payload_size;
+        std::vector<std::uint8_t> payload;
+    };
+
+    video::Buffer::Ptr Finish(Parity &parity, bool row, unsigned int offset);
+
+    const FECConfig config_;
+    const std::size_t max_payload_size_;
+    std::vector<Parity> columns_;
+    Parity row_;
+    unsigned int position_;
+    std::uint16_t next_sequence_number_;
+    std::uint16_t fec_sequence_number_;
+};
+
+} // namespace streaming
+} // namespace ac
+
+#endif
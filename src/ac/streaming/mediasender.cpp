@@ -25,6 +25,8 @@
 
 namespace {
 static constexpr const char *kMediaSenderThreadName{"MediaSender"};
+// Per spec we need to emit PAT/PMT and PCR updates atleast every 100ms
+static constexpr int64_t kMaxTableIntervalUs{100000};
 }
 
 namespace ac {
@@ -35,6 +37,7 @@ MediaSender::MediaSender(const Packetizer::Ptr &packetizer, const TransportSende
     packetizer_(packetizer),
     sender_(sender),
     prev_time_us_(-1ll),
+    frame_interval_us_(config.framerate > 0 ? 1000000ll / config.framerate : 0ll),
     queue_(video::BufferQueue::Create()) {
 
     if (!packetizer_ || !sender_) {
@@ -74,9 +77,13 @@ void MediaSender::ProcessBuffer(const ac::video::Buffer::Ptr &buffer) {
     // flags to Packetizer::kPrependSPSandPPStoIDRFrames.
     int flags = 0;
 
-    // Per spec we need to emit PAT/PMT and PCR updates atleast every 100ms
-    int64_t time_us = ac::Utils::GetNowUs();
-    if (prev_time_us_ < 0ll || prev_time_us_ + 100000ll <= time_us) {
+    // The tables can only go out together with a frame. If we waited
+    // until the limit is reached the next frame would already be too
+    // late so we emit them one frame interval ahead. Frames leave the
+    // encoder at the pace they were captured in so their capture time
+    // is what we measure the interval with.
+    int64_t time_us = buffer->Timestamp();
+    if (prev_time_us_ < 0ll || prev_time_us_ + kMaxTableIntervalUs - frame_interval_us_ <= time_us) {
         flags |= Packetizer::kEmitPATandPMT;
         flags |= Packetizer::kEmitPCR;
         prev_time_us_ = time_us;
@@ -88,6 +95,7 @@ void MediaSender::ProcessBuffer(const ac::video::Buffer::Ptr &buffer) {
     }
 
     packets->SetTimestamp(buffer->Timestamp());
+    packets->SetFrameNumber(buffer->FrameNumber());
     sender_->Queue(packets);
 }
 
@@ -62,6 +62,7 @@ private:
     TransportSender::Ptr sender_;
     Packetizer::TrackId video_track_;
     int64_t prev_time_us_;
+    int64_t frame_interval_us_;
     ac::video::BufferQueue::Ptr queue_;
 };
 
@@ -213,7 +213,6 @@ MPEGTSPacketizer::MPEGTSPacketizer(const ac::video::PacketizerReport::Ptr &repor
     report_(report),
     pat_continuity_counter_(0),
     pmt_continuity_counter_(0) {
-    InitCrcTable();
 }
 
 MPEGTSPacketizer::~MPEGTSPacketizer() {
@@ -421,6 +420,7 @@ bool MPEGTSPacketizer::Packetize(TrackId track_index, const video::Buffer::Ptr &
 
     auto buffer = ac::video::Buffer::Create(numTSPackets * 188);
     buffer->SetTimestamp(access_unit->Timestamp());
+    buffer->SetFrameNumber(access_unit->FrameNumber());
 
     uint8_t *packetDataStart = buffer->Data();
 
@@ -480,7 +480,7 @@ bool MPEGTSPacketizer::Packetize(TrackId track_index, const video::Buffer::Ptr &
         if (ptr - crcDataStart != 12)
             AC_FATAL("Invalid position for ptr");
 
-        uint32_t crc = ::htonl(CalcCrc32(crcDataStart, ptr - crcDataStart));
+        uint32_t crc = ::htonl(crc_.Calculate(crcDataStart, ptr - crcDataStart));
         ::memcpy(ptr, &crc, 4);
         ptr += 4;
 
@@ -593,7 +593,7 @@ bool MPEGTSPacketizer::Packetize(TrackId track_index, const video::Buffer::Ptr &
         crcDataStart[1] = 0xb0 | (section_length >> 8);
         crcDataStart[2] = section_length & 0xff;
 
-        crc = ::htonl(CalcCrc32(crcDataStart, ptr - crcDataStart));
+        crc = ::htonl(crc_.Calculate(crcDataStart, ptr - crcDataStart));
         memcpy(ptr, &crc, 4);
         ptr += 4;
 
@@ -797,33 +797,10 @@ bool MPEGTSPacketizer::Packetize(TrackId track_index, const video::Buffer::Ptr &
 
     *packets = buffer;
 
-    report_->PacketizedFrame(buffer->Timestamp());
+    report_->PacketizedFrame(buffer->FrameNumber(), buffer->Timestamp());
 
     return true;
 }
 
-void MPEGTSPacketizer::InitCrcTable() {
-    uint32_t poly = 0x04C11DB7;
-
-    for (int i = 0; i < 256; i++) {
-        uint32_t crc = i << 24;
-        for (int j = 0; j < 8; j++) {
-            crc = (crc << 1) ^ ((crc & 0x80000000) ? (poly) : 0);
-        }
-        crc_table_[i] = crc;
-    }
-}
-
-uint32_t MPEGTSPacketizer::CalcCrc32(const uint8_t *start, size_t size) const {
-    uint32_t crc = 0xFFFFFFFF;
-    const uint8_t *p;
-
-    for (p = start; p < start + size; ++p) {
-        crc = (crc << 8) ^ crc_table_[((crc >> 24) ^ *p) & 0xFF];
-    }
-
-    return crc;
-}
-
 } // namespace streaming
 } // namespace ac
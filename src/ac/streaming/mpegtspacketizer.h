@@ -23,6 +23,7 @@
 
 #include "ac/video/packetizerreport.h"
 
+#include "ac/streaming/crc32.h"
 #include "ac/streaming/packetizer.h"
 
 namespace ac {
@@ -44,10 +45,6 @@ public:
 private:
     MPEGTSPacketizer(const ac::video::PacketizerReport::Ptr &report);
 
-private:
-    void InitCrcTable();
-    uint32_t CalcCrc32(const uint8_t *start, size_t size) const;
-
 private:
     struct Track;
 
@@ -55,7 +52,7 @@ private:
     ac::video::PacketizerReport::Ptr report_;
     unsigned int pat_continuity_counter_;
     unsigned int pmt_continuity_counter_;
-    uint32_t crc_table_[256];
+    Crc32 crc_;
     std::vector<std::shared_ptr<Track>> tracks_;
     std::vector<video::Buffer::Ptr> program_info_descriptors_;
 };
@@ -0,0 +1,195 @@
+/*
+ * Copyright (C) 2016 Canonical, Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 3, as published
+ * by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranties of
+ * MERCHANTABILITY, SATISFACTORY QUALITY, or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <cstring>
+
+#include "ac/logger.h"
+
+#include "ac/streaming/rtcpreceiver.h"
+#include "ac/streaming/rtpsender.h"
+
+namespace {
+static constexpr const char *kRTCPReceiverThreadName{"RTCPReceiver"};
+static constexpr unsigned int kMaxDatagramSize{1500};
+// Keeps the executor responsive for stopping
+static constexpr int kPollTimeoutMs{10};
+
+static constexpr unsigned int kRTCPHeaderSize{4};
+static constexpr unsigned int kRTCPVersion{2};
+// Transport layer feedback and its generic NACK format, see RFC 4585
+static constexpr unsigned int kRTCPPayloadTypeRTPFB{205};
+static constexpr unsigned int kRTCPFormatGenericNACK{1};
+// Sender and media source SSRC in front of the feedback control information
+static constexpr unsigned int kFeedbackHeaderSize{8};
+static constexpr unsigned int kNACKItemSize{4};
+}
+
+namespace ac {
+namespace streaming {
+
+RTCPReceiver::RTCPReceiver() :
+    socket_(-1),
+    sink_address_(INADDR_NONE),
+    datagram_(kMaxDatagramSize) {
+}
+
+RTCPReceiver::~RTCPReceiver() {
+    if (socket_ >= 0)
+        ::close(socket_);
+}
+
+void RTCPReceiver::SetDelegate(const std::weak_ptr<Delegate> &delegate) {
+    delegate_ = delegate;
+}
+
+bool RTCPReceiver::Bind(const network::Port &port, const std::string &sink_address) {
+    if (socket_ >= 0)
+        return false;
+
+    // We don't know which port the sink sends its feedback from so
+    // instead of connecting the socket we filter by address ourself.
+    struct in_addr sink;
+    if (::inet_pton(AF_INET, sink_address.c_str(), &sink) != 1) {
+        AC_ERROR("Invalid sink address '%s'", sink_address);
+        return false;
+    }
+
+    const auto fd = ::socket(AF_INET, SOCK_DGRAM, 0);
+    if (fd < 0) {
+        AC_ERROR("Failed to create socket: %s (%d)", ::strerror(errno), errno);
+        return false;
+    }
+
+    struct sockaddr_in addr;
+    ::memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_ANY);
+    addr.sin_port = htons(port);
+
+    if (::bind(fd, reinterpret_cast<const struct sockaddr*>(&addr), sizeof(addr)) < 0) {
+        AC_ERROR("Failed to bind RTCP socket to port %d: %s (%d)", port, ::strerror(errno), errno);
+        ::close(fd);
+        return false;
+    }
+
+    socket_ = fd;
+    sink_address_ = sink.s_addr;
+
+    return true;
+}
+
+bool RTCPReceiver::Process(const std::uint8_t *data, std::size_t size) {
+    lost_.clear();
+
+    std::size_t offset = 0;
+    while (offset + kRTCPHeaderSize <= size) {
+        const auto header = data + offset;
+
+        if ((header[0] >> 6) != kRTCPVersion)
+            return false;
+
+        const std::size_t length = (((header[2] << 8) | header[3]) + 1) * 4;
+        if (offset + length > size)
+            return false;
+
+        if (header[1] == kRTCPPayloadTypeRTPFB && (header[0] & 0x1f) == kRTCPFormatGenericNACK) {
+            if (length < kRTCPHeaderSize + kFeedbackHeaderSize)
+                return false;
+
+            // Only the NACKs for our own stream are ours to answer
+            const std::uint32_t media_source = (header[8] << 24) | (header[9] << 16) |
+                                               (header[10] << 8) | header[11];
+
+            if (media_source == RTPSender::kSourceID) {
+                for (std::size_t n = kRTCPHeaderSize + kFeedbackHeaderSize; n + kNACKItemSize <= length; n += kNACKItemSize) {
+                    const std::uint16_t pid = (header[n] << 8) | header[n + 1];
+                    const std::uint16_t blp = (header[n + 2] << 8) | header[n + 3];
+
+                    lost_.push_back(pid);
+
+                    // Every bit stands for one of the 16 packets following
+                    for (unsigned int bit = 0; bit < 16; bit++) {
+                        if (blp & (1 << bit))
+                            lost_.push_back(pid + bit + 1);
+                    }
+                }
+            }
+        }
+
+        offset += length;
+    }
+
+    if (offset != size)
+        return false;
+
+    if (lost_.size() == 0)
+        return true;
+
+    if (auto sp = delegate_.lock())
+        sp->OnPacketsLost(lost_);
+
+    return true;
+}
+
+bool RTCPReceiver::Start() {
+    return socket_ >= 0;
+}
+
+bool RTCPReceiver::Stop() {
+    return true;
+}
+
+bool RTCPReceiver::Execute() {
+    struct pollfd pfd;
+    pfd.fd = socket_;
+    pfd.events = POLLIN;
+
+    if (::poll(&pfd, 1, kPollTimeoutMs) <= 0)
+        return true;
+
+    struct sockaddr_in from;
+    socklen_t from_length = sizeof(from);
+    const auto size = ::recvfrom(socket_, datagram_.data(), datagram_.size(), 0,
+                                 reinterpret_cast<struct sockaddr*>(&from), &from_length);
+    if (size < 0) {
+        AC_WARNING("Failed to receive RTCP packet: %s (%d)", ::strerror(errno), errno);
+        return true;
+    }
+
+    if (from.sin_family != AF_INET || from.sin_addr.s_addr != sink_address_) {
+        AC_DEBUG("Ignoring RTCP packet from other host than the sink");
+        return true;
+    }
+
+    if (!Process(datagram_.data(), size))
+        AC_DEBUG("Ignoring malformed RTCP packet");
+
+    return true;
+}
+
+std::string RTCPReceiver::Name() const {
+    return kRTCPReceiverThreadName;
+}
+
+} // namespace streaming
+} // namespace ac
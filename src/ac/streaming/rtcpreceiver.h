@@ -0,0 +1,78 @@
+/*
+ * Copyright (C) 2016 Canonical, Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 3, as published
+ * by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranties of
+ * MERCHANTABILITY, SATISFACTORY QUALITY, or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef AC_STREAMING_RTCPRECEIVER_H_
+#define AC_STREAMING_RTCPRECEIVER_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "ac/non_copyable.h"
+
+#include "ac/common/executable.h"
+
+#include "ac/network/types.h"
+
+namespace ac {
+namespace streaming {
+
+// Listens for RTCP feedback from the sink and reports the sequence
+// numbers of all packets it asks for with generic NACKs (RFC 4585).
+// Everything else the sink sends is ignored, as are NACKs for any
+// other media source than our RTP stream and packets from other hosts.
+class RTCPReceiver : public common::Executable {
+public:
+    typedef std::shared_ptr<RTCPReceiver> Ptr;
+
+    class Delegate : public ac::NonCopyable {
+    public:
+        virtual void OnPacketsLost(const std::vector<std::uint16_t> &sequence_numbers) = 0;
+    };
+
+    RTCPReceiver();
+    ~RTCPReceiver();
+
+    void SetDelegate(const std::weak_ptr<Delegate> &delegate);
+
+    // Listens on the given port for packets coming from the sink's address
+    bool Bind(const network::Port &port, const std::string &sink_address);
+
+    // Parses a compound RTCP packet and hands all NACKed sequence numbers
+    // to the delegate. Returns false if the packet is malformed.
+    bool Process(const std::uint8_t *data, std::size_t size);
+
+    // From ac::common::Executable
+    bool Start() override;
+    bool Stop() override;
+    bool Execute() override;
+    std::string Name() const override;
+
+private:
+    int socket_;
+    std::uint32_t sink_address_;
+    std::weak_ptr<Delegate> delegate_;
+    std::vector<std::uint8_t> datagram_;
+    std::vector<std::uint16_t> lost_;
+};
+
+} // namespace streaming
+} // namespace ac
+
+#endif
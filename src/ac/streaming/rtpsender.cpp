@@ -28,6 +28,8 @@
 #include <error.h>
 #include <stdlib.h>
 
+#include <algorithm>
+
 #include "ac/logger.h"
 
 #include "ac/streaming/rtpsender.h"
@@ -36,7 +38,6 @@ namespace {
 static constexpr const char *kRTPSenderThreadName{"RTPSender"};
 static constexpr unsigned int kRTPHeaderSize{12};
 static constexpr unsigned int kMPEGTSPacketSize{188};
-static constexpr unsigned int kSourceID = 0xdeadbeef;
 // See http://www.iana.org/assignments/rtp-parameters/rtp-parameters.xhtml
 static constexpr unsigned int kRTPPayloadTypeMP2T = 33;
 }
@@ -44,18 +45,55 @@ static constexpr unsigned int kRTPPayloadTypeMP2T = 33;
 namespace ac {
 namespace streaming {
 
+constexpr std::uint32_t RTPSender::kSourceID;
+constexpr std::uint32_t RTPSender::kRetransmissionHistorySize;
+constexpr ac::TimestampUs RTPSender::kMaxRetransmissionAge;
+
 RTPSender::RTPSender(const network::Stream::Ptr &stream, const video::SenderReport::Ptr &report) :
     stream_(stream),
     max_ts_packets_((stream->MaxUnitSize() - kRTPHeaderSize) / kMPEGTSPacketSize),
     report_(report),
     rtp_sequence_number_(0),
     queue_(video::BufferQueue::Create()),
-    network_error_(false) {
+    network_error_(false),
+    history_(kRetransmissionHistorySize) {
 }
 
 RTPSender::~RTPSender() {
 }
 
+bool RTPSender::EnableFEC(const network::Stream::Ptr &stream, const FECConfig &config) {
+    if (!stream || !config.IsValid())
+        return false;
+
+    const auto max_payload_size = max_ts_packets_ * kMPEGTSPacketSize;
+
+    // Parity packets carry their own header on top of the largest
+    // payload they protect.
+    if (kRTPHeaderSize + FECHeader::kSize + max_payload_size > stream->MaxUnitSize()) {
+        AC_WARNING("Parity packets don't fit into units of the FEC stream");
+        return false;
+    }
+
+    fec_stream_ = stream;
+    fec_encoder_ = std::make_shared<FECEncoder>(config, max_payload_size);
+
+    return true;
+}
+
+void RTPSender::SendParity(const video::Buffer::Ptr &packet) {
+    parity_.clear();
+    fec_encoder_->Protect(packet->Data(), packet->Length(), parity_);
+
+    // Losing parity packets doesn't hurt the stream itself so we
+    // don't treat that as a reason to stop.
+    for (const auto &parity : parity_) {
+        if (fec_stream_->Write(parity->Data(), parity->Length(), packet->Timestamp())
+                != network::Stream::Error::kNone)
+            AC_DEBUG("Failed to send parity packet");
+    }
+}
+
 bool RTPSender::Start() {
     return true;
 }
@@ -65,6 +103,10 @@ bool RTPSender::Stop() {
 }
 
 bool RTPSender::Execute() {
+    // Lost packets are only worth something if they still arrive in
+    // time so they go out before anything new.
+    SendRetransmissions();
+
     if (!queue_->WaitToBeFilled())
         return true;
 
@@ -77,11 +119,20 @@ bool RTPSender::Execute() {
 
         if (stream_->Write(packet->Data(), packet->Length(), packet->Timestamp())
                 != network::Stream::Error::kNone) {
+            report_->FailedToSendPacket(packet->FrameNumber(), packet->Timestamp());
             network_error_.exchange(true);
             break;
         }
 
-        report_->SentPacket(packet->Timestamp(), packet->Length());
+        report_->SentPacket(packet->FrameNumber(), packet->Timestamp(), packet->Length());
+
+        const std::uint16_t sequence_number = (packet->Data()[2] << 8) | packet->Data()[3];
+        auto &entry = history_[sequence_number & (kRetransmissionHistorySize - 1)];
+        entry.packet = packet;
+        entry.sent_at = ac::Utils::GetNowUs();
+
+        if (fec_encoder_)
+            SendParity(packet);
     }
 
     queue_->Unlock();
@@ -144,10 +195,11 @@ bool RTPSender::Queue(const video::Buffer::Ptr &packets) {
 
         packet->SetRange(0, kRTPHeaderSize + num_ts_packets * kMPEGTSPacketSize);
 
-        // We're only setting the timestamp on the packet here for
-        // statistically reasons we can check later on how late we
-        // send a buffer out.
+        // We're only setting the timestamp and frame number on the
+        // packet here for statistically reasons we can check later on
+        // how late we send a buffer out.
         packet->SetTimestamp(packets->Timestamp());
+        packet->SetFrameNumber(packets->FrameNumber());
 
         offset += num_ts_packets * kMPEGTSPacketSize;
 
@@ -159,6 +211,65 @@ bool RTPSender::Queue(const video::Buffer::Ptr &packets) {
     return true;
 }
 
+void RTPSender::OnPacketsLost(const std::vector<std::uint16_t> &sequence_numbers) {
+    std::lock_guard<std::mutex> lock(retransmission_mutex_);
+
+    retransmission_stats_.requested += sequence_numbers.size();
+
+    // More than we remember can't be answered anyway
+    const auto room = kRetransmissionHistorySize - std::min<std::size_t>(
+                pending_retransmissions_.size(), kRetransmissionHistorySize);
+    const auto accepted = std::min<std::size_t>(room, sequence_numbers.size());
+
+    pending_retransmissions_.insert(pending_retransmissions_.end(),
+                                    sequence_numbers.begin(), sequence_numbers.begin() + accepted);
+    retransmission_stats_.dropped += sequence_numbers.size() - accepted;
+}
+
+RTPSender::RetransmissionStatistics RTPSender::Retransmissions() {
+    std::lock_guard<std::mutex> lock(retransmission_mutex_);
+    return retransmission_stats_;
+}
+
+void RTPSender::SendRetransmissions() {
+    {
+        std::lock_guard<std::mutex> lock(retransmission_mutex_);
+        if (pending_retransmissions_.size() == 0)
+            return;
+
+        retransmissions_.swap(pending_retransmissions_);
+    }
+
+    const auto now = ac::Utils::GetNowUs();
+    std::uint64_t sent = 0;
+
+    for (const auto sequence_number : retransmissions_) {
+        const auto &entry = history_[sequence_number & (kRetransmissionHistorySize - 1)];
+
+        // The slot may already hold a newer packet or none at all
+        if (!entry.packet || now - entry.sent_at > kMaxRetransmissionAge)
+            continue;
+
+        const auto data = entry.packet->Data();
+        if (((data[2] << 8) | data[3]) != sequence_number)
+            continue;
+
+        // Retransmissions are best effort, a failing network shows up
+        // with the regular packets soon enough.
+        if (stream_->Write(data, entry.packet->Length(), entry.packet->Timestamp())
+                != network::Stream::Error::kNone)
+            continue;
+
+        sent++;
+    }
+
+    std::lock_guard<std::mutex> lock(retransmission_mutex_);
+    retransmission_stats_.sent += sent;
+    retransmission_stats_.dropped += retransmissions_.size() - sent;
+
+    retransmissions_.clear();
+}
+
 int32_t RTPSender::LocalPort() const {
     return stream_->LocalPort();
 }
@@ -24,6 +24,7 @@
 #include <mutex>
 #include <condition_variable>
 #include <atomic>
+#include <vector>
 
 #include "ac/common/executable.h"
 
@@ -34,16 +35,38 @@
 #include "ac/video/senderreport.h"
 
 #include "ac/streaming/transportsender.h"
+#include "ac/streaming/fecencoder.h"
+#include "ac/streaming/rtcpreceiver.h"
 
 namespace ac {
 namespace streaming {
 
 class RTPSender : public TransportSender,
+                  public RTCPReceiver::Delegate,
                   public common::Executable {
 public:
+    // SSRC of the only RTP stream we send
+    static constexpr std::uint32_t kSourceID{0xdeadbeef};
+    // Number of sent packets kept around to answer NACKs. Needs to be a
+    // power of two to map sequence numbers directly onto it.
+    static constexpr std::uint32_t kRetransmissionHistorySize{1024};
+    // Sinks don't buffer long enough to make use of packets older than
+    // this, so resending them would only waste bandwidth.
+    static constexpr ac::TimestampUs kMaxRetransmissionAge{200000};
+
+    struct RetransmissionStatistics {
+        std::uint64_t requested{0};
+        std::uint64_t sent{0};
+        std::uint64_t dropped{0};
+    };
+
     RTPSender(const network::Stream::Ptr &stream, const video::SenderReport::Ptr &report);
     ~RTPSender();
 
+    // Sends parity packets over all outgoing packets through the given
+    // stream. Needs to be called before the sender is started.
+    bool EnableFEC(const network::Stream::Ptr &stream, const FECConfig &config);
+
     // From ac::streaming::TransportSender
     bool Queue(const ac::video::Buffer::Ptr &packets) override;
     int32_t LocalPort() const override;
@@ -54,13 +77,37 @@ public:
     bool Execute() override;
     std::string Name() const override;
 
+    // From ac::streaming::RTCPReceiver::Delegate
+    void OnPacketsLost(const std::vector<std::uint16_t> &sequence_numbers) override;
+
+    RetransmissionStatistics Retransmissions();
+
 private:
+    struct HistoryEntry {
+        video::Buffer::Ptr packet;
+        ac::TimestampUs sent_at;
+    };
+
+    void SendRetransmissions();
+
+    void SendParity(const video::Buffer::Ptr &packet);
+
     network::Stream::Ptr stream_;
     const std::uint32_t max_ts_packets_;
     video::SenderReport::Ptr report_;
     uint16_t rtp_sequence_number_;
     ac::video::BufferQueue::Ptr queue_;
     std::atomic<bool> network_error_;
+    network::Stream::Ptr fec_stream_;
+    FECEncoder::Ptr fec_encoder_;
+    std::vector<video::Buffer::Ptr> parity_;
+    // Only touched by the sending thread. Holds the very buffers we
+    // sent so remembering them doesn't copy anything.
+    std::vector<HistoryEntry> history_;
+    std::mutex retransmission_mutex_;
+    std::vector<std::uint16_t> pending_retransmissions_;
+    std::vector<std::uint16_t> retransmissions_;
+    RetransmissionStatistics retransmission_stats_;
 };
 
 } // namespace streaming
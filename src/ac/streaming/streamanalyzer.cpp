@@ -0,0 +1,347 @@
+/*
+ * Copyright (C) 2016 Canonical, Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 3, as published
+ * by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranties of
+ * MERCHANTABILITY, SATISFACTORY QUALITY, or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <cmath>
+
+#include "ac/streaming/streamanalyzer.h"
+
+namespace {
+static constexpr unsigned int kRTPHeaderSize{12};
+static constexpr unsigned int kRTPVersion{2};
+static constexpr unsigned int kMPEGTSPacketSize{188};
+static constexpr unsigned int kMPEGTSSyncByte{0x47};
+static constexpr unsigned int kPIDofPAT{0x0000};
+static constexpr unsigned int kPIDofNull{0x1fff};
+static constexpr unsigned int kTableIdPAT{0x00};
+static constexpr unsigned int kTableIdPMT{0x02};
+static constexpr unsigned int kH264StreamType{0x1b};
+static constexpr unsigned int kPCRFlag{0x10};
+static constexpr unsigned int kDiscontinuityFlag{0x80};
+static constexpr std::uint64_t kPCRClockRate{27};
+}
+
+namespace ac {
+namespace streaming {
+
+constexpr ac::TimestampUs StreamAnalyzer::kMaxTableInterval;
+
+StreamAnalyzer::Result::Result() :
+    rtp_packets(0),
+    rtp_lost_packets(0),
+    rtp_reordered_packets(0),
+    rtp_invalid_packets(0),
+    rtp_jitter(0.0),
+    ts_packets(0),
+    ts_sync_errors(0),
+    ts_continuity_errors(0),
+    psi_crc_errors(0),
+    pat_count(0),
+    pmt_count(0),
+    pcr_count(0),
+    max_pat_interval(0),
+    max_pmt_interval(0),
+    max_pcr_interval(0),
+    max_pcr_jitter(0),
+    pes_packets(0),
+    es_bytes(0) {
+}
+
+std::ostream& operator<<(std::ostream& out, const StreamAnalyzer::Result &rhs) {
+    return out << "rtp packets " << rhs.rtp_packets
+               << " lost " << rhs.rtp_lost_packets
+               << " reordered " << rhs.rtp_reordered_packets
+               << " invalid " << rhs.rtp_invalid_packets
+               << " jitter " << rhs.rtp_jitter << " us"
+               << " ts packets " << rhs.ts_packets
+               << " sync errors " << rhs.ts_sync_errors
+               << " continuity errors " << rhs.ts_continuity_errors
+               << " crc errors " << rhs.psi_crc_errors
+               << " pat " << rhs.pat_count << " (max interval " << rhs.max_pat_interval << " us)"
+               << " pmt " << rhs.pmt_count << " (max interval " << rhs.max_pmt_interval << " us)"
+               << " pcr " << rhs.pcr_count << " (max interval " << rhs.max_pcr_interval << " us"
+               << " max jitter " << rhs.max_pcr_jitter << " us)"
+               << " pes packets " << rhs.pes_packets
+               << " es bytes " << rhs.es_bytes;
+}
+
+StreamAnalyzer::PIDState::PIDState() :
+    continuity_counter(-1) {
+}
+
+StreamAnalyzer::StreamAnalyzer() :
+    expected_sequence_number_(-1),
+    have_transit_(false),
+    last_transit_(0),
+    pmt_pid_(-1),
+    pcr_pid_(-1),
+    video_pid_(-1),
+    last_pat_(0),
+    last_pmt_(0),
+    last_pcr_arrival_(0),
+    last_pcr_(0) {
+}
+
+StreamAnalyzer::~StreamAnalyzer() {
+}
+
+void StreamAnalyzer::SetElementaryStreamCallback(const ElementaryStreamCallback &callback) {
+    es_callback_ = callback;
+}
+
+void StreamAnalyzer::ProcessRTPPacket(const uint8_t *data, size_t size, const ac::TimestampUs &arrival) {
+    if (size < kRTPHeaderSize || (data[0] >> 6) != kRTPVersion) {
+        statistics_.rtp_invalid_packets++;
+        return;
+    }
+
+    statistics_.rtp_packets++;
+
+    const uint16_t sequence_number = (data[2] << 8) | data[3];
+    if (expected_sequence_number_ >= 0 && sequence_number != expected_sequence_number_) {
+        const uint16_t gap = sequence_number - expected_sequence_number_;
+        // Anything jumping backwards is a late or duplicated packet
+        // which we don't count as lost.
+        if (gap >= 0x8000) {
+            statistics_.rtp_reordered_packets++;
+            return;
+        }
+        statistics_.rtp_lost_packets += gap;
+    }
+    expected_sequence_number_ = static_cast<uint16_t>(sequence_number + 1);
+
+    // See RFC 3550, A.8
+    const uint32_t rtp_time = (data[4] << 24) | (data[5] << 16) | (data[6] << 8) | data[7];
+    const uint32_t arrival_time = (arrival * 9ll) / 100ll;
+    const std::int64_t transit = static_cast<int32_t>(arrival_time - rtp_time);
+    if (have_transit_) {
+        const double d = std::abs(transit - last_transit_) * 100.0 / 9.0;
+        statistics_.rtp_jitter += (d - statistics_.rtp_jitter) / 16.0;
+    }
+    last_transit_ = transit;
+    have_transit_ = true;
+
+    // Skip CSRC list and header extension if present
+    size_t offset = kRTPHeaderSize + (data[0] & 0x0f) * 4;
+    if (data[0] & 0x10) {
+        if (offset + 4 > size) {
+            statistics_.rtp_invalid_packets++;
+            return;
+        }
+        offset += 4 + ((data[offset + 2] << 8) | data[offset + 3]) * 4;
+    }
+
+    for (; offset + kMPEGTSPacketSize <= size; offset += kMPEGTSPacketSize)
+        ProcessTSPacket(data + offset, arrival);
+}
+
+void StreamAnalyzer::ProcessTSPacket(const uint8_t *packet, const ac::TimestampUs &arrival) {
+    statistics_.ts_packets++;
+
+    if (packet[0] != kMPEGTSSyncByte) {
+        statistics_.ts_sync_errors++;
+        return;
+    }
+
+    const bool unit_start = packet[1] & 0x40;
+    const unsigned int pid = ((packet[1] & 0x1f) << 8) | packet[2];
+    const unsigned int adaptation_field_control = (packet[3] >> 4) & 0x3;
+    const int continuity_counter = packet[3] & 0x0f;
+    const bool has_payload = adaptation_field_control & 0x1;
+
+    if (pid == kPIDofNull)
+        return;
+
+    size_t offset = 4;
+    bool discontinuity = false;
+
+    if (adaptation_field_control & 0x2) {
+        const size_t length = packet[4];
+        if (5 + length > kMPEGTSPacketSize) {
+            statistics_.ts_sync_errors++;
+            return;
+        }
+
+        if (length > 0) {
+            discontinuity = packet[5] & kDiscontinuityFlag;
+            if (static_cast<int>(pid) == pcr_pid_ || pcr_pid_ < 0)
+                ProcessPCR(packet + 5, length, arrival);
+        }
+
+        offset += 1 + length;
+    }
+
+    // The continuity counter only increments with packets carrying
+    // payload; a single duplicate of the last packet is allowed.
+    auto &state = pids_[pid];
+    if (has_payload) {
+        if (state.continuity_counter >= 0 && !discontinuity &&
+                continuity_counter != ((state.continuity_counter + 1) & 0x0f) &&
+                continuity_counter != state.continuity_counter)
+            statistics_.ts_continuity_errors++;
+
+        state.continuity_counter = continuity_counter;
+    }
+
+    if (!has_payload || offset >= kMPEGTSPacketSize)
+        return;
+
+    const uint8_t *payload = packet + offset;
+    const size_t payload_size = kMPEGTSPacketSize - offset;
+
+    if (pid == kPIDofPAT || static_cast<int>(pid) == pmt_pid_) {
+        if (!unit_start)
+            return;
+
+        // Skip the pointer field
+        const size_t pointer = payload[0];
+        if (1 + pointer >= payload_size)
+            return;
+
+        if (pid == kPIDofPAT)
+            ProcessPAT(payload + 1 + pointer, payload_size - 1 - pointer, arrival);
+        else
+            ProcessPMT(payload + 1 + pointer, payload_size - 1 - pointer, arrival);
+    }
+    else if (static_cast<int>(pid) == video_pid_) {
+        ProcessPES(payload, payload_size, unit_start);
+    }
+}
+
+bool StreamAnalyzer::CheckSection(const uint8_t *section, size_t size, size_t *section_size) {
+    if (size < 3)
+        return false;
+
+    *section_size = 3 + (((section[1] & 0x0f) << 8) | section[2]);
+    // Sections spanning multiple packets are not used by any sender
+    // we deal with.
+    if (*section_size > size || *section_size < 12)
+        return false;
+
+    // Running the CRC over the section including its CRC yields zero
+    if (crc_.Calculate(section, *section_size) != 0) {
+        statistics_.psi_crc_errors++;
+        return false;
+    }
+
+    return true;
+}
+
+void StreamAnalyzer::ProcessPAT(const uint8_t *section, size_t size, const ac::TimestampUs &arrival) {
+    size_t section_size = 0;
+    if (section[0] != kTableIdPAT || !CheckSection(section, size, &section_size))
+        return;
+
+    statistics_.pat_count++;
+    if (last_pat_ > 0)
+        statistics_.max_pat_interval = std::max(statistics_.max_pat_interval, arrival - last_pat_);
+    last_pat_ = arrival;
+
+    // Program loop sits between the header and the CRC
+    for (size_t offset = 8; offset + 4 + 4 <= section_size; offset += 4) {
+        const unsigned int program_number = (section[offset] << 8) | section[offset + 1];
+        // Program zero points to the network information table
+        if (program_number == 0)
+            continue;
+
+        pmt_pid_ = ((section[offset + 2] & 0x1f) << 8) | section[offset + 3];
+        break;
+    }
+}
+
+void StreamAnalyzer::ProcessPMT(const uint8_t *section, size_t size, const ac::TimestampUs &arrival) {
+    size_t section_size = 0;
+    if (section[0] != kTableIdPMT || !CheckSection(section, size, &section_size))
+        return;
+
+    statistics_.pmt_count++;
+    if (last_pmt_ > 0)
+        statistics_.max_pmt_interval = std::max(statistics_.max_pmt_interval, arrival - last_pmt_);
+    last_pmt_ = arrival;
+
+    pcr_pid_ = ((section[8] & 0x1f) << 8) | section[9];
+
+    const size_t program_info_length = ((section[10] & 0x0f) << 8) | section[11];
+
+    for (size_t offset = 12 + program_info_length; offset + 5 + 4 <= section_size;) {
+        const unsigned int stream_type = section[offset];
+        const unsigned int pid = ((section[offset + 1] & 0x1f) << 8) | section[offset + 2];
+        const size_t es_info_length = ((section[offset + 3] & 0x0f) << 8) | section[offset + 4];
+
+        if (stream_type == kH264StreamType) {
+            video_pid_ = pid;
+            break;
+        }
+
+        offset += 5 + es_info_length;
+    }
+}
+
+void StreamAnalyzer::ProcessPCR(const uint8_t *adaptation_field, size_t size, const ac::TimestampUs &arrival) {
+    if (size < 7 || !(adaptation_field[0] & kPCRFlag))
+        return;
+
+    const uint8_t *ptr = adaptation_field + 1;
+    const uint64_t base = (static_cast<uint64_t>(ptr[0]) << 25) |
+                          (static_cast<uint64_t>(ptr[1]) << 17) |
+                          (static_cast<uint64_t>(ptr[2]) << 9) |
+                          (static_cast<uint64_t>(ptr[3]) << 1) |
+                          (ptr[4] >> 7);
+    const uint64_t extension = ((ptr[4] & 0x01) << 8) | ptr[5];
+    const uint64_t pcr = base * 300 + extension;
+
+    statistics_.pcr_count++;
+
+    if (last_pcr_arrival_ > 0) {
+        const ac::TimestampUs arrival_delta = arrival - last_pcr_arrival_;
+        const ac::TimestampUs pcr_delta = (pcr - last_pcr_) / kPCRClockRate;
+
+        statistics_.max_pcr_interval = std::max(statistics_.max_pcr_interval, arrival_delta);
+        statistics_.max_pcr_jitter = std::max(statistics_.max_pcr_jitter,
+                                              std::abs(pcr_delta - arrival_delta));
+    }
+
+    last_pcr_ = pcr;
+    last_pcr_arrival_ = arrival;
+}
+
+void StreamAnalyzer::ProcessPES(const uint8_t *payload, size_t size, bool unit_start) {
+    if (unit_start) {
+        if (size < 9 || payload[0] != 0x00 || payload[1] != 0x00 || payload[2] != 0x01)
+            return;
+
+        const size_t header_size = 9 + payload[8];
+        if (header_size > size)
+            return;
+
+        statistics_.pes_packets++;
+
+        payload += header_size;
+        size -= header_size;
+    }
+
+    statistics_.es_bytes += size;
+
+    if (es_callback_ && size > 0)
+        es_callback_(payload, size);
+}
+
+StreamAnalyzer::Result StreamAnalyzer::Statistics() const {
+    return statistics_;
+}
+
+} // namespace streaming
+} // namespace ac
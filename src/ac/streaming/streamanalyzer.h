@@ -0,0 +1,123 @@
+/*
+ * Copyright (C) 2016 Canonical, Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 3, as published
+ * by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranties of
+ * MERCHANTABILITY, SATISFACTORY QUALITY, or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef AC_STREAMING_STREAMANALYZER_H_
+#define AC_STREAMING_STREAMANALYZER_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <ostream>
+
+#include "ac/utils.h"
+
+#include "ac/streaming/crc32.h"
+
+namespace ac {
+namespace streaming {
+
+// Consumes what a sink receives from us, RTP datagrams carrying MPEG-TS
+// packets, and checks it for everything a sink would stumble over.
+// All intervals are measured on the arrival time of the packets.
+class StreamAnalyzer {
+public:
+    // The WiFi Display spec requires PAT, PMT and PCR to be repeated
+    // at least this often.
+    static constexpr ac::TimestampUs kMaxTableInterval{100000};
+
+    typedef std::function<void(const uint8_t *data, size_t size)> ElementaryStreamCallback;
+
+    class Result {
+    public:
+        Result();
+
+        std::uint64_t rtp_packets;
+        std::uint64_t rtp_lost_packets;
+        std::uint64_t rtp_reordered_packets;
+        std::uint64_t rtp_invalid_packets;
+        // Interarrival jitter as defined in RFC 3550 in micro-seconds
+        double rtp_jitter;
+
+        std::uint64_t ts_packets;
+        std::uint64_t ts_sync_errors;
+        std::uint64_t ts_continuity_errors;
+        std::uint64_t psi_crc_errors;
+
+        std::uint64_t pat_count;
+        std::uint64_t pmt_count;
+        std::uint64_t pcr_count;
+        ac::TimestampUs max_pat_interval;
+        ac::TimestampUs max_pmt_interval;
+        ac::TimestampUs max_pcr_interval;
+        // Largest difference between the time passed according to two
+        // consecutive PCRs and the time passed between their arrival.
+        ac::TimestampUs max_pcr_jitter;
+
+        std::uint64_t pes_packets;
+        std::uint64_t es_bytes;
+    };
+
+    StreamAnalyzer();
+    ~StreamAnalyzer();
+
+    // Called with the payload of every PES packet of the first video
+    // stream of the program.
+    void SetElementaryStreamCallback(const ElementaryStreamCallback &callback);
+
+    void ProcessRTPPacket(const uint8_t *data, size_t size, const ac::TimestampUs &arrival);
+    void ProcessTSPacket(const uint8_t *packet, const ac::TimestampUs &arrival);
+
+    Result Statistics() const;
+
+private:
+    struct PIDState {
+        PIDState();
+
+        int continuity_counter;
+    };
+
+    void ProcessPAT(const uint8_t *section, size_t size, const ac::TimestampUs &arrival);
+    void ProcessPMT(const uint8_t *section, size_t size, const ac::TimestampUs &arrival);
+    void ProcessPCR(const uint8_t *adaptation_field, size_t size, const ac::TimestampUs &arrival);
+    void ProcessPES(const uint8_t *payload, size_t size, bool unit_start);
+    bool CheckSection(const uint8_t *section, size_t size, size_t *section_size);
+
+    Crc32 crc_;
+    ElementaryStreamCallback es_callback_;
+    Result statistics_;
+    std::map<unsigned int, PIDState> pids_;
+
+    int expected_sequence_number_;
+    bool have_transit_;
+    std::int64_t last_transit_;
+
+    int pmt_pid_;
+    int pcr_pid_;
+    int video_pid_;
+    ac::TimestampUs last_pat_;
+    ac::TimestampUs last_pmt_;
+    ac::TimestampUs last_pcr_arrival_;
+    std::uint64_t last_pcr_;
+};
+
+std::ostream& operator<<(std::ostream& out, const StreamAnalyzer::Result &rhs);
+
+} // namespace streaming
+} // namespace ac
+
+#endif
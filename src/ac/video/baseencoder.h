@@ -92,6 +92,10 @@ public:
 
     virtual bool Configure(const Config &config) = 0;
 
+    // Drops the current configuration so that the encoder can be
+    // configured again. Only possible while it isn't running.
+    virtual bool Reset() { return false; }
+
     virtual void QueueBuffer(const ac::video::Buffer::Ptr &buffer) = 0;
 
     virtual Config Configuration() const = 0;
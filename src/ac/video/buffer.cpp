@@ -47,6 +47,7 @@ Buffer::Buffer() :
     offset_(0),
     data_(nullptr),
     timestamp_(0),
+    frame_number_(0),
     native_handle_(nullptr) {
 }
 
@@ -56,6 +57,7 @@ Buffer::Buffer(int64_t timestamp) :
     offset_(0),
     data_(nullptr),
     timestamp_(timestamp),
+    frame_number_(0),
     native_handle_(nullptr) {
 }
 
@@ -85,6 +87,10 @@ void Buffer::SetTimestamp(int64_t timestamp) {
     timestamp_ = timestamp;
 }
 
+void Buffer::SetFrameNumber(const video::FrameNumber &frame) {
+    frame_number_ = frame;
+}
+
 void Buffer::Allocate(uint32_t capacity) {
     if (data_)
         return;
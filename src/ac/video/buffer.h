@@ -18,6 +18,7 @@
 #ifndef AC_VIDEO_BUFFER_H_
 #define AC_VIDEO_BUFFER_H_
 
+#include <cstdint>
 #include <memory>
 
 #include "ac/non_copyable.h"
@@ -28,6 +29,12 @@ namespace video {
 
 class BufferOutputTarget;
 
+// Sequence number of a captured frame. Every buffer derived from a
+// frame, down to the single datagrams we send out, carries the same
+// number so all stages of the pipeline can be correlated. Zero means
+// the buffer doesn't belong to any frame.
+typedef std::uint64_t FrameNumber;
+
 class Buffer : public std::enable_shared_from_this<Buffer> {
 public:
     typedef std::shared_ptr<Buffer> Ptr;
@@ -45,6 +52,7 @@ public:
 
     void SetRange(uint32_t offset, uint32_t length);
     void SetTimestamp(int64_t timestamp);
+    void SetFrameNumber(const video::FrameNumber &frame);
 
     virtual uint32_t Capacity() const { return capacity_; }
     virtual uint32_t Offset() const { return offset_; }
@@ -52,6 +60,7 @@ public:
     virtual uint8_t* Data() { return data_ + offset_; }
     // Timestamp of the buffer in micro-seconds
     virtual ac::TimestampUs Timestamp() const { return timestamp_; }
+    virtual video::FrameNumber FrameNumber() const { return frame_number_; }
 
     virtual bool IsValid() const { return data_ != nullptr || native_handle_ != nullptr; }
 
@@ -74,6 +83,7 @@ private:
     uint32_t offset_;
     uint8_t *data_;
     int64_t timestamp_;
+    video::FrameNumber frame_number_;
     void *native_handle_;
 
     friend class BufferOutputTarget;
@@ -18,9 +18,11 @@
 #ifndef AC_VIDEO_BUFFERPRODUCER_H_
 #define AC_VIDEO_BUFFERPRODUCER_H_
 
+#include <functional>
 #include <memory>
 
 #include "ac/non_copyable.h"
+#include "ac/utils.h"
 
 #include "ac/video/displayoutput.h"
 
@@ -30,13 +32,38 @@ namespace video {
 class BufferProducer : public ac::NonCopyable {
 public:
     typedef std::shared_ptr<BufferProducer> Ptr;
+    // Called with false if no new buffer is coming
+    typedef std::function<void(bool success)> SwapCallback;
 
     virtual ~BufferProducer() { }
 
+    // Does all the work not depending on the output configuration
+    // ahead of Setup(). Can be called from any thread but must not
+    // run concurrently with Setup().
+    virtual bool Prepare() { return true; }
     virtual bool Setup(const video::DisplayOutput &output) = 0;
     virtual void SwapBuffers() = 0;
+    // Starts swapping buffers without waiting for the new buffer to
+    // be ready. The callback is invoked, possibly from a different
+    // thread, once CurrentBuffer() returns the new buffer or the swap
+    // failed. It is called exactly once in any case. Producers without
+    // native support for this just swap synchronously.
+    virtual void SwapBuffersAsync(const SwapCallback &callback) {
+        SwapBuffers();
+        callback(true);
+    }
     virtual void* CurrentBuffer() const = 0;
     virtual DisplayOutput OutputMode() const = 0;
+
+    // Presentation timestamp of the current buffer on the monotonic
+    // clock in microseconds. Producers not able to supply one return
+    // zero and the consumer has to come up with a timestamp itself.
+    virtual ac::TimestampUs CurrentBufferTimestamp() const { return 0; }
+
+    // Whether the content of the current buffer differs from the one
+    // of the previous buffer. Producers without any knowledge about
+    // damaged regions always report a change.
+    virtual bool CurrentBufferChanged() const { return true; }
 };
 
 } // namespace video
@@ -24,6 +24,8 @@
 
 #include "ac/utils.h"
 
+#include "ac/video/buffer.h"
+
 namespace ac {
 namespace video {
 
@@ -33,9 +35,13 @@ public:
 
     virtual void Started() = 0;
     virtual void Stopped() = 0;
-    virtual void BeganFrame(const ac::TimestampUs &timestamp) = 0;
-    virtual void FinishedFrame(const ac::TimestampUs &timestamp) = 0;
-    virtual void ReceivedInputBuffer(const ac::TimestampUs &timestamp) = 0;
+    virtual void BeganFrame(const FrameNumber &frame, const ac::TimestampUs &timestamp) = 0;
+    virtual void FinishedFrame(const FrameNumber &frame, const ac::TimestampUs &timestamp) = 0;
+    virtual void ReceivedInputBuffer(const FrameNumber &frame, const ac::TimestampUs &timestamp) = 0;
+    virtual void RequestedIDRFrame() = 0;
+    // An IDR frame was actually requested from the encoder. Several
+    // requests may end up in a single or no IDR frame at all.
+    virtual void EmittedIDRFrame() = 0;
 };
 
 } // namespace video
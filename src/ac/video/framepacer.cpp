@@ -0,0 +1,124 @@
+/*
+ * Copyright (C) 2016 Canonical, Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 3, as published
+ * by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranties of
+ * MERCHANTABILITY, SATISFACTORY QUALITY, or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <errno.h>
+#include <time.h>
+
+#include <limits>
+#include <ratio>
+
+#include "ac/video/framepacer.h"
+
+namespace {
+// Lateness of up to 1ms is put into the first bucket and every
+// following bucket doubles the limit. The last one takes everything.
+static constexpr ac::TimestampUs kFirstLatenessBucketLimit{1000};
+}
+
+namespace ac {
+namespace video {
+
+constexpr std::size_t FramePacer::kNumLatenessBuckets;
+
+FramePacer::FramePacer(const ac::TimestampUs &interval) :
+    interval_(interval),
+    deadline_(0),
+    skipped_frames_(0) {
+    Reset();
+}
+
+void FramePacer::Reset() {
+    deadline_ = 0;
+    skipped_frames_ = 0;
+    for (auto &bucket : lateness_)
+        bucket = 0;
+}
+
+ac::TimestampUs FramePacer::FrameProduced(const ac::TimestampUs &now) {
+    if (deadline_ == 0)
+        deadline_ = now;
+
+    const ac::TimestampUs lateness = now > deadline_ ? now - deadline_ : 0;
+
+    std::size_t bucket = 0;
+    while (bucket < kNumLatenessBuckets - 1 && lateness > LatenessBucketLimit(bucket))
+        bucket++;
+
+    lateness_[bucket]++;
+
+    return lateness;
+}
+
+std::uint32_t FramePacer::WaitForNextFrame() {
+    if (interval_ <= 0)
+        return 0;
+
+    const ac::TimestampUs now = ac::Utils::GetNowUs();
+
+    if (deadline_ == 0)
+        deadline_ = now;
+
+    deadline_ += interval_;
+
+    std::uint32_t skipped = 0;
+
+    // Being late by less than a full interval is fine and we start the
+    // next frame right away. Everything beyond that can't be made up
+    // for anymore so we drop those frames and stay on our schedule.
+    if (now > deadline_) {
+        skipped = (now - deadline_) / interval_;
+        deadline_ += skipped * interval_;
+        skipped_frames_ += skipped;
+    }
+
+    struct timespec ts;
+    ts.tv_sec = deadline_ / std::micro::den;
+    ts.tv_nsec = (deadline_ % std::micro::den) * 1000;
+
+    while (::clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, nullptr) == EINTR);
+
+    return skipped;
+}
+
+ac::TimestampUs FramePacer::Interval() const {
+    return interval_;
+}
+
+ac::TimestampUs FramePacer::NextDeadline() const {
+    return deadline_;
+}
+
+std::uint64_t FramePacer::SkippedFrames() const {
+    return skipped_frames_;
+}
+
+FramePacer::LatenessHistogram FramePacer::Lateness() const {
+    LatenessHistogram histogram;
+    for (std::size_t n = 0; n < kNumLatenessBuckets; n++)
+        histogram[n] = lateness_[n];
+    return histogram;
+}
+
+ac::TimestampUs FramePacer::LatenessBucketLimit(std::size_t bucket) {
+    if (bucket >= kNumLatenessBuckets - 1)
+        return std::numeric_limits<ac::TimestampUs>::max();
+
+    return kFirstLatenessBucketLimit << bucket;
+}
+
+} // namespace video
+} // namespace ac
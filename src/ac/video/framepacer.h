@@ -0,0 +1,78 @@
+/*
+ * Copyright (C) 2016 Canonical, Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 3, as published
+ * by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranties of
+ * MERCHANTABILITY, SATISFACTORY QUALITY, or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef AC_VIDEO_FRAMEPACER_H_
+#define AC_VIDEO_FRAMEPACER_H_
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+#include "ac/non_copyable.h"
+#include "ac/utils.h"
+
+namespace ac {
+namespace video {
+
+// FramePacer schedules frames against absolute deadlines on the
+// monotonic clock. As every deadline is derived from the first one
+// the time spent for a single frame doesn't accumulate into a drift
+// of the overall frame rate.
+class FramePacer : public ac::NonCopyable {
+public:
+    static constexpr std::size_t kNumLatenessBuckets{8};
+
+    // Number of frames with a lateness up to the limit of the
+    // bucket. See LatenessBucketLimit for the actual limits.
+    typedef std::array<std::uint64_t, kNumLatenessBuckets> LatenessHistogram;
+
+    explicit FramePacer(const ac::TimestampUs &interval);
+
+    // Forget about all previous deadlines. The next frame will be
+    // the first one of a new schedule.
+    void Reset();
+
+    // Records how late a frame produced at the given time was in
+    // relation to its deadline and returns that lateness. The time has
+    // to be taken from the monotonic clock like the deadlines are, a
+    // presentation timestamp from another clock can't be used here.
+    ac::TimestampUs FrameProduced(const ac::TimestampUs &now);
+
+    // Blocks until the deadline of the next frame is reached. If we're
+    // already behind by one or more frame intervals those frames are
+    // skipped and the number of skipped frames is returned.
+    std::uint32_t WaitForNextFrame();
+
+    ac::TimestampUs Interval() const;
+    ac::TimestampUs NextDeadline() const;
+    std::uint64_t SkippedFrames() const;
+    LatenessHistogram Lateness() const;
+
+    // Upper limit of the lateness in microseconds for the given bucket.
+    static ac::TimestampUs LatenessBucketLimit(std::size_t bucket);
+
+private:
+    const ac::TimestampUs interval_;
+    ac::TimestampUs deadline_;
+    std::atomic<std::uint64_t> skipped_frames_;
+    std::array<std::atomic<std::uint64_t>, kNumLatenessBuckets> lateness_;
+};
+
+} // namespace video
+} // namespace ac
+
+#endif
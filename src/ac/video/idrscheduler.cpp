@@ -0,0 +1,102 @@
+/*
+ * Copyright (C) 2016 Canonical, Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 3, as published
+ * by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranties of
+ * MERCHANTABILITY, SATISFACTORY QUALITY, or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "ac/video/idrscheduler.h"
+
+namespace ac {
+namespace video {
+
+constexpr ac::TimestampUs IdrScheduler::kDefaultMinInterval;
+
+IdrScheduler::IdrScheduler(const ac::TimestampUs &min_interval) :
+    min_interval_(min_interval),
+    refresh_period_(0),
+    last_emitted_(-1),
+    pending_(false) {
+}
+
+void IdrScheduler::SetRefreshPeriod(const ac::TimestampUs &period) {
+    std::lock_guard<std::mutex> l(mutex_);
+    refresh_period_ = period;
+}
+
+bool IdrScheduler::Request(const ac::TimestampUs &now) {
+    std::lock_guard<std::mutex> l(mutex_);
+
+    stats_.requested++;
+
+    if (pending_) {
+        stats_.coalesced++;
+        return false;
+    }
+
+    if (last_emitted_ < 0 || now - last_emitted_ >= min_interval_) {
+        Emit(now);
+        return true;
+    }
+
+    // No need to wait for the next IDR frame when the sweep has
+    // repaired the picture before we are allowed to send it.
+    if (refresh_period_ > 0 && now + refresh_period_ <= last_emitted_ + min_interval_) {
+        stats_.substituted++;
+        return false;
+    }
+
+    pending_ = true;
+
+    return false;
+}
+
+bool IdrScheduler::Poll(const ac::TimestampUs &now) {
+    std::lock_guard<std::mutex> l(mutex_);
+
+    if (!pending_ || now - last_emitted_ < min_interval_)
+        return false;
+
+    pending_ = false;
+    Emit(now);
+
+    return true;
+}
+
+void IdrScheduler::Reset() {
+    std::lock_guard<std::mutex> l(mutex_);
+    last_emitted_ = -1;
+    pending_ = false;
+}
+
+ac::TimestampUs IdrScheduler::MinInterval() const {
+    return min_interval_;
+}
+
+ac::TimestampUs IdrScheduler::RefreshPeriod() const {
+    std::lock_guard<std::mutex> l(mutex_);
+    return refresh_period_;
+}
+
+IdrScheduler::Statistics IdrScheduler::Stats() const {
+    std::lock_guard<std::mutex> l(mutex_);
+    return stats_;
+}
+
+void IdrScheduler::Emit(const ac::TimestampUs &now) {
+    last_emitted_ = now;
+    stats_.emitted++;
+}
+
+} // namespace video
+} // namespace ac
@@ -0,0 +1,86 @@
+/*
+ * Copyright (C) 2016 Canonical, Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 3, as published
+ * by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranties of
+ * MERCHANTABILITY, SATISFACTORY QUALITY, or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef AC_VIDEO_IDRSCHEDULER_H_
+#define AC_VIDEO_IDRSCHEDULER_H_
+
+#include <cstdint>
+#include <mutex>
+
+#include "ac/non_copyable.h"
+#include "ac/utils.h"
+
+namespace ac {
+namespace video {
+
+// IdrScheduler decides when requested IDR frames are actually sent.
+// Sinks tend to ask for them in bursts and every IDR frame causes a
+// spike of the bitrate. The first request is served right away, all
+// following within the minimum interval are coalesced into a single
+// IDR frame sent once the interval is over. If the encoder refreshes
+// the picture with a gradual intra refresh sweep faster than that the
+// request is dropped and the sweep repairs the picture instead.
+class IdrScheduler : public ac::NonCopyable {
+public:
+    static constexpr ac::TimestampUs kDefaultMinInterval{500000};
+
+    struct Statistics {
+        std::uint64_t requested = 0;
+        std::uint64_t emitted = 0;
+        // Requests served by an IDR frame already pending
+        std::uint64_t coalesced = 0;
+        // Requests left to the intra refresh sweep
+        std::uint64_t substituted = 0;
+    };
+
+    // Zero serves every request right away
+    explicit IdrScheduler(const ac::TimestampUs &min_interval = kDefaultMinInterval);
+
+    // Time the encoder needs for a full intra refresh sweep of the
+    // picture. Zero if it doesn't refresh gradually.
+    void SetRefreshPeriod(const ac::TimestampUs &period);
+
+    // Returns true if an IDR frame has to be sent right away.
+    bool Request(const ac::TimestampUs &now = ac::Utils::GetNowUs());
+
+    // Returns true if a deferred IDR frame is due now. Meant to be
+    // called once per frame.
+    bool Poll(const ac::TimestampUs &now = ac::Utils::GetNowUs());
+
+    // Drops a pending IDR frame and forgets when the last one was sent.
+    void Reset();
+
+    ac::TimestampUs MinInterval() const;
+    ac::TimestampUs RefreshPeriod() const;
+    Statistics Stats() const;
+
+private:
+    void Emit(const ac::TimestampUs &now);
+
+private:
+    mutable std::mutex mutex_;
+    const ac::TimestampUs min_interval_;
+    ac::TimestampUs refresh_period_;
+    ac::TimestampUs last_emitted_;
+    bool pending_;
+    Statistics stats_;
+};
+
+} // namespace video
+} // namespace ac
+
+#endif
@@ -0,0 +1,44 @@
+/*
+ * Copyright (C) 2016 Canonical, Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 3, as published
+ * by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranties of
+ * MERCHANTABILITY, SATISFACTORY QUALITY, or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef AC_VIDEO_NULLBUFFERPRODUCER_H_
+#define AC_VIDEO_NULLBUFFERPRODUCER_H_
+
+#include "ac/video/bufferproducer.h"
+
+namespace ac {
+namespace video {
+
+// Hands out empty buffers for pipelines where the encoder brings its
+// own content, like the ReplayEncoder does.
+class NullBufferProducer : public BufferProducer {
+public:
+    NullBufferProducer();
+
+    bool Setup(const video::DisplayOutput &output) override;
+    void SwapBuffers() override;
+    void* CurrentBuffer() const override;
+    DisplayOutput OutputMode() const override;
+
+private:
+    DisplayOutput output_;
+};
+
+} // namespace video
+} // namespace ac
+
+#endif
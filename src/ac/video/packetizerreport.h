@@ -24,6 +24,8 @@
 
 #include "ac/utils.h"
 
+#include "ac/video/buffer.h"
+
 namespace ac {
 namespace video {
 
@@ -31,7 +33,7 @@ class PacketizerReport : public ac::NonCopyable {
 public:
     typedef std::shared_ptr<PacketizerReport> Ptr;
 
-    virtual void PacketizedFrame(const ac::TimestampUs &timestamp) = 0;
+    virtual void PacketizedFrame(const FrameNumber &frame, const ac::TimestampUs &timestamp) = 0;
 };
 
 } // namespace video
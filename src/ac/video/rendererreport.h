@@ -24,6 +24,8 @@
 
 #include "ac/utils.h"
 
+#include "ac/video/buffer.h"
+
 namespace ac {
 namespace video {
 
@@ -32,7 +34,12 @@ public:
     typedef std::shared_ptr<RendererReport> Ptr;
 
     virtual void BeganFrame() = 0;
-    virtual void FinishedFrame(const ac::TimestampUs &timestamp) = 0;
+    virtual void FinishedFrame(const FrameNumber &frame, const ac::TimestampUs &timestamp) = 0;
+    // A frame wasn't send to the encoder as its content didn't change
+    virtual void UnchangedFrame(const ac::TimestampUs &timestamp) = 0;
+    virtual void SkippedFrames(const unsigned int &count) = 0;
+    // How late a frame was produced compared to its deadline
+    virtual void FrameLateness(const ac::TimestampUs &lateness) = 0;
 };
 
 } // namespace video
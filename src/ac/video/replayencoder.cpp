@@ -0,0 +1,332 @@
+/*
+ * Copyright (C) 2016 Canonical, Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 3, as published
+ * by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranties of
+ * MERCHANTABILITY, SATISFACTORY QUALITY, or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <chrono>
+#include <condition_variable>
+#include <cstring>
+#include <mutex>
+
+#include "ac/logger.h"
+
+#include "ac/video/replayencoder.h"
+#include "ac/video/utils.h"
+
+namespace {
+static constexpr const char *kReplayEncoderThreadName{"ReplayEncoder"};
+static constexpr unsigned int kNalTypeIDR{5};
+static constexpr std::chrono::milliseconds kWaitForBuffersTimeout{10};
+}
+
+namespace ac {
+namespace video {
+
+constexpr int ReplayEncoder::kDefaultFramerate;
+constexpr std::uint32_t ReplayEncoder::kMaxBuffersInFlight;
+
+// Keeps the file mapped for as long as any buffer pointing into it
+// is still alive and tracks how many of those are around.
+class ReplayEncoder::Mapping {
+public:
+    static std::shared_ptr<Mapping> Create(const std::string &path) {
+        const int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) {
+            AC_ERROR("Failed to open %s: %s (%d)", path, ::strerror(errno), errno);
+            return nullptr;
+        }
+
+        struct stat st;
+        if (::fstat(fd, &st) < 0 || st.st_size == 0) {
+            AC_ERROR("Failed to determine size of %s", path);
+            ::close(fd);
+            return nullptr;
+        }
+
+        void *data = ::mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        ::close(fd);
+
+        if (data == MAP_FAILED) {
+            AC_ERROR("Failed to map %s: %s (%d)", path, ::strerror(errno), errno);
+            return nullptr;
+        }
+
+        return std::shared_ptr<Mapping>(new Mapping(static_cast<uint8_t*>(data), st.st_size));
+    }
+
+    ~Mapping() {
+        ::munmap(data_, size_);
+    }
+
+    uint8_t* Data() const { return data_; }
+    std::size_t Size() const { return size_; }
+
+    void Acquire() {
+        std::lock_guard<std::mutex> l(mutex_);
+        in_flight_++;
+    }
+
+    void Release() {
+        {
+            std::lock_guard<std::mutex> l(mutex_);
+            in_flight_--;
+        }
+        cv_.notify_all();
+    }
+
+    bool WaitForInFlightBelow(std::uint32_t limit, const std::chrono::milliseconds &timeout) {
+        std::unique_lock<std::mutex> l(mutex_);
+        return cv_.wait_for(l, timeout, [&]() { return in_flight_ < limit; });
+    }
+
+private:
+    Mapping(uint8_t *data, std::size_t size) :
+        data_(data),
+        size_(size),
+        in_flight_(0) {
+    }
+
+    uint8_t *data_;
+    std::size_t size_;
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    std::uint32_t in_flight_;
+};
+
+// Read-only view on a single access unit inside the mapped file.
+class ReplayEncoder::AccessUnitBuffer : public Buffer {
+public:
+    static Buffer::Ptr Create(const std::shared_ptr<Mapping> &mapping, const AccessUnit &unit) {
+        return std::shared_ptr<AccessUnitBuffer>(new AccessUnitBuffer(mapping, unit));
+    }
+
+    ~AccessUnitBuffer() {
+        mapping_->Release();
+    }
+
+    uint32_t Capacity() const override { return size_; }
+    uint32_t Offset() const override { return 0; }
+    uint32_t Length() const override { return size_; }
+    uint8_t* Data() override { return data_; }
+    bool IsValid() const override { return true; }
+
+private:
+    AccessUnitBuffer(const std::shared_ptr<Mapping> &mapping, const AccessUnit &unit) :
+        mapping_(mapping),
+        data_(mapping->Data() + unit.offset),
+        size_(unit.size) {
+        mapping_->Acquire();
+    }
+
+    std::shared_ptr<Mapping> mapping_;
+    uint8_t *data_;
+    uint32_t size_;
+};
+
+ReplayEncoder::Ptr ReplayEncoder::Create(const std::string &path, const EncoderReport::Ptr &report,
+                                         const Pace &pace, bool loop) {
+    const auto mapping = Mapping::Create(path);
+    if (!mapping)
+        return nullptr;
+
+    auto encoder = std::shared_ptr<ReplayEncoder>(new ReplayEncoder(mapping, report, pace, loop));
+    if (!encoder->Index()) {
+        AC_ERROR("No access units found in %s", path);
+        return nullptr;
+    }
+
+    AC_DEBUG("Replaying %d access units from %s", encoder->AccessUnits(), path);
+
+    return encoder;
+}
+
+ReplayEncoder::ReplayEncoder(const std::shared_ptr<Mapping> &mapping, const EncoderReport::Ptr &report,
+                             const Pace &pace, bool loop) :
+    mapping_(mapping),
+    report_(report),
+    pace_(pace),
+    loop_(loop),
+    config_(DefaultConfiguration()),
+    next_unit_(0),
+    frame_(0),
+    running_(false),
+    idr_requested_(false) {
+}
+
+ReplayEncoder::~ReplayEncoder() {
+    Stop();
+}
+
+bool ReplayEncoder::Index() {
+    const uint8_t *begin = mapping_->Data();
+    const uint8_t *data = begin;
+    size_t size = mapping_->Size();
+    const uint8_t *au_start = nullptr;
+    size_t au_size = 0;
+
+    while (GetNextAccessUnit(&data, &size, &au_start, &au_size)) {
+        AccessUnit unit{static_cast<std::size_t>(au_start - begin), au_size, false};
+
+        const uint8_t *nal_data = au_start;
+        size_t nal_data_size = au_size;
+        const uint8_t *nal_start = nullptr;
+        size_t nal_size = 0;
+
+        while (GetNextNALUnit(&nal_data, &nal_data_size, &nal_start, &nal_size, true)) {
+            if ((nal_start[0] & 0x1f) == kNalTypeIDR) {
+                unit.idr = true;
+                break;
+            }
+        }
+
+        access_units_.push_back(unit);
+    }
+
+    return access_units_.size() > 0;
+}
+
+std::size_t ReplayEncoder::AccessUnits() const {
+    return access_units_.size();
+}
+
+BaseEncoder::Config ReplayEncoder::DefaultConfiguration() {
+    Config config;
+    config.framerate = kDefaultFramerate;
+    return config;
+}
+
+bool ReplayEncoder::Configure(const BaseEncoder::Config &config) {
+    if (running_)
+        return false;
+
+    config_ = config;
+
+    if (config_.framerate <= 0)
+        config_.framerate = kDefaultFramerate;
+
+    return true;
+}
+
+bool ReplayEncoder::Reset() {
+    if (running_)
+        return false;
+
+    config_ = DefaultConfiguration();
+
+    return true;
+}
+
+void ReplayEncoder::QueueBuffer(const ac::video::Buffer::Ptr &buffer) {
+    // Content only comes from the file so whatever the renderer gives
+    // us goes straight back.
+    buffer->Release();
+}
+
+BaseEncoder::Config ReplayEncoder::Configuration() const {
+    return config_;
+}
+
+bool ReplayEncoder::Running() const {
+    return running_;
+}
+
+void ReplayEncoder::SendIDRFrame() {
+    report_->RequestedIDRFrame();
+    idr_requested_ = true;
+}
+
+bool ReplayEncoder::Start() {
+    if (running_)
+        return false;
+
+    pacer_.reset(new FramePacer(std::micro::den / config_.framerate));
+    running_ = true;
+
+    report_->Started();
+
+    return true;
+}
+
+bool ReplayEncoder::Stop() {
+    if (!running_.exchange(false))
+        return false;
+
+    report_->Stopped();
+
+    return true;
+}
+
+bool ReplayEncoder::Execute() {
+    if (!running_)
+        return false;
+
+    if (pace_ == Pace::kAsFastAsPossible &&
+            !mapping_->WaitForInFlightBelow(kMaxBuffersInFlight, kWaitForBuffersTimeout))
+        return true;
+
+    if (next_unit_ >= access_units_.size()) {
+        if (!loop_) {
+            AC_DEBUG("Reached end of replayed stream");
+            return false;
+        }
+        next_unit_ = 0;
+    }
+
+    // Sinks ask for an IDR frame when they lost track of the stream
+    // so we continue with the next one we have.
+    if (idr_requested_.exchange(false)) {
+        for (std::size_t n = 0; n < access_units_.size(); n++) {
+            const auto index = (next_unit_ + n) % access_units_.size();
+            if (access_units_[index].idr) {
+                next_unit_ = index;
+                report_->EmittedIDRFrame();
+                break;
+            }
+        }
+    }
+
+    const auto timestamp = ac::Utils::GetNowUs();
+    const auto frame = ++frame_;
+
+    report_->BeganFrame(frame, timestamp);
+
+    auto buffer = AccessUnitBuffer::Create(mapping_, access_units_[next_unit_++]);
+    buffer->SetTimestamp(timestamp);
+    buffer->SetFrameNumber(frame);
+
+    report_->FinishedFrame(frame, timestamp);
+
+    if (auto sp = delegate_.lock())
+        sp->OnBufferAvailable(buffer);
+
+    if (pace_ == Pace::kRealtime) {
+        pacer_->FrameProduced(timestamp);
+        pacer_->WaitForNextFrame();
+    }
+
+    return true;
+}
+
+std::string ReplayEncoder::Name() const {
+    return kReplayEncoderThreadName;
+}
+
+} // namespace video
+} // namespace ac
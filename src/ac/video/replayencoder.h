@@ -0,0 +1,108 @@
+/*
+ * Copyright (C) 2016 Canonical, Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 3, as published
+ * by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranties of
+ * MERCHANTABILITY, SATISFACTORY QUALITY, or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef AC_VIDEO_REPLAYENCODER_H_
+#define AC_VIDEO_REPLAYENCODER_H_
+
+#include <atomic>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "ac/video/baseencoder.h"
+#include "ac/video/encoderreport.h"
+#include "ac/video/framepacer.h"
+
+namespace ac {
+namespace video {
+
+// Replays an already encoded H.264 Annex-B file instead of encoding
+// anything. The file is mapped into memory and its access units are
+// handed out without copying them. Buffers queued by the renderer are
+// returned right away as the content comes from the file only.
+class ReplayEncoder : public BaseEncoder {
+public:
+    typedef std::shared_ptr<ReplayEncoder> Ptr;
+
+    enum class Pace {
+        // One access unit per frame interval of the configured framerate
+        kRealtime,
+        // As fast as the rest of the pipeline consumes them
+        kAsFastAsPossible
+    };
+
+    static constexpr int kDefaultFramerate{30};
+    // Number of access units we allow to be on their way through the
+    // pipeline when not pacing them.
+    static constexpr std::uint32_t kMaxBuffersInFlight{4};
+
+    static Ptr Create(const std::string &path, const EncoderReport::Ptr &report,
+                      const Pace &pace = Pace::kRealtime, bool loop = true);
+
+    ~ReplayEncoder();
+
+    // Number of access units found in the file
+    std::size_t AccessUnits() const;
+
+    // From ac::video::BaseEncoder
+    BaseEncoder::Config DefaultConfiguration() override;
+    bool Configure(const BaseEncoder::Config &config) override;
+    bool Reset() override;
+    void QueueBuffer(const ac::video::Buffer::Ptr &buffer) override;
+    BaseEncoder::Config Configuration() const override;
+    bool Running() const override;
+    void SendIDRFrame() override;
+
+    // From ac::common::Executable
+    bool Start() override;
+    bool Stop() override;
+    bool Execute() override;
+    std::string Name() const override;
+
+private:
+    class Mapping;
+    class AccessUnitBuffer;
+
+    struct AccessUnit {
+        std::size_t offset;
+        std::size_t size;
+        bool idr;
+    };
+
+    ReplayEncoder(const std::shared_ptr<Mapping> &mapping, const EncoderReport::Ptr &report,
+                  const Pace &pace, bool loop);
+
+    bool Index();
+
+private:
+    std::shared_ptr<Mapping> mapping_;
+    EncoderReport::Ptr report_;
+    const Pace pace_;
+    const bool loop_;
+    BaseEncoder::Config config_;
+    std::vector<AccessUnit> access_units_;
+    std::unique_ptr<FramePacer> pacer_;
+    std::size_t next_unit_;
+    FrameNumber frame_;
+    std::atomic<bool> running_;
+    std::atomic<bool> idr_requested_;
+};
+
+} // namespace video
+} // namespace ac
+
+#endif
@@ -24,6 +24,8 @@
 
 #include "ac/utils.h"
 
+#include "ac/video/buffer.h"
+
 namespace ac {
 namespace video {
 
@@ -31,7 +33,8 @@ class SenderReport : public ac::NonCopyable {
 public:
     typedef std::shared_ptr<SenderReport> Ptr;
 
-    virtual void SentPacket(const ac::TimestampUs &timestamp, const size_t &size) = 0;
+    virtual void SentPacket(const FrameNumber &frame, const ac::TimestampUs &timestamp, const size_t &size) = 0;
+    virtual void FailedToSendPacket(const FrameNumber &frame, const ac::TimestampUs &timestamp) = 0;
 };
 
 } // namespace video
@@ -23,6 +23,34 @@ extern bool GetNextNALUnit(const uint8_t **_data, size_t *_size, const uint8_t *
                            size_t *nalSize, bool startCodeFollows);
 }
 
+namespace {
+enum {
+    kNalTypeSlice = 1,
+    kNalTypeIDR = 5,
+    kNalTypeSEI = 6,
+    kNalTypeAUD = 9,
+    kNalTypeReservedStart = 14,
+    kNalTypeReservedEnd = 18,
+};
+
+bool IsVCL(unsigned int nal_type) {
+    return nal_type >= kNalTypeSlice && nal_type <= kNalTypeIDR;
+}
+
+// See ITU-T H.264, 7.4.1.2.3 for what may start a new access unit.
+bool StartsAccessUnit(const uint8_t *nal, size_t size) {
+    const unsigned int nal_type = nal[0] & 0x1f;
+
+    if ((nal_type >= kNalTypeSEI && nal_type <= kNalTypeAUD) ||
+            (nal_type >= kNalTypeReservedStart && nal_type <= kNalTypeReservedEnd))
+        return true;
+
+    // The first slice of a picture has first_mb_in_slice set to zero
+    // which is coded as a single one bit.
+    return IsVCL(nal_type) && size > 1 && (nal[1] & 0x80);
+}
+}
+
 namespace ac {
 namespace video {
 
@@ -35,5 +63,61 @@ bool GetNextNALUnit(const uint8_t **_data, size_t *_size, const uint8_t **nalSta
     return from_android::GetNextNALUnit(_data, _size, nalStart, nalSize, startCodeFollows);
 }
 
+bool GetNextAccessUnit(const uint8_t **data, size_t *size, const uint8_t **auStart,
+                       size_t *auSize) {
+    *auStart = nullptr;
+    *auSize = 0;
+
+    if (!*data || *size == 0)
+        return false;
+
+    const uint8_t *begin = *data;
+    const uint8_t *end = *data + *size;
+    const uint8_t *current = *data;
+    size_t remaining = *size;
+    bool has_slice = false;
+
+    while (current && remaining > 0) {
+        const uint8_t *next = current;
+        size_t next_size = remaining;
+        const uint8_t *nal = nullptr;
+        size_t nal_size = 0;
+
+        if (!from_android::GetNextNALUnit(&next, &next_size, &nal, &nal_size, true))
+            break;
+
+        if (has_slice && StartsAccessUnit(nal, nal_size))
+            break;
+
+        if (IsVCL(nal[0] & 0x1f))
+            has_slice = true;
+
+        current = next;
+        remaining = next_size;
+    }
+
+    if (current == begin)
+        return false;
+
+    if (!current || remaining == 0) {
+        current = nullptr;
+        remaining = 0;
+    }
+    // Hand the zero byte of a four byte start code over to the next
+    // access unit it belongs to.
+    else if (current > begin && current[-1] == 0x00) {
+        current--;
+        remaining++;
+    }
+
+    *auStart = begin;
+    *auSize = (current ? current : end) - begin;
+
+    *data = current;
+    *size = remaining;
+
+    return true;
+}
+
 } // video
 } // ac
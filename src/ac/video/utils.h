@@ -26,6 +26,12 @@ namespace video {
 bool DoesBufferContainIDRFrame(const ac::video::Buffer::Ptr &buffer);
 bool GetNextNALUnit(const uint8_t **_data, size_t *_size, const uint8_t **nalStart,
                     size_t *nalSize, bool startCodeFollows);
+// Finds the next complete access unit in a H.264 byte stream. The
+// returned range starts with the start code of its first NAL unit and
+// ends right before the one of the next access unit. The remaining
+// data is expected to start with a start code.
+bool GetNextAccessUnit(const uint8_t **data, size_t *size, const uint8_t **auStart,
+                       size_t *auSize);
 
 } // video
 } // ac
@@ -134,6 +134,8 @@ Application::Application() :
     RegisterCommand(Command { "info", "<address>", "Show device information", std::bind(&Application::HandleInfoCommand, this, _1) });
     RegisterCommand(Command { "connect", "<address>", "Connect a device", std::bind(&Application::HandleConnectCommand, this, _1) });
     RegisterCommand(Command { "disconnect", "<address>", "Disconnect a device", std::bind(&Application::HandleDisconnectCommand, this, _1) });
+    RegisterCommand(Command { "stats", "", "Show streaming statistics", std::bind(&Application::HandleStatsCommand, this, _1) });
+    RegisterCommand(Command { "timeline", "", "Show phases of the last connection", std::bind(&Application::HandleTimelineCommand, this, _1) });
 }
 
 Application::~Application() {
@@ -341,6 +343,85 @@ void Application::HandleDisconnectCommand(const std::string &arguments) {
         std::cerr << "Unknown or invalid device address" << std::endl;
 }
 
+void Application::OnStatsReceived(GObject *object, GAsyncResult *res, gpointer user_data) {
+    PromptSaver ps;
+
+    GError *error = nullptr;
+    auto result = g_dbus_proxy_call_finish(G_DBUS_PROXY(object), res, &error);
+    if (!result) {
+        std::cerr << "Failed to get statistics: " << error->message << std::endl;
+        g_error_free(error);
+        return;
+    }
+
+    GVariant *metrics = nullptr;
+    g_variant_get(result, "(v)", &metrics);
+
+    if (g_variant_n_children(metrics) == 0)
+        std::cout << "No statistics available (service needs to run with AETHERCAST_REPORT_TYPE=metrics)" << std::endl;
+
+    GVariantIter iter;
+    const gchar *name = nullptr;
+    gdouble value = 0.0;
+
+    g_variant_iter_init(&iter, metrics);
+    while (g_variant_iter_next(&iter, "{&sd}", &name, &value))
+        fprintf(stdout, "  %-28s %.1f\n", name, value);
+
+    g_variant_unref(metrics);
+    g_variant_unref(result);
+}
+
+void Application::HandleStatsCommand(const std::string &arguments) {
+    if (!manager_)
+        return;
+
+    // The manager proxy only caches properties whenever they change
+    // which metrics never do so we have to ask for them explicitly.
+    g_dbus_proxy_call(G_DBUS_PROXY(manager_), "org.freedesktop.DBus.Properties.Get",
+                      g_variant_new("(ss)", "org.aethercast.Manager", "Metrics"),
+                      G_DBUS_CALL_FLAGS_NONE, -1, nullptr, &Application::OnStatsReceived, this);
+}
+
+void Application::OnTimelineReceived(GObject *object, GAsyncResult *res, gpointer user_data) {
+    PromptSaver ps;
+
+    GError *error = nullptr;
+    auto result = g_dbus_proxy_call_finish(G_DBUS_PROXY(object), res, &error);
+    if (!result) {
+        std::cerr << "Failed to get connection timeline: " << error->message << std::endl;
+        g_error_free(error);
+        return;
+    }
+
+    GVariant *timeline = nullptr;
+    g_variant_get(result, "(v)", &timeline);
+
+    if (g_variant_n_children(timeline) == 0)
+        std::cout << "No connection attempt recorded yet" << std::endl;
+
+    GVariantIter iter;
+    const gchar *phase = nullptr;
+    guint64 since_start = 0, since_previous = 0;
+
+    g_variant_iter_init(&iter, timeline);
+    while (g_variant_iter_next(&iter, "(&stt)", &phase, &since_start, &since_previous))
+        fprintf(stdout, "  %-24s %10.1f ms  (+%.1f ms)\n", phase,
+                since_start / 1000.0, since_previous / 1000.0);
+
+    g_variant_unref(timeline);
+    g_variant_unref(result);
+}
+
+void Application::HandleTimelineCommand(const std::string &arguments) {
+    if (!manager_)
+        return;
+
+    g_dbus_proxy_call(G_DBUS_PROXY(manager_), "org.freedesktop.DBus.Properties.Get",
+                      g_variant_new("(ss)", "org.aethercast.Manager", "ConnectionTimeline"),
+                      G_DBUS_CALL_FLAGS_NONE, -1, nullptr, &Application::OnTimelineReceived, this);
+}
+
 void Application::SetupStandardInput() {
     GIOChannel *channel;
 
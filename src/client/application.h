@@ -67,6 +67,8 @@ private:
     void HandleInfoCommand(const std::string &arguments);
     void HandleConnectCommand(const std::string &arguments);
     void HandleDisconnectCommand(const std::string &arguments);
+    void HandleStatsCommand(const std::string &arguments);
+    void HandleTimelineCommand(const std::string &arguments);
 
     void RegisterCommand(const Command &command);
 
@@ -91,6 +93,8 @@ private:
     static void OnScanDone(GObject *object, GAsyncResult *res, gpointer user_data);
     static void OnDeviceConnected(GObject *object, GAsyncResult *res, gpointer user_data);
     static void OnDeviceDisconnected(GObject *object, GAsyncResult *res, gpointer user_data);
+    static void OnStatsReceived(GObject *object, GAsyncResult *res, gpointer user_data);
+    static void OnTimelineReceived(GObject *object, GAsyncResult *res, gpointer user_data);
 private:
     void SetupStandardInput();
     void ForeachDevice(std::function<void(AethercastInterfaceDevice*)> callback, const std::string &address_filter = "");
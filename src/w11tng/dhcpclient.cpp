@@ -18,42 +18,140 @@
 #include <asm/types.h>
 #include <linux/netlink.h>
 #include <linux/rtnetlink.h>
+#include <net/if.h>
+#include <sys/ioctl.h>
 #include <sys/socket.h>
-#include <sys/prctl.h>
+#include <unistd.h>
 
-#include <boost/filesystem.hpp>
+#include <algorithm>
+#include <cstring>
+#include <map>
 
+#include <ac/keep_alive.h>
 #include <ac/logger.h>
 #include <ac/networkutils.h>
-#include <ac/keep_alive.h>
-#include <ac/scoped_gobject.h>
-
-#include <ac/config.h>
-#include <w11tng/config.h>
 
 #include "dhcpclient.h"
-#include "dhcpleaseparser.h"
+
+namespace {
+constexpr std::uint32_t kDefaultLeaseTime{3600};
+constexpr std::uint32_t kInfiniteLeaseTime{0xffffffff};
+constexpr unsigned char kDefaultPrefixLength{24};
+
+struct KnownLease {
+    ac::IpV4Address address;
+    std::chrono::steady_clock::time_point expiry;
+};
+
+// Leases by the address of the peer which handed them out
+std::map<std::string, KnownLease>& KnownLeases() {
+    static std::map<std::string, KnownLease> leases;
+    return leases;
+}
+
+bool RetrieveHardwareAddress(const std::string &interface_name, std::array<std::uint8_t, 16> &address) {
+    address.fill(0);
+
+    const auto fd = ::socket(AF_INET, SOCK_DGRAM | SOCK_CLOEXEC, 0);
+    if (fd < 0)
+        return false;
+
+    struct ifreq ifr;
+    ::memset(&ifr, 0, sizeof(ifr));
+    ::strncpy(ifr.ifr_name, interface_name.c_str(), IFNAMSIZ - 1);
+
+    const auto result = ::ioctl(fd, SIOCGIFHWADDR, &ifr);
+    ::close(fd);
+
+    if (result < 0)
+        return false;
+
+    std::copy(ifr.ifr_hwaddr.sa_data, ifr.ifr_hwaddr.sa_data + 6, address.begin());
+    return true;
+}
+
+unsigned char PrefixLengthFromNetmask(const ac::IpV4Address &netmask) {
+    if (netmask.is_unspecified())
+        return kDefaultPrefixLength;
+
+    auto bits = netmask.to_ulong();
+    unsigned char length = 0;
+    while (bits & 0x80000000) {
+        length++;
+        bits <<= 1;
+    }
+    return length;
+}
+}
 
 namespace w11tng {
 
-DhcpClient::Ptr DhcpClient::Create(const std::weak_ptr<Delegate> &delegate, const std::string &interface_name) {
-    auto sp = std::shared_ptr<DhcpClient>(new DhcpClient(delegate, interface_name));
+constexpr std::chrono::milliseconds DhcpClient::kInitialRetransmitTimeout;
+constexpr std::chrono::milliseconds DhcpClient::kMaxRetransmitTimeout;
+constexpr unsigned int DhcpClient::kMaxRebootAttempts;
+constexpr unsigned int DhcpClient::kMaxRequestAttempts;
+constexpr std::chrono::seconds DhcpClient::kDefaultTimeout;
+
+DhcpClient::Config DhcpClient::DefaultConfig() {
+    Config config;
+    config.server_port = DhcpMessage::kServerPort;
+    config.client_port = DhcpMessage::kClientPort;
+    config.timeout = kDefaultTimeout;
+    config.configure_interface = true;
+    return config;
+}
+
+DhcpClient::Ptr DhcpClient::Create(const std::weak_ptr<Delegate> &delegate, const std::string &interface_name,
+                                   const std::string &peer) {
+    return Create(delegate, interface_name, peer, DefaultConfig());
+}
+
+DhcpClient::Ptr DhcpClient::Create(const std::weak_ptr<Delegate> &delegate, const std::string &interface_name,
+                                   const std::string &peer, const Config &config) {
+    auto sp = std::shared_ptr<DhcpClient>(new DhcpClient(delegate, interface_name, peer, config));
     sp->Start();
     return sp;
 }
 
-DhcpClient::DhcpClient(const std::weak_ptr<Delegate> &delegate, const std::string &interface_name) :
-    delegate_(delegate),
-    interface_name_(interface_name) {
+void DhcpClient::RememberLease(const std::string &peer, const ac::IpV4Address &address) {
+    if (peer.length() == 0 || address.is_unspecified())
+        return;
+
+    const auto now = std::chrono::steady_clock::now();
+    const auto known = KnownLeases().find(peer);
+    if (known != KnownLeases().end() && known->second.expiry > now)
+        return;
+
+    // We don't know how long the lease is valid anymore but asking for
+    // it costs us at most kMaxRebootAttempts retransmits.
+    KnownLeases()[peer] = KnownLease{address, now + std::chrono::seconds{kDefaultLeaseTime}};
+}
 
-    lease_file_path_ = ac::Utils::Sprintf("%s/dhclient-%s-%s.leases",
-                                    ac::kRuntimePath,
-                                    boost::filesystem::unique_path().string(),
-                                    interface_name_);
+void DhcpClient::ForgetLeases() {
+    KnownLeases().clear();
+}
+
+DhcpClient::DhcpClient(const std::weak_ptr<Delegate> &delegate, const std::string &interface_name,
+                       const std::string &peer, const Config &config) :
+    delegate_(delegate),
+    interface_name_(interface_name),
+    peer_(peer),
+    config_(config),
+    random_(std::random_device()()),
+    state_(State::kInit),
+    transaction_id_(0),
+    attempts_(0),
+    retransmit_timeout_(kInitialRetransmitTimeout),
+    retransmit_source_(0),
+    timeout_source_(0),
+    renew_source_(0) {
+    hardware_address_.fill(0);
 }
 
 DhcpClient::~DhcpClient() {
-    ::unlink(lease_file_path_.c_str());
+    RemoveTimeout(retransmit_source_);
+    RemoveTimeout(timeout_source_);
+    RemoveTimeout(renew_source_);
 }
 
 ac::IpV4Address DhcpClient::LocalAddress() const {
@@ -65,48 +163,276 @@ ac::IpV4Address DhcpClient::RemoteAddress() const {
 }
 
 void DhcpClient::Start() {
-    if (!ac::Utils::CreateFile(lease_file_path_)) {
-        AC_ERROR("Failed to create database for DHCP leases at %s",
-                  lease_file_path_);
+    if (!RetrieveHardwareAddress(interface_name_, hardware_address_))
+        AC_WARNING("Failed to retrieve hardware address of %s", interface_name_);
+
+    socket_ = DhcpSocket::Create(shared_from_this(), interface_name_, config_.client_port);
+    if (!socket_) {
+        // Our creator doesn't hold a reference to us yet so tell it
+        // from the mainloop.
+        g_idle_add_full(G_PRIORITY_DEFAULT, &DhcpClient::OnStartFailed,
+                        new ac::WeakKeepAlive<DhcpClient>(shared_from_this()),
+                        [](gpointer data) { delete static_cast<ac::WeakKeepAlive<DhcpClient>*>(data); });
         return;
     }
 
-    monitor_ = FileMonitor::Create(lease_file_path_, shared_from_this());
+    timeout_source_ = AddTimeout(config_.timeout, &DhcpClient::OnTimeout);
 
-    std::vector<std::string> argv = {
-        // Disable background on lease (let dhclient not fork)
-        "-d",
-        // Be verbose and not quiet on startup
-        "-v",
-        // Force us to be IPv4 no matter what the default is
-        "-4",
-        // Use the temporary lease file we used above to not interfere
-        // with any other parts in the system which are using dhclient
-        // as well. We also want a fresh lease file on every start.
-        "-lf", lease_file_path_,
-        // We only want dhclient to operate on the P2P interface an no other
-        interface_name_
-    };
+    const auto known = KnownLeases().find(peer_);
+    if (peer_.length() > 0 && known != KnownLeases().end() &&
+        known->second.expiry > std::chrono::steady_clock::now()) {
+        AC_DEBUG("Asking %s for our last address %s again", peer_, known->second.address.to_string());
+        requested_address_ = known->second.address;
+        EnterState(State::kRebooting);
+        return;
+    }
 
-    executor_ = ProcessExecutor::Create(kDhcpClientPath, argv, shared_from_this());
+    EnterState(State::kSelecting);
 }
 
-void DhcpClient::OnProcessTerminated() {
-    if (auto sp = delegate_.lock())
+gboolean DhcpClient::OnStartFailed(gpointer user_data) {
+    auto thiz = static_cast<ac::WeakKeepAlive<DhcpClient>*>(user_data)->GetInstance().lock();
+    if (!thiz)
+        return FALSE;
+
+    if (auto sp = thiz->delegate_.lock())
         sp->OnDhcpTerminated();
+
+    return FALSE;
+}
+
+void DhcpClient::EnterState(State state) {
+    state_ = state;
+    attempts_ = 0;
+    retransmit_timeout_ = kInitialRetransmitTimeout;
+
+    // The request following an offer has to use the transaction id of
+    // the discover.
+    if (state != State::kRequesting)
+        transaction_id_ = random_();
+
+    SendMessage();
+}
+
+void DhcpClient::SendMessage() {
+    RemoveTimeout(retransmit_source_);
+
+    DhcpMessage message;
+    message.transaction_id = transaction_id_;
+    message.hardware_address = hardware_address_;
+
+    auto destination = ac::IpV4Address::broadcast();
+
+    switch (state_) {
+    case State::kSelecting:
+        message.SetMessageType(DhcpMessage::Type::kDiscover);
+        break;
+    case State::kRequesting:
+        message.SetMessageType(DhcpMessage::Type::kRequest);
+        message.SetAddressOption(DhcpMessage::Option::kRequestedAddress, requested_address_);
+        message.SetAddressOption(DhcpMessage::Option::kServerIdentifier, remote_address_);
+        break;
+    case State::kRebooting:
+        message.SetMessageType(DhcpMessage::Type::kRequest);
+        message.SetAddressOption(DhcpMessage::Option::kRequestedAddress, requested_address_);
+        break;
+    case State::kRenewing:
+        message.SetMessageType(DhcpMessage::Type::kRequest);
+        message.client_address = local_address_;
+        destination = remote_address_;
+        break;
+    default:
+        return;
+    }
+
+    if (state_ != State::kRenewing) {
+        // We can't receive unicasts before we have an address
+        message.flags = DhcpMessage::kBroadcastFlag;
+        message.SetOption(DhcpMessage::Option::kParameterRequestList, {
+                              static_cast<std::uint8_t>(DhcpMessage::Option::kSubnetMask),
+                              static_cast<std::uint8_t>(DhcpMessage::Option::kBroadcastAddress),
+                              static_cast<std::uint8_t>(DhcpMessage::Option::kLeaseTime),
+                              static_cast<std::uint8_t>(DhcpMessage::Option::kServerIdentifier)});
+    }
+
+    socket_->Send(message, destination, config_.server_port);
+
+    retransmit_source_ = AddTimeout(retransmit_timeout_, &DhcpClient::OnRetransmit);
+    retransmit_timeout_ = std::min(retransmit_timeout_ * 2, kMaxRetransmitTimeout);
 }
 
-void DhcpClient::OnFileChanged(const std::string &path) {
-    auto leases = DhcpLeaseParser::FromFile(path);
-    if (leases.size() != 1)
+gboolean DhcpClient::OnRetransmit(gpointer user_data) {
+    auto thiz = static_cast<ac::WeakKeepAlive<DhcpClient>*>(user_data)->GetInstance().lock();
+    if (!thiz)
+        return FALSE;
+
+    thiz->retransmit_source_ = 0;
+    thiz->attempts_++;
+
+    if (thiz->state_ == State::kRebooting && thiz->attempts_ >= kMaxRebootAttempts) {
+        AC_DEBUG("No answer to our request for %s, discovering", thiz->requested_address_.to_string());
+        thiz->EnterState(State::kSelecting);
+    } else if (thiz->state_ == State::kRequesting && thiz->attempts_ >= kMaxRequestAttempts) {
+        thiz->EnterState(State::kSelecting);
+    } else {
+        thiz->SendMessage();
+    }
+
+    return FALSE;
+}
+
+void DhcpClient::OnMessageReceived(const DhcpMessage &message) {
+    if (message.op != DhcpMessage::Op::kBootReply ||
+        message.transaction_id != transaction_id_ ||
+        message.hardware_address != hardware_address_)
         return;
 
-    auto actual_lease = leases[0];
+    AC_DEBUG("%s from %s", DhcpMessage::TypeToString(message.MessageType()),
+             message.AddressOption(DhcpMessage::Option::kServerIdentifier).to_string());
+
+    switch (message.MessageType()) {
+    case DhcpMessage::Type::kOffer:
+        if (state_ != State::kSelecting)
+            break;
+
+        requested_address_ = message.your_address;
+        remote_address_ = message.AddressOption(DhcpMessage::Option::kServerIdentifier);
+        if (remote_address_.is_unspecified())
+            break;
+
+        EnterState(State::kRequesting);
+        break;
+    case DhcpMessage::Type::kAck:
+        if (state_ == State::kRequesting || state_ == State::kRebooting || state_ == State::kRenewing)
+            Bind(message);
+        break;
+    case DhcpMessage::Type::kNak:
+        if (state_ == State::kRenewing) {
+            Terminate();
+        } else if (state_ == State::kRequesting || state_ == State::kRebooting) {
+            KnownLeases().erase(peer_);
+            EnterState(State::kSelecting);
+        }
+        break;
+    default:
+        break;
+    }
+}
+
+void DhcpClient::Bind(const DhcpMessage &ack) {
+    RemoveTimeout(retransmit_source_);
+    RemoveTimeout(timeout_source_);
+
+    const auto renewed = (state_ == State::kRenewing);
+
+    local_address_ = ack.your_address;
+    const auto server = ack.AddressOption(DhcpMessage::Option::kServerIdentifier);
+    if (!server.is_unspecified())
+        remote_address_ = server;
 
-    local_address_ = actual_lease.FixedAddress();
-    remote_address_ = actual_lease.Gateway();
+    state_ = State::kBound;
+
+    const auto lease_time = ack.Uint32Option(DhcpMessage::Option::kLeaseTime, kDefaultLeaseTime);
+    const auto renewal_time = ack.Uint32Option(DhcpMessage::Option::kRenewalTime, lease_time / 2);
+
+    if (peer_.length() > 0)
+        KnownLeases()[peer_] = KnownLease{local_address_,
+                                          std::chrono::steady_clock::now() + std::chrono::seconds{lease_time}};
+
+    if (lease_time != kInfiniteLeaseTime) {
+        // Once the lease runs out without being renewed we are done
+        timeout_source_ = AddLeaseTimeout(std::chrono::seconds{lease_time}, &DhcpClient::OnTimeout);
+        renew_source_ = AddLeaseTimeout(std::chrono::seconds{renewal_time}, &DhcpClient::OnRenew);
+    }
+
+    if (renewed)
+        return;
+
+    const auto prefix_length = PrefixLengthFromNetmask(ack.AddressOption(DhcpMessage::Option::kSubnetMask));
+    if (config_.configure_interface && !ConfigureInterface(prefix_length)) {
+        Terminate();
+        return;
+    }
+
+    AC_DEBUG("Got address %s from %s", local_address_.to_string(), remote_address_.to_string());
 
     if (auto sp = delegate_.lock())
         sp->OnDhcpAddressAssigned(local_address_, remote_address_);
 }
+
+gboolean DhcpClient::OnRenew(gpointer user_data) {
+    auto thiz = static_cast<ac::WeakKeepAlive<DhcpClient>*>(user_data)->GetInstance().lock();
+    if (!thiz)
+        return FALSE;
+
+    thiz->renew_source_ = 0;
+    thiz->EnterState(State::kRenewing);
+
+    return FALSE;
+}
+
+gboolean DhcpClient::OnTimeout(gpointer user_data) {
+    auto thiz = static_cast<ac::WeakKeepAlive<DhcpClient>*>(user_data)->GetInstance().lock();
+    if (!thiz)
+        return FALSE;
+
+    thiz->timeout_source_ = 0;
+
+    AC_WARNING("Failed to get an address on %s in time", thiz->interface_name_);
+    thiz->Terminate();
+
+    return FALSE;
+}
+
+void DhcpClient::Terminate() {
+    RemoveTimeout(retransmit_source_);
+    RemoveTimeout(timeout_source_);
+    RemoveTimeout(renew_source_);
+
+    state_ = State::kInit;
+
+    if (auto sp = delegate_.lock())
+        sp->OnDhcpTerminated();
+}
+
+bool DhcpClient::ConfigureInterface(unsigned char prefix_length) {
+    const auto netmask = prefix_length == 0 ? 0 : (0xffffffffu << (32 - prefix_length));
+    const auto broadcast = ac::IpV4Address(local_address_.to_ulong() | ~netmask);
+
+    auto interface_index = ac::NetworkUtils::RetrieveInterfaceIndex(interface_name_.c_str());
+    if (interface_index < 0) {
+        AC_ERROR("Failed to determine index of network interface: %s", interface_name_);
+        return false;
+    }
+
+    // No routes are added as we only talk to the peer inside the group.
+    if (ac::NetworkUtils::ModifyInterfaceAddress(RTM_NEWADDR, NLM_F_REPLACE | NLM_F_ACK, interface_index,
+                                    AF_INET, local_address_.to_string().c_str(),
+                                    NULL, prefix_length, broadcast.to_string().c_str()) < 0) {
+        AC_ERROR("Failed to assign network address for %s", interface_name_);
+        return false;
+    }
+
+    return true;
+}
+
+guint DhcpClient::AddTimeout(const std::chrono::milliseconds &timeout, GSourceFunc callback) {
+    return g_timeout_add_full(G_PRIORITY_DEFAULT, timeout.count(), callback,
+                              new ac::WeakKeepAlive<DhcpClient>(shared_from_this()),
+                              [](gpointer data) { delete static_cast<ac::WeakKeepAlive<DhcpClient>*>(data); });
+}
+
+guint DhcpClient::AddLeaseTimeout(const std::chrono::seconds &timeout, GSourceFunc callback) {
+    return g_timeout_add_seconds_full(G_PRIORITY_DEFAULT, timeout.count(), callback,
+                                      new ac::WeakKeepAlive<DhcpClient>(shared_from_this()),
+                                      [](gpointer data) { delete static_cast<ac::WeakKeepAlive<DhcpClient>*>(data); });
+}
+
+void DhcpClient::RemoveTimeout(guint &id) {
+    if (id == 0)
+        return;
+
+    g_source_remove(id);
+    id = 0;
+}
 } // namespace w11tng
@@ -18,8 +18,9 @@
 #ifndef W11TNG_DHCPCLIENT_H_
 #define W11TNG_DHCPCLIENT_H_
 
-#include <boost/noncopyable.hpp>
-
+#include <array>
+#include <chrono>
+#include <random>
 #include <string>
 
 #include <ac/glib_wrapper.h>
@@ -27,44 +28,117 @@
 #include <ac/ip_v4_address.h>
 #include <ac/non_copyable.h>
 
-#include "processexecutor.h"
-#include "filemonitor.h"
+#include "dhcpmessage.h"
+#include "dhcpsocket.h"
 
 namespace w11tng {
+// DhcpClient obtains our address in a P2P group owned by the peer. It
+// retransmits a lot faster than RFC 2131 suggests as there is only
+// one server on the link which either answers quickly or not at all.
+// Leases are remembered per peer so reconnecting to a peer we know
+// only takes a single REQUEST (INIT-REBOOT) instead of the full
+// DISCOVER/OFFER/REQUEST/ACK exchange.
 class DhcpClient : public std::enable_shared_from_this<DhcpClient>,
-                   public w11tng::ProcessExecutor::Delegate,
-                   public w11tng::FileMonitor::Delegate {
+                   public DhcpSocket::Delegate {
 public:
     typedef std::shared_ptr<DhcpClient> Ptr;
 
+    static constexpr std::chrono::milliseconds kInitialRetransmitTimeout{200};
+    static constexpr std::chrono::milliseconds kMaxRetransmitTimeout{2000};
+    // Unanswered INIT-REBOOT requests before we fall back to discover
+    static constexpr unsigned int kMaxRebootAttempts{2};
+    static constexpr unsigned int kMaxRequestAttempts{4};
+    static constexpr std::chrono::seconds kDefaultTimeout{30};
+
     class Delegate : private ac::NonCopyable {
     public:
         virtual void OnDhcpAddressAssigned(const ac::IpV4Address &local_address, const ac::IpV4Address &remote_address) = 0;
         virtual void OnDhcpTerminated() = 0;
     };
 
-    static Ptr Create(const std::weak_ptr<Delegate> &delegate, const std::string &interface_name);
+    struct Config {
+        std::uint16_t server_port;
+        std::uint16_t client_port;
+        // Time to get an address before giving up
+        std::chrono::seconds timeout;
+        // Whether the assigned address is put on the interface. Tests
+        // running over loopback don't want that.
+        bool configure_interface;
+    };
+
+    static Config DefaultConfig();
+
+    // The peer is the address of the device owning the group and used
+    // to look up the lease we got from it last time.
+    static Ptr Create(const std::weak_ptr<Delegate> &delegate, const std::string &interface_name,
+                      const std::string &peer = "");
+    static Ptr Create(const std::weak_ptr<Delegate> &delegate, const std::string &interface_name,
+                      const std::string &peer, const Config &config);
+
+    // Seeds the lease for a peer we know from an earlier run unless we
+    // already got one from it.
+    static void RememberLease(const std::string &peer, const ac::IpV4Address &address);
+    // Drops all remembered leases
+    static void ForgetLeases();
 
     ~DhcpClient();
 
     ac::IpV4Address RemoteAddress() const;
     ac::IpV4Address LocalAddress() const;
 
-    void OnProcessTerminated() override;
-    void OnFileChanged(const std::string &path) override;
+    void OnMessageReceived(const DhcpMessage &message) override;
 
 private:
-    DhcpClient(const std::weak_ptr<Delegate> &delegate, const std::string &interface_name);
+    enum class State {
+        kInit,
+        kSelecting,
+        kRequesting,
+        kRebooting,
+        kBound,
+        kRenewing,
+    };
+
+    static gboolean OnRetransmit(gpointer user_data);
+    static gboolean OnTimeout(gpointer user_data);
+    static gboolean OnRenew(gpointer user_data);
+    static gboolean OnStartFailed(gpointer user_data);
+
+    DhcpClient(const std::weak_ptr<Delegate> &delegate, const std::string &interface_name,
+               const std::string &peer, const Config &config);
+
     void Start();
 
+    void EnterState(State state);
+    void SendMessage();
+    void Bind(const DhcpMessage &ack);
+    void Terminate();
+
+    bool ConfigureInterface(unsigned char prefix_length);
+
+    guint AddTimeout(const std::chrono::milliseconds &timeout, GSourceFunc callback);
+    // Lease times go up to 2^32 - 2 seconds which doesn't fit into a
+    // millisecond timeout. Only precise to a second.
+    guint AddLeaseTimeout(const std::chrono::seconds &timeout, GSourceFunc callback);
+    void RemoveTimeout(guint &id);
+
 private:
     std::weak_ptr<Delegate> delegate_;
     std::string interface_name_;
+    std::string peer_;
+    Config config_;
+    DhcpSocket::Ptr socket_;
+    std::array<std::uint8_t, 16> hardware_address_;
+    std::mt19937 random_;
+    State state_;
+    std::uint32_t transaction_id_;
+    unsigned int attempts_;
+    std::chrono::milliseconds retransmit_timeout_;
+    guint retransmit_source_;
+    guint timeout_source_;
+    guint renew_source_;
+    ac::IpV4Address requested_address_;
     ac::IpV4Address local_address_;
     ac::IpV4Address remote_address_;
-    std::string lease_file_path_;
-    ProcessExecutor::Ptr executor_;
-    FileMonitor::Ptr monitor_;
 };
 }
 
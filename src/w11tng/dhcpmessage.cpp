@@ -0,0 +1,292 @@
+/*
+ * Copyright (C) 2016 Canonical, Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 3, as published
+ * by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranties of
+ * MERCHANTABILITY, SATISFACTORY QUALITY, or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <algorithm>
+#include <cstring>
+
+#include <ac/utils.h>
+
+#include "dhcpmessage.h"
+
+namespace {
+constexpr std::uint8_t kMagicCookie[] = {99, 130, 83, 99};
+constexpr std::uint8_t kHardwareTypeEthernet{1};
+constexpr std::uint8_t kHardwareAddressLengthEthernet{6};
+
+// Offsets into the fixed part of the message
+constexpr std::size_t kOpOffset{0};
+constexpr std::size_t kHardwareTypeOffset{1};
+constexpr std::size_t kHardwareAddressLengthOffset{2};
+constexpr std::size_t kHopsOffset{3};
+constexpr std::size_t kTransactionIdOffset{4};
+constexpr std::size_t kSecondsOffset{8};
+constexpr std::size_t kFlagsOffset{10};
+constexpr std::size_t kClientAddressOffset{12};
+constexpr std::size_t kYourAddressOffset{16};
+constexpr std::size_t kServerAddressOffset{20};
+constexpr std::size_t kRelayAddressOffset{24};
+constexpr std::size_t kHardwareAddressOffset{28};
+constexpr std::size_t kMagicCookieOffset{236};
+
+std::uint32_t ReadUint32(const std::uint8_t *data) {
+    return (static_cast<std::uint32_t>(data[0]) << 24) | (static_cast<std::uint32_t>(data[1]) << 16) |
+           (static_cast<std::uint32_t>(data[2]) << 8) | static_cast<std::uint32_t>(data[3]);
+}
+
+std::uint16_t ReadUint16(const std::uint8_t *data) {
+    return (static_cast<std::uint16_t>(data[0]) << 8) | data[1];
+}
+
+void WriteUint32(std::uint8_t *data, std::uint32_t value) {
+    data[0] = (value >> 24) & 0xff;
+    data[1] = (value >> 16) & 0xff;
+    data[2] = (value >> 8) & 0xff;
+    data[3] = value & 0xff;
+}
+
+void WriteUint16(std::uint8_t *data, std::uint16_t value) {
+    data[0] = (value >> 8) & 0xff;
+    data[1] = value & 0xff;
+}
+}
+
+namespace w11tng {
+
+constexpr std::uint16_t DhcpMessage::kServerPort;
+constexpr std::uint16_t DhcpMessage::kClientPort;
+constexpr std::size_t DhcpMessage::kHeaderSize;
+constexpr std::size_t DhcpMessage::kMinSize;
+constexpr std::size_t DhcpMessage::kMaxSize;
+constexpr std::uint16_t DhcpMessage::kBroadcastFlag;
+
+std::string DhcpMessage::TypeToString(Type type) {
+    switch (type) {
+    case Type::kDiscover:
+        return "DISCOVER";
+    case Type::kOffer:
+        return "OFFER";
+    case Type::kRequest:
+        return "REQUEST";
+    case Type::kDecline:
+        return "DECLINE";
+    case Type::kAck:
+        return "ACK";
+    case Type::kNak:
+        return "NAK";
+    case Type::kRelease:
+        return "RELEASE";
+    case Type::kInform:
+        return "INFORM";
+    default:
+        break;
+    }
+    return "NONE";
+}
+
+bool DhcpMessage::Parse(const std::uint8_t *data, std::size_t size, DhcpMessage &message) {
+    if (!data || size < kHeaderSize)
+        return false;
+
+    if (std::memcmp(data + kMagicCookieOffset, kMagicCookie, sizeof(kMagicCookie)) != 0)
+        return false;
+
+    const auto op = data[kOpOffset];
+    if (op != static_cast<std::uint8_t>(Op::kBootRequest) &&
+        op != static_cast<std::uint8_t>(Op::kBootReply))
+        return false;
+
+    DhcpMessage result;
+    result.op = static_cast<Op>(op);
+    result.hardware_type = data[kHardwareTypeOffset];
+    result.hardware_address_length = std::min<std::uint8_t>(data[kHardwareAddressLengthOffset],
+                                                            result.hardware_address.size());
+    result.hops = data[kHopsOffset];
+    result.transaction_id = ReadUint32(data + kTransactionIdOffset);
+    result.seconds = ReadUint16(data + kSecondsOffset);
+    result.flags = ReadUint16(data + kFlagsOffset);
+    result.client_address = ac::IpV4Address(ReadUint32(data + kClientAddressOffset));
+    result.your_address = ac::IpV4Address(ReadUint32(data + kYourAddressOffset));
+    result.server_address = ac::IpV4Address(ReadUint32(data + kServerAddressOffset));
+    result.relay_address = ac::IpV4Address(ReadUint32(data + kRelayAddressOffset));
+    std::copy(data + kHardwareAddressOffset,
+              data + kHardwareAddressOffset + result.hardware_address.size(),
+              result.hardware_address.begin());
+
+    std::size_t offset = kHeaderSize;
+    while (offset < size) {
+        const auto code = data[offset++];
+        if (code == static_cast<std::uint8_t>(Option::kPad))
+            continue;
+        if (code == static_cast<std::uint8_t>(Option::kEnd))
+            break;
+
+        if (offset >= size)
+            return false;
+
+        const std::size_t length = data[offset++];
+        if (offset + length > size)
+            return false;
+
+        // Long options are split into several ones with the same code
+        // (RFC 3396).
+        auto &option = result.options_[code];
+        option.insert(option.end(), data + offset, data + offset + length);
+        offset += length;
+    }
+
+    if (result.MessageType() == Type::kNone)
+        return false;
+
+    message = result;
+    return true;
+}
+
+DhcpMessage::DhcpMessage() :
+    op(Op::kBootRequest),
+    hardware_type(kHardwareTypeEthernet),
+    hardware_address_length(kHardwareAddressLengthEthernet),
+    hops(0),
+    transaction_id(0),
+    seconds(0),
+    flags(0) {
+    hardware_address.fill(0);
+}
+
+DhcpMessage DhcpMessage::CreateReply(Type type) const {
+    DhcpMessage reply;
+    reply.op = Op::kBootReply;
+    reply.hardware_type = hardware_type;
+    reply.hardware_address_length = hardware_address_length;
+    reply.transaction_id = transaction_id;
+    reply.flags = flags;
+    reply.relay_address = relay_address;
+    reply.hardware_address = hardware_address;
+    reply.SetMessageType(type);
+    return reply;
+}
+
+std::vector<std::uint8_t> DhcpMessage::Serialize() const {
+    std::vector<std::uint8_t> data(kHeaderSize, 0);
+
+    data[kOpOffset] = static_cast<std::uint8_t>(op);
+    data[kHardwareTypeOffset] = hardware_type;
+    data[kHardwareAddressLengthOffset] = hardware_address_length;
+    data[kHopsOffset] = hops;
+    WriteUint32(&data[kTransactionIdOffset], transaction_id);
+    WriteUint16(&data[kSecondsOffset], seconds);
+    WriteUint16(&data[kFlagsOffset], flags);
+    WriteUint32(&data[kClientAddressOffset], client_address.to_ulong());
+    WriteUint32(&data[kYourAddressOffset], your_address.to_ulong());
+    WriteUint32(&data[kServerAddressOffset], server_address.to_ulong());
+    WriteUint32(&data[kRelayAddressOffset], relay_address.to_ulong());
+    std::copy(hardware_address.begin(), hardware_address.end(), data.begin() + kHardwareAddressOffset);
+    std::copy(std::begin(kMagicCookie), std::end(kMagicCookie), data.begin() + kMagicCookieOffset);
+
+    // The message type comes first so it is found quickly
+    const auto type = options_.find(static_cast<std::uint8_t>(Option::kMessageType));
+    if (type != options_.end()) {
+        data.push_back(type->first);
+        data.push_back(type->second.size());
+        data.insert(data.end(), type->second.begin(), type->second.end());
+    }
+
+    for (const auto &option : options_) {
+        if (option.first == static_cast<std::uint8_t>(Option::kMessageType))
+            continue;
+
+        // Split up what doesn't fit into a single option
+        std::size_t offset = 0;
+        do {
+            const auto length = std::min<std::size_t>(option.second.size() - offset, 255);
+            data.push_back(option.first);
+            data.push_back(length);
+            data.insert(data.end(), option.second.begin() + offset, option.second.begin() + offset + length);
+            offset += length;
+        } while (offset < option.second.size());
+    }
+
+    data.push_back(static_cast<std::uint8_t>(Option::kEnd));
+
+    // Some clients drop anything shorter than a BOOTP message
+    if (data.size() < kMinSize)
+        data.resize(kMinSize, 0);
+
+    return data;
+}
+
+DhcpMessage::Type DhcpMessage::MessageType() const {
+    const auto data = OptionData(Option::kMessageType);
+    if (data.size() != 1 || data[0] < static_cast<std::uint8_t>(Type::kDiscover) ||
+        data[0] > static_cast<std::uint8_t>(Type::kInform))
+        return Type::kNone;
+
+    return static_cast<Type>(data[0]);
+}
+
+void DhcpMessage::SetMessageType(Type type) {
+    SetOption(Option::kMessageType, {static_cast<std::uint8_t>(type)});
+}
+
+bool DhcpMessage::HasOption(Option option) const {
+    return options_.find(static_cast<std::uint8_t>(option)) != options_.end();
+}
+
+std::vector<std::uint8_t> DhcpMessage::OptionData(Option option) const {
+    const auto iter = options_.find(static_cast<std::uint8_t>(option));
+    if (iter == options_.end())
+        return {};
+
+    return iter->second;
+}
+
+void DhcpMessage::SetOption(Option option, const std::vector<std::uint8_t> &data) {
+    options_[static_cast<std::uint8_t>(option)] = data;
+}
+
+ac::IpV4Address DhcpMessage::AddressOption(Option option) const {
+    return ac::IpV4Address(Uint32Option(option));
+}
+
+void DhcpMessage::SetAddressOption(Option option, const ac::IpV4Address &address) {
+    SetUint32Option(option, address.to_ulong());
+}
+
+std::uint32_t DhcpMessage::Uint32Option(Option option, std::uint32_t fallback) const {
+    const auto iter = options_.find(static_cast<std::uint8_t>(option));
+    if (iter == options_.end() || iter->second.size() != 4)
+        return fallback;
+
+    return ReadUint32(iter->second.data());
+}
+
+void DhcpMessage::SetUint32Option(Option option, std::uint32_t value) {
+    std::vector<std::uint8_t> data(4);
+    WriteUint32(data.data(), value);
+    SetOption(option, data);
+}
+
+std::string DhcpMessage::HardwareAddressToString() const {
+    std::string address;
+    for (std::size_t n = 0; n < hardware_address_length && n < hardware_address.size(); n++) {
+        if (n > 0)
+            address += ":";
+        address += ac::Utils::Sprintf("%02x", static_cast<unsigned int>(hardware_address[n]));
+    }
+    return address;
+}
+
+} // namespace w11tng
@@ -0,0 +1,125 @@
+/*
+ * Copyright (C) 2016 Canonical, Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 3, as published
+ * by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranties of
+ * MERCHANTABILITY, SATISFACTORY QUALITY, or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef W11TNG_DHCPMESSAGE_H_
+#define W11TNG_DHCPMESSAGE_H_
+
+#include <array>
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+
+#include <ac/ip_v4_address.h>
+
+namespace w11tng {
+// DhcpMessage is a BOOTP message carrying DHCP options (RFC 2131 and
+// RFC 2132). It only covers what is needed to hand out and obtain the
+// single address a peer of a P2P group needs.
+struct DhcpMessage {
+    static constexpr std::uint16_t kServerPort{67};
+    static constexpr std::uint16_t kClientPort{68};
+    // Fixed part of the message including the magic cookie
+    static constexpr std::size_t kHeaderSize{240};
+    // Every client has to accept messages of this size
+    static constexpr std::size_t kMinSize{300};
+    static constexpr std::size_t kMaxSize{576};
+    static constexpr std::uint16_t kBroadcastFlag{0x8000};
+
+    enum class Op : std::uint8_t {
+        kBootRequest = 1,
+        kBootReply = 2,
+    };
+
+    enum class Type : std::uint8_t {
+        kNone = 0,
+        kDiscover = 1,
+        kOffer = 2,
+        kRequest = 3,
+        kDecline = 4,
+        kAck = 5,
+        kNak = 6,
+        kRelease = 7,
+        kInform = 8,
+    };
+
+    enum class Option : std::uint8_t {
+        kPad = 0,
+        kSubnetMask = 1,
+        kRouter = 3,
+        kBroadcastAddress = 28,
+        kRequestedAddress = 50,
+        kLeaseTime = 51,
+        kMessageType = 53,
+        kServerIdentifier = 54,
+        kParameterRequestList = 55,
+        kRenewalTime = 58,
+        kRebindingTime = 59,
+        kClientIdentifier = 61,
+        kEnd = 255,
+    };
+
+    static std::string TypeToString(Type type);
+
+    // Returns false if data doesn't hold a valid DHCP message
+    static bool Parse(const std::uint8_t *data, std::size_t size, DhcpMessage &message);
+
+    DhcpMessage();
+
+    // Starts the reply to this message with everything copied over
+    // which the client needs to match it to its request.
+    DhcpMessage CreateReply(Type type) const;
+
+    std::vector<std::uint8_t> Serialize() const;
+
+    Type MessageType() const;
+    void SetMessageType(Type type);
+
+    bool HasOption(Option option) const;
+    std::vector<std::uint8_t> OptionData(Option option) const;
+    void SetOption(Option option, const std::vector<std::uint8_t> &data);
+
+    // Returns 0.0.0.0 if the option is missing or malformed
+    ac::IpV4Address AddressOption(Option option) const;
+    void SetAddressOption(Option option, const ac::IpV4Address &address);
+
+    // Returns fallback if the option is missing or malformed
+    std::uint32_t Uint32Option(Option option, std::uint32_t fallback = 0) const;
+    void SetUint32Option(Option option, std::uint32_t value);
+
+    // The client hardware address as aa:bb:cc:dd:ee:ff
+    std::string HardwareAddressToString() const;
+
+    Op op;
+    std::uint8_t hardware_type;
+    std::uint8_t hardware_address_length;
+    std::uint8_t hops;
+    std::uint32_t transaction_id;
+    std::uint16_t seconds;
+    std::uint16_t flags;
+    ac::IpV4Address client_address;
+    ac::IpV4Address your_address;
+    ac::IpV4Address server_address;
+    ac::IpV4Address relay_address;
+    std::array<std::uint8_t, 16> hardware_address;
+
+private:
+    std::map<std::uint8_t, std::vector<std::uint8_t>> options_;
+};
+} // namespace w11tng
+
+#endif
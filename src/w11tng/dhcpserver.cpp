@@ -19,111 +19,233 @@
 #include <linux/netlink.h>
 #include <linux/rtnetlink.h>
 #include <sys/socket.h>
-#include <sys/prctl.h>
 
-#include <boost/filesystem.hpp>
-
-#include <ac/config.h>
+#include <ac/keep_alive.h>
 #include <ac/logger.h>
 #include <ac/networkutils.h>
-#include <ac/keep_alive.h>
-
-#include <w11tng/config.h>
 
 #include "dhcpserver.h"
-#include "dhcpleaseparser.h"
+
+namespace {
+ac::IpV4Address NetmaskFromPrefixLength(unsigned char prefix_length) {
+    if (prefix_length == 0)
+        return ac::IpV4Address::any();
+    if (prefix_length >= 32)
+        return ac::IpV4Address::broadcast();
+    return ac::IpV4Address(0xffffffffu << (32 - prefix_length));
+}
+}
 
 namespace w11tng {
 
+constexpr std::chrono::seconds DhcpServer::kDefaultLeaseTime;
+
+DhcpServer::Config DhcpServer::DefaultConfig() {
+    Config config;
+    config.local_address = ac::IpV4Address::from_string("192.168.7.1");
+    config.pool_address = ac::IpV4Address::from_string("192.168.7.5");
+    config.prefix_length = 24;
+    config.lease_time = kDefaultLeaseTime;
+    config.server_port = DhcpMessage::kServerPort;
+    config.client_port = DhcpMessage::kClientPort;
+    config.configure_interface = true;
+    return config;
+}
+
 DhcpServer::Ptr DhcpServer::Create(const std::weak_ptr<Delegate> &delegate, const std::string &interface_name) {
-    auto sp = std::shared_ptr<DhcpServer>(new DhcpServer(delegate, interface_name));
+    return Create(delegate, interface_name, DefaultConfig());
+}
+
+DhcpServer::Ptr DhcpServer::Create(const std::weak_ptr<Delegate> &delegate, const std::string &interface_name, const Config &config) {
+    auto sp = std::shared_ptr<DhcpServer>(new DhcpServer(delegate, interface_name, config));
     sp->Start();
     return sp;
 }
 
-DhcpServer::DhcpServer(const std::weak_ptr<Delegate> &delegate, const std::string &interface_name) :
+DhcpServer::DhcpServer(const std::weak_ptr<Delegate> &delegate, const std::string &interface_name, const Config &config) :
     delegate_(delegate),
-    interface_name_(interface_name) {
+    interface_name_(interface_name),
+    config_(config) {
+}
 
-    lease_file_path_ = ac::Utils::Sprintf("%s/dhcpd-%s-%s.leases",
-                                           ac::kRuntimePath,
-                                           boost::filesystem::unique_path().string(),
-                                           interface_name);
+DhcpServer::~DhcpServer() {
+}
 
-    pid_file_path_ = ac::Utils::Sprintf("%s/dhcpd-%s.pid",
-                                         ac::kRuntimePath,
-                                         interface_name_);
+void DhcpServer::Start() {
+    if (config_.configure_interface) {
+        const auto netmask = NetmaskFromPrefixLength(config_.prefix_length);
+        const auto broadcast = ac::IpV4Address(config_.local_address.to_ulong() | ~netmask.to_ulong());
+
+        auto interface_index = ac::NetworkUtils::RetrieveInterfaceIndex(interface_name_.c_str());
+        if (interface_index < 0)
+            AC_ERROR("Failed to determine index of network interface: %s", interface_name_);
+
+        if (ac::NetworkUtils::ModifyInterfaceAddress(RTM_NEWADDR, NLM_F_REPLACE | NLM_F_ACK, interface_index,
+                                        AF_INET, config_.local_address.to_string().c_str(),
+                                        NULL, config_.prefix_length, broadcast.to_string().c_str()) < 0) {
+            AC_ERROR("Failed to assign network address for %s", interface_name_);
+            ReportStartFailed();
+            return;
+        }
+
+        AC_DEBUG("Assigned network address %s", config_.local_address.to_string());
+    }
 
+    socket_ = DhcpSocket::Create(shared_from_this(), interface_name_, config_.server_port);
+    if (!socket_) {
+        ReportStartFailed();
+        return;
+    }
 
-    local_address_ = ac::IpV4Address::from_string("192.168.7.1");
+    AC_DEBUG("Serving %s on %s", config_.pool_address.to_string(), interface_name_);
 }
 
-DhcpServer::~DhcpServer() {
-    ::unlink(lease_file_path_.c_str());
-    ::unlink(pid_file_path_.c_str());
+void DhcpServer::ReportStartFailed() {
+    // Our creator doesn't hold a reference to us yet so tell it from
+    // the mainloop.
+    g_idle_add_full(G_PRIORITY_DEFAULT, &DhcpServer::OnStartFailed,
+                    new ac::WeakKeepAlive<DhcpServer>(shared_from_this()),
+                    [](gpointer data) { delete static_cast<ac::WeakKeepAlive<DhcpServer>*>(data); });
 }
 
-void DhcpServer::Start() {
-    if (boost::filesystem::is_regular(pid_file_path_)) {
-        AC_ERROR("DHCP server already running");
+gboolean DhcpServer::OnStartFailed(gpointer user_data) {
+    auto thiz = static_cast<ac::WeakKeepAlive<DhcpServer>*>(user_data)->GetInstance().lock();
+    if (!thiz)
+        return FALSE;
+
+    if (auto sp = thiz->delegate_.lock())
+        sp->OnDhcpTerminated();
+
+    return FALSE;
+}
+
+void DhcpServer::OnMessageReceived(const DhcpMessage &message) {
+    if (message.op != DhcpMessage::Op::kBootRequest)
         return;
+
+    AC_DEBUG("%s from %s", DhcpMessage::TypeToString(message.MessageType()),
+             message.HardwareAddressToString());
+
+    switch (message.MessageType()) {
+    case DhcpMessage::Type::kDiscover:
+        HandleDiscover(message);
+        break;
+    case DhcpMessage::Type::kRequest:
+        HandleRequest(message);
+        break;
+    case DhcpMessage::Type::kDecline:
+        AC_WARNING("Client %s reports %s to be in use already",
+                   message.HardwareAddressToString(), config_.pool_address.to_string());
+        HandleRelease(message);
+        break;
+    case DhcpMessage::Type::kRelease:
+        HandleRelease(message);
+        break;
+    default:
+        break;
     }
+}
 
-    if (!ac::Utils::CreateFile(lease_file_path_)) {
-        AC_ERROR("Failed to create database for DHCP leases at %s",
-                  lease_file_path_);
+void DhcpServer::HandleDiscover(const DhcpMessage &message) {
+    if (IsLeasedToOtherClient(message)) {
+        AC_WARNING("Not offering an address to %s as the only one is taken",
+                   message.HardwareAddressToString());
         return;
     }
 
-    monitor_ = FileMonitor::Create(lease_file_path_, shared_from_this());
+    SendReply(message, CreateReply(message, DhcpMessage::Type::kOffer));
+}
 
-    // FIXME store those defaults somewhere else
-    const char *broadcast = "192.168.7.255";
-    unsigned char prefixlen = 24;
+void DhcpServer::HandleRequest(const DhcpMessage &message) {
+    const auto server_identifier = message.AddressOption(DhcpMessage::Option::kServerIdentifier);
+    // The client selected another server
+    if (!server_identifier.is_unspecified() && server_identifier != config_.local_address)
+        return;
 
-    auto interface_index = ac::NetworkUtils::RetrieveInterfaceIndex(interface_name_.c_str());
-    if (interface_index < 0)
-        AC_ERROR("Failed to determine index of network interface: %s", interface_name_);
+    // Clients renewing their lease don't send the requested address
+    auto requested_address = message.AddressOption(DhcpMessage::Option::kRequestedAddress);
+    if (requested_address.is_unspecified())
+        requested_address = message.client_address;
 
-    if (ac::NetworkUtils::ModifyInterfaceAddress(RTM_NEWADDR, NLM_F_REPLACE | NLM_F_ACK, interface_index,
-                                    AF_INET, local_address_.to_string().c_str(),
-                                    NULL, prefixlen, broadcast) < 0) {
-        AC_ERROR("Failed to assign network address for %s", interface_name_);
+    if (requested_address != config_.pool_address || IsLeasedToOtherClient(message)) {
+        AC_DEBUG("Rejecting request of %s for %s", message.HardwareAddressToString(),
+                 requested_address.to_string());
+        SendReply(message, CreateReply(message, DhcpMessage::Type::kNak));
         return;
     }
 
-    AC_DEBUG("Assigned network address %s", local_address_.to_string());
+    const auto client = message.HardwareAddressToString();
+    const auto renewed = (lease_owner_ == client);
 
-    std::vector<std::string> argv = {
-        "-f", "-4",
-        "-d",
-        "-cf", "/etc/aethercast/dhcpd.conf",
-        "-pf", pid_file_path_,
-        "-lf", lease_file_path_,
-        interface_name_
-    };
+    lease_owner_ = client;
+    lease_expiry_ = std::chrono::steady_clock::now() + config_.lease_time;
 
-    executor_ = ProcessExecutor::Create(kDhcpServerPath, argv, shared_from_this());
-}
+    SendReply(message, CreateReply(message, DhcpMessage::Type::kAck));
+
+    if (renewed)
+        return;
+
+    AC_DEBUG("Assigned %s to %s", config_.pool_address.to_string(), client);
 
-void DhcpServer::OnProcessTerminated() {
     if (auto sp = delegate_.lock())
-        sp->OnDhcpTerminated();
+        sp->OnDhcpAddressAssigned(config_.local_address, config_.pool_address);
 }
 
-void DhcpServer::OnFileChanged(const std::string &path) {
-    auto leases = DhcpLeaseParser::FromFile(path);
-    if (leases.size() != 1)
+void DhcpServer::HandleRelease(const DhcpMessage &message) {
+    if (lease_owner_ != message.HardwareAddressToString())
         return;
 
-    auto actual_lease = leases[0];
+    lease_owner_.clear();
+}
 
-    if (auto sp = delegate_.lock())
-        sp->OnDhcpAddressAssigned(local_address_, actual_lease.FixedAddress());
+bool DhcpServer::IsLeasedToOtherClient(const DhcpMessage &message) const {
+    return lease_owner_.length() > 0 &&
+           lease_owner_ != message.HardwareAddressToString() &&
+           std::chrono::steady_clock::now() < lease_expiry_;
+}
+
+DhcpMessage DhcpServer::CreateReply(const DhcpMessage &message, DhcpMessage::Type type) const {
+    auto reply = message.CreateReply(type);
+    reply.SetAddressOption(DhcpMessage::Option::kServerIdentifier, config_.local_address);
+
+    if (type == DhcpMessage::Type::kNak)
+        return reply;
+
+    const auto netmask = NetmaskFromPrefixLength(config_.prefix_length);
+    const auto lease_time = static_cast<std::uint32_t>(config_.lease_time.count());
+
+    reply.your_address = config_.pool_address;
+    reply.SetUint32Option(DhcpMessage::Option::kLeaseTime, lease_time);
+    reply.SetUint32Option(DhcpMessage::Option::kRenewalTime, lease_time / 2);
+    reply.SetUint32Option(DhcpMessage::Option::kRebindingTime, lease_time / 8 * 7);
+    reply.SetAddressOption(DhcpMessage::Option::kSubnetMask, netmask);
+    reply.SetAddressOption(DhcpMessage::Option::kBroadcastAddress,
+                           ac::IpV4Address(config_.local_address.to_ulong() | ~netmask.to_ulong()));
+
+    return reply;
+}
+
+void DhcpServer::SendReply(const DhcpMessage &message, const DhcpMessage &reply) {
+    if (!socket_)
+        return;
+
+    // See RFC 2131 section 4.1 for where replies go. We can't unicast
+    // to a client without an address as that needs an ARP entry so
+    // those always get a broadcast.
+    if (!message.relay_address.is_unspecified())
+        socket_->Send(reply, message.relay_address, config_.server_port);
+    else if (reply.MessageType() != DhcpMessage::Type::kNak && !message.client_address.is_unspecified())
+        socket_->Send(reply, message.client_address, config_.client_port);
+    else
+        socket_->Send(reply, ac::IpV4Address::broadcast(), config_.client_port);
 }
 
 ac::IpV4Address DhcpServer::LocalAddress() const {
-    return local_address_;
+    return config_.local_address;
+}
+
+std::uint16_t DhcpServer::Port() const {
+    return socket_ ? socket_->Port() : 0;
 }
 
 }
@@ -18,8 +18,7 @@
 #ifndef W11TNG_DHCPSERVER_H_
 #define W11TNG_DHCPSERVER_H_
 
-#include <boost/noncopyable.hpp>
-
+#include <chrono>
 #include <string>
 
 #include <ac/glib_wrapper.h>
@@ -27,44 +26,79 @@
 #include <ac/ip_v4_address.h>
 #include <ac/non_copyable.h>
 
-#include "processexecutor.h"
-#include "filemonitor.h"
+#include "dhcpmessage.h"
+#include "dhcpsocket.h"
 
 namespace w11tng {
+// DhcpServer hands out the address of the only other peer of a P2P
+// group we own. It answers DISCOVER and REQUEST messages for a pool of
+// a single address from the main loop and reports the address to its
+// delegate as soon as it was acknowledged.
 class DhcpServer : public std::enable_shared_from_this<DhcpServer>,
-                   public ProcessExecutor::Delegate,
-                   public FileMonitor::Delegate {
+                   public DhcpSocket::Delegate {
 public:
     typedef std::shared_ptr<DhcpServer> Ptr;
 
+    static constexpr std::chrono::seconds kDefaultLeaseTime{3600};
+
     class Delegate : private ac::NonCopyable {
     public:
         virtual void OnDhcpAddressAssigned(const ac::IpV4Address &local_address, const ac::IpV4Address &remote_address) = 0;
         virtual void OnDhcpTerminated() = 0;
     };
 
+    struct Config {
+        ac::IpV4Address local_address;
+        ac::IpV4Address pool_address;
+        unsigned char prefix_length;
+        std::chrono::seconds lease_time;
+        std::uint16_t server_port;
+        std::uint16_t client_port;
+        // Whether local_address is assigned to the interface before
+        // the server starts. Tests running over loopback don't want
+        // that.
+        bool configure_interface;
+    };
+
+    // 192.168.7.1 for us and 192.168.7.5 for the peer
+    static Config DefaultConfig();
+
     static Ptr Create(const std::weak_ptr<Delegate> &delegate, const std::string &interface_name);
+    static Ptr Create(const std::weak_ptr<Delegate> &delegate, const std::string &interface_name, const Config &config);
 
     ~DhcpServer();
 
     ac::IpV4Address LocalAddress() const;
+    // The port we listen on which only differs from the configured one
+    // when that was zero.
+    std::uint16_t Port() const;
 
-    void OnProcessTerminated() override;
-    void OnFileChanged(const std::string &path) override;
+    void OnMessageReceived(const DhcpMessage &message) override;
 
 private:
-    DhcpServer(const std::weak_ptr<Delegate> &delegate, const std::string &interface_name);
+    static gboolean OnStartFailed(gpointer user_data);
+
+    DhcpServer(const std::weak_ptr<Delegate> &delegate, const std::string &interface_name, const Config &config);
 
     void Start();
+    void ReportStartFailed();
+
+    void HandleDiscover(const DhcpMessage &message);
+    void HandleRequest(const DhcpMessage &message);
+    void HandleRelease(const DhcpMessage &message);
+
+    bool IsLeasedToOtherClient(const DhcpMessage &message) const;
+    DhcpMessage CreateReply(const DhcpMessage &message, DhcpMessage::Type type) const;
+    void SendReply(const DhcpMessage &message, const DhcpMessage &reply);
 
 private:
     std::weak_ptr<Delegate> delegate_;
     std::string interface_name_;
-    std::string lease_file_path_;
-    std::string pid_file_path_;
-    ProcessExecutor::Ptr executor_;
-    FileMonitor::Ptr monitor_;
-    ac::IpV4Address local_address_;
+    Config config_;
+    DhcpSocket::Ptr socket_;
+    // Hardware address of the client holding the pool address
+    std::string lease_owner_;
+    std::chrono::steady_clock::time_point lease_expiry_;
 };
 }
 #endif
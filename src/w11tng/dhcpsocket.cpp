@@ -0,0 +1,180 @@
+/*
+ * Copyright (C) 2016 Canonical, Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 3, as published
+ * by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranties of
+ * MERCHANTABILITY, SATISFACTORY QUALITY, or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstring>
+
+#include <boost/concept_check.hpp>
+
+#include <ac/keep_alive.h>
+#include <ac/logger.h>
+
+#include "dhcpsocket.h"
+
+namespace w11tng {
+
+DhcpSocket::Ptr DhcpSocket::Create(const std::weak_ptr<Delegate> &delegate, const std::string &interface_name, std::uint16_t port) {
+    auto sp = std::shared_ptr<DhcpSocket>(new DhcpSocket(delegate));
+    if (!sp->Setup(interface_name, port))
+        return nullptr;
+    return sp;
+}
+
+DhcpSocket::DhcpSocket(const std::weak_ptr<Delegate> &delegate) :
+    delegate_(delegate),
+    socket_source_(0),
+    port_(0) {
+}
+
+DhcpSocket::~DhcpSocket() {
+    if (socket_source_ > 0)
+        g_source_remove(socket_source_);
+}
+
+bool DhcpSocket::Setup(const std::string &interface_name, std::uint16_t port) {
+    const auto fd = ::socket(AF_INET, SOCK_DGRAM | SOCK_NONBLOCK | SOCK_CLOEXEC, IPPROTO_UDP);
+    if (fd < 0) {
+        AC_ERROR("Failed to create DHCP socket: %s", ::strerror(errno));
+        return false;
+    }
+
+    const int enable = 1;
+    if (::setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &enable, sizeof(enable)) < 0 ||
+        ::setsockopt(fd, SOL_SOCKET, SO_BROADCAST, &enable, sizeof(enable)) < 0) {
+        AC_ERROR("Failed to configure DHCP socket: %s", ::strerror(errno));
+        ::close(fd);
+        return false;
+    }
+
+    if (interface_name.length() > 0 &&
+        ::setsockopt(fd, SOL_SOCKET, SO_BINDTODEVICE, interface_name.c_str(), interface_name.length() + 1) < 0) {
+        AC_ERROR("Failed to bind DHCP socket to %s: %s", interface_name, ::strerror(errno));
+        ::close(fd);
+        return false;
+    }
+
+    struct sockaddr_in addr;
+    ::memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_ANY);
+    addr.sin_port = htons(port);
+
+    socklen_t addr_length = sizeof(addr);
+    if (::bind(fd, reinterpret_cast<struct sockaddr*>(&addr), sizeof(addr)) < 0 ||
+        ::getsockname(fd, reinterpret_cast<struct sockaddr*>(&addr), &addr_length) < 0) {
+        AC_ERROR("Failed to bind DHCP socket to port %d: %s", port, ::strerror(errno));
+        ::close(fd);
+        return false;
+    }
+
+    port_ = ntohs(addr.sin_port);
+
+    GError *error = nullptr;
+    socket_.reset(g_socket_new_from_fd(fd, &error));
+    if (!socket_) {
+        AC_ERROR("Failed to setup DHCP socket: %s", error->message);
+        g_error_free(error);
+        ::close(fd);
+        return false;
+    }
+
+    auto source = g_socket_create_source(socket_.get(), G_IO_IN, nullptr);
+    if (!source) {
+        AC_ERROR("Failed to setup listener for DHCP messages");
+        return false;
+    }
+
+    g_source_set_callback(source, (GSourceFunc) &DhcpSocket::OnDataAvailable,
+                          new ac::WeakKeepAlive<DhcpSocket>(shared_from_this()),
+                          [](gpointer data) { delete static_cast<ac::WeakKeepAlive<DhcpSocket>*>(data); });
+
+    socket_source_ = g_source_attach(source, nullptr);
+    g_source_unref(source);
+
+    if (socket_source_ == 0) {
+        AC_ERROR("Failed to attach DHCP socket to mainloop");
+        return false;
+    }
+
+    return true;
+}
+
+gboolean DhcpSocket::OnDataAvailable(GSocket *socket, GIOCondition condition, gpointer user_data) {
+    boost::ignore_unused_variable_warning(condition);
+
+    auto thiz = static_cast<ac::WeakKeepAlive<DhcpSocket>*>(user_data)->GetInstance().lock();
+    if (!thiz)
+        return FALSE;
+
+    const auto fd = g_socket_get_fd(socket);
+
+    std::uint8_t data[DhcpMessage::kMaxSize * 2];
+
+    // We get called again as long as there is more to read.
+    const auto bytes_read = ::recv(fd, data, sizeof(data), 0);
+    if (bytes_read < 0) {
+        if (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR)
+            AC_WARNING("Failed to receive DHCP message: %s", ::strerror(errno));
+        return TRUE;
+    }
+
+    DhcpMessage message;
+    if (!DhcpMessage::Parse(data, bytes_read, message)) {
+        AC_DEBUG("Ignoring invalid DHCP message of %d bytes", bytes_read);
+        return TRUE;
+    }
+
+    if (auto sp = thiz->delegate_.lock())
+        sp->OnMessageReceived(message);
+
+    return TRUE;
+}
+
+bool DhcpSocket::Send(const DhcpMessage &message, const ac::IpV4Address &address, std::uint16_t port) {
+    if (!socket_)
+        return false;
+
+    const auto data = message.Serialize();
+
+    struct sockaddr_in addr;
+    ::memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(address.to_ulong());
+    addr.sin_port = htons(port);
+
+    const auto bytes_sent = ::sendto(g_socket_get_fd(socket_.get()), data.data(), data.size(), 0,
+                                     reinterpret_cast<struct sockaddr*>(&addr), sizeof(addr));
+    if (bytes_sent < 0) {
+        AC_WARNING("Failed to send DHCP %s to %s: %s",
+                   DhcpMessage::TypeToString(message.MessageType()),
+                   address.to_string(), ::strerror(errno));
+        return false;
+    }
+
+    return true;
+}
+
+std::uint16_t DhcpSocket::Port() const {
+    return port_;
+}
+
+} // namespace w11tng
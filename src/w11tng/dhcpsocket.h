@@ -0,0 +1,73 @@
+/*
+ * Copyright (C) 2016 Canonical, Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 3, as published
+ * by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranties of
+ * MERCHANTABILITY, SATISFACTORY QUALITY, or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef W11TNG_DHCPSOCKET_H_
+#define W11TNG_DHCPSOCKET_H_
+
+#include <cstdint>
+#include <memory>
+#include <string>
+
+#include <ac/glib_wrapper.h>
+
+#include <ac/ip_v4_address.h>
+#include <ac/non_copyable.h>
+#include <ac/scoped_gobject.h>
+
+#include "dhcpmessage.h"
+
+namespace w11tng {
+// DhcpSocket sends and receives DHCP messages over UDP on a single
+// network interface. Incoming messages are delivered from the main
+// loop. Being bound to the interface allows to talk to peers while
+// the interface doesn't have an address yet.
+class DhcpSocket : public std::enable_shared_from_this<DhcpSocket> {
+public:
+    typedef std::shared_ptr<DhcpSocket> Ptr;
+
+    class Delegate : private ac::NonCopyable {
+    public:
+        virtual void OnMessageReceived(const DhcpMessage &message) = 0;
+    };
+
+    // Binds to port on the interface with the given name or on all
+    // interfaces if the name is empty. A port of zero picks a free one.
+    // Returns nullptr on failure.
+    static Ptr Create(const std::weak_ptr<Delegate> &delegate, const std::string &interface_name, std::uint16_t port);
+
+    ~DhcpSocket();
+
+    bool Send(const DhcpMessage &message, const ac::IpV4Address &address, std::uint16_t port);
+
+    std::uint16_t Port() const;
+
+private:
+    static gboolean OnDataAvailable(GSocket *socket, GIOCondition condition, gpointer user_data);
+
+    DhcpSocket(const std::weak_ptr<Delegate> &delegate);
+
+    bool Setup(const std::string &interface_name, std::uint16_t port);
+
+private:
+    std::weak_ptr<Delegate> delegate_;
+    ac::ScopedGObject<GSocket> socket_;
+    guint socket_source_;
+    std::uint16_t port_;
+};
+} // namespace w11tng
+
+#endif
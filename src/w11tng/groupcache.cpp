@@ -0,0 +1,223 @@
+/*
+ * Copyright (C) 2016 Canonical, Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 3, as published
+ * by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranties of
+ * MERCHANTABILITY, SATISFACTORY QUALITY, or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+
+#include <boost/filesystem.hpp>
+
+#include <ac/logger.h>
+#include <ac/utils.h>
+
+#include "groupcache.h"
+
+namespace {
+constexpr const char *kHeader{"# peer role frequency ssid passphrase psk address group_bssid"};
+// Stands in for empty fields so every line has the same number of them
+constexpr const char *kEmptyField{"-"};
+
+std::string EncodeField(const std::string &value) {
+    if (value.length() == 0)
+        return kEmptyField;
+
+    std::string encoded;
+    for (const auto c : value)
+        encoded += ac::Utils::Sprintf("%02x", static_cast<unsigned int>(static_cast<unsigned char>(c)));
+    return encoded;
+}
+
+bool DecodeField(const std::string &field, std::string &value) {
+    value.clear();
+
+    if (field == kEmptyField)
+        return true;
+
+    if (field.length() % 2 != 0)
+        return false;
+
+    for (std::size_t n = 0; n < field.length(); n += 2) {
+        char *end = nullptr;
+        const auto byte = field.substr(n, 2);
+        const auto c = ::strtoul(byte.c_str(), &end, 16);
+        if (!end || *end != '\0')
+            return false;
+        value += static_cast<char>(c);
+    }
+    return true;
+}
+}
+
+namespace w11tng {
+
+constexpr std::size_t GroupCache::kMaxEntries;
+
+bool GroupCache::Entry::operator==(const Entry &other) const {
+    return peer == other.peer &&
+            role == other.role &&
+            ssid == other.ssid &&
+            passphrase == other.passphrase &&
+            psk == other.psk &&
+            frequency == other.frequency &&
+            address == other.address &&
+            group_bssid == other.group_bssid;
+}
+
+GroupCache::GroupCache(const std::string &path, std::size_t max_entries) :
+    path_(path),
+    max_entries_(max_entries) {
+}
+
+bool GroupCache::Load() {
+    entries_.clear();
+
+    if (!boost::filesystem::is_regular_file(path_))
+        return false;
+
+    std::ifstream stream(path_);
+    std::string line;
+    while (std::getline(stream, line, '\n')) {
+        if (line.length() == 0 || ac::Utils::StringStartsWith(line, "#"))
+            continue;
+
+        std::istringstream fields(line);
+        std::string ssid, passphrase, psk, address;
+        Entry entry;
+        if (!(fields >> entry.peer >> entry.role >> entry.frequency >> ssid >> passphrase >> psk >> address) ||
+            !DecodeField(ssid, entry.ssid) ||
+            !DecodeField(passphrase, entry.passphrase) ||
+            !DecodeField(psk, entry.psk)) {
+            AC_WARNING("Ignoring malformed P2P group entry in %s", path_);
+            continue;
+        }
+
+        if (address != kEmptyField) {
+            boost::system::error_code ec;
+            entry.address = ac::IpV4Address::from_string(address, ec);
+        }
+
+        // Entries written before we kept the BSSID don't have one
+        std::string group_bssid;
+        if (fields >> group_bssid && group_bssid != kEmptyField)
+            entry.group_bssid = group_bssid;
+
+        if (entries_.size() < max_entries_)
+            entries_.push_back(entry);
+    }
+
+    AC_DEBUG("Loaded %d P2P groups from %s", entries_.size(), path_);
+
+    return true;
+}
+
+bool GroupCache::Save() const {
+    std::stringstream content;
+    content << kHeader << std::endl;
+    for (const auto &entry : entries_) {
+        content << entry.peer << " "
+                << entry.role << " "
+                << entry.frequency << " "
+                << EncodeField(entry.ssid) << " "
+                << EncodeField(entry.passphrase) << " "
+                << EncodeField(entry.psk) << " "
+                << (entry.address.is_unspecified() ? std::string(kEmptyField) : entry.address.to_string()) << " "
+                << (entry.group_bssid.length() == 0 ? std::string(kEmptyField) : entry.group_bssid)
+                << std::endl;
+    }
+
+    const auto data = content.str();
+
+    const auto directory = boost::filesystem::path(path_).parent_path();
+    boost::system::error_code ec;
+    if (!directory.empty() && !boost::filesystem::is_directory(directory))
+        boost::filesystem::create_directories(directory, ec);
+
+    // The file holds the credentials of all groups so nobody else should
+    // be able to read it. We write a temporary file first so a crash
+    // can't leave a truncated one behind.
+    const auto tmp_path = path_ + ".tmp";
+    const auto fd = ::open(tmp_path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0600);
+    if (fd < 0) {
+        AC_ERROR("Failed to open %s: %s", tmp_path, ::strerror(errno));
+        return false;
+    }
+
+    std::size_t written = 0;
+    while (written < data.length()) {
+        const auto ret = ::write(fd, data.c_str() + written, data.length() - written);
+        if (ret < 0) {
+            if (errno == EINTR)
+                continue;
+
+            AC_ERROR("Failed to write P2P groups to %s: %s", tmp_path, ::strerror(errno));
+            ::close(fd);
+            ::unlink(tmp_path.c_str());
+            return false;
+        }
+        written += ret;
+    }
+
+    ::close(fd);
+
+    if (::rename(tmp_path.c_str(), path_.c_str()) < 0) {
+        AC_ERROR("Failed to move P2P groups to %s: %s", path_, ::strerror(errno));
+        ::unlink(tmp_path.c_str());
+        return false;
+    }
+
+    return true;
+}
+
+bool GroupCache::Lookup(const ac::MacAddress &peer, Entry &entry) {
+    for (auto it = entries_.begin(); it != entries_.end(); ++it) {
+        if (it->peer != peer)
+            continue;
+
+        entries_.splice(entries_.begin(), entries_, it);
+        entry = entries_.front();
+        return true;
+    }
+    return false;
+}
+
+void GroupCache::Store(const Entry &entry) {
+    Remove(entry.peer);
+
+    entries_.push_front(entry);
+
+    while (entries_.size() > max_entries_)
+        entries_.pop_back();
+}
+
+void GroupCache::Remove(const ac::MacAddress &peer) {
+    entries_.remove_if([&](const Entry &entry) { return entry.peer == peer; });
+}
+
+std::size_t GroupCache::Size() const {
+    return entries_.size();
+}
+
+std::string GroupCache::Path() const {
+    return path_;
+}
+
+} // namespace w11tng
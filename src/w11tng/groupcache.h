@@ -0,0 +1,78 @@
+/*
+ * Copyright (C) 2016 Canonical, Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 3, as published
+ * by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranties of
+ * MERCHANTABILITY, SATISFACTORY QUALITY, or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef W11TNG_GROUPCACHE_H_
+#define W11TNG_GROUPCACHE_H_
+
+#include <list>
+#include <string>
+
+#include <ac/ip_v4_address.h>
+#include <ac/mac_address.h>
+
+namespace w11tng {
+// GroupCache remembers the persistent P2P groups we formed with our
+// peers so a reconnect can reinvoke the group instead of going through
+// find, group owner negotiation and WPS provisioning again. The number
+// of entries is bounded; the least recently used group is dropped first.
+class GroupCache {
+public:
+    static constexpr std::size_t kMaxEntries{8};
+
+    struct Entry {
+        ac::MacAddress peer;
+        // Our own role in the group, either "GO" or "client"
+        std::string role;
+        std::string ssid;
+        // Only known when we owned the group
+        std::string passphrase;
+        // Raw key as wpa_supplicant reports it to group clients
+        std::string psk;
+        int frequency{0};
+        // The address we had inside the group
+        ac::IpV4Address address;
+        // Interface address of the group owner. Unlike its device
+        // address this is what a client needs to rejoin the group.
+        ac::MacAddress group_bssid;
+
+        bool operator==(const Entry &other) const;
+    };
+
+    explicit GroupCache(const std::string &path, std::size_t max_entries = kMaxEntries);
+
+    bool Load();
+    bool Save() const;
+
+    // Marks the entry found as the most recently used one
+    bool Lookup(const ac::MacAddress &peer, Entry &entry);
+    // Adds or replaces the entry for the peer and marks it as the most
+    // recently used one.
+    void Store(const Entry &entry);
+    void Remove(const ac::MacAddress &peer);
+
+    std::size_t Size() const;
+    std::string Path() const;
+
+private:
+    std::string path_;
+    std::size_t max_entries_;
+    // Most recently used entry first
+    std::list<Entry> entries_;
+};
+} // namespace w11tng
+
+#endif
@@ -0,0 +1,123 @@
+/*
+ * Copyright (C) 2016 Canonical, Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 3, as published
+ * by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranties of
+ * MERCHANTABILITY, SATISFACTORY QUALITY, or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <ac/keep_alive.h>
+#include <ac/logger.h>
+#include <ac/utils.h>
+
+#include "groupstub.h"
+
+namespace w11tng {
+
+GroupStub::Ptr GroupStub::Create(const std::string &object_path) {
+    return std::shared_ptr<GroupStub>(new GroupStub)->FinalizeConstruction(object_path);
+}
+
+GroupStub::Ptr GroupStub::FinalizeConstruction(const std::string &object_path) {
+    auto sp = shared_from_this();
+
+    GError *error = nullptr;
+    connection_.reset(g_bus_get_sync(G_BUS_TYPE_SYSTEM, nullptr, &error));
+    if (!connection_) {
+        AC_ERROR("Failed to connect to system bus: %s", error->message);
+        g_error_free(error);
+        return sp;
+    }
+
+    wpa_supplicant_group_proxy_new(connection_.get(), G_DBUS_PROXY_FLAGS_DO_NOT_AUTO_START,
+                                   kBusName,
+                                   object_path.c_str(),
+                                   nullptr,
+                                   [](GObject *source, GAsyncResult *res, gpointer user_data) {
+
+        auto inst = static_cast<ac::SharedKeepAlive<GroupStub>*>(user_data)->ShouldDie();
+
+        GError *error = nullptr;
+        inst->proxy_.reset(wpa_supplicant_group_proxy_new_finish(res, &error));
+        if (!inst->proxy_) {
+            AC_ERROR("Failed to connect with Group proxy: %s", error->message);
+            g_error_free(error);
+            return;
+        }
+
+        AC_DEBUG("Successfully setup group proxy");
+
+    }, new ac::SharedKeepAlive<GroupStub>{shared_from_this()});
+
+    return sp;
+}
+
+std::string GroupStub::RetrieveByteArrayFromProxy(const std::string &name) const {
+    if (!proxy_)
+        return "";
+
+    // Same as for the peer address gdbus-codegen doesn't give us
+    // properties of type 'ay' in a usable way.
+    auto variant = g_dbus_proxy_get_cached_property(G_DBUS_PROXY(proxy_.get()), name.c_str());
+    if (!variant)
+        return "";
+
+    std::string value;
+    GVariantIter iter;
+    guchar byte = 0;
+
+    g_variant_iter_init(&iter, variant);
+    while (g_variant_iter_next(&iter, "y", &byte))
+        value += static_cast<char>(byte);
+
+    g_variant_unref(variant);
+
+    return value;
+}
+
+std::string GroupStub::Ssid() const {
+    return RetrieveByteArrayFromProxy("SSID");
+}
+
+std::string GroupStub::Passphrase() const {
+    if (!proxy_)
+        return "";
+
+    return wpa_supplicant_group_get_passphrase(proxy_.get()) ? : "";
+}
+
+std::string GroupStub::Psk() const {
+    return RetrieveByteArrayFromProxy("PSK");
+}
+
+std::string GroupStub::Bssid() const {
+    const auto bssid = RetrieveByteArrayFromProxy("BSSID");
+    if (bssid.length() != 6)
+        return "";
+
+    std::string address;
+    for (std::size_t n = 0; n < bssid.length(); n++) {
+        if (n > 0)
+            address += ":";
+        address += ac::Utils::Sprintf("%02x", static_cast<unsigned int>(static_cast<unsigned char>(bssid[n])));
+    }
+    return address;
+}
+
+int GroupStub::Frequency() const {
+    if (!proxy_)
+        return 0;
+
+    return wpa_supplicant_group_get_frequency(proxy_.get());
+}
+
+} // namespace w11tng
@@ -0,0 +1,71 @@
+/*
+ * Copyright (C) 2016 Canonical, Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 3, as published
+ * by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranties of
+ * MERCHANTABILITY, SATISFACTORY QUALITY, or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef W11TNG_GROUP_STUB_H_
+#define W11TNG_GROUP_STUB_H_
+
+#include <memory>
+#include <string>
+
+#include <ac/shared_gobject.h>
+#include <ac/scoped_gobject.h>
+
+extern "C" {
+// Ignore all warnings coming from the external headers as we don't
+// control them and also don't want to get any warnings from them
+// which will only pollute our build output.
+#pragma GCC diagnostic push
+#pragma GCC diagnostic warning "-w"
+#include "wpasupplicantinterface.h"
+#pragma GCC diagnostic pop
+}
+
+namespace w11tng {
+
+class GroupStub : public std::enable_shared_from_this<GroupStub> {
+public:
+    static constexpr const char *kBusName{"fi.w1.wpa_supplicant1"};
+
+    typedef std::shared_ptr<GroupStub> Ptr;
+
+    static Ptr Create(const std::string &object_path);
+
+    bool Ready() const { return !!proxy_; }
+
+    std::string Ssid() const;
+    std::string Passphrase() const;
+    // The raw key; group clients don't get to know the passphrase
+    std::string Psk() const;
+    int Frequency() const;
+    // Interface address of the group owner
+    std::string Bssid() const;
+
+private:
+    GroupStub() { }
+
+    Ptr FinalizeConstruction(const std::string &object_path);
+
+    std::string RetrieveByteArrayFromProxy(const std::string &name) const;
+
+private:
+    ac::ScopedGObject<GDBusConnection> connection_;
+    ac::ScopedGObject<WpaSupplicantGroup> proxy_;
+};
+
+} // namespace w11tng
+
+#endif
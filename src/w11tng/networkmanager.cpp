@@ -16,13 +16,16 @@
  */
 
 #include <boost/concept_check.hpp>
+#include <boost/filesystem.hpp>
 
 #include <algorithm>
 #include <sstream>
 
+#include <ac/config.h>
 #include <ac/logger.h>
 #include <ac/keep_alive.h>
 #include <ac/networkutils.h>
+#include <ac/report/timeline/connectiontimeline.h>
 
 #include "w11tng/networkmanager.h"
 #include "w11tng/informationelement.h"
@@ -36,6 +39,8 @@ static const std::chrono::seconds kConnectTimeout{120};
 // As we play the source role we don't intent to be the group owner
 // and therefor use the lowest intent possible.
 static constexpr std::int32_t kSourceGoIntent = 0;
+// Lives next to the state files of the service
+static constexpr const char *kGroupCacheFileName{"p2p-groups"};
 }
 
 namespace w11tng {
@@ -73,7 +78,10 @@ NetworkManager::NetworkManager() :
     firmware_loader_("", this),
     dedicated_p2p_interface_(ac::Utils::GetEnvValue("AETHERCAST_DEDICATED_P2P_INTERFACE")),
     session_available_(true),
+    group_cache_((boost::filesystem::path(ac::kStateDir) / kGroupCacheFileName).string()),
+    reinvoking_group_(false),
     urfkill_watch_(0) {
+    group_cache_.Load();
 }
 
 NetworkManager::~NetworkManager() {
@@ -174,8 +182,13 @@ void NetworkManager::ReleaseInterface() {
         current_device_.reset();
         current_group_device_.reset();
         current_group_iface_.reset();
+        current_group_.reset();
     }
 
+    // The persistent group went away together with the interface
+    persistent_group_path_.clear();
+    reinvoking_group_ = false;
+
     if (p2p_device_)
         p2p_device_.reset();
 
@@ -275,6 +288,8 @@ void NetworkManager::StartConnectTimeout() {
             return FALSE;
 
         inst->p2p_device_->Cancel();
+        inst->reinvoking_group_ = false;
+        inst->ReleasePersistentGroup();
 
         inst->AdvanceDeviceState(inst->current_device_, ac::kFailure);
 
@@ -318,7 +333,7 @@ bool NetworkManager::Connect(const ac::NetworkDevice::Ptr &device) {
 
     p2p_device_->StopFind();
 
-    if (!p2p_device_->Connect(d->ObjectPath(), kSourceGoIntent))
+    if (!ReinvokeGroup(d) && !p2p_device_->Connect(d->ObjectPath(), kSourceGoIntent))
         return false;
 
     current_device_->SetState(ac::kAssociation);
@@ -330,6 +345,76 @@ bool NetworkManager::Connect(const ac::NetworkDevice::Ptr &device) {
     return true;
 }
 
+bool NetworkManager::ReinvokeGroup(const NetworkDevice::Ptr &device) {
+    GroupCache::Entry entry;
+    if (!group_cache_.Lookup(device->Address(), entry))
+        return false;
+
+    P2PDeviceStub::PersistentGroup group;
+    group.group_owner = (entry.role == "GO");
+    group.bssid = entry.group_bssid;
+    group.ssid = entry.ssid;
+    group.passphrase = entry.passphrase;
+    group.psk = entry.psk;
+    group.frequency = entry.frequency;
+
+    if (!p2p_device_->AddPersistentGroup(group))
+        return false;
+
+    AC_DEBUG("Reinvoking persistent group as %s with %s", entry.role, device->Address());
+
+    // We continue once wpa_supplicant knows about the group
+    reinvoking_group_ = true;
+
+    return true;
+}
+
+void NetworkManager::NegotiateGroup() {
+    AC_DEBUG("Failed to reinvoke group with %s, negotiating a new one", current_device_->Address());
+
+    reinvoking_group_ = false;
+    ReleasePersistentGroup();
+
+    // The peer doesn't know the group anymore or isn't answering in
+    // time. Either way the cached group is of no use anymore.
+    group_cache_.Remove(current_device_->Address());
+    group_cache_.Save();
+
+    if (!p2p_device_->Connect(current_device_->ObjectPath(), kSourceGoIntent))
+        HandleConnectFailed();
+}
+
+void NetworkManager::ReleasePersistentGroup() {
+    if (persistent_group_path_.length() == 0)
+        return;
+
+    if (p2p_device_)
+        p2p_device_->RemovePersistentGroup(persistent_group_path_);
+
+    persistent_group_path_.clear();
+}
+
+void NetworkManager::StoreGroup(const ac::IpV4Address &local_address) {
+    if (!current_group_ || !current_group_->Ready())
+        return;
+
+    GroupCache::Entry entry;
+    entry.peer = current_device_->Address();
+    entry.role = current_device_->Role();
+    entry.ssid = current_group_->Ssid();
+    entry.passphrase = current_group_->Passphrase();
+    entry.psk = current_group_->Psk();
+    entry.frequency = current_group_->Frequency();
+    entry.address = local_address;
+    entry.group_bssid = current_group_->Bssid();
+
+    if (entry.ssid.length() == 0 || (entry.passphrase.length() == 0 && entry.psk.length() == 0))
+        return;
+
+    group_cache_.Store(entry);
+    group_cache_.Save();
+}
+
 std::string NetworkManager::SelectHostname() {
     auto hostname = hostname_service_->PrettyHostname();
     if (hostname.length() == 0)
@@ -513,9 +598,46 @@ void NetworkManager::OnPeerConnectFailed() {
 
     AC_DEBUG("");
 
+    if (reinvoking_group_) {
+        NegotiateGroup();
+        return;
+    }
+
     HandleConnectFailed();
 }
 
+void NetworkManager::OnPersistentGroupAdded(const std::string &path) {
+    if (!current_device_ || !reinvoking_group_) {
+        p2p_device_->RemovePersistentGroup(path);
+        return;
+    }
+
+    AC_DEBUG("path %s", path);
+
+    persistent_group_path_ = path;
+
+    if (!p2p_device_->Invite(current_device_->ObjectPath(), persistent_group_path_))
+        NegotiateGroup();
+}
+
+void NetworkManager::OnInvitationResult(P2PDeviceStub::Status status) {
+    if (!current_device_ || !reinvoking_group_)
+        return;
+
+    AC_DEBUG("status %s", P2PDeviceStub::StatusToString(status));
+
+    // On success wpa_supplicant starts the group and we continue as
+    // with a freshly negotiated one. The invitation took the place of
+    // the group owner negotiation.
+    if (status == P2PDeviceStub::Status::kSuccess) {
+        if (const auto timeline = ac::report::timeline::ConnectionTimeline::Instance())
+            timeline->Mark(ac::report::timeline::ConnectionTimeline::Phase::kGroupNegotiated);
+        return;
+    }
+
+    NegotiateGroup();
+}
+
 void NetworkManager::OnGroupOwnerNegotiationFailure(const std::string &peer_path, const P2PDeviceStub::GroupOwnerNegotiationResult &result) {
     if (!current_device_)
         return;
@@ -541,6 +663,9 @@ void NetworkManager::OnGroupOwnerNegotiationSuccess(const std::string &peer_path
     AC_DEBUG("peer %s selected oper freq %d wps_method %s",
               peer_path, result.oper_freq, P2PDeviceStub::WpsMethodToString(result.wps_method));
     AC_DEBUG("intersect freqs [%s]", frequencies.str());
+
+    if (const auto timeline = ac::report::timeline::ConnectionTimeline::Instance())
+        timeline->Mark(ac::report::timeline::ConnectionTimeline::Phase::kGroupNegotiated);
 }
 
 void NetworkManager::OnGroupStarted(const std::string &group_path, const std::string &interface_path, const std::string &role) {
@@ -549,6 +674,11 @@ void NetworkManager::OnGroupStarted(const std::string &group_path, const std::st
 
     AC_DEBUG("group %s interface %s role %s", group_path, interface_path, role);
 
+    reinvoking_group_ = false;
+
+    if (const auto timeline = ac::report::timeline::ConnectionTimeline::Instance())
+        timeline->Mark(ac::report::timeline::ConnectionTimeline::Phase::kGroupStarted);
+
     AdvanceDeviceState(current_device_, ac::kConfiguration);
 
     current_device_->SetRole(role);
@@ -560,6 +690,9 @@ void NetworkManager::OnGroupStarted(const std::string &group_path, const std::st
 
     std::weak_ptr<P2PDeviceStub::Delegate> null_delegate;
     current_group_device_ = P2PDeviceStub::Create(interface_path, null_delegate);
+
+    // Provides the credentials we need to reinvoke the group later on
+    current_group_ = GroupStub::Create(group_path);
 }
 
 void NetworkManager::OnGroupFinished(const std::string &group_path, const std::string &interface_path) {
@@ -575,6 +708,9 @@ void NetworkManager::OnGroupFinished(const std::string &group_path, const std::s
 
     current_group_iface_.reset();
     current_group_device_.reset();
+    current_group_.reset();
+
+    ReleasePersistentGroup();
 
     AdvanceDeviceState(current_device_, ac::kDisconnected);
     current_device_.reset();
@@ -607,6 +743,11 @@ void NetworkManager::OnDhcpAddressAssigned(const ac::IpV4Address &local_address,
 
     StopConnectTimeout();
 
+    StoreGroup(local_address);
+
+    if (const auto timeline = ac::report::timeline::ConnectionTimeline::Instance())
+        timeline->Mark(ac::report::timeline::ConnectionTimeline::Phase::kAddressAssigned);
+
     AdvanceDeviceState(current_device_, ac::kConnected);
 }
 
@@ -766,10 +907,17 @@ void NetworkManager::OnGroupInterfaceReady() {
 
     auto sp = shared_from_this();
 
-    if (current_device_->Role() == "GO")
+    if (current_device_->Role() == "GO") {
         dhcp_server_ = w11tng::DhcpServer::Create(sp, ifname);
-    else
-        dhcp_client_ = w11tng::DhcpClient::Create(sp, ifname);
+    } else {
+        // Lets the client ask for the address we had in the group
+        // before without discovering first.
+        GroupCache::Entry entry;
+        if (group_cache_.Lookup(current_device_->Address(), entry))
+            w11tng::DhcpClient::RememberLease(current_device_->Address(), entry.address);
+
+        dhcp_client_ = w11tng::DhcpClient::Create(sp, ifname, current_device_->Address());
+    }
 }
 
 void NetworkManager::OnHostnameChanged() {
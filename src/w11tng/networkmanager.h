@@ -24,6 +24,8 @@
 
 #include "managerstub.h"
 #include "p2pdevicestub.h"
+#include "groupstub.h"
+#include "groupcache.h"
 #include "interfacestub.h"
 #include "interfaceselector.h"
 #include "dhcpserver.h"
@@ -82,6 +84,8 @@ public:
     void OnGroupStarted(const std::string &group_path, const std::string &interface_path, const std::string &role) override;
     void OnGroupFinished(const std::string &group_path, const std::string &interface_path) override;
     void OnGroupRequest(const std::string &peer_path, int dev_passwd_id) override;
+    void OnPersistentGroupAdded(const std::string &path) override;
+    void OnInvitationResult(P2PDeviceStub::Status status) override;
 
     void OnDeviceChanged(const NetworkDevice::Ptr &device) override;
     void OnDeviceReady(const NetworkDevice::Ptr &device) override;
@@ -137,6 +141,11 @@ private:
 
     void HandleConnectFailed();
 
+    bool ReinvokeGroup(const NetworkDevice::Ptr &device);
+    void NegotiateGroup();
+    void ReleasePersistentGroup();
+    void StoreGroup(const ac::IpV4Address &local_address);
+
     void OnGroupInterfaceReady();
     void OnManagementInterfaceReady();
 
@@ -159,6 +168,11 @@ private:
     NetworkDevice::Ptr current_device_;
     InterfaceStub::Ptr current_group_iface_;
     P2PDeviceStub::Ptr current_group_device_;
+    GroupStub::Ptr current_group_;
+    GroupCache group_cache_;
+    // The group we handed to wpa_supplicant to reinvoke it
+    std::string persistent_group_path_;
+    bool reinvoking_group_;
     std::shared_ptr<w11tng::DhcpClient> dhcp_client_;
     std::shared_ptr<w11tng::DhcpServer> dhcp_server_;
     InterfaceSelector::Ptr interface_selector_;
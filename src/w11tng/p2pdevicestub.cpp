@@ -23,6 +23,12 @@
 
 #include "p2pdevicestub.h"
 
+namespace {
+// Values of the mode network property, see wpas_mode in wpa_supplicant
+constexpr std::int32_t kModeInfrastructure{0};
+constexpr std::int32_t kModeGroupOwner{3};
+}
+
 namespace w11tng {
 
 std::string P2PDeviceStub::StatusToString(Status status) {
@@ -293,6 +299,30 @@ void P2PDeviceStub::OnGroupRequest(WpaSupplicantInterfaceP2PDevice *device, cons
         sp->OnGroupRequest(peer_path, dev_passwd_id);
 }
 
+void P2PDeviceStub::OnInvitationResult(WpaSupplicantInterfaceP2PDevice *device, GVariant *properties, gpointer user_data) {
+    auto inst = static_cast<ac::WeakKeepAlive<P2PDeviceStub>*>(user_data)->GetInstance().lock();
+
+    if (not inst)
+        return;
+
+    // wpa_supplicant reports a negative status when the peer never
+    // answered our invitation.
+    auto status = Status::kUnknown;
+
+    ac::dbus::Helpers::ParseDictionary(properties, [&](const std::string &name, GVariant *value) {
+        if (name == PropertyToString(Property::kStatus)) {
+            const auto v = g_variant_get_variant(value);
+            if (g_variant_is_of_type(v, G_VARIANT_TYPE("i")) && g_variant_get_int32(v) >= 0)
+                status = static_cast<Status>(g_variant_get_int32(v));
+        }
+    });
+
+    AC_DEBUG("status %s", StatusToString(status));
+
+    if (auto sp = inst->delegate_.lock())
+        sp->OnInvitationResult(status);
+}
+
 void P2PDeviceStub::ConnectSignals() {
     auto sp = shared_from_this();
 
@@ -309,6 +339,7 @@ void P2PDeviceStub::ConnectSignals() {
     CONNECT_SIGNAL("group-started", OnGroupStarted);
     CONNECT_SIGNAL("group-finished", OnGroupFinished);
     CONNECT_SIGNAL("gonegotiation-request", OnGroupRequest);
+    CONNECT_SIGNAL("invitation-result", OnInvitationResult);
 }
 
 void P2PDeviceStub::StartFindTimeout() {
@@ -416,6 +447,9 @@ bool P2PDeviceStub::Connect(const std::string &path, const std::int32_t intent)
     // We support only WPS PBC for now
     g_variant_builder_add(builder, "{sv}", "wps_method", g_variant_new_string(WpsMethodToString(WpsMethod::kPbc).c_str()));
     g_variant_builder_add(builder, "{sv}", "go_intent", g_variant_new_int32(intent));
+    // Persistent groups can be reinvoked later on which is a lot
+    // faster than forming a new group.
+    g_variant_builder_add(builder, "{sv}", "persistent", g_variant_new_boolean(TRUE));
 
     auto arguments = g_variant_builder_end(builder);
 
@@ -439,6 +473,37 @@ bool P2PDeviceStub::Connect(const std::string &path, const std::int32_t intent)
     return true;
 }
 
+bool P2PDeviceStub::Invite(const std::string &path, const std::string &persistent_group_path) {
+    if (!proxy_ || path.length() == 0 || persistent_group_path.length() == 0)
+        return false;
+
+    AC_DEBUG("path %s group %s", path, persistent_group_path);
+
+    auto builder = g_variant_builder_new(G_VARIANT_TYPE_ARRAY);
+    g_variant_builder_add(builder, "{sv}", "peer", g_variant_new_object_path(path.c_str()));
+    g_variant_builder_add(builder, "{sv}", "persistent_group_object", g_variant_new_object_path(persistent_group_path.c_str()));
+    auto arguments = g_variant_builder_end(builder);
+
+    wpa_supplicant_interface_p2_pdevice_call_invite(proxy_.get(), arguments, nullptr,
+                                                    [](GObject *source, GAsyncResult *res, gpointer user_data) {
+
+        auto inst = static_cast<ac::SharedKeepAlive<P2PDeviceStub>*>(user_data)->ShouldDie();
+
+        GError *error = nullptr;
+        if (!wpa_supplicant_interface_p2_pdevice_call_invite_finish(inst->proxy_.get(), res, &error)) {
+            AC_ERROR("Failed to invite P2P device: %s", error->message);
+            g_error_free(error);
+
+            if (auto sp = inst->delegate_.lock())
+                sp->OnPeerConnectFailed();
+
+            return;
+        }
+    }, new ac::SharedKeepAlive<P2PDeviceStub>{shared_from_this()});
+
+    return true;
+}
+
 bool P2PDeviceStub::Disconnect() {
     AC_DEBUG("");
 
@@ -508,6 +573,80 @@ void P2PDeviceStub::Cancel() {
     }, new ac::SharedKeepAlive<P2PDeviceStub>{shared_from_this()});
 }
 
+bool P2PDeviceStub::AddPersistentGroup(const PersistentGroup &group) {
+    if (!proxy_)
+        return false;
+
+    AC_DEBUG("ssid %s group owner %d", group.ssid, group.group_owner);
+
+    // wpa_supplicant quotes string values itself and hex encodes byte
+    // arrays as they would appear in a network block of its
+    // configuration file.
+    auto builder = g_variant_builder_new(G_VARIANT_TYPE_ARRAY);
+    g_variant_builder_add(builder, "{sv}", "ssid",
+                          g_variant_new_fixed_array(G_VARIANT_TYPE_BYTE, group.ssid.data(), group.ssid.length(), 1));
+    if (group.passphrase.length() > 0)
+        g_variant_builder_add(builder, "{sv}", "psk", g_variant_new_string(group.passphrase.c_str()));
+    else
+        g_variant_builder_add(builder, "{sv}", "psk",
+                              g_variant_new_fixed_array(G_VARIANT_TYPE_BYTE, group.psk.data(), group.psk.length(), 1));
+    g_variant_builder_add(builder, "{sv}", "mode", g_variant_new_int32(group.group_owner ? kModeGroupOwner : kModeInfrastructure));
+    if (!group.group_owner && group.bssid.length() > 0)
+        g_variant_builder_add(builder, "{sv}", "bssid", g_variant_new_string(group.bssid.c_str()));
+    // Ask for the channel the group operated on last time
+    if (group.group_owner && group.frequency > 0)
+        g_variant_builder_add(builder, "{sv}", "frequency", g_variant_new_int32(group.frequency));
+    auto arguments = g_variant_builder_end(builder);
+
+    wpa_supplicant_interface_p2_pdevice_call_add_persistent_group(proxy_.get(), arguments, nullptr,
+                                                                  [](GObject *source, GAsyncResult *res, gpointer user_data) {
+
+        auto inst = static_cast<ac::SharedKeepAlive<P2PDeviceStub>*>(user_data)->ShouldDie();
+
+        gchar *path = nullptr;
+        GError *error = nullptr;
+        if (!wpa_supplicant_interface_p2_pdevice_call_add_persistent_group_finish(inst->proxy_.get(), &path, res, &error)) {
+            AC_ERROR("Failed to add persistent group: %s", error->message);
+            g_error_free(error);
+
+            if (auto sp = inst->delegate_.lock())
+                sp->OnPeerConnectFailed();
+
+            return;
+        }
+
+        const std::string group_path = path;
+        g_free(path);
+
+        if (auto sp = inst->delegate_.lock())
+            sp->OnPersistentGroupAdded(group_path);
+
+    }, new ac::SharedKeepAlive<P2PDeviceStub>{shared_from_this()});
+
+    return true;
+}
+
+void P2PDeviceStub::RemovePersistentGroup(const std::string &path) {
+    if (!proxy_ || path.length() == 0)
+        return;
+
+    AC_DEBUG("path %s", path);
+
+    wpa_supplicant_interface_p2_pdevice_call_remove_persistent_group(proxy_.get(), path.c_str(), nullptr,
+                                                                     [](GObject *source, GAsyncResult *res, gpointer user_data) {
+
+        auto inst = static_cast<ac::SharedKeepAlive<P2PDeviceStub>*>(user_data)->ShouldDie();
+
+        GError *error = nullptr;
+        if (!wpa_supplicant_interface_p2_pdevice_call_remove_persistent_group_finish(inst->proxy_.get(), res, &error)) {
+            AC_ERROR("Failed to remove persistent group: %s", error->message);
+            g_error_free(error);
+            return;
+        }
+
+    }, new ac::SharedKeepAlive<P2PDeviceStub>{shared_from_this()});
+}
+
 int DevTypeStringToBinary(const std::string &type, unsigned char dev_type[8]) {
     int length, pos, end;
     char b[3] = {};
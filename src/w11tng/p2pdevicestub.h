@@ -88,6 +88,20 @@ public:
     static WpsMethod WpsMethodFromString(const std::string &wps_method);
     static std::string WpsMethodToString(WpsMethod wps_method);
 
+    // Credentials of a group formed earlier which wpa_supplicant can
+    // reinvoke without negotiation and provisioning.
+    struct PersistentGroup {
+        bool group_owner;
+        // Interface address of the group owner, only needed when we
+        // were a client of the group.
+        ac::MacAddress bssid;
+        std::string ssid;
+        std::string passphrase;
+        // Raw key; used when we don't know the passphrase
+        std::string psk;
+        Frequency frequency;
+    };
+
     struct GroupOwnerNegotiationResult {
         GroupOwnerNegotiationResult() { }
         GroupOwnerNegotiationResult(const GroupOwnerNegotiationResult &other) :
@@ -114,6 +128,8 @@ public:
         virtual void OnGroupStarted(const std::string &group_path, const std::string &interface_path, const std::string &role) = 0;
         virtual void OnGroupFinished(const std::string &group_path, const std::string &interface_path) = 0;
         virtual void OnGroupRequest(const std::string &peer_path, int dev_passwd_id) = 0;
+        virtual void OnPersistentGroupAdded(const std::string &path) = 0;
+        virtual void OnInvitationResult(Status status) = 0;
 
         // Called whenver any of the exposed properties changes.
         virtual void OnP2PDeviceChanged() = 0;
@@ -130,11 +146,17 @@ public:
     void Find(const std::chrono::seconds &timeout);
     void StopFind();
     bool Connect(const std::string &path, const std::int32_t intent);
+    bool Invite(const std::string &path, const std::string &persistent_group_path);
     bool Disconnect();
     bool DisconnectSync();
     void Flush();
     void Cancel();
 
+    // As the group is only added to reinvoke it failures are reported
+    // through OnPeerConnectFailed.
+    bool AddPersistentGroup(const PersistentGroup &group);
+    void RemovePersistentGroup(const std::string &path);
+
     bool Scanning() const { return scan_timeout_source_ > 0; }
     bool Connected() const { return !!proxy_; }
     std::string ObjectPath() const;
@@ -150,6 +172,7 @@ private:
     static void OnGroupStarted(WpaSupplicantInterfaceP2PDevice *device, GVariant *properties, gpointer user_data);
     static void OnGroupFinished(WpaSupplicantInterfaceP2PDevice *device, GVariant *properties, gpointer user_data);
     static void OnGroupRequest(WpaSupplicantInterfaceP2PDevice *device, const gchar *path, int dev_passwd_id, gpointer user_data);
+    static void OnInvitationResult(WpaSupplicantInterfaceP2PDevice *device, GVariant *properties, gpointer user_data);
 
 private:
     P2PDeviceStub(const std::weak_ptr<P2PDeviceStub::Delegate> &delegate);
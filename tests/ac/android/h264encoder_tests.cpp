@@ -457,6 +457,48 @@ TEST_F(H264EncoderFixture, CorrectStartAndStopBehavior) {
     EXPECT_FALSE(encoder->Stop());
 }
 
+TEST_F(H264EncoderFixture, CanBeConfiguredAgainAfterReset) {
+    auto mock = std::make_shared<ac::test::android::MockMedia>();
+
+    auto encoder = ac::android::H264Encoder::Create(mock_report);
+
+    auto config = encoder->DefaultConfiguration();
+    config.width = 1280;
+    config.height = 720;
+    config.framerate = 30;
+
+    // Nothing to reset yet
+    EXPECT_FALSE(encoder->Reset());
+
+    ExpectValidConfiguration(config, mock);
+
+    EXPECT_TRUE(encoder->Configure(config));
+    EXPECT_TRUE(encoder->Reset());
+
+    config.framerate = 25;
+
+    ExpectValidConfiguration(config, mock);
+
+    EXPECT_TRUE(encoder->Configure(config));
+    EXPECT_EQ(config, encoder->Configuration());
+}
+
+TEST_F(H264EncoderFixture, ResetFailsWhileRunning) {
+    auto mock = std::make_shared<ac::test::android::MockMedia>();
+
+    auto encoder = ac::android::H264Encoder::Create(mock_report);
+
+    const auto config = encoder->DefaultConfiguration();
+
+    ExpectValidConfiguration(config, mock);
+    ExpectValidStartAndStop(mock);
+
+    EXPECT_TRUE(encoder->Configure(config));
+    EXPECT_TRUE(encoder->Start());
+    EXPECT_FALSE(encoder->Reset());
+    EXPECT_TRUE(encoder->Stop());
+}
+
 TEST_F(H264EncoderFixture, StartFailsCorrectly) {
     auto mock = std::make_shared<ac::test::android::MockMedia>();
 
@@ -517,10 +559,47 @@ TEST_F(H264EncoderFixture, RequestIDRFrame) {
 
     EXPECT_CALL(*mock, media_codec_source_request_idr_frame(_))
             .Times(1);
+    EXPECT_CALL(*mock_report, RequestedIDRFrame())
+            .Times(1);
+    EXPECT_CALL(*mock_report, EmittedIDRFrame())
+            .Times(1);
 
     encoder->SendIDRFrame();
 }
 
+TEST_F(H264EncoderFixture, CoalescesBurstOfIDRFrameRequests) {
+    auto mock = std::make_shared<ac::test::android::MockMedia>();
+
+    auto encoder = ac::android::H264Encoder::Create(mock_report);
+
+    auto config = encoder->DefaultConfiguration();
+    config.width = 1280;
+    config.height = 720;
+    config.framerate = 30;
+
+    ExpectValidConfiguration(config, mock);
+
+    EXPECT_TRUE(encoder->Configure(config));
+
+    // Only the first one of a burst reaches the encoder right away
+    EXPECT_CALL(*mock, media_codec_source_request_idr_frame(_))
+            .Times(1);
+    EXPECT_CALL(*mock_report, RequestedIDRFrame())
+            .Times(5);
+    EXPECT_CALL(*mock_report, EmittedIDRFrame())
+            .Times(1);
+
+    for (int n = 0; n < 5; n++)
+        encoder->SendIDRFrame();
+
+    const auto stats = static_cast<ac::android::H264Encoder*>(encoder.get())->IDRStatistics();
+    EXPECT_EQ(5u, stats.requested);
+    EXPECT_EQ(1u, stats.emitted);
+    // The intra refresh sweep takes 10 frames at 30 fps which repairs
+    // the picture long before we would send the next IDR frame.
+    EXPECT_EQ(4u, stats.substituted);
+}
+
 TEST_F(H264EncoderFixture, ReturnsPackedBufferAndReleaseProperly) {
     auto mock = std::make_shared<ac::test::android::MockMedia>();
 
@@ -548,7 +627,7 @@ TEST_F(H264EncoderFixture, ReturnsPackedBufferAndReleaseProperly) {
     auto now = ac::Utils::GetNowUs();
     input_buffer->SetTimestamp(now);
 
-    EXPECT_CALL(*mock_report, ReceivedInputBuffer(_))
+    EXPECT_CALL(*mock_report, ReceivedInputBuffer(_, _))
             .Times(1);
 
     encoder->QueueBuffer(input_buffer);
@@ -588,7 +667,7 @@ TEST_F(H264EncoderFixture, ReturnsPackedBufferAndReleaseProperly) {
     EXPECT_CALL(*mock, media_buffer_set_return_callback(mbuf, nullptr, nullptr))
             .Times(1);
 
-    EXPECT_CALL(*mock_report, BeganFrame(_))
+    EXPECT_CALL(*mock_report, BeganFrame(_, _))
             .Times(1);
 
     EXPECT_EQ(0, source_read_callback(&output_buffer, source_read_callback_data));
@@ -736,7 +815,7 @@ TEST_F(H264EncoderFixture, ExecuteProvidesBuffers) {
     EXPECT_CALL(*encoder_delegate, OnBufferWithCodecConfig(_))
             .Times(0);
 
-    EXPECT_CALL(*mock_report, FinishedFrame(_))
+    EXPECT_CALL(*mock_report, FinishedFrame(_, _))
             .Times(1);
 
     EXPECT_TRUE(encoder->Execute());
@@ -800,7 +879,7 @@ TEST_F(H264EncoderFixture, HandsBuffersWithCodecSpecificDataBack) {
     EXPECT_CALL(*encoder_delegate, OnBufferAvailable(_))
             .Times(1);
 
-    EXPECT_CALL(*mock_report, FinishedFrame(_))
+    EXPECT_CALL(*mock_report, FinishedFrame(_, _))
             .Times(1);
 
     EXPECT_TRUE(encoder->Execute());
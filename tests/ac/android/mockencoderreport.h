@@ -30,9 +30,11 @@ class MockEncoderReport : public video::EncoderReport {
 public:
     MOCK_METHOD0(Started, void());
     MOCK_METHOD0(Stopped, void());
-    MOCK_METHOD1(BeganFrame, void(const ac::TimestampUs&));
-    MOCK_METHOD1(FinishedFrame, void(const ac::TimestampUs&));
-    MOCK_METHOD1(ReceivedInputBuffer, void(const ac::TimestampUs&));
+    MOCK_METHOD2(BeganFrame, void(const video::FrameNumber&, const ac::TimestampUs&));
+    MOCK_METHOD2(FinishedFrame, void(const video::FrameNumber&, const ac::TimestampUs&));
+    MOCK_METHOD2(ReceivedInputBuffer, void(const video::FrameNumber&, const ac::TimestampUs&));
+    MOCK_METHOD0(RequestedIDRFrame, void());
+    MOCK_METHOD0(EmittedIDRFrame, void());
 };
 
 } // namespace android
@@ -0,0 +1,164 @@
+/*
+ * Copyright (C) 2016 Canonical, Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 3, as published
+ * by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranties of
+ * MERCHANTABILITY, SATISFACTORY QUALITY, or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <gtest/gtest.h>
+
+#include <sstream>
+#include <thread>
+#include <vector>
+
+#include "ac/asynclogger.h"
+
+namespace {
+std::vector<std::string> Lines(const std::string &output) {
+    std::vector<std::string> lines;
+    std::istringstream in(output);
+    std::string line;
+    while (std::getline(in, line))
+        lines.push_back(line);
+    return lines;
+}
+
+bool EndsWith(const std::string &str, const std::string &suffix) {
+    return str.size() >= suffix.size() &&
+            str.compare(str.size() - suffix.size(), suffix.size(), suffix) == 0;
+}
+
+// Counts how often it gets formatted to see if the logger formats
+// messages it drops.
+struct FormatCounter {
+    mutable int count = 0;
+};
+
+std::ostream& operator<<(std::ostream &out, const FormatCounter &counter) {
+    counter.count++;
+    return out << "counter";
+}
+}
+
+TEST(AsyncLogger, ChecksSeverityBeforeFormatting) {
+    std::ostringstream out;
+    ac::AsyncLogger logger(out, ac::Logger::Severity::kInfo);
+
+    EXPECT_FALSE(logger.IsEnabled(ac::Logger::Severity::kTrace));
+    EXPECT_FALSE(logger.IsEnabled(ac::Logger::Severity::kDebug));
+    EXPECT_TRUE(logger.IsEnabled(ac::Logger::Severity::kInfo));
+    EXPECT_TRUE(logger.IsEnabled(ac::Logger::Severity::kError));
+
+    FormatCounter counter;
+    logger.Debugf(boost::none, "%s", counter);
+    EXPECT_EQ(0, counter.count);
+
+    logger.Infof(boost::none, "%s", counter);
+    EXPECT_EQ(1, counter.count);
+
+    logger.Flush();
+    const auto lines = Lines(out.str());
+    ASSERT_EQ(1, lines.size());
+    EXPECT_EQ(0, lines[0].find("[II "));
+    EXPECT_TRUE(EndsWith(lines[0], "] counter"));
+}
+
+TEST(AsyncLogger, InitChangesSeverity) {
+    std::ostringstream out;
+    ac::AsyncLogger logger(out, ac::Logger::Severity::kInfo);
+
+    logger.Init(ac::Logger::Severity::kDebug);
+    EXPECT_TRUE(logger.IsEnabled(ac::Logger::Severity::kDebug));
+
+    logger.Debug("debug message");
+    logger.Flush();
+
+    EXPECT_EQ(1, Lines(out.str()).size());
+}
+
+TEST(AsyncLogger, WritesMessagesWithLocationInOrder) {
+    std::ostringstream out;
+    ac::AsyncLogger logger(out, ac::Logger::Severity::kTrace);
+
+    logger.Info("first");
+    logger.Warning("second", ac::Logger::Location{"file.cpp", "Function", 42});
+    logger.Error("third");
+    logger.Flush();
+
+    const auto lines = Lines(out.str());
+    ASSERT_EQ(3, lines.size());
+    EXPECT_TRUE(EndsWith(lines[0], "] first"));
+    EXPECT_EQ(0, lines[1].find("[WW "));
+    EXPECT_NE(std::string::npos, lines[1].find("file.cpp"));
+    EXPECT_TRUE(EndsWith(lines[1], "] second"));
+    EXPECT_TRUE(EndsWith(lines[2], "] third"));
+}
+
+TEST(AsyncLogger, WritesMessagesInBackground) {
+    std::ostringstream out;
+    {
+        ac::AsyncLogger logger(out, ac::Logger::Severity::kInfo);
+        logger.Info("message");
+        std::this_thread::sleep_for(ac::AsyncLogger::kDrainInterval * 5);
+    }
+    EXPECT_EQ(1, Lines(out.str()).size());
+}
+
+TEST(AsyncLogger, CollectsMessagesFromAllThreads) {
+    static constexpr unsigned int kNumThreads{4};
+    static constexpr unsigned int kMessagesPerThread{100};
+
+    std::ostringstream out;
+    ac::AsyncLogger logger(out, ac::Logger::Severity::kInfo);
+
+    std::vector<std::thread> threads;
+    for (unsigned int n = 0; n < kNumThreads; n++) {
+        threads.push_back(std::thread([&]() {
+            for (unsigned int m = 0; m < kMessagesPerThread; m++)
+                logger.Info("message");
+        }));
+    }
+
+    for (auto &thread : threads)
+        thread.join();
+
+    logger.Flush();
+
+    EXPECT_EQ(kNumThreads * kMessagesPerThread, Lines(out.str()).size());
+    EXPECT_EQ(0, logger.DroppedMessages());
+}
+
+TEST(AsyncLogger, DropsMessagesWhenQueueIsFull) {
+    std::ostringstream out;
+    ac::AsyncLogger logger(out, ac::Logger::Severity::kInfo);
+
+    const auto num_messages = ac::AsyncLogger::kRecordsPerThread * 4;
+    for (std::size_t n = 0; n < num_messages; n++)
+        logger.Info("message");
+    logger.Flush();
+
+    const auto dropped = logger.DroppedMessages();
+
+    std::size_t written = 0;
+    bool reported = false;
+    for (const auto &line : Lines(out.str())) {
+        if (EndsWith(line, "] message"))
+            written++;
+        else if (line.find("Dropped") != std::string::npos)
+            reported = true;
+    }
+
+    EXPECT_GT(dropped, 0);
+    EXPECT_EQ(num_messages - dropped, written);
+    EXPECT_TRUE(reported);
+}
@@ -0,0 +1,74 @@
+/*
+ * Copyright (C) 2016 Canonical, Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 3, as published
+ * by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranties of
+ * MERCHANTABILITY, SATISFACTORY QUALITY, or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <gtest/gtest.h>
+
+#include <thread>
+#include <vector>
+
+#include "ac/common/ringbuffer.h"
+
+TEST(RingBuffer, RoundsCapacityUpToPowerOfTwo) {
+    ac::common::RingBuffer<int> buffer(5);
+    EXPECT_EQ(8, buffer.Capacity());
+}
+
+TEST(RingBuffer, RejectsItemsWhenFull) {
+    ac::common::RingBuffer<int> buffer(4);
+
+    for (int n = 0; n < 4; n++)
+        EXPECT_TRUE(buffer.Push(std::move(n)));
+
+    EXPECT_FALSE(buffer.Push(4));
+
+    std::vector<int> items;
+    EXPECT_EQ(4, buffer.Drain([&](int &&item) { items.push_back(item); }));
+    EXPECT_EQ(std::vector<int>({0, 1, 2, 3}), items);
+    EXPECT_TRUE(buffer.Empty());
+
+    EXPECT_TRUE(buffer.Push(4));
+    EXPECT_FALSE(buffer.Empty());
+}
+
+TEST(RingBuffer, DeliversItemsInOrderAcrossThreads) {
+    static constexpr int kNumItems{10000};
+
+    ac::common::RingBuffer<int> buffer(64);
+
+    std::thread producer([&]() {
+        for (int n = 0; n < kNumItems; n++) {
+            int item = n;
+            while (!buffer.Push(std::move(item)))
+                std::this_thread::yield();
+        }
+    });
+
+    int expected = 0;
+    bool in_order = true;
+    while (expected < kNumItems) {
+        buffer.Drain([&](int &&item) {
+            in_order = in_order && item == expected;
+            expected++;
+        });
+        std::this_thread::yield();
+    }
+
+    producer.join();
+
+    EXPECT_TRUE(in_order);
+    EXPECT_TRUE(buffer.Empty());
+}
@@ -0,0 +1,530 @@
+/*
+ * Copyright (C) 2016 Canonical, Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 3, as published
+ * by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranties of
+ * MERCHANTABILITY, SATISFACTORY QUALITY, or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <gmock/gmock.h>
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <mutex>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include <boost/accumulators/accumulators.hpp>
+#include <boost/accumulators/statistics/max.hpp>
+#include <boost/accumulators/statistics/min.hpp>
+#include <boost/accumulators/statistics/mean.hpp>
+#include <boost/accumulators/statistics/stats.hpp>
+#include <boost/accumulators/statistics/variance.hpp>
+
+#include "ac/logger.h"
+#include "ac/utils.h"
+
+#include "ac/common/executorpool.h"
+#include "ac/common/threadedexecutorfactory.h"
+
+#include "ac/mir/streamrenderer.h"
+
+#include "ac/network/udpstream.h"
+
+#include "ac/report/null/encoderreport.h"
+#include "ac/report/null/packetizerreport.h"
+#include "ac/report/null/rendererreport.h"
+#include "ac/report/null/senderreport.h"
+
+#include "ac/streaming/mediasender.h"
+#include "ac/streaming/mpegtspacketizer.h"
+#include "ac/streaming/rtpsender.h"
+
+#include "ac/video/bufferproducer.h"
+#include "ac/video/bufferqueue.h"
+
+#include "tests/common/benchmark.h"
+
+#include "tests/ac/integration_tests/config.h"
+
+namespace ba = boost::accumulators;
+
+using namespace ::testing;
+
+namespace {
+static constexpr const char *kLoopbackAddress{"127.0.0.1"};
+static constexpr unsigned int kWidth{1280};
+static constexpr unsigned int kHeight{720};
+static constexpr int kFramerate{30};
+// Roughly what the hardware encoder produces for a 720p stream
+// at the bitrate we configure it with.
+static constexpr std::size_t kFrameSize{20 * 1024};
+static constexpr std::size_t kIDRFrameSize{60 * 1024};
+static constexpr std::size_t kNumFrames{kFramerate};
+static constexpr std::chrono::seconds kDuration{5};
+// Without an encoder in the loop the whole path takes well below a
+// millisecond and scheduling noise alone shifts the mean by some ten
+// microseconds between runs. We only want to catch real regressions
+// so anything within this margin of the reference is accepted.
+static constexpr double kLatencyToleranceSeconds{0.001};
+
+static constexpr unsigned int kRTPHeaderSize{12};
+static constexpr unsigned int kMPEGTSPacketSize{188};
+static constexpr unsigned int kMaxDatagramSize{2048};
+static constexpr std::uint64_t kPTSWrap{1ull << 33};
+static constexpr int kReceiveTimeoutMs{100};
+static constexpr int kReceiveBufferSize{1024 * 1024};
+
+typedef ac::testing::Benchmark::Result::Timing::Seconds Resolution;
+
+typedef ba::accumulator_set<
+    Resolution::rep,
+    ba::stats<ba::tag::count, ba::tag::min, ba::tag::max, ba::tag::mean, ba::tag::variance>
+> Statistics;
+
+void FillResultsFromStatistics(ac::testing::Benchmark::Result& result,
+                               const Statistics& stats)
+{
+    result.sample_size = ba::count(stats);
+
+    result.timing.min = Resolution{static_cast<Resolution::rep>(ba::min(stats))};
+    result.timing.max = Resolution{static_cast<Resolution::rep>(ba::max(stats))};
+    result.timing.mean = Resolution{static_cast<Resolution::rep>(ba::mean(stats))};
+    result.timing.std_dev = Resolution{static_cast<Resolution::rep>(std::sqrt(ba::variance(stats)))};
+}
+
+// A single encoded access unit as the producer hands it out. Instead
+// of a native buffer the renderer passes a pointer to this through the
+// pipeline.
+struct SyntheticFrame {
+    std::vector<std::uint8_t> data;
+};
+
+// Stands in for the compositor and hands out a fixed set of already
+// encoded frames one after the other. The capture timestamp is taken
+// when a buffer is swapped like a real producer would do.
+class SyntheticBufferProducer : public ac::video::BufferProducer {
+public:
+    SyntheticBufferProducer() :
+        current_(0),
+        timestamp_(0) {
+
+        std::mt19937 generator;
+        // Avoid zero bytes so the payload never contains anything
+        // looking like a start code.
+        std::uniform_int_distribution<int> distribution(1, 255);
+
+        for (std::size_t n = 0; n < kNumFrames; n++) {
+            const bool idr = (n == 0);
+
+            SyntheticFrame frame;
+            frame.data.resize(idr ? kIDRFrameSize : kFrameSize);
+            frame.data[0] = 0x00;
+            frame.data[1] = 0x00;
+            frame.data[2] = 0x00;
+            frame.data[3] = 0x01;
+            frame.data[4] = idr ? 0x65 : 0x41;
+            for (std::size_t i = 5; i < frame.data.size(); i++)
+                frame.data[i] = distribution(generator);
+
+            frames_.push_back(frame);
+        }
+    }
+
+    bool Setup(const ac::video::DisplayOutput&) override {
+        return true;
+    }
+
+    void SwapBuffers() override {
+        current_ = (current_ + 1) % frames_.size();
+        timestamp_ = ac::Utils::GetNowUs();
+    }
+
+    void* CurrentBuffer() const override {
+        return const_cast<SyntheticFrame*>(&frames_[current_]);
+    }
+
+    ac::video::DisplayOutput OutputMode() const override {
+        return ac::video::DisplayOutput{ac::video::DisplayOutput::Mode::kMirror,
+                                        kWidth, kHeight, kFramerate};
+    }
+
+    ac::TimestampUs CurrentBufferTimestamp() const override {
+        return timestamp_;
+    }
+
+private:
+    std::vector<SyntheticFrame> frames_;
+    std::size_t current_;
+    ac::TimestampUs timestamp_;
+};
+
+// Copies the already encoded access units out of the producer buffers
+// on its own thread like the hardware encoder hands its output over.
+class PassthroughEncoder : public ac::video::BaseEncoder {
+public:
+    PassthroughEncoder() :
+        input_queue_(ac::video::BufferQueue::Create()) {
+        config_.width = kWidth;
+        config_.height = kHeight;
+        config_.framerate = kFramerate;
+    }
+
+    ac::video::BaseEncoder::Config DefaultConfiguration() override { return config_; }
+    bool Configure(const ac::video::BaseEncoder::Config &config) override { config_ = config; return true; }
+    ac::video::BaseEncoder::Config Configuration() const override { return config_; }
+
+    void QueueBuffer(const ac::video::Buffer::Ptr &buffer) override {
+        input_queue_->Push(buffer);
+    }
+
+    bool Running() const override { return true; }
+    void SendIDRFrame() override { }
+    bool Start() override { return true; }
+    bool Stop() override { return true; }
+    std::string Name() const override { return "PassthroughEncoder"; }
+
+    bool Execute() override {
+        if (!input_queue_->WaitToBeFilled())
+            return true;
+
+        const auto input = input_queue_->Pop();
+        const auto frame = static_cast<SyntheticFrame*>(input->NativeHandle());
+
+        const auto output = ac::video::Buffer::Create(frame->data.size());
+        ::memcpy(output->Data(), frame->data.data(), frame->data.size());
+        output->SetTimestamp(input->Timestamp());
+        output->SetFrameNumber(input->FrameNumber());
+
+        input->Release();
+
+        if (auto sp = delegate_.lock())
+            sp->OnBufferAvailable(output);
+
+        return true;
+    }
+
+private:
+    ac::video::BaseEncoder::Config config_;
+    ac::video::BufferQueue::Ptr input_queue_;
+};
+
+// Plays the sink: receives the RTP datagrams on a loopback socket,
+// looks into the transport stream for the PTS of each frame and
+// measures how long it took from capturing a frame until its last
+// datagram arrived.
+class LoopbackReceiver {
+public:
+    struct Statistics {
+        std::uint64_t received_packets;
+        std::uint64_t lost_packets;
+        // Interarrival jitter as defined in RFC 3550 in seconds
+        double jitter;
+    };
+
+    LoopbackReceiver() :
+        socket_(-1),
+        running_(false),
+        current_pts_(-1),
+        last_arrival_(0),
+        expected_sequence_number_(-1),
+        last_transit_(0),
+        have_transit_(false),
+        statistics_{0, 0, 0.0} {
+    }
+
+    ~LoopbackReceiver() {
+        Stop();
+
+        if (socket_ >= 0)
+            ::close(socket_);
+    }
+
+    bool Setup() {
+        socket_ = ::socket(AF_INET, SOCK_DGRAM, 0);
+        if (socket_ < 0)
+            return false;
+
+        int value = kReceiveBufferSize;
+        ::setsockopt(socket_, SOL_SOCKET, SO_RCVBUF, &value, sizeof(value));
+
+        struct sockaddr_in addr;
+        ::memset(&addr, 0, sizeof(addr));
+        addr.sin_family = AF_INET;
+        addr.sin_addr.s_addr = ::inet_addr(kLoopbackAddress);
+        addr.sin_port = 0;
+
+        if (::bind(socket_, reinterpret_cast<const struct sockaddr*>(&addr), sizeof(addr)) < 0)
+            return false;
+
+        socklen_t length = sizeof(addr);
+        if (::getsockname(socket_, reinterpret_cast<struct sockaddr*>(&addr), &length) < 0)
+            return false;
+
+        port_ = ntohs(addr.sin_port);
+
+        return true;
+    }
+
+    ac::network::Port Port() const {
+        return port_;
+    }
+
+    void Start(const std::function<void(double)> &latency_callback) {
+        latency_callback_ = latency_callback;
+        running_ = true;
+        thread_ = std::thread([this]() { Run(); });
+    }
+
+    void Stop() {
+        running_ = false;
+        if (thread_.joinable())
+            thread_.join();
+    }
+
+    Statistics Results() const {
+        std::lock_guard<std::mutex> l(mutex_);
+        return statistics_;
+    }
+
+private:
+    void Run() {
+        std::vector<std::uint8_t> datagram(kMaxDatagramSize);
+
+        struct pollfd fd;
+        fd.fd = socket_;
+        fd.events = POLLIN;
+
+        while (running_) {
+            if (::poll(&fd, 1, kReceiveTimeoutMs) <= 0)
+                continue;
+
+            const auto size = ::recv(socket_, datagram.data(), datagram.size(), 0);
+            const auto now = ac::Utils::GetNowUs();
+
+            if (size < static_cast<ssize_t>(kRTPHeaderSize))
+                continue;
+
+            std::lock_guard<std::mutex> l(mutex_);
+            ProcessDatagram(datagram.data(), size, now);
+        }
+    }
+
+    void ProcessDatagram(const std::uint8_t *data, std::size_t size, ac::TimestampUs now) {
+        const std::uint16_t sequence_number = (data[2] << 8) | data[3];
+        const std::uint32_t rtp_time = (data[4] << 24) | (data[5] << 16) | (data[6] << 8) | data[7];
+
+        statistics_.received_packets++;
+
+        if (expected_sequence_number_ >= 0 && sequence_number != expected_sequence_number_)
+            statistics_.lost_packets += static_cast<std::uint16_t>(sequence_number - expected_sequence_number_);
+        expected_sequence_number_ = static_cast<std::uint16_t>(sequence_number + 1);
+
+        // See RFC 3550, A.8
+        const std::int64_t arrival = static_cast<std::uint32_t>((now * 9) / 100);
+        const std::int64_t transit = static_cast<std::int32_t>(arrival - rtp_time);
+        if (have_transit_) {
+            const double d = std::abs(transit - last_transit_) / 90000.0;
+            statistics_.jitter += (d - statistics_.jitter) / 16.0;
+        }
+        last_transit_ = transit;
+        have_transit_ = true;
+
+        for (std::size_t offset = kRTPHeaderSize; offset + kMPEGTSPacketSize <= size;
+             offset += kMPEGTSPacketSize) {
+            const auto pts = ParsePTS(data + offset);
+            if (pts < 0)
+                continue;
+
+            // A new frame starts so the previous one is complete with
+            // the last datagram we received.
+            FinishFrame();
+            current_pts_ = pts;
+        }
+
+        last_arrival_ = now;
+    }
+
+    void FinishFrame() {
+        if (current_pts_ < 0)
+            return;
+
+        const std::uint64_t arrival = (static_cast<std::uint64_t>(last_arrival_) * 9ull) / 100ull;
+        const std::uint64_t latency = (arrival - current_pts_) % kPTSWrap;
+
+        if (latency_callback_)
+            latency_callback_(latency / 90000.0);
+    }
+
+    // Returns the PTS of the PES packet starting in this TS packet
+    // or a negative value if there is none.
+    std::int64_t ParsePTS(const std::uint8_t *packet) {
+        if (packet[0] != 0x47)
+            return -1;
+
+        const bool payload_unit_start = packet[1] & 0x40;
+        const unsigned int adaptation_field_control = (packet[3] >> 4) & 0x3;
+
+        if (!payload_unit_start || !(adaptation_field_control & 0x1))
+            return -1;
+
+        std::size_t offset = 4;
+        if (adaptation_field_control & 0x2)
+            offset += 1 + packet[4];
+
+        if (offset + 14 > kMPEGTSPacketSize)
+            return -1;
+
+        const std::uint8_t *pes = packet + offset;
+        if (pes[0] != 0x00 || pes[1] != 0x00 || pes[2] != 0x01 || (pes[3] & 0xf0) != 0xe0)
+            return -1;
+
+        // PTS_DTS_flags
+        if (!(pes[7] & 0x80))
+            return -1;
+
+        const std::uint8_t *ptr = pes + 9;
+        return (static_cast<std::int64_t>((ptr[0] >> 1) & 0x7) << 30) |
+               (static_cast<std::int64_t>(ptr[1]) << 22) |
+               (static_cast<std::int64_t>(ptr[2] >> 1) << 15) |
+               (static_cast<std::int64_t>(ptr[3]) << 7) |
+               (ptr[4] >> 1);
+    }
+
+    int socket_;
+    ac::network::Port port_;
+    std::atomic<bool> running_;
+    std::thread thread_;
+    std::function<void(double)> latency_callback_;
+    mutable std::mutex mutex_;
+    std::int64_t current_pts_;
+    ac::TimestampUs last_arrival_;
+    std::int32_t expected_sequence_number_;
+    std::int64_t last_transit_;
+    bool have_transit_;
+    Statistics statistics_;
+};
+
+class LoopbackStreamBenchmark : public ac::testing::Benchmark {
+public:
+    struct PlaybackConfiguration {
+        std::chrono::seconds duration{kDuration};
+    };
+
+    ac::testing::Benchmark::Result ForPlayback(const PlaybackConfiguration &config,
+                                               LoopbackReceiver::Statistics &receiver_statistics) {
+        Statistics stats;
+        ac::testing::Benchmark::Result benchmark_result;
+
+        LoopbackReceiver receiver;
+        if (!receiver.Setup())
+            throw std::runtime_error{"Failed to setup loopback receiver"};
+
+        const auto output_stream = std::make_shared<ac::network::UdpStream>();
+        if (!output_stream->Connect(kLoopbackAddress, receiver.Port()))
+            throw std::runtime_error{"Failed to connect to loopback receiver"};
+
+        const auto producer = std::make_shared<SyntheticBufferProducer>();
+        const auto encoder = std::make_shared<PassthroughEncoder>();
+
+        const auto renderer = std::make_shared<ac::mir::StreamRenderer>(
+                    producer, encoder, std::make_shared<ac::report::null::RendererReport>());
+
+        const auto rtp_sender = std::make_shared<ac::streaming::RTPSender>(
+                    output_stream, std::make_shared<ac::report::null::SenderReport>());
+
+        const auto packetizer = ac::streaming::MPEGTSPacketizer::Create(
+                    std::make_shared<ac::report::null::PacketizerReport>());
+
+        const auto sender = std::make_shared<ac::streaming::MediaSender>(
+                    packetizer, rtp_sender, encoder->Configuration());
+
+        encoder->SetDelegate(sender);
+
+        ac::common::ExecutorPool pipeline(std::make_shared<ac::common::ThreadedExecutorFactory>(), 4);
+        pipeline.Add(encoder);
+        pipeline.Add(renderer);
+        pipeline.Add(rtp_sender);
+        pipeline.Add(sender);
+
+        receiver.Start([&](double seconds) {
+            stats(seconds);
+            benchmark_result.timing.sample.push_back(Resolution{seconds});
+        });
+
+        pipeline.Start();
+
+        std::this_thread::sleep_for(config.duration);
+
+        pipeline.Stop();
+        receiver.Stop();
+
+        receiver_statistics = receiver.Results();
+
+        FillResultsFromStatistics(benchmark_result, stats);
+        return benchmark_result;
+    }
+};
+}
+
+TEST(LoopbackStreamPerformance, EndToEndIsAcceptable) {
+    ac::testing::Benchmark::Result reference_result;
+
+    auto ref_path = ac::Utils::GetEnvValue("AETHERCAST_TESTS_LOOPBACK_REFERENCE_RESULTS",
+                                           ac::testing::stream_performance::kLoopbackReferenceResultFile);
+    std::ifstream in{ref_path};
+    reference_result.load_from_xml(in);
+
+    LoopbackStreamBenchmark benchmark;
+    const LoopbackStreamBenchmark::PlaybackConfiguration config;
+    LoopbackReceiver::Statistics receiver_statistics;
+    auto result = benchmark.ForPlayback(config, receiver_statistics);
+
+    // We store the potential new reference such that we can copy over if
+    // the last test fails.
+    std::ofstream out{"loopback-ref-new.xml"};
+    result.save_to_xml(out);
+
+    AC_DEBUG("current sample size %d mean %f var %f std dev %f",
+              result.timing.get_size(), result.timing.get_mean(),
+              result.timing.get_variance(), result.timing.get_stddev());
+    AC_DEBUG("reference sample size %d  mean %f var %f std dev %f",
+              reference_result.timing.get_size(), reference_result.timing.get_mean(),
+              reference_result.timing.get_variance(), reference_result.timing.get_stddev());
+    AC_DEBUG("received %d packets lost %d jitter %f",
+              receiver_statistics.received_packets, receiver_statistics.lost_packets,
+              receiver_statistics.jitter);
+
+    ASSERT_GT(result.timing.get_size(), 0u);
+
+    // Nothing should ever get lost on the loopback device.
+    EXPECT_EQ(0u, receiver_statistics.lost_packets);
+
+    ASSERT_FALSE(result.timing.is_significantly_slower_than_reference(
+                     reference_result.timing.get_mean() + kLatencyToleranceSeconds,
+                     reference_result.timing.get_stddev()));
+
+    if (result.timing.is_significantly_faster_than_reference(reference_result.timing))
+        AC_WARNING("Benchmark shows significantly better performance than reference sample");
+}
@@ -136,7 +136,7 @@ public:
                 return ac::network::Stream::Error::kNone;
             }));
 
-        const auto media_manager = ac::MediaManagerFactory::CreateSource(kNullIpAddress, output_stream);
+        const auto media_manager = ac::MediaManagerFactory::CreateSource(kNullIpAddress, ac::MacAddress(), output_stream);
         const auto port = ac::NetworkUtils::PickRandomPort();
 
         std::vector<wds::H264VideoCodec> sink_codecs;
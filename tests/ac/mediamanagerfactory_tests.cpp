@@ -17,6 +17,10 @@
 
 #include <gtest/gtest.h>
 
+#include <fstream>
+
+#include <boost/filesystem.hpp>
+
 #include <ac/mediamanagerfactory.h>
 #include <ac/mir/sourcemediamanager.h>
 
@@ -24,7 +28,7 @@ struct MediaManagerFactoryFixture : public ::testing::Test {
     template <typename T>
     void CheckSourceCreation(const std::string &type_name) {
         setenv("MIRACAST_SOURCE_TYPE", type_name.c_str(), 1);
-        EXPECT_TRUE((std::dynamic_pointer_cast<T>(ac::MediaManagerFactory::CreateSource("", nullptr)) ? true : false));
+        EXPECT_TRUE((std::dynamic_pointer_cast<T>(ac::MediaManagerFactory::CreateSource("", "", nullptr)) ? true : false));
     }
 };
 
@@ -42,3 +46,23 @@ TEST_F(MediaManagerFactoryFixture, MirTypeCreation) {
     CheckSourceCreation<ac::NullSourceMediaManager>("123mir123");
     CheckSourceCreation<ac::NullSourceMediaManager>("123mir");
 }
+
+TEST_F(MediaManagerFactoryFixture, ReplayTypeCreation) {
+    const auto path = boost::filesystem::temp_directory_path() /
+            boost::filesystem::unique_path("replay-%%%%%%.h264");
+
+    setenv("AETHERCAST_REPLAY_FILE", path.string().c_str(), 1);
+
+    // Without anything to replay we can't stream anything
+    CheckSourceCreation<ac::NullSourceMediaManager>("replay");
+
+    const uint8_t access_unit[] = { 0x00, 0x00, 0x00, 0x01, 0x65, 0x88, 0x84, 0x21, 0xa0 };
+    std::ofstream out{path.string(), std::ios::binary};
+    out.write(reinterpret_cast<const char*>(access_unit), sizeof(access_unit));
+    out.close();
+
+    CheckSourceCreation<ac::mir::SourceMediaManager>("replay");
+
+    boost::filesystem::remove(path);
+    unsetenv("AETHERCAST_REPLAY_FILE");
+}
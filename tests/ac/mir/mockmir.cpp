@@ -126,3 +126,25 @@ void mir_buffer_stream_get_current_buffer(MirBufferStream *buffer_stream,
 void mir_buffer_stream_swap_buffers_sync(MirBufferStream *buffer_stream) {
     global_mock->mir_buffer_stream_swap_buffers_sync(buffer_stream);
 }
+
+MirWaitHandle* mir_buffer_stream_swap_buffers(MirBufferStream *buffer_stream,
+    mir_buffer_stream_callback callback, void *context) {
+    return global_mock->mir_buffer_stream_swap_buffers(buffer_stream, callback, context);
+}
+
+bool mir_buffer_stream_is_valid(MirBufferStream *buffer_stream) {
+    return global_mock->mir_buffer_stream_is_valid(buffer_stream);
+}
+
+char const *mir_buffer_stream_get_error_message(MirBufferStream *buffer_stream) {
+    return global_mock->mir_buffer_stream_get_error_message(buffer_stream);
+}
+
+bool mir_buffer_stream_get_graphics_region(MirBufferStream *buffer_stream,
+    MirGraphicsRegion *graphics_region) {
+    return global_mock->mir_buffer_stream_get_graphics_region(buffer_stream, graphics_region);
+}
+
+void mir_wait_for(MirWaitHandle *wait_handle) {
+    global_mock->mir_wait_for(wait_handle);
+}
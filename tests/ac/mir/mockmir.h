@@ -61,6 +61,12 @@ public:
 
     MOCK_METHOD2(mir_buffer_stream_get_current_buffer, void(MirBufferStream*, MirNativeBuffer**));
     MOCK_METHOD1(mir_buffer_stream_swap_buffers_sync, void(MirBufferStream*));
+    MOCK_METHOD3(mir_buffer_stream_swap_buffers, MirWaitHandle*(MirBufferStream*, mir_buffer_stream_callback, void*));
+    MOCK_METHOD1(mir_buffer_stream_is_valid, bool(MirBufferStream*));
+    MOCK_METHOD1(mir_buffer_stream_get_error_message, char const*(MirBufferStream*));
+    MOCK_METHOD2(mir_buffer_stream_get_graphics_region, bool(MirBufferStream*, MirGraphicsRegion*));
+
+    MOCK_METHOD1(mir_wait_for, void(MirWaitHandle*));
 };
 
 } // namespace mir
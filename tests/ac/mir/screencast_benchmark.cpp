@@ -0,0 +1,271 @@
+/*
+ * Copyright (C) 2016 Canonical, Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 3, as published
+ * by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranties of
+ * MERCHANTABILITY, SATISFACTORY QUALITY, or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <gmock/gmock.h>
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstring>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+#include "mockmir.h"
+
+#include "ac/logger.h"
+
+#include "ac/mir/screencast.h"
+#include "ac/mir/streamrenderer.h"
+
+using namespace ::testing;
+
+namespace {
+// Rough numbers for a phone composing and encoding a 720p frame
+static constexpr std::chrono::milliseconds kCompositionTime{8};
+static constexpr std::chrono::milliseconds kEncodingTime{12};
+static constexpr std::chrono::seconds kBenchmarkDuration{1};
+
+// Executes jobs one after the other on its own thread each taking
+// a fixed amount of time like a compositor or a hardware encoder.
+class SerialWorker {
+public:
+    SerialWorker(const std::chrono::milliseconds &job_duration) :
+        job_duration_(job_duration),
+        running_(true),
+        busy_(false),
+        thread_([this]() { Run(); }) {
+    }
+
+    ~SerialWorker() {
+        {
+            std::lock_guard<std::mutex> l(mutex_);
+            running_ = false;
+        }
+        cv_.notify_all();
+        thread_.join();
+    }
+
+    void Post(const std::function<void()> &job) {
+        {
+            std::lock_guard<std::mutex> l(mutex_);
+            jobs_.push_back(job);
+        }
+        cv_.notify_all();
+    }
+
+    void WaitUntilIdle() {
+        std::unique_lock<std::mutex> l(mutex_);
+        cv_.wait(l, [&]() { return jobs_.empty() && !busy_; });
+    }
+
+private:
+    void Run() {
+        std::unique_lock<std::mutex> l(mutex_);
+        while (true) {
+            cv_.wait(l, [&]() { return !running_ || !jobs_.empty(); });
+            if (!running_)
+                break;
+
+            auto job = jobs_.front();
+            jobs_.pop_front();
+            busy_ = true;
+            l.unlock();
+
+            std::this_thread::sleep_for(job_duration_);
+            job();
+
+            l.lock();
+            busy_ = false;
+            cv_.notify_all();
+        }
+    }
+
+    std::chrono::milliseconds job_duration_;
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    std::deque<std::function<void()>> jobs_;
+    bool running_;
+    bool busy_;
+    std::thread thread_;
+};
+
+class SimulatedEncoder : public ac::video::BaseEncoder {
+public:
+    SimulatedEncoder() :
+        worker_(kEncodingTime),
+        frames_encoded_(0) {
+    }
+
+    ac::video::BaseEncoder::Config DefaultConfiguration() override { return Config{}; }
+    bool Configure(const ac::video::BaseEncoder::Config&) override { return true; }
+
+    void QueueBuffer(const ac::video::Buffer::Ptr &buffer) override {
+        worker_.Post([this, buffer]() {
+            frames_encoded_++;
+            buffer->Release();
+        });
+    }
+
+    ac::video::BaseEncoder::Config Configuration() const override {
+        // No framerate means the renderer produces as fast as it can
+        return Config{};
+    }
+
+    bool Running() const override { return true; }
+    void SendIDRFrame() override { }
+    bool Start() override { return true; }
+    bool Stop() override { worker_.WaitUntilIdle(); return true; }
+    bool Execute() override { return true; }
+    std::string Name() const override { return "SimulatedEncoder"; }
+
+    std::uint32_t FramesEncoded() const { return frames_encoded_; }
+
+private:
+    SerialWorker worker_;
+    std::atomic<std::uint32_t> frames_encoded_;
+};
+
+class ScreencastBenchmark {
+public:
+    ScreencastBenchmark() :
+        mir_spec(reinterpret_cast<MirScreencastSpec*>(1)),
+        compositor(kCompositionTime) {
+
+        ::memset(&display_mode, 0, sizeof(display_mode));
+        ::memset(&display_output, 0, sizeof(display_output));
+        ::memset(&display_config, 0, sizeof(display_config));
+
+        display_mode.horizontal_resolution = 1280;
+        display_mode.vertical_resolution = 720;
+        display_mode.refresh_rate = 60;
+
+        display_output.connected = true;
+        display_output.used = true;
+        display_output.num_modes = 1;
+        display_output.modes = &display_mode;
+
+        display_config.num_outputs = 1;
+        display_config.outputs = &display_output;
+
+        const auto connection = reinterpret_cast<MirConnection*>(2);
+        const auto screencast = reinterpret_cast<MirScreencast*>(3);
+        const auto buffer_stream = reinterpret_cast<MirBufferStream*>(4);
+
+        ON_CALL(mir, mir_connect_sync(_, _))
+                .WillByDefault(Return(connection));
+        ON_CALL(mir, mir_connection_is_valid(connection))
+                .WillByDefault(Return(true));
+        ON_CALL(mir, mir_connection_create_display_config(connection))
+                .WillByDefault(Return(&display_config));
+        ON_CALL(mir, mir_create_screencast_spec(connection))
+                .WillByDefault(Return(mir_spec));
+        ON_CALL(mir, mir_connection_get_available_surface_formats(connection, _, _, _))
+                .WillByDefault(SetArgPointee<3>(1));
+        ON_CALL(mir, mir_screencast_create_sync(mir_spec))
+                .WillByDefault(Return(screencast));
+        ON_CALL(mir, mir_screencast_is_valid(screencast))
+                .WillByDefault(Return(true));
+        ON_CALL(mir, mir_screencast_get_buffer_stream(screencast))
+                .WillByDefault(Return(buffer_stream));
+
+        // Every swap of buffers lets the compositor render a new frame
+        // which takes its time before the new buffer is handed out.
+        ON_CALL(mir, mir_buffer_stream_swap_buffers(buffer_stream, _, _))
+                .WillByDefault(Invoke([&](MirBufferStream *stream, mir_buffer_stream_callback callback, void *context) {
+                    compositor.Post([=]() { callback(stream, context); });
+                    return reinterpret_cast<MirWaitHandle*>(5);
+                }));
+        ON_CALL(mir, mir_buffer_stream_swap_buffers_sync(buffer_stream))
+                .WillByDefault(InvokeWithoutArgs([&]() {
+                    std::this_thread::sleep_for(kCompositionTime);
+                }));
+        ON_CALL(mir, mir_wait_for(_))
+                .WillByDefault(InvokeWithoutArgs([&]() {
+                    compositor.WaitUntilIdle();
+                }));
+    }
+
+    // Returns the number of frames per second the pipeline achieved
+    double Run(unsigned int num_buffers) {
+        const auto screencast = std::make_shared<ac::mir::Screencast>(num_buffers);
+        const auto encoder = std::make_shared<SimulatedEncoder>();
+
+        ac::video::DisplayOutput output{ac::video::DisplayOutput::Mode::kMirror, 1280, 720, 60};
+        EXPECT_TRUE(screencast->Setup(output));
+
+        // The compositor can only work on the next frame if not all of
+        // its buffers are held by the encoder.
+        ac::mir::StreamRenderer::Config config;
+        config.buffer_slots = num_buffers - 1;
+        config.async_swap = true;
+
+        auto renderer = std::make_shared<ac::mir::StreamRenderer>(
+                    screencast, encoder, std::make_shared<NullRendererReport>(), config);
+
+        EXPECT_TRUE(renderer->Start());
+
+        const auto start = std::chrono::steady_clock::now();
+        while (std::chrono::steady_clock::now() - start < kBenchmarkDuration)
+            renderer->Execute();
+
+        const auto frames = encoder->FramesEncoded();
+        const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+        renderer->Stop();
+        encoder->Stop();
+        renderer.reset();
+
+        return frames / elapsed.count();
+    }
+
+private:
+    class NullRendererReport : public ac::video::RendererReport {
+    public:
+        void BeganFrame() override { }
+        void FinishedFrame(const ac::video::FrameNumber&, const ac::TimestampUs&) override { }
+        void UnchangedFrame(const ac::TimestampUs&) override { }
+        void SkippedFrames(const unsigned int&) override { }
+        void FrameLateness(const ac::TimestampUs&) override { }
+    };
+
+    NiceMock<ac::test::mir::MockMir> mir;
+    MirScreencastSpec *mir_spec;
+    MirDisplayMode display_mode;
+    MirDisplayOutput display_output;
+    MirDisplayConfiguration display_config;
+    SerialWorker compositor;
+};
+}
+
+TEST(ScreencastBenchmark, MoreBuffersAllowOverlappingCompositionWithEncoding) {
+    ScreencastBenchmark benchmark;
+
+    const auto fps_double_buffered = benchmark.Run(2);
+    const auto fps_triple_buffered = benchmark.Run(3);
+    const auto fps_quadruple_buffered = benchmark.Run(4);
+
+    AC_INFO("Achieved framerate: 2 buffers %.1f fps, 3 buffers %.1f fps, 4 buffers %.1f fps",
+            fps_double_buffered, fps_triple_buffered, fps_quadruple_buffered);
+
+    // With two buffers composition and encoding strictly alternate so we
+    // get one frame every kCompositionTime + kEncodingTime. With more
+    // buffers both overlap and the encoder becomes the limit.
+    EXPECT_GT(fps_triple_buffered, fps_double_buffered * 1.2);
+    EXPECT_GT(fps_quadruple_buffered, fps_triple_buffered * 0.9);
+}
@@ -15,6 +15,11 @@
  *
  */
 
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
 #include <boost/concept_check.hpp>
 
 #include <gmock/gmock.h>
@@ -28,17 +33,562 @@ using namespace ::testing;
 namespace {
 struct TestMirScreencastSpec {
 };
+
+class ScreencastFixture : public ::testing::Test {
+public:
+    ScreencastFixture() :
+        mir(std::make_shared<ac::test::mir::MockMir>()),
+        connection(reinterpret_cast<MirConnection*>(1)),
+        mir_spec(reinterpret_cast<MirScreencastSpec*>(&spec)),
+        mir_screencast(reinterpret_cast<MirScreencast*>(2)),
+        buffer_stream(reinterpret_cast<MirBufferStream*>(3)),
+        num_buffers(0) {
+
+        ::memset(&display_mode, 0, sizeof(display_mode));
+        ::memset(&display_output, 0, sizeof(display_output));
+        ::memset(&display_config, 0, sizeof(display_config));
+
+        display_output.connected = true;
+        display_output.used = true;
+        display_output.current_mode = 0;
+        display_output.num_modes = 1;
+        display_output.modes = &display_mode;
+
+        display_config.num_outputs = 1;
+        display_config.outputs = &display_output;
+    }
+
+    // Lets the whole screencast setup succeed and captures the region
+    // the screencast was configured with.
+    void ExpectSuccessfulSetup(const ac::video::DisplayOutput &output) {
+        EXPECT_CALL(*mir, mir_connect_sync(_, _))
+                .WillOnce(Return(connection));
+        EXPECT_CALL(*mir, mir_connection_is_valid(connection))
+                .WillOnce(Return(true));
+        EXPECT_CALL(*mir, mir_connection_release(connection))
+                .Times(1);
+        EXPECT_CALL(*mir, mir_connection_create_display_config(connection))
+                .WillOnce(Return(&display_config));
+        EXPECT_CALL(*mir, mir_create_screencast_spec(connection))
+                .WillOnce(Return(mir_spec));
+
+        // Scaling happens as part of the capture so the buffer has to
+        // match what the sink expects.
+        EXPECT_CALL(*mir, mir_screencast_spec_set_width(mir_spec, output.width))
+                .Times(1);
+        EXPECT_CALL(*mir, mir_screencast_spec_set_height(mir_spec, output.height))
+                .Times(1);
+
+        EXPECT_CALL(*mir, mir_screencast_spec_set_capture_region(mir_spec, _))
+                .WillOnce(SaveArgPointee<1>(&region));
+
+        EXPECT_CALL(*mir, mir_connection_get_available_surface_formats(connection, _, _, _))
+                .WillOnce(SetArgPointee<3>(1));
+        EXPECT_CALL(*mir, mir_screencast_spec_set_pixel_format(mir_spec, _))
+                .Times(1);
+        EXPECT_CALL(*mir, mir_screencast_spec_set_mirror_mode(mir_spec, mir_mirror_mode_vertical))
+                .Times(1);
+        EXPECT_CALL(*mir, mir_screencast_spec_set_number_of_buffers(mir_spec, _))
+                .WillOnce(SaveArg<1>(&num_buffers));
+        EXPECT_CALL(*mir, mir_screencast_create_sync(mir_spec))
+                .WillOnce(Return(mir_screencast));
+        EXPECT_CALL(*mir, mir_screencast_spec_release(mir_spec))
+                .Times(1);
+        EXPECT_CALL(*mir, mir_screencast_is_valid(mir_screencast))
+                .WillOnce(Return(true));
+        EXPECT_CALL(*mir, mir_screencast_get_buffer_stream(mir_screencast))
+                .WillOnce(Return(buffer_stream));
+        EXPECT_CALL(*mir, mir_screencast_release_sync(mir_screencast))
+                .Times(1);
+        EXPECT_CALL(*mir, mir_buffer_stream_is_valid(buffer_stream))
+                .WillRepeatedly(Return(true));
+    }
+
+    void SetupAndExpectRegion(const ac::video::DisplayOutput &output,
+                              int left, int top, unsigned int width, unsigned int height) {
+        ExpectSuccessfulSetup(output);
+
+        const auto screencast = std::make_shared<ac::mir::Screencast>();
+        EXPECT_TRUE(screencast->Setup(output));
+        EXPECT_EQ(ac::video::DisplayOutput::Mode::kMirror, screencast->OutputMode().mode);
+
+        EXPECT_EQ(left, region.left);
+        EXPECT_EQ(top, region.top);
+        EXPECT_EQ(width, region.width);
+        EXPECT_EQ(height, region.height);
+
+        // The region is scaled into the buffer by the same factor in both
+        // directions, off by at most the pixel we rounded to.
+        EXPECT_NEAR(static_cast<double>(output.width) / output.height,
+                    static_cast<double>(region.width) / region.height,
+                    static_cast<double>(output.width) / output.height / region.height);
+    }
+
+    // Where the output itself ends up in the buffer of the sink, the
+    // rest of it are black bars.
+    MirRectangle ContentInBuffer(const ac::video::DisplayOutput &output, const MirRectangle &content) {
+        MirRectangle rect;
+        rect.left = (content.left - region.left) * static_cast<int>(output.width) / static_cast<int>(region.width);
+        rect.top = (content.top - region.top) * static_cast<int>(output.height) / static_cast<int>(region.height);
+        rect.width = content.width * output.width / region.width;
+        rect.height = content.height * output.height / region.height;
+        return rect;
+    }
+
+    std::shared_ptr<ac::test::mir::MockMir> mir;
+    TestMirScreencastSpec spec;
+    MirConnection *connection;
+    MirScreencastSpec *mir_spec;
+    MirScreencast *mir_screencast;
+    MirBufferStream *buffer_stream;
+    MirDisplayMode display_mode;
+    MirDisplayOutput display_output;
+    MirDisplayConfiguration display_config;
+    MirRectangle region;
+    unsigned int num_buffers;
+};
+}
+
+TEST_F(ScreencastFixture, CapturesActiveOutputWithMatchingAspectRatio) {
+    display_mode.horizontal_resolution = 1920;
+    display_mode.vertical_resolution = 1080;
+    display_output.position_x = 0;
+    display_output.position_y = 0;
+    display_output.orientation = mir_orientation_normal;
+
+    ac::video::DisplayOutput output{ac::video::DisplayOutput::Mode::kMirror, 1280, 720, 30};
+
+    SetupAndExpectRegion(output, 0, 0, 1920, 1080);
+}
+
+TEST_F(ScreencastFixture, CapturesOutputAtItsPosition) {
+    display_mode.horizontal_resolution = 1280;
+    display_mode.vertical_resolution = 720;
+    display_output.position_x = 100;
+    display_output.position_y = 50;
+    display_output.orientation = mir_orientation_normal;
+
+    ac::video::DisplayOutput output{ac::video::DisplayOutput::Mode::kMirror, 1280, 720, 30};
+
+    SetupAndExpectRegion(output, 100, 50, 1280, 720);
+}
+
+TEST_F(ScreencastFixture, LetterboxesWiderOutput) {
+    // 2:1 output onto a 16:9 sink
+    display_mode.horizontal_resolution = 1440;
+    display_mode.vertical_resolution = 720;
+    display_output.position_x = 1920;
+    display_output.orientation = mir_orientation_normal;
+
+    ac::video::DisplayOutput output{ac::video::DisplayOutput::Mode::kMirror, 1280, 720, 30};
+
+    SetupAndExpectRegion(output, 1920, -45, 1440, 810);
+
+    // Full width with bars of 40 lines above and below
+    MirRectangle content{1920, 0, 1440, 720};
+    const auto rect = ContentInBuffer(output, content);
+    EXPECT_EQ(0, rect.left);
+    EXPECT_EQ(40, rect.top);
+    EXPECT_EQ(1280, rect.width);
+    EXPECT_EQ(640, rect.height);
+}
+
+TEST_F(ScreencastFixture, PillarboxesPortraitOutput) {
+    // A phone with a portrait panel in its natural orientation
+    display_mode.horizontal_resolution = 720;
+    display_mode.vertical_resolution = 1280;
+    display_output.orientation = mir_orientation_normal;
+
+    ac::video::DisplayOutput output{ac::video::DisplayOutput::Mode::kMirror, 1280, 720, 30};
+
+    SetupAndExpectRegion(output, -778, 0, 2276, 1280);
+
+    // Centred at full height with bars left and right
+    MirRectangle content{0, 0, 720, 1280};
+    const auto rect = ContentInBuffer(output, content);
+    EXPECT_EQ(437, rect.left);
+    EXPECT_EQ(0, rect.top);
+    EXPECT_EQ(404, rect.width);
+    EXPECT_EQ(720, rect.height);
+}
+
+TEST_F(ScreencastFixture, RefusesToMirrorWhenBarsWouldCoverAnotherOutput) {
+    MirDisplayMode modes[2];
+    MirDisplayOutput outputs[2];
+    ::memset(modes, 0, sizeof(modes));
+    ::memset(outputs, 0, sizeof(outputs));
+
+    // Portrait panel with another landscape output right next to it
+    modes[0].horizontal_resolution = 720;
+    modes[0].vertical_resolution = 1280;
+    modes[1].horizontal_resolution = 1920;
+    modes[1].vertical_resolution = 1080;
+
+    for (unsigned int n = 0; n < 2; n++) {
+        outputs[n].connected = true;
+        outputs[n].used = true;
+        outputs[n].num_modes = 1;
+        outputs[n].modes = &modes[n];
+    }
+    outputs[1].position_x = 720;
+
+    display_config.num_outputs = 2;
+    display_config.outputs = outputs;
+
+    EXPECT_CALL(*mir, mir_connect_sync(_, _))
+            .WillOnce(Return(connection));
+    EXPECT_CALL(*mir, mir_connection_is_valid(connection))
+            .WillOnce(Return(true));
+    EXPECT_CALL(*mir, mir_connection_release(connection))
+            .Times(1);
+    EXPECT_CALL(*mir, mir_connection_create_display_config(connection))
+            .WillOnce(Return(&display_config));
+    EXPECT_CALL(*mir, mir_create_screencast_spec(connection))
+            .WillOnce(Return(mir_spec));
+    EXPECT_CALL(*mir, mir_screencast_spec_set_width(mir_spec, _))
+            .Times(AnyNumber());
+    EXPECT_CALL(*mir, mir_screencast_spec_set_height(mir_spec, _))
+            .Times(AnyNumber());
+    EXPECT_CALL(*mir, mir_screencast_spec_release(mir_spec))
+            .Times(1);
+    EXPECT_CALL(*mir, mir_screencast_create_sync(_))
+            .Times(0);
+
+    ac::video::DisplayOutput output{ac::video::DisplayOutput::Mode::kMirror, 1280, 720, 30};
+    const auto screencast = std::make_shared<ac::mir::Screencast>();
+
+    EXPECT_FALSE(screencast->Setup(output));
+}
+
+TEST_F(ScreencastFixture, RespectsRotationOfPortraitPanel) {
+    // The same portrait panel but held in landscape now
+    display_mode.horizontal_resolution = 720;
+    display_mode.vertical_resolution = 1280;
+    display_output.orientation = mir_orientation_left;
+
+    ac::video::DisplayOutput output{ac::video::DisplayOutput::Mode::kMirror, 1280, 720, 30};
+
+    SetupAndExpectRegion(output, 0, 0, 1280, 720);
+}
+
+TEST_F(ScreencastFixture, RespectsRightRotation) {
+    display_mode.horizontal_resolution = 1080;
+    display_mode.vertical_resolution = 1920;
+    display_output.orientation = mir_orientation_right;
+
+    ac::video::DisplayOutput output{ac::video::DisplayOutput::Mode::kMirror, 1280, 720, 30};
+
+    SetupAndExpectRegion(output, 0, 0, 1920, 1080);
+}
+
+TEST_F(ScreencastFixture, UsesTwoBuffersByDefault) {
+    ac::video::DisplayOutput output{ac::video::DisplayOutput::Mode::kExtend, 1280, 720, 30};
+    ExpectSuccessfulSetup(output);
+
+    const auto screencast = std::make_shared<ac::mir::Screencast>();
+    EXPECT_TRUE(screencast->Setup(output));
+    EXPECT_EQ(2, num_buffers);
+}
+
+TEST_F(ScreencastFixture, ConfiguresNumberOfBuffers) {
+    ac::video::DisplayOutput output{ac::video::DisplayOutput::Mode::kExtend, 1280, 720, 30};
+    ExpectSuccessfulSetup(output);
+
+    const auto screencast = std::make_shared<ac::mir::Screencast>(3);
+    EXPECT_EQ(3, screencast->NumBuffers());
+    EXPECT_TRUE(screencast->Setup(output));
+    EXPECT_EQ(3, num_buffers);
+}
+
+TEST_F(ScreencastFixture, SetupReusesConnectionFromPrepare) {
+    ac::video::DisplayOutput output{ac::video::DisplayOutput::Mode::kExtend, 1280, 720, 30};
+    // Only expects a single connection to Mir
+    ExpectSuccessfulSetup(output);
+
+    const auto screencast = std::make_shared<ac::mir::Screencast>();
+    EXPECT_TRUE(screencast->Prepare());
+    EXPECT_TRUE(screencast->Prepare());
+    EXPECT_TRUE(screencast->Setup(output));
 }
 
-TEST(Screencast, DoesNotSupportMirrorMode) {
+TEST(Screencast, SetupConnectsAgainAfterFailedPrepare) {
+    auto mir = std::make_shared<ac::test::mir::MockMir>();
+    const auto connection = reinterpret_cast<MirConnection*>(1);
+
+    EXPECT_CALL(*mir, mir_connect_sync(_, _))
+            .Times(2)
+            .WillRepeatedly(Return(connection));
+    EXPECT_CALL(*mir, mir_connection_is_valid(connection))
+            .Times(2)
+            .WillRepeatedly(Return(false));
+    EXPECT_CALL(*mir, mir_connection_get_error_message(connection))
+            .Times(2)
+            .WillRepeatedly(Return("Error message from mock"));
+    EXPECT_CALL(*mir, mir_connection_release(connection))
+            .Times(2);
+
     ac::video::DisplayOutput output;
-    ::memset(&output, 0, sizeof(output));
-    output.mode = ac::video::DisplayOutput::Mode::kMirror;
+    output.mode = ac::video::DisplayOutput::Mode::kExtend;
+    const auto screencast = std::make_shared<ac::mir::Screencast>();
+
+    EXPECT_FALSE(screencast->Prepare());
+    EXPECT_FALSE(screencast->Setup(output));
+}
+
+TEST(Screencast, RejectsUnsupportedModeBeforeConnecting) {
+    auto mir = std::make_shared<ac::test::mir::MockMir>();
+
+    EXPECT_CALL(*mir, mir_connect_sync(_, _))
+            .Times(0);
 
+    ac::video::DisplayOutput output{static_cast<ac::video::DisplayOutput::Mode>(42), 1280, 720, 30};
     const auto screencast = std::make_shared<ac::mir::Screencast>();
+
     EXPECT_FALSE(screencast->Setup(output));
 }
 
+TEST(Screencast, ClampsNumberOfBuffers) {
+    EXPECT_EQ(ac::mir::Screencast::kMinNumBuffers, ac::mir::Screencast(0).NumBuffers());
+    EXPECT_EQ(ac::mir::Screencast::kMinNumBuffers, ac::mir::Screencast(1).NumBuffers());
+    EXPECT_EQ(ac::mir::Screencast::kMaxNumBuffers, ac::mir::Screencast(5).NumBuffers());
+}
+
+TEST_F(ScreencastFixture, SwapsBuffersAsynchronously) {
+    ac::video::DisplayOutput output{ac::video::DisplayOutput::Mode::kExtend, 1280, 720, 30};
+    ExpectSuccessfulSetup(output);
+
+    mir_buffer_stream_callback swap_callback = nullptr;
+    void *swap_context = nullptr;
+    auto wait_handle = reinterpret_cast<MirWaitHandle*>(5);
+
+    EXPECT_CALL(*mir, mir_buffer_stream_swap_buffers(buffer_stream, _, _))
+            .Times(2)
+            .WillRepeatedly(DoAll(SaveArg<1>(&swap_callback),
+                                  SaveArg<2>(&swap_context),
+                                  Return(wait_handle)));
+    EXPECT_CALL(*mir, mir_buffer_stream_swap_buffers_sync(_))
+            .Times(0);
+
+    const auto screencast = std::make_shared<ac::mir::Screencast>(3);
+    EXPECT_TRUE(screencast->Setup(output));
+
+    unsigned int swaps_done = 0;
+    unsigned int swaps_failed = 0;
+    const auto count_swaps = [&](bool success) {
+        if (success)
+            swaps_done++;
+        else
+            swaps_failed++;
+    };
+
+    screencast->SwapBuffersAsync(count_swaps);
+    EXPECT_EQ(0, swaps_done);
+
+    ASSERT_NE(nullptr, swap_callback);
+    swap_callback(buffer_stream, swap_context);
+    EXPECT_EQ(1, swaps_done);
+
+    screencast->SwapBuffersAsync(count_swaps);
+    swap_callback(buffer_stream, swap_context);
+    EXPECT_EQ(2, swaps_done);
+    EXPECT_EQ(0, swaps_failed);
+}
+
+TEST_F(ScreencastFixture, RefusesSecondSwapWhileOneIsPending) {
+    ac::video::DisplayOutput output{ac::video::DisplayOutput::Mode::kExtend, 1280, 720, 30};
+    ExpectSuccessfulSetup(output);
+
+    mir_buffer_stream_callback swap_callback = nullptr;
+    void *swap_context = nullptr;
+
+    EXPECT_CALL(*mir, mir_buffer_stream_swap_buffers(buffer_stream, _, _))
+            .WillOnce(DoAll(SaveArg<1>(&swap_callback),
+                            SaveArg<2>(&swap_context),
+                            Return(reinterpret_cast<MirWaitHandle*>(5))));
+
+    const auto screencast = std::make_shared<ac::mir::Screencast>(3);
+    EXPECT_TRUE(screencast->Setup(output));
+
+    std::vector<bool> first, second;
+    screencast->SwapBuffersAsync([&](bool success) { first.push_back(success); });
+
+    // The refused swap is completed right away
+    screencast->SwapBuffersAsync([&](bool success) { second.push_back(success); });
+    EXPECT_EQ(std::vector<bool>{}, first);
+    EXPECT_EQ(std::vector<bool>{false}, second);
+
+    ASSERT_NE(nullptr, swap_callback);
+    swap_callback(buffer_stream, swap_context);
+    EXPECT_EQ(std::vector<bool>{true}, first);
+    EXPECT_EQ(std::vector<bool>{false}, second);
+}
+
+TEST(Screencast, SwapWithoutSetupFails) {
+    auto mir = std::make_shared<ac::test::mir::MockMir>();
+
+    EXPECT_CALL(*mir, mir_buffer_stream_swap_buffers(_, _, _))
+            .Times(0);
+
+    const auto screencast = std::make_shared<ac::mir::Screencast>();
+
+    std::vector<bool> results;
+    screencast->SwapBuffersAsync([&](bool success) { results.push_back(success); });
+    EXPECT_EQ(std::vector<bool>{false}, results);
+}
+
+TEST_F(ScreencastFixture, ReportsFailedSwapOfInvalidStream) {
+    ac::video::DisplayOutput output{ac::video::DisplayOutput::Mode::kExtend, 1280, 720, 30};
+    ExpectSuccessfulSetup(output);
+
+    mir_buffer_stream_callback swap_callback = nullptr;
+    void *swap_context = nullptr;
+
+    EXPECT_CALL(*mir, mir_buffer_stream_swap_buffers(buffer_stream, _, _))
+            .WillOnce(DoAll(SaveArg<1>(&swap_callback),
+                            SaveArg<2>(&swap_context),
+                            Return(reinterpret_cast<MirWaitHandle*>(5))));
+    EXPECT_CALL(*mir, mir_buffer_stream_is_valid(buffer_stream))
+            .WillOnce(Return(false));
+    EXPECT_CALL(*mir, mir_buffer_stream_get_error_message(buffer_stream))
+            .WillOnce(Return("Server went away"));
+
+    const auto screencast = std::make_shared<ac::mir::Screencast>();
+    EXPECT_TRUE(screencast->Setup(output));
+
+    std::vector<bool> results;
+    screencast->SwapBuffersAsync([&](bool success) { results.push_back(success); });
+
+    ASSERT_NE(nullptr, swap_callback);
+    swap_callback(buffer_stream, swap_context);
+    EXPECT_EQ(std::vector<bool>{false}, results);
+}
+
+TEST_F(ScreencastFixture, WaitsForPendingSwapWhenDestroyed) {
+    ac::video::DisplayOutput output{ac::video::DisplayOutput::Mode::kExtend, 1280, 720, 30};
+    ExpectSuccessfulSetup(output);
+
+    mir_buffer_stream_callback swap_callback = nullptr;
+    void *swap_context = nullptr;
+
+    EXPECT_CALL(*mir, mir_buffer_stream_swap_buffers(buffer_stream, _, _))
+            .WillOnce(DoAll(SaveArg<1>(&swap_callback),
+                            SaveArg<2>(&swap_context),
+                            Return(reinterpret_cast<MirWaitHandle*>(5))));
+
+    auto screencast = std::make_shared<ac::mir::Screencast>();
+    EXPECT_TRUE(screencast->Setup(output));
+
+    std::vector<bool> results;
+    screencast->SwapBuffersAsync([&](bool success) { results.push_back(success); });
+    ASSERT_NE(nullptr, swap_callback);
+
+    std::atomic<bool> destroyed{false};
+    std::thread destroyer([&]() {
+        screencast.reset();
+        destroyed = true;
+    });
+
+    // Mir completes the swap from its own thread some time later
+    std::this_thread::sleep_for(std::chrono::milliseconds{50});
+    EXPECT_FALSE(destroyed);
+
+    swap_callback(buffer_stream, swap_context);
+    destroyer.join();
+
+    EXPECT_TRUE(destroyed);
+    EXPECT_EQ(std::vector<bool>{true}, results);
+}
+
+TEST_F(ScreencastFixture, DoesNotWaitWhenNoSwapIsPending) {
+    ac::video::DisplayOutput output{ac::video::DisplayOutput::Mode::kExtend, 1280, 720, 30};
+    ExpectSuccessfulSetup(output);
+
+    mir_buffer_stream_callback swap_callback = nullptr;
+    void *swap_context = nullptr;
+
+    // Mir calls back right from within the swap when it has a buffer
+    // available already.
+    EXPECT_CALL(*mir, mir_buffer_stream_swap_buffers(buffer_stream, _, _))
+            .WillOnce(Invoke([](MirBufferStream *stream, mir_buffer_stream_callback callback, void *context) {
+                callback(stream, context);
+                return reinterpret_cast<MirWaitHandle*>(5);
+            }));
+
+    auto screencast = std::make_shared<ac::mir::Screencast>();
+    EXPECT_TRUE(screencast->Setup(output));
+
+    std::vector<bool> results;
+    screencast->SwapBuffersAsync([&](bool success) { results.push_back(success); });
+    EXPECT_EQ(std::vector<bool>{true}, results);
+
+    screencast.reset();
+}
+
+// Maps the given pixels as content of the current buffer
+void ExpectGraphicsRegion(const std::shared_ptr<ac::test::mir::MockMir> &mir,
+                          std::vector<std::uint32_t> &pixels, int width, int height) {
+    MirGraphicsRegion region;
+    region.width = width;
+    region.height = height;
+    region.stride = width * sizeof(std::uint32_t);
+    region.pixel_format = mir_pixel_format_abgr_8888;
+    region.vaddr = reinterpret_cast<char*>(pixels.data());
+
+    EXPECT_CALL(*mir, mir_buffer_stream_get_graphics_region(_, _))
+            .WillRepeatedly(DoAll(SetArgPointee<1>(region), Return(true)));
+}
+
+TEST_F(ScreencastFixture, DetectsWhetherBufferContentChanged) {
+    ac::video::DisplayOutput output{ac::video::DisplayOutput::Mode::kExtend, 64, 64, 30};
+    ExpectSuccessfulSetup(output);
+
+    std::vector<std::uint32_t> pixels(64 * 64, 0xff000000);
+    ExpectGraphicsRegion(mir, pixels, 64, 64);
+
+    const auto screencast = std::make_shared<ac::mir::Screencast>();
+    EXPECT_TRUE(screencast->Setup(output));
+
+    // Nothing to compare the first buffer with
+    EXPECT_TRUE(screencast->CurrentBufferChanged());
+    EXPECT_FALSE(screencast->CurrentBufferChanged());
+
+    // A sampled pixel changes
+    pixels[0] = 0xffffffff;
+    EXPECT_TRUE(screencast->CurrentBufferChanged());
+    EXPECT_FALSE(screencast->CurrentBufferChanged());
+
+    // Every sampled row starts at another column so a thin vertical
+    // line somewhere in the frame is caught.
+    for (int y = 0; y < 64; y++)
+        pixels[y * 64 + 37] = 0xff00ff00;
+    EXPECT_TRUE(screencast->CurrentBufferChanged());
+    EXPECT_FALSE(screencast->CurrentBufferChanged());
+}
+
+TEST_F(ScreencastFixture, AssumesChangedContentWhenBufferCantBeMapped) {
+    ac::video::DisplayOutput output{ac::video::DisplayOutput::Mode::kExtend, 64, 64, 30};
+    ExpectSuccessfulSetup(output);
+
+    EXPECT_CALL(*mir, mir_buffer_stream_get_graphics_region(buffer_stream, _))
+            .WillRepeatedly(Return(false));
+
+    const auto screencast = std::make_shared<ac::mir::Screencast>();
+    EXPECT_TRUE(screencast->Setup(output));
+
+    EXPECT_TRUE(screencast->CurrentBufferChanged());
+    EXPECT_TRUE(screencast->CurrentBufferChanged());
+}
+
+TEST(Screencast, AssumesChangedContentWithoutSetup) {
+    auto mir = std::make_shared<ac::test::mir::MockMir>();
+
+    EXPECT_CALL(*mir, mir_buffer_stream_get_graphics_region(_, _))
+            .Times(0);
+
+    const auto screencast = std::make_shared<ac::mir::Screencast>();
+    EXPECT_TRUE(screencast->CurrentBufferChanged());
+}
+
 TEST(Screencast, ConnectToMirFailsCorrectly) {
     auto mir = std::make_shared<ac::test::mir::MockMir>();
 
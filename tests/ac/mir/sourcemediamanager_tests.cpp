@@ -17,23 +17,48 @@
 
 #include <gmock/gmock.h>
 
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstring>
+#include <functional>
+#include <mutex>
+
 #include "tests/common/glibhelpers.h"
 
+#include "ac/network/udpstream.h"
+
 #include "ac/mir/sourcemediamanager.h"
 
 using namespace ::testing;
 
 namespace {
+// Only guards against a deadlock when calls we expect to happen side
+// by side get serialized, nothing is measured against it.
+static constexpr std::chrono::milliseconds kRendezvousTimeout{2000};
+
 class MockOutputStream : public ac::network::Stream {
 public:
+    MOCK_METHOD0(Prepare, bool());
     MOCK_METHOD2(Connect, bool(const std::string&, const ac::network::Port&));
     MOCK_METHOD3(Write, ac::network::Stream::Error(const uint8_t*, unsigned int, const ac::TimestampUs&));
     MOCK_CONST_METHOD0(LocalPort, ac::network::Port());
     MOCK_CONST_METHOD0(MaxUnitSize, std::uint32_t());
 };
 
+class MockProbingOutputStream : public MockOutputStream {
+public:
+    MOCK_METHOD0(SendProbe, bool());
+    MOCK_METHOD0(RemoteRefused, bool());
+};
+
 class MockBufferProducer : public ac::video::BufferProducer {
 public:
+    MOCK_METHOD0(Prepare, bool());
     MOCK_METHOD1(Setup, bool(const ac::video::DisplayOutput&));
     MOCK_METHOD0(SwapBuffers, void());
     MOCK_CONST_METHOD0(CurrentBuffer, void*());
@@ -44,6 +69,7 @@ class MockEncoder : public ac::video::BaseEncoder {
 public:
     MOCK_METHOD0(DefaultConfiguration, ac::video::BaseEncoder::Config());
     MOCK_METHOD1(Configure, bool(const ac::video::BaseEncoder::Config&));
+    MOCK_METHOD0(Reset, bool());
     MOCK_METHOD1(QueueBuffer, void(const ac::video::Buffer::Ptr&));
     MOCK_CONST_METHOD0(Configuration, ac::video::BaseEncoder::Config());
     MOCK_CONST_METHOD0(Running, bool());
@@ -74,49 +100,128 @@ public:
     MOCK_CONST_METHOD0(Running, bool());
 };
 
+// Opens a UDP socket on the loopback interface playing the sink
+int OpenSink(std::uint16_t port) {
+    const auto fd = ::socket(AF_INET, SOCK_DGRAM, 0);
+
+    struct sockaddr_in addr;
+    ::memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    addr.sin_port = htons(port);
+    ::bind(fd, reinterpret_cast<struct sockaddr*>(&addr), sizeof(addr));
+
+    return fd;
+}
+
+std::uint16_t FindFreePort() {
+    const auto fd = OpenSink(0);
+
+    struct sockaddr_in addr;
+    socklen_t length = sizeof(addr);
+    ::getsockname(fd, reinterpret_cast<struct sockaddr*>(&addr), &length);
+    ::close(fd);
+
+    return ntohs(addr.sin_port);
+}
+
+bool RunMainLoopUntil(const std::function<bool()> &condition,
+                      const std::chrono::milliseconds &timeout = std::chrono::milliseconds{2000}) {
+    const auto deadline = std::chrono::steady_clock::now() + timeout;
+    while (std::chrono::steady_clock::now() < deadline) {
+        if (condition())
+            return true;
+
+        g_main_context_iteration(nullptr, FALSE);
+        ::usleep(1000);
+    }
+    return condition();
+}
+
+// Lets calls made from different threads wait for each other. Calls
+// which are made one after the other never all meet.
+class Rendezvous {
+public:
+    explicit Rendezvous(unsigned int parties) :
+        missing_(parties) {
+    }
+
+    // Returns whether all other parties arrived while we waited
+    bool Arrive() {
+        std::unique_lock<std::mutex> lock(mutex_);
+        if (missing_ > 0)
+            missing_--;
+        all_arrived_.notify_all();
+        return all_arrived_.wait_for(lock, kRendezvousTimeout, [this]() { return missing_ == 0; });
+    }
+
+    bool WaitForAll() {
+        std::unique_lock<std::mutex> lock(mutex_);
+        return all_arrived_.wait_for(lock, kRendezvousTimeout, [this]() { return missing_ == 0; });
+    }
+
+private:
+    std::mutex mutex_;
+    std::condition_variable all_arrived_;
+    unsigned int missing_;
+};
+
 class SourceMediaManagerFixture : public Test {
 public:
-    bool Configure(const ac::mir::SourceMediaManager::Ptr &manager) {
+    SourceMediaManagerFixture() {
+        ac::mir::SourceMediaManager::ForgetSinkStartDelays();
+    }
+
+    bool Configure(const ac::mir::SourceMediaManager::Ptr &manager,
+                   wds::CEARatesAndResolutions rate_resolution = wds::CEA1280x720p30) {
         std::vector<wds::H264VideoCodec> sink_supported_codecs;
         wds::RateAndResolutionsBitmap cea_rr;
         wds::RateAndResolutionsBitmap vesa_rr;
         wds::RateAndResolutionsBitmap hh_rr;
 
-        cea_rr.set(wds::CEA1280x720p30);
+        cea_rr.set(rate_resolution);
 
         wds::H264VideoCodec codec(wds::CBP, wds::k3_2, cea_rr, vesa_rr, hh_rr);
         sink_supported_codecs.push_back(codec);
 
         wds::NativeVideoFormat sink_native_format;
         sink_native_format.type = wds::CEA;
-        sink_native_format.rate_resolution = wds::CEA1280x720p30;
+        sink_native_format.rate_resolution = rate_resolution;
 
         return manager->InitOptimalVideoFormat(sink_native_format, sink_supported_codecs);
     }
 
     void ExpectCorrectConfiguration() {
-        EXPECT_CALL(*mock_executor_factory, Create(_))
-                .Times(4)
-                .WillRepeatedly(Return(mock_executor));
-
         EXPECT_CALL(*mock_output_stream, Connect(remote_address, _))
                 .WillOnce(Return(true));
 
-        EXPECT_CALL(*mock_output_stream, MaxUnitSize())
-                .WillOnce(Return(1000));
-
         EXPECT_CALL(*mock_buffer_producer, Setup(_))
                 .WillOnce(Return(true));
 
-        EXPECT_CALL(*mock_buffer_producer, OutputMode())
-                .WillRepeatedly(Return(ac::video::DisplayOutput{}));
-
         EXPECT_CALL(*mock_encoder, DefaultConfiguration())
                 .WillOnce(Return(ac::video::BaseEncoder::Config{}));
 
         EXPECT_CALL(*mock_encoder, Configure(_))
                 .WillOnce(Return(true));
 
+        ExpectPipelineAssembly();
+    }
+
+    void ExpectPipelineAssembly() {
+        EXPECT_CALL(*mock_output_stream, MaxUnitSize())
+                .WillOnce(Return(1000));
+
+        ExpectPipelineComponents();
+    }
+
+    void ExpectPipelineComponents() {
+        EXPECT_CALL(*mock_executor_factory, Create(_))
+                .Times(4)
+                .WillRepeatedly(Return(mock_executor));
+
+        EXPECT_CALL(*mock_buffer_producer, OutputMode())
+                .WillRepeatedly(Return(ac::video::DisplayOutput{}));
+
         EXPECT_CALL(*mock_encoder, Configuration())
                 .WillOnce(Return(ac::video::BaseEncoder::Config{}));
 
@@ -130,7 +235,45 @@ public:
                 .WillOnce(Return(nullptr));
     }
 
+    // Sets up a manager streaming through the given stream and counts
+    // how often the executors of the pipeline are started.
+    ac::mir::SourceMediaManager::Ptr CreateStartableManager(const ac::network::Stream::Ptr &output_stream,
+                                                            std::uint16_t sink_port = 0) {
+        EXPECT_CALL(*mock_buffer_producer, Setup(_))
+                .WillOnce(Return(true));
+        EXPECT_CALL(*mock_encoder, DefaultConfiguration())
+                .WillOnce(Return(ac::video::BaseEncoder::Config{}));
+        EXPECT_CALL(*mock_encoder, Configure(_))
+                .WillOnce(Return(true));
+
+        ExpectPipelineComponents();
+
+        EXPECT_CALL(*mock_executor, Start())
+                .WillRepeatedly(InvokeWithoutArgs([this]() {
+                    executors_started++;
+                    return true;
+                }));
+        EXPECT_CALL(*mock_executor, Stop())
+                .WillRepeatedly(Return(true));
+
+        const auto manager = std::make_shared<ac::mir::SourceMediaManager>(
+                    remote_address,
+                    sink_address,
+                    mock_executor_factory,
+                    mock_buffer_producer,
+                    mock_encoder,
+                    output_stream,
+                    mock_report_factory);
+
+        manager->SetSinkRtpPorts(sink_port, 0);
+        EXPECT_TRUE(Configure(manager));
+
+        return manager;
+    }
+
+    int executors_started = 0;
     std::string remote_address = "127.0.0.1";
+    ac::MacAddress sink_address = "02:00:00:00:00:01";
     std::shared_ptr<MockExecutor> mock_executor = std::make_shared<MockExecutor>();
     std::shared_ptr<MockExecutorFactory> mock_executor_factory = std::make_shared<MockExecutorFactory>();
     std::shared_ptr<MockBufferProducer> mock_buffer_producer = std::make_shared<MockBufferProducer>();
@@ -146,6 +289,7 @@ TEST_F(SourceMediaManagerFixture, FailingStreamCausesConfigureToFail) {
 
     const auto manager = std::make_shared<ac::mir::SourceMediaManager>(
                 remote_address,
+                sink_address,
                 mock_executor_factory,
                 nullptr,
                 nullptr,
@@ -164,6 +308,7 @@ TEST_F(SourceMediaManagerFixture, ConfiguresFailsWithFailingProducer) {
 
     const auto manager = std::make_shared<ac::mir::SourceMediaManager>(
                 remote_address,
+                sink_address,
                 mock_executor_factory,
                 mock_buffer_producer,
                 nullptr,
@@ -188,6 +333,7 @@ TEST_F(SourceMediaManagerFixture, ConfigureFailsWithFailingEncoder) {
 
     const auto manager = std::make_shared<ac::mir::SourceMediaManager>(
                 remote_address,
+                sink_address,
                 mock_executor_factory,
                 mock_buffer_producer,
                 mock_encoder,
@@ -202,6 +348,7 @@ TEST_F(SourceMediaManagerFixture, ConfiugresAndSetsUpEverything) {
 
     const auto manager = std::make_shared<ac::mir::SourceMediaManager>(
                 remote_address,
+                sink_address,
                 mock_executor_factory,
                 mock_buffer_producer,
                 mock_encoder,
@@ -224,6 +371,7 @@ TEST_F(SourceMediaManagerFixture, StateSwitching) {
 
     const auto manager = std::make_shared<ac::mir::SourceMediaManager>(
                 remote_address,
+                sink_address,
                 mock_executor_factory,
                 mock_buffer_producer,
                 mock_encoder,
@@ -252,6 +400,7 @@ TEST_F(SourceMediaManagerFixture, StateSwitching) {
 TEST_F(SourceMediaManagerFixture, SendsIDRPicture) {
     const auto manager = std::make_shared<ac::mir::SourceMediaManager>(
                 remote_address,
+                sink_address,
                 mock_executor_factory,
                 mock_buffer_producer,
                 mock_encoder,
@@ -263,3 +412,429 @@ TEST_F(SourceMediaManagerFixture, SendsIDRPicture) {
 
     manager->SendIDRPicture();
 }
+
+TEST_F(SourceMediaManagerFixture, PreparesPipelineAheadOfNegotiation) {
+    ac::video::BaseEncoder::Config prepared_config;
+
+    EXPECT_CALL(*mock_output_stream, Prepare())
+            .WillOnce(Return(true));
+    EXPECT_CALL(*mock_buffer_producer, Prepare())
+            .WillOnce(Return(true));
+    EXPECT_CALL(*mock_encoder, DefaultConfiguration())
+            .Times(2)
+            .WillRepeatedly(Return(ac::video::BaseEncoder::Config{}));
+
+    // Only configured once ahead of time as the sink settles on the
+    // format we speculated on.
+    EXPECT_CALL(*mock_encoder, Configure(_))
+            .WillOnce(DoAll(SaveArg<0>(&prepared_config), Return(true)));
+    EXPECT_CALL(*mock_encoder, Reset())
+            .Times(0);
+
+    EXPECT_CALL(*mock_output_stream, Connect(remote_address, _))
+            .WillOnce(Return(true));
+    EXPECT_CALL(*mock_buffer_producer, Setup(_))
+            .WillOnce(Return(true));
+
+    ExpectPipelineAssembly();
+
+    const auto manager = std::make_shared<ac::mir::SourceMediaManager>(
+                remote_address,
+                sink_address,
+                mock_executor_factory,
+                mock_buffer_producer,
+                mock_encoder,
+                mock_output_stream,
+                mock_report_factory);
+
+    manager->Prepare();
+
+    EXPECT_TRUE(Configure(manager));
+
+    EXPECT_EQ(1280u, prepared_config.width);
+    EXPECT_EQ(720u, prepared_config.height);
+    EXPECT_EQ(30, prepared_config.framerate);
+}
+
+TEST_F(SourceMediaManagerFixture, ReconfiguresPreparedEncoderForOtherFormat) {
+    EXPECT_CALL(*mock_output_stream, Prepare())
+            .WillOnce(Return(true));
+    EXPECT_CALL(*mock_buffer_producer, Prepare())
+            .WillOnce(Return(true));
+    EXPECT_CALL(*mock_encoder, DefaultConfiguration())
+            .Times(2)
+            .WillRepeatedly(Return(ac::video::BaseEncoder::Config{}));
+
+    ac::video::BaseEncoder::Config final_config;
+    {
+        InSequence s;
+
+        EXPECT_CALL(*mock_encoder, Configure(_))
+                .WillOnce(Return(true));
+        EXPECT_CALL(*mock_encoder, Reset())
+                .WillOnce(Return(true));
+        EXPECT_CALL(*mock_encoder, Configure(_))
+                .WillOnce(DoAll(SaveArg<0>(&final_config), Return(true)));
+    }
+
+    EXPECT_CALL(*mock_output_stream, Connect(remote_address, _))
+            .WillOnce(Return(true));
+    EXPECT_CALL(*mock_buffer_producer, Setup(_))
+            .WillOnce(Return(true));
+
+    ExpectPipelineAssembly();
+
+    const auto manager = std::make_shared<ac::mir::SourceMediaManager>(
+                remote_address,
+                sink_address,
+                mock_executor_factory,
+                mock_buffer_producer,
+                mock_encoder,
+                mock_output_stream,
+                mock_report_factory);
+
+    manager->Prepare();
+
+    EXPECT_TRUE(Configure(manager, wds::CEA1280x720p25));
+    EXPECT_EQ(25, final_config.framerate);
+}
+
+TEST_F(SourceMediaManagerFixture, ConfigureFailsWhenPreparedEncoderCannotBeReset) {
+    EXPECT_CALL(*mock_output_stream, Prepare())
+            .WillOnce(Return(true));
+    EXPECT_CALL(*mock_buffer_producer, Prepare())
+            .WillOnce(Return(true));
+    EXPECT_CALL(*mock_encoder, DefaultConfiguration())
+            .Times(2)
+            .WillRepeatedly(Return(ac::video::BaseEncoder::Config{}));
+    EXPECT_CALL(*mock_encoder, Configure(_))
+            .WillOnce(Return(true));
+    EXPECT_CALL(*mock_encoder, Reset())
+            .WillOnce(Return(false));
+
+    EXPECT_CALL(*mock_output_stream, Connect(remote_address, _))
+            .WillOnce(Return(true));
+    EXPECT_CALL(*mock_buffer_producer, Setup(_))
+            .WillOnce(Return(true));
+
+    const auto manager = std::make_shared<ac::mir::SourceMediaManager>(
+                remote_address,
+                sink_address,
+                mock_executor_factory,
+                mock_buffer_producer,
+                mock_encoder,
+                mock_output_stream,
+                mock_report_factory);
+
+    manager->Prepare();
+
+    EXPECT_FALSE(Configure(manager, wds::CEA1280x720p25));
+}
+
+TEST_F(SourceMediaManagerFixture, FailedPreparationIsNotFatal) {
+    EXPECT_CALL(*mock_output_stream, Prepare())
+            .WillOnce(Return(false));
+    EXPECT_CALL(*mock_buffer_producer, Prepare())
+            .WillOnce(Return(false));
+    EXPECT_CALL(*mock_encoder, Reset())
+            .Times(0);
+
+    {
+        InSequence s;
+
+        EXPECT_CALL(*mock_encoder, Configure(_))
+                .WillOnce(Return(false));
+        EXPECT_CALL(*mock_encoder, Configure(_))
+                .WillOnce(Return(true));
+    }
+
+    EXPECT_CALL(*mock_encoder, DefaultConfiguration())
+            .Times(2)
+            .WillRepeatedly(Return(ac::video::BaseEncoder::Config{}));
+    EXPECT_CALL(*mock_output_stream, Connect(remote_address, _))
+            .WillOnce(Return(true));
+    EXPECT_CALL(*mock_buffer_producer, Setup(_))
+            .WillOnce(Return(true));
+
+    ExpectPipelineAssembly();
+
+    const auto manager = std::make_shared<ac::mir::SourceMediaManager>(
+                remote_address,
+                sink_address,
+                mock_executor_factory,
+                mock_buffer_producer,
+                mock_encoder,
+                mock_output_stream,
+                mock_report_factory);
+
+    manager->Prepare();
+
+    EXPECT_TRUE(Configure(manager));
+}
+
+TEST_F(SourceMediaManagerFixture, PreparesSideBySideBeforeFormatIsKnown) {
+    // Creating the socket, connecting to Mir and configuring the encoder
+    // only meet when they run in parallel.
+    Rendezvous rendezvous(3);
+    std::atomic<int> met_others{0};
+    const auto arrive = [&]() {
+        if (rendezvous.Arrive())
+            met_others++;
+        return true;
+    };
+
+    MockFunction<void()> format_known;
+    Sequence stream, producer, encoder;
+
+    EXPECT_CALL(*mock_output_stream, Prepare())
+            .InSequence(stream)
+            .WillOnce(InvokeWithoutArgs(arrive));
+    EXPECT_CALL(*mock_buffer_producer, Prepare())
+            .InSequence(producer)
+            .WillOnce(InvokeWithoutArgs(arrive));
+    EXPECT_CALL(*mock_encoder, Configure(_))
+            .InSequence(encoder)
+            .WillOnce(InvokeWithoutArgs(arrive));
+
+    EXPECT_CALL(format_known, Call())
+            .InSequence(stream, producer, encoder);
+
+    // Once the sink settled the format nothing expensive is left
+    EXPECT_CALL(*mock_output_stream, Connect(remote_address, _))
+            .InSequence(stream)
+            .WillOnce(Return(true));
+    EXPECT_CALL(*mock_buffer_producer, Setup(_))
+            .InSequence(producer)
+            .WillOnce(Return(true));
+    EXPECT_CALL(*mock_encoder, Reset())
+            .Times(0);
+
+    EXPECT_CALL(*mock_encoder, DefaultConfiguration())
+            .Times(2)
+            .WillRepeatedly(Return(ac::video::BaseEncoder::Config{}));
+
+    ExpectPipelineAssembly();
+
+    const auto manager = std::make_shared<ac::mir::SourceMediaManager>(
+                remote_address,
+                sink_address,
+                mock_executor_factory,
+                mock_buffer_producer,
+                mock_encoder,
+                mock_output_stream,
+                mock_report_factory);
+
+    manager->Prepare();
+
+    // The sink negotiates while everything is being prepared
+    EXPECT_TRUE(rendezvous.WaitForAll());
+    format_known.Call();
+
+    EXPECT_TRUE(Configure(manager));
+    EXPECT_EQ(3, met_others);
+}
+
+TEST_F(SourceMediaManagerFixture, StartsRightAwayForListeningSink) {
+    const auto stream = std::make_shared<MockProbingOutputStream>();
+
+    EXPECT_CALL(*stream, Connect(remote_address, _))
+            .WillOnce(Return(true));
+    EXPECT_CALL(*stream, MaxUnitSize())
+            .WillRepeatedly(Return(1000));
+
+    const auto manager = CreateStartableManager(stream);
+
+    // A sink which listens already accepts the first probe and the
+    // pipeline starts on that answer without any further probing.
+    Sequence s;
+
+    EXPECT_CALL(*stream, SendProbe())
+            .InSequence(s)
+            .WillOnce(Return(true));
+    EXPECT_CALL(*stream, RemoteRefused())
+            .InSequence(s)
+            .WillOnce(Return(false));
+    EXPECT_CALL(*mock_executor, Start())
+            .Times(4)
+            .InSequence(s)
+            .WillRepeatedly(InvokeWithoutArgs([this]() {
+                executors_started++;
+                return true;
+            }));
+
+    manager->Play();
+
+    EXPECT_TRUE(RunMainLoopUntil([&]() { return executors_started == 4; }));
+
+    manager->Teardown();
+}
+
+TEST_F(SourceMediaManagerFixture, WaitsForLateSinkBeforeStarting) {
+    const auto sink_port = FindFreePort();
+
+    const auto manager = CreateStartableManager(std::make_shared<ac::network::UdpStream>(), sink_port);
+
+    manager->Play();
+
+    // Nobody listens yet so every probe gets refused
+    RunMainLoopUntil([]() { return false; }, std::chrono::milliseconds{300});
+    EXPECT_EQ(0, executors_started);
+    EXPECT_FALSE(manager->IsPaused());
+
+    const auto sink = OpenSink(sink_port);
+
+    EXPECT_TRUE(RunMainLoopUntil([&]() { return executors_started == 4; }));
+
+    manager->Teardown();
+    ::close(sink);
+}
+
+TEST_F(SourceMediaManagerFixture, DoesNotProbeKnownSinkBeforeItWasReadyLastTime) {
+    static constexpr std::chrono::milliseconds kSinkStartDelay{100};
+
+    const auto create_manager = [&](const ac::network::Stream::Ptr &stream) {
+        return std::make_shared<ac::mir::SourceMediaManager>(
+                    remote_address,
+                    sink_address,
+                    mock_executor_factory,
+                    mock_buffer_producer,
+                    mock_encoder,
+                    stream,
+                    mock_report_factory);
+    };
+
+    // The sink refuses everything in the first session until it is ready
+    auto first_stream = std::make_shared<MockProbingOutputStream>();
+    auto start = std::chrono::steady_clock::now();
+    bool ready = false;
+
+    EXPECT_CALL(*first_stream, SendProbe())
+            .WillRepeatedly(Return(true));
+    EXPECT_CALL(*first_stream, RemoteRefused())
+            .WillRepeatedly(InvokeWithoutArgs([&]() {
+                ready = std::chrono::steady_clock::now() - start >= kSinkStartDelay;
+                return !ready;
+            }));
+
+    auto manager = create_manager(first_stream);
+    manager->Play();
+    EXPECT_TRUE(RunMainLoopUntil([&]() { return ready; }));
+    manager->Teardown();
+
+    // and isn't probed again before that time in the next session
+    auto second_stream = std::make_shared<MockProbingOutputStream>();
+    std::chrono::steady_clock::duration first_probe{0};
+
+    EXPECT_CALL(*second_stream, SendProbe())
+            .WillOnce(InvokeWithoutArgs([&]() {
+                first_probe = std::chrono::steady_clock::now() - start;
+                return true;
+            }));
+    EXPECT_CALL(*second_stream, RemoteRefused())
+            .WillOnce(Return(false));
+
+    manager = create_manager(second_stream);
+    start = std::chrono::steady_clock::now();
+    manager->Play();
+    EXPECT_TRUE(RunMainLoopUntil([&]() { return first_probe.count() > 0; }));
+    RunMainLoopUntil([]() { return false; }, std::chrono::milliseconds{50});
+    manager->Teardown();
+
+    // Probing backs off so we only know for sure the sink still
+    // refused packets about halfway through its start.
+    EXPECT_GE(first_probe, kSinkStartDelay / 2);
+}
+
+TEST_F(SourceMediaManagerFixture, RemembersStartDelayPerSinkDevice) {
+    // Our DHCP server hands out the same address to every sink
+    const ac::MacAddress slow_sink = "02:00:00:00:00:01";
+    const ac::MacAddress other_sink = "02:00:00:00:00:02";
+
+    const auto create_manager = [&](const ac::MacAddress &sink, const ac::network::Stream::Ptr &stream) {
+        return std::make_shared<ac::mir::SourceMediaManager>(
+                    remote_address,
+                    sink,
+                    mock_executor_factory,
+                    mock_buffer_producer,
+                    mock_encoder,
+                    stream,
+                    mock_report_factory);
+    };
+
+    // The slow sink refuses a few probes before it accepts packets
+    auto stream = std::make_shared<MockProbingOutputStream>();
+    int refusals = 3;
+
+    EXPECT_CALL(*stream, SendProbe())
+            .WillRepeatedly(Return(true));
+    EXPECT_CALL(*stream, RemoteRefused())
+            .WillRepeatedly(InvokeWithoutArgs([&]() { return refusals-- > 0; }));
+
+    auto manager = create_manager(slow_sink, stream);
+    manager->Play();
+    EXPECT_TRUE(RunMainLoopUntil([&]() { return refusals < 0; }));
+    manager->Teardown();
+
+    // which doesn't hold back the first probe of another sink
+    stream = std::make_shared<MockProbingOutputStream>();
+
+    EXPECT_CALL(*stream, SendProbe())
+            .WillOnce(Return(true));
+
+    manager = create_manager(other_sink, stream);
+    manager->Play();
+    g_main_context_iteration(nullptr, FALSE);
+    Mock::VerifyAndClearExpectations(stream.get());
+    manager->Teardown();
+
+    // but does for the slow sink itself when it comes back
+    stream = std::make_shared<MockProbingOutputStream>();
+
+    EXPECT_CALL(*stream, SendProbe())
+            .Times(0);
+
+    manager = create_manager(slow_sink, stream);
+    manager->Play();
+    g_main_context_iteration(nullptr, FALSE);
+    Mock::VerifyAndClearExpectations(stream.get());
+    manager->Teardown();
+}
+
+TEST_F(SourceMediaManagerFixture, RemembersStartDelayWhenProbingFails) {
+    // The sink refuses a few probes before we fail to send any more
+    auto stream = std::make_shared<MockProbingOutputStream>();
+    int probes = 3;
+
+    EXPECT_CALL(*stream, Connect(remote_address, _))
+            .WillOnce(Return(true));
+    EXPECT_CALL(*stream, MaxUnitSize())
+            .WillRepeatedly(Return(1000));
+    EXPECT_CALL(*stream, SendProbe())
+            .WillRepeatedly(InvokeWithoutArgs([&]() { return probes-- > 0; }));
+    EXPECT_CALL(*stream, RemoteRefused())
+            .WillRepeatedly(Return(true));
+
+    auto manager = CreateStartableManager(stream);
+    manager->Play();
+    EXPECT_TRUE(RunMainLoopUntil([&]() { return executors_started == 4; }));
+    manager->Teardown();
+
+    // and the time it refused them still holds back the next session
+    stream = std::make_shared<MockProbingOutputStream>();
+
+    EXPECT_CALL(*stream, SendProbe())
+            .Times(0);
+
+    manager = std::make_shared<ac::mir::SourceMediaManager>(
+                remote_address,
+                sink_address,
+                mock_executor_factory,
+                mock_buffer_producer,
+                mock_encoder,
+                stream,
+                mock_report_factory);
+    manager->Play();
+    g_main_context_iteration(nullptr, FALSE);
+    Mock::VerifyAndClearExpectations(stream.get());
+    manager->Teardown();
+}
@@ -18,6 +18,7 @@
 #include <gmock/gmock.h>
 
 #include <atomic>
+#include <vector>
 
 #include "ac/mir/streamrenderer.h"
 
@@ -30,6 +31,7 @@ public:
     MOCK_METHOD0(SwapBuffers, void());
     MOCK_CONST_METHOD0(CurrentBuffer, void*());
     MOCK_CONST_METHOD0(OutputMode, ac::video::DisplayOutput());
+    MOCK_CONST_METHOD0(CurrentBufferTimestamp, ac::TimestampUs());
 };
 
 class MockEncoder : public ac::video::BaseEncoder {
@@ -49,9 +51,99 @@ public:
 class MockRendererReport : public ac::video::RendererReport {
 public:
     MOCK_METHOD0(BeganFrame, void());
-    MOCK_METHOD1(FinishedFrame, void(const ac::TimestampUs&));
+    MOCK_METHOD2(FinishedFrame, void(const ac::video::FrameNumber&, const ac::TimestampUs&));
+    MOCK_METHOD1(UnchangedFrame, void(const ac::TimestampUs&));
+    MOCK_METHOD1(SkippedFrames, void(const unsigned int&));
+    MOCK_METHOD1(FrameLateness, void(const ac::TimestampUs&));
 };
 
+// Producer replaying a script of content changes. Buffers are handed
+// out round-robin like a real producer would do.
+class ScriptedBufferProducer : public ac::video::BufferProducer {
+public:
+    ScriptedBufferProducer(const std::vector<bool> &changes) :
+        changes_(changes),
+        frame_(0),
+        current_(0) {
+    }
+
+    bool Setup(const ac::video::DisplayOutput&) override { return true; }
+
+    void SwapBuffers() override {
+        current_ = frame_++;
+    }
+
+    void* CurrentBuffer() const override {
+        return reinterpret_cast<void*>((current_ % 2) + 1);
+    }
+
+    ac::video::DisplayOutput OutputMode() const override {
+        return ac::video::DisplayOutput{ac::video::DisplayOutput::Mode::kExtend, 1280, 720, 30};
+    }
+
+    bool CurrentBufferChanged() const override {
+        if (changes_.size() == 0)
+            return true;
+        // The script is repeated with its last entry
+        return changes_[std::min<std::size_t>(current_, changes_.size() - 1)];
+    }
+
+    // Number of frames the renderer let us compose
+    std::uint32_t Swaps() const {
+        return frame_;
+    }
+
+private:
+    std::vector<bool> changes_;
+    std::uint32_t frame_;
+    std::uint32_t current_;
+};
+
+// Producer which only finishes a swap of buffers when told so
+class AsyncBufferProducer : public ac::video::BufferProducer {
+public:
+    AsyncBufferProducer() :
+        swaps_requested(0) {
+    }
+
+    bool Setup(const ac::video::DisplayOutput&) override { return true; }
+
+    void SwapBuffers() override {
+        ADD_FAILURE() << "Renderer swapped buffers synchronously";
+    }
+
+    void SwapBuffersAsync(const SwapCallback &callback) override {
+        pending_swap_ = callback;
+        swaps_requested++;
+    }
+
+    void* CurrentBuffer() const override {
+        return reinterpret_cast<void*>(swaps_requested);
+    }
+
+    ac::video::DisplayOutput OutputMode() const override {
+        return ac::video::DisplayOutput{ac::video::DisplayOutput::Mode::kExtend, 1280, 720, 30};
+    }
+
+    void CompleteSwap(bool success = true) {
+        auto callback = pending_swap_;
+        pending_swap_ = nullptr;
+        if (callback)
+            callback(success);
+    }
+
+    std::uint32_t swaps_requested;
+
+private:
+    SwapCallback pending_swap_;
+};
+
+ac::mir::StreamRenderer::Config RendererConfig(std::uint32_t buffer_slots) {
+    ac::mir::StreamRenderer::Config config;
+    config.buffer_slots = buffer_slots;
+    return config;
+}
+
 class StreamRendererFixture : public ::testing::Test {
 public:
     StreamRendererFixture() :
@@ -117,7 +209,7 @@ TEST_F(StreamRendererFixture, TakesBufferFromProducerAndForwardsToEncoder) {
     EXPECT_CALL(*mock_renderer_report, BeganFrame())
             .Times(1);
 
-    EXPECT_CALL(*mock_renderer_report, FinishedFrame(_))
+    EXPECT_CALL(*mock_renderer_report, FinishedFrame(_, _))
             .Times(1);
 
     auto buffer_native_handle = reinterpret_cast<void*>(1);
@@ -165,7 +257,7 @@ TEST_F(StreamRendererFixture, CorrectBufferManagement) {
     EXPECT_CALL(*mock_renderer_report, BeganFrame())
             .Times(AtLeast(1));
 
-    EXPECT_CALL(*mock_renderer_report, FinishedFrame(_))
+    EXPECT_CALL(*mock_renderer_report, FinishedFrame(_, _))
             .Times(AtLeast(1));
 
     EXPECT_CALL(*mock_buffer_producer, SwapBuffers())
@@ -217,7 +309,7 @@ TEST_F(StreamRendererFixture, KeepsExecutingWhenNoFreeSlots) {
     EXPECT_CALL(*mock_renderer_report, BeganFrame())
             .Times(2);
 
-    EXPECT_CALL(*mock_renderer_report, FinishedFrame(_))
+    EXPECT_CALL(*mock_renderer_report, FinishedFrame(_, _))
             .Times(2);
 
     EXPECT_CALL(*mock_buffer_producer, SwapBuffers())
@@ -238,3 +330,552 @@ TEST_F(StreamRendererFixture, KeepsExecutingWhenNoFreeSlots) {
 
     EXPECT_EQ(2, buffers->Size());
 }
+
+TEST_F(StreamRendererFixture, ConfigurableNumberOfBufferSlots) {
+    ExpectValidConfiguration();
+
+    const auto renderer = std::make_shared<ac::mir::StreamRenderer>(
+                mock_buffer_producer,
+                mock_encoder,
+                mock_renderer_report,
+                RendererConfig(4));
+
+    EXPECT_EQ(4, renderer->BufferSlots());
+    EXPECT_EQ(0, renderer->OccupiedBufferSlots());
+
+    std::vector<ac::video::Buffer::Ptr> buffers;
+
+    EXPECT_CALL(*mock_encoder, QueueBuffer(_))
+            .WillRepeatedly(Invoke([&](const ac::video::Buffer::Ptr &buffer) {
+                buffers.push_back(buffer);
+            }));
+
+    EXPECT_CALL(*mock_renderer_report, BeganFrame())
+            .Times(4);
+
+    EXPECT_CALL(*mock_renderer_report, FinishedFrame(_, _))
+            .Times(4);
+
+    EXPECT_CALL(*mock_buffer_producer, SwapBuffers())
+            .Times(4);
+
+    EXPECT_CALL(*mock_buffer_producer, CurrentBuffer())
+            .Times(4)
+            .WillRepeatedly(Return(reinterpret_cast<void*>(1)));
+
+    for (int n = 0; n < 10; n++)
+        EXPECT_TRUE(renderer->Execute());
+
+    EXPECT_EQ(4, buffers.size());
+    EXPECT_EQ(4, renderer->OccupiedBufferSlots());
+}
+
+TEST_F(StreamRendererFixture, InvalidNumberOfBufferSlotsIsClamped) {
+    ExpectValidConfiguration();
+
+    const auto renderer = std::make_shared<ac::mir::StreamRenderer>(
+                mock_buffer_producer,
+                mock_encoder,
+                mock_renderer_report,
+                RendererConfig(0));
+
+    EXPECT_EQ(1, renderer->BufferSlots());
+
+    const auto other_renderer = std::make_shared<ac::mir::StreamRenderer>(
+                mock_buffer_producer,
+                mock_encoder,
+                mock_renderer_report,
+                RendererConfig(ac::mir::StreamRenderer::kMaxBufferSlots + 1));
+
+    EXPECT_EQ(ac::mir::StreamRenderer::kMaxBufferSlots, other_renderer->BufferSlots());
+}
+
+TEST_F(StreamRendererFixture, ReusesSlotsOfBuffersReturnedOutOfOrder) {
+    ExpectValidConfiguration();
+
+    const auto renderer = std::make_shared<ac::mir::StreamRenderer>(
+                mock_buffer_producer,
+                mock_encoder,
+                mock_renderer_report,
+                RendererConfig(3));
+
+    std::vector<ac::video::Buffer::Ptr> buffers;
+
+    EXPECT_CALL(*mock_encoder, QueueBuffer(_))
+            .WillRepeatedly(Invoke([&](const ac::video::Buffer::Ptr &buffer) {
+                buffers.push_back(buffer);
+            }));
+
+    EXPECT_CALL(*mock_renderer_report, BeganFrame())
+            .Times(AtLeast(1));
+
+    EXPECT_CALL(*mock_renderer_report, FinishedFrame(_, _))
+            .Times(AtLeast(1));
+
+    EXPECT_CALL(*mock_buffer_producer, SwapBuffers())
+            .Times(AtLeast(1));
+
+    EXPECT_CALL(*mock_buffer_producer, CurrentBuffer())
+            .WillOnce(Return(reinterpret_cast<void*>(1)))
+            .WillOnce(Return(reinterpret_cast<void*>(2)))
+            .WillOnce(Return(reinterpret_cast<void*>(3)))
+            .WillOnce(Return(reinterpret_cast<void*>(4)));
+
+    for (int n = 0; n < 3; n++)
+        EXPECT_TRUE(renderer->Execute());
+
+    EXPECT_EQ(3, buffers.size());
+    EXPECT_EQ(3, renderer->OccupiedBufferSlots());
+
+    // No free slot left so nothing should be queued
+    EXPECT_TRUE(renderer->Execute());
+    EXPECT_EQ(3, buffers.size());
+
+    // Return the middle buffer first which the old in-order logic
+    // couldn't deal with.
+    buffers[1]->Release();
+    EXPECT_EQ(2, renderer->OccupiedBufferSlots());
+
+    // Returning the same buffer twice must not free another slot
+    buffers[1]->Release();
+    EXPECT_EQ(2, renderer->OccupiedBufferSlots());
+
+    EXPECT_TRUE(renderer->Execute());
+    EXPECT_EQ(4, buffers.size());
+    EXPECT_EQ(reinterpret_cast<void*>(4), buffers[3]->NativeHandle());
+    EXPECT_EQ(3, renderer->OccupiedBufferSlots());
+
+    buffers[2]->Release();
+    buffers[0]->Release();
+    buffers[3]->Release();
+    EXPECT_EQ(0, renderer->OccupiedBufferSlots());
+}
+
+TEST_F(StreamRendererFixture, UsesPresentationTimestampOfProducer) {
+    ExpectValidConfiguration();
+
+    const auto renderer = std::make_shared<ac::mir::StreamRenderer>(
+                mock_buffer_producer,
+                mock_encoder,
+                mock_renderer_report);
+
+    const ac::TimestampUs presentation_time = ac::Utils::GetNowUs() - 1000;
+
+    EXPECT_CALL(*mock_buffer_producer, CurrentBufferTimestamp())
+            .WillOnce(Return(presentation_time));
+
+    EXPECT_CALL(*mock_buffer_producer, CurrentBuffer())
+            .WillOnce(Return(reinterpret_cast<void*>(1)));
+
+    EXPECT_CALL(*mock_renderer_report, FinishedFrame(_, presentation_time))
+            .Times(1);
+
+    // Being the first frame it defines the schedule and can't be late
+    EXPECT_CALL(*mock_renderer_report, FrameLateness(0))
+            .Times(1);
+
+    ac::video::Buffer::Ptr output_buffer;
+
+    EXPECT_CALL(*mock_encoder, QueueBuffer(_))
+            .WillOnce(SaveArg<0>(&output_buffer));
+
+    EXPECT_TRUE(renderer->Execute());
+
+    EXPECT_NE(nullptr, output_buffer.get());
+    EXPECT_EQ(presentation_time, output_buffer->Timestamp());
+}
+
+TEST_F(StreamRendererFixture, PacesOnMonotonicClockWithOffsetPresentationTimestamps) {
+    ExpectValidConfiguration();
+
+    const auto renderer = std::make_shared<ac::mir::StreamRenderer>(
+                mock_buffer_producer,
+                mock_encoder,
+                mock_renderer_report);
+
+    // The producer stamps its buffers with a clock an hour behind
+    // ours. Pacing against that would make every frame look late.
+    static constexpr ac::TimestampUs kOffset{3600ll * 1000 * 1000};
+    static constexpr ac::TimestampUs kInterval{1000 * 1000 / 30};
+
+    ac::TimestampUs presentation_time = ac::Utils::GetNowUs() - kOffset;
+    EXPECT_CALL(*mock_buffer_producer, CurrentBufferTimestamp())
+            .WillRepeatedly(Invoke([&]() {
+                presentation_time += kInterval;
+                return presentation_time;
+            }));
+    EXPECT_CALL(*mock_buffer_producer, CurrentBuffer())
+            .WillRepeatedly(Return(reinterpret_cast<void*>(1)));
+
+    std::vector<ac::TimestampUs> timestamps;
+    EXPECT_CALL(*mock_encoder, QueueBuffer(_))
+            .WillRepeatedly(Invoke([&](const ac::video::Buffer::Ptr &buffer) {
+                timestamps.push_back(buffer->Timestamp());
+                buffer->Release();
+            }));
+
+    std::vector<ac::TimestampUs> lateness;
+    EXPECT_CALL(*mock_renderer_report, FrameLateness(_))
+            .WillRepeatedly(Invoke([&](const ac::TimestampUs &value) {
+                lateness.push_back(value);
+            }));
+    EXPECT_CALL(*mock_renderer_report, SkippedFrames(_))
+            .Times(0);
+
+    EXPECT_TRUE(renderer->Start());
+
+    for (int n = 0; n < 10; n++)
+        EXPECT_TRUE(renderer->Execute());
+
+    EXPECT_EQ(0, renderer->SkippedFrames());
+    for (const auto &value : lateness)
+        EXPECT_LT(value, kInterval);
+
+    // The frames still carry the timestamps of the producer
+    ASSERT_EQ(10, timestamps.size());
+    EXPECT_EQ(presentation_time, timestamps.back());
+}
+
+TEST_F(StreamRendererFixture, KeepsFramerateWithoutDrift) {
+    ExpectValidConfiguration();
+
+    const auto renderer = std::make_shared<ac::mir::StreamRenderer>(
+                mock_buffer_producer,
+                mock_encoder,
+                mock_renderer_report);
+
+    EXPECT_CALL(*mock_buffer_producer, CurrentBuffer())
+            .WillRepeatedly(Return(reinterpret_cast<void*>(1)));
+
+    EXPECT_CALL(*mock_encoder, QueueBuffer(_))
+            .WillRepeatedly(Invoke([&](const ac::video::Buffer::Ptr &buffer) {
+                // Simulate some work being done in the pipeline which
+                // would otherwise accumulate into a drift.
+                std::this_thread::sleep_for(std::chrono::milliseconds{3});
+                buffer->Release();
+            }));
+
+    EXPECT_TRUE(renderer->Start());
+
+    static constexpr unsigned int kNumFrames{30};
+
+    const auto start_time = ac::Utils::GetNowUs();
+    for (unsigned int n = 0; n < kNumFrames; n++)
+        EXPECT_TRUE(renderer->Execute());
+    const auto duration = ac::Utils::GetNowUs() - start_time;
+
+    // 30 frames at 30 fps should take one second. We allow a bit of
+    // tolerance for a loaded machine but a sleep based on the iteration
+    // time would be way off here.
+    EXPECT_NEAR(1000000, duration, 50000);
+    EXPECT_EQ(0, renderer->SkippedFrames());
+}
+
+TEST_F(StreamRendererFixture, SkipsUnchangedFramesButKeepsMinimumRefreshRate) {
+    ExpectValidConfiguration();
+
+    // First frame has new content and after that nothing changes
+    // anymore like on a static desktop.
+    const auto producer = std::make_shared<ScriptedBufferProducer>(std::vector<bool>{true, false});
+
+    ac::mir::StreamRenderer::Config config;
+    config.mode = ac::mir::StreamRenderer::Mode::kSkipUnchanged;
+    config.min_refresh_interval = std::chrono::milliseconds{200};
+
+    const auto renderer = std::make_shared<ac::mir::StreamRenderer>(
+                producer,
+                mock_encoder,
+                mock_renderer_report,
+                config);
+
+    std::uint32_t frames_encoded = 0;
+
+    EXPECT_CALL(*mock_encoder, QueueBuffer(_))
+            .WillRepeatedly(Invoke([&](const ac::video::Buffer::Ptr &buffer) {
+                frames_encoded++;
+                buffer->Release();
+            }));
+
+    EXPECT_TRUE(renderer->Start());
+
+    // Run for one second at 30 fps
+    for (int n = 0; n < 30; n++)
+        EXPECT_TRUE(renderer->Execute());
+
+    EXPECT_TRUE(renderer->Stop());
+
+    // One frame for the initial content and then one every 200ms
+    EXPECT_GE(frames_encoded, 5);
+    EXPECT_LE(frames_encoded, 6);
+    EXPECT_EQ(30, frames_encoded + renderer->UnchangedFrames());
+}
+
+TEST_F(StreamRendererFixture, EncodesAllFramesByDefault) {
+    ExpectValidConfiguration();
+
+    const auto producer = std::make_shared<ScriptedBufferProducer>(std::vector<bool>{true, false});
+
+    const auto renderer = std::make_shared<ac::mir::StreamRenderer>(
+                producer,
+                mock_encoder,
+                mock_renderer_report);
+
+    std::uint32_t frames_encoded = 0;
+
+    EXPECT_CALL(*mock_encoder, QueueBuffer(_))
+            .WillRepeatedly(Invoke([&](const ac::video::Buffer::Ptr &buffer) {
+                frames_encoded++;
+                buffer->Release();
+            }));
+
+    EXPECT_TRUE(renderer->Start());
+
+    for (int n = 0; n < 30; n++)
+        EXPECT_TRUE(renderer->Execute());
+
+    EXPECT_TRUE(renderer->Stop());
+
+    EXPECT_EQ(30, frames_encoded);
+    EXPECT_EQ(0, renderer->UnchangedFrames());
+}
+
+TEST_F(StreamRendererFixture, EncodesChangedFramesWhenSkippingUnchanged) {
+    ExpectValidConfiguration();
+
+    const auto producer = std::make_shared<ScriptedBufferProducer>(
+                std::vector<bool>{true, false, true, false, false, true});
+
+    ac::mir::StreamRenderer::Config config;
+    config.mode = ac::mir::StreamRenderer::Mode::kSkipUnchanged;
+    config.min_refresh_interval = std::chrono::milliseconds{10000};
+
+    const auto renderer = std::make_shared<ac::mir::StreamRenderer>(
+                producer,
+                mock_encoder,
+                mock_renderer_report,
+                config);
+
+    std::uint32_t frames_encoded = 0;
+
+    EXPECT_CALL(*mock_encoder, QueueBuffer(_))
+            .WillRepeatedly(Invoke([&](const ac::video::Buffer::Ptr &buffer) {
+                frames_encoded++;
+                buffer->Release();
+            }));
+
+    // Only frames which went to the encoder are finished and they
+    // are numbered without gaps.
+    EXPECT_CALL(*mock_renderer_report, FinishedFrame(0, _))
+            .Times(0);
+    for (ac::video::FrameNumber frame = 1; frame <= 3; frame++)
+        EXPECT_CALL(*mock_renderer_report, FinishedFrame(frame, _))
+                .Times(1);
+    EXPECT_CALL(*mock_renderer_report, UnchangedFrame(_))
+            .Times(3);
+
+    EXPECT_TRUE(renderer->Start());
+
+    for (int n = 0; n < 6; n++)
+        EXPECT_TRUE(renderer->Execute());
+
+    EXPECT_EQ(3, frames_encoded);
+    EXPECT_EQ(3, renderer->UnchangedFrames());
+}
+
+TEST_F(StreamRendererFixture, RepeatsUnchangedFramesWithoutComposingThem) {
+    ExpectValidConfiguration();
+
+    const auto producer = std::make_shared<ScriptedBufferProducer>(std::vector<bool>{true, false});
+
+    ac::mir::StreamRenderer::Config config;
+    config.mode = ac::mir::StreamRenderer::Mode::kRepeatUnchanged;
+    config.min_refresh_interval = std::chrono::milliseconds{200};
+
+    const auto renderer = std::make_shared<ac::mir::StreamRenderer>(
+                producer,
+                mock_encoder,
+                mock_renderer_report,
+                config);
+
+    std::uint32_t frames_encoded = 0;
+
+    EXPECT_CALL(*mock_encoder, QueueBuffer(_))
+            .WillRepeatedly(Invoke([&](const ac::video::Buffer::Ptr &buffer) {
+                frames_encoded++;
+                buffer->Release();
+            }));
+
+    EXPECT_TRUE(renderer->Start());
+
+    // Run for one second at 30 fps
+    for (int n = 0; n < 30; n++)
+        EXPECT_TRUE(renderer->Execute());
+
+    EXPECT_TRUE(renderer->Stop());
+
+    // The sink gets every frame but only the initial one and one
+    // every 200ms to look for changes were composed.
+    EXPECT_EQ(30, frames_encoded);
+    EXPECT_GE(producer->Swaps(), 5);
+    EXPECT_LE(producer->Swaps(), 6);
+    EXPECT_EQ(30, producer->Swaps() + renderer->UnchangedFrames());
+}
+
+TEST_F(StreamRendererFixture, ComposesEveryFrameWhileContentChangesWhenRepeating) {
+    ExpectValidConfiguration();
+
+    const auto producer = std::make_shared<ScriptedBufferProducer>(
+                std::vector<bool>{true, true, true, false});
+
+    ac::mir::StreamRenderer::Config config;
+    config.mode = ac::mir::StreamRenderer::Mode::kRepeatUnchanged;
+    config.min_refresh_interval = std::chrono::milliseconds{10000};
+
+    const auto renderer = std::make_shared<ac::mir::StreamRenderer>(
+                producer,
+                mock_encoder,
+                mock_renderer_report,
+                config);
+
+    std::vector<void*> buffers;
+
+    EXPECT_CALL(*mock_encoder, QueueBuffer(_))
+            .WillRepeatedly(Invoke([&](const ac::video::Buffer::Ptr &buffer) {
+                buffers.push_back(buffer->NativeHandle());
+                buffer->Release();
+            }));
+    EXPECT_CALL(*mock_renderer_report, UnchangedFrame(_))
+            .Times(2);
+
+    EXPECT_TRUE(renderer->Start());
+
+    for (int n = 0; n < 6; n++)
+        EXPECT_TRUE(renderer->Execute());
+
+    // The last composed buffer is repeated once nothing changes
+    EXPECT_EQ(4, producer->Swaps());
+    EXPECT_EQ(2, renderer->UnchangedFrames());
+    const auto buffer = [](std::uintptr_t n) { return reinterpret_cast<void*>(n); };
+    EXPECT_EQ((std::vector<void*>{buffer(1), buffer(2), buffer(1), buffer(2), buffer(2), buffer(2)}),
+              buffers);
+}
+
+TEST_F(StreamRendererFixture, RequestsNextBufferAheadWhenSwappingAsynchronously) {
+    ExpectValidConfiguration();
+
+    const auto producer = std::make_shared<AsyncBufferProducer>();
+
+    auto config = RendererConfig(2);
+    config.async_swap = true;
+
+    const auto renderer = std::make_shared<ac::mir::StreamRenderer>(
+                producer,
+                mock_encoder,
+                mock_renderer_report,
+                config);
+
+    std::vector<ac::video::Buffer::Ptr> encoding;
+
+    EXPECT_CALL(*mock_encoder, QueueBuffer(_))
+            .WillRepeatedly(Invoke([&](const ac::video::Buffer::Ptr &buffer) {
+                encoding.push_back(buffer);
+            }));
+
+    EXPECT_TRUE(renderer->Start());
+
+    // Nothing is produced as long as the producer didn't finish
+    EXPECT_TRUE(renderer->Execute());
+    EXPECT_EQ(1, producer->swaps_requested);
+    EXPECT_EQ(0, encoding.size());
+
+    // Once the buffer arrived it goes to the encoder and the next one
+    // is requested right away as we still have a free slot.
+    producer->CompleteSwap();
+    EXPECT_TRUE(renderer->Execute());
+    EXPECT_EQ(1, encoding.size());
+    EXPECT_EQ(2, producer->swaps_requested);
+
+    // With all slots occupied no further buffer must be requested
+    producer->CompleteSwap();
+    EXPECT_TRUE(renderer->Execute());
+    EXPECT_EQ(2, encoding.size());
+    EXPECT_EQ(2, producer->swaps_requested);
+
+    encoding[0]->Release();
+    EXPECT_TRUE(renderer->Execute());
+    EXPECT_EQ(3, producer->swaps_requested);
+
+    for (const auto &buffer : encoding)
+        buffer->Release();
+}
+
+TEST_F(StreamRendererFixture, RequestsBufferAgainAfterFailedSwap) {
+    ExpectValidConfiguration();
+
+    const auto producer = std::make_shared<AsyncBufferProducer>();
+
+    auto config = RendererConfig(2);
+    config.async_swap = true;
+
+    const auto renderer = std::make_shared<ac::mir::StreamRenderer>(
+                producer,
+                mock_encoder,
+                mock_renderer_report,
+                config);
+
+    std::vector<ac::video::Buffer::Ptr> encoding;
+
+    EXPECT_CALL(*mock_encoder, QueueBuffer(_))
+            .WillRepeatedly(Invoke([&](const ac::video::Buffer::Ptr &buffer) {
+                encoding.push_back(buffer);
+            }));
+
+    EXPECT_TRUE(renderer->Start());
+
+    EXPECT_TRUE(renderer->Execute());
+    EXPECT_EQ(1, producer->swaps_requested);
+
+    // Nothing is encoded for a failed swap but we don't get stuck
+    // waiting for it either.
+    producer->CompleteSwap(false);
+    EXPECT_TRUE(renderer->Execute());
+    EXPECT_EQ(0, encoding.size());
+
+    EXPECT_TRUE(renderer->Execute());
+    EXPECT_EQ(2, producer->swaps_requested);
+
+    producer->CompleteSwap();
+    EXPECT_TRUE(renderer->Execute());
+    EXPECT_EQ(1, encoding.size());
+
+    for (const auto &buffer : encoding)
+        buffer->Release();
+}
+
+TEST_F(StreamRendererFixture, AsyncSwapFallsBackToSynchronousProducers) {
+    ExpectValidConfiguration();
+
+    auto config = RendererConfig(1);
+    config.async_swap = true;
+
+    const auto renderer = std::make_shared<ac::mir::StreamRenderer>(
+                mock_buffer_producer,
+                mock_encoder,
+                mock_renderer_report,
+                config);
+
+    // The buffer for the next frame is always requested ahead
+    EXPECT_CALL(*mock_buffer_producer, SwapBuffers())
+            .Times(3);
+    EXPECT_CALL(*mock_buffer_producer, CurrentBuffer())
+            .WillRepeatedly(Return(nullptr));
+    EXPECT_CALL(*mock_encoder, QueueBuffer(_))
+            .Times(2)
+            .WillRepeatedly(Invoke([&](const ac::video::Buffer::Ptr &buffer) {
+                buffer->Release();
+            }));
+
+    EXPECT_TRUE(renderer->Start());
+    EXPECT_TRUE(renderer->Execute());
+    EXPECT_TRUE(renderer->Execute());
+}
@@ -0,0 +1,93 @@
+/*
+ * Copyright (C) 2016 Canonical, Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 3, as published
+ * by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranties of
+ * MERCHANTABILITY, SATISFACTORY QUALITY, or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <gtest/gtest.h>
+
+#include <stdlib.h>
+
+#include "ac/network/socketprofile.h"
+
+using ac::network::SocketProfile;
+
+TEST(SocketProfile, VideoMarksPacketsForVideoAccessCategory) {
+    const auto legacy = SocketProfile::Legacy();
+    const auto video = SocketProfile::Video();
+
+    EXPECT_EQ(legacy.send_buffer_size, video.send_buffer_size);
+    EXPECT_GT(0, legacy.type_of_service);
+    EXPECT_GT(0, legacy.priority);
+    EXPECT_EQ(SocketProfile::kVideoTypeOfService, video.type_of_service);
+    EXPECT_EQ(SocketProfile::kVideoPriority, video.priority);
+}
+
+TEST(SocketProfile, DefaultsKeepSystemSettings) {
+    const SocketProfile profile;
+
+    EXPECT_EQ(0, profile.send_buffer_size);
+    EXPECT_GT(0, profile.type_of_service);
+    EXPECT_GT(0, profile.priority);
+    EXPECT_EQ(SocketProfile::MtuDiscovery::kSystem, profile.mtu_discovery);
+}
+
+TEST(SocketProfile, ParsesNamedProfiles) {
+    SocketProfile profile;
+
+    EXPECT_TRUE(SocketProfile::Parse("legacy", profile));
+    EXPECT_EQ(SocketProfile::Legacy(), profile);
+
+    EXPECT_TRUE(SocketProfile::Parse("video", profile));
+    EXPECT_EQ(SocketProfile::Video(), profile);
+}
+
+TEST(SocketProfile, OverridesSingleValues) {
+    SocketProfile profile;
+    EXPECT_TRUE(SocketProfile::Parse("legacy,sndbuf=65536,tos=0x80,priority=4,pmtudisc=do", profile));
+
+    EXPECT_EQ(65536, profile.send_buffer_size);
+    EXPECT_EQ(0x80, profile.type_of_service);
+    EXPECT_EQ(4, profile.priority);
+    EXPECT_EQ(SocketProfile::MtuDiscovery::kDo, profile.mtu_discovery);
+}
+
+TEST(SocketProfile, RejectsInvalidSpecs) {
+    auto profile = SocketProfile::Video();
+
+    EXPECT_FALSE(SocketProfile::Parse("", profile));
+    EXPECT_FALSE(SocketProfile::Parse("voice", profile));
+    EXPECT_FALSE(SocketProfile::Parse("video,tos", profile));
+    EXPECT_FALSE(SocketProfile::Parse("video,tos=high", profile));
+    EXPECT_FALSE(SocketProfile::Parse("video,pmtudisc=maybe", profile));
+    EXPECT_FALSE(SocketProfile::Parse("video,busypoll=50", profile));
+    // Nothing hands launch times to the kernel so SO_TXTIME isn't offered
+    EXPECT_FALSE(SocketProfile::Parse("video,txtime=1", profile));
+
+    // A failed parse leaves the profile alone
+    EXPECT_EQ(SocketProfile::Video(), profile);
+}
+
+TEST(SocketProfile, LoadsFromEnvironment) {
+    ::unsetenv("AETHERCAST_SOCKET_PROFILE");
+    EXPECT_EQ(SocketProfile::Video(), SocketProfile::FromEnvironment());
+
+    ::setenv("AETHERCAST_SOCKET_PROFILE", "legacy", 1);
+    EXPECT_EQ(SocketProfile::Legacy(), SocketProfile::FromEnvironment());
+
+    ::setenv("AETHERCAST_SOCKET_PROFILE", "invalid", 1);
+    EXPECT_EQ(SocketProfile::Video(), SocketProfile::FromEnvironment());
+
+    ::unsetenv("AETHERCAST_SOCKET_PROFILE");
+}
@@ -0,0 +1,137 @@
+/*
+ * Copyright (C) 2016 Canonical, Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 3, as published
+ * by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranties of
+ * MERCHANTABILITY, SATISFACTORY QUALITY, or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <gmock/gmock.h>
+
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <chrono>
+#include <cstring>
+#include <thread>
+
+#include "ac/network/udpstream.h"
+
+namespace {
+// Loopback answers right away but give the kernel a moment
+static constexpr std::chrono::milliseconds kIcmpDelay{20};
+
+int OpenReceiver(std::uint16_t port) {
+    const auto fd = ::socket(AF_INET, SOCK_DGRAM, 0);
+
+    struct sockaddr_in addr;
+    ::memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    addr.sin_port = htons(port);
+    ::bind(fd, reinterpret_cast<struct sockaddr*>(&addr), sizeof(addr));
+
+    return fd;
+}
+
+std::uint16_t FindFreePort() {
+    const auto fd = OpenReceiver(0);
+
+    struct sockaddr_in addr;
+    socklen_t length = sizeof(addr);
+    ::getsockname(fd, reinterpret_cast<struct sockaddr*>(&addr), &length);
+    ::close(fd);
+
+    return ntohs(addr.sin_port);
+}
+}
+
+TEST(UdpStream, ProbingFailsWithoutSocket) {
+    ac::network::UdpStream stream;
+    EXPECT_FALSE(stream.SendProbe());
+    EXPECT_FALSE(stream.RemoteRefused());
+}
+
+TEST(UdpStream, RemoteWithoutReceiverRefusesProbe) {
+    const auto port = FindFreePort();
+
+    ac::network::UdpStream stream;
+    EXPECT_TRUE(stream.Connect("127.0.0.1", port));
+
+    EXPECT_TRUE(stream.SendProbe());
+    std::this_thread::sleep_for(kIcmpDelay);
+    EXPECT_TRUE(stream.RemoteRefused());
+
+    // Checking consumes the refusal
+    EXPECT_FALSE(stream.RemoteRefused());
+}
+
+TEST(UdpStream, ListeningRemoteAcceptsProbe) {
+    const auto port = FindFreePort();
+    const auto receiver = OpenReceiver(port);
+
+    ac::network::UdpStream stream;
+    EXPECT_TRUE(stream.Connect("127.0.0.1", port));
+
+    EXPECT_TRUE(stream.SendProbe());
+    std::this_thread::sleep_for(kIcmpDelay);
+    EXPECT_FALSE(stream.RemoteRefused());
+
+    // The probe doesn't carry any payload
+    std::uint8_t data[16];
+    EXPECT_EQ(0, ::recv(receiver, data, sizeof(data), MSG_DONTWAIT));
+
+    ::close(receiver);
+}
+
+TEST(UdpStream, WritesSucceedAfterRefusalWasChecked) {
+    const auto port = FindFreePort();
+
+    ac::network::UdpStream stream;
+    EXPECT_TRUE(stream.Connect("127.0.0.1", port));
+
+    EXPECT_TRUE(stream.SendProbe());
+    std::this_thread::sleep_for(kIcmpDelay);
+    EXPECT_TRUE(stream.RemoteRefused());
+
+    const auto receiver = OpenReceiver(port);
+
+    const std::uint8_t data[] = { 0x80, 0x21 };
+    EXPECT_EQ(ac::network::Stream::Error::kNone, stream.Write(data, sizeof(data)));
+
+    ::close(receiver);
+}
+
+TEST(UdpStream, ReportsEffectiveSocketProfile) {
+    auto profile = ac::network::SocketProfile::Video();
+    profile.mtu_discovery = ac::network::SocketProfile::MtuDiscovery::kDo;
+
+    ac::network::UdpStream stream(profile);
+    EXPECT_TRUE(stream.Prepare());
+
+    const auto effective = stream.EffectiveProfile();
+
+    // The kernel reserves room for its own bookkeeping on top
+    EXPECT_LE(profile.send_buffer_size, effective.send_buffer_size);
+    EXPECT_EQ(ac::network::SocketProfile::kVideoTypeOfService, effective.type_of_service);
+    EXPECT_EQ(ac::network::SocketProfile::kVideoPriority, effective.priority);
+    EXPECT_EQ(ac::network::SocketProfile::MtuDiscovery::kDo, effective.mtu_discovery);
+}
+
+TEST(UdpStream, LegacyProfileLeavesPacketsUnmarked) {
+    ac::network::UdpStream stream(ac::network::SocketProfile::Legacy());
+    EXPECT_TRUE(stream.Prepare());
+
+    const auto effective = stream.EffectiveProfile();
+    EXPECT_EQ(0, effective.type_of_service);
+}
@@ -0,0 +1,115 @@
+/*
+ * Copyright (C) 2016 Canonical, Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 3, as published
+ * by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranties of
+ * MERCHANTABILITY, SATISFACTORY QUALITY, or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <gmock/gmock.h>
+
+#include "ac/report/composite/compositereportfactory.h"
+
+using namespace ::testing;
+
+namespace {
+class MockEncoderReport : public ac::video::EncoderReport {
+public:
+    MOCK_METHOD0(Started, void());
+    MOCK_METHOD0(Stopped, void());
+    MOCK_METHOD2(BeganFrame, void(const ac::video::FrameNumber&, const ac::TimestampUs&));
+    MOCK_METHOD2(FinishedFrame, void(const ac::video::FrameNumber&, const ac::TimestampUs&));
+    MOCK_METHOD2(ReceivedInputBuffer, void(const ac::video::FrameNumber&, const ac::TimestampUs&));
+    MOCK_METHOD0(RequestedIDRFrame, void());
+    MOCK_METHOD0(EmittedIDRFrame, void());
+};
+
+class MockRendererReport : public ac::video::RendererReport {
+public:
+    MOCK_METHOD0(BeganFrame, void());
+    MOCK_METHOD2(FinishedFrame, void(const ac::video::FrameNumber&, const ac::TimestampUs&));
+    MOCK_METHOD1(UnchangedFrame, void(const ac::TimestampUs&));
+    MOCK_METHOD1(SkippedFrames, void(const unsigned int&));
+    MOCK_METHOD1(FrameLateness, void(const ac::TimestampUs&));
+};
+
+class MockPacketizerReport : public ac::video::PacketizerReport {
+public:
+    MOCK_METHOD2(PacketizedFrame, void(const ac::video::FrameNumber&, const ac::TimestampUs&));
+};
+
+class MockSenderReport : public ac::video::SenderReport {
+public:
+    MOCK_METHOD3(SentPacket, void(const ac::video::FrameNumber&, const ac::TimestampUs&, const size_t&));
+    MOCK_METHOD2(FailedToSendPacket, void(const ac::video::FrameNumber&, const ac::TimestampUs&));
+};
+
+class MockReportFactory : public ac::report::ReportFactory {
+public:
+    MockReportFactory() :
+        encoder(std::make_shared<MockEncoderReport>()),
+        renderer(std::make_shared<MockRendererReport>()),
+        packetizer(std::make_shared<MockPacketizerReport>()),
+        sender(std::make_shared<MockSenderReport>()) {
+    }
+
+    ac::video::EncoderReport::Ptr CreateEncoderReport() override { return encoder; }
+    ac::video::RendererReport::Ptr CreateRendererReport() override { return renderer; }
+    ac::video::PacketizerReport::Ptr CreatePacketizerReport() override { return packetizer; }
+    ac::video::SenderReport::Ptr CreateSenderReport() override { return sender; }
+
+    std::shared_ptr<MockEncoderReport> encoder;
+    std::shared_ptr<MockRendererReport> renderer;
+    std::shared_ptr<MockPacketizerReport> packetizer;
+    std::shared_ptr<MockSenderReport> sender;
+};
+}
+
+TEST(CompositeReportFactory, ForwardsEventsToAllReports) {
+    auto first = std::make_shared<MockReportFactory>();
+    auto second = std::make_shared<MockReportFactory>();
+
+    ac::report::CompositeReportFactory factory({first, second});
+
+    auto encoder = factory.CreateEncoderReport();
+    auto renderer = factory.CreateRendererReport();
+    auto packetizer = factory.CreatePacketizerReport();
+    auto sender = factory.CreateSenderReport();
+
+    for (const auto &f : {first, second}) {
+        EXPECT_CALL(*f->encoder, Started());
+        EXPECT_CALL(*f->encoder, ReceivedInputBuffer(1, 100));
+        EXPECT_CALL(*f->encoder, BeganFrame(1, 100));
+        EXPECT_CALL(*f->encoder, FinishedFrame(1, 100));
+        EXPECT_CALL(*f->encoder, Stopped());
+        EXPECT_CALL(*f->renderer, BeganFrame());
+        EXPECT_CALL(*f->renderer, FinishedFrame(1, 100));
+        EXPECT_CALL(*f->renderer, UnchangedFrame(200));
+        EXPECT_CALL(*f->renderer, SkippedFrames(3));
+        EXPECT_CALL(*f->renderer, FrameLateness(500));
+        EXPECT_CALL(*f->packetizer, PacketizedFrame(1, 100));
+        EXPECT_CALL(*f->sender, SentPacket(1, 100, 1328));
+    }
+
+    encoder->Started();
+    renderer->BeganFrame();
+    renderer->FinishedFrame(1, 100);
+    renderer->UnchangedFrame(200);
+    renderer->SkippedFrames(3);
+    renderer->FrameLateness(500);
+    encoder->ReceivedInputBuffer(1, 100);
+    encoder->BeganFrame(1, 100);
+    encoder->FinishedFrame(1, 100);
+    packetizer->PacketizedFrame(1, 100);
+    sender->SentPacket(1, 100, 1328);
+    encoder->Stopped();
+}
@@ -0,0 +1,558 @@
+/*
+ * Copyright (C) 2016 Canonical, Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 3, as published
+ * by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranties of
+ * MERCHANTABILITY, SATISFACTORY QUALITY, or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <gmock/gmock.h>
+
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <set>
+#include <thread>
+
+#include "tests/common/dbusfixture.h"
+#include "tests/common/dbusnameowner.h"
+#include "tests/common/glibhelpers.h"
+
+#include "tests/w11tng/interfaceskeleton.h"
+#include "tests/w11tng/managerskeleton.h"
+#include "tests/w11tng/p2pdeviceskeleton.h"
+#include "tests/w11tng/peerskeleton.h"
+
+#include "ac/sourcemanager.h"
+
+#include "ac/mir/sourcemediamanager.h"
+
+#include "ac/report/recorder/flightrecorder.h"
+#include "ac/report/timeline/connectiontimeline.h"
+#include "ac/report/timeline/timelinereportfactory.h"
+
+#include "w11tng/networkmanager.h"
+
+using namespace ::testing;
+
+namespace {
+using ConnectionTimeline = ac::report::timeline::ConnectionTimeline;
+using Phase = ConnectionTimeline::Phase;
+
+// Drives a timeline with a clock we control so the phases of a whole
+// connection can be played back without a supplicant, DHCP or a sink.
+struct ConnectionTimelineFixture : public ::testing::Test {
+    ConnectionTimelineFixture() :
+        now(1000000),
+        timeline(ConnectionTimeline::Create([&]() { return now; })) {
+    }
+
+    void Advance(std::uint64_t ms) {
+        now += ms * 1000;
+    }
+
+    void ExpectEntry(const ConnectionTimeline::Entry &entry, Phase phase,
+                     std::uint64_t since_start_ms, std::uint64_t since_previous_ms) {
+        EXPECT_EQ(phase, entry.phase);
+        EXPECT_EQ(since_start_ms * 1000, entry.since_start);
+        EXPECT_EQ(since_previous_ms * 1000, entry.since_previous);
+    }
+
+    // What the network manager, the source and the pipeline report
+    // for a connection which goes through without problems.
+    void PlaySuccessfulConnect(const ac::report::ReportFactory::Ptr &reports) {
+        timeline->Start();
+        Advance(1200);
+        timeline->Mark(Phase::kGroupNegotiated);
+        Advance(800);
+        timeline->Mark(Phase::kGroupStarted);
+        Advance(1500);
+        timeline->Mark(Phase::kAddressAssigned);
+        Advance(100);
+        timeline->Mark(Phase::kSinkConnected);
+        Advance(400);
+        timeline->Mark(Phase::kPlayRequested);
+        Advance(300);
+        timeline->Mark(Phase::kPipelineStarted);
+
+        const auto renderer = reports->CreateRendererReport();
+        const auto encoder = reports->CreateEncoderReport();
+        const auto sender = reports->CreateSenderReport();
+
+        for (ac::video::FrameNumber frame = 1; frame <= 3; frame++) {
+            Advance(16);
+            renderer->FinishedFrame(frame, 0);
+            Advance(8);
+            encoder->FinishedFrame(frame, 0);
+            Advance(1);
+            sender->SentPacket(frame, 0, 1316);
+        }
+    }
+
+    std::uint64_t now;
+    ConnectionTimeline::Ptr timeline;
+};
+
+// How long each step of a connection may take in the harness below
+static constexpr std::chrono::seconds kStepTimeout{5};
+static constexpr const char *kPeerPath{"/peer_1"};
+static constexpr const char *kInterfacePath{"/interface_0"};
+
+class MockNetworkManagerDelegate : public ac::NetworkManager::Delegate {
+public:
+    MOCK_METHOD1(OnDeviceFound, void(const ac::NetworkDevice::Ptr&));
+    MOCK_METHOD1(OnDeviceLost, void(const ac::NetworkDevice::Ptr&));
+    MOCK_METHOD1(OnDeviceStateChanged, void(const ac::NetworkDevice::Ptr&));
+    MOCK_METHOD1(OnDeviceChanged, void(const ac::NetworkDevice::Ptr&));
+    MOCK_METHOD0(OnChanged, void());
+    MOCK_METHOD0(OnReadyChanged, void());
+};
+
+class MockP2PDeviceSkeletonDelegate : public w11tng::testing::P2PDeviceSkeleton::Delegate {
+public:
+    MOCK_METHOD0(OnFind, void());
+    MOCK_METHOD0(OnStopFind, void());
+    MOCK_METHOD1(OnConnect, void(const std::string&));
+    MOCK_METHOD2(OnInvite, void(const std::string&, const std::string&));
+    MOCK_METHOD1(OnAddPersistentGroup, void(const w11tng::P2PDeviceStub::PersistentGroup&));
+    MOCK_METHOD1(OnRemovePersistentGroup, void(const std::string&));
+};
+
+class MockOutputStream : public ac::network::Stream {
+public:
+    MOCK_METHOD2(Connect, bool(const std::string&, const ac::network::Port&));
+    MOCK_METHOD3(Write, ac::network::Stream::Error(const uint8_t*, unsigned int, const ac::TimestampUs&));
+    MOCK_CONST_METHOD0(LocalPort, ac::network::Port());
+    MOCK_CONST_METHOD0(MaxUnitSize, std::uint32_t());
+};
+
+class MockBufferProducer : public ac::video::BufferProducer {
+public:
+    MOCK_METHOD1(Setup, bool(const ac::video::DisplayOutput&));
+    MOCK_METHOD0(SwapBuffers, void());
+    MOCK_CONST_METHOD0(CurrentBuffer, void*());
+    MOCK_CONST_METHOD0(OutputMode, ac::video::DisplayOutput());
+};
+
+class MockEncoder : public ac::video::BaseEncoder {
+public:
+    MOCK_METHOD0(DefaultConfiguration, ac::video::BaseEncoder::Config());
+    MOCK_METHOD1(Configure, bool(const ac::video::BaseEncoder::Config&));
+    MOCK_METHOD0(Reset, bool());
+    MOCK_METHOD1(QueueBuffer, void(const ac::video::Buffer::Ptr&));
+    MOCK_CONST_METHOD0(Configuration, ac::video::BaseEncoder::Config());
+    MOCK_CONST_METHOD0(Running, bool());
+    MOCK_METHOD0(SendIDRFrame, void());
+    MOCK_CONST_METHOD0(Name, std::string());
+    MOCK_METHOD0(Start, bool());
+    MOCK_METHOD0(Stop, bool());
+    MOCK_METHOD0(Execute, bool());
+};
+
+class MockExecutor : public ac::common::Executor {
+public:
+    MOCK_METHOD0(Start, bool());
+    MOCK_METHOD0(Stop, bool());
+    MOCK_CONST_METHOD0(Running, bool());
+};
+
+class MockExecutorFactory : public ac::common::ExecutorFactory {
+public:
+    MOCK_METHOD1(Create, ac::common::Executor::Ptr(const ac::common::Executable::Ptr&));
+};
+
+bool RunMainLoopUntil(const std::function<bool()> &condition) {
+    const auto deadline = std::chrono::steady_clock::now() + kStepTimeout;
+    while (!condition()) {
+        if (std::chrono::steady_clock::now() >= deadline)
+            return false;
+
+        g_main_context_iteration(nullptr, FALSE);
+        ::usleep(1000);
+    }
+    return true;
+}
+
+std::uint16_t FindFreeTcpPort() {
+    const auto fd = ::socket(AF_INET, SOCK_STREAM, 0);
+
+    struct sockaddr_in addr;
+    ::memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    ::bind(fd, reinterpret_cast<struct sockaddr*>(&addr), sizeof(addr));
+
+    socklen_t length = sizeof(addr);
+    ::getsockname(fd, reinterpret_cast<struct sockaddr*>(&addr), &length);
+    ::close(fd);
+
+    return ntohs(addr.sin_port);
+}
+
+// Plays the sink opening the RTSP connection to us
+int ConnectSink(std::uint16_t port) {
+    const auto fd = ::socket(AF_INET, SOCK_STREAM, 0);
+
+    struct sockaddr_in addr;
+    ::memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    addr.sin_port = htons(port);
+    ::connect(fd, reinterpret_cast<struct sockaddr*>(&addr), sizeof(addr));
+
+    return fd;
+}
+
+// Runs a connection through the real network manager, source manager and
+// source media manager of the service. wpa_supplicant is played by the
+// skeletons on a private system bus, the sink by a socket on the loopback
+// interface and the pipeline components by mocks. Every phase has to be
+// stamped by the component owning it and in the order of a connection.
+class ConnectionHarness : public ::testing::Test,
+                          public ac::testing::DBusFixture,
+                          public ac::testing::DBusNameOwner {
+public:
+    ConnectionHarness() :
+        ac::testing::DBusNameOwner(w11tng::NetworkManager::kBusName) {
+    }
+
+    void SetUp() override {
+        unsetenv("AETHERCAST_CONNECTION_TIMELINE");
+        // The session with the sink itself is driven by hand further
+        // down so the source client must not bring up Mir.
+        setenv("MIRACAST_SOURCE_TYPE", "null", 1);
+
+        timeline = ConnectionTimeline::Instance();
+        report_factory = std::make_shared<ac::report::TimelineReportFactory>(timeline);
+
+        manager_skeleton = std::make_shared<w11tng::testing::ManagerSkeleton>(w11tng::ManagerStub::kManagerPath);
+        manager_skeleton->SetCapabilities({"p2p"});
+        manager_skeleton->SetInterfaces({kInterfacePath});
+
+        interface_skeleton = std::make_shared<w11tng::testing::InterfaceSkeleton>(kInterfacePath);
+        interface_skeleton->SetDriver("nl80211");
+        interface_skeleton->SetIfname("wlan0");
+        interface_skeleton->SetCapabilities(P2PCapabilities());
+
+        p2p_device_skeleton = w11tng::testing::P2PDeviceSkeleton::Create(kInterfacePath);
+        p2p_device_skeleton->SetDelegate(p2p_device_delegate);
+
+        peer_skeleton = std::make_shared<w11tng::testing::PeerSkeleton>(kPeerPath);
+        peer_skeleton->SetAddress({0x02, 0x00, 0x00, 0x00, 0x00, 0x01});
+        peer_skeleton->SetName("Sink");
+    }
+
+    void TearDown() override {
+        unsetenv("MIRACAST_SOURCE_TYPE");
+    }
+
+    GVariant* P2PCapabilities() {
+        GVariantBuilder modes_builder;
+        g_variant_builder_init(&modes_builder, G_VARIANT_TYPE("as"));
+        g_variant_builder_add(&modes_builder, "s", "infrastructure");
+        g_variant_builder_add(&modes_builder, "s", "p2p");
+
+        GVariantBuilder builder;
+        g_variant_builder_init(&builder, G_VARIANT_TYPE("a{sv}"));
+        g_variant_builder_add(&builder, "{sv}", "Modes", g_variant_builder_end(&modes_builder));
+
+        return g_variant_builder_end(&builder);
+    }
+
+    ac::mir::SourceMediaManager::Ptr CreateMediaManager(const ac::MacAddress &sink_address) {
+        ON_CALL(*output_stream, Connect(_, _)).WillByDefault(Return(true));
+        ON_CALL(*output_stream, MaxUnitSize()).WillByDefault(Return(1472));
+        ON_CALL(*buffer_producer, Setup(_)).WillByDefault(Return(true));
+        ON_CALL(*buffer_producer, OutputMode()).WillByDefault(Return(ac::video::DisplayOutput{}));
+        ON_CALL(*encoder, DefaultConfiguration()).WillByDefault(Return(ac::video::BaseEncoder::Config{}));
+        ON_CALL(*encoder, Configure(_)).WillByDefault(Return(true));
+        ON_CALL(*encoder, Configuration()).WillByDefault(Return(ac::video::BaseEncoder::Config{}));
+        ON_CALL(*executor, Start()).WillByDefault(Return(true));
+        ON_CALL(*executor, Stop()).WillByDefault(Return(true));
+        ON_CALL(*executor_factory, Create(_)).WillByDefault(Return(executor));
+
+        return std::make_shared<ac::mir::SourceMediaManager>(
+                    "127.0.0.1",
+                    sink_address,
+                    executor_factory,
+                    buffer_producer,
+                    encoder,
+                    output_stream,
+                    report_factory);
+    }
+
+    // What the sink settles on with M4 of the RTSP session
+    bool Configure(const ac::mir::SourceMediaManager::Ptr &manager) {
+        wds::RateAndResolutionsBitmap cea_rr;
+        wds::RateAndResolutionsBitmap vesa_rr;
+        wds::RateAndResolutionsBitmap hh_rr;
+        cea_rr.set(wds::CEA1280x720p30);
+
+        std::vector<wds::H264VideoCodec> sink_supported_codecs;
+        sink_supported_codecs.push_back(wds::H264VideoCodec(wds::CBP, wds::k3_2, cea_rr, vesa_rr, hh_rr));
+
+        wds::NativeVideoFormat sink_native_format;
+        sink_native_format.type = wds::CEA;
+        sink_native_format.rate_resolution = wds::CEA1280x720p30;
+
+        return manager->InitOptimalVideoFormat(sink_native_format, sink_supported_codecs);
+    }
+
+    std::vector<Phase> ReachedPhases() const {
+        std::vector<Phase> phases;
+        for (const auto &entry : timeline->Breakdown())
+            phases.push_back(entry.phase);
+        return phases;
+    }
+
+    ConnectionTimeline::Ptr timeline;
+
+    w11tng::testing::ManagerSkeleton::Ptr manager_skeleton;
+    w11tng::testing::InterfaceSkeleton::Ptr interface_skeleton;
+    w11tng::testing::P2PDeviceSkeleton::Ptr p2p_device_skeleton;
+    std::shared_ptr<w11tng::testing::PeerSkeleton> peer_skeleton;
+
+    std::shared_ptr<MockP2PDeviceSkeletonDelegate> p2p_device_delegate = std::make_shared<NiceMock<MockP2PDeviceSkeletonDelegate>>();
+    NiceMock<MockNetworkManagerDelegate> network_manager_delegate;
+
+    std::shared_ptr<MockOutputStream> output_stream = std::make_shared<NiceMock<MockOutputStream>>();
+    std::shared_ptr<MockBufferProducer> buffer_producer = std::make_shared<NiceMock<MockBufferProducer>>();
+    std::shared_ptr<MockEncoder> encoder = std::make_shared<NiceMock<MockEncoder>>();
+    std::shared_ptr<MockExecutor> executor = std::make_shared<NiceMock<MockExecutor>>();
+    std::shared_ptr<MockExecutorFactory> executor_factory = std::make_shared<NiceMock<MockExecutorFactory>>();
+    ac::report::ReportFactory::Ptr report_factory;
+};
+}
+
+TEST(ConnectionTimeline, PhasesHaveDistinctNames) {
+    std::set<std::string> names;
+    for (std::size_t n = 0; n < ConnectionTimeline::kNumPhases; n++) {
+        const auto name = ConnectionTimeline::PhaseToString(static_cast<Phase>(n));
+        EXPECT_NE("unknown", name);
+        names.insert(name);
+    }
+    EXPECT_EQ(ConnectionTimeline::kNumPhases, names.size());
+}
+
+TEST(ConnectionTimeline, NeedsClock) {
+    EXPECT_EQ(nullptr, ConnectionTimeline::Create(nullptr));
+}
+
+TEST_F(ConnectionTimelineFixture, IgnoresPhasesBeforeStart) {
+    timeline->Mark(Phase::kGroupStarted);
+
+    EXPECT_FALSE(timeline->Reached(Phase::kGroupStarted));
+    EXPECT_EQ(0, timeline->Breakdown().size());
+}
+
+TEST_F(ConnectionTimelineFixture, StampsEachPhaseOnce) {
+    timeline->Start();
+    Advance(10);
+    timeline->Mark(Phase::kGroupStarted);
+    Advance(10);
+    timeline->Mark(Phase::kGroupStarted);
+
+    EXPECT_TRUE(timeline->Reached(Phase::kConnectRequested));
+    EXPECT_TRUE(timeline->Reached(Phase::kGroupStarted));
+    EXPECT_FALSE(timeline->Reached(Phase::kAddressAssigned));
+
+    const auto breakdown = timeline->Breakdown();
+    ASSERT_EQ(2, breakdown.size());
+    ExpectEntry(breakdown[0], Phase::kConnectRequested, 0, 0);
+    ExpectEntry(breakdown[1], Phase::kGroupStarted, 10, 10);
+}
+
+TEST_F(ConnectionTimelineFixture, SuccessfulConnect) {
+    PlaySuccessfulConnect(std::make_shared<ac::report::TimelineReportFactory>(timeline));
+
+    const auto breakdown = timeline->Breakdown();
+    ASSERT_EQ(ConnectionTimeline::kNumPhases, breakdown.size());
+
+    ExpectEntry(breakdown[0], Phase::kConnectRequested, 0, 0);
+    ExpectEntry(breakdown[1], Phase::kGroupNegotiated, 1200, 1200);
+    ExpectEntry(breakdown[2], Phase::kGroupStarted, 2000, 800);
+    ExpectEntry(breakdown[3], Phase::kAddressAssigned, 3500, 1500);
+    ExpectEntry(breakdown[4], Phase::kSinkConnected, 3600, 100);
+    ExpectEntry(breakdown[5], Phase::kPlayRequested, 4000, 400);
+    ExpectEntry(breakdown[6], Phase::kPipelineStarted, 4300, 300);
+    // Only the first frame counts
+    ExpectEntry(breakdown[7], Phase::kFirstFrameRendered, 4316, 16);
+    ExpectEntry(breakdown[8], Phase::kFirstFrameEncoded, 4324, 8);
+    ExpectEntry(breakdown[9], Phase::kFirstPacketSent, 4325, 1);
+}
+
+TEST_F(ConnectionTimelineFixture, FailedAddressAssignmentShowsWhereItStopped) {
+    timeline->Start();
+    Advance(1000);
+    timeline->Mark(Phase::kGroupNegotiated);
+    Advance(500);
+    timeline->Mark(Phase::kGroupStarted);
+    // DHCP gives up and the service never gets any further
+    Advance(30000);
+
+    const auto breakdown = timeline->Breakdown();
+    ASSERT_EQ(3, breakdown.size());
+    EXPECT_EQ(Phase::kGroupStarted, breakdown.back().phase);
+    EXPECT_FALSE(timeline->Reached(Phase::kAddressAssigned));
+}
+
+TEST_F(ConnectionTimelineFixture, StartForgetsLastAttempt) {
+    PlaySuccessfulConnect(std::make_shared<ac::report::TimelineReportFactory>(timeline));
+
+    Advance(60000);
+    timeline->Start();
+    Advance(5);
+    timeline->Mark(Phase::kGroupNegotiated);
+
+    const auto breakdown = timeline->Breakdown();
+    ASSERT_EQ(2, breakdown.size());
+    ExpectEntry(breakdown[1], Phase::kGroupNegotiated, 5, 5);
+    EXPECT_FALSE(timeline->Reached(Phase::kFirstPacketSent));
+}
+
+TEST_F(ConnectionTimelineFixture, BreakdownFollowsTimeNotDeclarationOrder) {
+    timeline->Start();
+    Advance(10);
+    timeline->Mark(Phase::kPlayRequested);
+    Advance(20);
+    timeline->Mark(Phase::kSinkConnected);
+
+    const auto breakdown = timeline->Breakdown();
+    ASSERT_EQ(3, breakdown.size());
+    ExpectEntry(breakdown[1], Phase::kPlayRequested, 10, 10);
+    ExpectEntry(breakdown[2], Phase::kSinkConnected, 30, 20);
+}
+
+TEST_F(ConnectionTimelineFixture, ConcurrentMarksStampOnce) {
+    timeline->Start();
+
+    std::vector<std::thread> threads;
+    for (int n = 0; n < 4; n++) {
+        threads.push_back(std::thread([&]() {
+            for (int m = 0; m < 1000; m++)
+                timeline->Mark(Phase::kFirstPacketSent);
+        }));
+    }
+    for (auto &thread : threads)
+        thread.join();
+
+    const auto breakdown = timeline->Breakdown();
+    ASSERT_EQ(2, breakdown.size());
+    EXPECT_EQ(Phase::kFirstPacketSent, breakdown[1].phase);
+}
+
+TEST(ConnectionTimeline, PutsPhasesIntoFlightRecorder) {
+    using FlightRecorder = ac::report::recorder::FlightRecorder;
+
+    const auto recorder = FlightRecorder::Create(16);
+    ASSERT_NE(nullptr, recorder);
+
+    std::uint64_t now = 1;
+    const auto timeline = ConnectionTimeline::Create([&]() { return now++; }, recorder);
+    timeline->Start();
+    timeline->Mark(Phase::kAddressAssigned);
+    timeline->Mark(Phase::kAddressAssigned);
+
+    const auto events = recorder->Events();
+    ASSERT_EQ(2, events.size());
+    EXPECT_EQ(FlightRecorder::EventType::kConnectionPhase, events[0].type);
+    EXPECT_EQ(static_cast<std::uint32_t>(Phase::kConnectRequested), events[0].value);
+    EXPECT_EQ(FlightRecorder::EventType::kConnectionPhase, events[1].type);
+    EXPECT_EQ(static_cast<std::uint32_t>(Phase::kAddressAssigned), events[1].value);
+}
+
+TEST_F(ConnectionHarness, ComponentsMarkEveryPhaseInOrder) {
+    ASSERT_NE(nullptr, timeline);
+
+    const auto network_manager = std::static_pointer_cast<w11tng::NetworkManager>(w11tng::NetworkManager::Create());
+    network_manager->SetDelegate(&network_manager_delegate);
+
+    ac::NetworkDevice::Ptr device;
+    ON_CALL(network_manager_delegate, OnDeviceFound(_))
+            .WillByDefault(SaveArg<0>(&device));
+
+    // Rfkill state is determined asynchronously before we can start
+    ASSERT_TRUE(RunMainLoopUntil([&]() { return network_manager->Ready(); }));
+    ASSERT_TRUE(network_manager->Setup());
+    ASSERT_TRUE(RunMainLoopUntil([&]() { return network_manager->Running(); }));
+
+    p2p_device_skeleton->EmitDeviceFound(kPeerPath);
+    ASSERT_TRUE(RunMainLoopUntil([&]() { return !!device; }));
+
+    bool connect_requested = false;
+    EXPECT_CALL(*p2p_device_delegate, OnConnect(std::string(kPeerPath)))
+            .WillOnce(Assign(&connect_requested, true));
+
+    // What Service::Connect does before it hands over to the network manager
+    timeline->Start();
+    ASSERT_TRUE(network_manager->Connect(device));
+    ASSERT_TRUE(RunMainLoopUntil([&]() { return connect_requested; }));
+    EXPECT_FALSE(timeline->Reached(Phase::kGroupNegotiated));
+
+    p2p_device_skeleton->EmitGroupOwnerNegotiationSuccess(kPeerPath, w11tng::P2PDeviceStub::Status::kSuccess,
+                                                          2412, {2412}, w11tng::P2PDeviceStub::WpsMethod::kPbc);
+    ASSERT_TRUE(RunMainLoopUntil([&]() { return timeline->Reached(Phase::kGroupNegotiated); }));
+    EXPECT_FALSE(timeline->Reached(Phase::kGroupStarted));
+
+    p2p_device_skeleton->EmitGroupStarted("/group_1", "/interface_1", "client");
+    ASSERT_TRUE(RunMainLoopUntil([&]() { return timeline->Reached(Phase::kGroupStarted); }));
+    EXPECT_FALSE(timeline->Reached(Phase::kAddressAssigned));
+
+    // Getting an address needs a real network interface so we hand it
+    // over the way the DHCP client does once it has a lease.
+    const auto local_address = ac::IpV4Address::from_string("127.0.0.1");
+    network_manager->OnDhcpAddressAssigned(local_address, local_address);
+    EXPECT_TRUE(timeline->Reached(Phase::kAddressAssigned));
+    EXPECT_EQ(ac::kConnected, device->State());
+
+    const auto rtsp_port = FindFreeTcpPort();
+    const auto source_manager = ac::SourceManager::Create(local_address, rtsp_port, device->Address());
+    EXPECT_FALSE(timeline->Reached(Phase::kSinkConnected));
+
+    const auto sink = ConnectSink(rtsp_port);
+    ASSERT_LE(0, sink);
+    ASSERT_TRUE(RunMainLoopUntil([&]() { return timeline->Reached(Phase::kSinkConnected); }));
+
+    // The RTSP session configures the pipeline with M4 and starts it with M7
+    const auto media_manager = CreateMediaManager(device->Address());
+    ASSERT_TRUE(Configure(media_manager));
+    EXPECT_FALSE(timeline->Reached(Phase::kPlayRequested));
+
+    media_manager->Play();
+    EXPECT_TRUE(timeline->Reached(Phase::kPlayRequested));
+    ASSERT_TRUE(RunMainLoopUntil([&]() { return timeline->Reached(Phase::kPipelineStarted); }));
+
+    // The pipeline reports its first frame through the timeline backend
+    report_factory->CreateRendererReport()->FinishedFrame(1, 0);
+    report_factory->CreateEncoderReport()->FinishedFrame(1, 0);
+    report_factory->CreateSenderReport()->SentPacket(1, 0, 1316);
+
+    EXPECT_THAT(ReachedPhases(), ElementsAre(Phase::kConnectRequested,
+                                             Phase::kGroupNegotiated,
+                                             Phase::kGroupStarted,
+                                             Phase::kAddressAssigned,
+                                             Phase::kSinkConnected,
+                                             Phase::kPlayRequested,
+                                             Phase::kPipelineStarted,
+                                             Phase::kFirstFrameRendered,
+                                             Phase::kFirstFrameEncoded,
+                                             Phase::kFirstPacketSent));
+
+    media_manager->Teardown();
+    ::close(sink);
+    network_manager->Release();
+}
@@ -0,0 +1,276 @@
+/*
+ * Copyright (C) 2016 Canonical, Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 3, as published
+ * by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranties of
+ * MERCHANTABILITY, SATISFACTORY QUALITY, or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <gtest/gtest.h>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <fstream>
+#include <iterator>
+#include <thread>
+#include <vector>
+
+#include <boost/filesystem.hpp>
+
+#include "ac/report/recorder/flightrecorder.h"
+#include "ac/report/recorder/recorderreportfactory.h"
+
+using namespace ::testing;
+
+namespace {
+using FlightRecorder = ac::report::recorder::FlightRecorder;
+
+struct FlightRecorderFixture : public ::testing::Test {
+    FlightRecorderFixture() :
+        directory(boost::filesystem::temp_directory_path() /
+                  boost::filesystem::unique_path("flightrecorder-%%%%%%")) {
+        boost::filesystem::create_directories(directory);
+    }
+
+    ~FlightRecorderFixture() {
+        boost::filesystem::remove_all(directory);
+    }
+
+    std::vector<char> ReadFile(const std::string &path) {
+        std::ifstream in(path, std::ios::binary);
+        return std::vector<char>(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+    }
+
+    boost::filesystem::path directory;
+};
+}
+
+TEST_F(FlightRecorderFixture, KeepsEventsInOrder) {
+    const auto recorder = FlightRecorder::Create(8);
+    ASSERT_NE(nullptr, recorder);
+    EXPECT_EQ(8, recorder->Capacity());
+
+    recorder->Record(FlightRecorder::EventType::kRendererFinishedFrame, 1);
+    recorder->Record(FlightRecorder::EventType::kSenderSentPacket, 1, 1328);
+
+    const auto events = recorder->Events();
+    ASSERT_EQ(2, events.size());
+    EXPECT_EQ(FlightRecorder::EventType::kRendererFinishedFrame, events[0].type);
+    EXPECT_EQ(1, events[0].frame);
+    EXPECT_EQ(FlightRecorder::EventType::kSenderSentPacket, events[1].type);
+    EXPECT_EQ(1328, events[1].value);
+    EXPECT_LE(events[0].time, events[1].time);
+}
+
+TEST_F(FlightRecorderFixture, OverwritesOldestEvents) {
+    const auto recorder = FlightRecorder::Create(4);
+    ASSERT_NE(nullptr, recorder);
+
+    for (ac::video::FrameNumber frame = 1; frame <= 10; frame++)
+        recorder->Record(FlightRecorder::EventType::kEncoderFinishedFrame, frame);
+
+    const auto events = recorder->Events();
+    ASSERT_EQ(4, events.size());
+    for (unsigned int n = 0; n < events.size(); n++)
+        EXPECT_EQ(7 + n, events[n].frame);
+}
+
+TEST_F(FlightRecorderFixture, DropsSlotsWithoutMatchingSequence) {
+    const auto path = (directory / "recording").string();
+
+    const auto recorder = FlightRecorder::Create(4, path);
+    ASSERT_NE(nullptr, recorder);
+
+    for (ac::video::FrameNumber frame = 1; frame <= 3; frame++)
+        recorder->Record(FlightRecorder::EventType::kEncoderFinishedFrame, frame);
+
+    // Let the second slot look like a writer was still busy with it
+    // and the third like a newer event went in there already.
+    const auto fd = ::open(path.c_str(), O_WRONLY);
+    ASSERT_LE(0, fd);
+    const std::uint64_t sequences[] = {0, 3 + 4};
+    for (unsigned int n = 0; n < 2; n++) {
+        const auto offset = sizeof(FlightRecorder::Header) + (n + 1) * sizeof(FlightRecorder::Slot);
+        ASSERT_EQ(sizeof(sequences[n]), ::pwrite(fd, &sequences[n], sizeof(sequences[n]), offset));
+    }
+    ::close(fd);
+
+    const auto events = recorder->Events();
+    ASSERT_EQ(1, events.size());
+    EXPECT_EQ(1, events[0].frame);
+}
+
+TEST_F(FlightRecorderFixture, NeverReturnsTornEvents) {
+    const auto recorder = FlightRecorder::Create(64);
+    ASSERT_NE(nullptr, recorder);
+
+    static constexpr unsigned int kNumWriters{4};
+    static constexpr std::uint32_t kEventsPerWriter{200000};
+
+    std::atomic<bool> done{false};
+    std::vector<std::thread> writers;
+    for (unsigned int w = 0; w < kNumWriters; w++) {
+        writers.push_back(std::thread([&, w]() {
+            // Every field of an event can be derived from its frame
+            for (std::uint32_t n = 1; n <= kEventsPerWriter; n++) {
+                const ac::video::FrameNumber frame = (static_cast<std::uint64_t>(w) << 32) | n;
+                recorder->Record(FlightRecorder::EventType::kSenderSentPacket, frame, n);
+            }
+        }));
+    }
+
+    std::uint64_t checked = 0;
+    std::thread reader([&]() {
+        while (!done) {
+            for (const auto &event : recorder->Events()) {
+                ASSERT_EQ(FlightRecorder::EventType::kSenderSentPacket, event.type);
+                ASSERT_EQ(event.frame & 0xffffffff, event.value);
+                checked++;
+            }
+        }
+    });
+
+    for (auto &writer : writers)
+        writer.join();
+    done = true;
+    reader.join();
+
+    EXPECT_LT(0, checked);
+    EXPECT_EQ(64, recorder->Events().size());
+}
+
+TEST_F(FlightRecorderFixture, ZeroCapacityDisables) {
+    EXPECT_EQ(nullptr, FlightRecorder::Create(0));
+}
+
+TEST_F(FlightRecorderFixture, DumpContainsHeaderAndAllSlots) {
+    const auto recorder = FlightRecorder::Create(4);
+    ASSERT_NE(nullptr, recorder);
+
+    for (ac::video::FrameNumber frame = 1; frame <= 5; frame++)
+        recorder->Record(FlightRecorder::EventType::kPacketizerPacketizedFrame, frame);
+
+    const auto path = recorder->DumpToDirectory(directory.string());
+    ASSERT_NE(0, path.length());
+
+    const auto data = ReadFile(path);
+    ASSERT_EQ(sizeof(FlightRecorder::Header) + 4 * sizeof(FlightRecorder::Slot), data.size());
+
+    const auto header = reinterpret_cast<const FlightRecorder::Header*>(data.data());
+    EXPECT_EQ(FlightRecorder::kMagic, header->magic);
+    EXPECT_EQ(FlightRecorder::kVersion, header->version);
+    EXPECT_EQ(sizeof(FlightRecorder::Slot), header->event_size);
+    EXPECT_EQ(4, header->capacity);
+    EXPECT_EQ(5, header->next.load());
+
+    // The fifth event went into the first slot again
+    const auto slots = reinterpret_cast<const FlightRecorder::Slot*>(data.data() + sizeof(FlightRecorder::Header));
+    EXPECT_EQ(5, slots[0].event.frame);
+    EXPECT_EQ(5, slots[0].sequence.load());
+    EXPECT_EQ(2, slots[1].event.frame);
+    EXPECT_EQ(2, slots[1].sequence.load());
+}
+
+TEST_F(FlightRecorderFixture, FileBackedRecorderIsReadableWhileRunning) {
+    const auto path = (directory / "recording").string();
+
+    const auto recorder = FlightRecorder::Create(4, path);
+    ASSERT_NE(nullptr, recorder);
+
+    recorder->Record(FlightRecorder::EventType::kSenderFailedToSendPacket, 3);
+
+    // Without any dump the file has everything as the service could
+    // have crashed any time.
+    const auto data = ReadFile(path);
+    ASSERT_EQ(sizeof(FlightRecorder::Header) + 4 * sizeof(FlightRecorder::Slot), data.size());
+
+    const auto slots = reinterpret_cast<const FlightRecorder::Slot*>(data.data() + sizeof(FlightRecorder::Header));
+    EXPECT_EQ(FlightRecorder::EventType::kSenderFailedToSendPacket, slots[0].event.type);
+    EXPECT_EQ(3, slots[0].event.frame);
+    EXPECT_EQ(1, slots[0].sequence.load());
+}
+
+TEST_F(FlightRecorderFixture, KeepsRecordingOfPreviousRunOnRestart) {
+    const auto path = (directory / "recording").string();
+    const auto previous_path = path + FlightRecorder::kPreviousRecordingSuffix;
+
+    {
+        const auto recorder = FlightRecorder::Create(4, path);
+        ASSERT_NE(nullptr, recorder);
+        recorder->Record(FlightRecorder::EventType::kSenderFailedToSendPacket, 7);
+    }
+
+    EXPECT_FALSE(boost::filesystem::exists(previous_path));
+
+    // Service comes up again after a crash
+    const auto recorder = FlightRecorder::Create(4, path);
+    ASSERT_NE(nullptr, recorder);
+    EXPECT_EQ(0, recorder->Events().size());
+
+    const auto data = ReadFile(previous_path);
+    ASSERT_EQ(sizeof(FlightRecorder::Header) + 4 * sizeof(FlightRecorder::Slot), data.size());
+
+    const auto header = reinterpret_cast<const FlightRecorder::Header*>(data.data());
+    EXPECT_EQ(FlightRecorder::kMagic, header->magic);
+    EXPECT_EQ(1, header->next.load());
+
+    const auto slots = reinterpret_cast<const FlightRecorder::Slot*>(data.data() + sizeof(FlightRecorder::Header));
+    EXPECT_EQ(FlightRecorder::EventType::kSenderFailedToSendPacket, slots[0].event.type);
+    EXPECT_EQ(7, slots[0].event.frame);
+}
+
+TEST_F(FlightRecorderFixture, DumpFailsForInvalidDirectory) {
+    const auto recorder = FlightRecorder::Create(4);
+    ASSERT_NE(nullptr, recorder);
+
+    EXPECT_EQ(0, recorder->DumpToDirectory((directory / "does-not-exist").string()).length());
+}
+
+TEST_F(FlightRecorderFixture, ReportsRecordPipelineEvents) {
+    const auto recorder = FlightRecorder::Create(32);
+    ASSERT_NE(nullptr, recorder);
+
+    ac::report::RecorderReportFactory factory(recorder);
+    const auto renderer = factory.CreateRendererReport();
+    const auto encoder = factory.CreateEncoderReport();
+    const auto packetizer = factory.CreatePacketizerReport();
+    const auto sender = factory.CreateSenderReport();
+
+    renderer->FinishedFrame(1, 100);
+    encoder->ReceivedInputBuffer(1, 100);
+    encoder->ReceivedInputBuffer(2, 200);
+    encoder->FinishedFrame(1, 100);
+    encoder->RequestedIDRFrame();
+    renderer->SkippedFrames(3);
+    packetizer->PacketizedFrame(1, 100);
+    sender->SentPacket(1, 100, 1328);
+    sender->FailedToSendPacket(1, 100);
+
+    const auto events = recorder->Events();
+    ASSERT_EQ(9, events.size());
+
+    EXPECT_EQ(FlightRecorder::EventType::kRendererFinishedFrame, events[0].type);
+    // Frames waiting in the encoder
+    EXPECT_EQ(1, events[1].value);
+    EXPECT_EQ(2, events[2].value);
+    EXPECT_EQ(FlightRecorder::EventType::kEncoderFinishedFrame, events[3].type);
+    EXPECT_EQ(1, events[3].value);
+    EXPECT_EQ(FlightRecorder::EventType::kEncoderRequestedIDRFrame, events[4].type);
+    EXPECT_EQ(FlightRecorder::EventType::kRendererSkippedFrames, events[5].type);
+    EXPECT_EQ(3, events[5].value);
+    EXPECT_EQ(FlightRecorder::EventType::kPacketizerPacketizedFrame, events[6].type);
+    EXPECT_EQ(FlightRecorder::EventType::kSenderSentPacket, events[7].type);
+    EXPECT_EQ(1328, events[7].value);
+    EXPECT_EQ(FlightRecorder::EventType::kSenderFailedToSendPacket, events[8].type);
+}
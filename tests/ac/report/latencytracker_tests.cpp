@@ -0,0 +1,91 @@
+/*
+ * Copyright (C) 2016 Canonical, Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 3, as published
+ * by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranties of
+ * MERCHANTABILITY, SATISFACTORY QUALITY, or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <gtest/gtest.h>
+
+#include "ac/report/latency/tracker.h"
+
+using namespace ac::report::latency;
+
+namespace {
+// Lets a frame go through the whole pipeline with fixed durations in
+// each stage and its datagrams being sent 100us apart.
+void PassFrame(const Tracker::Ptr &tracker, const ac::video::FrameNumber &frame,
+               const ac::TimestampUs &captured, unsigned int num_packets = 2) {
+    tracker->FrameRendered(frame, captured, captured + 1000);
+    tracker->FrameReceivedByEncoder(frame, captured + 1100);
+    tracker->FrameEncoded(frame, captured + 11100);
+    tracker->FramePacketized(frame, captured + 11600);
+
+    for (unsigned int n = 0; n < num_packets; n++)
+        tracker->PacketSent(frame, captured + 12000 + n * 100);
+}
+}
+
+TEST(LatencyTracker, BreaksDownLatencyPerStage) {
+    auto tracker = Tracker::Create();
+
+    PassFrame(tracker, 1, 100000, 3);
+    // A frame only completes once datagrams of the next one go out
+    EXPECT_EQ(0, tracker->StageSummary(Tracker::Stage::kTotal).samples);
+
+    PassFrame(tracker, 2, 133000);
+
+    auto summary = tracker->StageSummary(Tracker::Stage::kCapture);
+    EXPECT_EQ(1, summary.samples);
+    EXPECT_EQ(1000, summary.p50);
+
+    EXPECT_EQ(10000, tracker->StageSummary(Tracker::Stage::kEncode).p50);
+    EXPECT_EQ(500, tracker->StageSummary(Tracker::Stage::kPacketize).p50);
+    EXPECT_EQ(400, tracker->StageSummary(Tracker::Stage::kQueue).p50);
+    EXPECT_EQ(200, tracker->StageSummary(Tracker::Stage::kSend).p50);
+    EXPECT_EQ(12200, tracker->StageSummary(Tracker::Stage::kTotal).p50);
+}
+
+TEST(LatencyTracker, IgnoresIncompleteFramesAndFramesWithoutNumber) {
+    auto tracker = Tracker::Create();
+
+    // Encoder dropped this one
+    tracker->FrameRendered(1, 1000, 2000);
+    tracker->FrameReceivedByEncoder(1, 2100);
+
+    // Buffers not belonging to any frame like codec config
+    tracker->FramePacketized(0, 3000);
+    tracker->PacketSent(0, 3100);
+
+    PassFrame(tracker, 2, 10000);
+    PassFrame(tracker, 3, 43000);
+
+    EXPECT_EQ(1, tracker->StageSummary(Tracker::Stage::kTotal).samples);
+}
+
+TEST(LatencyTracker, PercentilesCoverRollingWindow) {
+    auto tracker = Tracker::Create(10);
+
+    for (ac::video::FrameNumber frame = 1; frame <= 50; frame++)
+        PassFrame(tracker, frame, frame * 33000);
+
+    auto summary = tracker->StageSummary(Tracker::Stage::kEncode);
+    EXPECT_EQ(10, summary.samples);
+    EXPECT_EQ(10000, summary.p99);
+    EXPECT_EQ(10000, summary.max);
+}
+
+TEST(LatencyTracker, HasNamesForAllStages) {
+    for (std::size_t n = 0; n < Tracker::kNumStages; n++)
+        EXPECT_NE("unknown", Tracker::StageName(static_cast<Tracker::Stage>(n)));
+}
@@ -0,0 +1,134 @@
+/*
+ * Copyright (C) 2016 Canonical, Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 3, as published
+ * by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranties of
+ * MERCHANTABILITY, SATISFACTORY QUALITY, or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <gtest/gtest.h>
+
+#include "ac/report/metrics/metrics.h"
+#include "ac/report/metrics/registry.h"
+
+using namespace ac::report::metrics;
+
+namespace {
+static constexpr ac::TimestampUs kSecond{1000000};
+}
+
+TEST(Metrics, CounterAndGauge) {
+    Counter counter;
+    counter.Increment();
+    counter.Increment(41);
+    EXPECT_EQ(42, counter.Value());
+    counter.Reset();
+    EXPECT_EQ(0, counter.Value());
+
+    Gauge gauge;
+    gauge.Set(-3);
+    EXPECT_EQ(-3, gauge.Value());
+}
+
+TEST(Metrics, MeterGivesRateOverCompletedSeconds) {
+    Meter meter;
+    const ac::TimestampUs start = 100 * kSecond;
+
+    EXPECT_EQ(0.0, meter.Rate(start));
+
+    // 30 events per second for ten seconds
+    for (int second = 0; second < 10; second++) {
+        for (int n = 0; n < 30; n++)
+            meter.Mark(1, start + second * kSecond + n * 1000);
+    }
+
+    // The second we're in isn't complete yet and doesn't count
+    meter.Mark(1000, start + 10 * kSecond);
+
+    EXPECT_DOUBLE_EQ(30.0, meter.Rate(start + 10 * kSecond + 500));
+
+    // Not lower while the window hasn't filled up yet
+    Meter young;
+    young.Mark(30, start);
+    young.Mark(30, start + kSecond);
+    EXPECT_DOUBLE_EQ(30.0, young.Rate(start + 2 * kSecond));
+
+    // Nothing happened for too long
+    EXPECT_DOUBLE_EQ(0.0, meter.Rate(start + 30 * kSecond));
+}
+
+TEST(Metrics, HistogramBucketsStayWithinError) {
+    for (std::uint64_t value : {0ull, 1ull, 31ull, 32ull, 33ull, 1000ull, 33333ull, 1000000ull, 1ull << 40, (1ull << 62) + 7}) {
+        const auto index = Histogram::BucketIndex(value);
+        EXPECT_LT(index, Histogram::kNumBuckets);
+
+        const auto bucket_value = Histogram::BucketValue(index);
+        const auto error = bucket_value > value ? bucket_value - value : value - bucket_value;
+        EXPECT_LE(error, value / 16) << "value " << value;
+    }
+
+    EXPECT_EQ(Histogram::kNumBuckets - 1, Histogram::BucketIndex(~0ull));
+}
+
+TEST(Metrics, HistogramPercentiles) {
+    Histogram histogram;
+    EXPECT_EQ(0, histogram.Percentile(50));
+
+    for (int n = 1; n <= 1000; n++)
+        histogram.Record(n * 100);
+
+    histogram.Record(-5);
+
+    EXPECT_EQ(1001, histogram.Count());
+    EXPECT_EQ(100000, histogram.Max());
+    EXPECT_NEAR(50000, histogram.Percentile(50), 50000 / 16);
+    EXPECT_NEAR(99000, histogram.Percentile(99), 99000 / 16);
+    EXPECT_EQ(100000, histogram.Percentile(100));
+
+    histogram.Reset();
+    EXPECT_EQ(0, histogram.Count());
+    EXPECT_EQ(0, histogram.Max());
+}
+
+TEST(MetricsRegistry, ReturnsSameMetricForSameName) {
+    auto registry = Registry::Create();
+
+    auto counter = registry->RegisterCounter("frames");
+    EXPECT_EQ(counter, registry->RegisterCounter("frames"));
+    EXPECT_NE(counter, registry->RegisterCounter("packets"));
+}
+
+TEST(MetricsRegistry, SnapshotContainsAllMetrics) {
+    auto registry = Registry::Create();
+
+    registry->RegisterCounter("frames")->Increment(3);
+    registry->RegisterGauge("depth")->Set(2);
+    registry->RegisterMeter("fps");
+    registry->RegisterHistogram("latency")->Record(20);
+
+    auto snapshot = registry->TakeSnapshot();
+
+    EXPECT_EQ(3.0, snapshot["frames"]);
+    EXPECT_EQ(2.0, snapshot["depth"]);
+    EXPECT_EQ(0.0, snapshot["fps"]);
+    EXPECT_EQ(1.0, snapshot["latency.count"]);
+    EXPECT_EQ(20.0, snapshot["latency.p50"]);
+    EXPECT_EQ(20.0, snapshot["latency.p90"]);
+    EXPECT_EQ(20.0, snapshot["latency.p99"]);
+    EXPECT_EQ(20.0, snapshot["latency.max"]);
+    EXPECT_EQ(8, snapshot.size());
+
+    registry->Reset();
+    snapshot = registry->TakeSnapshot();
+    EXPECT_EQ(0.0, snapshot["frames"]);
+    EXPECT_EQ(0.0, snapshot["latency.count"]);
+}
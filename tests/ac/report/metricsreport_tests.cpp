@@ -0,0 +1,79 @@
+/*
+ * Copyright (C) 2016 Canonical, Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 3, as published
+ * by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranties of
+ * MERCHANTABILITY, SATISFACTORY QUALITY, or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <gtest/gtest.h>
+
+#include "ac/report/metrics/metricsreportfactory.h"
+
+using namespace ac::report;
+
+TEST(MetricsReport, FeedsRegistry) {
+    auto registry = metrics::Registry::Create();
+    MetricsReportFactory factory(registry);
+
+    auto renderer = factory.CreateRendererReport();
+    auto encoder = factory.CreateEncoderReport();
+    auto packetizer = factory.CreatePacketizerReport();
+    auto sender = factory.CreateSenderReport();
+
+    const auto now = ac::Utils::GetNowUs();
+
+    for (ac::video::FrameNumber frame = 1; frame <= 3; frame++) {
+        renderer->FinishedFrame(frame, now);
+        encoder->ReceivedInputBuffer(frame, now);
+    }
+    renderer->UnchangedFrame(now);
+    renderer->SkippedFrames(2);
+    renderer->FrameLateness(0);
+    renderer->FrameLateness(4000);
+
+    encoder->FinishedFrame(1, now);
+
+    packetizer->PacketizedFrame(0, now);
+    packetizer->PacketizedFrame(1, now);
+
+    sender->SentPacket(1, now, 100);
+    sender->SentPacket(1, now, 100);
+
+    auto snapshot = registry->TakeSnapshot();
+
+    EXPECT_EQ(3.0, snapshot["renderer.frames"]);
+    EXPECT_EQ(2.0, snapshot["renderer.skipped_frames"]);
+    EXPECT_EQ(1.0, snapshot["renderer.unchanged_frames"]);
+    EXPECT_EQ(2.0, snapshot["renderer.lateness.count"]);
+    EXPECT_LE(4000.0, snapshot["renderer.lateness.max"]);
+    EXPECT_EQ(1.0, snapshot["encoder.frames"]);
+    EXPECT_EQ(2.0, snapshot["encoder.queue_depth"]);
+    EXPECT_EQ(1.0, snapshot["latency.encode.count"]);
+    EXPECT_EQ(1.0, snapshot["packetizer.frames"]);
+    EXPECT_EQ(2.0, snapshot["sender.packets"]);
+    EXPECT_EQ(200.0, snapshot["sender.bytes"]);
+    EXPECT_EQ(0.0, snapshot["sender.queue_depth"]);
+    // Only measured once for every frame
+    EXPECT_EQ(1.0, snapshot["latency.total.count"]);
+    EXPECT_LE(0.0, snapshot["latency.total.max"]);
+}
+
+TEST(MetricsReport, NewFactoryStartsNewSession) {
+    auto registry = metrics::Registry::Create();
+
+    auto counter = registry->RegisterCounter("renderer.frames");
+    counter->Increment(10);
+
+    MetricsReportFactory factory(registry);
+    EXPECT_EQ(0, counter->Value());
+}
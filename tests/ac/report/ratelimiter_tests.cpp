@@ -0,0 +1,43 @@
+/*
+ * Copyright (C) 2016 Canonical, Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 3, as published
+ * by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranties of
+ * MERCHANTABILITY, SATISFACTORY QUALITY, or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <gtest/gtest.h>
+
+#include "ac/report/logging/ratelimiter.h"
+
+using namespace ac::report::logging;
+
+TEST(RateLimiter, LimitsMessagesPerSecond) {
+    RateLimiter limiter(3);
+    const ac::TimestampUs start = 1000000;
+
+    EXPECT_TRUE(limiter.Allow(start));
+    EXPECT_TRUE(limiter.Allow(start + 10));
+    EXPECT_TRUE(limiter.Allow(start + 20));
+    EXPECT_FALSE(limiter.Allow(start + 30));
+    EXPECT_FALSE(limiter.Allow(start + 999999));
+
+    // Next second starts
+    EXPECT_TRUE(limiter.Allow(start + 1000000));
+}
+
+TEST(RateLimiter, ZeroDisablesLimit) {
+    RateLimiter limiter(0);
+
+    for (int n = 0; n < 1000; n++)
+        EXPECT_TRUE(limiter.Allow(0));
+}
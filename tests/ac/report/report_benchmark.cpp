@@ -0,0 +1,159 @@
+/*
+ * Copyright (C) 2016 Canonical, Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 3, as published
+ * by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranties of
+ * MERCHANTABILITY, SATISFACTORY QUALITY, or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <gtest/gtest.h>
+
+#include <boost/concept_check.hpp>
+
+#include <chrono>
+#include <cstdlib>
+#include <memory>
+#include <vector>
+
+#include "ac/logger.h"
+
+#include "ac/report/reportfactory.h"
+#include "ac/report/null/nullreportfactory.h"
+#include "ac/report/composite/compositereportfactory.h"
+#include "ac/report/timeline/connectiontimeline.h"
+
+namespace {
+static constexpr unsigned int kNumFrames{1000000};
+// Roughly what a 720p frame at 5 Mbit/s needs in RTP datagrams
+static constexpr unsigned int kPacketsPerFrame{8};
+static constexpr std::size_t kPacketSize{1328};
+// A frame at 60 fps has 16.6ms. Everything below a microsecond isn't
+// measurable in the pipeline at all.
+static constexpr double kMaxNullCostPerFrameNs{1000.0};
+// Without any report type configured the service still feeds the
+// flight recorder and the connection timeline with every frame so
+// they must not take more than a tiny fraction of a frame either.
+static constexpr double kMaxDefaultCostPerFrameNs{10000.0};
+
+struct Reports {
+    explicit Reports(const ac::report::ReportFactory::Ptr &factory) :
+        encoder(factory->CreateEncoderReport()),
+        renderer(factory->CreateRendererReport()),
+        packetizer(factory->CreatePacketizerReport()),
+        sender(factory->CreateSenderReport()) {
+    }
+
+    ac::video::EncoderReport::Ptr encoder;
+    ac::video::RendererReport::Ptr renderer;
+    ac::video::PacketizerReport::Ptr packetizer;
+    ac::video::SenderReport::Ptr sender;
+};
+
+// Calls all reports the same way the pipeline does for every frame
+// and returns the time needed per frame in nano-seconds.
+double RunFrames(Reports *reports) {
+    volatile ac::video::FrameNumber sink = 0;
+
+    const auto start = std::chrono::steady_clock::now();
+
+    for (ac::video::FrameNumber frame = 1; frame <= kNumFrames; frame++) {
+        const ac::TimestampUs timestamp = frame * 33333;
+
+        if (reports) {
+            reports->renderer->BeganFrame();
+            reports->renderer->FrameLateness(0);
+            reports->renderer->FinishedFrame(frame, timestamp);
+            reports->encoder->ReceivedInputBuffer(frame, timestamp);
+            reports->encoder->BeganFrame(frame, timestamp);
+            reports->encoder->FinishedFrame(frame, timestamp);
+            reports->packetizer->PacketizedFrame(frame, timestamp);
+            for (unsigned int n = 0; n < kPacketsPerFrame; n++)
+                reports->sender->SentPacket(frame, timestamp, kPacketSize);
+        }
+
+        sink = frame;
+    }
+
+    boost::ignore_unused_variable_warning(sink);
+
+    const std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+    return elapsed.count() / kNumFrames;
+}
+
+// The reports the service would create with the given report types
+// and otherwise its default environment.
+Reports ServiceReports(const char *types) {
+    if (types)
+        setenv("AETHERCAST_REPORT_TYPE", types, 1);
+    else
+        unsetenv("AETHERCAST_REPORT_TYPE");
+
+    Reports reports(ac::report::ReportFactory::Create());
+
+    unsetenv("AETHERCAST_REPORT_TYPE");
+
+    return reports;
+}
+}
+
+TEST(ReportBenchmark, DefaultReportsStayCheap) {
+    // Like the service does when a sink connects so the timeline is
+    // stamping the first frames.
+    const auto timeline = ac::report::timeline::ConnectionTimeline::Instance();
+    ASSERT_NE(nullptr, timeline);
+    timeline->Start();
+
+    auto factory = ac::report::ReportFactory::Create();
+    // The flight recorder and the connection timeline are fed together
+    ASSERT_NE(nullptr, std::dynamic_pointer_cast<ac::report::CompositeReportFactory>(factory));
+
+    Reports reports(factory);
+
+    const auto baseline = RunFrames(nullptr);
+    const auto default_cost = RunFrames(&reports);
+
+    AC_INFO("Cost per frame: baseline %.1f ns, default reports %.1f ns", baseline, default_cost);
+
+    EXPECT_LT(default_cost - baseline, kMaxDefaultCostPerFrameNs);
+}
+
+TEST(ReportBenchmark, NullReportsCostNothingPerFrame) {
+    // What the service uses with AETHERCAST_FLIGHT_RECORDER_EVENTS=0,
+    // AETHERCAST_CONNECTION_TIMELINE=0 and no report type configured.
+    // Both are only read once per process so we can't go through
+    // ReportFactory::Create() next to the default reports here.
+    Reports reports(std::make_shared<ac::report::NullReportFactory>());
+
+    const auto baseline = RunFrames(nullptr);
+    const auto null_reports = RunFrames(&reports);
+
+    AC_INFO("Cost per frame: baseline %.1f ns, null reports %.1f ns", baseline, null_reports);
+
+    EXPECT_LT(null_reports - baseline, kMaxNullCostPerFrameNs);
+}
+
+TEST(ReportBenchmark, ConfiguredTypesAddToDefaultReports) {
+    auto default_reports = ServiceReports(nullptr);
+    auto metrics = ServiceReports("metrics");
+    auto metrics_and_latency = ServiceReports("metrics,latency");
+
+    const auto default_cost = RunFrames(&default_reports);
+    const auto metrics_cost = RunFrames(&metrics);
+    const auto metrics_and_latency_cost = RunFrames(&metrics_and_latency);
+
+    AC_INFO("Cost per frame: default %.1f ns, with metrics %.1f ns, with metrics and latency %.1f ns",
+            default_cost, metrics_cost, metrics_and_latency_cost);
+
+    // Every backend is called on top of the always-on ones
+    EXPECT_GT(metrics_cost, default_cost);
+    EXPECT_GT(metrics_and_latency_cost, metrics_cost);
+}
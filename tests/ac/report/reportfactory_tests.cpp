@@ -22,10 +22,21 @@
 #include "ac/report/reportfactory.h"
 #include "ac/report/null/nullreportfactory.h"
 #include "ac/report/logging/loggingreportfactory.h"
+#include "ac/report/logging/ratelimiter.h"
+#include "ac/report/latency/latencyreportfactory.h"
+#include "ac/report/metrics/metricsreportfactory.h"
+#include "ac/report/composite/compositereportfactory.h"
 
 using namespace ::testing;
 
 struct ReportFactoryFixture : public ::testing::Test {
+    static void SetUpTestCase() {
+        // Keep the always-on flight recorder and connection timeline
+        // out of the way so we only see the configured types.
+        setenv("AETHERCAST_FLIGHT_RECORDER_EVENTS", "0", 1);
+        setenv("AETHERCAST_CONNECTION_TIMELINE", "0", 1);
+    }
+
     template <typename T>
     void ExceptCorrectType(const std::string &type_name = "", bool set_env = true) {
         if (set_env)
@@ -39,9 +50,41 @@ TEST_F(ReportFactoryFixture, CreatesCorrectImplementations) {
     ExceptCorrectType<ac::report::NullReportFactory>();
     ExceptCorrectType<ac::report::NullReportFactory>("", false);
     ExceptCorrectType<ac::report::LoggingReportFactory>("log");
+    ExceptCorrectType<ac::report::LatencyReportFactory>("latency");
+    ExceptCorrectType<ac::report::MetricsReportFactory>("metrics");
 }
 
 TEST_F(ReportFactoryFixture, InvalidTypesGiveNull) {
     ExceptCorrectType<ac::report::NullReportFactory>("lalalal");
     ExceptCorrectType<ac::report::NullReportFactory>("12343asd123");
 }
+
+TEST_F(ReportFactoryFixture, CombinesMultipleTypes) {
+    setenv("AETHERCAST_REPORT_TYPE", "metrics,log", 1);
+
+    const auto factory = std::dynamic_pointer_cast<ac::report::CompositeReportFactory>(
+                ac::report::ReportFactory::Create());
+    ASSERT_NE(nullptr, factory);
+
+    const auto factories = factory->Factories();
+    ASSERT_EQ(2, factories.size());
+    EXPECT_NE(nullptr, std::dynamic_pointer_cast<ac::report::MetricsReportFactory>(factories[0]));
+    EXPECT_NE(nullptr, std::dynamic_pointer_cast<ac::report::LoggingReportFactory>(factories[1]));
+}
+
+TEST_F(ReportFactoryFixture, SingleValidTypeIsNotWrapped) {
+    ExceptCorrectType<ac::report::LoggingReportFactory>("log,log");
+    ExceptCorrectType<ac::report::LoggingReportFactory>("log,unknown");
+    ExceptCorrectType<ac::report::NullReportFactory>(",unknown,");
+}
+
+TEST_F(ReportFactoryFixture, LogRateIsConfigurable) {
+    setenv("AETHERCAST_REPORT_LOG_RATE", "0", 1);
+    EXPECT_EQ(0, ac::report::LoggingReportFactory().MessagesPerSecond());
+
+    setenv("AETHERCAST_REPORT_LOG_RATE", "invalid", 1);
+    EXPECT_EQ(ac::report::logging::RateLimiter::kDefaultMessagesPerSecond,
+              ac::report::LoggingReportFactory().MessagesPerSecond());
+
+    unsetenv("AETHERCAST_REPORT_LOG_RATE");
+}
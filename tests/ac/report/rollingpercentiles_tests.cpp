@@ -0,0 +1,62 @@
+/*
+ * Copyright (C) 2016 Canonical, Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 3, as published
+ * by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranties of
+ * MERCHANTABILITY, SATISFACTORY QUALITY, or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <gtest/gtest.h>
+
+#include "ac/report/latency/rollingpercentiles.h"
+
+using namespace ac::report::latency;
+
+TEST(RollingPercentiles, EmptyWindowGivesZero) {
+    RollingPercentiles percentiles(10);
+    EXPECT_EQ(0, percentiles.Size());
+    EXPECT_EQ(0, percentiles.Percentile(50));
+    EXPECT_EQ(0, percentiles.Max());
+}
+
+TEST(RollingPercentiles, CalculatesNearestRank) {
+    RollingPercentiles percentiles(100);
+    // Insert out of order to make sure we don't rely on it
+    for (int n = 100; n > 0; n--)
+        percentiles.Add(n);
+
+    EXPECT_EQ(100, percentiles.Size());
+    EXPECT_EQ(1, percentiles.Percentile(1));
+    EXPECT_EQ(50, percentiles.Percentile(50));
+    EXPECT_EQ(90, percentiles.Percentile(90));
+    EXPECT_EQ(99, percentiles.Percentile(99));
+    EXPECT_EQ(100, percentiles.Percentile(100));
+    EXPECT_EQ(100, percentiles.Max());
+}
+
+TEST(RollingPercentiles, OnlyKeepsMostRecentSamples) {
+    RollingPercentiles percentiles(4);
+
+    for (int n = 0; n < 4; n++)
+        percentiles.Add(1000);
+
+    // Overwrites all the old samples
+    for (int n = 0; n < 4; n++)
+        percentiles.Add(1);
+
+    EXPECT_EQ(4, percentiles.Size());
+    EXPECT_EQ(1, percentiles.Percentile(99));
+    EXPECT_EQ(1, percentiles.Max());
+
+    percentiles.Clear();
+    EXPECT_EQ(0, percentiles.Size());
+}
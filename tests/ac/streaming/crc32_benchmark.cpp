@@ -0,0 +1,63 @@
+/*
+ * Copyright (C) 2016 Canonical, Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 3, as published
+ * by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranties of
+ * MERCHANTABILITY, SATISFACTORY QUALITY, or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <gtest/gtest.h>
+
+#include <vector>
+
+#include "ac/logger.h"
+
+#include "ac/streaming/crc32.h"
+
+#include "tests/common/benchmark.h"
+
+namespace {
+// A PMT section fits into a single TS packet
+static constexpr std::size_t kSectionSize{188};
+static constexpr std::size_t kLargeSize{64 * 1024};
+// Even an unoptimized table driven CRC32 does more than 30 MB/s.
+// Sections are calculated for every PAT and PMT so they have to stay
+// cheap.
+static constexpr std::chrono::nanoseconds kSectionBudget{std::chrono::microseconds{10}};
+static constexpr std::chrono::nanoseconds kLargeBudget{std::chrono::milliseconds{2}};
+
+ac::testing::Benchmark::Result RunForSize(const std::string &name, std::size_t size,
+                                          const std::chrono::nanoseconds &budget) {
+    const ac::streaming::Crc32 crc;
+    const std::vector<std::uint8_t> data(size, 0xaa);
+
+    volatile std::uint32_t value = 0;
+
+    const auto result = ac::testing::run_operation(name, [&]() {
+        value = crc.Calculate(data.data(), data.size());
+    }, budget);
+
+    AC_INFO("CRC32 over %d bytes takes %.0f ns (%.0f MB/s)", size, result.timing.mean.count() * 1e9,
+            size / result.timing.mean.count() / (1024 * 1024));
+
+    EXPECT_NE(0, value);
+
+    return result;
+}
+}
+
+TEST(Crc32Benchmark, ScalesWithSize) {
+    const auto section = RunForSize("crc32-section", kSectionSize, kSectionBudget);
+    const auto large = RunForSize("crc32-64k", kLargeSize, kLargeBudget);
+
+    EXPECT_TRUE(section.timing.is_significantly_faster_than_reference(large.timing));
+}
@@ -0,0 +1,34 @@
+/*
+ * Copyright (C) 2016 Canonical, Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 3, as published
+ * by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranties of
+ * MERCHANTABILITY, SATISFACTORY QUALITY, or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <gtest/gtest.h>
+
+#include <cstring>
+
+#include "ac/streaming/crc32.h"
+
+TEST(Crc32, MatchesMPEG2CheckValue) {
+    static const char *kCheckInput{"123456789"};
+
+    const ac::streaming::Crc32 crc;
+    EXPECT_EQ(0x0376E6E7, crc.Calculate(reinterpret_cast<const std::uint8_t*>(kCheckInput), ::strlen(kCheckInput)));
+}
+
+TEST(Crc32, EmptyInputGivesInitialValue) {
+    const ac::streaming::Crc32 crc;
+    EXPECT_EQ(0xFFFFFFFF, crc.Calculate(nullptr, 0));
+}
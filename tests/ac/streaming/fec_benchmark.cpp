@@ -0,0 +1,105 @@
+/*
+ * Copyright (C) 2016 Canonical, Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 3, as published
+ * by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranties of
+ * MERCHANTABILITY, SATISFACTORY QUALITY, or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <gtest/gtest.h>
+
+#include <vector>
+
+#include "ac/logger.h"
+
+#include "ac/streaming/fecencoder.h"
+
+#include "tests/common/benchmark.h"
+
+namespace {
+static constexpr unsigned int kRTPHeaderSize{12};
+// Payload of a full datagram with seven TS packets
+static constexpr std::size_t kPayloadSize{7 * 188};
+// Datagrams of a 720p frame at 5 Mbit/s and 30 fps
+static constexpr unsigned int kPacketsPerFrame{16};
+// Parity is calculated for every datagram and even the bytewise XOR
+// has to keep up with a few hundred datagrams per frame.
+static constexpr std::chrono::nanoseconds kXorBudget{std::chrono::microseconds{50}};
+// A frame at 60 fps has 16.6ms and protecting it must only take a
+// small part of that.
+static constexpr std::chrono::nanoseconds kFrameBudget{std::chrono::microseconds{200}};
+
+// What we'd have without any vector instructions. The volatile
+// destination keeps the compiler from vectorizing it behind our back.
+void XorBytewise(volatile std::uint8_t *dst, const std::uint8_t *src, std::size_t size) {
+    for (std::size_t n = 0; n < size; n++)
+        dst[n] ^= src[n];
+}
+
+ac::testing::Benchmark::Result RunXor(const std::string &name,
+                                      const std::function<void(std::uint8_t*, const std::uint8_t*)> &kernel) {
+    std::vector<std::uint8_t> dst(kPayloadSize, 0x55);
+    const std::vector<std::uint8_t> src(kPayloadSize, 0xaa);
+
+    const auto result = ac::testing::run_operation(name, [&]() {
+        kernel(dst.data(), src.data());
+    }, kXorBudget);
+
+    AC_INFO("XOR over %d bytes with %s takes %.0f ns (%.0f MB/s)", kPayloadSize, name,
+            result.timing.mean.count() * 1e9,
+            kPayloadSize / result.timing.mean.count() / (1024 * 1024));
+
+    return result;
+}
+}
+
+TEST(FECBenchmark, VectorXorBeatsBytewiseXor) {
+    const auto vector = RunXor("fec-xor-vector", [](std::uint8_t *dst, const std::uint8_t *src) {
+        ac::streaming::FECXor(dst, src, kPayloadSize);
+    });
+    const auto bytewise = RunXor("fec-xor-bytewise", [](std::uint8_t *dst, const std::uint8_t *src) {
+        XorBytewise(dst, src, kPayloadSize);
+    });
+
+    EXPECT_TRUE(vector.timing.is_significantly_faster_than_reference(bytewise.timing));
+}
+
+TEST(FECBenchmark, ProtectFrame) {
+    ac::streaming::FECConfig fec_config;
+    fec_config.columns = 10;
+    fec_config.rows = 10;
+    fec_config.row_parity = true;
+
+    ac::streaming::FECEncoder encoder(fec_config, kPayloadSize);
+
+    std::vector<std::uint8_t> packet(kRTPHeaderSize + kPayloadSize, 0x47);
+    packet[0] = 0x80;
+    packet[1] = 33;
+
+    std::uint16_t sequence_number = 0;
+    std::vector<ac::video::Buffer::Ptr> parity;
+
+    const auto result = ac::testing::run_operation("fec-frame", [&]() {
+        for (unsigned int n = 0; n < kPacketsPerFrame; n++) {
+            packet[2] = sequence_number >> 8;
+            packet[3] = sequence_number & 0xff;
+            sequence_number++;
+
+            parity.clear();
+            encoder.Protect(packet.data(), packet.size(), parity);
+        }
+    }, kFrameBudget);
+
+    AC_INFO("Protecting a frame of %d datagrams with %dx%d FEC takes %.1f us",
+            kPacketsPerFrame, fec_config.columns, fec_config.rows,
+            result.timing.mean.count() * 1e6);
+}
@@ -0,0 +1,241 @@
+/*
+ * Copyright (C) 2016 Canonical, Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 3, as published
+ * by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranties of
+ * MERCHANTABILITY, SATISFACTORY QUALITY, or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <gtest/gtest.h>
+
+#include <cstring>
+#include <set>
+#include <vector>
+
+#include "ac/network/stream.h"
+
+#include "ac/report/null/senderreport.h"
+
+#include "ac/streaming/fecdecoder.h"
+#include "ac/streaming/fecencoder.h"
+#include "ac/streaming/rtpsender.h"
+#include "ac/streaming/streamanalyzer.h"
+
+namespace {
+static constexpr unsigned int kRTPHeaderSize{12};
+static constexpr unsigned int kMPEGTSPacketSize{188};
+static constexpr unsigned int kStreamMaxUnitSize{1472};
+static constexpr unsigned int kMaxPayloadSize{7 * kMPEGTSPacketSize};
+
+typedef std::vector<std::uint8_t> Packet;
+
+Packet CreatePacket(std::uint16_t sequence_number) {
+    // Payloads of differing length check that the length is recovered
+    Packet packet(kRTPHeaderSize + (1 + sequence_number % 7) * kMPEGTSPacketSize);
+
+    packet[0] = 0x80;
+    packet[1] = 33;
+    packet[2] = sequence_number >> 8;
+    packet[3] = sequence_number & 0xff;
+    packet[4] = 0x12;
+    packet[7] = sequence_number & 0xff;
+    packet[8] = 0xde;
+    packet[9] = 0xad;
+    packet[10] = 0xbe;
+    packet[11] = 0xef;
+
+    for (unsigned int n = kRTPHeaderSize; n < packet.size(); n++)
+        packet[n] = (sequence_number * 31 + n) & 0xff;
+
+    return packet;
+}
+
+ac::streaming::FECConfig CreateConfig(unsigned int columns, unsigned int rows, bool row_parity) {
+    ac::streaming::FECConfig config;
+    config.columns = columns;
+    config.rows = rows;
+    config.row_parity = row_parity;
+    return config;
+}
+
+// Sends the given number of packets through encoder and decoder while
+// dropping the media packets at the given positions and returns what
+// comes out of the decoder.
+std::vector<Packet> Transmit(const ac::streaming::FECConfig &config, std::uint16_t first,
+                             unsigned int count, const std::set<unsigned int> &dropped,
+                             ac::streaming::FECDecoder::Statistics *stats) {
+    ac::streaming::FECEncoder encoder(config, kMaxPayloadSize);
+
+    std::vector<Packet> received;
+    ac::streaming::FECDecoder decoder([&](const std::uint8_t *data, std::size_t size) {
+        received.push_back(Packet(data, data + size));
+    });
+
+    std::vector<ac::video::Buffer::Ptr> parity;
+
+    for (unsigned int n = 0; n < count; n++) {
+        const auto packet = CreatePacket(first + n);
+
+        parity.clear();
+        encoder.Protect(packet.data(), packet.size(), parity);
+
+        if (dropped.find(n) == dropped.end())
+            decoder.ProcessMediaPacket(packet.data(), packet.size());
+
+        for (const auto &p : parity)
+            decoder.ProcessFECPacket(p->Data(), p->Length());
+    }
+
+    decoder.Flush();
+
+    *stats = decoder.Stats();
+
+    return received;
+}
+
+std::vector<Packet> Expected(std::uint16_t first, unsigned int count) {
+    std::vector<Packet> packets;
+    for (unsigned int n = 0; n < count; n++)
+        packets.push_back(CreatePacket(first + n));
+    return packets;
+}
+
+class CapturingStream : public ac::network::Stream {
+public:
+    bool Connect(const std::string&, const ac::network::Port&) override { return true; }
+
+    Error Write(const uint8_t *data, unsigned int size, const ac::TimestampUs&) override {
+        packets.push_back(Packet(data, data + size));
+        return Error::kNone;
+    }
+
+    ac::network::Port LocalPort() const override { return 0; }
+    std::uint32_t MaxUnitSize() const override { return kStreamMaxUnitSize; }
+
+    std::vector<Packet> packets;
+};
+}
+
+TEST(FECDecoder, PassesPacketsThroughWithoutLoss) {
+    ac::streaming::FECDecoder::Statistics stats;
+    const auto received = Transmit(CreateConfig(5, 4, false), 0, 60, {}, &stats);
+
+    EXPECT_EQ(Expected(0, 60), received);
+    EXPECT_EQ(60, stats.media_packets);
+    EXPECT_EQ(15, stats.fec_packets);
+    EXPECT_EQ(0, stats.recovered_packets);
+    EXPECT_EQ(0, stats.lost_packets);
+}
+
+TEST(FECDecoder, RecoversBurstWithColumnParity) {
+    ac::streaming::FECDecoder::Statistics stats;
+    // A burst as long as a row hits every column only once
+    const auto received = Transmit(CreateConfig(10, 5, false), 0, 150,
+                                   {53, 54, 55, 56, 57, 58, 59, 60, 61, 62}, &stats);
+
+    EXPECT_EQ(Expected(0, 150), received);
+    EXPECT_EQ(10, stats.recovered_packets);
+    EXPECT_EQ(0, stats.lost_packets);
+}
+
+TEST(FECDecoder, RecoversLastPacketOfStream) {
+    ac::streaming::FECDecoder::Statistics stats;
+    const auto received = Transmit(CreateConfig(4, 4, false), 0, 16, {15}, &stats);
+
+    EXPECT_EQ(Expected(0, 16), received);
+    EXPECT_EQ(1, stats.recovered_packets);
+}
+
+TEST(FECDecoder, CombinesRowAndColumnParity) {
+    ac::streaming::FECDecoder::Statistics stats;
+    // Neither the first row nor the first column of the second matrix
+    // can be recovered on their own but with the other rows they can.
+    const auto received = Transmit(CreateConfig(4, 4, true), 0, 32, {16, 17, 20, 24}, &stats);
+
+    EXPECT_EQ(Expected(0, 32), received);
+    EXPECT_EQ(4, stats.recovered_packets);
+    EXPECT_EQ(0, stats.lost_packets);
+}
+
+TEST(FECDecoder, ReportsUnrecoverableLoss) {
+    ac::streaming::FECDecoder::Statistics stats;
+    const auto received = Transmit(CreateConfig(4, 4, false), 0, 32, {1, 5}, &stats);
+
+    auto expected = Expected(0, 32);
+    expected.erase(expected.begin() + 5);
+    expected.erase(expected.begin() + 1);
+
+    EXPECT_EQ(expected, received);
+    EXPECT_EQ(0, stats.recovered_packets);
+    EXPECT_EQ(2, stats.lost_packets);
+}
+
+TEST(FECDecoder, HandlesSequenceNumberWrapAround) {
+    ac::streaming::FECDecoder::Statistics stats;
+    const auto received = Transmit(CreateConfig(4, 4, false), 65530, 32, {5, 6, 7, 8}, &stats);
+
+    EXPECT_EQ(Expected(65530, 32), received);
+    EXPECT_EQ(4, stats.recovered_packets);
+}
+
+TEST(FECDecoder, RepairsStreamFromRTPSender) {
+    const auto stream = std::make_shared<CapturingStream>();
+    const auto fec_stream = std::make_shared<CapturingStream>();
+
+    auto sender = std::make_shared<ac::streaming::RTPSender>(
+                stream, std::make_shared<ac::report::null::SenderReport>());
+    EXPECT_TRUE(sender->EnableFEC(fec_stream, CreateConfig(5, 5, false)));
+
+    // A single TS packet per datagram is enough to get sequence numbers
+    // checked by the analyzer.
+    for (int n = 0; n < 100; n++) {
+        auto packet = ac::video::Buffer::Create(kMPEGTSPacketSize);
+        ::memset(packet->Data(), 0xff, kMPEGTSPacketSize);
+        packet->Data()[0] = 0x47;
+        packet->Data()[1] = 0x1f;
+        packet->Data()[2] = 0xff;
+        packet->Data()[3] = 0x10;
+        EXPECT_TRUE(sender->Queue(packet));
+    }
+    EXPECT_TRUE(sender->Execute());
+
+    EXPECT_EQ(100, stream->packets.size());
+    EXPECT_EQ(20, fec_stream->packets.size());
+
+    ac::streaming::StreamAnalyzer analyzer;
+    ac::streaming::FECDecoder decoder([&](const std::uint8_t *data, std::size_t size) {
+        analyzer.ProcessRTPPacket(data, size, ac::Utils::GetNowUs());
+    });
+
+    // Parity packets arrive after the last media packet of their column
+    auto parity = fec_stream->packets.begin();
+    for (unsigned int n = 0; n < stream->packets.size(); n++) {
+        const auto &packet = stream->packets[n];
+        if (n >= 25 && n % 25 < 5)
+            continue;
+
+        decoder.ProcessMediaPacket(packet.data(), packet.size());
+
+        if (n % 25 >= 20 && parity != fec_stream->packets.end()) {
+            decoder.ProcessFECPacket(parity->data(), parity->size());
+            ++parity;
+        }
+    }
+    decoder.Flush();
+
+    EXPECT_EQ(15, decoder.Stats().recovered_packets);
+
+    const auto result = analyzer.Statistics();
+    EXPECT_EQ(100, result.rtp_packets);
+    EXPECT_EQ(0, result.rtp_lost_packets);
+    EXPECT_EQ(0, result.rtp_reordered_packets);
+}
@@ -0,0 +1,203 @@
+/*
+ * Copyright (C) 2016 Canonical, Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 3, as published
+ * by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranties of
+ * MERCHANTABILITY, SATISFACTORY QUALITY, or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <gtest/gtest.h>
+
+#include <vector>
+
+#include "ac/streaming/fecencoder.h"
+
+namespace {
+static constexpr unsigned int kRTPHeaderSize{12};
+static constexpr unsigned int kMPEGTSPacketSize{188};
+static constexpr unsigned int kMaxPayloadSize{7 * kMPEGTSPacketSize};
+
+std::vector<std::uint8_t> CreatePacket(std::uint16_t sequence_number, unsigned int ts_packets) {
+    std::vector<std::uint8_t> packet(kRTPHeaderSize + ts_packets * kMPEGTSPacketSize);
+
+    packet[0] = 0x80;
+    packet[1] = 33;
+    packet[2] = sequence_number >> 8;
+    packet[3] = sequence_number & 0xff;
+    packet[7] = sequence_number & 0xff;
+
+    for (unsigned int n = kRTPHeaderSize; n < packet.size(); n++)
+        packet[n] = (sequence_number * 31 + n) & 0xff;
+
+    return packet;
+}
+
+ac::streaming::FECConfig CreateConfig(unsigned int columns, unsigned int rows, bool row_parity) {
+    ac::streaming::FECConfig config;
+    config.columns = columns;
+    config.rows = rows;
+    config.row_parity = row_parity;
+    return config;
+}
+
+ac::streaming::FECHeader ReadHeader(const ac::video::Buffer::Ptr &parity) {
+    ac::streaming::FECHeader header;
+    EXPECT_TRUE(header.Read(parity->Data() + kRTPHeaderSize, parity->Length() - kRTPHeaderSize));
+    return header;
+}
+}
+
+TEST(FECConfig, FollowsMatrixLimits) {
+    EXPECT_FALSE(ac::streaming::FECConfig().IsValid());
+    EXPECT_TRUE(CreateConfig(1, 4, false).IsValid());
+    EXPECT_TRUE(CreateConfig(10, 10, true).IsValid());
+    EXPECT_TRUE(CreateConfig(20, 5, false).IsValid());
+
+    EXPECT_FALSE(CreateConfig(21, 4, false).IsValid());
+    EXPECT_FALSE(CreateConfig(4, 3, false).IsValid());
+    EXPECT_FALSE(CreateConfig(4, 21, false).IsValid());
+    EXPECT_FALSE(CreateConfig(20, 20, false).IsValid());
+    EXPECT_FALSE(CreateConfig(2, 10, true).IsValid());
+}
+
+TEST(FECConfig, CalculatesOverhead) {
+    EXPECT_DOUBLE_EQ(0.0, ac::streaming::FECConfig().Overhead());
+    EXPECT_DOUBLE_EQ(0.2, CreateConfig(10, 5, false).Overhead());
+    EXPECT_DOUBLE_EQ(0.3, CreateConfig(10, 5, true).Overhead());
+}
+
+TEST(FECHeader, SurvivesRoundTrip) {
+    ac::streaming::FECHeader header;
+    header.sn_base = 0xfffe;
+    header.length_recovery = 0x1234;
+    header.pt_recovery = 33;
+    header.ts_recovery = 0xdeadbeef;
+    header.row = true;
+    header.offset = 1;
+    header.count = 10;
+
+    std::uint8_t data[ac::streaming::FECHeader::kSize];
+    header.Write(data);
+
+    ac::streaming::FECHeader read;
+    EXPECT_TRUE(read.Read(data, sizeof(data)));
+    EXPECT_EQ(header.sn_base, read.sn_base);
+    EXPECT_EQ(header.length_recovery, read.length_recovery);
+    EXPECT_EQ(header.pt_recovery, read.pt_recovery);
+    EXPECT_EQ(header.ts_recovery, read.ts_recovery);
+    EXPECT_EQ(header.row, read.row);
+    EXPECT_EQ(header.offset, read.offset);
+    EXPECT_EQ(header.count, read.count);
+
+    EXPECT_FALSE(read.Read(data, sizeof(data) - 1));
+}
+
+TEST(FECXor, MatchesBytewiseXorForAllSizes) {
+    for (std::size_t size = 0; size < 200; size++) {
+        std::vector<std::uint8_t> src(size), dst(size), expected(size);
+        for (std::size_t n = 0; n < size; n++) {
+            src[n] = n * 7;
+            dst[n] = n * 13 + 1;
+            expected[n] = src[n] ^ dst[n];
+        }
+
+        // Unaligned buffers must work as well
+        ac::streaming::FECXor(dst.data(), src.data(), size);
+        EXPECT_EQ(expected, dst);
+    }
+}
+
+TEST(FECEncoder, EmitsColumnParityWithLastRow) {
+    ac::streaming::FECEncoder encoder(CreateConfig(4, 4, false), kMaxPayloadSize);
+
+    std::vector<ac::video::Buffer::Ptr> parity;
+    std::vector<std::uint8_t> expected(kMaxPayloadSize, 0);
+    std::uint16_t expected_length = 0;
+
+    for (std::uint16_t n = 0; n < 16; n++) {
+        // Packets of differing length are padded with zeros
+        const auto packet = CreatePacket(100 + n, 1 + n % 7);
+        if (n % 4 == 1) {
+            for (std::size_t m = kRTPHeaderSize; m < packet.size(); m++)
+                expected[m - kRTPHeaderSize] ^= packet[m];
+            expected_length ^= packet.size() - kRTPHeaderSize;
+        }
+
+        encoder.Protect(packet.data(), packet.size(), parity);
+
+        EXPECT_EQ(n < 12 ? 0u : n - 11u, parity.size());
+    }
+
+    ASSERT_EQ(4, parity.size());
+
+    for (unsigned int column = 0; column < 4; column++) {
+        const auto header = ReadHeader(parity[column]);
+        EXPECT_EQ(100 + column, header.sn_base);
+        EXPECT_FALSE(header.row);
+        EXPECT_EQ(4, header.offset);
+        EXPECT_EQ(4, header.count);
+        EXPECT_EQ(96, parity[column]->Data()[1]);
+        EXPECT_EQ(column, parity[column]->Data()[3]);
+    }
+
+    const auto header = ReadHeader(parity[1]);
+    EXPECT_EQ(expected_length, header.length_recovery);
+    EXPECT_EQ(33 ^ 33 ^ 33 ^ 33, header.pt_recovery);
+
+    const auto payload = parity[1]->Data() + kRTPHeaderSize + ac::streaming::FECHeader::kSize;
+    const auto payload_size = parity[1]->Length() - kRTPHeaderSize - ac::streaming::FECHeader::kSize;
+    EXPECT_EQ(std::vector<std::uint8_t>(expected.begin(), expected.begin() + payload_size),
+              std::vector<std::uint8_t>(payload, payload + payload_size));
+}
+
+TEST(FECEncoder, EmitsRowParityWhenRequested) {
+    ac::streaming::FECEncoder encoder(CreateConfig(4, 4, true), kMaxPayloadSize);
+
+    std::vector<ac::video::Buffer::Ptr> parity;
+    for (std::uint16_t n = 0; n < 4; n++) {
+        const auto packet = CreatePacket(n, 7);
+        encoder.Protect(packet.data(), packet.size(), parity);
+    }
+
+    ASSERT_EQ(1, parity.size());
+
+    const auto header = ReadHeader(parity[0]);
+    EXPECT_TRUE(header.row);
+    EXPECT_EQ(0, header.sn_base);
+    EXPECT_EQ(1, header.offset);
+    EXPECT_EQ(4, header.count);
+}
+
+TEST(FECEncoder, StartsNewMatrixAfterGap) {
+    ac::streaming::FECEncoder encoder(CreateConfig(1, 4, false), kMaxPayloadSize);
+
+    std::vector<ac::video::Buffer::Ptr> parity;
+    for (std::uint16_t n : {0, 1, 2, 10, 11, 12, 13}) {
+        const auto packet = CreatePacket(n, 7);
+        encoder.Protect(packet.data(), packet.size(), parity);
+    }
+
+    ASSERT_EQ(1, parity.size());
+    EXPECT_EQ(10, ReadHeader(parity[0]).sn_base);
+}
+
+TEST(FECEncoder, IgnoresPacketsItCannotProtect) {
+    ac::streaming::FECEncoder encoder(CreateConfig(1, 4, false), kMPEGTSPacketSize);
+
+    std::vector<ac::video::Buffer::Ptr> parity;
+    for (std::uint16_t n = 0; n < 4; n++) {
+        const auto packet = CreatePacket(n, 2);
+        encoder.Protect(packet.data(), packet.size(), parity);
+    }
+
+    EXPECT_EQ(0, parity.size());
+}
@@ -17,11 +17,20 @@
 
 #include <gmock/gmock.h>
 
+#include <cstring>
+
+#include "ac/report/null/packetizerreport.h"
+
 #include "ac/streaming/mediasender.h"
+#include "ac/streaming/mpegtspacketizer.h"
+#include "ac/streaming/streamanalyzer.h"
 
 using namespace ::testing;
 
 namespace {
+static constexpr unsigned int kMPEGTSPacketSize{188};
+static constexpr unsigned int kFrameSize{4000};
+
 class MockTransportSender : public ac::streaming::TransportSender {
 public:
     MOCK_METHOD1(Queue, bool(const ac::video::Buffer::Ptr&));
@@ -167,7 +176,6 @@ TEST(MediaSender, RequestsPCRandPATandPMTEvery100ms) {
     auto dummy_packetizer = std::make_shared<MockPacketizer>();
     auto dummy_transport = std::make_shared<MockTransportSender>();
 
-    auto buffer = ac::video::Buffer::Create(1);
     auto packets = ac::video::Buffer::Create(10);
 
     auto expected_flags = ac::streaming::Packetizer::kEmitPATandPMT |
@@ -177,11 +185,11 @@ TEST(MediaSender, RequestsPCRandPATandPMTEvery100ms) {
             .Times(1)
             .WillRepeatedly(Return(1));
 
-    EXPECT_CALL(*dummy_packetizer, Packetize(1, buffer, NotNull(), expected_flags))
+    EXPECT_CALL(*dummy_packetizer, Packetize(1, _, NotNull(), expected_flags))
             .Times(2)
             .WillRepeatedly(DoAll(SetArgPointee<2>(packets), Return(true)));
 
-    EXPECT_CALL(*dummy_packetizer, Packetize(1, buffer, NotNull(), 0))
+    EXPECT_CALL(*dummy_packetizer, Packetize(1, _, NotNull(), 0))
             .Times(2)
             .WillRepeatedly(DoAll(SetArgPointee<2>(packets), Return(true)));
 
@@ -194,31 +202,68 @@ TEST(MediaSender, RequestsPCRandPATandPMTEvery100ms) {
 
     // As this is the first buffer the sender will ask packetizer to include
     // PCR / PAT and PMT
-    sender->OnBufferAvailable(buffer);
-
-    std::this_thread::sleep_for(std::chrono::milliseconds{5});
+    sender->OnBufferAvailable(ac::video::Buffer::Create(1, 1000000));
     EXPECT_TRUE(sender->Execute());
 
     // Second one shouldn't include PCR / PAT and PMT
-    sender->OnBufferAvailable(buffer);
-
-    std::this_thread::sleep_for(std::chrono::milliseconds{5});
+    sender->OnBufferAvailable(ac::video::Buffer::Create(1, 1005000));
     EXPECT_TRUE(sender->Execute());
 
     // As 100ms later this will include both PCR / PAT and PMT
-    sender->OnBufferAvailable(buffer);
-
-    // PCR / PAT and PMT will be included every 100ms so wait a bit until the sender
-    // will do that.
-    std::this_thread::sleep_for(std::chrono::milliseconds{100});
+    sender->OnBufferAvailable(ac::video::Buffer::Create(1, 1100000));
     EXPECT_TRUE(sender->Execute());
 
     // As this buffer is send directly after the previous one which include
     // both PCR / PAT and PMT this wont get them attached.
-    sender->OnBufferAvailable(buffer);
-
-    std::this_thread::sleep_for(std::chrono::milliseconds{5});
+    sender->OnBufferAvailable(ac::video::Buffer::Create(1, 1105000));
     EXPECT_TRUE(sender->Execute());
 
     EXPECT_TRUE(sender->Stop());
 }
+
+TEST(MediaSender, TablesArriveWithinTheRequiredInterval) {
+    auto encoder_config = ac::video::BaseEncoder::Config{};
+    encoder_config.framerate = 30;
+
+    const ac::TimestampUs frame_interval = 1000000 / encoder_config.framerate;
+
+    auto packetizer = ac::streaming::MPEGTSPacketizer::Create(
+                std::make_shared<ac::report::null::PacketizerReport>());
+    auto transport = std::make_shared<MockTransportSender>();
+
+    ac::streaming::StreamAnalyzer analyzer;
+
+    // Every frame arrives at the sink at the time it was captured
+    EXPECT_CALL(*transport, Queue(_))
+            .WillRepeatedly(Invoke([&](const ac::video::Buffer::Ptr &packets) {
+                for (uint32_t offset = 0; offset < packets->Length(); offset += kMPEGTSPacketSize)
+                    analyzer.ProcessTSPacket(packets->Data() + offset, packets->Timestamp());
+                return true;
+            }));
+
+    auto sender = std::make_shared<ac::streaming::MediaSender>(packetizer, transport, encoder_config);
+
+    EXPECT_TRUE(sender->Start());
+
+    for (int n = 1; n <= 60; n++) {
+        auto buffer = ac::video::Buffer::Create(kFrameSize, n * frame_interval);
+        uint8_t *data = buffer->Data();
+        ::memset(data, 0x01, kFrameSize);
+        data[0] = 0x00; data[1] = 0x00; data[2] = 0x00; data[3] = 0x01;
+        data[4] = 0x41;
+
+        sender->OnBufferAvailable(buffer);
+        EXPECT_TRUE(sender->Execute());
+    }
+
+    EXPECT_TRUE(sender->Stop());
+
+    const auto result = analyzer.Statistics();
+    EXPECT_LT(1u, result.pat_count);
+    EXPECT_LT(1u, result.pcr_count);
+    EXPECT_EQ(0u, result.ts_continuity_errors);
+    EXPECT_EQ(0u, result.psi_crc_errors);
+    EXPECT_GE(ac::streaming::StreamAnalyzer::kMaxTableInterval, result.max_pat_interval);
+    EXPECT_GE(ac::streaming::StreamAnalyzer::kMaxTableInterval, result.max_pmt_interval);
+    EXPECT_GE(ac::streaming::StreamAnalyzer::kMaxTableInterval, result.max_pcr_interval);
+}
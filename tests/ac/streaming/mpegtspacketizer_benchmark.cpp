@@ -0,0 +1,85 @@
+/*
+ * Copyright (C) 2016 Canonical, Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 3, as published
+ * by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranties of
+ * MERCHANTABILITY, SATISFACTORY QUALITY, or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <gtest/gtest.h>
+
+#include <cstring>
+
+#include "ac/logger.h"
+
+#include "ac/report/null/packetizerreport.h"
+
+#include "ac/streaming/mpegtspacketizer.h"
+
+#include "tests/common/benchmark.h"
+
+namespace {
+static const uint8_t kCSD[] = {
+    0x00, 0x00, 0x00, 0x01, 0x67, 0x42, 0x00, 0x0a, 0xf8, 0x41, 0xa2,
+    0x00, 0x00, 0x00, 0x01, 0x68, 0xce, 0x38, 0x80
+};
+static const uint8_t kSliceHeader[] = { 0x00, 0x00, 0x00, 0x01, 0x41, 0x9a, 0x02, 0x0c };
+// A P frame at 720p and 5 Mbit/s
+static constexpr unsigned int kFrameSize{20 * 1024};
+// A frame at 60 fps has 16.6ms and packetizing it must only take a
+// small part of that.
+static constexpr std::chrono::nanoseconds kFrameBudget{std::chrono::microseconds{200}};
+
+class PacketizerBenchmark {
+public:
+    PacketizerBenchmark() :
+        packetizer(ac::streaming::MPEGTSPacketizer::Create(std::make_shared<ac::report::null::PacketizerReport>())),
+        track(packetizer->AddTrack(ac::streaming::MPEGTSPacketizer::TrackFormat{"video/avc"})),
+        frame(ac::video::Buffer::Create(kFrameSize)) {
+
+        auto csd = ac::video::Buffer::Create(sizeof(kCSD));
+        ::memcpy(csd->Data(), kCSD, sizeof(kCSD));
+        packetizer->SubmitCSD(track, csd);
+
+        ::memset(frame->Data(), 0xaa, kFrameSize);
+        ::memcpy(frame->Data(), kSliceHeader, sizeof(kSliceHeader));
+        frame->SetTimestamp(1);
+    }
+
+    ac::testing::Benchmark::Result Run(const std::string &name, int flags) {
+        return ac::testing::run_operation(name, [&]() {
+            ac::video::Buffer::Ptr packets;
+            packetizer->Packetize(track, frame, &packets, flags);
+        }, kFrameBudget);
+    }
+
+    ac::streaming::Packetizer::Ptr packetizer;
+    ac::streaming::Packetizer::TrackId track;
+    ac::video::Buffer::Ptr frame;
+};
+}
+
+TEST(MPEGTSPacketizerBenchmark, PacketizeFrame) {
+    PacketizerBenchmark benchmark;
+    const auto result = benchmark.Run("mpegtspacketizer-frame", 0);
+
+    AC_INFO("Packetizing a %d byte frame takes %.1f us", kFrameSize, result.timing.mean.count() * 1e6);
+}
+
+TEST(MPEGTSPacketizerBenchmark, PacketizeFrameWithProgramTables) {
+    PacketizerBenchmark benchmark;
+    const auto result = benchmark.Run("mpegtspacketizer-frame-with-tables",
+        ac::streaming::Packetizer::kEmitPATandPMT | ac::streaming::Packetizer::kEmitPCR);
+
+    AC_INFO("Packetizing a %d byte frame with PAT, PMT and PCR takes %.1f us",
+            kFrameSize, result.timing.mean.count() * 1e6);
+}
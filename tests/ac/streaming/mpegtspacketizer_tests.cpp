@@ -105,7 +105,7 @@ private:
 
 class MockPacketizerReport : public ac::video::PacketizerReport {
 public:
-    MOCK_METHOD1(PacketizedFrame, void(const ac::TimestampUs&));
+    MOCK_METHOD2(PacketizedFrame, void(const ac::video::FrameNumber&, const ac::TimestampUs&));
 };
 
 }
@@ -146,14 +146,17 @@ TEST(MPEGTSPacketizer, SubmitAndProcessCodecSpecificData) {
     auto buffer = ac::video::Buffer::Create(sizeof(csd0));
     ::memcpy(buffer->Data(), csd0, sizeof(csd0));
     buffer->SetTimestamp(now);
+    buffer->SetFrameNumber(3);
 
-    EXPECT_CALL(*report, PacketizedFrame(buffer->Timestamp()))
+    EXPECT_CALL(*report, PacketizedFrame(3, buffer->Timestamp()))
             .Times(1);
 
     ac::video::Buffer::Ptr out;
 
     packetizer->Packetize(id, buffer, &out);
 
+    EXPECT_EQ(3, out->FrameNumber());
+
     MPEGTSPacketMatcher matcher(out);
 
     matcher.ExpectPackets(1);
@@ -174,7 +177,7 @@ TEST(MPEGTSPacketizer, EmitPCRandPATandPMT) {
     ac::video::Buffer::Ptr out;
     auto buffer = CreateFrame(100);
 
-    EXPECT_CALL(*report, PacketizedFrame(buffer->Timestamp()))
+    EXPECT_CALL(*report, PacketizedFrame(_, buffer->Timestamp()))
             .Times(1);
 
     packetizer->Packetize(id, buffer, &out, ac::streaming::Packetizer::kEmitPCR |
@@ -216,7 +219,7 @@ TEST(MPEGTSPacketizer, IncreasingContinuityCounter) {
     auto packetizer = ac::streaming::MPEGTSPacketizer::Create(report);
     auto id = packetizer->AddTrack(ac::streaming::MPEGTSPacketizer::TrackFormat{"video/avc"});
 
-    EXPECT_CALL(*report, PacketizedFrame(_))
+    EXPECT_CALL(*report, PacketizedFrame(_, _))
             .Times(20);
 
     // Make sure we looper over 15 here as that is used for the continuity counter
@@ -0,0 +1,286 @@
+/*
+ * Copyright (C) 2016 Canonical, Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 3, as published
+ * by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranties of
+ * MERCHANTABILITY, SATISFACTORY QUALITY, or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <gmock/gmock.h>
+
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <cstring>
+#include <set>
+#include <vector>
+
+#include "ac/network/udpstream.h"
+
+#include "ac/report/null/senderreport.h"
+
+#include "ac/streaming/rtcpreceiver.h"
+#include "ac/streaming/rtpsender.h"
+
+using namespace ::testing;
+
+namespace {
+static constexpr unsigned int kMPEGTSPacketSize{188};
+static constexpr int kReceiveTimeoutMs{100};
+// Another address on the loopback interface, 127.0.0.2
+static constexpr std::uint32_t kForeignHost{0x7f000002};
+
+class MockDelegate : public ac::streaming::RTCPReceiver::Delegate {
+public:
+    MOCK_METHOD1(OnPacketsLost, void(const std::vector<std::uint16_t>&));
+};
+
+// Generic NACK as defined by RFC 4585 with a single PID/BLP pair
+std::vector<std::uint8_t> CreateNACK(std::uint16_t pid, std::uint16_t blp) {
+    return {
+        0x81, 205, 0x00, 0x03,
+        0x00, 0x00, 0x00, 0x01,
+        0xde, 0xad, 0xbe, 0xef,
+        static_cast<std::uint8_t>(pid >> 8), static_cast<std::uint8_t>(pid & 0xff),
+        static_cast<std::uint8_t>(blp >> 8), static_cast<std::uint8_t>(blp & 0xff),
+    };
+}
+
+// Receiver report without any report blocks
+std::vector<std::uint8_t> CreateReceiverReport() {
+    return { 0x80, 201, 0x00, 0x01, 0x00, 0x00, 0x00, 0x01 };
+}
+
+int OpenSocket(std::uint16_t port, std::uint32_t address = INADDR_LOOPBACK) {
+    const auto fd = ::socket(AF_INET, SOCK_DGRAM, 0);
+
+    struct sockaddr_in addr;
+    ::memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(address);
+    addr.sin_port = htons(port);
+    ::bind(fd, reinterpret_cast<struct sockaddr*>(&addr), sizeof(addr));
+
+    return fd;
+}
+
+std::uint16_t LocalPort(int fd) {
+    struct sockaddr_in addr;
+    socklen_t length = sizeof(addr);
+    ::getsockname(fd, reinterpret_cast<struct sockaddr*>(&addr), &length);
+    return ntohs(addr.sin_port);
+}
+
+std::uint16_t FindFreePort() {
+    const auto fd = OpenSocket(0);
+    const auto port = LocalPort(fd);
+    ::close(fd);
+    return port;
+}
+
+void SendTo(int fd, std::uint16_t port, const std::vector<std::uint8_t> &data) {
+    struct sockaddr_in addr;
+    ::memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    addr.sin_port = htons(port);
+    ::sendto(fd, data.data(), data.size(), 0, reinterpret_cast<struct sockaddr*>(&addr), sizeof(addr));
+}
+
+// Returns the sequence numbers of all RTP packets arriving until
+// nothing came in for a while.
+std::vector<std::uint16_t> ReceiveAll(int fd) {
+    std::vector<std::uint16_t> sequence_numbers;
+    std::uint8_t datagram[2048];
+
+    struct pollfd pfd;
+    pfd.fd = fd;
+    pfd.events = POLLIN;
+
+    while (::poll(&pfd, 1, kReceiveTimeoutMs) > 0) {
+        if (::recv(fd, datagram, sizeof(datagram), 0) >= 4)
+            sequence_numbers.push_back((datagram[2] << 8) | datagram[3]);
+    }
+
+    return sequence_numbers;
+}
+}
+
+TEST(RTCPReceiver, ReportsNACKedPackets) {
+    auto delegate = std::make_shared<MockDelegate>();
+
+    ac::streaming::RTCPReceiver receiver;
+    receiver.SetDelegate(delegate);
+
+    EXPECT_CALL(*delegate, OnPacketsLost(std::vector<std::uint16_t>{100, 101, 103, 116}));
+
+    const auto nack = CreateNACK(100, 0x8005);
+    EXPECT_TRUE(receiver.Process(nack.data(), nack.size()));
+}
+
+TEST(RTCPReceiver, WrapsAroundSequenceNumbers) {
+    auto delegate = std::make_shared<MockDelegate>();
+
+    ac::streaming::RTCPReceiver receiver;
+    receiver.SetDelegate(delegate);
+
+    EXPECT_CALL(*delegate, OnPacketsLost(std::vector<std::uint16_t>{65535, 0}));
+
+    const auto nack = CreateNACK(65535, 0x0001);
+    EXPECT_TRUE(receiver.Process(nack.data(), nack.size()));
+}
+
+TEST(RTCPReceiver, FindsNACKInCompoundPacket) {
+    auto delegate = std::make_shared<MockDelegate>();
+
+    ac::streaming::RTCPReceiver receiver;
+    receiver.SetDelegate(delegate);
+
+    EXPECT_CALL(*delegate, OnPacketsLost(std::vector<std::uint16_t>{7}));
+
+    auto packet = CreateReceiverReport();
+    const auto nack = CreateNACK(7, 0);
+    packet.insert(packet.end(), nack.begin(), nack.end());
+
+    EXPECT_TRUE(receiver.Process(packet.data(), packet.size()));
+}
+
+TEST(RTCPReceiver, IgnoresOtherFeedback) {
+    auto delegate = std::make_shared<MockDelegate>();
+
+    ac::streaming::RTCPReceiver receiver;
+    receiver.SetDelegate(delegate);
+
+    EXPECT_CALL(*delegate, OnPacketsLost(_))
+            .Times(0);
+
+    const auto report = CreateReceiverReport();
+    EXPECT_TRUE(receiver.Process(report.data(), report.size()));
+
+    // Same layout but a different feedback message type
+    auto nack = CreateNACK(7, 0);
+    nack[0] = 0x83;
+    EXPECT_TRUE(receiver.Process(nack.data(), nack.size()));
+}
+
+TEST(RTCPReceiver, IgnoresNACKForOtherMediaSource) {
+    auto delegate = std::make_shared<MockDelegate>();
+
+    ac::streaming::RTCPReceiver receiver;
+    receiver.SetDelegate(delegate);
+
+    EXPECT_CALL(*delegate, OnPacketsLost(_))
+            .Times(0);
+
+    auto nack = CreateNACK(7, 0);
+    nack[11] = 0xee;
+    EXPECT_TRUE(receiver.Process(nack.data(), nack.size()));
+}
+
+TEST(RTCPReceiver, RejectsMalformedPackets) {
+    auto delegate = std::make_shared<MockDelegate>();
+
+    ac::streaming::RTCPReceiver receiver;
+    receiver.SetDelegate(delegate);
+
+    EXPECT_CALL(*delegate, OnPacketsLost(_))
+            .Times(0);
+
+    auto nack = CreateNACK(7, 0);
+    nack[0] = 0x41;
+    EXPECT_FALSE(receiver.Process(nack.data(), nack.size()));
+
+    nack = CreateNACK(7, 0);
+    EXPECT_FALSE(receiver.Process(nack.data(), nack.size() - 4));
+}
+
+TEST(RTCPReceiver, SenderResendsPacketsDroppedByLoopbackSink) {
+    const int sink = OpenSocket(0);
+    const int sink_rtcp = OpenSocket(0);
+
+    auto stream = std::make_shared<ac::network::UdpStream>();
+    ASSERT_TRUE(stream->Connect("127.0.0.1", LocalPort(sink)));
+
+    auto sender = std::make_shared<ac::streaming::RTPSender>(
+                stream, std::make_shared<ac::report::null::SenderReport>());
+
+    const auto rtcp_port = FindFreePort();
+    auto receiver = std::make_shared<ac::streaming::RTCPReceiver>();
+    ASSERT_TRUE(receiver->Bind(rtcp_port, "127.0.0.1"));
+    receiver->SetDelegate(sender);
+
+    EXPECT_TRUE(receiver->Start());
+    EXPECT_TRUE(sender->Start());
+
+    // One TS packet per datagram gives us one sequence number per packet
+    for (int n = 0; n < 20; n++) {
+        auto packet = ac::video::Buffer::Create(kMPEGTSPacketSize);
+        ::memset(packet->Data(), 0, kMPEGTSPacketSize);
+        EXPECT_TRUE(sender->Queue(packet));
+    }
+    EXPECT_TRUE(sender->Execute());
+
+    // The sink drops some of what it receives on purpose and asks for
+    // the dropped packets again.
+    const std::set<std::uint16_t> dropped{3, 4, 9};
+    std::vector<std::uint16_t> kept;
+    for (const auto sequence_number : ReceiveAll(sink)) {
+        if (dropped.find(sequence_number) == dropped.end())
+            kept.push_back(sequence_number);
+    }
+    EXPECT_EQ(17, kept.size());
+
+    SendTo(sink_rtcp, rtcp_port, CreateNACK(3, 0x0021));
+
+    EXPECT_TRUE(receiver->Execute());
+    EXPECT_TRUE(sender->Execute());
+
+    EXPECT_EQ(std::vector<std::uint16_t>({3, 4, 9}), ReceiveAll(sink));
+
+    const auto stats = sender->Retransmissions();
+    EXPECT_EQ(3, stats.requested);
+    EXPECT_EQ(3, stats.sent);
+    EXPECT_EQ(0, stats.dropped);
+
+    ::close(sink);
+    ::close(sink_rtcp);
+}
+
+TEST(RTCPReceiver, IgnoresPacketsFromOtherHosts) {
+    auto delegate = std::make_shared<MockDelegate>();
+    const int sink = OpenSocket(0);
+    const int foreign = OpenSocket(0, kForeignHost);
+
+    const auto rtcp_port = FindFreePort();
+    auto receiver = std::make_shared<ac::streaming::RTCPReceiver>();
+    ASSERT_TRUE(receiver->Bind(rtcp_port, "127.0.0.1"));
+    receiver->SetDelegate(delegate);
+
+    EXPECT_CALL(*delegate, OnPacketsLost(std::vector<std::uint16_t>{7}))
+            .Times(1);
+
+    SendTo(foreign, rtcp_port, CreateNACK(5, 0));
+    EXPECT_TRUE(receiver->Execute());
+
+    SendTo(sink, rtcp_port, CreateNACK(7, 0));
+    EXPECT_TRUE(receiver->Execute());
+
+    ::close(sink);
+    ::close(foreign);
+}
+
+TEST(RTCPReceiver, BindFailsForInvalidSinkAddress) {
+    ac::streaming::RTCPReceiver receiver;
+    EXPECT_FALSE(receiver.Bind(FindFreePort(), "not-an-address"));
+}
@@ -0,0 +1,61 @@
+/*
+ * Copyright (C) 2016 Canonical, Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 3, as published
+ * by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranties of
+ * MERCHANTABILITY, SATISFACTORY QUALITY, or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <gtest/gtest.h>
+
+#include "ac/logger.h"
+
+#include "ac/network/stream.h"
+
+#include "ac/report/null/senderreport.h"
+
+#include "ac/streaming/rtpsender.h"
+
+#include "tests/common/benchmark.h"
+
+namespace {
+static constexpr unsigned int kStreamMaxUnitSize{1472};
+static constexpr unsigned int kMPEGTSPacketSize{188};
+// Eight datagrams with seven TS packets each
+static constexpr unsigned int kTSPacketsPerFrame{56};
+// A frame at 60 fps has 16.6ms and sending it must only take a small
+// part of that.
+static constexpr std::chrono::nanoseconds kFrameBudget{std::chrono::microseconds{200}};
+
+class NullStream : public ac::network::Stream {
+public:
+    bool Connect(const std::string&, const ac::network::Port&) override { return true; }
+    Error Write(const uint8_t*, unsigned int, const ac::TimestampUs&) override { return Error::kNone; }
+    ac::network::Port LocalPort() const override { return 0; }
+    std::uint32_t MaxUnitSize() const override { return kStreamMaxUnitSize; }
+};
+}
+
+TEST(RTPSenderBenchmark, QueueAndSendFrame) {
+    const auto sender = std::make_shared<ac::streaming::RTPSender>(
+                std::make_shared<NullStream>(), std::make_shared<ac::report::null::SenderReport>());
+
+    const auto frame = ac::video::Buffer::Create(kTSPacketsPerFrame * kMPEGTSPacketSize);
+
+    const auto result = ac::testing::run_operation("rtpsender-frame", [&]() {
+        sender->Queue(frame);
+        sender->Execute();
+    }, kFrameBudget);
+
+    AC_INFO("Sending a frame of %d TS packets takes %.1f us",
+            kTSPacketsPerFrame, result.timing.mean.count() * 1e6);
+}
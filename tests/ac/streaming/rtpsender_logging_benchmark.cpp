@@ -0,0 +1,107 @@
+/*
+ * Copyright (C) 2016 Canonical, Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 3, as published
+ * by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranties of
+ * MERCHANTABILITY, SATISFACTORY QUALITY, or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <iostream>
+#include <ostream>
+
+#include "ac/asynclogger.h"
+#include "ac/logger.h"
+
+#include "ac/network/stream.h"
+
+#include "ac/report/logging/senderreport.h"
+
+#include "ac/streaming/rtpsender.h"
+
+namespace {
+static constexpr unsigned int kStreamMaxUnitSize{1472};
+static constexpr unsigned int kMPEGTSPacketSize{188};
+// Seven TS packets fit into one RTP packet
+static constexpr unsigned int kTSPacketsPerFrame{7 * 8};
+static constexpr unsigned int kNumFrames{5000};
+
+class NullStream : public ac::network::Stream {
+public:
+    bool Connect(const std::string&, const ac::network::Port&) override { return true; }
+    Error Write(const uint8_t*, unsigned int, const ac::TimestampUs&) override { return Error::kNone; }
+    ac::network::Port LocalPort() const override { return 0; }
+    std::uint32_t MaxUnitSize() const override { return kStreamMaxUnitSize; }
+};
+
+class NullBuffer : public std::streambuf {
+protected:
+    int overflow(int c) override { return c; }
+    std::streamsize xsputn(const char*, std::streamsize n) override { return n; }
+};
+
+// Sends frames through the RTP sender with every packet being logged
+// and returns the time needed per packet in nano-seconds.
+double RunPackets() {
+    // Not limiting the report makes every packet hit the logger
+    auto sender = std::make_shared<ac::streaming::RTPSender>(
+                std::make_shared<NullStream>(),
+                std::make_shared<ac::report::logging::SenderReport>(0));
+
+    const auto frame = ac::video::Buffer::Create(kTSPacketsPerFrame * kMPEGTSPacketSize);
+
+    unsigned int num_packets = 0;
+    std::chrono::nanoseconds elapsed{0};
+
+    for (unsigned int n = 0; n < kNumFrames; n++) {
+        frame->SetFrameNumber(n + 1);
+        sender->Queue(frame);
+
+        const auto start = std::chrono::steady_clock::now();
+        sender->Execute();
+        elapsed += std::chrono::steady_clock::now() - start;
+
+        num_packets += kTSPacketsPerFrame / 7;
+    }
+
+    return std::chrono::duration<double, std::nano>(elapsed).count() / num_packets;
+}
+}
+
+TEST(RTPSenderLoggingBenchmark, AsyncLoggerKeepsLoggingOffTheSenderThread) {
+    NullBuffer null_buffer;
+    std::ostream null_stream(&null_buffer);
+
+    const auto cout_buffer = std::cout.rdbuf(&null_buffer);
+    ac::Log().Init();
+    const auto boost_cost = RunPackets();
+    std::cout.rdbuf(cout_buffer);
+
+    auto async_logger = std::make_shared<ac::AsyncLogger>(null_stream, ac::Logger::Severity::kTrace);
+    ac::SetLogger(async_logger);
+    const auto async_cost = RunPackets();
+
+    async_logger->Init(ac::Logger::Severity::kInfo);
+    const auto disabled_cost = RunPackets();
+
+    // The null stream goes away with this test
+    ac::SetLogger(std::make_shared<ac::AsyncLogger>());
+    async_logger.reset();
+
+    AC_INFO("Logging cost per RTP packet: boost %.0f ns, async %.0f ns, async disabled %.0f ns",
+            boost_cost, async_cost, disabled_cost);
+
+    EXPECT_LT(async_cost, boost_cost);
+    EXPECT_LT(disabled_cost, async_cost);
+}
@@ -17,6 +17,9 @@
 
 #include <gmock/gmock.h>
 
+#include <chrono>
+#include <thread>
+
 #include <boost/concept_check.hpp>
 
 #include "ac/network/stream.h"
@@ -43,7 +46,8 @@ public:
 
 class MockSenderReport : public ac::video::SenderReport {
 public:
-    MOCK_METHOD2(SentPacket, void(const ac::TimestampUs&, const size_t&));
+    MOCK_METHOD3(SentPacket, void(const ac::video::FrameNumber&, const ac::TimestampUs&, const size_t&));
+    MOCK_METHOD2(FailedToSendPacket, void(const ac::video::FrameNumber&, const ac::TimestampUs&));
 };
 }
 
@@ -122,8 +126,10 @@ TEST(RTPSender, QueuesUpPackagesAndSendsAll) {
     auto mock_report = std::make_shared<MockSenderReport>();
 
     auto now = ac::Utils::GetNowUs();
+    ac::video::FrameNumber frame = 42;
 
-    EXPECT_CALL(*mock_report, SentPacket(now, _))
+    // All datagrams of a frame need to be reported with its number
+    EXPECT_CALL(*mock_report, SentPacket(frame, now, _))
             .Times(3);
 
     EXPECT_CALL(*mock_stream, MaxUnitSize())
@@ -137,6 +143,7 @@ TEST(RTPSender, QueuesUpPackagesAndSendsAll) {
 
     auto packets = ac::video::Buffer::Create(kMPEGTSPacketSize * 15);
     packets->SetTimestamp(now);
+    packets->SetFrameNumber(frame);
 
     EXPECT_TRUE(sender->Queue(packets));
     EXPECT_TRUE(sender->Execute());
@@ -153,6 +160,11 @@ TEST(RTPSender, WritePackageFails) {
             .Times(1)
             .WillOnce(Return(ac::network::Stream::Error::kRemoteClosedConnection));
 
+    EXPECT_CALL(*mock_report, FailedToSendPacket(_, _))
+            .Times(1);
+    EXPECT_CALL(*mock_report, SentPacket(_, _, _))
+            .Times(0);
+
     auto sender = std::make_shared<ac::streaming::RTPSender>(mock_stream, mock_report);
 
     auto packets = ac::video::Buffer::Create(kMPEGTSPacketSize);
@@ -169,7 +181,7 @@ TEST(RTPSender, ConstructsCorrectRTPHeader) {
 
     uint32_t expected_output_size = kMPEGTSPacketSize + kRTPHeaderSize;
 
-    EXPECT_CALL(*mock_report, SentPacket(packet_timestamp, expected_output_size))
+    EXPECT_CALL(*mock_report, SentPacket(_, packet_timestamp, expected_output_size))
             .Times(1);
 
     EXPECT_CALL(*mock_stream, MaxUnitSize())
@@ -230,3 +242,112 @@ TEST(RTPSender, ConstructsCorrectRTPHeader) {
     if (output_data)
         delete output_data;
 }
+
+TEST(RTPSender, RejectsInvalidFECConfiguration) {
+    auto mock_stream = std::make_shared<MockNetworkStream>();
+    auto mock_fec_stream = std::make_shared<MockNetworkStream>();
+    auto mock_report = std::make_shared<MockSenderReport>();
+
+    EXPECT_CALL(*mock_stream, MaxUnitSize())
+            .WillRepeatedly(Return(kStreamMaxUnitSize));
+
+    auto sender = std::make_shared<ac::streaming::RTPSender>(mock_stream, mock_report);
+
+    ac::streaming::FECConfig config;
+    EXPECT_FALSE(sender->EnableFEC(mock_fec_stream, config));
+
+    config.columns = 5;
+    config.rows = 5;
+    EXPECT_FALSE(sender->EnableFEC(nullptr, config));
+
+    // Parity packets need room for the FEC header
+    EXPECT_CALL(*mock_fec_stream, MaxUnitSize())
+            .WillOnce(Return(kRTPHeaderSize + 7 * kMPEGTSPacketSize))
+            .WillOnce(Return(kStreamMaxUnitSize));
+
+    EXPECT_FALSE(sender->EnableFEC(mock_fec_stream, config));
+    EXPECT_TRUE(sender->EnableFEC(mock_fec_stream, config));
+}
+
+TEST(RTPSender, ResendsRequestedPacketsFromHistory) {
+    auto mock_stream = std::make_shared<MockNetworkStream>();
+    auto mock_report = std::make_shared<NiceMock<MockSenderReport>>();
+
+    EXPECT_CALL(*mock_stream, MaxUnitSize())
+            .WillRepeatedly(Return(kStreamMaxUnitSize));
+
+    std::vector<std::uint16_t> written;
+    EXPECT_CALL(*mock_stream, Write(_, _, _))
+            .WillRepeatedly(DoAll(Invoke([&](const uint8_t *data, unsigned int, const ac::TimestampUs&) {
+                                      written.push_back((data[2] << 8) | data[3]);
+                                  }),
+                                  Return(ac::network::Stream::Error::kNone)));
+
+    auto sender = std::make_shared<ac::streaming::RTPSender>(mock_stream, mock_report);
+
+    for (int n = 0; n < 3; n++)
+        EXPECT_TRUE(sender->Queue(ac::video::Buffer::Create(kMPEGTSPacketSize)));
+    EXPECT_TRUE(sender->Execute());
+
+    written.clear();
+
+    // Packets we never sent can't be resent
+    sender->OnPacketsLost({1, 2, 7});
+    EXPECT_TRUE(sender->Execute());
+
+    EXPECT_EQ(std::vector<std::uint16_t>({1, 2}), written);
+
+    const auto stats = sender->Retransmissions();
+    EXPECT_EQ(3, stats.requested);
+    EXPECT_EQ(2, stats.sent);
+    EXPECT_EQ(1, stats.dropped);
+}
+
+TEST(RTPSender, DropsRequestsForOverwrittenPackets) {
+    auto mock_stream = std::make_shared<MockNetworkStream>();
+    auto mock_report = std::make_shared<NiceMock<MockSenderReport>>();
+
+    EXPECT_CALL(*mock_stream, MaxUnitSize())
+            .WillRepeatedly(Return(kStreamMaxUnitSize));
+
+    EXPECT_CALL(*mock_stream, Write(_, _, _))
+            .Times(ac::streaming::RTPSender::kRetransmissionHistorySize + 1)
+            .WillRepeatedly(Return(ac::network::Stream::Error::kNone));
+
+    auto sender = std::make_shared<ac::streaming::RTPSender>(mock_stream, mock_report);
+
+    // The last packet takes the slot of the first one
+    for (unsigned int n = 0; n <= ac::streaming::RTPSender::kRetransmissionHistorySize; n++)
+        EXPECT_TRUE(sender->Queue(ac::video::Buffer::Create(kMPEGTSPacketSize)));
+    EXPECT_TRUE(sender->Execute());
+
+    sender->OnPacketsLost({0});
+    EXPECT_TRUE(sender->Execute());
+
+    EXPECT_EQ(1, sender->Retransmissions().dropped);
+}
+
+TEST(RTPSender, DropsRequestsTooOldToHelp) {
+    auto mock_stream = std::make_shared<MockNetworkStream>();
+    auto mock_report = std::make_shared<NiceMock<MockSenderReport>>();
+
+    EXPECT_CALL(*mock_stream, MaxUnitSize())
+            .WillRepeatedly(Return(kStreamMaxUnitSize));
+
+    EXPECT_CALL(*mock_stream, Write(_, _, _))
+            .Times(1)
+            .WillRepeatedly(Return(ac::network::Stream::Error::kNone));
+
+    auto sender = std::make_shared<ac::streaming::RTPSender>(mock_stream, mock_report);
+
+    EXPECT_TRUE(sender->Queue(ac::video::Buffer::Create(kMPEGTSPacketSize)));
+    EXPECT_TRUE(sender->Execute());
+
+    std::this_thread::sleep_for(std::chrono::microseconds{
+                                    ac::streaming::RTPSender::kMaxRetransmissionAge + 10000});
+
+    sender->OnPacketsLost({0});
+    EXPECT_TRUE(sender->Execute());
+
+    EXPECT_EQ(1, sender->Retransmissions().dropped);
+}
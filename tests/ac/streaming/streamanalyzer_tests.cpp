@@ -0,0 +1,253 @@
+/*
+ * Copyright (C) 2016 Canonical, Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 3, as published
+ * by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranties of
+ * MERCHANTABILITY, SATISFACTORY QUALITY, or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <gmock/gmock.h>
+
+#include <cstring>
+#include <vector>
+
+#include "ac/report/null/packetizerreport.h"
+
+#include "ac/streaming/mpegtspacketizer.h"
+#include "ac/streaming/streamanalyzer.h"
+
+using namespace ::testing;
+
+namespace {
+static constexpr unsigned int kMPEGTSPacketSize{188};
+static constexpr unsigned int kRTPHeaderSize{12};
+static constexpr unsigned int kTSPacketsPerDatagram{7};
+static constexpr unsigned int kFrameSize{4000};
+static constexpr ac::TimestampUs kFrameInterval{33333};
+static constexpr unsigned int kPIDofPAT{0x0000};
+
+typedef std::vector<uint8_t> Packet;
+
+class StreamGenerator {
+public:
+    StreamGenerator() :
+        packetizer_(ac::streaming::MPEGTSPacketizer::Create(
+                        std::make_shared<ac::report::null::PacketizerReport>())),
+        track_(packetizer_->AddTrack(ac::streaming::MPEGTSPacketizer::TrackFormat{"video/avc"})),
+        frame_(0) {
+    }
+
+    // Produces the transport stream packets for a single frame with
+    // PAT, PMT and PCR in front of it.
+    std::vector<Packet> NextFrame(std::vector<uint8_t> *content = nullptr) {
+        auto buffer = ac::video::Buffer::Create(kFrameSize, ++frame_ * kFrameInterval);
+        uint8_t *data = buffer->Data();
+        data[0] = 0x00; data[1] = 0x00; data[2] = 0x00; data[3] = 0x01;
+        data[4] = 0x41;
+        for (unsigned int n = 5; n < kFrameSize; n++)
+            data[n] = (n + frame_) % 255 + 1;
+
+        if (content)
+            content->insert(content->end(), data, data + kFrameSize);
+
+        ac::video::Buffer::Ptr output;
+        packetizer_->Packetize(track_, buffer, &output,
+                               ac::streaming::Packetizer::kEmitPATandPMT |
+                               ac::streaming::Packetizer::kEmitPCR);
+
+        std::vector<Packet> packets;
+        for (uint32_t offset = 0; offset < output->Length(); offset += kMPEGTSPacketSize)
+            packets.push_back(Packet(output->Data() + offset, output->Data() + offset + kMPEGTSPacketSize));
+
+        return packets;
+    }
+
+private:
+    ac::streaming::Packetizer::Ptr packetizer_;
+    ac::streaming::Packetizer::TrackId track_;
+    uint64_t frame_;
+};
+
+std::vector<Packet> CreateDatagrams(const std::vector<Packet> &ts_packets, uint16_t *sequence_number,
+                                    const ac::TimestampUs &timestamp) {
+    std::vector<Packet> datagrams;
+
+    const uint32_t rtp_time = (timestamp * 9) / 100;
+
+    for (size_t n = 0; n < ts_packets.size(); n += kTSPacketsPerDatagram) {
+        Packet datagram(kRTPHeaderSize, 0);
+        datagram[0] = 0x80;
+        datagram[1] = 33;
+        datagram[2] = *sequence_number >> 8;
+        datagram[3] = *sequence_number & 0xff;
+        datagram[4] = rtp_time >> 24;
+        datagram[5] = (rtp_time >> 16) & 0xff;
+        datagram[6] = (rtp_time >> 8) & 0xff;
+        datagram[7] = rtp_time & 0xff;
+
+        (*sequence_number)++;
+
+        for (size_t i = n; i < ts_packets.size() && i < n + kTSPacketsPerDatagram; i++)
+            datagram.insert(datagram.end(), ts_packets[i].begin(), ts_packets[i].end());
+
+        datagrams.push_back(datagram);
+    }
+
+    return datagrams;
+}
+
+unsigned int PID(const Packet &packet) {
+    return ((packet[1] & 0x1f) << 8) | packet[2];
+}
+}
+
+TEST(StreamAnalyzer, ValidStreamHasNoErrors) {
+    StreamGenerator generator;
+    ac::streaming::StreamAnalyzer analyzer;
+
+    std::vector<uint8_t> sent, received;
+    analyzer.SetElementaryStreamCallback([&](const uint8_t *data, size_t size) {
+        received.insert(received.end(), data, data + size);
+    });
+
+    uint16_t sequence_number = 0;
+    ac::TimestampUs now = 1000000;
+
+    for (int n = 0; n < 10; n++) {
+        for (const auto &datagram : CreateDatagrams(generator.NextFrame(&sent), &sequence_number, now))
+            analyzer.ProcessRTPPacket(datagram.data(), datagram.size(), now);
+        now += kFrameInterval;
+    }
+
+    const auto result = analyzer.Statistics();
+
+    EXPECT_EQ(0u, result.rtp_lost_packets);
+    EXPECT_EQ(0u, result.rtp_reordered_packets);
+    EXPECT_EQ(0u, result.rtp_invalid_packets);
+    EXPECT_EQ(0u, result.ts_sync_errors);
+    EXPECT_EQ(0u, result.ts_continuity_errors);
+    EXPECT_EQ(0u, result.psi_crc_errors);
+    EXPECT_EQ(10u, result.pat_count);
+    EXPECT_EQ(10u, result.pmt_count);
+    EXPECT_EQ(10u, result.pcr_count);
+    EXPECT_EQ(kFrameInterval, result.max_pat_interval);
+    EXPECT_EQ(kFrameInterval, result.max_pmt_interval);
+    EXPECT_EQ(10u, result.pes_packets);
+    EXPECT_EQ(sent.size(), result.es_bytes);
+    EXPECT_EQ(sent, received);
+}
+
+TEST(StreamAnalyzer, CountsLostAndReorderedDatagrams) {
+    StreamGenerator generator;
+    ac::streaming::StreamAnalyzer analyzer;
+
+    uint16_t sequence_number = 0xfffe;
+    auto datagrams = CreateDatagrams(generator.NextFrame(), &sequence_number, 0);
+    for (const auto &datagram : CreateDatagrams(generator.NextFrame(), &sequence_number, 0))
+        datagrams.push_back(datagram);
+    ASSERT_GE(datagrams.size(), 5u);
+
+    analyzer.ProcessRTPPacket(datagrams[0].data(), datagrams[0].size(), 0);
+    // Crosses the wrap around of the sequence number and looses two
+    analyzer.ProcessRTPPacket(datagrams[3].data(), datagrams[3].size(), 0);
+    analyzer.ProcessRTPPacket(datagrams[2].data(), datagrams[2].size(), 0);
+    analyzer.ProcessRTPPacket(datagrams[4].data(), datagrams[4].size(), 0);
+
+    const auto result = analyzer.Statistics();
+    EXPECT_EQ(4u, result.rtp_packets);
+    EXPECT_EQ(2u, result.rtp_lost_packets);
+    EXPECT_EQ(1u, result.rtp_reordered_packets);
+}
+
+TEST(StreamAnalyzer, DetectsContinuityErrors) {
+    StreamGenerator generator;
+    ac::streaming::StreamAnalyzer analyzer;
+
+    auto packets = generator.NextFrame();
+    ASSERT_GE(packets.size(), 6u);
+
+    // Drop one packet of the video stream in the middle of the frame
+    packets.erase(packets.begin() + 5);
+
+    for (const auto &packet : packets)
+        analyzer.ProcessTSPacket(packet.data(), 0);
+
+    EXPECT_EQ(1u, analyzer.Statistics().ts_continuity_errors);
+}
+
+TEST(StreamAnalyzer, AcceptsDuplicatePackets) {
+    StreamGenerator generator;
+    ac::streaming::StreamAnalyzer analyzer;
+
+    auto packets = generator.NextFrame();
+    packets.insert(packets.begin() + 5, packets[5]);
+
+    for (const auto &packet : packets)
+        analyzer.ProcessTSPacket(packet.data(), 0);
+
+    EXPECT_EQ(0u, analyzer.Statistics().ts_continuity_errors);
+}
+
+TEST(StreamAnalyzer, DetectsSyncByteErrors) {
+    StreamGenerator generator;
+    ac::streaming::StreamAnalyzer analyzer;
+
+    auto packets = generator.NextFrame();
+    packets[4][0] = 0x00;
+
+    for (const auto &packet : packets)
+        analyzer.ProcessTSPacket(packet.data(), 0);
+
+    const auto result = analyzer.Statistics();
+    EXPECT_EQ(packets.size(), result.ts_packets);
+    EXPECT_EQ(1u, result.ts_sync_errors);
+}
+
+TEST(StreamAnalyzer, DetectsCorruptedTables) {
+    StreamGenerator generator;
+    ac::streaming::StreamAnalyzer analyzer;
+
+    auto packets = generator.NextFrame();
+    ASSERT_EQ(kPIDofPAT, PID(packets[0]));
+
+    // Flip a bit of the transport_stream_id
+    packets[0][9] ^= 0x01;
+
+    for (const auto &packet : packets)
+        analyzer.ProcessTSPacket(packet.data(), 0);
+
+    const auto result = analyzer.Statistics();
+    EXPECT_EQ(1u, result.psi_crc_errors);
+    EXPECT_EQ(0u, result.pat_count);
+    // Without a PAT we don't know where to look for the PMT
+    EXPECT_EQ(0u, result.pmt_count);
+}
+
+TEST(StreamAnalyzer, MeasuresTableIntervals) {
+    StreamGenerator generator;
+    ac::streaming::StreamAnalyzer analyzer;
+
+    const ac::TimestampUs interval = 2 * ac::streaming::StreamAnalyzer::kMaxTableInterval;
+    ac::TimestampUs now = 1000000;
+
+    for (int n = 0; n < 3; n++) {
+        for (const auto &packet : generator.NextFrame())
+            analyzer.ProcessTSPacket(packet.data(), now);
+        now += interval;
+    }
+
+    const auto result = analyzer.Statistics();
+    EXPECT_EQ(interval, result.max_pat_interval);
+    EXPECT_EQ(interval, result.max_pmt_interval);
+    EXPECT_EQ(interval, result.max_pcr_interval);
+    EXPECT_EQ(3u, result.pcr_count);
+}
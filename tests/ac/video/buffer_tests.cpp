@@ -104,3 +104,11 @@ TEST(Buffer, RangeSelection) {
     buffer->SetRange(-1, -1);
     EXPECT_EQ(test_data[1], buffer->Data()[0]);
 }
+
+TEST(Buffer, CarriesFrameNumber) {
+    auto buffer = Buffer::Create(10);
+    EXPECT_EQ(0, buffer->FrameNumber());
+
+    buffer->SetFrameNumber(42);
+    EXPECT_EQ(42, buffer->FrameNumber());
+}
@@ -0,0 +1,61 @@
+/*
+ * Copyright (C) 2016 Canonical, Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 3, as published
+ * by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranties of
+ * MERCHANTABILITY, SATISFACTORY QUALITY, or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <gtest/gtest.h>
+
+#include "ac/logger.h"
+
+#include "ac/video/bufferqueue.h"
+
+#include "tests/common/benchmark.h"
+
+namespace {
+// What the RTP sender gets from the packetizer for one 720p frame
+static constexpr unsigned int kBuffersPerBatch{8};
+// Both run for every packet of a frame so they have to stay within a
+// few micro-seconds even when the lock is contended sometimes.
+static constexpr std::chrono::nanoseconds kPushAndPopBudget{std::chrono::microseconds{5}};
+static constexpr std::chrono::nanoseconds kBatchBudget{kBuffersPerBatch * kPushAndPopBudget};
+}
+
+TEST(BufferQueueBenchmark, PushAndPop) {
+    const auto queue = ac::video::BufferQueue::Create();
+    const auto buffer = ac::video::Buffer::Create(1);
+
+    const auto result = ac::testing::run_operation("bufferqueue-push-pop", [&]() {
+        queue->Push(buffer);
+        queue->Pop();
+    }, kPushAndPopBudget);
+
+    AC_INFO("Push and pop of one buffer takes %.0f ns", result.timing.mean.count() * 1e9);
+}
+
+TEST(BufferQueueBenchmark, BatchUnderOneLock) {
+    const auto queue = ac::video::BufferQueue::Create();
+    const auto buffer = ac::video::Buffer::Create(1);
+
+    const auto result = ac::testing::run_operation("bufferqueue-batch", [&]() {
+        queue->Lock();
+        for (unsigned int n = 0; n < kBuffersPerBatch; n++)
+            queue->PushUnlocked(buffer);
+        while (queue->PopUnlocked()) { }
+        queue->Unlock();
+    }, kBatchBudget);
+
+    AC_INFO("Push and pop of %d buffers under one lock takes %.0f ns",
+            kBuffersPerBatch, result.timing.mean.count() * 1e9);
+}
@@ -0,0 +1,108 @@
+/*
+ * Copyright (C) 2016 Canonical, Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 3, as published
+ * by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranties of
+ * MERCHANTABILITY, SATISFACTORY QUALITY, or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <gtest/gtest.h>
+
+#include <limits>
+#include <thread>
+
+#include "ac/utils.h"
+
+#include "ac/video/framepacer.h"
+
+using namespace ac::video;
+
+namespace {
+static constexpr ac::TimestampUs kInterval{10000};
+}
+
+TEST(FramePacer, WaitsForAbsoluteDeadline) {
+    FramePacer pacer(kInterval);
+
+    const ac::TimestampUs start = ac::Utils::GetNowUs();
+    pacer.FrameProduced(start);
+
+    std::this_thread::sleep_for(std::chrono::milliseconds{4});
+
+    EXPECT_EQ(0, pacer.WaitForNextFrame());
+    EXPECT_EQ(start + kInterval, pacer.NextDeadline());
+    EXPECT_LE(start + kInterval, ac::Utils::GetNowUs());
+}
+
+TEST(FramePacer, DoesNotDrift) {
+    FramePacer pacer(kInterval);
+
+    const ac::TimestampUs start = ac::Utils::GetNowUs();
+    pacer.FrameProduced(start);
+
+    for (int n = 0; n < 20; n++) {
+        std::this_thread::sleep_for(std::chrono::milliseconds{2});
+        EXPECT_EQ(0, pacer.WaitForNextFrame());
+    }
+
+    EXPECT_EQ(start + 20 * kInterval, pacer.NextDeadline());
+    EXPECT_NEAR(start + 20 * kInterval, ac::Utils::GetNowUs(), kInterval / 2);
+}
+
+TEST(FramePacer, SkipsFramesWhenBehind) {
+    FramePacer pacer(kInterval);
+
+    const ac::TimestampUs start = ac::Utils::GetNowUs();
+    pacer.FrameProduced(start);
+
+    std::this_thread::sleep_for(std::chrono::microseconds{3 * kInterval + kInterval / 2});
+
+    EXPECT_EQ(2, pacer.WaitForNextFrame());
+    EXPECT_EQ(2, pacer.SkippedFrames());
+    EXPECT_EQ(start + 3 * kInterval, pacer.NextDeadline());
+
+    // We're still on the original schedule
+    EXPECT_EQ(0, pacer.WaitForNextFrame());
+    EXPECT_EQ(start + 4 * kInterval, pacer.NextDeadline());
+}
+
+TEST(FramePacer, RecordsLateness) {
+    FramePacer pacer(kInterval);
+
+    EXPECT_EQ(0, pacer.FrameProduced(1000000));
+    EXPECT_EQ(500, pacer.FrameProduced(1000000 + 500));
+    EXPECT_EQ(1500, pacer.FrameProduced(1000000 + 1500));
+    EXPECT_EQ(3000000, pacer.FrameProduced(1000000 + 3000000));
+
+    const auto lateness = pacer.Lateness();
+    EXPECT_EQ(2, lateness[0]);
+    EXPECT_EQ(1, lateness[1]);
+    EXPECT_EQ(1, lateness[FramePacer::kNumLatenessBuckets - 1]);
+
+    pacer.Reset();
+
+    for (const auto &bucket : pacer.Lateness())
+        EXPECT_EQ(0, bucket);
+}
+
+TEST(FramePacer, LatenessBucketLimits) {
+    EXPECT_EQ(1000, FramePacer::LatenessBucketLimit(0));
+    EXPECT_EQ(2000, FramePacer::LatenessBucketLimit(1));
+    EXPECT_EQ(4000, FramePacer::LatenessBucketLimit(2));
+    EXPECT_EQ(std::numeric_limits<ac::TimestampUs>::max(),
+              FramePacer::LatenessBucketLimit(FramePacer::kNumLatenessBuckets - 1));
+}
+
+TEST(FramePacer, DoesNotWaitWithoutInterval) {
+    FramePacer pacer(0);
+    EXPECT_EQ(0, pacer.WaitForNextFrame());
+}
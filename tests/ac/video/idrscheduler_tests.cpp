@@ -0,0 +1,114 @@
+/*
+ * Copyright (C) 2016 Canonical, Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 3, as published
+ * by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranties of
+ * MERCHANTABILITY, SATISFACTORY QUALITY, or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <gtest/gtest.h>
+
+#include "ac/video/idrscheduler.h"
+
+using namespace ac::video;
+
+namespace {
+static constexpr ac::TimestampUs kMinInterval{500000};
+static constexpr ac::TimestampUs kStart{1000000};
+}
+
+TEST(IdrScheduler, ServesFirstRequestRightAway) {
+    IdrScheduler scheduler(kMinInterval);
+
+    EXPECT_TRUE(scheduler.Request(kStart));
+    EXPECT_FALSE(scheduler.Poll(kStart + kMinInterval));
+
+    const auto stats = scheduler.Stats();
+    EXPECT_EQ(1u, stats.requested);
+    EXPECT_EQ(1u, stats.emitted);
+}
+
+TEST(IdrScheduler, CoalescesBurstIntoSingleDeferredIDRFrame) {
+    IdrScheduler scheduler(kMinInterval);
+
+    EXPECT_TRUE(scheduler.Request(kStart));
+    for (int n = 1; n <= 10; n++)
+        EXPECT_FALSE(scheduler.Request(kStart + n * 1000));
+
+    EXPECT_FALSE(scheduler.Poll(kStart + kMinInterval - 1));
+    EXPECT_TRUE(scheduler.Poll(kStart + kMinInterval));
+    EXPECT_FALSE(scheduler.Poll(kStart + kMinInterval + 1));
+
+    const auto stats = scheduler.Stats();
+    EXPECT_EQ(11u, stats.requested);
+    EXPECT_EQ(2u, stats.emitted);
+    EXPECT_EQ(9u, stats.coalesced);
+    EXPECT_EQ(0u, stats.substituted);
+}
+
+TEST(IdrScheduler, RateLimitsRequestsSpreadOverTime) {
+    IdrScheduler scheduler(kMinInterval);
+
+    // One request every 100 ms over two seconds
+    unsigned int emitted = 0;
+    for (ac::TimestampUs now = kStart; now < kStart + 2000000; now += 100000) {
+        if (scheduler.Poll(now))
+            emitted++;
+        if (scheduler.Request(now))
+            emitted++;
+    }
+
+    EXPECT_EQ(4u, emitted);
+    EXPECT_EQ(emitted, scheduler.Stats().emitted);
+    EXPECT_EQ(20u, scheduler.Stats().requested);
+}
+
+TEST(IdrScheduler, LeavesRequestToFastIntraRefresh) {
+    IdrScheduler scheduler(kMinInterval);
+    scheduler.SetRefreshPeriod(kMinInterval / 2);
+
+    EXPECT_TRUE(scheduler.Request(kStart));
+
+    // The sweep finishes before we could send the next IDR frame
+    EXPECT_FALSE(scheduler.Request(kStart + 1000));
+    EXPECT_FALSE(scheduler.Poll(kStart + kMinInterval));
+
+    // but not anymore when the interval is almost over
+    EXPECT_FALSE(scheduler.Request(kStart + kMinInterval - 1000));
+    EXPECT_TRUE(scheduler.Poll(kStart + kMinInterval));
+
+    const auto stats = scheduler.Stats();
+    EXPECT_EQ(3u, stats.requested);
+    EXPECT_EQ(2u, stats.emitted);
+    EXPECT_EQ(1u, stats.substituted);
+}
+
+TEST(IdrScheduler, ZeroIntervalServesEveryRequest) {
+    IdrScheduler scheduler(0);
+
+    for (int n = 0; n < 5; n++)
+        EXPECT_TRUE(scheduler.Request(kStart));
+
+    EXPECT_EQ(5u, scheduler.Stats().emitted);
+}
+
+TEST(IdrScheduler, ResetDropsPendingIDRFrame) {
+    IdrScheduler scheduler(kMinInterval);
+
+    EXPECT_TRUE(scheduler.Request(kStart));
+    EXPECT_FALSE(scheduler.Request(kStart + 1000));
+
+    scheduler.Reset();
+
+    EXPECT_FALSE(scheduler.Poll(kStart + kMinInterval));
+    EXPECT_TRUE(scheduler.Request(kStart + 2000));
+}
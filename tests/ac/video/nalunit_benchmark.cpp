@@ -0,0 +1,118 @@
+/*
+ * Copyright (C) 2016 Canonical, Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 3, as published
+ * by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranties of
+ * MERCHANTABILITY, SATISFACTORY QUALITY, or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <gtest/gtest.h>
+
+#include <cstring>
+
+#include "ac/logger.h"
+
+#include "ac/video/h264analyzer.h"
+#include "ac/video/utils.h"
+
+#include "tests/common/benchmark.h"
+
+namespace {
+static const uint8_t kSPS[] = { 0x00, 0x00, 0x00, 0x01, 0x67, 0x42, 0x00, 0x0a, 0xf8, 0x41, 0xa2 };
+static const uint8_t kPPS[] = { 0x00, 0x00, 0x00, 0x01, 0x68, 0xce, 0x38, 0x80 };
+static const uint8_t kIDRSliceHeader[] = { 0x00, 0x00, 0x00, 0x01, 0x65, 0x88, 0x84, 0x21, 0xa0 };
+// Size of an IDR frame at 720p and 5 Mbit/s
+static constexpr unsigned int kSliceCount{4};
+static constexpr unsigned int kSliceSize{16 * 1024};
+// Scanning an access unit must only take a small part of the 16.6ms a
+// frame at 60 fps has.
+static constexpr std::chrono::nanoseconds kAccessUnitBudget{std::chrono::milliseconds{1}};
+
+// Creates an access unit with SPS, PPS and a few IDR slices. The
+// payload never contains anything looking like a start code so the
+// scanners have to look at every byte.
+ac::video::Buffer::Ptr CreateAccessUnit() {
+    const auto size = sizeof(kSPS) + sizeof(kPPS) + kSliceCount * (sizeof(kIDRSliceHeader) + kSliceSize);
+    auto buffer = ac::video::Buffer::Create(size);
+
+    auto ptr = buffer->Data();
+    ::memcpy(ptr, kSPS, sizeof(kSPS));
+    ptr += sizeof(kSPS);
+    ::memcpy(ptr, kPPS, sizeof(kPPS));
+    ptr += sizeof(kPPS);
+
+    for (unsigned int n = 0; n < kSliceCount; n++) {
+        ::memcpy(ptr, kIDRSliceHeader, sizeof(kIDRSliceHeader));
+        ptr += sizeof(kIDRSliceHeader);
+        ::memset(ptr, 0xaa, kSliceSize);
+        ptr += kSliceSize;
+    }
+
+    return buffer;
+}
+
+void ReportThroughput(const char *name, const ac::testing::Benchmark::Result &result, size_t size) {
+    AC_INFO("%s: %.0f us per access unit, %.0f MB/s", name, result.timing.mean.count() * 1e6,
+            size / result.timing.mean.count() / (1024 * 1024));
+}
+}
+
+TEST(NALUnitBenchmark, GetNextNALUnit) {
+    const auto access_unit = CreateAccessUnit();
+
+    unsigned int units = 0;
+
+    const auto result = ac::testing::run_operation("nalunit-get-next", [&]() {
+        const uint8_t *data = access_unit->Data();
+        size_t size = access_unit->Length();
+        const uint8_t *nal_start = nullptr;
+        size_t nal_size = 0;
+
+        // The end of the access unit terminates the last NAL unit
+        units = 0;
+        while (ac::video::GetNextNALUnit(&data, &size, &nal_start, &nal_size, true))
+            units++;
+    }, kAccessUnitBudget);
+
+    ReportThroughput("GetNextNALUnit", result, access_unit->Length());
+
+    EXPECT_EQ(2 + kSliceCount, units);
+}
+
+TEST(NALUnitBenchmark, H264Analyzer) {
+    const auto access_unit = CreateAccessUnit();
+
+    ac::video::H264Analyzer analyzer;
+    ac::video::H264Analyzer::Result analyzed;
+
+    const auto result = ac::testing::run_operation("nalunit-h264analyzer", [&]() {
+        analyzed = analyzer.Process(access_unit->Data(), access_unit->Length());
+    }, kAccessUnitBudget);
+
+    ReportThroughput("H264Analyzer", result, access_unit->Length());
+
+    EXPECT_EQ(kSliceCount, analyzed.idr_frames);
+}
+
+TEST(NALUnitBenchmark, DoesBufferContainIDRFrame) {
+    const auto access_unit = CreateAccessUnit();
+
+    bool found = false;
+
+    const auto result = ac::testing::run_operation("nalunit-contains-idr", [&]() {
+        found = ac::video::DoesBufferContainIDRFrame(access_unit);
+    }, kAccessUnitBudget);
+
+    ReportThroughput("DoesBufferContainIDRFrame", result, access_unit->Length());
+
+    EXPECT_TRUE(found);
+}
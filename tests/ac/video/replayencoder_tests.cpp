@@ -0,0 +1,243 @@
+/*
+ * Copyright (C) 2016 Canonical, Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 3, as published
+ * by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranties of
+ * MERCHANTABILITY, SATISFACTORY QUALITY, or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <gmock/gmock.h>
+
+#include <fstream>
+#include <vector>
+
+#include <boost/filesystem.hpp>
+
+#include "ac/report/null/encoderreport.h"
+
+#include "ac/video/replayencoder.h"
+
+using namespace ::testing;
+
+namespace {
+static const std::vector<uint8_t> kIDRAccessUnit {
+    0x00, 0x00, 0x00, 0x01, 0x67, 0x42, 0x00, 0x0a, 0xf8, 0x41, 0xa2,
+    0x00, 0x00, 0x00, 0x01, 0x68, 0xce, 0x38, 0x80,
+    0x00, 0x00, 0x00, 0x01, 0x65, 0x88, 0x84, 0x21, 0xa0,
+};
+static const std::vector<uint8_t> kAccessUnit {
+    0x00, 0x00, 0x00, 0x01, 0x41, 0x9a, 0x02, 0x04,
+};
+
+class MockEncoderReport : public ac::video::EncoderReport {
+public:
+    MOCK_METHOD0(Started, void());
+    MOCK_METHOD0(Stopped, void());
+    MOCK_METHOD2(BeganFrame, void(const ac::video::FrameNumber&, const ac::TimestampUs&));
+    MOCK_METHOD2(FinishedFrame, void(const ac::video::FrameNumber&, const ac::TimestampUs&));
+    MOCK_METHOD2(ReceivedInputBuffer, void(const ac::video::FrameNumber&, const ac::TimestampUs&));
+    MOCK_METHOD0(RequestedIDRFrame, void());
+    MOCK_METHOD0(EmittedIDRFrame, void());
+};
+
+class BufferCollector : public ac::video::BaseEncoder::Delegate {
+public:
+    void OnBufferAvailable(const ac::video::Buffer::Ptr &buffer) override {
+        buffers.push_back(buffer);
+    }
+
+    void OnBufferWithCodecConfig(const ac::video::Buffer::Ptr&) override {
+    }
+
+    std::vector<uint8_t> Content(std::size_t n) const {
+        return std::vector<uint8_t>(buffers[n]->Data(), buffers[n]->Data() + buffers[n]->Length());
+    }
+
+    std::vector<ac::video::Buffer::Ptr> buffers;
+};
+
+class ReplayEncoderFixture : public ::testing::Test {
+public:
+    ReplayEncoderFixture() :
+        path((boost::filesystem::temp_directory_path() /
+              boost::filesystem::unique_path("replay-%%%%%%.h264")).string()),
+        report(std::make_shared<ac::report::null::EncoderReport>()),
+        collector(std::make_shared<BufferCollector>()) {
+    }
+
+    ~ReplayEncoderFixture() {
+        boost::filesystem::remove(path);
+    }
+
+    void WriteStream(const std::vector<std::vector<uint8_t>> &units) {
+        std::ofstream out{path, std::ios::binary};
+        for (const auto &unit : units)
+            out.write(reinterpret_cast<const char*>(unit.data()), unit.size());
+    }
+
+    ac::video::ReplayEncoder::Ptr CreateEncoder(bool loop = true) {
+        auto encoder = ac::video::ReplayEncoder::Create(path, report,
+                                                        ac::video::ReplayEncoder::Pace::kAsFastAsPossible,
+                                                        loop);
+        if (encoder)
+            encoder->SetDelegate(collector);
+        return encoder;
+    }
+
+    std::string path;
+    ac::video::EncoderReport::Ptr report;
+    std::shared_ptr<BufferCollector> collector;
+};
+}
+
+TEST_F(ReplayEncoderFixture, FailsWithoutValidFile) {
+    EXPECT_EQ(nullptr, ac::video::ReplayEncoder::Create("/does/not/exist", report));
+
+    WriteStream({{0x12, 0x34, 0x56, 0x78}});
+    EXPECT_EQ(nullptr, CreateEncoder());
+}
+
+TEST_F(ReplayEncoderFixture, IndexesAccessUnits) {
+    WriteStream({kIDRAccessUnit, kAccessUnit, kAccessUnit});
+
+    auto encoder = CreateEncoder();
+    ASSERT_NE(nullptr, encoder);
+    EXPECT_EQ(3u, encoder->AccessUnits());
+    EXPECT_EQ(ac::video::ReplayEncoder::kDefaultFramerate, encoder->Configuration().framerate);
+}
+
+TEST_F(ReplayEncoderFixture, EmitsAccessUnitsInOrderAndLoops) {
+    WriteStream({kIDRAccessUnit, kAccessUnit});
+
+    auto encoder = CreateEncoder();
+    ASSERT_NE(nullptr, encoder);
+    EXPECT_TRUE(encoder->Start());
+
+    std::vector<std::vector<uint8_t>> content;
+    for (int n = 0; n < 5; n++) {
+        EXPECT_TRUE(encoder->Execute());
+        ASSERT_EQ(1u, collector->buffers.size());
+        content.push_back(collector->Content(0));
+        // Don't hold on to buffers to not run into the limit of
+        // buffers in flight.
+        collector->buffers.clear();
+    }
+
+    EXPECT_TRUE(encoder->Stop());
+
+    EXPECT_EQ(kIDRAccessUnit, content[0]);
+    EXPECT_EQ(kAccessUnit, content[1]);
+    EXPECT_EQ(kIDRAccessUnit, content[2]);
+    EXPECT_EQ(kAccessUnit, content[3]);
+    EXPECT_EQ(kIDRAccessUnit, content[4]);
+}
+
+TEST_F(ReplayEncoderFixture, BuffersPointIntoTheFile) {
+    WriteStream({kIDRAccessUnit, kAccessUnit});
+
+    auto encoder = CreateEncoder();
+    ASSERT_NE(nullptr, encoder);
+    EXPECT_TRUE(encoder->Start());
+
+    EXPECT_TRUE(encoder->Execute());
+    EXPECT_TRUE(encoder->Execute());
+
+    ASSERT_EQ(2u, collector->buffers.size());
+    EXPECT_EQ(kIDRAccessUnit, collector->Content(0));
+    EXPECT_EQ(kAccessUnit, collector->Content(1));
+    EXPECT_EQ(1u, collector->buffers[0]->FrameNumber());
+    EXPECT_EQ(2u, collector->buffers[1]->FrameNumber());
+    EXPECT_GT(collector->buffers[1]->Timestamp(), 0);
+    EXPECT_EQ(collector->buffers[0]->Data() + kIDRAccessUnit.size(), collector->buffers[1]->Data());
+}
+
+TEST_F(ReplayEncoderFixture, StopsAtEndWithoutLoop) {
+    WriteStream({kIDRAccessUnit, kAccessUnit});
+
+    auto encoder = CreateEncoder(false);
+    ASSERT_NE(nullptr, encoder);
+    EXPECT_TRUE(encoder->Start());
+
+    EXPECT_TRUE(encoder->Execute());
+    EXPECT_TRUE(encoder->Execute());
+    EXPECT_FALSE(encoder->Execute());
+
+    EXPECT_EQ(2u, collector->buffers.size());
+}
+
+TEST_F(ReplayEncoderFixture, LimitsBuffersInFlight) {
+    WriteStream({kIDRAccessUnit, kAccessUnit});
+
+    auto encoder = CreateEncoder();
+    ASSERT_NE(nullptr, encoder);
+    EXPECT_TRUE(encoder->Start());
+
+    for (std::uint32_t n = 0; n < ac::video::ReplayEncoder::kMaxBuffersInFlight + 2; n++)
+        EXPECT_TRUE(encoder->Execute());
+
+    EXPECT_EQ(ac::video::ReplayEncoder::kMaxBuffersInFlight, collector->buffers.size());
+
+    collector->buffers.clear();
+
+    EXPECT_TRUE(encoder->Execute());
+    EXPECT_EQ(1u, collector->buffers.size());
+}
+
+TEST_F(ReplayEncoderFixture, ContinuesWithIDRFrameWhenRequested) {
+    auto mock_report = std::make_shared<MockEncoderReport>();
+    report = mock_report;
+
+    EXPECT_CALL(*mock_report, Started());
+    EXPECT_CALL(*mock_report, Stopped());
+    EXPECT_CALL(*mock_report, BeganFrame(_, _)).Times(2);
+    EXPECT_CALL(*mock_report, FinishedFrame(_, _)).Times(2);
+    EXPECT_CALL(*mock_report, RequestedIDRFrame());
+    EXPECT_CALL(*mock_report, EmittedIDRFrame());
+
+    WriteStream({kIDRAccessUnit, kAccessUnit, kAccessUnit, kIDRAccessUnit, kAccessUnit});
+
+    auto encoder = CreateEncoder();
+    ASSERT_NE(nullptr, encoder);
+    EXPECT_TRUE(encoder->Start());
+
+    EXPECT_TRUE(encoder->Execute());
+    encoder->SendIDRFrame();
+    EXPECT_TRUE(encoder->Execute());
+
+    EXPECT_TRUE(encoder->Stop());
+
+    ASSERT_EQ(2u, collector->buffers.size());
+    EXPECT_EQ(kIDRAccessUnit, collector->Content(1));
+    // Both intermediate access units got skipped
+    EXPECT_EQ(collector->buffers[0]->Data() + kIDRAccessUnit.size() + 2 * kAccessUnit.size(),
+              collector->buffers[1]->Data());
+}
+
+TEST_F(ReplayEncoderFixture, ReturnsQueuedBuffersRightAway) {
+    class BufferDelegate : public ac::video::Buffer::Delegate {
+    public:
+        MOCK_METHOD1(OnBufferFinished, void(const ac::video::Buffer::Ptr&));
+    };
+
+    WriteStream({kIDRAccessUnit});
+
+    auto encoder = CreateEncoder();
+    ASSERT_NE(nullptr, encoder);
+
+    auto delegate = std::make_shared<BufferDelegate>();
+    auto input = ac::video::Buffer::Create(static_cast<void*>(nullptr));
+    input->SetDelegate(delegate);
+
+    EXPECT_CALL(*delegate, OnBufferFinished(input));
+
+    encoder->QueueBuffer(input);
+}
@@ -0,0 +1,90 @@
+/*
+ * Copyright (C) 2016 Canonical, Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 3, as published
+ * by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranties of
+ * MERCHANTABILITY, SATISFACTORY QUALITY, or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <gtest/gtest.h>
+
+#include <vector>
+
+#include <ac/video/utils.h>
+
+namespace {
+// SPS, PPS and a single IDR slice with first_mb_in_slice = 0
+static const std::vector<uint8_t> kIDRAccessUnit {
+    0x00, 0x00, 0x00, 0x01, 0x67, 0x42, 0x00, 0x0a, 0xf8, 0x41, 0xa2,
+    0x00, 0x00, 0x00, 0x01, 0x68, 0xce, 0x38, 0x80,
+    0x00, 0x00, 0x00, 0x01, 0x65, 0x88, 0x84, 0x21, 0xa0,
+};
+// Picture split into two slices where the second one starts at
+// macroblock 1 and thus belongs to the same access unit.
+static const std::vector<uint8_t> kTwoSliceAccessUnit {
+    0x00, 0x00, 0x00, 0x01, 0x41, 0x9a, 0x02, 0x04,
+    0x00, 0x00, 0x01, 0x41, 0x40, 0x11, 0x22,
+};
+// Access unit delimiter followed by a slice
+static const std::vector<uint8_t> kDelimitedAccessUnit {
+    0x00, 0x00, 0x00, 0x01, 0x09, 0xf0,
+    0x00, 0x00, 0x00, 0x01, 0x41, 0x9a, 0x03, 0x05,
+};
+
+std::vector<uint8_t> Concat(const std::vector<std::vector<uint8_t>> &units) {
+    std::vector<uint8_t> result;
+    for (const auto &unit : units)
+        result.insert(result.end(), unit.begin(), unit.end());
+    return result;
+}
+
+std::vector<std::vector<uint8_t>> Split(const std::vector<uint8_t> &stream) {
+    std::vector<std::vector<uint8_t>> units;
+
+    const uint8_t *data = stream.data();
+    size_t size = stream.size();
+    const uint8_t *au_start = nullptr;
+    size_t au_size = 0;
+
+    while (ac::video::GetNextAccessUnit(&data, &size, &au_start, &au_size))
+        units.push_back(std::vector<uint8_t>(au_start, au_start + au_size));
+
+    return units;
+}
+}
+
+TEST(VideoUtils, SingleAccessUnit) {
+    const auto units = Split(kIDRAccessUnit);
+    ASSERT_EQ(1u, units.size());
+    EXPECT_EQ(kIDRAccessUnit, units[0]);
+}
+
+TEST(VideoUtils, SplitsOnFirstSliceOfPicture) {
+    const auto units = Split(Concat({kIDRAccessUnit, kTwoSliceAccessUnit, kTwoSliceAccessUnit}));
+    ASSERT_EQ(3u, units.size());
+    EXPECT_EQ(kIDRAccessUnit, units[0]);
+    EXPECT_EQ(kTwoSliceAccessUnit, units[1]);
+    EXPECT_EQ(kTwoSliceAccessUnit, units[2]);
+}
+
+TEST(VideoUtils, SplitsOnDelimiter) {
+    const auto units = Split(Concat({kDelimitedAccessUnit, kDelimitedAccessUnit}));
+    ASSERT_EQ(2u, units.size());
+    EXPECT_EQ(kDelimitedAccessUnit, units[0]);
+    EXPECT_EQ(kDelimitedAccessUnit, units[1]);
+}
+
+TEST(VideoUtils, NoAccessUnitWithoutStartCode) {
+    const std::vector<uint8_t> garbage{0x12, 0x34, 0x56, 0x78};
+    EXPECT_EQ(0u, Split(garbage).size());
+    EXPECT_EQ(0u, Split(std::vector<uint8_t>{}).size());
+}
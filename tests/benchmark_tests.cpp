@@ -0,0 +1,158 @@
+/*
+ * Copyright (C) 2016 Canonical, Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 3, as published
+ * by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranties of
+ * MERCHANTABILITY, SATISFACTORY QUALITY, or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <gtest/gtest.h>
+#include <gtest/gtest-spi.h>
+
+#include <boost/filesystem.hpp>
+
+#include <chrono>
+#include <sstream>
+#include <stdexcept>
+#include <thread>
+
+#include "tests/common/benchmark.h"
+
+namespace {
+ac::testing::InProcessBenchmark::OperationConfiguration ShortConfiguration() {
+    ac::testing::InProcessBenchmark::OperationConfiguration config;
+    config.warmup = std::chrono::milliseconds{1};
+    config.trial_duration = std::chrono::milliseconds{1};
+    config.trial_configuration.trial_count = 10;
+    return config;
+}
+
+void Sleep() {
+    std::this_thread::sleep_for(std::chrono::microseconds{200});
+}
+}
+
+TEST(InProcessBenchmark, RunsAllTrials) {
+    auto config = ShortConfiguration();
+
+    std::size_t calls = 0;
+    config.operation = [&]() { calls++; };
+
+    ac::testing::InProcessBenchmark benchmark;
+    const auto result = benchmark.for_operation(config);
+
+    EXPECT_EQ(10, result.sample_size);
+    EXPECT_EQ(10, result.timing.sample.size());
+    EXPECT_GT(calls, 10);
+    EXPECT_LE(result.timing.min, result.timing.mean);
+    EXPECT_GE(result.timing.max, result.timing.mean);
+}
+
+TEST(InProcessBenchmark, MeasuresTimePerCall) {
+    auto config = ShortConfiguration();
+    config.trial_duration = std::chrono::milliseconds{5};
+    config.operation = []() { std::this_thread::sleep_for(std::chrono::microseconds{500}); };
+
+    ac::testing::InProcessBenchmark benchmark;
+    const auto result = benchmark.for_operation(config);
+
+    EXPECT_GE(result.timing.mean, std::chrono::microseconds{500});
+}
+
+TEST(InProcessBenchmark, ThrowsWhenTrialTimesOut) {
+    auto config = ShortConfiguration();
+    // Calibration aims for trials way above the timeout
+    config.trial_duration = std::chrono::milliseconds{50};
+    config.trial_configuration.per_trial_timeout = std::chrono::milliseconds{1};
+    config.operation = []() { std::this_thread::sleep_for(std::chrono::microseconds{100}); };
+
+    ac::testing::InProcessBenchmark benchmark;
+    EXPECT_THROW(benchmark.for_operation(config), std::runtime_error);
+}
+
+TEST(InProcessBenchmark, DetectsSignificantlySlowerOperation) {
+    auto config = ShortConfiguration();
+    config.trial_configuration.trial_count = 20;
+
+    ac::testing::InProcessBenchmark benchmark;
+
+    config.operation = []() { std::this_thread::sleep_for(std::chrono::microseconds{100}); };
+    const auto fast = benchmark.for_operation(config);
+
+    config.operation = []() { std::this_thread::sleep_for(std::chrono::microseconds{1000}); };
+    const auto slow = benchmark.for_operation(config);
+
+    EXPECT_TRUE(slow.timing.is_significantly_slower_than_reference(fast.timing));
+    EXPECT_TRUE(fast.timing.is_significantly_faster_than_reference(slow.timing));
+}
+
+TEST(BenchmarkResult, XmlRoundTrip) {
+    auto config = ShortConfiguration();
+    config.operation = []() {};
+
+    ac::testing::InProcessBenchmark benchmark;
+    auto result = benchmark.for_operation(config);
+
+    std::stringstream ss;
+    result.save_to_xml(ss);
+
+    ac::testing::Benchmark::Result loaded;
+    loaded.load_from_xml(ss);
+
+    EXPECT_EQ(result, loaded);
+}
+
+TEST(BenchmarkResult, JsonUsesReferenceFieldNames) {
+    ac::testing::Benchmark::Result result;
+    result.sample_size = 2;
+    result.timing.min = ac::testing::Benchmark::Result::Timing::Seconds{0.5};
+    result.timing.max = ac::testing::Benchmark::Result::Timing::Seconds{1.5};
+    result.timing.mean = ac::testing::Benchmark::Result::Timing::Seconds{1.0};
+    result.timing.std_dev = ac::testing::Benchmark::Result::Timing::Seconds{0.5};
+    result.timing.sample = {result.timing.min, result.timing.max};
+
+    std::stringstream ss;
+    result.save_to_json(ss);
+
+    EXPECT_EQ("{\"result\": {\"sample_size\": 2, "
+              "\"timing.min\": {\"seconds\": 0.5}, "
+              "\"timing.max\": {\"seconds\": 1.5}, "
+              "\"timing.mean\": {\"seconds\": 1}, "
+              "\"timing.std_dev\": {\"seconds\": 0.5}, "
+              "\"timing.sample\": [{\"seconds\": 0.5}, {\"seconds\": 1.5}]}}\n", ss.str());
+}
+
+TEST(RunOperation, PassesWithinBudget) {
+    const auto result = ac::testing::run_operation("within-budget", []() {}, std::chrono::milliseconds{1});
+    EXPECT_LT(0, result.sample_size);
+}
+
+TEST(RunOperation, FailsOverBudget) {
+    EXPECT_NONFATAL_FAILURE(ac::testing::run_operation("over-budget", &Sleep, std::chrono::microseconds{10}),
+                            "exceeds its budget");
+}
+
+TEST(RunOperation, FailsWhenSlowerThanReference) {
+    const auto directory = boost::filesystem::temp_directory_path() / boost::filesystem::unique_path();
+    boost::filesystem::create_directories(directory);
+
+    setenv("AETHERCAST_BENCHMARK_RESULTS", directory.string().c_str(), 1);
+    ac::testing::run_operation("reference", []() {}, std::chrono::seconds{1});
+    unsetenv("AETHERCAST_BENCHMARK_RESULTS");
+
+    setenv("AETHERCAST_BENCHMARK_REFERENCES", directory.string().c_str(), 1);
+    EXPECT_NONFATAL_FAILURE(ac::testing::run_operation("reference", &Sleep, std::chrono::seconds{1}),
+                            "slower than its reference");
+    unsetenv("AETHERCAST_BENCHMARK_REFERENCES");
+
+    boost::filesystem::remove_all(directory);
+}
@@ -26,12 +26,44 @@
 #include <boost/archive/xml_iarchive.hpp>
 #include <boost/archive/xml_oarchive.hpp>
 
+#include <boost/accumulators/accumulators.hpp>
+#include <boost/accumulators/statistics/count.hpp>
+#include <boost/accumulators/statistics/max.hpp>
+#include <boost/accumulators/statistics/mean.hpp>
+#include <boost/accumulators/statistics/min.hpp>
+#include <boost/accumulators/statistics/stats.hpp>
+#include <boost/accumulators/statistics/variance.hpp>
+
+#include <cmath>
+#include <iomanip>
+#include <fstream>
 #include <iostream>
+#include <limits>
+#include <stdexcept>
+
+#include <boost/filesystem.hpp>
+
+#include <gtest/gtest.h>
+
+#include "ac/utils.h"
 
 #include "tests/common/benchmark.h"
 
 namespace {
 constexpr const char* kNameForSeconds{"seconds"};
+// Calibration doubles the number of calls until it gets a measurable
+// duration.
+constexpr std::chrono::microseconds kMinCalibrationDuration{1000};
+// Reading the clock after every call would add to what we measure
+constexpr std::size_t kTimeoutCheckInterval{64};
+
+typedef std::chrono::steady_clock Clock;
+
+void WriteJsonSeconds(std::ostream& out, const char* name,
+                      const ac::testing::Benchmark::Result::Timing::Seconds& value)
+{
+    out << "\"" << name << "\": {\"" << kNameForSeconds << "\": " << value.count() << "}";
+}
 }
 
 namespace boost {
@@ -119,6 +151,34 @@ void Benchmark::Result::save_to_xml(std::ostream& out)
     }
 }
 
+void Benchmark::Result::save_to_json(std::ostream& out) const
+{
+    const auto flags = out.flags();
+    const auto precision = out.precision();
+    out << std::setprecision(std::numeric_limits<double>::max_digits10);
+
+    out << "{\"result\": {";
+    out << "\"sample_size\": " << sample_size << ", ";
+    WriteJsonSeconds(out, "timing.min", timing.min);
+    out << ", ";
+    WriteJsonSeconds(out, "timing.max", timing.max);
+    out << ", ";
+    WriteJsonSeconds(out, "timing.mean", timing.mean);
+    out << ", ";
+    WriteJsonSeconds(out, "timing.std_dev", timing.std_dev);
+    out << ", \"timing.sample\": [";
+    for (std::size_t n = 0; n < timing.sample.size(); n++)
+    {
+        if (n > 0)
+            out << ", ";
+        out << "{\"" << kNameForSeconds << "\": " << timing.sample[n].count() << "}";
+    }
+    out << "]}}\n";
+
+    out.flags(flags);
+    out.precision(precision);
+}
+
 void Benchmark::Result::load_from(std::istream& in)
 {
     try
@@ -219,6 +279,123 @@ bool Benchmark::Result::Timing::is_significantly_slower_than_reference(
             test_result.sample1_mean_gt_sample2_mean(alpha);
 }
 
+Benchmark::Result InProcessBenchmark::for_operation(const OperationConfiguration& config)
+{
+    namespace ba = boost::accumulators;
+
+    if (!config.operation)
+        throw std::runtime_error{"InProcessBenchmark::for_operation: no operation given"};
+
+    const auto& trials = config.trial_configuration;
+
+    const auto warmup_start = Clock::now();
+    while (Clock::now() - warmup_start < config.warmup)
+        config.operation();
+
+    // Figure out how many calls we need for one trial to take about
+    // trial_duration.
+    std::size_t calls = 1;
+    Clock::duration elapsed{0};
+    while (true)
+    {
+        const auto start = Clock::now();
+        for (std::size_t n = 0; n < calls; n++)
+            config.operation();
+        elapsed = Clock::now() - start;
+
+        if (elapsed >= kMinCalibrationDuration || elapsed >= config.trial_duration)
+            break;
+
+        calls *= 2;
+    }
+
+    const double seconds_per_call = std::chrono::duration<double>(elapsed).count() / calls;
+    const double trial_seconds = std::chrono::duration<double>(config.trial_duration).count();
+    const auto calls_per_trial = std::max<std::size_t>(1, static_cast<std::size_t>(std::ceil(trial_seconds / seconds_per_call)));
+
+    ba::accumulator_set<
+        double,
+        ba::stats<ba::tag::count, ba::tag::min, ba::tag::max, ba::tag::mean, ba::tag::variance>
+    > stats;
+
+    Result result;
+
+    for (std::size_t trial = 0; trial < trials.trial_count; trial++)
+    {
+        const auto start = Clock::now();
+        for (std::size_t n = 0; n < calls_per_trial; n++)
+        {
+            config.operation();
+
+            if ((n % kTimeoutCheckInterval) == 0 && Clock::now() - start > trials.per_trial_timeout)
+                throw std::runtime_error{"InProcessBenchmark::for_operation: trial exceeded timeout"};
+        }
+
+        const double seconds = std::chrono::duration<double>(Clock::now() - start).count() / calls_per_trial;
+        stats(seconds);
+        result.timing.sample.push_back(Result::Timing::Seconds{seconds});
+    }
+
+    result.sample_size = ba::count(stats);
+    result.timing.min = Result::Timing::Seconds{ba::min(stats)};
+    result.timing.max = Result::Timing::Seconds{ba::max(stats)};
+    result.timing.mean = Result::Timing::Seconds{ba::mean(stats)};
+    result.timing.std_dev = Result::Timing::Seconds{std::sqrt(ba::variance(stats))};
+
+    return result;
+}
+
+void save_result_if_requested(const std::string& name, const Benchmark::Result& result)
+{
+    const auto directory = ac::Utils::GetEnvValue("AETHERCAST_BENCHMARK_RESULTS");
+    if (directory.length() == 0)
+        return;
+
+    auto copy = result;
+
+    std::ofstream xml{directory + "/" + name + ".xml"};
+    copy.save_to_xml(xml);
+
+    std::ofstream json{directory + "/" + name + ".json"};
+    copy.save_to_json(json);
+}
+
+Benchmark::Result run_operation(const std::string& name,
+                                const std::function<void()>& operation,
+                                std::chrono::nanoseconds budget)
+{
+    InProcessBenchmark::OperationConfiguration config;
+    config.operation = operation;
+
+    InProcessBenchmark benchmark;
+    const auto result = benchmark.for_operation(config);
+    save_result_if_requested(name, result);
+
+    EXPECT_LE(result.timing.mean, budget) << name << " exceeds its budget";
+
+    const auto directory = ac::Utils::GetEnvValue("AETHERCAST_BENCHMARK_REFERENCES");
+    const auto path = boost::filesystem::path(directory) / (name + ".xml");
+    if (directory.length() == 0 || !boost::filesystem::exists(path))
+        return result;
+
+    Benchmark::Result reference;
+    try
+    {
+        std::ifstream in{path.string()};
+        reference.load_from_xml(in);
+    }
+    catch (const std::exception& e)
+    {
+        ADD_FAILURE() << "Failed to load reference result " << path.string() << ": " << e.what();
+        return result;
+    }
+
+    EXPECT_FALSE(result.timing.is_significantly_slower_than_reference(reference.timing))
+            << name << " is slower than its reference " << reference;
+
+    return result;
+}
+
 bool operator==(const Benchmark::Result& lhs, const Benchmark::Result& rhs)
 {
     return lhs.sample_size == rhs.sample_size &&
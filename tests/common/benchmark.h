@@ -23,6 +23,8 @@
 #include <functional>
 #include <iosfwd>
 #include <memory>
+#include <string>
+#include <vector>
 
 #include "tests/common/statistics.h"
 
@@ -151,6 +153,16 @@ public:
          * \param out The stream to write to.
          */
         void save_to_xml(std::ostream& out);
+
+        /**
+         * \brief save_to_json stores a result as json to the given output stream.
+         *
+         * The json document carries the same fields under the same names as the
+         * xml archive so results can be compared with either reference format.
+         *
+         * \param out The stream to write to.
+         */
+        void save_to_json(std::ostream& out) const;
     };
 
     /**
@@ -190,6 +202,83 @@ protected:
     Benchmark() = default;
 };
 
+/**
+ * \brief The InProcessBenchmark class measures an operation by calling it
+ * repeatedly in the current process.
+ *
+ * Each run warms up first, then calibrates how many calls make up one
+ * trial so that a trial is long enough to be measured reliably and
+ * finally executes the configured number of trials. Every trial adds the
+ * mean time of one call to the resulting sample.
+ *
+ * \code
+ * ac::testing::InProcessBenchmark benchmark;
+ * ac::testing::InProcessBenchmark::OperationConfiguration config;
+ * config.operation = [&]() { queue->Push(buffer); queue->Pop(); };
+ *
+ * auto result = benchmark.for_operation(config);
+ * \endcode
+ */
+class InProcessBenchmark : public Benchmark
+{
+public:
+    /**
+     * \brief The OperationConfiguration struct describes the operation to be
+     * benchmarked and how it is executed.
+     */
+    struct OperationConfiguration
+    {
+        /** The operation to measure. */
+        std::function<void()> operation{};
+        /** Time the operation is called before measuring anything. */
+        std::chrono::microseconds warmup{std::chrono::milliseconds{50}};
+        /** Calibration picks the number of calls so that one trial takes about this long. */
+        std::chrono::microseconds trial_duration{std::chrono::milliseconds{10}};
+        /** Number of trials and the timeout for each. */
+        TrialConfiguration trial_configuration{};
+    };
+
+    InProcessBenchmark() = default;
+
+    /**
+     * \brief for_operation runs the benchmark for the given operation.
+     * \throw std::runtime_error if a trial exceeds the per trial timeout. The
+     * timeout is checked between calls of the operation so a single call which
+     * never returns is not detected.
+     * \param config The operation and its trial setup.
+     * \return The timing of one call of the operation.
+     */
+    Result for_operation(const OperationConfiguration& config);
+};
+
+/**
+ * \brief save_result_if_requested stores result as <name>.xml and <name>.json in the
+ * directory named by AETHERCAST_BENCHMARK_RESULTS. Does nothing if that is not set.
+ *
+ * The xml files can be used as reference results the same way as
+ * stream-performance-reference.xml.
+ */
+void save_result_if_requested(const std::string& name, const Benchmark::Result& result);
+
+/**
+ * \brief run_operation benchmarks operation with the default configuration
+ * of InProcessBenchmark and stores the result with save_result_if_requested.
+ *
+ * The result is checked and any violation is reported as a test failure:
+ *  - one call of the operation must not take longer than budget on average
+ *  - if AETHERCAST_BENCHMARK_REFERENCES names a directory containing a
+ *    reference result <name>.xml the operation must not be significantly
+ *    slower than that reference.
+ *
+ * \param name The name the result is stored and looked up with.
+ * \param operation The operation to measure.
+ * \param budget Upper limit for the mean time of one call.
+ * \return The timing of one call of the operation.
+ */
+Benchmark::Result run_operation(const std::string& name,
+                                const std::function<void()>& operation,
+                                std::chrono::nanoseconds budget);
+
 bool operator==(const Benchmark::Result& lhs, const Benchmark::Result& rhs);
 
 std::ostream& operator<<(std::ostream&, const Benchmark::Result&);
@@ -51,6 +51,7 @@ std::string BaseSkeleton<T>::ObjectPath() const {
 template class BaseSkeleton<WpaSupplicantInterfaceP2PDevice>;
 template class BaseSkeleton<WpaSupplicantPeer>;
 template class BaseSkeleton<WpaSupplicantInterface>;
+template class BaseSkeleton<WpaSupplicantFiW1Wpa_supplicant1>;
 
 } // namespace testing
 } // namespace w11tng
@@ -0,0 +1,330 @@
+/*
+ * Copyright (C) 2016 Canonical, Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 3, as published
+ * by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranties of
+ * MERCHANTABILITY, SATISFACTORY QUALITY, or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <chrono>
+#include <cstring>
+#include <functional>
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include <w11tng/dhcpclient.h>
+#include <w11tng/dhcpserver.h>
+
+#include <common/glibhelpers.h>
+
+using namespace ::testing;
+
+namespace {
+using DhcpMessage = w11tng::DhcpMessage;
+
+constexpr const char *kPeer{"02:00:00:00:00:01"};
+
+class MockDhcpServerDelegate : public w11tng::DhcpServer::Delegate {
+public:
+    MOCK_METHOD2(OnDhcpAddressAssigned, void(const ac::IpV4Address &, const ac::IpV4Address&));
+    MOCK_METHOD0(OnDhcpTerminated, void());
+};
+
+class MockDhcpClientDelegate : public w11tng::DhcpClient::Delegate {
+public:
+    MOCK_METHOD2(OnDhcpAddressAssigned, void(const ac::IpV4Address &, const ac::IpV4Address&));
+    MOCK_METHOD0(OnDhcpTerminated, void());
+};
+
+int CreateSocket(std::uint16_t port = 0) {
+    const auto fd = ::socket(AF_INET, SOCK_DGRAM | SOCK_NONBLOCK | SOCK_CLOEXEC, IPPROTO_UDP);
+
+    const int enable = 1;
+    ::setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &enable, sizeof(enable));
+    ::setsockopt(fd, SOL_SOCKET, SO_BROADCAST, &enable, sizeof(enable));
+
+    struct sockaddr_in addr;
+    ::memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_ANY);
+    addr.sin_port = htons(port);
+    ::bind(fd, reinterpret_cast<struct sockaddr*>(&addr), sizeof(addr));
+
+    return fd;
+}
+
+std::uint16_t SocketPort(int fd) {
+    struct sockaddr_in addr;
+    socklen_t length = sizeof(addr);
+    ::getsockname(fd, reinterpret_cast<struct sockaddr*>(&addr), &length);
+    return ntohs(addr.sin_port);
+}
+
+// The client has to know its port before the server exists and vice
+// versa so we pick one nobody uses right now.
+std::uint16_t FindFreePort() {
+    const auto fd = CreateSocket();
+    const auto port = SocketPort(fd);
+    ::close(fd);
+    return port;
+}
+
+bool RunMainLoopUntil(const std::function<bool()> &condition,
+                      const std::chrono::milliseconds &timeout = std::chrono::milliseconds{2000}) {
+    const auto deadline = std::chrono::steady_clock::now() + timeout;
+    while (std::chrono::steady_clock::now() < deadline) {
+        if (condition())
+            return true;
+
+        g_main_context_iteration(nullptr, FALSE);
+        ::usleep(1000);
+    }
+    return condition();
+}
+
+// Plays the server side of the protocol so we can check each message
+// the client sends and answer as we like.
+class ScriptedServer {
+public:
+    ScriptedServer() :
+        fd_(CreateSocket()),
+        port_(SocketPort(fd_)) {
+    }
+
+    ~ScriptedServer() {
+        ::close(fd_);
+    }
+
+    std::uint16_t Port() const {
+        return port_;
+    }
+
+    bool Receive(DhcpMessage &message, const std::chrono::milliseconds &timeout = std::chrono::milliseconds{1000}) {
+        return RunMainLoopUntil([&]() {
+            std::uint8_t data[DhcpMessage::kMaxSize * 2];
+            const auto bytes_read = ::recv(fd_, data, sizeof(data), 0);
+            return bytes_read > 0 &&
+                    DhcpMessage::Parse(data, bytes_read, message) &&
+                    message.op == DhcpMessage::Op::kBootRequest;
+        }, timeout);
+    }
+
+    void Send(const DhcpMessage &message, std::uint16_t client_port) {
+        const auto data = message.Serialize();
+
+        struct sockaddr_in addr;
+        ::memset(&addr, 0, sizeof(addr));
+        addr.sin_family = AF_INET;
+        addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        addr.sin_port = htons(client_port);
+        ::sendto(fd_, data.data(), data.size(), 0, reinterpret_cast<struct sockaddr*>(&addr), sizeof(addr));
+    }
+
+private:
+    int fd_;
+    std::uint16_t port_;
+};
+
+struct DhcpClientFixture : public ::testing::Test {
+    DhcpClientFixture() :
+        client_port(FindFreePort()),
+        server_delegate(std::make_shared<MockDhcpServerDelegate>()),
+        client_delegate(std::make_shared<NiceMock<MockDhcpClientDelegate>>()) {
+        w11tng::DhcpClient::ForgetLeases();
+    }
+
+    w11tng::DhcpServer::Ptr CreateServer() {
+        auto config = w11tng::DhcpServer::DefaultConfig();
+        config.local_address = ac::IpV4Address::from_string("127.0.0.1");
+        config.pool_address = ac::IpV4Address::from_string("127.0.0.5");
+        config.prefix_length = 8;
+        config.server_port = 0;
+        config.client_port = client_port;
+        config.configure_interface = false;
+        return w11tng::DhcpServer::Create(server_delegate, "lo", config);
+    }
+
+    w11tng::DhcpClient::Ptr CreateClient(std::uint16_t server_port, const std::string &peer = kPeer) {
+        auto config = w11tng::DhcpClient::DefaultConfig();
+        config.server_port = server_port;
+        config.client_port = client_port;
+        config.configure_interface = false;
+        return w11tng::DhcpClient::Create(client_delegate, "lo", peer, config);
+    }
+
+    // Runs a full exchange with the in-tree server so the client
+    // remembers the lease for kPeer.
+    void AcquireLease() {
+        EXPECT_CALL(*server_delegate, OnDhcpAddressAssigned(_, _)).Times(AtLeast(1));
+
+        auto server = CreateServer();
+        auto client = CreateClient(server->Port());
+        ASSERT_TRUE(RunMainLoopUntil([&]() { return !client->LocalAddress().is_unspecified(); }));
+    }
+
+    std::uint16_t client_port;
+    std::shared_ptr<MockDhcpServerDelegate> server_delegate;
+    std::shared_ptr<NiceMock<MockDhcpClientDelegate>> client_delegate;
+};
+}
+
+TEST_F(DhcpClientFixture, AcquiresAddressFromServer) {
+    EXPECT_CALL(*server_delegate, OnDhcpAddressAssigned(ac::IpV4Address::from_string("127.0.0.1"),
+                                                        ac::IpV4Address::from_string("127.0.0.5")))
+            .Times(1);
+    EXPECT_CALL(*client_delegate, OnDhcpAddressAssigned(ac::IpV4Address::from_string("127.0.0.5"),
+                                                        ac::IpV4Address::from_string("127.0.0.1")))
+            .Times(1);
+    EXPECT_CALL(*client_delegate, OnDhcpTerminated()).Times(0);
+
+    auto server = CreateServer();
+    auto client = CreateClient(server->Port());
+
+    ASSERT_TRUE(RunMainLoopUntil([&]() { return !client->LocalAddress().is_unspecified(); }));
+
+    EXPECT_EQ("127.0.0.5", client->LocalAddress().to_string());
+    EXPECT_EQ("127.0.0.1", client->RemoteAddress().to_string());
+}
+
+TEST_F(DhcpClientFixture, UnknownPeerStartsWithDiscover) {
+    ScriptedServer server;
+    auto client = CreateClient(server.Port());
+
+    DhcpMessage discover;
+    ASSERT_TRUE(server.Receive(discover));
+    EXPECT_EQ(DhcpMessage::Type::kDiscover, discover.MessageType());
+    EXPECT_EQ(DhcpMessage::kBroadcastFlag, discover.flags);
+}
+
+TEST_F(DhcpClientFixture, RetransmitsQuickly) {
+    ScriptedServer server;
+    auto client = CreateClient(server.Port());
+
+    DhcpMessage first, second;
+    ASSERT_TRUE(server.Receive(first));
+
+    const auto start = std::chrono::steady_clock::now();
+    ASSERT_TRUE(server.Receive(second));
+    const auto elapsed = std::chrono::steady_clock::now() - start;
+
+    EXPECT_EQ(DhcpMessage::Type::kDiscover, second.MessageType());
+    EXPECT_EQ(first.transaction_id, second.transaction_id);
+    EXPECT_LT(elapsed, w11tng::DhcpClient::kInitialRetransmitTimeout * 2);
+}
+
+TEST_F(DhcpClientFixture, KnownPeerRequestsLastAddress) {
+    AcquireLease();
+
+    EXPECT_CALL(*client_delegate, OnDhcpAddressAssigned(ac::IpV4Address::from_string("127.0.0.5"),
+                                                        ac::IpV4Address::from_string("127.0.0.1")))
+            .Times(1);
+
+    ScriptedServer server;
+    auto client = CreateClient(server.Port());
+
+    DhcpMessage request;
+    ASSERT_TRUE(server.Receive(request));
+    EXPECT_EQ(DhcpMessage::Type::kRequest, request.MessageType());
+    EXPECT_EQ("127.0.0.5", request.AddressOption(DhcpMessage::Option::kRequestedAddress).to_string());
+    EXPECT_FALSE(request.HasOption(DhcpMessage::Option::kServerIdentifier));
+
+    auto ack = request.CreateReply(DhcpMessage::Type::kAck);
+    ack.your_address = ac::IpV4Address::from_string("127.0.0.5");
+    ack.SetAddressOption(DhcpMessage::Option::kServerIdentifier, ac::IpV4Address::from_string("127.0.0.1"));
+    server.Send(ack, client_port);
+
+    ASSERT_TRUE(RunMainLoopUntil([&]() { return !client->LocalAddress().is_unspecified(); }));
+}
+
+TEST_F(DhcpClientFixture, KeepsLeasesLongerThanMillisecondTimersCanHold) {
+    AcquireLease();
+
+    // 4294968 s are 704 ms once wrapped into a 32 bit millisecond count
+    static constexpr std::uint32_t kLongLeaseTime{4294968};
+
+    EXPECT_CALL(*client_delegate, OnDhcpTerminated()).Times(0);
+
+    ScriptedServer server;
+    auto client = CreateClient(server.Port());
+
+    DhcpMessage request;
+    ASSERT_TRUE(server.Receive(request));
+
+    auto ack = request.CreateReply(DhcpMessage::Type::kAck);
+    ack.your_address = ac::IpV4Address::from_string("127.0.0.5");
+    ack.SetAddressOption(DhcpMessage::Option::kServerIdentifier, ac::IpV4Address::from_string("127.0.0.1"));
+    ack.SetUint32Option(DhcpMessage::Option::kLeaseTime, kLongLeaseTime);
+    server.Send(ack, client_port);
+
+    ASSERT_TRUE(RunMainLoopUntil([&]() { return !client->LocalAddress().is_unspecified(); }));
+
+    ac::testing::RunMainLoop(std::chrono::seconds{2});
+
+    EXPECT_FALSE(client->LocalAddress().is_unspecified());
+}
+
+TEST_F(DhcpClientFixture, KnownPeerFallsBackToDiscoverOnNak) {
+    AcquireLease();
+
+    ScriptedServer server;
+    auto client = CreateClient(server.Port());
+
+    DhcpMessage request;
+    ASSERT_TRUE(server.Receive(request));
+    EXPECT_EQ(DhcpMessage::Type::kRequest, request.MessageType());
+
+    server.Send(request.CreateReply(DhcpMessage::Type::kNak), client_port);
+
+    DhcpMessage discover;
+    ASSERT_TRUE(server.Receive(discover));
+    EXPECT_EQ(DhcpMessage::Type::kDiscover, discover.MessageType());
+}
+
+TEST_F(DhcpClientFixture, OtherPeerStartsWithDiscover) {
+    AcquireLease();
+
+    ScriptedServer server;
+    auto client = CreateClient(server.Port(), "02:00:00:00:00:02");
+
+    DhcpMessage discover;
+    ASSERT_TRUE(server.Receive(discover));
+    EXPECT_EQ(DhcpMessage::Type::kDiscover, discover.MessageType());
+}
+
+TEST_F(DhcpClientFixture, GivesUpWithoutServer) {
+    EXPECT_CALL(*client_delegate, OnDhcpTerminated()).Times(1);
+
+    ScriptedServer server;
+    auto config = w11tng::DhcpClient::DefaultConfig();
+    config.server_port = server.Port();
+    config.client_port = client_port;
+    config.timeout = std::chrono::seconds{1};
+    config.configure_interface = false;
+    auto client = w11tng::DhcpClient::Create(client_delegate, "lo", kPeer, config);
+
+    ac::testing::RunMainLoop(std::chrono::seconds{2});
+}
+
+TEST(DhcpClient, ReportsFailureToStart) {
+    auto delegate = std::make_shared<MockDhcpClientDelegate>();
+    EXPECT_CALL(*delegate, OnDhcpTerminated()).Times(1);
+
+    auto client = w11tng::DhcpClient::Create(delegate, "doesnotexist0");
+
+    ac::testing::RunMainLoopIteration();
+}
@@ -0,0 +1,115 @@
+/*
+ * Copyright (C) 2016 Canonical, Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 3, as published
+ * by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranties of
+ * MERCHANTABILITY, SATISFACTORY QUALITY, or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <gtest/gtest.h>
+
+#include <w11tng/dhcpmessage.h>
+
+namespace {
+w11tng::DhcpMessage CreateDiscover() {
+    w11tng::DhcpMessage message;
+    message.transaction_id = 0x12345678;
+    message.flags = w11tng::DhcpMessage::kBroadcastFlag;
+    message.hardware_address = {{0x02, 0x11, 0x22, 0x33, 0x44, 0x55}};
+    message.SetMessageType(w11tng::DhcpMessage::Type::kDiscover);
+    return message;
+}
+}
+
+TEST(DhcpMessage, RoundTrip) {
+    auto message = CreateDiscover();
+    message.client_address = ac::IpV4Address::from_string("10.0.0.1");
+    message.SetAddressOption(w11tng::DhcpMessage::Option::kRequestedAddress,
+                             ac::IpV4Address::from_string("192.168.7.5"));
+    message.SetUint32Option(w11tng::DhcpMessage::Option::kLeaseTime, 3600);
+
+    const auto data = message.Serialize();
+    EXPECT_LE(w11tng::DhcpMessage::kMinSize, data.size());
+    // Message type goes first
+    EXPECT_EQ(53, data[w11tng::DhcpMessage::kHeaderSize]);
+
+    w11tng::DhcpMessage parsed;
+    ASSERT_TRUE(w11tng::DhcpMessage::Parse(data.data(), data.size(), parsed));
+
+    EXPECT_EQ(w11tng::DhcpMessage::Op::kBootRequest, parsed.op);
+    EXPECT_EQ(w11tng::DhcpMessage::Type::kDiscover, parsed.MessageType());
+    EXPECT_EQ(0x12345678, parsed.transaction_id);
+    EXPECT_EQ(w11tng::DhcpMessage::kBroadcastFlag, parsed.flags);
+    EXPECT_EQ("10.0.0.1", parsed.client_address.to_string());
+    EXPECT_EQ("192.168.7.5", parsed.AddressOption(w11tng::DhcpMessage::Option::kRequestedAddress).to_string());
+    EXPECT_EQ(3600, parsed.Uint32Option(w11tng::DhcpMessage::Option::kLeaseTime));
+    EXPECT_EQ("02:11:22:33:44:55", parsed.HardwareAddressToString());
+}
+
+TEST(DhcpMessage, RejectsInvalidMessages) {
+    const auto data = CreateDiscover().Serialize();
+    w11tng::DhcpMessage parsed;
+
+    EXPECT_FALSE(w11tng::DhcpMessage::Parse(nullptr, 0, parsed));
+    EXPECT_FALSE(w11tng::DhcpMessage::Parse(data.data(), w11tng::DhcpMessage::kHeaderSize - 1, parsed));
+
+    auto broken = data;
+    // Magic cookie
+    broken[236] = 0;
+    EXPECT_FALSE(w11tng::DhcpMessage::Parse(broken.data(), broken.size(), parsed));
+
+    broken = data;
+    // Message type option claims to be longer than the message
+    broken[w11tng::DhcpMessage::kHeaderSize + 1] = 0xff;
+    EXPECT_FALSE(w11tng::DhcpMessage::Parse(broken.data(), w11tng::DhcpMessage::kHeaderSize + 10, parsed));
+
+    // Plain BOOTP without a message type
+    w11tng::DhcpMessage bootp;
+    const auto bootp_data = bootp.Serialize();
+    EXPECT_FALSE(w11tng::DhcpMessage::Parse(bootp_data.data(), bootp_data.size(), parsed));
+}
+
+TEST(DhcpMessage, MissingOptionsGiveFallbacks) {
+    const auto message = CreateDiscover();
+
+    EXPECT_FALSE(message.HasOption(w11tng::DhcpMessage::Option::kServerIdentifier));
+    EXPECT_TRUE(message.AddressOption(w11tng::DhcpMessage::Option::kServerIdentifier).is_unspecified());
+    EXPECT_EQ(42, message.Uint32Option(w11tng::DhcpMessage::Option::kLeaseTime, 42));
+}
+
+TEST(DhcpMessage, LongOptionsAreSplitAndJoined) {
+    auto message = CreateDiscover();
+    std::vector<std::uint8_t> identifier(300);
+    for (std::size_t n = 0; n < identifier.size(); n++)
+        identifier[n] = n & 0xff;
+    message.SetOption(w11tng::DhcpMessage::Option::kClientIdentifier, identifier);
+
+    const auto data = message.Serialize();
+
+    w11tng::DhcpMessage parsed;
+    ASSERT_TRUE(w11tng::DhcpMessage::Parse(data.data(), data.size(), parsed));
+    EXPECT_EQ(identifier, parsed.OptionData(w11tng::DhcpMessage::Option::kClientIdentifier));
+}
+
+TEST(DhcpMessage, ReplyMatchesRequest) {
+    auto request = CreateDiscover();
+    request.relay_address = ac::IpV4Address::from_string("10.0.0.254");
+
+    const auto reply = request.CreateReply(w11tng::DhcpMessage::Type::kOffer);
+    EXPECT_EQ(w11tng::DhcpMessage::Op::kBootReply, reply.op);
+    EXPECT_EQ(w11tng::DhcpMessage::Type::kOffer, reply.MessageType());
+    EXPECT_EQ(request.transaction_id, reply.transaction_id);
+    EXPECT_EQ(request.flags, reply.flags);
+    EXPECT_EQ(request.relay_address, reply.relay_address);
+    EXPECT_EQ(request.hardware_address, reply.hardware_address);
+    EXPECT_FALSE(reply.HasOption(w11tng::DhcpMessage::Option::kRequestedAddress));
+}
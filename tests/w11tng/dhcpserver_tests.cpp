@@ -0,0 +1,265 @@
+/*
+ * Copyright (C) 2016 Canonical, Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 3, as published
+ * by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranties of
+ * MERCHANTABILITY, SATISFACTORY QUALITY, or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <chrono>
+#include <cstring>
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include <w11tng/dhcpserver.h>
+
+#include <common/glibhelpers.h>
+
+using namespace ::testing;
+
+namespace {
+using DhcpMessage = w11tng::DhcpMessage;
+
+class MockDhcpServerDelegate : public w11tng::DhcpServer::Delegate {
+public:
+    MOCK_METHOD2(OnDhcpAddressAssigned, void(const ac::IpV4Address &, const ac::IpV4Address&));
+    MOCK_METHOD0(OnDhcpTerminated, void());
+};
+
+// Plays the client side of the protocol message by message over the
+// loopback interface so we can check each answer of the server.
+class ScriptedClient {
+public:
+    explicit ScriptedClient(std::uint8_t id) :
+        fd_(::socket(AF_INET, SOCK_DGRAM | SOCK_NONBLOCK | SOCK_CLOEXEC, IPPROTO_UDP)),
+        port_(0),
+        transaction_id_(0x1000 * id) {
+
+        hardware_address_ = {{0x02, 0x00, 0x00, 0x00, 0x00, id}};
+
+        const int enable = 1;
+        ::setsockopt(fd_, SOL_SOCKET, SO_REUSEADDR, &enable, sizeof(enable));
+        ::setsockopt(fd_, SOL_SOCKET, SO_BROADCAST, &enable, sizeof(enable));
+
+        struct sockaddr_in addr;
+        ::memset(&addr, 0, sizeof(addr));
+        addr.sin_family = AF_INET;
+        addr.sin_addr.s_addr = htonl(INADDR_ANY);
+        socklen_t length = sizeof(addr);
+        ::bind(fd_, reinterpret_cast<struct sockaddr*>(&addr), sizeof(addr));
+        ::getsockname(fd_, reinterpret_cast<struct sockaddr*>(&addr), &length);
+        port_ = ntohs(addr.sin_port);
+    }
+
+    ~ScriptedClient() {
+        ::close(fd_);
+    }
+
+    std::uint16_t Port() const {
+        return port_;
+    }
+
+    // The server sends all replies to a single port so instead of a
+    // second client we change the identity of this one.
+    void SetHardwareAddress(std::uint8_t id) {
+        hardware_address_[5] = id;
+    }
+
+    DhcpMessage CreateMessage(DhcpMessage::Type type) {
+        DhcpMessage message;
+        message.transaction_id = ++transaction_id_;
+        message.hardware_address = hardware_address_;
+        message.SetMessageType(type);
+        return message;
+    }
+
+    void Send(const DhcpMessage &message, std::uint16_t server_port) {
+        const auto data = message.Serialize();
+
+        struct sockaddr_in addr;
+        ::memset(&addr, 0, sizeof(addr));
+        addr.sin_family = AF_INET;
+        addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        addr.sin_port = htons(server_port);
+        ::sendto(fd_, data.data(), data.size(), 0, reinterpret_cast<struct sockaddr*>(&addr), sizeof(addr));
+    }
+
+    // Runs the main loop until the reply to our last message arrived
+    bool Receive(DhcpMessage &reply, const std::chrono::milliseconds &timeout = std::chrono::milliseconds{500}) {
+        const auto deadline = std::chrono::steady_clock::now() + timeout;
+        while (std::chrono::steady_clock::now() < deadline) {
+            g_main_context_iteration(nullptr, FALSE);
+
+            std::uint8_t data[DhcpMessage::kMaxSize * 2];
+            const auto bytes_read = ::recv(fd_, data, sizeof(data), 0);
+            if (bytes_read > 0 &&
+                DhcpMessage::Parse(data, bytes_read, reply) &&
+                reply.op == DhcpMessage::Op::kBootReply &&
+                reply.transaction_id == transaction_id_)
+                return true;
+
+            ::usleep(1000);
+        }
+        return false;
+    }
+
+private:
+    int fd_;
+    std::uint16_t port_;
+    std::uint32_t transaction_id_;
+    std::array<std::uint8_t, 16> hardware_address_;
+};
+
+struct DhcpServerFixture : public ::testing::Test {
+    DhcpServerFixture() :
+        client(1),
+        delegate(std::make_shared<MockDhcpServerDelegate>()) {
+    }
+
+    w11tng::DhcpServer::Ptr CreateServer() {
+        auto config = w11tng::DhcpServer::DefaultConfig();
+        config.local_address = ac::IpV4Address::from_string("127.0.0.1");
+        config.pool_address = ac::IpV4Address::from_string("127.0.0.5");
+        config.prefix_length = 8;
+        config.server_port = 0;
+        config.client_port = client.Port();
+        config.configure_interface = false;
+        return w11tng::DhcpServer::Create(delegate, "lo", config);
+    }
+
+    DhcpMessage CreateRequest(const std::string &address = "127.0.0.5") {
+        auto request = client.CreateMessage(DhcpMessage::Type::kRequest);
+        request.SetAddressOption(DhcpMessage::Option::kRequestedAddress, ac::IpV4Address::from_string(address));
+        request.SetAddressOption(DhcpMessage::Option::kServerIdentifier, ac::IpV4Address::from_string("127.0.0.1"));
+        return request;
+    }
+
+    ScriptedClient client;
+    std::shared_ptr<MockDhcpServerDelegate> delegate;
+};
+}
+
+TEST_F(DhcpServerFixture, AssignsPoolAddress) {
+    EXPECT_CALL(*delegate, OnDhcpAddressAssigned(ac::IpV4Address::from_string("127.0.0.1"),
+                                                 ac::IpV4Address::from_string("127.0.0.5")))
+            .Times(1);
+    EXPECT_CALL(*delegate, OnDhcpTerminated()).Times(0);
+
+    auto server = CreateServer();
+    ASSERT_NE(0, server->Port());
+
+    client.Send(client.CreateMessage(DhcpMessage::Type::kDiscover), server->Port());
+
+    DhcpMessage offer;
+    ASSERT_TRUE(client.Receive(offer));
+    EXPECT_EQ(DhcpMessage::Type::kOffer, offer.MessageType());
+    EXPECT_EQ("127.0.0.5", offer.your_address.to_string());
+    EXPECT_EQ("127.0.0.1", offer.AddressOption(DhcpMessage::Option::kServerIdentifier).to_string());
+    EXPECT_EQ("255.0.0.0", offer.AddressOption(DhcpMessage::Option::kSubnetMask).to_string());
+    EXPECT_EQ(w11tng::DhcpServer::kDefaultLeaseTime.count(),
+              offer.Uint32Option(DhcpMessage::Option::kLeaseTime));
+
+    client.Send(CreateRequest(), server->Port());
+
+    DhcpMessage ack;
+    ASSERT_TRUE(client.Receive(ack));
+    EXPECT_EQ(DhcpMessage::Type::kAck, ack.MessageType());
+    EXPECT_EQ("127.0.0.5", ack.your_address.to_string());
+}
+
+TEST_F(DhcpServerFixture, RenewalIsNotReportedAgain) {
+    EXPECT_CALL(*delegate, OnDhcpAddressAssigned(_, _)).Times(1);
+
+    auto server = CreateServer();
+
+    client.Send(CreateRequest(), server->Port());
+    DhcpMessage ack;
+    ASSERT_TRUE(client.Receive(ack));
+    EXPECT_EQ(DhcpMessage::Type::kAck, ack.MessageType());
+
+    // Renewing clients only fill in their current address
+    auto renew = client.CreateMessage(DhcpMessage::Type::kRequest);
+    renew.client_address = ac::IpV4Address::from_string("127.0.0.5");
+    client.Send(renew, server->Port());
+
+    ASSERT_TRUE(client.Receive(ack));
+    EXPECT_EQ(DhcpMessage::Type::kAck, ack.MessageType());
+}
+
+TEST_F(DhcpServerFixture, RejectsAddressOutsideOfPool) {
+    EXPECT_CALL(*delegate, OnDhcpAddressAssigned(_, _)).Times(0);
+
+    auto server = CreateServer();
+
+    client.Send(CreateRequest("127.0.0.9"), server->Port());
+
+    DhcpMessage nak;
+    ASSERT_TRUE(client.Receive(nak));
+    EXPECT_EQ(DhcpMessage::Type::kNak, nak.MessageType());
+}
+
+TEST_F(DhcpServerFixture, IgnoresRequestsForOtherServers) {
+    EXPECT_CALL(*delegate, OnDhcpAddressAssigned(_, _)).Times(0);
+
+    auto server = CreateServer();
+
+    auto request = CreateRequest();
+    request.SetAddressOption(DhcpMessage::Option::kServerIdentifier, ac::IpV4Address::from_string("127.0.0.2"));
+    client.Send(request, server->Port());
+
+    DhcpMessage reply;
+    EXPECT_FALSE(client.Receive(reply, std::chrono::milliseconds{100}));
+}
+
+TEST_F(DhcpServerFixture, OnlyAddressIsHandedOutOnce) {
+    EXPECT_CALL(*delegate, OnDhcpAddressAssigned(_, _)).Times(2);
+
+    auto server = CreateServer();
+
+    client.Send(CreateRequest(), server->Port());
+    DhcpMessage reply;
+    ASSERT_TRUE(client.Receive(reply));
+    EXPECT_EQ(DhcpMessage::Type::kAck, reply.MessageType());
+
+    client.SetHardwareAddress(2);
+    client.Send(client.CreateMessage(DhcpMessage::Type::kDiscover), server->Port());
+    EXPECT_FALSE(client.Receive(reply, std::chrono::milliseconds{100}));
+
+    client.SetHardwareAddress(1);
+    client.Send(client.CreateMessage(DhcpMessage::Type::kRelease), server->Port());
+
+    client.SetHardwareAddress(2);
+    client.Send(CreateRequest(), server->Port());
+    ASSERT_TRUE(client.Receive(reply));
+    EXPECT_EQ(DhcpMessage::Type::kAck, reply.MessageType());
+    EXPECT_EQ("02:00:00:00:00:02", reply.HardwareAddressToString());
+}
+
+TEST(DhcpServer, ReportsFailureToStart) {
+    auto delegate = std::make_shared<MockDhcpServerDelegate>();
+    EXPECT_CALL(*delegate, OnDhcpTerminated()).Times(1);
+
+    auto config = w11tng::DhcpServer::DefaultConfig();
+    config.server_port = 0;
+    config.configure_interface = false;
+    auto server = w11tng::DhcpServer::Create(delegate, "doesnotexist0", config);
+
+    EXPECT_EQ(0, server->Port());
+
+    ac::testing::RunMainLoopIteration();
+}
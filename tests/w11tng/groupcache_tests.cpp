@@ -0,0 +1,183 @@
+/*
+ * Copyright (C) 2016 Canonical, Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 3, as published
+ * by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranties of
+ * MERCHANTABILITY, SATISFACTORY QUALITY, or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <sys/stat.h>
+
+#include <fstream>
+
+#include <gtest/gtest.h>
+
+#include <boost/filesystem.hpp>
+
+#include <w11tng/groupcache.h>
+
+using namespace ::testing;
+
+namespace {
+using GroupCache = w11tng::GroupCache;
+
+struct GroupCacheFixture : public ::testing::Test {
+    GroupCacheFixture() :
+        directory(boost::filesystem::temp_directory_path() /
+                  boost::filesystem::unique_path("groupcache-%%%%%%")),
+        path((directory / "p2p-groups").string()) {
+    }
+
+    ~GroupCacheFixture() {
+        boost::filesystem::remove_all(directory);
+    }
+
+    GroupCache::Entry CreateEntry(const std::string &peer) {
+        GroupCache::Entry entry;
+        entry.peer = peer;
+        entry.role = "client";
+        entry.ssid = "DIRECT-ab Living Room";
+        entry.psk = std::string("\x00\x01\xfe\xff\x20", 5);
+        entry.frequency = 2437;
+        entry.address = ac::IpV4Address::from_string("192.168.7.5");
+        entry.group_bssid = "aa:bb:cc:dd:ff:01";
+        return entry;
+    }
+
+    boost::filesystem::path directory;
+    std::string path;
+};
+}
+
+TEST_F(GroupCacheFixture, LoadFailsWithoutFile) {
+    GroupCache cache(path);
+    EXPECT_FALSE(cache.Load());
+    EXPECT_EQ(0, cache.Size());
+}
+
+TEST_F(GroupCacheFixture, LookupFindsStoredPeer) {
+    GroupCache cache(path);
+    cache.Store(CreateEntry("aa:bb:cc:dd:ee:01"));
+
+    GroupCache::Entry entry;
+    EXPECT_TRUE(cache.Lookup("aa:bb:cc:dd:ee:01", entry));
+    EXPECT_EQ(CreateEntry("aa:bb:cc:dd:ee:01"), entry);
+    EXPECT_FALSE(cache.Lookup("aa:bb:cc:dd:ee:02", entry));
+
+    cache.Remove("aa:bb:cc:dd:ee:01");
+    EXPECT_FALSE(cache.Lookup("aa:bb:cc:dd:ee:01", entry));
+}
+
+TEST_F(GroupCacheFixture, StoreReplacesEntryOfPeer) {
+    GroupCache cache(path);
+    cache.Store(CreateEntry("aa:bb:cc:dd:ee:01"));
+
+    auto updated = CreateEntry("aa:bb:cc:dd:ee:01");
+    updated.role = "GO";
+    updated.passphrase = "secret";
+    cache.Store(updated);
+
+    EXPECT_EQ(1, cache.Size());
+
+    GroupCache::Entry entry;
+    ASSERT_TRUE(cache.Lookup("aa:bb:cc:dd:ee:01", entry));
+    EXPECT_EQ("GO", entry.role);
+    EXPECT_EQ("secret", entry.passphrase);
+}
+
+TEST_F(GroupCacheFixture, DropsLeastRecentlyUsedEntry) {
+    GroupCache cache(path, 2);
+    cache.Store(CreateEntry("aa:bb:cc:dd:ee:01"));
+    cache.Store(CreateEntry("aa:bb:cc:dd:ee:02"));
+    // Using the first peer again makes the second one the oldest
+    cache.Store(CreateEntry("aa:bb:cc:dd:ee:01"));
+    cache.Store(CreateEntry("aa:bb:cc:dd:ee:03"));
+
+    EXPECT_EQ(2, cache.Size());
+
+    GroupCache::Entry entry;
+    EXPECT_TRUE(cache.Lookup("aa:bb:cc:dd:ee:01", entry));
+    EXPECT_FALSE(cache.Lookup("aa:bb:cc:dd:ee:02", entry));
+    EXPECT_TRUE(cache.Lookup("aa:bb:cc:dd:ee:03", entry));
+}
+
+TEST_F(GroupCacheFixture, LookupMarksEntryAsMostRecentlyUsed) {
+    GroupCache cache(path, 2);
+    cache.Store(CreateEntry("aa:bb:cc:dd:ee:01"));
+    cache.Store(CreateEntry("aa:bb:cc:dd:ee:02"));
+
+    // Reconnecting to the first peer makes the second one the oldest
+    GroupCache::Entry entry;
+    ASSERT_TRUE(cache.Lookup("aa:bb:cc:dd:ee:01", entry));
+    cache.Store(CreateEntry("aa:bb:cc:dd:ee:03"));
+
+    EXPECT_TRUE(cache.Lookup("aa:bb:cc:dd:ee:01", entry));
+    EXPECT_FALSE(cache.Lookup("aa:bb:cc:dd:ee:02", entry));
+    EXPECT_TRUE(cache.Lookup("aa:bb:cc:dd:ee:03", entry));
+}
+
+TEST_F(GroupCacheFixture, SurvivesSaveAndLoad) {
+    GroupCache cache(path);
+    auto owned = CreateEntry("aa:bb:cc:dd:ee:01");
+    owned.role = "GO";
+    owned.passphrase = "with spaces";
+    owned.psk.clear();
+    owned.address = ac::IpV4Address::from_string("192.168.7.1");
+    cache.Store(owned);
+    cache.Store(CreateEntry("aa:bb:cc:dd:ee:02"));
+
+    // The directory doesn't exist yet so saving has to create it
+    ASSERT_TRUE(cache.Save());
+
+    struct stat st;
+    ASSERT_EQ(0, ::stat(path.c_str(), &st));
+    EXPECT_EQ(0600, st.st_mode & 0777);
+
+    GroupCache loaded(path);
+    ASSERT_TRUE(loaded.Load());
+    EXPECT_EQ(2, loaded.Size());
+
+    GroupCache::Entry entry;
+    ASSERT_TRUE(loaded.Lookup("aa:bb:cc:dd:ee:01", entry));
+    EXPECT_EQ(owned, entry);
+    ASSERT_TRUE(loaded.Lookup("aa:bb:cc:dd:ee:02", entry));
+    EXPECT_EQ(CreateEntry("aa:bb:cc:dd:ee:02"), entry);
+
+    // Order of use is kept as well
+    GroupCache bounded(path, 1);
+    ASSERT_TRUE(bounded.Load());
+    ASSERT_TRUE(bounded.Lookup("aa:bb:cc:dd:ee:02", entry));
+}
+
+TEST_F(GroupCacheFixture, IgnoresMalformedLines) {
+    boost::filesystem::create_directories(directory);
+    {
+        std::ofstream out(path);
+        out << "# comment" << std::endl;
+        out << "aa:bb:cc:dd:ee:01 client" << std::endl;
+        out << "aa:bb:cc:dd:ee:02 client 2437 zz - - 192.168.7.5" << std::endl;
+        out << "aa:bb:cc:dd:ee:03 GO 5180 4449524543542d6162 736563726574 - 192.168.7.1" << std::endl;
+    }
+
+    GroupCache cache(path);
+    ASSERT_TRUE(cache.Load());
+    EXPECT_EQ(1, cache.Size());
+
+    GroupCache::Entry entry;
+    ASSERT_TRUE(cache.Lookup("aa:bb:cc:dd:ee:03", entry));
+    EXPECT_EQ("DIRECT-ab", entry.ssid);
+    EXPECT_EQ("secret", entry.passphrase);
+    EXPECT_EQ("", entry.psk);
+    EXPECT_EQ(5180, entry.frequency);
+    // Written before we kept the BSSID of the group
+    EXPECT_EQ("", entry.group_bssid);
+}
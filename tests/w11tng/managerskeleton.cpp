@@ -0,0 +1,52 @@
+/*
+ * Copyright (C) 2016 Canonical, Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 3, as published
+ * by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranties of
+ * MERCHANTABILITY, SATISFACTORY QUALITY, or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "managerskeleton.h"
+
+namespace {
+// The generated setters want a NULL terminated array of C strings
+std::vector<const gchar*> ToStrv(const std::vector<std::string> &values) {
+    std::vector<const gchar*> strv;
+    for (const auto &value : values)
+        strv.push_back(value.c_str());
+    strv.push_back(nullptr);
+    return strv;
+}
+}
+
+namespace w11tng {
+namespace testing {
+
+ManagerSkeleton::ManagerSkeleton(const std::string &object_path) :
+    BaseSkeleton(wpa_supplicant_fi_w1_wpa_supplicant1_skeleton_new(), object_path) {
+}
+
+ManagerSkeleton::~ManagerSkeleton() {
+}
+
+void ManagerSkeleton::SetCapabilities(const std::vector<std::string> &capabilities) {
+    const auto value = ToStrv(capabilities);
+    wpa_supplicant_fi_w1_wpa_supplicant1_set_capabilities(skeleton_.get(), value.data());
+}
+
+void ManagerSkeleton::SetInterfaces(const std::vector<std::string> &interfaces) {
+    const auto value = ToStrv(interfaces);
+    wpa_supplicant_fi_w1_wpa_supplicant1_set_interfaces(skeleton_.get(), value.data());
+}
+
+} // namespace testing
+} // namespace w11tng
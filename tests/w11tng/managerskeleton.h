@@ -15,37 +15,29 @@
  *
  */
 
-#ifndef W11TNG_DHCPLEASEPARSER_H_
-#define W11TNG_DHCPLEASEPARSER_H_
+#ifndef W11TNG_TESTING_MANAGER_SKELETON_H_
+#define W11TNG_TESTING_MANAGER_SKELETON_H_
 
 #include <string>
 #include <vector>
 
-#include <ac/glib_wrapper.h>
-
-#include <ac/ip_v4_address.h>
+#include "baseskeleton.h"
 
 namespace w11tng {
-class DhcpLeaseInfo {
+namespace testing {
+
+class ManagerSkeleton : public BaseSkeleton<WpaSupplicantFiW1Wpa_supplicant1> {
 public:
-    std::string Interface() const { return interface_; }
-    ac::IpV4Address FixedAddress() const { return fixed_address_; }
-    ac::IpV4Address Gateway() const { return gateway_; }
+    typedef std::shared_ptr<ManagerSkeleton> Ptr;
 
-private:
-    std::string interface_;
-    ac::IpV4Address fixed_address_;
-    ac::IpV4Address gateway_;
+    ManagerSkeleton(const std::string &object_path);
+    ~ManagerSkeleton();
 
-    friend class DhcpLeaseParser;
+    void SetCapabilities(const std::vector<std::string> &capabilities);
+    void SetInterfaces(const std::vector<std::string> &interfaces);
 };
 
-std::ostream& operator<<(std::ostream& out, const DhcpLeaseInfo &lease);
-
-class DhcpLeaseParser {
-public:
-    static std::vector<DhcpLeaseInfo> FromFile(const std::string &path);
-};
-} // w11tng
+} // namespace testing
+} // namespace w11tng
 
 #endif
@@ -20,12 +20,15 @@
 
 #include "ac/keep_alive.h"
 #include "ac/logger.h"
+#include "ac/dbus/helpers.h"
 
 #include "p2pdeviceskeleton.h"
 
 namespace w11tng {
 namespace testing {
 
+constexpr const char *P2PDeviceSkeleton::kPersistentGroupPath;
+
 P2PDeviceSkeleton::Ptr P2PDeviceSkeleton::FinalizeConstruction() {
     auto sp = shared_from_this();
 
@@ -37,6 +40,22 @@ P2PDeviceSkeleton::Ptr P2PDeviceSkeleton::FinalizeConstruction() {
          G_CALLBACK(&P2PDeviceSkeleton::OnHandleStopFind), new ac::WeakKeepAlive<P2PDeviceSkeleton>(shared_from_this()),
          [](gpointer data, GClosure *) { delete static_cast<ac::WeakKeepAlive<P2PDeviceSkeleton>*>(data); }, GConnectFlags(0));
 
+    g_signal_connect_data(skeleton_.get(), "handle-connect",
+         G_CALLBACK(&P2PDeviceSkeleton::OnHandleConnect), new ac::WeakKeepAlive<P2PDeviceSkeleton>(shared_from_this()),
+         [](gpointer data, GClosure *) { delete static_cast<ac::WeakKeepAlive<P2PDeviceSkeleton>*>(data); }, GConnectFlags(0));
+
+    g_signal_connect_data(skeleton_.get(), "handle-invite",
+         G_CALLBACK(&P2PDeviceSkeleton::OnHandleInvite), new ac::WeakKeepAlive<P2PDeviceSkeleton>(shared_from_this()),
+         [](gpointer data, GClosure *) { delete static_cast<ac::WeakKeepAlive<P2PDeviceSkeleton>*>(data); }, GConnectFlags(0));
+
+    g_signal_connect_data(skeleton_.get(), "handle-add-persistent-group",
+         G_CALLBACK(&P2PDeviceSkeleton::OnHandleAddPersistentGroup), new ac::WeakKeepAlive<P2PDeviceSkeleton>(shared_from_this()),
+         [](gpointer data, GClosure *) { delete static_cast<ac::WeakKeepAlive<P2PDeviceSkeleton>*>(data); }, GConnectFlags(0));
+
+    g_signal_connect_data(skeleton_.get(), "handle-remove-persistent-group",
+         G_CALLBACK(&P2PDeviceSkeleton::OnHandleRemovePersistentGroup), new ac::WeakKeepAlive<P2PDeviceSkeleton>(shared_from_this()),
+         [](gpointer data, GClosure *) { delete static_cast<ac::WeakKeepAlive<P2PDeviceSkeleton>*>(data); }, GConnectFlags(0));
+
     return sp;
 }
 
@@ -87,6 +106,120 @@ gboolean P2PDeviceSkeleton::OnHandleStopFind(WpaSupplicantInterfaceP2PDevice *de
     return TRUE;
 }
 
+gboolean P2PDeviceSkeleton::OnHandleConnect(WpaSupplicantInterfaceP2PDevice *device, GDBusMethodInvocation *invocation, GVariant *properties, gpointer user_data) {
+    auto inst = static_cast<ac::WeakKeepAlive<P2PDeviceSkeleton>*>(user_data)->GetInstance().lock();
+
+    AC_DEBUG("");
+
+    if (not inst) {
+        g_dbus_method_invocation_return_error(invocation, G_DBUS_ERROR, G_DBUS_ERROR_FAILED, "Invalid state");
+        return TRUE;
+    }
+
+    std::string peer_path;
+    ac::dbus::Helpers::ParseDictionary(properties, [&](const std::string &name, GVariant *value) {
+        if (name == "peer")
+            peer_path = g_variant_get_string(g_variant_get_variant(value), nullptr);
+    });
+
+    if (auto sp = inst->delegate_.lock())
+        sp->OnConnect(peer_path);
+
+    // With PBC there is no generated PIN to hand back
+    wpa_supplicant_interface_p2_pdevice_complete_connect(device, invocation, "");
+
+    return TRUE;
+}
+
+gboolean P2PDeviceSkeleton::OnHandleInvite(WpaSupplicantInterfaceP2PDevice *device, GDBusMethodInvocation *invocation, GVariant *properties, gpointer user_data) {
+    auto inst = static_cast<ac::WeakKeepAlive<P2PDeviceSkeleton>*>(user_data)->GetInstance().lock();
+
+    AC_DEBUG("");
+
+    if (not inst) {
+        g_dbus_method_invocation_return_error(invocation, G_DBUS_ERROR, G_DBUS_ERROR_FAILED, "Invalid state");
+        return TRUE;
+    }
+
+    std::string peer_path, persistent_group_path;
+    ac::dbus::Helpers::ParseDictionary(properties, [&](const std::string &name, GVariant *value) {
+        const auto v = g_variant_get_variant(value);
+        if (name == "peer")
+            peer_path = g_variant_get_string(v, nullptr);
+        else if (name == "persistent_group_object")
+            persistent_group_path = g_variant_get_string(v, nullptr);
+    });
+
+    if (auto sp = inst->delegate_.lock())
+        sp->OnInvite(peer_path, persistent_group_path);
+
+    g_dbus_method_invocation_return_value(invocation, nullptr);
+
+    return TRUE;
+}
+
+gboolean P2PDeviceSkeleton::OnHandleAddPersistentGroup(WpaSupplicantInterfaceP2PDevice *device, GDBusMethodInvocation *invocation, GVariant *properties, gpointer user_data) {
+    auto inst = static_cast<ac::WeakKeepAlive<P2PDeviceSkeleton>*>(user_data)->GetInstance().lock();
+
+    AC_DEBUG("");
+
+    if (not inst) {
+        g_dbus_method_invocation_return_error(invocation, G_DBUS_ERROR, G_DBUS_ERROR_FAILED, "Invalid state");
+        return TRUE;
+    }
+
+    auto bytes = [](GVariant *v) {
+        gsize length = 0;
+        auto data = static_cast<const char*>(g_variant_get_fixed_array(v, &length, 1));
+        return std::string(data, length);
+    };
+
+    P2PDeviceStub::PersistentGroup group;
+    group.group_owner = false;
+    group.frequency = 0;
+
+    ac::dbus::Helpers::ParseDictionary(properties, [&](const std::string &name, GVariant *value) {
+        const auto v = g_variant_get_variant(value);
+        if (name == "ssid")
+            group.ssid = bytes(v);
+        else if (name == "psk" && g_variant_is_of_type(v, G_VARIANT_TYPE_STRING))
+            group.passphrase = g_variant_get_string(v, nullptr);
+        else if (name == "psk")
+            group.psk = bytes(v);
+        else if (name == "mode")
+            group.group_owner = (g_variant_get_int32(v) == 3);
+        else if (name == "bssid")
+            group.bssid = g_variant_get_string(v, nullptr);
+        else if (name == "frequency")
+            group.frequency = g_variant_get_int32(v);
+    });
+
+    if (auto sp = inst->delegate_.lock())
+        sp->OnAddPersistentGroup(group);
+
+    g_dbus_method_invocation_return_value(invocation, g_variant_new("(o)", kPersistentGroupPath));
+
+    return TRUE;
+}
+
+gboolean P2PDeviceSkeleton::OnHandleRemovePersistentGroup(WpaSupplicantInterfaceP2PDevice *device, GDBusMethodInvocation *invocation, const gchar *path, gpointer user_data) {
+    auto inst = static_cast<ac::WeakKeepAlive<P2PDeviceSkeleton>*>(user_data)->GetInstance().lock();
+
+    AC_DEBUG("");
+
+    if (not inst) {
+        g_dbus_method_invocation_return_error(invocation, G_DBUS_ERROR, G_DBUS_ERROR_FAILED, "Invalid state");
+        return TRUE;
+    }
+
+    if (auto sp = inst->delegate_.lock())
+        sp->OnRemovePersistentGroup(std::string(path));
+
+    g_dbus_method_invocation_return_value(invocation, nullptr);
+
+    return TRUE;
+}
+
 void P2PDeviceSkeleton::EmitDeviceFound(const std::string &path) {
     wpa_supplicant_interface_p2_pdevice_emit_device_found(skeleton_.get(), path.c_str());
 }
@@ -143,6 +276,13 @@ void P2PDeviceSkeleton::EmitGroupRequest(const std::string &path, int dev_passwd
     wpa_supplicant_interface_p2_pdevice_emit_gonegotiation_request(skeleton_.get(), path.c_str(), dev_passwd_id);
 }
 
+void P2PDeviceSkeleton::EmitInvitationResult(int status) {
+    auto builder = g_variant_builder_new(G_VARIANT_TYPE("a{sv}"));
+    g_variant_builder_add(builder, "{sv}", "status", g_variant_new_int32(status));
+    auto value = g_variant_builder_end(builder);
+    wpa_supplicant_interface_p2_pdevice_emit_invitation_result(skeleton_.get(), value);
+}
+
 void P2PDeviceSkeleton::SetDelegate(const std::weak_ptr<Delegate> &delegate) {
     delegate_ = delegate;
 }
@@ -36,8 +36,14 @@ public:
     public:
         virtual void OnFind() = 0;
         virtual void OnStopFind() = 0;
+        virtual void OnConnect(const std::string &peer_path) = 0;
+        virtual void OnInvite(const std::string &peer_path, const std::string &persistent_group_path) = 0;
+        virtual void OnAddPersistentGroup(const P2PDeviceStub::PersistentGroup &group) = 0;
+        virtual void OnRemovePersistentGroup(const std::string &path) = 0;
     };
 
+    static constexpr const char *kPersistentGroupPath{"/persistent_group_1"};
+
     static Ptr Create(const std::string &object_path);
 
     ~P2PDeviceSkeleton();
@@ -53,6 +59,7 @@ public:
     void EmitGroupStarted(const std::string &group_path, const std::string &interface_path, const std::string &role);
     void EmitGroupFinished(const std::string &group_path, const std::string &interface_path);
     void EmitGroupRequest(const std::string &path, int dev_passwd_id);
+    void EmitInvitationResult(int status);
 
 private:
     P2PDeviceSkeleton(const std::string &object_path);
@@ -61,6 +68,10 @@ private:
 private:
     static gboolean OnHandleFind(WpaSupplicantInterfaceP2PDevice *device, GDBusMethodInvocation *invocation, GVariant *properties, gpointer user_data);
     static gboolean OnHandleStopFind(WpaSupplicantInterfaceP2PDevice *device, GDBusMethodInvocation *invocation, gpointer user_data);
+    static gboolean OnHandleConnect(WpaSupplicantInterfaceP2PDevice *device, GDBusMethodInvocation *invocation, GVariant *properties, gpointer user_data);
+    static gboolean OnHandleInvite(WpaSupplicantInterfaceP2PDevice *device, GDBusMethodInvocation *invocation, GVariant *properties, gpointer user_data);
+    static gboolean OnHandleAddPersistentGroup(WpaSupplicantInterfaceP2PDevice *device, GDBusMethodInvocation *invocation, GVariant *properties, gpointer user_data);
+    static gboolean OnHandleRemovePersistentGroup(WpaSupplicantInterfaceP2PDevice *device, GDBusMethodInvocation *invocation, const gchar *path, gpointer user_data);
 
 private:
     std::weak_ptr<Delegate> delegate_;
@@ -50,6 +50,8 @@ public:
     MOCK_METHOD3(OnGroupStarted, void(const std::string&, const std::string&, const std::string&));
     MOCK_METHOD2(OnGroupFinished, void(const std::string&, const std::string&));
     MOCK_METHOD2(OnGroupRequest, void(const std::string&, int));
+    MOCK_METHOD1(OnPersistentGroupAdded, void(const std::string&));
+    MOCK_METHOD1(OnInvitationResult, void(w11tng::P2PDeviceStub::Status));
     MOCK_METHOD0(OnP2PDeviceChanged, void());
     MOCK_METHOD0(OnP2PDeviceReady, void());
 };
@@ -58,6 +60,10 @@ class MockP2PDeviceSkeletonDelegate : public w11tng::testing::P2PDeviceSkeleton:
 public:
     MOCK_METHOD0(OnFind, void());
     MOCK_METHOD0(OnStopFind, void());
+    MOCK_METHOD1(OnConnect, void(const std::string&));
+    MOCK_METHOD2(OnInvite, void(const std::string&, const std::string&));
+    MOCK_METHOD1(OnAddPersistentGroup, void(const w11tng::P2PDeviceStub::PersistentGroup&));
+    MOCK_METHOD1(OnRemovePersistentGroup, void(const std::string&));
 };
 }
 
@@ -222,3 +228,118 @@ TEST_F(P2PDeviceStubFixture, FindAndTimeoutHandling) {
     // call the stub issues after the timeout.
     ac::testing::RunMainLoop(std::chrono::seconds{2});
 }
+
+TEST_F(P2PDeviceStubFixture, PersistentGroupReinvocation) {
+    auto stub_delegate = std::make_shared<NiceMock<MockP2PDeviceStubDelegate>>();
+    auto skeleton_delegate = std::make_shared<MockP2PDeviceSkeletonDelegate>();
+
+    const std::string group_path = w11tng::testing::P2PDeviceSkeleton::kPersistentGroupPath;
+
+    w11tng::P2PDeviceStub::PersistentGroup added;
+
+    EXPECT_CALL(*skeleton_delegate, OnAddPersistentGroup(_))
+            .Times(1)
+            .WillRepeatedly(SaveArg<0>(&added));
+    EXPECT_CALL(*stub_delegate, OnPersistentGroupAdded(group_path)).Times(1);
+    EXPECT_CALL(*skeleton_delegate, OnInvite(std::string("/peer_1"), group_path)).Times(1);
+    EXPECT_CALL(*skeleton_delegate, OnRemovePersistentGroup(group_path)).Times(1);
+    EXPECT_CALL(*stub_delegate, OnPeerConnectFailed()).Times(0);
+
+    auto skeleton = w11tng::testing::P2PDeviceSkeleton::Create("/device_1");
+    skeleton->SetDelegate(skeleton_delegate);
+
+    ac::testing::RunMainLoop(std::chrono::seconds{1});
+
+    auto stub = w11tng::P2PDeviceStub::Create("/device_1", stub_delegate);
+
+    ac::testing::RunMainLoop(std::chrono::seconds{1});
+
+    ASSERT_TRUE(stub->Connected());
+
+    w11tng::P2PDeviceStub::PersistentGroup group;
+    group.group_owner = false;
+    group.bssid = "aa:bb:cc:dd:ee:ff";
+    group.ssid = "DIRECT-ab";
+    group.psk = std::string("\x00\x01\xfe\xff", 4);
+    group.frequency = 2437;
+
+    EXPECT_TRUE(stub->AddPersistentGroup(group));
+
+    ac::testing::RunMainLoop(std::chrono::seconds{1});
+
+    EXPECT_FALSE(added.group_owner);
+    EXPECT_EQ(group.bssid, added.bssid);
+    EXPECT_EQ(group.ssid, added.ssid);
+    EXPECT_EQ("", added.passphrase);
+    EXPECT_EQ(group.psk, added.psk);
+    // Only the group owner picks the channel
+    EXPECT_EQ(0, added.frequency);
+
+    EXPECT_TRUE(stub->Invite("/peer_1", group_path));
+    EXPECT_FALSE(stub->Invite("/peer_1", ""));
+
+    stub->RemovePersistentGroup(group_path);
+
+    ac::testing::RunMainLoop(std::chrono::seconds{1});
+}
+
+TEST_F(P2PDeviceStubFixture, PersistentGroupOwnerUsesPassphrase) {
+    auto stub_delegate = std::make_shared<NiceMock<MockP2PDeviceStubDelegate>>();
+    auto skeleton_delegate = std::make_shared<NiceMock<MockP2PDeviceSkeletonDelegate>>();
+
+    w11tng::P2PDeviceStub::PersistentGroup added;
+
+    EXPECT_CALL(*skeleton_delegate, OnAddPersistentGroup(_))
+            .Times(1)
+            .WillRepeatedly(SaveArg<0>(&added));
+
+    auto skeleton = w11tng::testing::P2PDeviceSkeleton::Create("/device_1");
+    skeleton->SetDelegate(skeleton_delegate);
+
+    ac::testing::RunMainLoop(std::chrono::seconds{1});
+
+    auto stub = w11tng::P2PDeviceStub::Create("/device_1", stub_delegate);
+
+    ac::testing::RunMainLoop(std::chrono::seconds{1});
+
+    w11tng::P2PDeviceStub::PersistentGroup group;
+    group.group_owner = true;
+    group.ssid = "DIRECT-cd";
+    group.passphrase = "secret";
+    group.psk = std::string("\x00\x01", 2);
+    group.frequency = 5180;
+
+    EXPECT_TRUE(stub->AddPersistentGroup(group));
+
+    ac::testing::RunMainLoop(std::chrono::seconds{1});
+
+    EXPECT_TRUE(added.group_owner);
+    EXPECT_EQ("", added.bssid);
+    EXPECT_EQ("secret", added.passphrase);
+    EXPECT_EQ("", added.psk);
+    EXPECT_EQ(5180, added.frequency);
+}
+
+TEST_F(P2PDeviceStubFixture, InvitationResult) {
+    auto delegate = std::make_shared<NiceMock<MockP2PDeviceStubDelegate>>();
+
+    InSequence s;
+    EXPECT_CALL(*delegate, OnInvitationResult(w11tng::P2PDeviceStub::Status::kSuccess)).Times(1);
+    EXPECT_CALL(*delegate, OnInvitationResult(w11tng::P2PDeviceStub::Status::kUnknownP2PGroup)).Times(1);
+    // A negative status means the peer didn't answer at all
+    EXPECT_CALL(*delegate, OnInvitationResult(w11tng::P2PDeviceStub::Status::kUnknown)).Times(1);
+
+    auto skeleton = w11tng::testing::P2PDeviceSkeleton::Create("/device_1");
+
+    ac::testing::RunMainLoop(std::chrono::seconds{1});
+
+    auto stub = w11tng::P2PDeviceStub::Create("/device_1", delegate);
+
+    ac::testing::RunMainLoop(std::chrono::seconds{1});
+
+    skeleton->EmitInvitationResult(0);
+    skeleton->EmitInvitationResult(8);
+    skeleton->EmitInvitationResult(-1);
+
+    ac::testing::RunMainLoop(std::chrono::seconds{1});
+}
@@ -60,8 +60,11 @@ static gboolean OnSignalRaised(gpointer user_data) {
 
 int main(int argc, char **argv) {
     std::string remote_address;
+    std::string replay_file;
     int port = 0;
     bool debug = false;
+    bool replay_fast = false;
+    bool replay_once = false;
 
     g_unix_signal_add(SIGINT, OnSignalRaised, nullptr);
     g_unix_signal_add(SIGTERM, OnSignalRaised, nullptr);
@@ -76,7 +79,13 @@ int main(int argc, char **argv) {
         ("port,p",
             boost::program_options::value<int>(&port), "Port to use")
         ("debug,d",
-            boost::program_options::bool_switch(&debug), "Enable verbose debug output");
+            boost::program_options::bool_switch(&debug), "Enable verbose debug output")
+        ("replay",
+            boost::program_options::value<std::string>(&replay_file), "Stream this H.264 file instead of the screen")
+        ("replay-fast",
+            boost::program_options::bool_switch(&replay_fast), "Send the replayed file as fast as possible")
+        ("replay-once",
+            boost::program_options::bool_switch(&replay_once), "Stop at the end of the replayed file");
 
     boost::program_options::variables_map vm;
     try {
@@ -105,6 +114,17 @@ int main(int argc, char **argv) {
     if (debug)
         ac::Log().Init(ac::Logger::Severity::kDebug);
 
+    // The media manager factory picks up what to stream from the
+    // environment.
+    if (replay_file.length() > 0) {
+        setenv("MIRACAST_SOURCE_TYPE", "replay", 1);
+        setenv("AETHERCAST_REPLAY_FILE", replay_file.c_str(), 1);
+        if (replay_fast)
+            setenv("AETHERCAST_REPLAY_PACE", "fast", 1);
+        if (replay_once)
+            setenv("AETHERCAST_REPLAY_NO_LOOP", "1", 1);
+    }
+
     source = ac::tools::SimpleSource::Create(remote_address, port);
     source->Start();
 
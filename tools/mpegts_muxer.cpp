@@ -17,43 +17,134 @@
  *
  */
 
+#include <sys/mman.h>
 #include <sys/types.h>
 #include <sys/stat.h>
 #include <fcntl.h>
 #include <memory.h>
+#include <unistd.h>
 
 #include <memory>
 #include <chrono>
-#include <thread>
 #include <iostream>
 #include <string>
 
+#include <boost/program_options.hpp>
+
 #include <ac/logger.h>
 #include <ac/report/reportfactory.h>
 #include <ac/streaming/mpegtspacketizer.h>
+#include <ac/video/utils.h>
 
 namespace {
-static constexpr unsigned int kBufferSize = 100;
+static constexpr int kDefaultFramerate{30};
+// Per spec we need to emit PAT/PMT and PCR updates atleast every 100ms
+static constexpr ac::TimestampUs kTableInterval{100000};
+
+// Hands a slice of the mapped input over to the packetizer without
+// copying it first.
+class MappedBuffer : public ac::video::Buffer {
+public:
+    static ac::video::Buffer::Ptr Create(const uint8_t *data, uint32_t length, ac::TimestampUs timestamp) {
+        auto buffer = std::shared_ptr<MappedBuffer>(new MappedBuffer(data, length));
+        buffer->SetTimestamp(timestamp);
+        return buffer;
+    }
+
+    uint32_t Capacity() const override { return length_; }
+    uint32_t Offset() const override { return 0; }
+    uint32_t Length() const override { return length_; }
+    uint8_t* Data() override { return const_cast<uint8_t*>(data_); }
+    bool IsValid() const override { return data_ != nullptr; }
+
+private:
+    MappedBuffer(const uint8_t *data, uint32_t length) :
+        data_(data),
+        length_(length) {
+    }
+
+    const uint8_t *data_;
+    uint32_t length_;
+};
+
+double ToSeconds(const std::chrono::steady_clock::duration &duration) {
+    return std::chrono::duration_cast<std::chrono::duration<double>>(duration).count();
+}
 }
 
 int main(int argc, char **argv) {
+    std::string input;
+    std::string output;
+    int framerate = kDefaultFramerate;
+
+    boost::program_options::options_description desc("Usage");
+    desc.add_options()
+        ("help,h", "displays this message")
+        ("input,i",
+            boost::program_options::value<std::string>(&input), "H.264 elementary stream to read")
+        ("output,o",
+            boost::program_options::value<std::string>(&output), "MPEG-TS file to write")
+        ("framerate,f",
+            boost::program_options::value<int>(&framerate), "Framerate used to timestamp the access units");
+
+    boost::program_options::positional_options_description positional;
+    positional.add("input", 1);
+    positional.add("output", 1);
+
+    boost::program_options::variables_map vm;
+    try {
+        boost::program_options::store(boost::program_options::command_line_parser(argc, argv)
+                                      .options(desc).positional(positional).run(), vm);
+        boost::program_options::notify(vm);
+    }
+    catch(boost::program_options::error& e) {
+        std::cerr << e.what() << std::endl << std::endl;
+        std::cerr << desc << std::endl;
+        return EXIT_FAILURE;
+    }
 
-    if (argc != 3 || argv[1] == nullptr || argv[2] == nullptr) {
+    if (vm.count("help") || input.length() == 0 || output.length() == 0) {
         std::cout << "Usage: " << std::endl
-                  << " " << argv[0] << " <input> <output>" << std::endl;
-        return -EINVAL;
+                  << " " << argv[0] << " [options] <input> <output>" << std::endl
+                  << desc << std::endl;
+        return vm.count("help") ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
+
+    if (framerate <= 0) {
+        AC_ERROR("Invalid framerate %d", framerate);
+        return EXIT_FAILURE;
     }
 
-    int fin = ::open(argv[1], O_RDONLY);
+    int fin = ::open(input.c_str(), O_RDONLY);
     if (fin < 0) {
-        AC_ERROR("Failed to open input file %s", argv[1]);
-        return -EINVAL;
+        AC_ERROR("Failed to open input file %s", input);
+        return EXIT_FAILURE;
+    }
+
+    struct stat st;
+    if (::fstat(fin, &st) < 0 || st.st_size == 0) {
+        AC_ERROR("Failed to determine size of input file %s", input);
+        ::close(fin);
+        return EXIT_FAILURE;
+    }
+
+    const size_t input_size = st.st_size;
+    void *mapping = ::mmap(nullptr, input_size, PROT_READ, MAP_PRIVATE, fin, 0);
+    ::close(fin);
+
+    if (mapping == MAP_FAILED) {
+        AC_ERROR("Failed to map input file %s: %s", input, ::strerror(errno));
+        return EXIT_FAILURE;
     }
 
-    int fout = ::open(argv[2], O_WRONLY | O_CREAT, 0755);
+    // We go through the whole file once from the beginning to the end
+    ::madvise(mapping, input_size, MADV_SEQUENTIAL);
+
+    int fout = ::open(output.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
     if (fout < 0) {
-        AC_ERROR("Failed to open output file %s", argv[1]);
-        return -EINVAL;
+        AC_ERROR("Failed to open output file %s", output);
+        ::munmap(mapping, input_size);
+        return EXIT_FAILURE;
     }
 
     auto report_factory = ac::report::ReportFactory::Create();
@@ -62,42 +153,72 @@ int main(int argc, char **argv) {
 
     int track_index = packetizer->AddTrack(ac::streaming::MPEGTSPacketizer::TrackFormat{"video/avc"});
 
-    int counter = 0;
+    const uint8_t *data = static_cast<const uint8_t*>(mapping);
+    size_t size = input_size;
+    const uint8_t *au_start = nullptr;
+    size_t au_size = 0;
 
-    while (true) {
-        uint8_t inbuf[kBufferSize];
+    std::uint64_t frames = 0;
+    std::uint64_t bytes_written = 0;
+    ac::TimestampUs last_table_time = -1;
+    std::chrono::steady_clock::duration packetize_time{0};
+    const auto start = std::chrono::steady_clock::now();
+    int result = EXIT_SUCCESS;
 
-        auto bytes_read = ::read(fin, inbuf, kBufferSize);
-        if (bytes_read < 0) {
-            AC_ERROR("Failed to read input data");
-            break;
+    while (ac::video::GetNextAccessUnit(&data, &size, &au_start, &au_size)) {
+        const ac::TimestampUs timestamp = (frames * std::micro::den) / framerate;
+
+        int flags = 0;
+        if (last_table_time < 0 || timestamp - last_table_time >= kTableInterval) {
+            flags = ac::streaming::MPEGTSPacketizer::kEmitPCR |
+                    ac::streaming::MPEGTSPacketizer::kEmitPATandPMT;
+            last_table_time = timestamp;
         }
-        else if (bytes_read == 0)
-            break;
 
-        auto buffer = ac::video::Buffer::Create(bytes_read, ac::Utils::GetNowUs());
-        ::memcpy(buffer->Data(), inbuf, bytes_read);
+        auto buffer = MappedBuffer::Create(au_start, au_size, timestamp);
+        buffer->SetFrameNumber(frames + 1);
 
         ac::video::Buffer::Ptr outbuf;
 
-        int flags = 0;
-        if (!(counter % 100))
-            flags = ac::streaming::MPEGTSPacketizer::kEmitPCR |
-                    ac::streaming::MPEGTSPacketizer::kEmitPATandPMT;
+        const auto before = std::chrono::steady_clock::now();
+        const bool packetized = packetizer->Packetize(track_index, buffer, &outbuf, flags);
+        packetize_time += std::chrono::steady_clock::now() - before;
 
-        packetizer->Packetize(track_index, buffer, &outbuf, flags);
+        if (!packetized) {
+            AC_ERROR("Failed to packetize access unit %d", frames);
+            result = EXIT_FAILURE;
+            break;
+        }
 
-        auto bytes_written = ::write(fout, outbuf->Data(), outbuf->Length());
-        if (bytes_written < 0) {
+        if (::write(fout, outbuf->Data(), outbuf->Length()) < 0) {
             AC_ERROR("Failed to write output data");
+            result = EXIT_FAILURE;
             break;
         }
 
-        counter++;
+        bytes_written += outbuf->Length();
+        frames++;
     }
 
-    ::close(fin);
+    const auto total_time = std::chrono::steady_clock::now() - start;
+
+    ::munmap(mapping, input_size);
     ::close(fout);
 
-    return 0;
+    const double packetize_seconds = ToSeconds(packetize_time);
+    const double total_seconds = ToSeconds(total_time);
+
+    std::cout << "Access units:   " << frames << " ("
+              << static_cast<double>(frames) / framerate << " s of video)" << std::endl
+              << "Input:          " << input_size << " bytes" << std::endl
+              << "Output:         " << bytes_written << " bytes ("
+              << (input_size > 0 ? 100.0 * (bytes_written - input_size) / input_size : 0.0)
+              << "% overhead)" << std::endl
+              << "Packetizing:    " << packetize_seconds << " s, "
+              << (packetize_seconds > 0 ? input_size / packetize_seconds / 1e6 : 0.0) << " MB/s, "
+              << (packetize_seconds > 0 ? frames / packetize_seconds : 0.0) << " frames/s" << std::endl
+              << "Total:          " << total_seconds << " s, "
+              << (total_seconds > 0 ? input_size / total_seconds / 1e6 : 0.0) << " MB/s" << std::endl;
+
+    return result;
 }
@@ -0,0 +1,312 @@
+/*
+ * Copyright (C) 2016 Canonical, Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 3, as published
+ * by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranties of
+ * MERCHANTABILITY, SATISFACTORY QUALITY, or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <signal.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <boost/program_options.hpp>
+
+#include <ac/logger.h>
+#include <ac/utils.h>
+#include <ac/streaming/fecdecoder.h>
+#include <ac/streaming/streamanalyzer.h>
+
+namespace {
+static constexpr unsigned int kMaxDatagramSize{2048};
+static constexpr int kReceiveBufferSize{1024 * 1024};
+static constexpr int kPollTimeoutMs{100};
+
+std::atomic<bool> running{true};
+
+void OnSignalRaised(int) {
+    running = false;
+}
+
+int CreateSocket(const std::string &address, int port) {
+    int fd = ::socket(AF_INET, SOCK_DGRAM, 0);
+    if (fd < 0) {
+        AC_ERROR("Failed to create socket: %s (%d)", ::strerror(errno), errno);
+        return -1;
+    }
+
+    int value = kReceiveBufferSize;
+    if (::setsockopt(fd, SOL_SOCKET, SO_RCVBUF, &value, sizeof(value)) < 0)
+        AC_WARNING("Failed to set socket receive buffer size: %s (%d)", ::strerror(errno), errno);
+
+    struct sockaddr_in addr;
+    ::memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(port);
+
+    if (::inet_pton(AF_INET, address.c_str(), &addr.sin_addr) != 1) {
+        AC_ERROR("Invalid address %s", address);
+        ::close(fd);
+        return -1;
+    }
+
+    if (::bind(fd, reinterpret_cast<const struct sockaddr*>(&addr), sizeof(addr)) < 0) {
+        AC_ERROR("Failed to bind socket to %s:%d: %s (%d)", address, port, ::strerror(errno), errno);
+        ::close(fd);
+        return -1;
+    }
+
+    return fd;
+}
+
+// Returns the number of problems found in the stream so far which
+// would be noticed by a sink.
+std::uint64_t CountProblems(const ac::streaming::StreamAnalyzer::Result &result) {
+    std::uint64_t problems = result.rtp_lost_packets +
+                             result.rtp_reordered_packets +
+                             result.rtp_invalid_packets +
+                             result.ts_sync_errors +
+                             result.ts_continuity_errors +
+                             result.psi_crc_errors;
+
+    const auto max_interval = ac::streaming::StreamAnalyzer::kMaxTableInterval;
+    if (result.max_pat_interval > max_interval)
+        problems++;
+    if (result.max_pmt_interval > max_interval)
+        problems++;
+    if (result.max_pcr_interval > max_interval)
+        problems++;
+
+    return problems;
+}
+
+// Drops media packets in bursts to see how well FEC copes with what
+// WiFi does to the stream.
+class LossInjector {
+public:
+    LossInjector(double percentage, unsigned int burst) :
+        probability_(percentage / 100.0 / std::max(burst, 1u)),
+        burst_(std::max(burst, 1u)),
+        remaining_(0),
+        distribution_(0.0, 1.0) {
+    }
+
+    bool Drop() {
+        if (remaining_ == 0 && probability_ > 0.0 && distribution_(generator_) < probability_)
+            remaining_ = burst_;
+
+        if (remaining_ == 0)
+            return false;
+
+        remaining_--;
+        return true;
+    }
+
+private:
+    const double probability_;
+    const unsigned int burst_;
+    unsigned int remaining_;
+    std::mt19937 generator_;
+    std::uniform_real_distribution<double> distribution_;
+};
+}
+
+int main(int argc, char **argv) {
+    std::string address = "0.0.0.0";
+    std::string output;
+    int port = 0;
+    int fec_port = 0;
+    double drop = 0.0;
+    unsigned int drop_burst = 1;
+    int duration = 0;
+    int interval = 1;
+    bool debug = false;
+
+    boost::program_options::options_description desc("Usage");
+    desc.add_options()
+        ("help,h", "displays this message")
+        ("address,a",
+            boost::program_options::value<std::string>(&address), "Local address to listen on")
+        ("port,p",
+            boost::program_options::value<int>(&port), "Port to listen on")
+        ("fec-port,f",
+            boost::program_options::value<int>(&fec_port), "Port to receive FEC parity packets on (usually port + 2)")
+        ("drop",
+            boost::program_options::value<double>(&drop), "Drop this percentage of the received media packets")
+        ("drop-burst",
+            boost::program_options::value<unsigned int>(&drop_burst), "Drop packets in bursts of this length")
+        ("output,o",
+            boost::program_options::value<std::string>(&output), "Write the H.264 elementary stream to this file")
+        ("duration,t",
+            boost::program_options::value<int>(&duration), "Stop after this many seconds (default: until interrupted)")
+        ("interval,i",
+            boost::program_options::value<int>(&interval), "Print statistics every this many seconds")
+        ("debug,d",
+            boost::program_options::bool_switch(&debug), "Enable verbose debug output");
+
+    boost::program_options::variables_map vm;
+    try {
+        boost::program_options::store(boost::program_options::parse_command_line(argc, argv, desc), vm);
+        boost::program_options::notify(vm);
+    }
+    catch(boost::program_options::error& e) {
+        std::cerr << e.what() << std::endl << std::endl;
+        std::cerr << desc << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    if (vm.count("help")) {
+        std::cout << desc << std::endl;
+        return EXIT_SUCCESS;
+    }
+
+    if (port == 0)
+        throw std::runtime_error("Invalid or no port supplied");
+
+    if (debug)
+        ac::Log().Init(ac::Logger::Severity::kDebug);
+
+    ::signal(SIGINT, OnSignalRaised);
+    ::signal(SIGTERM, OnSignalRaised);
+
+    const int fd = CreateSocket(address, port);
+    if (fd < 0)
+        return EXIT_FAILURE;
+
+    int fec_fd = -1;
+    if (fec_port > 0) {
+        fec_fd = CreateSocket(address, fec_port);
+        if (fec_fd < 0) {
+            ::close(fd);
+            return EXIT_FAILURE;
+        }
+    }
+
+    ac::streaming::StreamAnalyzer analyzer;
+
+    // Packets held back until parity arrives reach the analyzer late
+    // just like they would reach the decoder of a sink.
+    ac::streaming::FECDecoder decoder([&](const uint8_t *data, size_t size) {
+        analyzer.ProcessRTPPacket(data, size, ac::Utils::GetNowUs());
+    });
+
+    LossInjector loss(drop, drop_burst);
+
+    int fout = -1;
+    if (output.length() > 0) {
+        fout = ::open(output.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        if (fout < 0) {
+            AC_ERROR("Failed to open output file %s", output);
+            ::close(fd);
+            return EXIT_FAILURE;
+        }
+
+        analyzer.SetElementaryStreamCallback([&](const uint8_t *data, size_t size) {
+            if (::write(fout, data, size) < 0)
+                AC_ERROR("Failed to write output data");
+        });
+    }
+
+    std::cout << "Listening on " << address << ":" << port << std::endl;
+
+    std::vector<uint8_t> datagram(kMaxDatagramSize);
+
+    struct pollfd pfd[2];
+    pfd[0].fd = fd;
+    pfd[0].events = POLLIN;
+    pfd[1].fd = fec_fd;
+    pfd[1].events = POLLIN;
+    const nfds_t num_fds = fec_fd < 0 ? 1 : 2;
+
+    const auto start = std::chrono::steady_clock::now();
+    auto last_report = start;
+
+    while (running) {
+        const auto now = std::chrono::steady_clock::now();
+
+        if (duration > 0 && now - start >= std::chrono::seconds{duration})
+            break;
+
+        if (interval > 0 && now - last_report >= std::chrono::seconds{interval}) {
+            std::cout << analyzer.Statistics() << std::endl;
+            last_report = now;
+        }
+
+        if (::poll(pfd, num_fds, kPollTimeoutMs) <= 0)
+            continue;
+
+        if (num_fds > 1 && (pfd[1].revents & POLLIN)) {
+            const auto size = ::recv(fec_fd, datagram.data(), datagram.size(), 0);
+            if (size < 0)
+                AC_ERROR("Failed to receive parity data: %s (%d)", ::strerror(errno), errno);
+            else
+                decoder.ProcessFECPacket(datagram.data(), size);
+        }
+
+        if (!(pfd[0].revents & POLLIN))
+            continue;
+
+        const auto size = ::recv(fd, datagram.data(), datagram.size(), 0);
+        if (size < 0) {
+            AC_ERROR("Failed to receive data: %s (%d)", ::strerror(errno), errno);
+            continue;
+        }
+
+        if (loss.Drop())
+            continue;
+
+        if (fec_fd >= 0)
+            decoder.ProcessMediaPacket(datagram.data(), size);
+        else
+            analyzer.ProcessRTPPacket(datagram.data(), size, ac::Utils::GetNowUs());
+    }
+
+    decoder.Flush();
+
+    ::close(fd);
+    if (fec_fd >= 0)
+        ::close(fec_fd);
+    if (fout >= 0)
+        ::close(fout);
+
+    const auto result = analyzer.Statistics();
+    const auto problems = CountProblems(result);
+
+    std::cout << result << std::endl;
+
+    if (fec_fd >= 0) {
+        const auto stats = decoder.Stats();
+        std::cout << "FEC: " << stats.fec_packets << " parity packets, "
+                  << stats.recovered_packets << " recovered, "
+                  << stats.lost_packets << " not recovered" << std::endl;
+    }
+
+    if (problems > 0) {
+        std::cout << "Found " << problems << " problems in the received stream" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}